@@ -97,9 +97,15 @@
 #define configCPU_CLOCK_HZ				( 48000000UL )
 #define configTICK_RATE_HZ				( ( portTickType ) 100 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 70 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 32 * 1024 ) )
+// heap_1: only the TCBs, queues, semaphores and timer created at init, and the idle and timer task stacks.
+// FSW stacks are static, see fsw_memmap.h. At init the target takes about 5.5 KB: 19 TCBs of 80 bytes,
+// 22 queues and semaphores of 80 bytes and under 1 KB of their storage, 1240 bytes of idle and timer
+// stacks and the timer. This is worked out from fsw_host's allocations with 32 bit sizes, not read from
+// xPortGetFreeHeapSize() on the target. The rest, over 40 %, is margin for queues added later.
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 10 * 1024 ) )
+#define configUSE_MALLOC_FAILED_HOOK	1
 #define configMAX_TASK_NAME_LEN			( 10 )
-#define configUSE_TRACE_FACILITY		0
+#define configUSE_TRACE_FACILITY		1		// uxTaskGetSystemState, for the task telemetry
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			0
 #define configUSE_CO_ROUTINES 			1
@@ -113,7 +119,32 @@
 #define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configQUEUE_REGISTRY_SIZE		0
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+
+// The RTC ticks instead of the SysTick, so the tick keeps counting in EM2, and the idle task stops it and sleeps
+// until the next task's timeout. See bsp_sleep.c.
+#define configUSE_TICKLESS_IDLE					1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP	2
+
+// Run time is counted by the RTC, 32768 Hz, which BSP_RTC_Init starts
+#include <stdint.h>
+extern uint32_t BSP_SLEEP_getTime( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()		BSP_SLEEP_getTime()
+
+// Context switches and queue operations are recorded to the trace ring, see bsp_trace.c. The hooks expand inside
+// tasks.c and queue.c, where the TCB and queue members are visible. Sends are traced before the item is copied in,
+// receives before it is taken out.
+#include "bsp_trace.h"
+#define traceTASK_SWITCHED_IN()						BSP_TRACE_switchedIn( pxCurrentTCB->uxTCBNumber )
+#define traceQUEUE_CREATE( pxNewQueue )				( pxNewQueue )->ucQueueNumber = BSP_TRACE_queueCreated( ( pxNewQueue )->uxLength, ( pxNewQueue )->ucQueueType )
+#define traceCREATE_MUTEX( pxNewQueue )				traceQUEUE_CREATE( pxNewQueue )
+#define traceQUEUE_SEND( pxQueue )					BSP_TRACE_queueEvent( BSP_TRACE_SEND, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting + 1 )
+#define traceQUEUE_SEND_FAILED( pxQueue )			BSP_TRACE_queueEvent( BSP_TRACE_SENDFAIL, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting )
+#define traceQUEUE_RECEIVE( pxQueue )				BSP_TRACE_queueEvent( BSP_TRACE_RECEIVE, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting - 1 )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )			BSP_TRACE_queueEvent( BSP_TRACE_SEND | BSP_TRACE_FROMISR, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting + 1 )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )	BSP_TRACE_queueEvent( BSP_TRACE_SENDFAIL | BSP_TRACE_FROMISR, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )		BSP_TRACE_queueEvent( BSP_TRACE_RECEIVE | BSP_TRACE_FROMISR, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting - 1 )
 
 // Added for using software timers. Author: AEH
 // TODO: These values probably need adjusting
@@ -7,33 +7,26 @@
 
 #include "includes.h"
 
-volatile uint32_t  sec = 0; ///< total time in seconds
-volatile uint16_t msec = 0; ///< total time in mseconds
-
 volatile uint32_t singleErrors = 0;
 volatile uint32_t doubleErrors = 0;
 volatile uint32_t multiErrors  = 0;
 
 /**************************************************************************//**
  * @brief RTC_IRQHandler
- * Interrupt Service Routine for real time clock
+ * Interrupt Service Routine for real time clock. OF extends the counter, the
+ * timebase read by BSP_RTC_getTimeUs, and COMP1 is the RTOS tick, handled by
+ * bsp_sleep.c. No interrupt is needed to keep the time.
  *****************************************************************************/
 void RTC_IRQHandler(void)
 {
-	// clear interrupt source
-	RTC_IntClear(RTC_IFC_COMP0);
+	uint32_t flags;
 
-	// update milliseconds timer
-	msec++;
+	flags = RTC_IntGet() & RTC->IEN;
 
-	if(msec >= 1024)
-	{
-		// update seconds timer
-		sec++;
+	if(flags & RTC_IF_OF)
+		BSP_RTC_overflowIRQ();
 
-		// reset milliseconds timer
-		msec = 0;
-	}
+	BSP_SLEEP_rtcIRQ(flags);
 
 	// toggle external wdog
 	// BSP_WDG_ToggleExt();
@@ -75,26 +68,42 @@ void ACMP0_IRQHandler(void)
 
 /**************************************************************************//**
  * @brief RTC_IRQHandler
- * Interrupt Service Routine for general purpose input/output pins
+ * Interrupt Service Routine for general purpose input/output pins: the EDAC
+ * error lines on B0 and B2, and the debug UART RX pin while its reader waits
+ * for the line to become active.
  *****************************************************************************/
 void GPIO_EVEN_IRQHandler(void)
 {
+	uint32_t flags;
 	uint8_t errors;
 
-	errors = ( (uint8_t)GPIO_PortInGet(gpioPortB) ) & 0x5;
+	flags = GPIO_IntGet() & GPIO->IEN;
 
-	switch(errors)
+	if(flags & (1 << BSP_UART_DEBUG_RXPIN))
 	{
-	case 0x0:
-		multiErrors++;
-		break;
+		BSP_UART_rxPinIRQ();
+	}
+
+	if(flags & 0x5)
+	{
+		// clear interrupt source, or the interrupt is taken again straight away
+		GPIO_IntClear(flags & 0x5);
+
+		errors = ( (uint8_t)GPIO_PortInGet(gpioPortB) ) & 0x5;
+
+		switch(errors)
+		{
+		case 0x0:
+			multiErrors++;
+			break;
 
-	case 0x1:
-		doubleErrors++;
-		break;
+		case 0x1:
+			doubleErrors++;
+			break;
 
-	case 0x4:
-		singleErrors++;
-		break;
+		case 0x4:
+			singleErrors++;
+			break;
+		}
 	}
 }
@@ -8,8 +8,6 @@
 #ifndef BACKGROUND_H_
 #define BACKGROUND_H_
 
-extern volatile uint32_t sec;
-extern volatile uint16_t msec;
 extern volatile uint32_t singleErrors, doubleErrors, multiErrors;
 
 #endif /* BACKGROUND_H_ */
@@ -6,43 +6,38 @@
  */
 
 #include "comms.h" 	// received with only this include
+#include "fsw_cmdpool.h"
+#include "fsw_tlmstore.h"
 
 // #define COMMS_TCMDERR_OVERFLOW 	1		// Used in testing with HIL software
 // #define COMMS_TCMDERR_ID 		2
 
 extern xSemaphoreHandle printingMutex;
 
-enum commsState{
-	waitForId,
-	waitForData
-} uartState, i2cState;
+// Telecommands on their way from each link's receiver to COMMS_processTCMD
+static FSW_LINK_Frame_TypeDef uartTcmdSlots[COMMS_TCMD_BUFFLEN];
+static FSW_LINK_Frame_TypeDef i2cTcmdSlots[COMMS_TCMD_BUFFLEN];
+static FSW_LINK_Queue_TypeDef uartTcmds;	// Filled by COMMS_uartRx
+static FSW_LINK_Queue_TypeDef i2cTcmds;		// Filled by the I2C slave interrupt
 
-typedef struct{
-	uint8_t id;
-	uint8_t len;
-	uint8_t error;
-	uint8_t processed;
-	uint8_t params[COMMS_TCMD_PARAMLEN];
-} COMMS_TCMD_TypeDef;
+static FSW_LINK_Decoder_TypeDef uartLink;
+static FSW_LINK_Decoder_TypeDef i2cLink;
 
-COMMS_TCMD_TypeDef tcmdBuffer[COMMS_TCMD_BUFFLEN];
-
-uint8_t tcmdReadIndex;
-uint8_t tcmdWriteIndex;
-uint8_t tcmdBuffFull;
+static uint8_t lastTcmdId;
+static uint8_t lastTcmdError;
 
 uint16_t tcmdCount;
 uint16_t tlmCount;
 
 //uint16_t commsErr;
 
-uint8_t uartRxIndex;
-uint8_t uartTxIndex;
 uint8_t uartTxBuffer[64];
+static uint8_t uartReply[FSW_LINK_FRAMEMAX];
 
-uint8_t i2cRxIndex;
-uint8_t i2cTxIndex;
-uint8_t i2cTxBuffer[64];
+static uint16_t i2cTxIndex;
+static uint16_t i2cTxLen;
+static uint8_t i2cTxFresh;				// Whether the reply has not been read yet
+static uint8_t i2cTxBuffer[FSW_LINK_FRAMEMAX];
 
 uint8_t debugStr[64], debugLen;
 
@@ -52,6 +47,7 @@ uint16_t txBufferSize;
 uint8_t rxBuffer[64];
 uint16_t rxBufferSize;
 uint8_t TLMreturn[32], TLMreturn_len;
+static xQueueHandle i2cReplyQueue;			// Completed terminal requests, from the I2C manager
 
 // FreeRTOS queue in which to queue up subsystem commands
 extern xQueueHandle FSW_CDH_CMDqueue;
@@ -93,557 +89,420 @@ void addToBuffer_uint32 (uint8_t *buffer, uint32_t data)
 
 void COMMS_init(void)
 {
-	int i;
+	FSW_LINK_queueInit(&uartTcmds, uartTcmdSlots, COMMS_TCMD_BUFFLEN);
+	FSW_LINK_queueInit(&i2cTcmds, i2cTcmdSlots, COMMS_TCMD_BUFFLEN);
+	FSW_LINK_rxInit(&uartLink);
+	FSW_LINK_rxInit(&i2cLink);
+	lastTcmdId = 0;
+	lastTcmdError = 0;
 
 	BSP_UART_Init(BSP_UART_DEBUG);
 	BSP_I2C_Init(BSP_I2C_SYS, true);			// Initialise FSW as master on I2C bus
-
-	for(i = 0; i < COMMS_TCMD_BUFFLEN; i++)
-	{
-		tcmdBuffer[i].error = 0;
-		tcmdBuffer[i].processed = 1;
-	}
-
-	tcmdReadIndex  = 0;
-	tcmdWriteIndex = 0;
-	tcmdBuffFull   = 0;
+	i2cReplyQueue = xQueueCreate(1, sizeof(COMM_I2Cmsg_TypeDef));
 
 	tcmdCount = 0;
 	tlmCount  = 0;
 
 	commsErr  = 0x00;
 
-	uartRxIndex = 0;
-	uartTxIndex = 0;
-
-	i2cRxIndex = 0;
 	i2cTxIndex = 0;
+	i2cTxLen = 0;
+	i2cTxFresh = 0;
 
 	debugLen = 0;
 }
 
 #ifndef HIL_sim
 
-uint8_t identifyTCMD (uint8_t id)
+// Reads CubeSense telemetry through the I2C manager, ahead of the periodic traffic
+static BSP_I2C_Status_TypeDef readCubeSense (uint8_t *request, uint16_t requestLen, uint8_t *tlm, uint16_t tlmLen)
 {
-	uint8_t tcmdLen;
-	/*
-	if(tcmdError)												// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-	{
-		// ignore tcmd until error cleared (see tlm: 0x81)
-		//return;
-	}
-
-	if(!tcmdProcessed)											// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-	{
-		//tcmdError = COMMS_TCMDERR_OVERFLOW;
-		//return;
-	}
-	 */
-
-	switch(id)
-	{
+	COMM_I2Cmsg_TypeDef I2Cmsg;
 
-	case 0x01:													// EDITED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-		tcmdBuffer[tcmdWriteIndex].id = id;
-		tcmdLen = 0;
-		tcmdBuffer[tcmdWriteIndex].processed = 0;
-		break;
-	case 't':
-		tcmdLen = 0;
-		break;
+	// Drop the reply of an earlier request that timed out
+	while(xQueueReceive(i2cReplyQueue, &I2Cmsg, 0) == pdTRUE);
 
-	case 0x2:
-		tcmdLen = 1;
-		break;
-	case 0x11: 	// set attitude estimation mode					// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-		tcmdLen = 1;
-		break;
-	case 0x12:	// send sysHealth command
-		tcmdLen = 0;
-		break;
-	case 0x13: 	// set OBC time and date
-		tcmdLen = 0;
-		break;
-		//default:												// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-		// flag tcmd error										// ..
-		//tcmdId = id;											// ..
-		//tcmdError = COMMS_TCMDERR_ID;							// ..
-		//return; // !Note we exit function						// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
+	FSW_I2CBUS_construct(&I2Cmsg, bspI2cWriteRead, request, requestLen, tlm, tlmLen, FSW_COMM, I2CADDR_CUBESENSE_W);
+	I2Cmsg.priority = FSW_I2C_PRIO_HIGH;
+	I2Cmsg.reply = i2cReplyQueue;
 
-	default:
-		tcmdLen = 0;
-		//tcmdBuffer[tcmdWriteIndex].len = 0;
-		break;
-	}
+	if(FSW_I2CBUS_submit(FSW_COMM_I2Cqueue, &I2Cmsg, 0) != pdTRUE)
+		return bspI2cBusy;
 
-	/*
-			tcmdId = id;													// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-			commsUart = waitForData;										// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-			uartRxIndex = 0;												// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-	 */
+	if(xQueueReceive(i2cReplyQueue, &I2Cmsg, 1000 / portTICK_RATE_MS) != pdTRUE)
+		return bspI2cTimeout;
 
-	return tcmdLen;
+	return (BSP_I2C_Status_TypeDef)I2Cmsg.status;
 }
 
 
-void COMMS_processTCMD(void)
+// Executes a telecommand; its parameters are in tcmd->payload
+static void executeTCMD (const FSW_LINK_Frame_TypeDef *tcmd)
 {
-	portBASE_TYPE sendStatus;
-
-	//if(tcmdProcessed)															// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-	//if( tcmdBuffer[tcmdReadIndex].processed )									// Enabling this locks up matlab
-	//return; // no need to proceed, no tcmd to process
-
-	//if(tcmdError)																// ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
-	if( tcmdBuffer[tcmdReadIndex].error )
-		return; // wait for "TCM ack" telemetry msg (0x82) to clear error flag
-
-	// loop through TCMD buffer until all TCMDs have been processed
-	while( !( tcmdBuffer[(tcmdReadIndex + 1) % COMMS_TCMD_BUFFLEN].processed ) )
+	switch(tcmd->id)
 	{
-		tcmdReadIndex = (tcmdReadIndex + 1) % COMMS_TCMD_BUFFLEN;
-
-		// process errors
-		if(tcmdBuffer[tcmdReadIndex].error)
-		{
-			debugLen = sprintf((char*)debugStr,"\nERROR: %d\n", tcmdBuffer[tcmdReadIndex].error);
-			BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen, true);
-
-			tcmdBuffer[tcmdReadIndex].error = 0;
-		}
-		// process telecommands
-		else
-		{
-			switch(tcmdBuffer[tcmdReadIndex].id)
-			{
-			case 't':													// Print out RTC value
-				TEST_RTC();
-				break;
-
-			case 'm':													// Test microSD card
-				TEST_microSD();
-				break;
-
-			case 'c':													// Generate a CMD log
-				log_entry.type = LOG_CMD;
-				log_entry.exe_time = OBC_time;
-				log_entry.source = FSW_COMM;
-				log_entry.id = 0x01;
-
-				xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
-				break;
-
-			case 'w':													// Generate a WOD log
-				log_entry.type = LOG_WOD;
-				log_entry.exe_time = OBC_time;
-				log_entry.source = FSW_COMM;
-				log_entry.id = 0x02;
-
-				xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
-				break;
-
-			case 'i':													// Send a 'status' TLM request to CubeSense
-				// Construct a buffer containing 'status' TLM request
-				txBuffer[0] = 0x80;		// Telemetry request id for status
-				txBufferSize = 1;
-				rxBufferSize = 6;		// 6 Bytes will be received after this request
-
-				// Send a 'status' TLM request to CubeSense
-				BSP_I2C_masterTX (BSP_I2C_SYS, 0x20, bspI2cWriteRead, txBuffer, txBufferSize, rxBuffer, rxBufferSize);
-
-				TLMreturn_len = sprintf((char*)TLMreturn,"%d \n%d \n%d \n%d \n%d \n%d \n", (int)rxBuffer[0],
-						(int)rxBuffer[1], (int)rxBuffer[2], (int)rxBuffer[3], (int)rxBuffer[4], (int)rxBuffer[5]);
-
-				BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)TLMreturn,TLMreturn_len,true);
-
-				printString("status request completed\n");
-				break;
-
-			case 'I':
-				// Construct a buffer containing 'status' TLM request
-				txBuffer[0] = 0x81;		// Telemetry request id for status
-				txBufferSize = 1;
-				rxBufferSize = 8;		// 6 Bytes will be received after this request
-
-				// Send a 'status' TLM request to CubeSense
-				BSP_I2C_masterTX (BSP_I2C_SYS, 0x20, bspI2cWriteRead, txBuffer, txBufferSize, rxBuffer, rxBufferSize);
-
-				TLMreturn_len = sprintf((char*)TLMreturn,"%d \n%d \n%d \n%d \n%d \n%d \n", (int)rxBuffer[0],
-						(int)rxBuffer[1], (int)rxBuffer[2], (int)rxBuffer[3], (int)rxBuffer[4], (int)rxBuffer[5], (int)rxBuffer[6], (int)rxBuffer[7]);
-
-				BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)TLMreturn,TLMreturn_len,true);
-
-				printString("comm status request completed\n");
-				break;
-
-			case 'p':
-				BSP_ADC_update(1);
-
-					debugLen = sprintf((char*)debugStr,"\n\nChannel 0 (mV): %d\nChannel 1 (mV): %d\nChannel 2 (mV): %d\nChannel 3 (mV): %d\nCelcius (C): %.2f",
-							BSP_ADC_getData(CHANNEL0),BSP_ADC_getData(CHANNEL1),
-							BSP_ADC_getData(CHANNEL2),BSP_ADC_getData(CHANNEL3),
-							BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE)));
-					BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen,true);
-				break;
-
-			case 'e':													// Generate a error log
-				log_entry.type = LOG_ERROR;
-				log_entry.exe_time = OBC_time;
-				log_entry.source = FSW_COMM;
-				log_entry.id = 0x03;
-
-				xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
-				break;
-
-			case 'r':													// Reset MCU
-				SCB->AIRCR = 0x05FA0004;
-				break;
-
-			case 'a':													// Print a test string to the terminal
-				printString( "Terminal test successful\n" );
-				break;
-
-			default:
-				//debugLen = sprintf((char*)debugStr,"\nERROR: Unknown telecommand ID!\n");
-				//BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen, true);
-				while(1);
-				break;
-			}
-			tcmdCount++;
-		}
-
-		tcmdBuffer[tcmdReadIndex].processed = 1;
-		//sendStatus = NULL;
-	}
-}
+	case 't':													// Print out RTC value
+		TEST_RTC();
+		break;
 
+	case 'm':													// Test microSD card
+		TEST_microSD();
+		break;
 
-uint8_t processTLM(uint8_t id, uint8_t *txBuffer)
-{
-	uint8_t tlmLen;
+	case 'c':													// Generate a CMD log
+		log_entry.type = LOG_CMD;
+		log_entry.exe_time = getOBC_time();
+		log_entry.source = FSW_COMM;
+		log_entry.id = 0x01;
 
-	switch(id)
-	{
-	case 0x80: // status
+		xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
+		break;
 
-		addToBuffer_uint32(&(txBuffer[0]),sec);
-		addToBuffer_uint8 (&(txBuffer[4]),(uint8_t)FIRMWARE_MAJOR);
-		addToBuffer_uint8 (&(txBuffer[5]),(uint8_t)FIRMWARE_MINOR);
-		tlmLen = 6;
+	case 'w':													// Generate a WOD log
+		log_entry.type = LOG_WOD;
+		log_entry.exe_time = getOBC_time();
+		log_entry.source = FSW_COMM;
+		log_entry.id = 0x02;
 
+		xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
 		break;
 
-	case 0x81: // communication status
+	case 'i':													// Send a 'status' TLM request to CubeSense
+		// Construct a buffer containing 'status' TLM request
+		txBuffer[0] = 0x80;		// Telemetry request id for status
+		txBufferSize = 1;
+		rxBufferSize = 6;		// 6 Bytes will be received after this request
 
-		addToBuffer_uint16(&(txBuffer[0]), tcmdCount);
-		addToBuffer_uint16(&(txBuffer[2]), tlmCount);
-		addToBuffer_uint16(&(txBuffer[4]), commsErr);
-		tlmLen = 6;
+		// Send a 'status' TLM request to CubeSense
+		readCubeSense(txBuffer, txBufferSize, rxBuffer, rxBufferSize);
 
-		// clear error flags
-		commsErr = 0x00;
+		TLMreturn_len = sprintf((char*)TLMreturn,"%d \n%d \n%d \n%d \n%d \n%d \n", (int)rxBuffer[0],
+				(int)rxBuffer[1], (int)rxBuffer[2], (int)rxBuffer[3], (int)rxBuffer[4], (int)rxBuffer[5]);
+
+		BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)TLMreturn,TLMreturn_len,true);
 
+		printString("status request completed\n");
 		break;
 
-	case 0x82: // telecommand acknowledge. ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY
+	case 'I':
+		// Construct a buffer containing 'status' TLM request
+		txBuffer[0] = 0x81;		// Telemetry request id for status
+		txBufferSize = 1;
+		rxBufferSize = 8;		// 6 Bytes will be received after this request
 
-		//addToBuffer_uint8(&(uartTxBuffer[0]), tcmdId);
-		addToBuffer_uint8(&(uartTxBuffer[0]), tcmdBuffer[tcmdWriteIndex].id);
-		//addToBuffer_uint8(&(uartTxBuffer[1]), tcmdProcessed);
-		addToBuffer_uint8(&(uartTxBuffer[1]), tcmdBuffer[tcmdWriteIndex].processed);
-		//addToBuffer_uint8(&(uartTxBuffer[2]), tcmdError);
-		addToBuffer_uint8(&(uartTxBuffer[2]), tcmdBuffer[tcmdWriteIndex].error);
+		// Send a 'status' TLM request to CubeSense
+		readCubeSense(txBuffer, txBufferSize, rxBuffer, rxBufferSize);
 
-		// clear error flags
-		tcmdBuffer[tcmdWriteIndex].error = 0;
-		//tcmdError = 0;
+		TLMreturn_len = sprintf((char*)TLMreturn,"%d \n%d \n%d \n%d \n%d \n%d \n", (int)rxBuffer[0],
+				(int)rxBuffer[1], (int)rxBuffer[2], (int)rxBuffer[3], (int)rxBuffer[4], (int)rxBuffer[5], (int)rxBuffer[6], (int)rxBuffer[7]);
 
-		//BSP_UART_txBuffer (BSP_UART_DEBUG, uartTxBuffer, 3, true);
-		tlmLen = 3;
+		BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)TLMreturn,TLMreturn_len,true);
 
+		printString("comm status request completed\n");
 		break;
 
-	case 0x83: // current time
+	case 'p':
+		debugLen = sprintf((char*)debugStr,"\n\nChannel 0 (mV): %d\nChannel 1 (mV): %d\nChannel 2 (mV): %d\nChannel 3 (mV): %d\nCelcius (C): %.2f",
+				BSP_ADC_getData(CHANNEL0),BSP_ADC_getData(CHANNEL1),
+				BSP_ADC_getData(CHANNEL2),BSP_ADC_getData(CHANNEL3),
+				BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE)));
+		BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen,true);
+		break;
 
-		addToBuffer_uint32(&(txBuffer[0]),sec);
-		addToBuffer_uint16(&(txBuffer[4]),msec);
-		tlmLen = 6;
+	case 'e':													// Generate a error log
+		log_entry.type = LOG_ERROR;
+		log_entry.exe_time = getOBC_time();
+		log_entry.source = FSW_COMM;
+		log_entry.id = 0x03;
+
+		xQueueSendToBack( FSW_FS_LOGqueue, &log_entry, 0 );
+		break;
 
+	case 'r':													// Reset MCU
+		SCB->AIRCR = 0x05FA0004;
 		break;
 
-	case 0x92:	// Report OBC time and date
-		addToBuffer_uint32 ( uartTxBuffer, (uint32_t)getOBC_time() );
-		tlmLen = 4;
+	case 'a':													// Print a test string to the terminal
+		printString( "Terminal test successful\n" );
 		break;
 
 	default:
-		// error: unknown telemetry id
+		debugLen = sprintf((char*)debugStr,"\nERROR: Unknown telecommand ID!\n");
+		BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen, true);
+		lastTcmdError = COMMS_TCMDERR_ID;
 		break;
 	}
+}
 
-	tlmCount++;
 
-	return tlmLen;
+/**
+ * Executes the telecommands queued by both links, each link's in the order they arrived. A telecommand stays in its queue slot
+ * until it has been executed, so the receivers never wait on it.
+ */
+
+static void drainTCMD (FSW_LINK_Queue_TypeDef *queue)
+{
+	FSW_LINK_Frame_TypeDef *tcmd;
+
+	while((tcmd = FSW_LINK_queuePeek(queue)) != NULL)
+	{
+		executeTCMD(tcmd);
+		FSW_LINK_queuePop(queue);
+		tcmdCount++;
+	}
 }
 
 /**
- * UART interrupt handler
- * This handler executes when data is received on the UART. The UART state (initially waitForId) is used to determine what action to take
- * waitForId
- * In this state, the received ID is evaluated to see if a TCMD or TLM request was received. If a TLM request was received, it is
- * processed in the handler by processTLM. processTLM puts the requested TLM on the buffer for transmission. The buffer is then
- * transmitted if no data is currently being transmitted. If a TCMD was received and there isn't a backlog of TCMDs waiting to be
- * processed, the ID and length of the TCMD are added to the buffer. If the length is bigger than 0, the state is switched to waitForData
- * (in order to receive the data in the TCMD), otherwise the TCMD is flagged for processing.
- * waitForData
- * Whenever data appears on the UART, it is stored in the TCMD buffer's parameter array. When the same amount of data as the length of the
- * TCMD has been received, the TCMD is flagged for processing and the mode is set to waitForId
+ * Telemetry publisher
+ * Publishes the comms telemetry to the telemetry store, from which both links answer telemetry requests without gathering it
+ * themselves. It runs each time the telecommands are drained, at least every COMMS_UART_QUIET_MS.
  */
 
-void BSP_UART_DEBUG_IRQHandler(void)
+static void publishTLM (void)
+{
+	uint8_t tlm[18];
+
+	addToBuffer_uint32(&(tlm[0]), BSP_RTC_getTimeSec());
+	addToBuffer_uint8 (&(tlm[4]), (uint8_t)FIRMWARE_MAJOR);
+	addToBuffer_uint8 (&(tlm[5]), (uint8_t)FIRMWARE_MINOR);
+	FSW_TLM_publish(FSW_TLM_STATUS, tlm, 6);
+
+	addToBuffer_uint16(&(tlm[0]), tcmdCount);
+	addToBuffer_uint16(&(tlm[2]), tlmCount);
+	addToBuffer_uint16(&(tlm[4]), commsErr);
+	FSW_TLM_publish(FSW_TLM_COMMSTATUS, tlm, 6);
+
+	addToBuffer_uint8(&(tlm[0]), lastTcmdId);
+	addToBuffer_uint8(&(tlm[1]), FSW_LINK_queueCount(&uartTcmds) + FSW_LINK_queueCount(&i2cTcmds) == 0);
+	addToBuffer_uint8(&(tlm[2]), lastTcmdError);
+	FSW_TLM_publish(FSW_TLM_TCMDACK, tlm, 3);
+
+	addToBuffer_uint32(&(tlm[0]), uartLink.stats.frames);
+	addToBuffer_uint16(&(tlm[4]), uartLink.stats.crcErrors);
+	addToBuffer_uint16(&(tlm[6]), uartLink.stats.formatErrors);
+	addToBuffer_uint32(&(tlm[8]), i2cLink.stats.frames);
+	addToBuffer_uint16(&(tlm[12]), i2cLink.stats.crcErrors);
+	addToBuffer_uint16(&(tlm[14]), i2cLink.stats.formatErrors);
+	addToBuffer_uint16(&(tlm[16]), uartTcmds.dropped + i2cTcmds.dropped);
+	FSW_TLM_publish(FSW_TLM_LINK, tlm, 18);
+}
+
+void COMMS_processTCMD(void)
 {
-	uint32_t status;
-	uint8_t  tempId, tempLen, tempData;
+	drainTCMD(&uartTcmds);
+	drainTCMD(&i2cTcmds);
+
+	publishTLM();
+}
 
-	// disable interrupt
-	BSP_UART_DEBUG->IEN &= ~USART_IEN_RXDATAV;
 
-	status = BSP_UART_DEBUG->IF;
+/**
+ * Link frame handlers
+ * A telemetry request is answered at once from the telemetry store, or the RTC for the current time, with a frame carrying the
+ * request's ID and sequence number. A telecommand is queued for
+ * COMMS_processTCMD; if its link's queue is full it is dropped and flagged. Frames dropped by the receiver are flagged too, and
+ * counted in the link status telemetry.
+ */
 
-	switch(uartState)
+static uint16_t encodeTLM (const FSW_LINK_Frame_TypeDef *request, uint8_t *reply)
+{
+	uint8_t tlm[FSW_TLM_MAXLEN];
+	uint8_t tlmLen;
+	uint64_t now;
+
+	if(request->id == FSW_TLM_TIME)
+	{
+		now = BSP_RTC_getTimeUs();
+		addToBuffer_uint32(&(tlm[0]), (uint32_t)(now / 1000000));
+		addToBuffer_uint16(&(tlm[4]), (uint16_t)((now / 1000) % 1000));
+		tlmLen = 6;
+	}
+	else
+	{
+		tlmLen = FSW_TLM_read(request->id, tlm);
+	}
+
+	// Error flags are cleared once reported, unless a newer error has replaced them since the snapshot
+	if(request->id == FSW_TLM_COMMSTATUS && tlmLen == 6 && commsErr == (uint16_t)(tlm[4] | (tlm[5] << 8)))
+	{
+		commsErr = 0x00;
+	}
+	else if(request->id == FSW_TLM_TCMDACK && tlmLen == 3 && lastTcmdError == tlm[2])
 	{
-	case waitForId:
+		lastTcmdError = 0;
+	}
 
-		tempId = BSP_UART_DEBUG->RXDATA;
+	tlmCount++;
 
-		// Telemetry ID
-		if( (tempId & COMMS_ID_TYPE) == COMMS_ID_TLM)
+	return FSW_LINK_encode(reply, request->id, request->seq, tlm, tlmLen);
+}
+
+static void queueTCMD (FSW_LINK_Queue_TypeDef *queue, const FSW_LINK_Frame_TypeDef *tcmd)
+{
+	lastTcmdId = tcmd->id;
+
+	if(!FSW_LINK_queuePush(queue, tcmd))
+	{
+		commsErr = COMMS_ERROR_TCMDBUFOF;
+	}
+}
+
+static void uartFrame (FSW_LINK_RxStatus_TypeDef status)
+{
+	uint16_t replyLen;
+
+	if(status == linkRxFrame)
+	{
+		if((uartLink.frame.id & COMMS_ID_TYPE) == COMMS_ID_TLM)
 		{
-			tempLen = processTLM (tempId, uartTxBuffer);
+			replyLen = encodeTLM(&uartLink.frame, uartReply);
 
-			if( BSP_UART_txInProgress() )
+			// Queued behind any transmission in progress; an error only if the queue stays full
+			if(BSP_UART_txQueue(BSP_UART_DEBUG, uartReply, replyLen, COMMS_UART_TXTIMEOUT_MS / portTICK_RATE_MS) < replyLen)
 			{
 				commsErr = COMMS_ERROR_UARTTLM;
 			}
-			else
-			{
-				BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, tempLen, false);
-			}
 		}
-		// Telecommand ID
 		else
 		{
-			// check for tcmd buffer overflow
-			if(tcmdBuffer[(tcmdWriteIndex + 1) % COMMS_TCMD_BUFFLEN].processed == 0)
-			{
-				tcmdBuffFull = 1;
-				commsErr = COMMS_ERROR_TCMDBUFOF;
-			}
-			// add data to new tcmd parameter storage
-			else
-			{
-				tcmdWriteIndex = (tcmdWriteIndex + 1) % COMMS_TCMD_BUFFLEN;
-				tcmdBuffFull = 0;
-
-				tcmdBuffer[tcmdWriteIndex].id  = tempId;
-				tcmdBuffer[tcmdWriteIndex].len = identifyTCMD (tempId);
-
-				// if tcmd has length, switch uart state, else flag for processing
-				if(tcmdBuffer[tcmdWriteIndex].len > 0)
-				{
-					uartRxIndex = 0;
-					uartState = waitForData;
-				}
-				else
-				{
-					tcmdBuffer[tcmdWriteIndex].processed = 0;
-				}
-			}
+			queueTCMD(&uartTcmds, &uartLink.frame);
 		}
-		break;
+	}
+	else if(status != linkRxNone)
+	{
+		commsErr = COMMS_ERROR_FRAME;
+	}
+}
 
-	case waitForData:
+static void i2cFrame (FSW_LINK_RxStatus_TypeDef status)
+{
+	portBASE_TYPE woken = pdFALSE;
 
-		if(!tcmdBuffFull)
+	if(status == linkRxFrame)
+	{
+		if((i2cLink.frame.id & COMMS_ID_TYPE) == COMMS_ID_TLM)
 		{
-			tcmdBuffer[tcmdWriteIndex].params[uartRxIndex++] = BSP_UART_DEBUG->RXDATA;
-
-			if(uartRxIndex == tcmdBuffer[tcmdWriteIndex].len)
-			{
-				tcmdBuffer[tcmdWriteIndex].processed = 0;
-				uartState = waitForId;
-			}
+			// Read by the master after a repeated start or in its next transfer
+			i2cTxLen = encodeTLM(&i2cLink.frame, i2cTxBuffer);
+			i2cTxFresh = 1;
 		}
 		else
 		{
-			// read data to clear interrupt
-			tempData = BSP_UART_DEBUG->RXDATA;
-		}
-		break;
+			queueTCMD(&i2cTcmds, &i2cLink.frame);
 
-	default:
-		break;
+			// The comms task may be waiting for the UART line with nothing to poll for
+			BSP_UART_rxWakeFromISR(&woken);
+			portEND_SWITCHING_ISR(woken);
+		}
+	}
+	else if(status != linkRxNone)
+	{
+		commsErr = COMMS_ERROR_FRAME;
 	}
-
-	// enable interrupt
-	BSP_UART_DEBUG->IEN |= USART_IEN_RXDATAV;
 }
 
-
 /**
- * I2C interrupt handler
+ * UART receiver
+ * Waits up to COMMS_UART_POLL_MS for data in the UART receive ring, which the DMA fills without interrupting the CPU for each byte,
+ * and gives all of it to the link receiver. A frame the line goes idle in for COMMS_UART_IDLE_MS is ended there, so bytes lost on
+ * the line cost only the frame they belonged to. Once the line has been idle for COMMS_UART_QUIETAFTER_MS, it instead waits up to
+ * COMMS_UART_QUIET_MS for the line to become active, so the idle task can stop the tick and sleep between telecommands.
  */
 
-void I2C0_IRQHandler(void)
+void COMMS_uartRx(void)
 {
-	int status;
-	uint8_t tempAddr, tempId, tempData;
-
-	status = BSP_I2C_SYS->IF;
+	static portTickType lastRx;
+	uint8_t data[32];
+	uint16_t len, i;
 
-	switch(i2cState)
+	if((xTaskGetTickCount() - lastRx) >= COMMS_UART_QUIETAFTER_MS / portTICK_RATE_MS)
 	{
-	case waitForId:
+		if(BSP_UART_rxWaitQuiet(COMMS_UART_QUIET_MS / portTICK_RATE_MS))
+			lastRx = xTaskGetTickCount();	// poll for the frame the line or the I2C link woke us for
+	}
+	else
+	{
+		BSP_UART_rxWait(COMMS_UART_POLL_MS / portTICK_RATE_MS);
+	}
 
-		if (status & I2C_IF_ADDR)
+	while((len = BSP_UART_rxRead(data, sizeof(data))) > 0)
+	{
+		for(i = 0; i < len; i++)
 		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IFC_ADDR);
+			uartFrame(FSW_LINK_rxByte(&uartLink, data[i]));
+		}
+		lastRx = xTaskGetTickCount();
+	}
 
-			tempAddr = BSP_I2C_SYS->RXDATA;
+	if((xTaskGetTickCount() - lastRx) >= COMMS_UART_IDLE_MS / portTICK_RATE_MS)
+	{
+		uartFrame(FSW_LINK_rxEnd(&uartLink));
+	}
+}
 
-			// should not receive read request while waiting for ID
-			if((tempAddr & COMMS_I2C_TYPE) == COMMS_I2C_READ)
-			{
-				commsErr = COMMS_ERROR_I2CTLM;
 
-				// send previous TLM already in buffer
-				i2cState = waitForData;
-				i2cTxIndex = 0;
-				BSP_I2C_SYS->TXDATA = i2cTxBuffer[i2cTxIndex++];
-			}
-		}
-		else if (status & I2C_IF_RXDATAV)
-		{
-			tempId = BSP_I2C_SYS->RXDATA;
+/**
+ * I2C interrupt handler
+ * The master writes a frame, ended by its delimiter, a repeated start or the STOP, and reads the reply to a telemetry request
+ * after it. Reads past the end of the reply return delimiters. A read without a new reply sends the last one again and is flagged.
+ */
 
-			// Telemetry ID
-			if( (tempId & COMMS_ID_TYPE) == COMMS_ID_TLM)
-			{
-				processTLM (tempId, i2cTxBuffer);
+void I2C0_IRQHandler(void)
+{
+	int status;
+	uint8_t tempAddr;
 
-				i2cTxIndex = 0;
-				i2cState = waitForData;
-			}
-			// Telecommand ID
-			else
-			{
-				// check for tcmd buffer overflow
-				if(tcmdBuffer[(tcmdWriteIndex + 1) % COMMS_TCMD_BUFFLEN].processed == 0)
-				{
-					tcmdBuffFull = 1;
-					commsErr = COMMS_ERROR_TCMDBUFOF;
-
-					i2cState = waitForData;
-				}
-				else
-				{
-					tcmdWriteIndex = (tcmdWriteIndex + 1) % COMMS_TCMD_BUFFLEN;
-					tcmdBuffFull = 0;
-
-					tcmdBuffer[tcmdWriteIndex].id  = tempId;
-					tcmdBuffer[tcmdWriteIndex].len = identifyTCMD (tempId);
-
-					i2cRxIndex = 0;
-					i2cState = waitForData;
-				}
-			}
-		}
-		else if(status & I2C_IEN_SSTOP)
-		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IEN_SSTOP);
-		}
-		break;
+	// Master transfers, e.g. CubeSense telemetry requests, are run by the BSP
+	if (BSP_I2C_masterIRQHandler(BSP_I2C_SYS))
+		return;
 
-	case waitForData:
+	status = BSP_I2C_SYS->IF;
 
-		// if data received which is address, start of TLM request
-		if (status & I2C_IF_ADDR)
-		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IFC_ADDR);
+	if (status & I2C_IF_ADDR)
+	{
+		I2C_IntClear(BSP_I2C_SYS, I2C_IFC_ADDR);
 
-			tempAddr = BSP_I2C_SYS->RXDATA;
+		tempAddr = BSP_I2C_SYS->RXDATA;
 
-			// Send first byte of telemetry buffer
-			if((tempAddr & COMMS_I2C_TYPE) == COMMS_I2C_READ)
-			{
-				BSP_I2C_SYS->TXDATA = i2cTxBuffer[i2cTxIndex++];
-			}
-		}
-		// if data received which is not address, TCMD data
-		else if (status & I2C_IF_RXDATAV)
+		// Start of a TLM read
+		if((tempAddr & COMMS_I2C_TYPE) == COMMS_I2C_READ)
 		{
-			if (tcmdBuffFull)
-			{
-				// read data to clear interrupt
-				tempData = BSP_UART_DEBUG->RXDATA;
-			}
-			else if (i2cRxIndex < COMMS_TCMD_PARAMLEN)
-			{
-				// save data in TCMD buffer
-				tcmdBuffer[tcmdWriteIndex].params[i2cRxIndex++] = BSP_I2C_SYS->RXDATA;
-			}
-			else
-			{
-				// read data to clear interrupt
-				tempData = BSP_UART_DEBUG->RXDATA;
+			i2cFrame(FSW_LINK_rxEnd(&i2cLink));
 
-				// increment index counter for error checking when stop received
-				i2cRxIndex++;
+			if(!i2cTxFresh)
+			{
+				commsErr = COMMS_ERROR_I2CTLM;
 			}
+			i2cTxFresh = 0;
+			i2cTxIndex = 0;
+			BSP_I2C_SYS->TXDATA = (i2cTxIndex < i2cTxLen) ? i2cTxBuffer[i2cTxIndex++] : FSW_LINK_DELIMITER;
 		}
+	}
+	else if (status & I2C_IF_RXDATAV)
+	{
+		i2cFrame(FSW_LINK_rxByte(&i2cLink, BSP_I2C_SYS->RXDATA));
+	}
 
-		// if ACK received, another TLM byte requested
-		if(status & I2C_IF_ACK)
-		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IEN_ACK);
-
-			BSP_I2C_SYS->TXDATA = i2cTxBuffer[i2cTxIndex++];
-		}
-
-		// if NACK received, tlm transmission ends
-		if(status & I2C_IF_NACK)
-		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IFC_NACK);
+	// if ACK received, another TLM byte requested
+	if(status & I2C_IF_ACK)
+	{
+		I2C_IntClear(BSP_I2C_SYS, I2C_IEN_ACK);
 
-			i2cState = waitForId;
-		}
+		BSP_I2C_SYS->TXDATA = (i2cTxIndex < i2cTxLen) ? i2cTxBuffer[i2cTxIndex++] : FSW_LINK_DELIMITER;
+	}
 
-		// if STOP received, tcmd transmission ends
-		if(status & I2C_IF_SSTOP)
-		{
-			I2C_IntClear(BSP_I2C_SYS, I2C_IFC_SSTOP);
+	// if NACK received, tlm transmission ends
+	if(status & I2C_IF_NACK)
+	{
+		I2C_IntClear(BSP_I2C_SYS, I2C_IFC_NACK);
+	}
 
-			if(i2cRxIndex == tcmdBuffer[tcmdWriteIndex].len)
-			{
-				// flag message to be processed
-				tcmdBuffer[tcmdWriteIndex].processed = 0;
-			}
-			else if (i2cRxIndex < tcmdBuffer[tcmdWriteIndex].len)
-			{
-				tcmdBuffer[tcmdWriteIndex].error = COMMS_TCMDERR_PARAMUF;
-				tcmdBuffer[tcmdWriteIndex].processed = 0;
-			}
-			else
-			{
-				tcmdBuffer[tcmdWriteIndex].error = COMMS_TCMDERR_PARAMOF;
-				tcmdBuffer[tcmdWriteIndex].processed = 0;
-			}
+	// if STOP received, a frame written without its delimiter ends
+	if(status & I2C_IF_SSTOP)
+	{
+		I2C_IntClear(BSP_I2C_SYS, I2C_IFC_SSTOP);
 
-			// telecommand data reception complete
-			i2cState = waitForId;
-		}
-		break;
+		i2cFrame(FSW_LINK_rxEnd(&i2cLink));
 	}
 }
 #endif
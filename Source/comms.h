@@ -15,6 +15,7 @@
 
 #include "includes.h"
 #include "z_CMDdefs.h"
+#include "fsw_link.h"
 // cdh.h to include definitions for simulation commands
 
 //#define HIL_sim		///< Include this macro to configure the FSW for testing with the HIL simulation in MATLAB
@@ -33,12 +34,20 @@
 #define COMMS_ERROR_TCMDBUFOF 	1
 #define COMMS_ERROR_UARTTLM		2
 #define COMMS_ERROR_I2CTLM  	3
+#define COMMS_ERROR_FRAME		4		///< A frame was dropped for its CRC, size or coding.
 
-#define COMMS_TCMDERR_PARAMUF 	1
-#define COMMS_TCMDERR_PARAMOF 	2
+#define COMMS_TCMDERR_ID		1		///< Unknown telecommand ID.
 
-#define COMMS_TCMD_BUFFLEN   	4
-#define COMMS_TCMD_PARAMLEN  	8
+#ifndef COMMS_TCMD_BUFFLEN
+#define COMMS_TCMD_BUFFLEN   	16		///< Telecommands queued on each link, a power of two.
+#endif
+#define COMMS_TCMD_PARAMLEN  	FSW_LINK_MAXPAYLOAD
+
+#define COMMS_UART_POLL_MS		10		///< Longest wait for UART data short of a DMA half, one tick.
+#define COMMS_UART_IDLE_MS		20		///< Idle line time that ends a frame, two ticks.
+#define COMMS_UART_QUIETAFTER_MS	200		///< Idle line time after which the UART is no longer polled.
+#define COMMS_UART_QUIET_MS		1000	///< Longest wait for the idle UART line to become active.
+#define COMMS_UART_TXTIMEOUT_MS	50		///< Longest wait for room in the UART transmit queue for a telemetry reply.
 
 uint16_t commsErr;
 
@@ -47,9 +56,11 @@ extern uint8_t debugStr[64], debugLen;
 uint8_t uartTxBuffer[64];	// moved here by AH
 
 void addToBuffer_uint8 (uint8_t *buffer, uint8_t data);
+void addToBuffer_uint16 (uint8_t *buffer, uint16_t data);
 void addToBuffer_uint32 (uint8_t *buffer, uint32_t data);
 void COMMS_init(void);
 void COMMS_processTCMD(void);
+void COMMS_uartRx(void);
 void printString(const char * format);
 
 #endif
@@ -36,12 +36,15 @@
 #include "bsp_ebi.h"
 #include "bsp_i2c.h"
 #include "bsp_rtc.h"
+#include "bsp_sleep.h"
+#include "bsp_trace.h"
 #include "bsp_uart.h"
 #include "bsp_wdg.h"
 
 // component specific library
 #include "ff.h"
 #include "diskio.h"
+#include "diskcache.h"
 #include "microsdconfig.h"
 #include "microsd.h"
 #include "lld.h"
@@ -57,10 +60,13 @@
 #include "fsw_adcs.h"
 #include "fsw_comm.h"
 #include "fsw_payload.h"
+#include "fsw_imagedl.h"
 #include "fsw_power.h"
 #include "fsw_healthandhousekeeping.h"
 #include "fsw_filesystem.h"
 #include "fsw_modes.h"
+#include "fsw_periodic.h"
+#include "fsw_memmap.h"
 
 // application library
 #include "background.h"
@@ -72,6 +78,8 @@
 #define FIRMWARE_MAJOR 2
 #define FIRMWARE_MINOR 1
 
+#define FATTIME_EPOCH 315532800		// UNIX time of 1980-01-01, the earliest FAT time stamp
+
 void Delay(uint32_t dlyTicks);
 
 #endif // __INCLUDES_H
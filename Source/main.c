@@ -6,6 +6,7 @@
  ******************************************************************************/
 #include "includes.h"
 #include "z_HILcomm.h"		// For HIL testing
+#include "fsw_cmdpool.h"
 
 #define VERBOSE 1
 uint8_t debugTLM, wdgEnable;
@@ -13,13 +14,16 @@ volatile uint32_t msTicks; /* Counts 1ms timeTicks */
 
 xSemaphoreHandle printingMutex;		///< Mutex for the printing function. A more useful mutex would be assigned to the UART itself
 
+#ifndef HIL_sim
+static portSTACK_TYPE HIL_stack[ FSW_STACK_HIL ];
+#endif
+
 void print_heap_space( void *pvParameters );
 
 /***************************************************************************//**
  * @brief
  *   This function is required by the FAT file system in order to provide
- *   timestamps for created files. Since this example does not include a
- *   reliable clock we hardcode a value here.
+ *   timestamps for created files. They are the OBC date and time.
  *
  *   Refer to drivers/fatfs/doc/en/fattime.html for the format of this DWORD.
  * @return
@@ -27,20 +31,30 @@ void print_heap_space( void *pvParameters );
  ******************************************************************************/
 DWORD get_fattime(void)
 {
-	return (28 << 25) | (2 << 21) | (1 << 16);
+	time_t now = getOBC_time();
+	struct tm ts;
+
+	// FAT time starts in 1980; until the ground sets the date, the old fixed stamp
+	if(now < FATTIME_EPOCH)
+		return (28 << 25) | (2 << 21) | (1 << 16);
+
+	gmtime_r(&now, &ts);
+
+	return ((DWORD)(ts.tm_year - 80) << 25) | ((DWORD)(ts.tm_mon + 1) << 21) | ((DWORD)ts.tm_mday << 16)
+			| ((DWORD)ts.tm_hour << 11) | ((DWORD)ts.tm_min << 5) | ((DWORD)ts.tm_sec >> 1);
 }
 
 
 /***************************************************************************//**
- * @brief Delays number of msTick Systicks (typically 1 ms)
- * @param dlyTicks Number of ticks to delay
+ * @brief Busy waits a number of milliseconds on the RTC
+ * @param dlyTicks Number of ms to delay
  ******************************************************************************/
 void Delay(uint32_t dlyTicks)
 {
-	uint32_t curTicks;
+	uint64_t start;
 
-	curTicks = msec;
-	while ((msec - curTicks) < dlyTicks);
+	start = BSP_RTC_getTimeUs();
+	while ((BSP_RTC_getTimeUs() - start) < (uint64_t)dlyTicks * 1000);
 }
 
 
@@ -57,10 +71,12 @@ int main(void)
 
 	// set up general clocks
 	CMU_OscillatorEnable(cmuOsc_HFXO, true, true);
-	CMU_OscillatorEnable(cmuOsc_LFRCO, true, true);
+	CMU_OscillatorEnable(cmuOsc_LFXO, true, true);
 
+	// The RTC timebase and the ADC trigger run from the 32.768 kHz crystal, so the
+	// OBC time drifts by tens of ppm, inside the range FSW_HANDH_trimTime corrects
 	CMU_ClockSelectSet(cmuClock_HF,  cmuSelect_HFXO);
-	CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFRCO);
+	CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO);
 
 	CMU_ClockEnable(cmuClock_CORELE, true);
 
@@ -68,7 +84,8 @@ int main(void)
 
 	BSP_WDG_Init (false, false);
 	BSP_RTC_Init();
-	//BSP_EBI_Init();
+	BSP_EBI_Init();			// The external SRAM holds the housekeeping series
+	BSP_TRACE_Init();		// Records the kernel from the first queue the modules create
 	BSP_ADC_Init();
 
 	// Initializes UART and I2C communications
@@ -77,6 +94,7 @@ int main(void)
 
 	// Flight Software************************************************************************************************************************************
 	// Primary initialization
+	FSW_CMDPOOL_Init();		// Command blocks must be available before any module sends a command
 	// First initialize the satellite mode so other modules know how to behave after initializing
 	FSW_MODES_Init();
 	FSW_CDH_Init();
@@ -90,9 +108,12 @@ int main(void)
 	FSW_PAYLOAD_Init();
 	FSW_FS_Init();
 
+	// Periodic jobs use the modules' queues
+	FSW_PERIODIC_Init();
+
 #ifndef HIL_sim
 	printingMutex = xSemaphoreCreateMutex();
-	xTaskCreate( HIL_TransceiverRX, "TaskTest", 240, NULL, 1, NULL );				// Prints the menu for test tasks and accepts user input
+	FSW_TASK_CREATE( HIL_TransceiverRX, "TaskTest", HIL_stack, NULL, 1 );			// Prints the menu for test tasks and accepts user input
 #endif
 
 	//xTaskCreate( print_heap_space, "heap", 170, NULL, 1, NULL );
@@ -118,11 +139,19 @@ void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName
 	for( ;; );
 }
 
+void vApplicationMallocFailedHook( void )
+{
+	/* The heap is only allocated from while the modules are initialised, so a
+	failure means configTOTAL_HEAP_SIZE is too small for the kernel objects
+	they create. The heap left over is xPortGetFreeHeapSize() after init. */
+	for( ;; );
+}
+
 void vApplicationIdleHook( void )
 {
-	/* Use the idle task to place the CPU into a low power mode.  Greater power
-	saving could be achieved by not including any demo tasks that never block. */
-	//prvLowPowerMode1();
+	/* The idle task sleeps with the tick stopped whenever no task is due for
+	two ticks or more, see vPortSuppressTicksAndSleep in bsp_sleep.c. Sleeping
+	here as well would only wake the core once more per idle period. */
 }
 
 void print_heap_space( void *pvParameters )
@@ -0,0 +1,77 @@
+/***************************************************************************//**
+ * @file	FreeRTOSConfig.h
+ * @brief	FreeRTOS configuration for the host (POSIX) build.
+ *
+ * Pulls in the flight configuration unchanged and only overrides what differs
+ * on a 64-bit host: stack words and TCBs are twice the size, so the heap is
+ * scaled up, and the queue trace hooks also feed the benchmark instrumentation.
+ *
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FREERTOS_CONFIG_POSIX_H
+#define FREERTOS_CONFIG_POSIX_H
+
+#include "../FreeRTOSConfig.h"
+
+#undef  configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 256 * 1024 ) )	// 64-bit stack words and TCBs
+
+#undef  configUSE_MALLOC_FAILED_HOOK
+#define configUSE_MALLOC_FAILED_HOOK	0		// The benches check the handles, and the heap left, themselves
+
+#undef  configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE			0		// The tick is a timer signal
+
+// Run time is counted by the host clock at the RTC's rate, as the benches link the kernel without the BSP
+#include <time.h>
+
+static inline uint32_t ulHostRunTimeCounter( void )
+{
+	struct timespec now;
+
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return ( uint32_t )( ( uint64_t )now.tv_sec * 32768 + ( ( uint64_t )now.tv_nsec << 15 ) / 1000000000ULL );
+}
+
+#undef  portGET_RUN_TIME_COUNTER_VALUE
+#define portGET_RUN_TIME_COUNTER_VALUE()	ulHostRunTimeCounter()
+
+/* Queue instrumentation used by the host benchmark (see bench.c). */
+extern void vHostTraceQueueSend( void *pxQueue );
+extern void vHostTraceQueueSendFailed( void *pxQueue );
+extern void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer );
+
+/* They run before the trace recorder's hooks, which every host build links. */
+#undef  traceQUEUE_SEND
+#undef  traceQUEUE_SEND_FAILED
+#undef  traceQUEUE_RECEIVE
+#define traceQUEUE_SEND( pxQueue )				( vHostTraceQueueSend( pxQueue ), \
+		BSP_TRACE_queueEvent( BSP_TRACE_SEND, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting + 1 ) )
+#define traceQUEUE_SEND_FAILED( pxQueue )		( vHostTraceQueueSendFailed( pxQueue ), \
+		BSP_TRACE_queueEvent( BSP_TRACE_SENDFAIL, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting ) )
+#define traceQUEUE_RECEIVE( pxQueue )			( vHostTraceQueueReceive( pxQueue, pvBuffer ), \
+		BSP_TRACE_queueEvent( BSP_TRACE_RECEIVE, ( pxQueue )->ucQueueNumber, ( pxQueue )->uxMessagesWaiting - 1 ) )
+
+#endif /* FREERTOS_CONFIG_POSIX_H */
@@ -0,0 +1,495 @@
+/***************************************************************************//**
+ * @file	adcbench.c
+ * @brief	Host test and benchmark of the ADC sampling engine.
+ *
+ * Runs bsp_adc.c against the trigger, ADC and DMA model in adcmodel.c,
+ * without the RTOS.
+ *
+ * Every 16 bit scan result and every temperature reading between -70 and
+ * +120 degrees is converted, a value per sample, and compared with the exact
+ * conversion: the integer scaling must stay within rounding of it, where the
+ * truncating float conversion it replaces was up to 1 mV and 1/256 degree low.
+ * Gaussian noise on a channel must be reduced by the square root of its
+ * decimation, down to the 1 mV resolution of a value, a sawtooth must give the
+ * window minimum, maximum and mean, and each channel must produce values at the
+ * scan rate over its decimation. The scan rate must be the nearest to the one
+ * set that the LETIMER0 divider gives, stopping the ADC must stop the scans
+ * and release the EM1 hold until it is started again, a burst must run
+ * exactly BSP_ADC_BURST scans, complete a window at the default configuration
+ * and release its hold, and the DMA callbacks are timed with no result lost.
+ *
+ * Usage: fsw_adcbench [-s seconds] [-r seed]
+ *   -s  seconds of sampling timed (default 60)
+ *   -r  seed of the noise (default 1)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "adcmodel.h"
+#include "bsp_adc.h"
+#include "bsp_dma.h"
+
+#define ADCBENCH_SECONDS		60			///< Default seconds of sampling timed.
+#define ADCBENCH_READINGS		2000		///< Readings of a noisy channel at each decimation.
+#define ADCBENCH_NOISE			1024.0		///< Standard deviation of the noise, in 16 bit LSB, well above the 1 mV of a value.
+#define ADCBENCH_SAWSTEP		256			///< Sawtooth step per scan, in 16 bit LSB.
+#define ADCBENCH_MV( lsb )		( ( lsb ) * 1250.0 / 65536.0 )		///< Exact scan conversion.
+
+/// Exact temperature conversion, in 1/256 degrees. Reference manual section 28.3.4.2.
+#define ADCBENCH_TEMP( raw )	( ( HOST_ADC_CALTEMP + ( HOST_ADC_CALREAD - ( int32_t )( raw ) ) * 1250.0 / 4096.0 / 1.92 ) * 256.0 )
+
+/// Signal on an ADC input.
+typedef struct
+{
+	enum { ADCBENCH_CONST, ADCBENCH_NOISY, ADCBENCH_SAW } kind;
+	uint16_t level;			///< Constant level, mean of the noise or bottom of the sawtooth.
+	uint16_t period;		///< Scans per sawtooth.
+} ADCBENCH_Signal_TypeDef;
+
+static ADCBENCH_Signal_TypeDef signal[CHANNELCOUNT];
+static uint32_t adcbenchSeconds = ADCBENCH_SECONDS;
+static uint32_t adcbenchSeed = 1;
+
+// FUNCTIONS *******************************************************************
+
+static uint32_t ADCBENCH_random( void )
+{
+	adcbenchSeed ^= adcbenchSeed << 13;
+	adcbenchSeed ^= adcbenchSeed >> 17;
+	adcbenchSeed ^= adcbenchSeed << 5;
+
+	return adcbenchSeed;
+}
+
+static double ADCBENCH_gaussian( void )
+{
+	double u1 = ( ADCBENCH_random() + 1.0 ) / 4294967296.0;
+	double u2 = ADCBENCH_random() / 4294967296.0;
+
+	return sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * M_PI * u2 );
+}
+
+static uint16_t ADCBENCH_input( uint32_t scan, void *arg )
+{
+	const ADCBENCH_Signal_TypeDef *s = arg;
+	double v;
+
+	switch( s->kind )
+	{
+	case ADCBENCH_NOISY:
+		v = s->level + ADCBENCH_gaussian() * ADCBENCH_NOISE + 0.5;
+		return ( uint16_t )( v < 0 ? 0 : v > 65535 ? 65535 : v );
+	case ADCBENCH_SAW:
+		return s->level + ( scan % s->period ) * ADCBENCH_SAWSTEP;
+	default:
+		return s->level;
+	}
+}
+
+/*
+ * Starts sampling afresh at the default rate, every channel constant at level
+ * and configured with decimation and window.
+ */
+static void ADCBENCH_start( uint16_t level, uint16_t decimation, uint16_t window )
+{
+	unsigned int c;
+
+	BSP_ADC_stop();
+	HOST_ADC_Init();
+	for( c = 0; c < CHANNELCOUNT; c++ )
+	{
+		signal[c].kind = ADCBENCH_CONST;
+		signal[c].level = level;
+		HOST_ADC_setInput( c, ADCBENCH_input, &signal[c] );
+	}
+
+	BSP_DMA_Init();
+	BSP_ADC_Init();
+	for( c = 0; c < CHANNELCOUNT; c++ )
+	{
+		BSP_ADC_configChannel( ( ADC_Channel_TypeDef )c, decimation, window );
+	}
+	BSP_ADC_start();
+}
+
+/*
+ * Converts every scan result and the temperature readings of -70 to +120
+ * degrees, one value per sample, against the exact conversion and the legacy
+ * one.
+ */
+static int ADCBENCH_accuracy( void )
+{
+	double err, worst = 0, sum = 0, legacyWorst = 0, legacySum = 0;
+	double tWorst = 0, tSum = 0, tLegacyWorst = 0, tLegacySum = 0;
+	uint32_t level, raw, temps = 0;
+	int result;
+
+	ADCBENCH_start( 0, 1, 1 );
+
+	for( level = 0; level <= 0xFFFF; level++ )
+	{
+		raw = level >> 4;
+		signal[CHANNEL0].level = level;
+		signal[TEMPERATURE].level = raw;
+		HOST_ADC_run( BSP_ADC_BLOCK );
+
+		err = BSP_ADC_getData( CHANNEL0 ) - ADCBENCH_MV( level );
+		sum += fabs( err );
+		worst = fmax( worst, fabs( err ) );
+		err = ( uint16_t )ADCBENCH_MV( level ) - ADCBENCH_MV( level );
+		legacySum += fabs( err );
+		legacyWorst = fmax( legacyWorst, fabs( err ) );
+
+		if( ( level & 0xF ) == 0 && raw >= 1400 && raw <= 2600 )
+		{
+			err = ( int16_t )BSP_ADC_getData( TEMPERATURE ) - ADCBENCH_TEMP( raw );
+			tSum += fabs( err );
+			tWorst = fmax( tWorst, fabs( err ) );
+			err = ( int16_t )ADCBENCH_TEMP( raw ) - ADCBENCH_TEMP( raw );
+			tLegacySum += fabs( err );
+			tLegacyWorst = fmax( tLegacyWorst, fabs( err ) );
+			temps++;
+		}
+	}
+
+	result = worst > 0.5 + 1e-9 || tWorst > 0.5 + 1e-9;
+
+	printf( "conversion, error against exact     mean     worst\n" );
+	printf( "  scan, mV           integer      %7.3f   %7.3f\n", sum / 65536, worst );
+	printf( "                     legacy float %7.3f   %7.3f\n", legacySum / 65536, legacyWorst );
+	printf( "  temperature, 1/256 integer      %7.3f   %7.3f\n", tSum / temps, tWorst );
+	printf( "  degrees            legacy float %7.3f   %7.3f\n", tLegacySum / temps, tLegacyWorst );
+	printf( "conversion %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Standard deviation, in mV, of readings of a noisy channel at a decimation.
+ */
+static double ADCBENCH_deviation( uint16_t decimation )
+{
+	double v, sum = 0, sumSq = 0;
+	uint32_t i;
+
+	ADCBENCH_start( 32768, decimation, 1 );
+	signal[CHANNEL0].kind = ADCBENCH_NOISY;
+
+	for( i = 0; i < ADCBENCH_READINGS; i++ )
+	{
+		// Readings are a block apart at least, so independent
+		HOST_ADC_run( decimation > BSP_ADC_BLOCK ? decimation : BSP_ADC_BLOCK );
+		v = BSP_ADC_getData( CHANNEL0 );
+		sum += v;
+		sumSq += v * v;
+	}
+
+	return sqrt( ( sumSq - sum * sum / ADCBENCH_READINGS ) / ( ADCBENCH_READINGS - 1 ) );
+}
+
+static int ADCBENCH_noise( void )
+{
+	static const uint16_t decimations[] = { 1, 16, 64, 256 };
+	double sigma1 = 0, sigma, expected;
+	unsigned int i;
+	int result = 0;
+
+	printf( "noise, %.0f LSB (%.2f mV) gaussian\n", ADCBENCH_NOISE, ADCBENCH_MV( ADCBENCH_NOISE ) );
+	printf( "  decimation  sigma, mV  reduction  expected\n" );
+	for( i = 0; i < sizeof( decimations ) / sizeof( decimations[0] ); i++ )
+	{
+		sigma = ADCBENCH_deviation( decimations[i] );
+		if( i == 0 )
+		{
+			sigma1 = sigma;
+		}
+		expected = sqrt( decimations[i] );
+		printf( "  %10u  %9.3f  %9.2f  %8.2f\n", decimations[i], sigma, sigma1 / sigma, expected );
+
+		// Within 15 % of the square root, while the noise left is above the 1 mV resolution
+		if( sigma1 / expected > 1.0 && fabs( sigma1 / sigma / expected - 1.0 ) > 0.15 )
+		{
+			result = 1;
+		}
+	}
+	printf( "noise %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * A sawtooth of a window's length must give the same minimum, maximum and
+ * mean in every window.
+ */
+static int ADCBENCH_window( void )
+{
+	const uint16_t base = 1000, period = 16;
+	BSP_ADC_Stats_TypeDef stats;
+	int16_t min, max, mean;
+	int32_t sum = 0;
+	uint32_t i, windows = 50;
+	int result;
+
+	ADCBENCH_start( base, 1, period );
+	signal[CHANNEL1].kind = ADCBENCH_SAW;
+	signal[CHANNEL1].period = period;
+
+	min = ( int16_t )floor( ADCBENCH_MV( base ) + 0.5 );
+	max = ( int16_t )floor( ADCBENCH_MV( base + ( period - 1 ) * ADCBENCH_SAWSTEP ) + 0.5 );
+	for( i = 0; i < period; i++ )
+	{
+		sum += ( int16_t )floor( ADCBENCH_MV( base + i * ADCBENCH_SAWSTEP ) + 0.5 );
+	}
+	mean = ( int16_t )( sum / period );
+
+	HOST_ADC_run( windows * period );
+	BSP_ADC_getStats( CHANNEL1, &stats );
+
+	result = stats.min != min || stats.max != max || stats.mean != mean || stats.window != period ||
+			 stats.windows != windows || stats.values != windows * period || BSP_ADC_getMean( CHANNEL1 ) != mean;
+
+	printf( "window of %u: min %d max %d mean %d mV over %lu windows, expected %d %d %d over %lu %s\n",
+			stats.window, stats.min, stats.max, stats.mean, ( unsigned long )stats.windows,
+			min, max, mean, ( unsigned long )windows, result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Every channel at its own decimation, over a second of sampling.
+ */
+static int ADCBENCH_rates( void )
+{
+	static const uint16_t decimations[CHANNELCOUNT] = { 1, 16, 64, 256, 1024 };
+	BSP_ADC_Stats_TypeDef stats;
+	uint32_t scans, expected;
+	unsigned int c;
+	int result = 0;
+
+	ADCBENCH_start( 2000, 1, 1 );
+	for( c = 0; c < CHANNELCOUNT; c++ )
+	{
+		BSP_ADC_configChannel( ( ADC_Channel_TypeDef )c, decimations[c], 4 );
+	}
+
+	scans = ( uint32_t )( HOST_ADC_rate() + 0.5 );
+	HOST_ADC_run( scans );
+
+	printf( "value rates over 1 s at %.1f scans/s\n  channel  decimation  values  expected\n", HOST_ADC_rate() );
+	for( c = 0; c < CHANNELCOUNT; c++ )
+	{
+		BSP_ADC_getStats( ( ADC_Channel_TypeDef )c, &stats );
+		expected = scans / decimations[c];
+		printf( "  %7u  %10u  %6lu  %8lu\n", c, decimations[c], ( unsigned long )stats.values, ( unsigned long )expected );
+		if( stats.values != expected || stats.windows != expected / 4 )
+		{
+			result = 1;
+		}
+	}
+	printf( "value rates %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+static int ADCBENCH_setRate( void )
+{
+	static const uint16_t rates[] = { 1, 100, 1000, 1024, 4096, 10000 };
+	double rate, expected;
+	unsigned int i;
+	int result = 0;
+
+	ADCBENCH_start( 2000, 1, 1 );
+
+	printf( "scan rate, LETIMER0 at %u Hz\n  set, Hz  triggered, Hz\n", HOST_ADC_LFHZ );
+	for( i = 0; i < sizeof( rates ) / sizeof( rates[0] ); i++ )
+	{
+		BSP_ADC_setRate( rates[i] );
+		rate = HOST_ADC_rate();
+		expected = rates[i] > BSP_ADC_MAXRATE_HZ ? BSP_ADC_MAXRATE_HZ : rates[i];
+		expected = HOST_ADC_LFHZ / floor( HOST_ADC_LFHZ / expected + 0.5 );		// Nearest the divider gives
+		printf( "  %7u  %13.2f\n", rates[i], rate );
+		if( fabs( rate / expected - 1.0 ) > 1e-9 )
+		{
+			result = 1;
+		}
+	}
+	printf( "scan rate %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Stops and restarts sampling: no scan may be triggered and no EM1 hold kept
+ * while stopped, and the values must continue once started again.
+ */
+static int ADCBENCH_stopStart( void )
+{
+	BSP_ADC_Stats_TypeDef stats;
+	uint32_t scans, values;
+	int result = 0;
+
+	ADCBENCH_start( 2000, 1, 1 );
+
+	BSP_ADC_stop();
+	BSP_ADC_stop();
+	scans = HOST_ADC_run( BSP_ADC_BLOCK * 4 );
+	printf( "stopped: %lu scans, EM1 holds %ld\n", ( unsigned long )scans, ( long )HOST_sleepHolds );
+	if( scans != 0 || HOST_sleepHolds != 0 )
+	{
+		result = 1;
+	}
+
+	BSP_ADC_start();
+	BSP_ADC_start();
+	BSP_ADC_getStats( CHANNEL0, &stats );
+	values = stats.values;
+	scans = HOST_ADC_run( BSP_ADC_BLOCK * 4 );
+	BSP_ADC_getStats( CHANNEL0, &stats );
+	printf( "started: %lu scans, %lu values, EM1 holds %ld\n", ( unsigned long )scans,
+			( unsigned long )( stats.values - values ), ( long )HOST_sleepHolds );
+	if( scans != BSP_ADC_BLOCK * 4 || stats.values - values != BSP_ADC_BLOCK * 4 || HOST_sleepHolds != 1 )
+	{
+		result = 1;
+	}
+	printf( "stop and start %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Runs bursts at the default configuration, with more scans offered than a
+ * burst takes: each must stop the trigger after BSP_ADC_BURST scans, complete
+ * one window of every channel and hold EM1 only while it runs.
+ */
+static int ADCBENCH_burst( void )
+{
+	BSP_ADC_Stats_TypeDef stats;
+	uint32_t scans, windows;
+	int32_t during;
+	unsigned int b;
+	int result = 0;
+
+	ADCBENCH_start( 2000, BSP_ADC_DECIMATION, BSP_ADC_WINDOW );
+	BSP_ADC_stop();
+
+	for( b = 0; b < 3; b++ )
+	{
+		BSP_ADC_getStats( TEMPERATURE, &stats );
+		windows = stats.windows;
+
+		BSP_ADC_burst();
+		BSP_ADC_burst();
+		during = HOST_sleepHolds;
+		scans = HOST_ADC_run( BSP_ADC_BURST * 2 );
+		BSP_ADC_getStats( TEMPERATURE, &stats );
+
+		printf( "burst %u: %lu scans, %lu windows, EM1 holds %ld during and %ld after\n", b, ( unsigned long )scans,
+				( unsigned long )( stats.windows - windows ), ( long )during, ( long )HOST_sleepHolds );
+		if( scans != BSP_ADC_BURST || stats.windows - windows != 1 || during != 1 || HOST_sleepHolds != 0 )
+		{
+			result = 1;
+		}
+	}
+	printf( "bursts %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Samples every channel, noisy, at the default rate and decimation, timing
+ * the DMA callbacks.
+ */
+static int ADCBENCH_timing( void )
+{
+	uint32_t scans;
+	unsigned int c;
+	double perSecond;
+	int result;
+
+	ADCBENCH_start( 30000, BSP_ADC_DECIMATION, BSP_ADC_WINDOW );
+	for( c = 0; c < CHANNELCOUNT; c++ )
+	{
+		signal[c].kind = ADCBENCH_NOISY;
+	}
+	signal[TEMPERATURE].level = HOST_ADC_CALREAD;
+
+	scans = ( uint32_t )( HOST_ADC_rate() + 0.5 ) * adcbenchSeconds;
+	HOST_ADC_run( scans );
+
+	perSecond = ( double )HOST_adcStats.interrupts / adcbenchSeconds;
+	result = HOST_adcStats.lost != 0 || HOST_adcStats.interrupts != scans / BSP_ADC_BLOCK * 2;
+
+	printf( "%lu s at %.0f scans/s: %lu results, %.0f interrupts/s, %lu lost\n", ( unsigned long )adcbenchSeconds,
+			HOST_ADC_rate(), ( unsigned long )( HOST_adcStats.scans * ( BSP_ADC_SCANCOUNT + 1 ) ), perSecond,
+			( unsigned long )HOST_adcStats.lost );
+	printf( "callbacks: %.0f host cycles each, worst %lu, %.1f per result, %.0f per second\n",
+			( double )HOST_adcStats.isrCycles / HOST_adcStats.interrupts, ( unsigned long )HOST_adcStats.isrWorst,
+			( double )HOST_adcStats.isrCycles / ( HOST_adcStats.scans * ( BSP_ADC_SCANCOUNT + 1 ) ),
+			( double )HOST_adcStats.isrCycles / adcbenchSeconds );
+	printf( "timing %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+int main( int argc, char **argv )
+{
+	int opt, result;
+
+	while( ( opt = getopt( argc, argv, "s:r:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 's':	adcbenchSeconds = strtoul( optarg, NULL, 0 );	break;
+		case 'r':	adcbenchSeed = strtoul( optarg, NULL, 0 );		break;
+		default:
+			fprintf( stderr, "usage: %s [-s seconds] [-r seed]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( adcbenchSeconds == 0 || adcbenchSeed == 0 )
+	{
+		fprintf( stderr, "seconds or seed 0\n" );
+		return 2;
+	}
+
+	printf( "ADC sampling engine, %u scans/s, %u scans per DMA block (modelled)\n", BSP_ADC_RATE_HZ, BSP_ADC_BLOCK );
+
+	result = ADCBENCH_accuracy();
+	result |= ADCBENCH_noise();
+	result |= ADCBENCH_window();
+	result |= ADCBENCH_rates();
+	result |= ADCBENCH_setRate();
+	result |= ADCBENCH_stopStart();
+	result |= ADCBENCH_burst();
+	result |= ADCBENCH_timing();
+
+	printf( "ADC sampling engine %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
@@ -0,0 +1,442 @@
+/***************************************************************************//**
+ * @file	adcmodel.c
+ * @brief	Host ADC, LETIMER and DMA model.
+ *
+ * Emulates the trigger chain and the parts of the DMA controller bsp_adc.c
+ * uses, behind the register blocks of adcmodel.h, so the sampling engine runs
+ * unmodified on the host. As in uartmodel.c, the emlib functions are
+ * implemented here on the driver's descriptor table.
+ *
+ * A scan is only triggered once the LETIMER0 is running and routed through
+ * PRS to the ADC channel both conversions are set to start on. Each result,
+ * taken from the channel's input function, is written through the active
+ * descriptor of its DMA channel, which is counted down as the controller does;
+ * a completed cycle carries on with the other descriptor and takes the
+ * interrupt, whose callback is timed in host cycles.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "adcmodel.h"
+#include "bsp_adc.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define ADC_CYCLES()		__builtin_ia32_rdtsc()		///< Time stamp counter. x86intrin.h clashes with the CMSIS macros.
+#else
+#define ADC_CYCLES()		0
+#endif
+
+#define DMA_CYCLE( descr )	( ( ( descr )->CTRL & _DMA_CTRL_CYCLE_CTRL_MASK ) >> _DMA_CTRL_CYCLE_CTRL_SHIFT )
+#define DMA_NMINUS1( descr )	( ( ( descr )->CTRL & _DMA_CTRL_N_MINUS_1_MASK ) >> _DMA_CTRL_N_MINUS_1_SHIFT )
+
+ADC_TypeDef HOST_adc0;								///< ADC registers seen by the driver.
+LETIMER_TypeDef HOST_letimer0;						///< LETIMER registers seen by the driver.
+DEVINFO_TypeDef HOST_devinfo =						///< Calibration seen by the driver.
+{
+	.CAL = HOST_ADC_CALTEMP << _DEVINFO_CAL_TEMP_SHIFT,
+	.ADC0CAL2 = HOST_ADC_CALREAD << _DEVINFO_ADC0CAL2_TEMP1V25_SHIFT,
+};
+
+HOST_ADC_Stats_TypeDef HOST_adcStats;
+
+extern DMA_DESCRIPTOR_TypeDef dmaControlBlock[];
+
+static DMA_CB_TypeDef *chanCb[DMA_CHAN_COUNT];		// Callbacks; the descriptors' USER word cannot hold a host pointer
+static bool     chanInt[DMA_CHAN_COUNT];
+static bool     chanAlt[DMA_CHAN_COUNT];			// Alternate descriptor active
+static int      scanChannel = -1;					// Channel requested by scan results
+static int      singleChannel = -1;					// Channel requested by single results
+
+static HOST_ADC_Input_TypeDef input[CHANNELCOUNT];
+static void    *inputArg[CHANNELCOUNT];
+
+static uint32_t scanInputs;							// Scan input mask
+static int      scanPrs = -1;						// PRS channel starting a scan, or -1
+static int      singlePrs = -1;						// PRS channel starting a single conversion, or -1
+static int      letimerPrs = -1;					// PRS channel carrying LETIMER0 output 0, or -1
+static bool     letimerOn;
+static uint32_t letimerTop;
+static uint32_t scanCount;
+
+// FUNCTIONS *******************************************************************
+
+static DMA_DESCRIPTOR_TypeDef *DMA_descr( unsigned int channel, bool primary )
+{
+	return primary ? &dmaControlBlock[channel] : &dmaControlBlock[16 + channel];
+}
+
+/*
+ * End address of a transfer, as the controller expects it in the descriptor.
+ */
+static void *DMA_end( void *start, uint32_t ctrl, uint32_t incMask, uint32_t incShift, unsigned int nMinus1 )
+{
+	uint32_t inc = ( ctrl & incMask ) >> incShift;
+
+	if( inc == 3 )		// _DMA_CTRL_SRC_INC_NONE, _DMA_CTRL_DST_INC_NONE
+	{
+		return start;
+	}
+	return ( uint8_t * )start + ( nMinus1 << inc );
+}
+
+/*
+ * Sets up a descriptor as DMA_Prepare and DMA_RefreshPingPong do. NULL
+ * addresses leave those of the previous cycle.
+ */
+static void DMA_setup( unsigned int channel, bool primary, uint32_t cycleCtrl, void *dst, void *src, unsigned int nMinus1 )
+{
+	DMA_DESCRIPTOR_TypeDef *descr = DMA_descr( channel, primary );
+	uint32_t tmp;
+
+	if( src )
+	{
+		descr->SRCEND = DMA_end( src, descr->CTRL, _DMA_CTRL_SRC_INC_MASK, _DMA_CTRL_SRC_INC_SHIFT, nMinus1 );
+	}
+	if( dst )
+	{
+		descr->DSTEND = DMA_end( dst, descr->CTRL, _DMA_CTRL_DST_INC_MASK, _DMA_CTRL_DST_INC_SHIFT, nMinus1 );
+	}
+
+	tmp  = descr->CTRL & ~( _DMA_CTRL_CYCLE_CTRL_MASK | _DMA_CTRL_N_MINUS_1_MASK );
+	tmp |= nMinus1 << _DMA_CTRL_N_MINUS_1_SHIFT;
+	tmp |= cycleCtrl << _DMA_CTRL_CYCLE_CTRL_SHIFT;
+	descr->CTRL = tmp;
+}
+
+/*
+ * Takes the interrupt of a completed cycle as DMA_IRQHandler does, timing the
+ * callback.
+ */
+static void DMA_interrupt( unsigned int channel )
+{
+	DMA_CB_TypeDef *cb = chanCb[channel];
+	uint32_t primaryCpy;
+	uint64_t t0, cycles;
+
+	if( !chanInt[channel] || !cb )
+	{
+		return;
+	}
+
+	HOST_adcStats.interrupts++;
+
+	primaryCpy = cb->primary;
+	cb->primary ^= 1;
+	if( cb->cbFunc )
+	{
+		t0 = ADC_CYCLES();
+		cb->cbFunc( channel, ( bool )primaryCpy, cb->userPtr );
+		cycles = ADC_CYCLES() - t0;
+
+		HOST_adcStats.isrCycles += cycles;
+		if( cycles > HOST_adcStats.isrWorst )
+		{
+			HOST_adcStats.isrWorst = ( uint32_t )cycles;
+		}
+	}
+}
+
+/*
+ * Writes a conversion result through the active descriptor of a channel,
+ * writing back the count as the controller does after each arbitration, and
+ * takes the interrupt when the cycle completes.
+ */
+static void DMA_result( int channel, uint16_t result )
+{
+	DMA_DESCRIPTOR_TypeDef *descr;
+	uint32_t cycle, nMinus1;
+
+	if( channel < 0 )
+	{
+		HOST_adcStats.lost++;
+		return;
+	}
+
+	descr = DMA_descr( channel, !chanAlt[channel] );
+	cycle = DMA_CYCLE( descr );
+	if( cycle == _DMA_CTRL_CYCLE_CTRL_INVALID )
+	{
+		// The channel has stopped; the result overflows the ADC
+		HOST_adcStats.lost++;
+		return;
+	}
+
+	nMinus1 = DMA_NMINUS1( descr );
+	*( ( uint16_t * )descr->DSTEND - nMinus1 ) = result;
+
+	if( nMinus1 > 0 )
+	{
+		descr->CTRL = ( descr->CTRL & ~_DMA_CTRL_N_MINUS_1_MASK ) | ( ( nMinus1 - 1 ) << _DMA_CTRL_N_MINUS_1_SHIFT );
+		return;
+	}
+
+	// Cycle complete: a ping-pong cycle carries on with the other descriptor
+	descr->CTRL &= ~_DMA_CTRL_CYCLE_CTRL_MASK;
+	if( cycle == _DMA_CTRL_CYCLE_CTRL_PINGPONG )
+	{
+		chanAlt[channel] = !chanAlt[channel];
+	}
+	DMA_interrupt( channel );
+}
+
+static uint16_t ADC_sample( unsigned int channel )
+{
+	return input[channel] ? input[channel]( scanCount, inputArg[channel] ) : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Stops the trigger, clears the inputs and resets the statistics.
+ ******************************************************************************/
+void HOST_ADC_Init( void )
+{
+	memset( &HOST_adcStats, 0, sizeof( HOST_adcStats ) );
+	memset( input, 0, sizeof( input ) );
+	letimerOn = false;
+	scanCount = 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Sets the input of a channel.
+ *
+ * @param[in] channel
+ *   CHANNEL0 to CHANNEL3 for the scan inputs, in order, or TEMPERATURE.
+ * @param[in] fn
+ *   Returns the result of each conversion; NULL for 0.
+ * @param[in] arg
+ *   Passed to fn.
+ ******************************************************************************/
+void HOST_ADC_setInput( unsigned int channel, HOST_ADC_Input_TypeDef fn, void *arg )
+{
+	if( channel < CHANNELCOUNT )
+	{
+		input[channel] = fn;
+		inputArg[channel] = arg;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Triggers scans as LETIMER0 underflows would. Each converts the scan inputs
+ * and then the temperature, and the DMA takes every result.
+ *
+ * @param[in] scans
+ *   Scans to trigger.
+ * @return
+ *   Scans triggered: 0 if the LETIMER0 is stopped or not routed to the ADC,
+ *   fewer than asked for if it was stopped while they ran.
+ ******************************************************************************/
+uint32_t HOST_ADC_run( uint32_t scans )
+{
+	uint32_t i;
+	unsigned int c, n;
+
+	if( !letimerOn || letimerPrs < 0 || ( scanPrs != letimerPrs && singlePrs != letimerPrs ) )
+	{
+		return 0;
+	}
+
+	// The engine may stop LETIMER0 from the DMA callbacks, ending a burst
+	for( i = 0; i < scans && letimerOn; i++ )
+	{
+		if( scanPrs == letimerPrs )
+		{
+			for( c = 0, n = 0; c < 8; c++ )
+			{
+				if( scanInputs & ( 1UL << ( _ADC_SCANCTRL_INPUTMASK_SHIFT + c ) ) )
+				{
+					DMA_result( scanChannel, ADC_sample( n++ ) );
+				}
+			}
+		}
+		if( singlePrs == letimerPrs )
+		{
+			DMA_result( singleChannel, ADC_sample( TEMPERATURE ) );
+		}
+		scanCount++;
+		HOST_adcStats.scans++;
+	}
+
+	return i;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns the scan rate the LETIMER0 is set to, underflowing every COMP0 + 1
+ * clocks.
+ ******************************************************************************/
+double HOST_ADC_rate( void )
+{
+	return ( double )HOST_ADC_LFHZ / ( letimerTop + 1 );
+}
+
+// EMLIB STAND-INS *************************************************************
+
+void DMA_Init( DMA_Init_TypeDef *init )
+{
+	memset( chanCb, 0, sizeof( chanCb ) );
+	scanChannel = -1;
+	singleChannel = -1;
+}
+
+void DMA_CfgChannel( unsigned int channel, DMA_CfgChannel_TypeDef *cfg )
+{
+	chanCb[channel] = cfg->cb;
+	chanInt[channel] = cfg->enableInt;
+
+	if( cfg->select == DMAREQ_ADC0_SCAN )
+	{
+		scanChannel = channel;
+	}
+	else if( cfg->select == DMAREQ_ADC0_SINGLE )
+	{
+		singleChannel = channel;
+	}
+}
+
+void DMA_CfgDescr( unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg )
+{
+	DMA_descr( channel, primary )->CTRL =
+		( cfg->dstInc << _DMA_CTRL_DST_INC_SHIFT ) |
+		( cfg->size << _DMA_CTRL_DST_SIZE_SHIFT ) |
+		( cfg->srcInc << _DMA_CTRL_SRC_INC_SHIFT ) |
+		( cfg->size << _DMA_CTRL_SRC_SIZE_SHIFT ) |
+		( ( uint32_t )( cfg->hprot ) << _DMA_CTRL_SRC_PROT_CTRL_SHIFT ) |
+		( cfg->arbRate << _DMA_CTRL_R_POWER_SHIFT ) |
+		DMA_CTRL_CYCLE_CTRL_INVALID;
+}
+
+void DMA_ActivatePingPong( unsigned int channel, bool useBurst,
+						   void *primDst, void *primSrc, unsigned int primNMinus1,
+						   void *altDst, void *altSrc, unsigned int altNMinus1 )
+{
+	DMA_setup( channel, false, dmaCycleCtrlPingPong, altDst, altSrc, altNMinus1 );
+	DMA_setup( channel, true, dmaCycleCtrlPingPong, primDst, primSrc, primNMinus1 );
+
+	if( chanCb[channel] )
+	{
+		chanCb[channel]->primary = true;
+	}
+	chanAlt[channel] = false;
+}
+
+void DMA_RefreshPingPong( unsigned int channel, bool primary, bool useBurst,
+						  void *dst, void *src, unsigned int nMinus1, bool stop )
+{
+	DMA_setup( channel, primary, stop ? dmaCycleCtrlBasic : dmaCycleCtrlPingPong, dst, src, nMinus1 );
+}
+
+void ADC_Init( ADC_TypeDef *adc, const ADC_Init_TypeDef *init )
+{
+}
+
+void ADC_InitScan( ADC_TypeDef *adc, const ADC_InitScan_TypeDef *init )
+{
+	scanInputs = init->input;
+	scanPrs = init->prsEnable ? ( int )init->prsSel : -1;
+}
+
+void ADC_InitSingle( ADC_TypeDef *adc, const ADC_InitSingle_TypeDef *init )
+{
+	singlePrs = init->prsEnable ? ( int )init->prsSel : -1;
+}
+
+uint8_t ADC_TimebaseCalc( uint32_t hfperFreq )
+{
+	return 0;
+}
+
+uint8_t ADC_PrescaleCalc( uint32_t adcFreq, uint32_t hfperFreq )
+{
+	return 0;
+}
+
+void LETIMER_Init( LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init )
+{
+	letimerOn = init->enable;
+}
+
+void LETIMER_CompareSet( LETIMER_TypeDef *letimer, unsigned int comp, uint32_t value )
+{
+	if( comp == 0 )
+	{
+		letimerTop = value;
+	}
+}
+
+void LETIMER_RepeatSet( LETIMER_TypeDef *letimer, unsigned int rep, uint32_t value )
+{
+}
+
+void LETIMER_Enable( LETIMER_TypeDef *letimer, bool enable )
+{
+	letimerOn = enable;
+}
+
+void PRS_SourceSignalSet( unsigned int ch, uint32_t source, uint32_t signal, PRS_Edge_TypeDef edge )
+{
+	if( source == PRS_CH_CTRL_SOURCESEL_LETIMER0 && signal == PRS_CH_CTRL_SIGSEL_LETIMER0CH0 )
+	{
+		letimerPrs = ch;
+	}
+	else if( letimerPrs == ( int )ch )
+	{
+		letimerPrs = -1;
+	}
+}
+
+void CMU_ClockEnable( CMU_Clock_TypeDef clock, bool enable )
+{
+}
+
+uint32_t CMU_ClockFreqGet( CMU_Clock_TypeDef clock )
+{
+	return ( clock == cmuClock_LETIMER0 ) ? HOST_ADC_LFHZ : 48000000;
+}
+
+// SLEEP STAND-INS *************************************************************
+
+int32_t HOST_sleepHolds = 0;
+
+void BSP_SLEEP_holdEM1( void )
+{
+	__sync_fetch_and_add( &HOST_sleepHolds, 1 );
+}
+
+void BSP_SLEEP_releaseEM1( void )
+{
+	__sync_fetch_and_sub( &HOST_sleepHolds, 1 );
+}
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ * @file	adcmodel.h
+ * @brief	Host ADC, LETIMER and DMA model.
+ *
+ * Force-included ahead of bsp_adc.c in the host build of the ADC benchmark.
+ * It points the ADC, LETIMER and calibration register blocks and the NVIC
+ * functions at host memory, so the sampling engine runs unmodified against
+ * the trigger and DMA controller model in adcmodel.c.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __ADCMODEL_H
+#define __ADCMODEL_H
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_adc.h"
+#include "em_letimer.h"
+#include "em_prs.h"
+#include "em_dma.h"
+
+extern ADC_TypeDef HOST_adc0;
+extern LETIMER_TypeDef HOST_letimer0;
+extern DEVINFO_TypeDef HOST_devinfo;
+
+// Register blocks seen by the driver. The device header is include guarded,
+// so these survive its later inclusion by bsp_adc.h.
+#undef  ADC0
+#undef  LETIMER0
+#undef  DEVINFO
+#define ADC0		( &HOST_adc0 )
+#define LETIMER0	( &HOST_letimer0 )
+#define DEVINFO		( &HOST_devinfo )
+
+// The CMSIS NVIC functions are inline and already bound to the core's address.
+#define NVIC_EnableIRQ( irq )				( ( void )( irq ) )
+#define NVIC_DisableIRQ( irq )				( ( void )( irq ) )
+#define NVIC_ClearPendingIRQ( irq )			( ( void )( irq ) )
+#define NVIC_SetPriority( irq, priority )	( ( void )( irq ) )
+
+#define HOST_ADC_LFHZ		32768			///< LETIMER0 clock.
+#define HOST_ADC_CALTEMP	25				///< Calibration temperature in the model's DEVINFO.
+#define HOST_ADC_CALREAD	2000			///< Temperature sensor reading at the calibration temperature.
+
+/// Input of an ADC channel: the raw result of a conversion, 16 bit oversampled
+/// for the scan channels and 12 bit for the temperature, at a scan.
+typedef uint16_t ( *HOST_ADC_Input_TypeDef )( uint32_t scan, void *arg );
+
+/// What the model counted.
+typedef struct
+{
+	uint32_t	scans;			///< Scans triggered.
+	uint32_t	interrupts;		///< DMA interrupts taken.
+	uint32_t	lost;			///< Results the DMA could not take, its cycle having stopped.
+	uint64_t	isrCycles;		///< Host cycles spent in the DMA callbacks.
+	uint32_t	isrWorst;		///< Most host cycles spent in one callback.
+} HOST_ADC_Stats_TypeDef;
+
+extern HOST_ADC_Stats_TypeDef HOST_adcStats;
+
+void     HOST_ADC_Init( void );												///< Reset the model and its statistics.
+void     HOST_ADC_setInput( unsigned int channel, HOST_ADC_Input_TypeDef input, void *arg );	///< Set the input of a channel.
+uint32_t HOST_ADC_run( uint32_t scans );									///< Trigger scans, taking the interrupts they raise.
+double   HOST_ADC_rate( void );												///< Scans per second the LETIMER0 is set to trigger.
+
+/// EM1 holds the driver has taken and not released. The host never sleeps,
+/// so they are only counted, to check that they balance.
+extern int32_t HOST_sleepHolds;
+
+#endif // __ADCMODEL_H
@@ -0,0 +1,1358 @@
+/***************************************************************************//**
+ * @file	bench.c
+ * @brief	Command dispatch benchmark for the host build.
+ *
+ * Floods FSW_CDH_CMDqueue with health status requests addressed to every
+ * module and measures, per destination, the end-to-end dispatch latency from
+ * the telecommand entering the C&DH queue to the destination manager taking it
+ * off its own queue. The queue trace hooks also record the high-water mark of
+ * every FSW queue and every send that was dropped because a queue was full.
+ * Commands travel as command pool handles, so the pool usage is reported too.
+ *
+ * BENCH_scheduler() separately times the time-tagged command scheduler on its
+ * own, outside the RTOS, BENCH_router() compares the routing table lookup
+ * with the switch statements it replaced, and BENCH_logger() compares the
+ * binary log records and buffered log writer with the text entries and
+ * per-entry file access they replaced. BENCH_cache() measures the card
+ * traffic of the three flight logs with and without the sector cache.
+ * BENCH_telemetry() times the telemetry replies served from the telemetry
+ * store against the switch that gathered them in the reply path.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "includes.h"
+#include "fsw_scheduler.h"
+#include "fsw_cmdpool.h"
+#include "fsw_logwriter.h"
+#include "fsw_logformat.h"
+#include "fsw_link.h"
+#include "fsw_tlmstore.h"
+#include "host.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define BENCH_CYCLES()		__builtin_ia32_rdtsc()		///< Time stamp counter. x86intrin.h clashes with the CMSIS macros.
+#define BENCH_TLMTICKS()	BENCH_CYCLES()
+#define BENCH_TLMUNIT		"cycles"
+#else
+#define BENCH_TLMTICKS()	BENCH_now()
+#define BENCH_TLMUNIT		"ns"
+#endif
+
+#define BENCH_MAGIC			0xBE000000		///< Tag in params[0] marking benchmark commands.
+#define BENCH_SEQMASK		0x00FFFFFF		///< Sequence number field of params[0].
+#define BENCH_MAXCMDS		1000000			///< Upper bound on commands per run.
+#define BENCH_SETTLE_MS		2000			///< Time given to the modes module to leave detumbling.
+#define BENCH_DRAIN_MS		2000			///< Time allowed for the last commands to be dispatched.
+#define BENCH_RING_SECTORS	16				///< Ring size for the log writer runs. Small, so that they wrap.
+#define BENCH_CACHE_FLUSH	48				///< Entries between timeout flushes in the cache runs, about LOG_FLUSH_MS of logging.
+#define BENCH_TLM_TORNID	0x9F			///< Telemetry store entry no module publishes, for the torn read test.
+
+/// A command queue whose dispatch latency is measured.
+typedef struct
+{
+	const char		*name;
+	uint8_t			dest;
+	xQueueHandle	*queue;
+	uint32_t		sent;
+	uint32_t		dispatched;
+	uint32_t		*latency;		///< Dispatch latencies in ns, one per dispatched command.
+} BENCH_Dest_TypeDef;
+
+/// A queue whose depth is tracked.
+typedef struct
+{
+	const char		*name;
+	xQueueHandle	*queue;
+	uint32_t		length;
+	uint32_t		hwm;
+	uint32_t		dropped;
+} BENCH_Queue_TypeDef;
+
+static BENCH_Dest_TypeDef dests[] =
+{
+	{ "ADCS",    FSW_ADCS,    &FSW_ADCS_CMDqueue },
+	{ "CDH",     FSW_CDH,     &FSW_CDH_CMDqueue },
+	{ "COMM",    FSW_COMM,    &FSW_COMM_CMDqueue },
+	{ "FS",      FSW_FS,      &FSW_FS_CMDqueue },
+	{ "HANDH",   FSW_HANDH,   &FSW_HANDH_CMDqueue },
+	{ "MODES",   FSW_MODES,   &FSW_MODES_CMDqueue },
+	{ "PAYLOAD", FSW_PAYLOAD, &FSW_PAYLOAD_CMDqueue },
+	{ "POWER",   FSW_POWER,   &FSW_POWER_CMDqueue },
+};
+#define BENCH_DESTCOUNT		( sizeof( dests ) / sizeof( dests[0] ) )
+
+static BENCH_Queue_TypeDef queues[] =
+{
+	{ "CDH_CMD",     &FSW_CDH_CMDqueue,     6 },
+	{ "CDH_DIARY",   &FSW_CDH_DIARYqueue,   6 },
+	{ "ADCS_CMD",    &FSW_ADCS_CMDqueue,    6 },
+	{ "COMM_CMD",    &FSW_COMM_CMDqueue,    6 },
+	{ "COMM_I2C",    &FSW_COMM_I2Cqueue,    6 },
+	{ "FS_CMD",      &FSW_FS_CMDqueue,      6 },
+	{ "FS_LOG",      &FSW_FS_LOGqueue,      6 },
+	{ "HANDH_CMD",   &FSW_HANDH_CMDqueue,   6 },
+	{ "HANDH_DATA",  &FSW_HANDH_DATAqueue,  6 },
+	{ "MODES_CMD",   &FSW_MODES_CMDqueue,   6 },
+	{ "PAYLOAD_CMD", &FSW_PAYLOAD_CMDqueue, 6 },
+	{ "POWER_CMD",   &FSW_POWER_CMDqueue,   6 },
+};
+#define BENCH_QUEUECOUNT	( sizeof( queues ) / sizeof( queues[0] ) )
+
+static uint32_t benchCount;				///< Commands to send this run.
+static uint64_t *sendTime;				///< Enqueue timestamp of every command, indexed by sequence number.
+static int      benchResult = 1;
+static size_t   heapStart;				///< Heap free once the scheduler ran, the FSW allocates nothing after.
+static volatile uintptr_t BENCH_sink;	///< Keeps the router benchmark results live.
+
+// FUNCTIONS *******************************************************************
+
+static uint64_t BENCH_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int BENCH_compare( const void *a, const void *b )
+{
+	uint32_t x = *( const uint32_t* )a;
+	uint32_t y = *( const uint32_t* )b;
+
+	return ( x > y ) - ( x < y );
+}
+
+/*
+ * Returns the p-th percentile (0..100) of a sorted array, in microseconds.
+ */
+static double BENCH_percentile( const uint32_t *sorted, uint32_t n, double p )
+{
+	uint32_t i;
+
+	if( n == 0 )
+	{
+		return 0.0;
+	}
+
+	i = ( uint32_t )( ( p / 100.0 ) * ( n - 1 ) + 0.5 );
+	return sorted[i] / 1000.0;
+}
+
+static BENCH_Queue_TypeDef *BENCH_findQueue( void *pxQueue )
+{
+	uint32_t i;
+
+	for( i = 0; i < BENCH_QUEUECOUNT; i++ )
+	{
+		if( *queues[i].queue == pxQueue )
+		{
+			return &queues[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void BENCH_report( uint64_t sendNs, uint64_t totalNs )
+{
+	uint32_t i, dispatched = 0, dropped = 0;
+	BENCH_Dest_TypeDef *d;
+	FSW_CMDPOOL_Stats_TypeDef pool;
+	CDH_RouteStats_TypeDef route;
+	FSW_PERIODIC_Stats_TypeDef job;
+
+	printf( "\nFSW command dispatch benchmark: %u commands to %u destinations\n",
+			( unsigned )benchCount, ( unsigned )BENCH_DESTCOUNT );
+	printf( "%-8s %8s %10s %9s %9s %9s %9s\n", "dest", "sent", "dispatched", "p50[us]", "p90[us]", "p99[us]", "max[us]" );
+
+	for( i = 0; i < BENCH_DESTCOUNT; i++ )
+	{
+		d = &dests[i];
+		qsort( d->latency, d->dispatched, sizeof( uint32_t ), BENCH_compare );
+		printf( "%-8s %8u %10u %9.1f %9.1f %9.1f %9.1f\n", d->name, ( unsigned )d->sent, ( unsigned )d->dispatched,
+				BENCH_percentile( d->latency, d->dispatched, 50 ), BENCH_percentile( d->latency, d->dispatched, 90 ),
+				BENCH_percentile( d->latency, d->dispatched, 99 ), BENCH_percentile( d->latency, d->dispatched, 100 ) );
+		dispatched += d->dispatched;
+	}
+
+	printf( "\n%-12s %6s %6s %8s\n", "queue", "length", "hwm", "dropped" );
+	for( i = 0; i < BENCH_QUEUECOUNT; i++ )
+	{
+		printf( "%-12s %6u %6u %8u\n", queues[i].name, ( unsigned )queues[i].length,
+				( unsigned )queues[i].hwm, ( unsigned )queues[i].dropped );
+		dropped += queues[i].dropped;
+	}
+
+	printf( "\nsend phase %.1f ms, %.0f cmd/s offered; %u dispatched, %u dropped, %.0f cmd/s sustained\n",
+			sendNs / 1e6, benchCount / ( sendNs / 1e9 ), ( unsigned )dispatched, ( unsigned )dropped,
+			dispatched / ( totalNs / 1e9 ) );
+	FSW_CDH_getRouteStats( &route );
+	printf( "router: %u commands rejected, last error %u (dest %u id 0x%02X)\n", ( unsigned )route.rejected,
+			( unsigned )route.lastError, ( unsigned )route.lastDest, ( unsigned )route.lastId );
+	FSW_CMDPOOL_getStats( &pool );
+	printf( "command pool: %u of %u blocks in use, hwm %u, %u allocations, %u refused\n", ( unsigned )pool.inUse,
+			( unsigned )CDH_CMDPOOL_LEN, ( unsigned )pool.hwm, ( unsigned )pool.allocs, ( unsigned )pool.exhausted );
+	printf( "heap free %u bytes, %u allocated since the scheduler started\n", ( unsigned )xPortGetFreeHeapSize(),
+			( unsigned )( heapStart - xPortGetFreeHeapSize() ) );
+	for( i = 0; i < FSW_PERIODIC_count(); i++ )
+	{
+		// Timed to the tick on the host
+		FSW_PERIODIC_getStats( ( uint8_t )i, &job );
+		printf( "periodic job %u: %u releases, %u deadlines missed, worst start %u us, response %u us\n", ( unsigned )i,
+				( unsigned )job.releases, ( unsigned )job.misses, ( unsigned )job.worstJitterUs, ( unsigned )job.worstResponseUs );
+	}
+
+	benchResult = ( dispatched + dropped >= benchCount && xPortGetFreeHeapSize() == heapStart ) ? 0 : 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Times insert, peek, cancel and pop on a command schedule holding count
+ * commands spread over a day, and checks that due commands come out in
+ * execution time order.
+ *
+ * @param[in] count
+ *   Number of commands to schedule.
+ * @return
+ *   0 on success, 1 if the schedule misbehaved.
+ ******************************************************************************/
+int BENCH_scheduler( uint32_t count )
+{
+	FSW_SCHED_TypeDef sched;
+	FSW_SCHED_Entry_TypeDef *pool;
+	uint16_t *heap, *freeSlots, *handles;
+	CDH_CMD_TypeDef cmd;
+	const CDH_CMD_TypeDef *next;
+	uint32_t i, j, rnd = 12345, cancelled = 0, popped = 0, lastTime = 0, peekSum = 0;
+	uint64_t t0, tInsert, tPeek, tCancel, tPop;
+	int result = 0;
+
+	if( count >= FSW_SCHED_NONE )
+	{
+		count = FSW_SCHED_NONE - 1;
+	}
+
+	pool = calloc( count, sizeof( FSW_SCHED_Entry_TypeDef ) );
+	heap = calloc( count, sizeof( uint16_t ) );
+	freeSlots = calloc( count, sizeof( uint16_t ) );
+	handles = calloc( count, sizeof( uint16_t ) );
+	FSW_SCHED_Init( &sched, pool, heap, freeSlots, count );
+	memset( &cmd, 0, sizeof( cmd ) );
+
+	t0 = BENCH_now();
+	for( i = 0; i < count; i++ )
+	{
+		rnd = rnd * 1103515245 + 12345;
+		cmd.exe_time = 1000000 + ( rnd >> 8 ) % 86400;
+		cmd.id = ( uint8_t )i;
+		handles[i] = FSW_SCHED_insert( &sched, &cmd );
+		if( handles[i] == FSW_SCHED_NONE )
+		{
+			result = 1;
+		}
+	}
+	tInsert = BENCH_now() - t0;
+
+	t0 = BENCH_now();
+	for( i = 0; i < count; i++ )
+	{
+		next = FSW_SCHED_peek( &sched );
+		peekSum += next->exe_time;
+	}
+	tPeek = BENCH_now() - t0;
+
+	// Cancel every other command, in a scattered order
+	t0 = BENCH_now();
+	for( i = 0, j = 0; i < count; i++, j = ( j + 7919 ) % count )
+	{
+		if( ( j & 1 ) == 0 )
+		{
+			cancelled += FSW_SCHED_cancel( &sched, handles[j] );
+		}
+	}
+	tCancel = BENCH_now() - t0;
+
+	t0 = BENCH_now();
+	while( FSW_SCHED_popDue( &sched, 0xFFFFFFFF, &cmd ) )
+	{
+		if( cmd.exe_time < lastTime )
+		{
+			result = 1;
+		}
+		lastTime = cmd.exe_time;
+		popped++;
+	}
+	tPop = BENCH_now() - t0;
+
+	if( cancelled + popped != count || FSW_SCHED_peek( &sched ) != NULL )
+	{
+		result = 1;
+	}
+
+	printf( "\nFSW command scheduler benchmark: %u commands (capacity %u)\n", ( unsigned )count, ( unsigned )count );
+	printf( "insert %7.1f ns/op\n", ( double )tInsert / count );
+	printf( "peek   %7.1f ns/op\n", ( double )tPeek / count );
+	printf( "cancel %7.1f ns/op (%u cancelled)\n", cancelled ? ( double )tCancel / cancelled : 0.0, ( unsigned )cancelled );
+	printf( "pop    %7.1f ns/op (%u popped, order %s)\n", popped ? ( double )tPop / popped : 0.0, ( unsigned )popped,
+			result ? "BROKEN" : "ok" );
+
+	free( pool );
+	free( heap );
+	free( freeSlots );
+	free( handles );
+
+	return result;
+}
+
+/*
+ * Routing as FSW_CDH_processCMD and the module managers did it before the
+ * routing table: a switch on the destination picks the queue and the
+ * destination's own switch on the id picks the action. Returns 0 where the old
+ * code trapped in a default case.
+ */
+static uintptr_t BENCH_switchRoute( const CDH_CMD_TypeDef *cmd )
+{
+	static const uint8_t actions[CDH_ROUTE_DESTCOUNT * CDH_ROUTE_IDCOUNT];	// Stand-ins for the handlers
+	xQueueHandle *queue;
+
+	switch( cmd->dest )
+	{
+	case FSW_ADCS:		queue = &FSW_ADCS_CMDqueue;		break;
+	case FSW_CDH:		queue = NULL;					break;
+	case FSW_COMM:		queue = &FSW_COMM_CMDqueue;		break;
+	case FSW_FS:		queue = &FSW_FS_CMDqueue;		break;
+	case FSW_HANDH:		queue = &FSW_HANDH_CMDqueue;	break;
+	case FSW_MODES:		queue = &FSW_MODES_CMDqueue;	break;
+	case FSW_PAYLOAD:	queue = &FSW_PAYLOAD_CMDqueue;	break;
+	case FSW_POWER:		queue = &FSW_POWER_CMDqueue;	break;
+	default:			return 0;
+	}
+
+	switch( cmd->dest )
+	{
+	case FSW_ADCS:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[0];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[1];
+		case 0x03:	return ( uintptr_t )queue + ( uintptr_t )&actions[2];
+		case 0x04:	return ( uintptr_t )queue + ( uintptr_t )&actions[3];
+		case 0x05:	return ( uintptr_t )queue + ( uintptr_t )&actions[4];
+		case 0x06:	return ( uintptr_t )queue + ( uintptr_t )&actions[5];
+		default:	return 0;
+		}
+	case FSW_CDH:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )&actions[8];
+		case 0x02:	return ( uintptr_t )&actions[9];
+		default:	return 0;
+		}
+	case FSW_COMM:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[16];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[17];
+		default:	return 0;
+		}
+	case FSW_FS:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[24];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[25];
+		default:	return 0;
+		}
+	case FSW_HANDH:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[32];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[33];
+		case 0x03:	return ( uintptr_t )queue + ( uintptr_t )&actions[34];
+		default:	return 0;
+		}
+	case FSW_MODES:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[40];
+		case 0x03:	return ( uintptr_t )queue + ( uintptr_t )&actions[42];
+		default:	return 0;
+		}
+	case FSW_PAYLOAD:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[48];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[49];
+		default:	return 0;
+		}
+	default:
+		switch( cmd->id )
+		{
+		case 0x01:	return ( uintptr_t )queue + ( uintptr_t )&actions[56];
+		case 0x02:	return ( uintptr_t )queue + ( uintptr_t )&actions[57];
+		case 0x03:	return ( uintptr_t )queue + ( uintptr_t )&actions[58];
+		case 0x04:	return ( uintptr_t )queue + ( uintptr_t )&actions[59];
+		default:	return 0;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Routes count commands, spread over every valid destination and id, through
+ * FSW_CDH_route() and through the switch statements it replaced, and reports
+ * the time per command for each. The table lookup also validates the
+ * parameter count and satellite mode, which the switches did not.
+ *
+ * @param[in] count
+ *   Number of commands to route.
+ * @return
+ *   0 on success, 1 if the table rejected a command the switches accepted.
+ ******************************************************************************/
+int BENCH_router( uint32_t count )
+{
+	CDH_CMD_TypeDef *cmds;
+	CDH_CMD_TypeDef cmd;
+	const CDH_Route_TypeDef *route;
+	uint16_t valid[CDH_ROUTE_DESTCOUNT * CDH_ROUTE_IDCOUNT];
+	uint32_t i, validCount = 0, rnd = 12345, rejected = 0;
+	uintptr_t sumTable = 0, sumSwitch = 0;
+	uint64_t t0, tTable, tSwitch;
+#ifdef BENCH_CYCLES
+	uint64_t c0, cTable, cSwitch;
+#endif
+
+	// Every destination and id both routers accept
+	memset( &cmd, 0, sizeof( cmd ) );
+	cmd.len = CDH_CMD_PARAMLEN;
+	current_state = NOMINAL_MODE;
+	for( cmd.dest = 0; cmd.dest < CDH_ROUTE_DESTCOUNT; cmd.dest++ )
+	{
+		for( cmd.id = 0; cmd.id < CDH_ROUTE_IDCOUNT; cmd.id++ )
+		{
+			if( BENCH_switchRoute( &cmd ) != 0 && FSW_CDH_route( &cmd, &route ) == CDH_CMDERR_NONE )
+			{
+				valid[validCount++] = ( cmd.dest << 8 ) | cmd.id;
+			}
+		}
+	}
+
+	cmds = calloc( count, sizeof( CDH_CMD_TypeDef ) );
+	for( i = 0; i < count; i++ )
+	{
+		rnd = rnd * 1103515245 + 12345;
+		cmds[i].dest = valid[( rnd >> 8 ) % validCount] >> 8;
+		cmds[i].id = valid[( rnd >> 8 ) % validCount] & 0xFF;
+		cmds[i].len = CDH_CMD_PARAMLEN;
+	}
+
+	t0 = BENCH_now();
+#ifdef BENCH_CYCLES
+	c0 = BENCH_CYCLES();
+#endif
+	for( i = 0; i < count; i++ )
+	{
+		if( FSW_CDH_route( &cmds[i], &route ) == CDH_CMDERR_NONE )
+		{
+			sumTable += ( uintptr_t )route->queue + ( uintptr_t )route->handler;
+		}
+		else
+		{
+			rejected++;
+		}
+	}
+#ifdef BENCH_CYCLES
+	cTable = BENCH_CYCLES() - c0;
+#endif
+	tTable = BENCH_now() - t0;
+
+	t0 = BENCH_now();
+#ifdef BENCH_CYCLES
+	c0 = BENCH_CYCLES();
+#endif
+	for( i = 0; i < count; i++ )
+	{
+		sumSwitch += BENCH_switchRoute( &cmds[i] );
+	}
+#ifdef BENCH_CYCLES
+	cSwitch = BENCH_CYCLES() - c0;
+#endif
+	tSwitch = BENCH_now() - t0;
+
+	printf( "\nFSW command router benchmark: %u commands over %u destination/id pairs\n",
+			( unsigned )count, ( unsigned )validCount );
+#ifdef BENCH_CYCLES
+	printf( "table  %7.1f ns/cmd %7.1f cycles/cmd (validated, %u rejected)\n", ( double )tTable / count,
+			( double )cTable / count, ( unsigned )rejected );
+	printf( "switch %7.1f ns/cmd %7.1f cycles/cmd\n", ( double )tSwitch / count, ( double )cSwitch / count );
+#else
+	printf( "table  %7.1f ns/cmd (validated, %u rejected)\n", ( double )tTable / count, ( unsigned )rejected );
+	printf( "switch %7.1f ns/cmd\n", ( double )tSwitch / count );
+#endif
+
+	BENCH_sink = sumTable + sumSwitch;
+	free( cmds );
+	current_state = DETUMBLING_MODE;
+
+	return ( rejected != 0 ) ? 1 : 0;
+}
+
+/*
+ * Telemetry as processTLM gathered it in the reply path before the telemetry
+ * store: a switch on the ID calling the modules' getters. The comms counters,
+ * which live in comms.c, are stand-ins.
+ */
+static uint8_t BENCH_switchTLM( uint8_t id, uint8_t *txBuffer )
+{
+	static uint16_t tcmdCount, tlmCount, commsError;
+	static uint8_t lastTcmdId, lastTcmdError;
+	static FSW_LINK_RxStats_TypeDef uartStats, i2cStats;
+	FSW_CMDPOOL_Stats_TypeDef poolStats;
+	CDH_RouteStats_TypeDef routeStats;
+	FSW_LOGW_Stats_TypeDef logStats;
+	uint16_t logRate;
+	DISKCACHE_Stats_TypeDef cacheStats;
+	uint8_t tlmLen = 0;
+
+	switch( id )
+	{
+	case 0x80:
+		addToBuffer_uint32( &txBuffer[0], BSP_RTC_getTimeSec() );
+		addToBuffer_uint8 ( &txBuffer[4], ( uint8_t )FIRMWARE_MAJOR );
+		addToBuffer_uint8 ( &txBuffer[5], ( uint8_t )FIRMWARE_MINOR );
+		tlmLen = 6;
+		break;
+	case 0x81:
+		addToBuffer_uint16( &txBuffer[0], tcmdCount );
+		addToBuffer_uint16( &txBuffer[2], tlmCount );
+		addToBuffer_uint16( &txBuffer[4], commsError );
+		tlmLen = 6;
+		commsError = 0;
+		break;
+	case 0x82:
+		addToBuffer_uint8( &txBuffer[0], lastTcmdId );
+		addToBuffer_uint8( &txBuffer[1], 1 );
+		addToBuffer_uint8( &txBuffer[2], lastTcmdError );
+		lastTcmdError = 0;
+		tlmLen = 3;
+		break;
+	case 0x83:
+		addToBuffer_uint32( &txBuffer[0], BSP_RTC_getTimeSec() );
+		addToBuffer_uint16( &txBuffer[4], BSP_RTC_getTimeMSec() );
+		tlmLen = 6;
+		break;
+	case 0x84:
+		FSW_CMDPOOL_getStats( &poolStats );
+		addToBuffer_uint8 ( &txBuffer[0], poolStats.inUse );
+		addToBuffer_uint8 ( &txBuffer[1], poolStats.hwm );
+		addToBuffer_uint16( &txBuffer[2], poolStats.exhausted );
+		addToBuffer_uint32( &txBuffer[4], poolStats.allocs );
+		tlmLen = 8;
+		break;
+	case 0x85:
+		FSW_CDH_getRouteStats( &routeStats );
+		addToBuffer_uint16( &txBuffer[0], routeStats.rejected );
+		addToBuffer_uint8 ( &txBuffer[2], routeStats.lastError );
+		addToBuffer_uint8 ( &txBuffer[3], routeStats.lastDest );
+		addToBuffer_uint8 ( &txBuffer[4], routeStats.lastId );
+		tlmLen = 5;
+		break;
+	case 0x86:
+		FSW_FS_getLogStats( &logStats, &logRate );
+		addToBuffer_uint32( &txBuffer[0], logStats.entries );
+		addToBuffer_uint16( &txBuffer[4], logRate );
+		addToBuffer_uint32( &txBuffer[6], logStats.entryBytes );
+		addToBuffer_uint32( &txBuffer[10], logStats.sectorWrites );
+		addToBuffer_uint16( &txBuffer[14], logStats.syncs );
+		addToBuffer_uint16( &txBuffer[16], logStats.errors );
+		tlmLen = 18;
+		break;
+	case 0x87:
+		FSW_FS_getCacheStats( &cacheStats );
+		addToBuffer_uint32( &txBuffer[0], cacheStats.reads );
+		addToBuffer_uint32( &txBuffer[4], cacheStats.readHits );
+		addToBuffer_uint32( &txBuffer[8], cacheStats.writes );
+		addToBuffer_uint32( &txBuffer[12], cacheStats.writeHits );
+		addToBuffer_uint32( &txBuffer[16], cacheStats.diskWrites );
+		addToBuffer_uint32( &txBuffer[20], cacheStats.diskWriteCmds );
+		addToBuffer_uint16( &txBuffer[24], cacheStats.pinned );
+		addToBuffer_uint16( &txBuffer[26], cacheStats.dirty );
+		tlmLen = 28;
+		break;
+	case 0x88:
+		addToBuffer_uint32( &txBuffer[0], uartStats.frames );
+		addToBuffer_uint16( &txBuffer[4], uartStats.crcErrors );
+		addToBuffer_uint16( &txBuffer[6], uartStats.formatErrors );
+		addToBuffer_uint32( &txBuffer[8], i2cStats.frames );
+		addToBuffer_uint16( &txBuffer[12], i2cStats.crcErrors );
+		addToBuffer_uint16( &txBuffer[14], i2cStats.formatErrors );
+		addToBuffer_uint16( &txBuffer[16], 0 );
+		tlmLen = 18;
+		break;
+	case 0x92:
+		addToBuffer_uint32( txBuffer, ( uint32_t )getOBC_time() );
+		tlmLen = 4;
+		break;
+	default:
+		break;
+	}
+
+	return tlmLen;
+}
+
+/*
+ * Reply as encodeTLM builds it from the telemetry store.
+ */
+static uint8_t BENCH_storeTLM( uint8_t id, uint8_t *tlm )
+{
+	uint64_t now;
+
+	if( id == FSW_TLM_TIME )
+	{
+		now = BSP_RTC_getTimeUs();
+		addToBuffer_uint32( &tlm[0], ( uint32_t )( now / 1000000 ) );
+		addToBuffer_uint16( &tlm[4], ( uint16_t )( ( now / 1000 ) % 1000 ) );
+		return 6;
+	}
+
+	return FSW_TLM_read( id, tlm );
+}
+
+/*
+ * Publishes the store's torn read test entry as fast as it can: every byte of
+ * update n is n, and it is ( n % FSW_TLM_MAXLEN ) + 1 bytes long.
+ */
+static void *BENCH_tlmWriter( void *arg )
+{
+	volatile uint8_t *stop = arg;
+	uint8_t value[FSW_TLM_MAXLEN];
+	uint32_t n = 0;
+
+	while( !*stop )
+	{
+		n++;
+		memset( value, ( uint8_t )n, sizeof( value ) );
+		FSW_TLM_publish( BENCH_TLM_TORNID, value, ( n % FSW_TLM_MAXLEN ) + 1 );
+	}
+
+	return NULL;
+}
+
+static void BENCH_tlmReport( const char *name, uint32_t *ticks, uint32_t count )
+{
+	uint64_t sum = 0;
+	uint32_t i;
+
+	for( i = 0; i < count; i++ )
+	{
+		sum += ticks[i];
+	}
+	qsort( ticks, count, sizeof( uint32_t ), BENCH_compare );
+
+	printf( "%-6s %8.1f %8u %8u %8u\n", name, ( double )sum / count, ( unsigned )ticks[count / 2],
+			( unsigned )ticks[( uint32_t )( ( count - 1 ) * 0.999 )], ( unsigned )ticks[count - 1] );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Answers count telemetry requests, spread over every telemetry ID, the way
+ * the reply path did before the telemetry store and the way it does now, and
+ * reports the time per reply for each, including the frame encoding: mean,
+ * median, 99.9th percentile and worst case over all requests, the same for
+ * the values alone, and the worst case per ID. The worst cases include the
+ * host's own preemptions. Both must give the same replies. A second thread then publishes
+ * to one entry without pause while this one reads it count times, checking
+ * that every read is a complete update.
+ *
+ * On the target the old path's getters also mask interrupts, which the POSIX
+ * port does not, so its host times understate the interrupt latency it caused.
+ *
+ * @param[in] count
+ *   Number of telemetry requests.
+ * @return
+ *   0 on success, 1 if the replies differ or a read was torn.
+ ******************************************************************************/
+int BENCH_telemetry( uint32_t count )
+{
+	static const uint8_t ids[] = { 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x92 };
+	uint32_t worstSwitch[sizeof( ids )] = { 0 }, worstStore[sizeof( ids )] = { 0 };
+	uint8_t tlm[FSW_LINK_MAXPAYLOAD], frame[FSW_LINK_FRAMEMAX], expected[FSW_LINK_FRAMEMAX];
+	uint8_t *requests;
+	uint32_t *tSwitch, *tStore, *tGather, *tRead;
+	uint32_t i, rnd = 12345, mismatched = 0, torn = 0, updates;
+	uint16_t frameLen, expectedLen;
+	uint64_t t0;
+	volatile uint8_t stop = 0;
+	pthread_t writer;
+	uint8_t len, k;
+
+	// The store holds what the old path would have replied
+	for( k = 0; k < sizeof( ids ); k++ )
+	{
+		if( ids[k] != FSW_TLM_TIME )
+		{
+			FSW_TLM_publish( ids[k], tlm, BENCH_switchTLM( ids[k], tlm ) );
+		}
+	}
+
+	requests = malloc( count );
+	tSwitch = malloc( count * sizeof( uint32_t ) );
+	tStore = malloc( count * sizeof( uint32_t ) );
+	tGather = malloc( count * sizeof( uint32_t ) );
+	tRead = malloc( count * sizeof( uint32_t ) );
+	for( i = 0; i < count; i++ )
+	{
+		rnd = rnd * 1103515245 + 12345;
+		requests[i] = ( rnd >> 8 ) % sizeof( ids );
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		k = requests[i];
+
+		t0 = BENCH_TLMTICKS();
+		expectedLen = FSW_LINK_encode( expected, ids[k], ( uint8_t )i, tlm, BENCH_switchTLM( ids[k], tlm ) );
+		tSwitch[i] = BENCH_TLMTICKS() - t0;
+
+		t0 = BENCH_TLMTICKS();
+		frameLen = FSW_LINK_encode( frame, ids[k], ( uint8_t )i, tlm, BENCH_storeTLM( ids[k], tlm ) );
+		tStore[i] = BENCH_TLMTICKS() - t0;
+
+		// The values alone, without the encoding both paths share
+		t0 = BENCH_TLMTICKS();
+		BENCH_sink += BENCH_switchTLM( ids[k], tlm );
+		tGather[i] = BENCH_TLMTICKS() - t0;
+
+		t0 = BENCH_TLMTICKS();
+		BENCH_sink += BENCH_storeTLM( ids[k], tlm );
+		tRead[i] = BENCH_TLMTICKS() - t0;
+
+		if( frameLen != expectedLen || memcmp( frame, expected, frameLen ) != 0 )
+		{
+			mismatched++;
+		}
+		if( tSwitch[i] > worstSwitch[k] )
+		{
+			worstSwitch[k] = tSwitch[i];
+		}
+		if( tStore[i] > worstStore[k] )
+		{
+			worstStore[k] = tStore[i];
+		}
+	}
+
+	printf( "\nFSW telemetry reply benchmark: %u requests over %u IDs, %s per reply\n",
+			( unsigned )count, ( unsigned )sizeof( ids ), BENCH_TLMUNIT );
+	printf( "path       mean   median    p99.9    worst\n" );
+	BENCH_tlmReport( "switch", tSwitch, count );
+	BENCH_tlmReport( "store", tStore, count );
+	printf( "values only\n" );
+	BENCH_tlmReport( "switch", tGather, count );
+	BENCH_tlmReport( "store", tRead, count );
+	printf( "worst per ID  switch    store\n" );
+	for( k = 0; k < sizeof( ids ); k++ )
+	{
+		printf( "  0x%02X     %8u %8u\n", ids[k], ( unsigned )worstSwitch[k], ( unsigned )worstStore[k] );
+	}
+	printf( "replies: %u differ\n", ( unsigned )mismatched );
+
+	// Torn reads
+	updates = FSW_TLM_updates( BENCH_TLM_TORNID );
+	pthread_create( &writer, NULL, BENCH_tlmWriter, ( void * )&stop );
+	for( i = 0; i < count; i++ )
+	{
+		len = FSW_TLM_read( BENCH_TLM_TORNID, tlm );
+		if( len == 0 )
+		{
+			continue;
+		}
+		for( k = 1; k < len; k++ )
+		{
+			if( tlm[k] != tlm[0] )
+			{
+				break;
+			}
+		}
+		if( k != len || len != ( uint8_t )( tlm[0] % FSW_TLM_MAXLEN ) + 1 )
+		{
+			torn++;
+		}
+		if( ( i & 0x3F ) == 0 )
+		{
+			sched_yield();
+		}
+	}
+	stop = 1;
+	pthread_join( writer, NULL );
+	updates = FSW_TLM_updates( BENCH_TLM_TORNID ) - updates;
+
+	printf( "concurrent: %u reads during %u updates, %u torn\n", ( unsigned )count, ( unsigned )updates, ( unsigned )torn );
+
+	free( requests );
+	free( tSwitch );
+	free( tStore );
+	free( tGather );
+	free( tRead );
+
+	return ( mismatched != 0 || torn != 0 ) ? 1 : 0;
+}
+
+/*
+ * Formats a command log entry as text, the way log_CMD did before the binary
+ * records. Returns the length of the entry.
+ */
+static uint16_t BENCH_formatText( const FS_LogEntry_TypeDef *logEntry, char *write_buffer )
+{
+	static const char cmdString[] = "CMD:   ";
+	static const char module_strings[9][9] = {{"Source: "},{"ADCS    "},{"CDH     "},{"COMM    "},{"FS      "},{"HANDH   "},{"MODES   "},{"PAYLOAD "},{"POWER   "}};
+	int16_t i = 0;
+	char temp_id[13] = {0};							// Any int, the tab and the NUL
+	char buf[20];
+	struct tm ts;
+	time_t time = logEntry->exe_time;
+
+	ts = *gmtime(&time);
+	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ts);
+
+	strcpy( write_buffer, cmdString );
+	i += sizeof(cmdString);
+	strcpy( &write_buffer[i], module_strings[0] );
+	i += sizeof( module_strings[0] );
+	strcpy( &write_buffer[i], module_strings[logEntry->source] );
+	i += sizeof(module_strings[logEntry->source]);
+	sprintf(temp_id, "%d\t", (int)(logEntry->id));
+	strcpy( &write_buffer[i], temp_id );
+	i += 4;												// log_CMD's id field, from its 4 byte buffer
+	strcpy( &write_buffer[i], buf );
+	i += sizeof(buf);
+	write_buffer[i] = '\r';
+	write_buffer[i+1] = '\n';
+
+	return i+2;
+}
+
+/*
+ * Logs count entries the way log_CMD did before the log writer: open, seek,
+ * write and close for every entry.
+ */
+static int BENCH_logDirect( const char *path, const void *entry, uint16_t len, uint32_t count )
+{
+	FIL file;
+	UINT bytes;
+	DWORD index = 0;
+	uint32_t i;
+
+	for( i = 0; i < count; i++ )
+	{
+		if( f_open( &file, path, FA_WRITE ) != FR_OK && f_open( &file, path, FA_CREATE_ALWAYS | FA_WRITE ) != FR_OK )
+		{
+			return 1;
+		}
+		f_lseek( &file, index );
+		if( f_write( &file, entry, len, &bytes ) != FR_OK || bytes != len )
+		{
+			return 1;
+		}
+		index += len;
+		f_close( &file );
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Formats count command log entries as text, as log_CMD used to, and as
+ * binary records, and reports the bytes and time per entry of each.
+ *
+ * Then logs count records to the disk image, once with an open, seek, write
+ * and close per entry as the file system module used to, and once through the
+ * buffered log writer with each sync policy. Reports the entries per second,
+ * the disk sectors read and written per entry, and the write amplification
+ * (bytes written to the disk per byte logged). Each writer is then reopened
+ * from its control block, as after a reset, and must continue exactly where
+ * it stopped; the sectors read to do so are reported.
+ *
+ * @param[in] count
+ *   Number of entries to log per run.
+ * @return
+ *   0 on success, 1 if a run failed, a log file came out the wrong size or a
+ *   writer did not resume where it stopped.
+ ******************************************************************************/
+int BENCH_logger( uint32_t count )
+{
+	FSW_LOGW_TypeDef log;
+	static const char *policies[] = { "flush", "timeout", "explicit" };
+	static const char *dirs[] = { "/BENCHW0", "/BENCHW1", "/BENCHW2" };
+	static const char *rings[] = { "/BENCHW0/RING.LOG", "/BENCHW1/RING.LOG", "/BENCHW2/RING.LOG" };
+	static const char *blocks[] = { "/BENCHW0/CTRL.BLK", "/BENCHW1/CTRL.BLK", "/BENCHW2/CTRL.BLK" };
+	FS_LogRingState_TypeDef state;
+	FS_LogEntry_TypeDef logEntry = { 1792152000, LOG_CMD, FSW_ADCS, 0 };
+	FS_LogRecord_TypeDef record;
+	char text[64];
+	uint16_t len, textLen = 0;
+	uint32_t i, reads, writes, policy, fill;
+	uint64_t t0, t, tText, tBinary;
+#ifdef BENCH_CYCLES
+	uint64_t c0, cText, cBinary;
+#endif
+	FILINFO info;
+	uintptr_t sum = 0;
+	int result = 0;
+
+	// Formatting, with the id and time changing as in a real log. Ids stay below
+	// 100, as the text format overflows its id field for longer ones.
+	t0 = BENCH_now();
+#ifdef BENCH_CYCLES
+	c0 = BENCH_CYCLES();
+#endif
+	for( i = 0; i < count; i++ )
+	{
+		logEntry.exe_time++;
+		logEntry.id = ( uint8_t )( i % 100 );
+		textLen = BENCH_formatText( &logEntry, text );
+		sum += text[textLen - 3];
+	}
+#ifdef BENCH_CYCLES
+	cText = BENCH_CYCLES() - c0;
+#endif
+	tText = BENCH_now() - t0;
+
+	t0 = BENCH_now();
+#ifdef BENCH_CYCLES
+	c0 = BENCH_CYCLES();
+#endif
+	for( i = 0; i < count; i++ )
+	{
+		logEntry.exe_time++;
+		logEntry.id = ( uint8_t )( i % 100 );
+		FSW_LOGFMT_record( &record, logEntry.exe_time, logEntry.source, logEntry.id );
+		sum += record.crc;
+	}
+#ifdef BENCH_CYCLES
+	cBinary = BENCH_CYCLES() - c0;
+#endif
+	tBinary = BENCH_now() - t0;
+	BENCH_sink = sum;
+
+	if( !FSW_LOGFMT_checkRecord( &record ) )
+	{
+		result = 1;
+	}
+
+	printf( "\nFSW log format benchmark: %u entries\n", ( unsigned )count );
+#ifdef BENCH_CYCLES
+	printf( "text   %3u bytes/entry %7.1f ns/entry %7.1f cycles/entry\n", ( unsigned )textLen,
+			( double )tText / count, ( double )cText / count );
+	printf( "binary %3u bytes/entry %7.1f ns/entry %7.1f cycles/entry (with CRC)\n", ( unsigned )sizeof( record ),
+			( double )tBinary / count, ( double )cBinary / count );
+#else
+	printf( "text   %3u bytes/entry %7.1f ns/entry\n", ( unsigned )textLen, ( double )tText / count );
+	printf( "binary %3u bytes/entry %7.1f ns/entry (with CRC)\n", ( unsigned )sizeof( record ), ( double )tBinary / count );
+#endif
+
+	len = sizeof( record );
+
+	printf( "\nFSW log writer benchmark: %u records of %u bytes, %u sector rings\n", ( unsigned )count, ( unsigned )len,
+			BENCH_RING_SECTORS );
+	printf( "%-18s %10s %12s %12s %10s %12s\n", "writer", "entries/s", "reads/entry", "writes/entry", "write amp", "resume reads" );
+
+	f_mkdir( "/BENCHOLD" );
+	f_unlink( "/BENCHOLD/LOG.txt" );
+	reads = HOST_diskReads;
+	writes = HOST_diskWrites;
+	t0 = BENCH_now();
+	result |= BENCH_logDirect( "/BENCHOLD/LOG.txt", &record, len, count );
+	t = BENCH_now() - t0;
+	reads = HOST_diskReads - reads;
+	writes = HOST_diskWrites - writes;
+	if( f_stat( "/BENCHOLD/LOG.txt", &info ) != FR_OK || info.fsize != count * len )
+	{
+		result = 1;
+	}
+	printf( "%-18s %10.0f %12.2f %12.2f %10.1f %12s\n", "open/write/close", count / ( t / 1e9 ),
+			( double )reads / count, ( double )writes / count, ( double )writes * 512 / ( ( double )count * len ), "-" );
+
+	for( policy = FSW_LOGW_SYNC_FLUSH; policy <= FSW_LOGW_SYNC_EXPLICIT; policy++ )
+	{
+		// A ring left by an earlier run on a disk image file is continued, so the erase stays out of the timing
+		f_mkdir( dirs[policy] );
+		FSW_LOGW_loadControlBlock( blocks[policy] );
+		if( FSW_LOGW_Init( &log, rings[policy], LOG_CMD, BENCH_RING_SECTORS, policy ) != FR_OK )
+		{
+			result = 1;
+		}
+
+		reads = HOST_diskReads;
+		writes = HOST_diskWrites;
+		t0 = BENCH_now();
+		for( i = 0; i < count; i++ )
+		{
+			if( FSW_LOGW_append( &log, &record, len ) != FR_OK )
+			{
+				result = 1;
+			}
+		}
+		FSW_LOGW_close( &log );
+		t = BENCH_now() - t0;
+		reads = HOST_diskReads - reads;
+		writes = HOST_diskWrites - writes;
+
+		if( f_stat( log.path, &info ) != FR_OK || info.fsize != BENCH_RING_SECTORS * FSW_LOGW_SECTOR
+				|| log.stats.entries != count || log.stats.errors != 0
+				|| ( count >= BENCH_RING_SECTORS * ( FSW_LOGW_SECTOR / len ) && log.stats.overwrites == 0 ) )
+		{
+			result = 1;
+		}
+		printf( "buffered, %-8s %10.0f %12.2f %12.2f %10.1f", policies[policy], count / ( t / 1e9 ),
+				( double )reads / count, ( double )writes / count, ( double )writes * 512 / ( ( double )count * len ) );
+
+		// Reopen as after a reset
+		state = *log.state;
+		fill = log.fill;
+		reads = HOST_diskReads;
+		if( FSW_LOGW_loadControlBlock( blocks[policy] ) != FR_OK
+				|| FSW_LOGW_Init( &log, rings[policy], LOG_CMD, BENCH_RING_SECTORS, policy ) != FR_OK
+				|| log.state->seq != state.seq || log.state->head != state.head || log.state->tail != state.tail
+				|| log.fill != fill )
+		{
+			result = 1;
+		}
+		reads = HOST_diskReads - reads;
+		FSW_LOGW_close( &log );
+		printf( " %12u\n", ( unsigned )reads );
+	}
+
+	printf( "log writer %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Logs count records spread over an error, command and WOD log, as the file
+ * system module does, flushing every log on a timeout every
+ * BENCH_CACHE_FLUSH entries. Runs with the flush and timeout sync policies,
+ * each without and with the sector cache and its metadata pins, and reports
+ * the disk sectors read and written per entry, the disk write commands per
+ * entry and the cache hit rate. After each run the cache is written back and
+ * the logs are reopened from the control block, and must continue where they
+ * stopped.
+ *
+ * @param[in] count
+ *   Number of entries to log per run.
+ * @return
+ *   0 on success, 1 if a run failed or a log did not resume where it stopped.
+ ******************************************************************************/
+int BENCH_cache( uint32_t count )
+{
+	static FSW_LOGW_TypeDef logs[3];
+	static const char *dirs[] = { "/BENCHCE", "/BENCHCC", "/BENCHCW" };
+	static const char *rings[] = { "/BENCHCE/RING.LOG", "/BENCHCC/RING.LOG", "/BENCHCW/RING.LOG" };
+	static const uint8_t types[] = { LOG_ERROR, LOG_CMD, LOG_WOD };
+	static const char *policies[] = { "flush", "timeout", "explicit" };
+	FS_LogRingState_TypeDef state[3];
+	FS_LogRecord_TypeDef record;
+	DISKCACHE_Stats_TypeDef stats;
+	uint16_t fill[3];
+	uint32_t i, n, reads, writes, cmds, policy, pass, lines;
+	uint64_t t0, t;
+	int result = 0;
+
+	printf( "\nFSW sector cache benchmark: %u records over 3 logs, flushed every %u entries\n", ( unsigned )count,
+			BENCH_CACHE_FLUSH );
+	printf( "%-8s %6s %10s %12s %12s %12s %8s\n", "policy", "lines", "entries/s", "reads/entry", "writes/entry",
+			"cmds/entry", "hits" );
+
+	for( n = 0; n < 3; n++ )
+	{
+		f_mkdir( dirs[n] );
+	}
+
+	for( policy = FSW_LOGW_SYNC_FLUSH; policy <= FSW_LOGW_SYNC_EXPLICIT; policy++ )
+	{
+		for( pass = 0; pass < 2; pass++ )
+		{
+			lines = pass ? DISKCACHE_LINES : 0;
+			HOST_DISK_setCache( lines );
+
+			// Opening the logs stays out of the counts
+			FSW_LOGW_loadControlBlock( "/BENCHC.BLK" );
+			for( n = 0; n < 3; n++ )
+			{
+				if( FSW_LOGW_Init( &logs[n], rings[n], types[n], BENCH_RING_SECTORS, policy ) != FR_OK )
+				{
+					result = 1;
+				}
+				FSW_LOGW_pinMetadata( &logs[n] );
+			}
+			DISKCACHE_flush();
+
+			reads = HOST_diskReads;
+			writes = HOST_diskWrites;
+			cmds = HOST_diskWriteCmds;
+			t0 = BENCH_now();
+			for( i = 0; i < count; i++ )
+			{
+				n = i % 3;
+				FSW_LOGFMT_record( &record, 1792152000 + i, FSW_ADCS, ( uint8_t )i );
+				if( FSW_LOGW_append( &logs[n], &record, sizeof( record ) ) != FR_OK )
+				{
+					result = 1;
+				}
+				if( ( i + 1 ) % BENCH_CACHE_FLUSH == 0 )
+				{
+					for( n = 0; n < 3; n++ )
+					{
+						if( logs[n].dirty )
+						{
+							FSW_LOGW_flush( &logs[n], FSW_LOGW_FLUSH_TIMEOUT );
+						}
+					}
+				}
+			}
+			for( n = 0; n < 3; n++ )
+			{
+				state[n] = *logs[n].state;
+				fill[n] = logs[n].fill;
+				FSW_LOGW_close( &logs[n] );
+				if( logs[n].stats.errors != 0 )
+				{
+					result = 1;
+				}
+			}
+			t = BENCH_now() - t0;
+			reads = HOST_diskReads - reads;
+			writes = HOST_diskWrites - writes;
+			cmds = HOST_diskWriteCmds - cmds;
+			DISKCACHE_getStats( &stats );
+			DISKCACHE_unpinAll();
+
+			printf( "%-8s %6u %10.0f %12.3f %12.3f %12.3f", policies[policy], ( unsigned )lines, count / ( t / 1e9 ),
+					( double )reads / count, ( double )writes / count, ( double )cmds / count );
+			if( lines )
+			{
+				printf( " %7.1f%%\n", 100.0 * ( stats.readHits + stats.writeHits ) / ( stats.reads + stats.writes ) );
+			}
+			else
+			{
+				printf( " %8s\n", "-" );
+			}
+
+			// Everything must have reached the image: reopen from it without the cache
+			HOST_DISK_setCache( 0 );
+			if( FSW_LOGW_loadControlBlock( "/BENCHC.BLK" ) != FR_OK )
+			{
+				result = 1;
+			}
+			for( n = 0; n < 3; n++ )
+			{
+				if( FSW_LOGW_Init( &logs[n], rings[n], types[n], BENCH_RING_SECTORS, policy ) != FR_OK
+						|| logs[n].state->seq != state[n].seq || logs[n].state->head != state[n].head
+						|| logs[n].state->tail != state[n].tail || logs[n].fill != fill[n] )
+				{
+					result = 1;
+				}
+				FSW_LOGW_close( &logs[n] );
+			}
+		}
+	}
+
+	HOST_DISK_setCache( DISKCACHE_LINES );
+	printf( "sector cache %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+// TASKS ***********************************************************************
+
+static void BENCH_task( void *pvParameters )
+{
+	CDH_CMD_TypeDef cmd;
+	uint32_t seq, i, dispatched;
+	uint64_t start, sendEnd, deadline;
+
+	heapStart = xPortGetFreeHeapSize();
+	vTaskDelay( BENCH_SETTLE_MS / portTICK_RATE_MS );
+
+	memset( &cmd, 0, sizeof( cmd ) );
+	cmd.id = 0x01;									// Report health status
+	cmd.exe_time = 0;
+
+	start = BENCH_now();
+	for( seq = 0; seq < benchCount; seq++ )
+	{
+		BENCH_Dest_TypeDef *d = &dests[seq % BENCH_DESTCOUNT];
+
+		cmd.dest = d->dest;
+		cmd.params[0] = BENCH_MAGIC | ( seq & BENCH_SEQMASK );
+		d->sent++;
+
+		sendTime[seq] = BENCH_now();
+		while( FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &cmd, portMAX_DELAY ) != pdPASS )
+		{
+			vTaskDelay( 1 );								// Pool exhausted, wait for blocks to be released
+		}
+	}
+	sendEnd = BENCH_now();
+
+	// Let the chain drain
+	deadline = sendEnd + BENCH_DRAIN_MS * 1000000ULL;
+	do
+	{
+		vTaskDelay( 1 );
+		for( i = 0, dispatched = 0; i < BENCH_DESTCOUNT; i++ )
+		{
+			dispatched += dests[i].dispatched;
+		}
+	}
+	while( dispatched < benchCount && BENCH_now() < deadline );
+
+	BENCH_report( sendEnd - start, BENCH_now() - start );
+
+	// Dump the kernel trace of the run's end with the telecommand, to the UART capture
+	if( HOST_uartCapture != NULL )
+	{
+		cmd.dest = FSW_HANDH;
+		cmd.id = 0x06;
+		cmd.params[0] = 0;
+		cmd.len = 1;
+		FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &cmd, portMAX_DELAY );
+		vTaskDelay( BENCH_DRAIN_MS / portTICK_RATE_MS );
+	}
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Allocates the measurement buffers and creates the benchmark task.
+ *
+ * @param[in] cmdCount
+ *   Number of commands to send through the C&DH queue.
+ ******************************************************************************/
+void BENCH_Init( uint32_t cmdCount )
+{
+	uint32_t i, perDest;
+
+	benchCount = ( cmdCount > BENCH_MAXCMDS ) ? BENCH_MAXCMDS : cmdCount;
+	perDest = benchCount / BENCH_DESTCOUNT + 1;
+
+	sendTime = calloc( benchCount, sizeof( uint64_t ) );
+	for( i = 0; i < BENCH_DESTCOUNT; i++ )
+	{
+		dests[i].latency = calloc( perDest, sizeof( uint32_t ) );
+	}
+
+	xTaskCreate( BENCH_task, ( const signed char * )"BENCH", 240, NULL, 1, NULL );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @return
+ *   0 if every command was either dispatched or accounted for as dropped.
+ ******************************************************************************/
+int BENCH_result( void )
+{
+	return benchResult;
+}
+
+// TRACE HOOKS *****************************************************************
+// Called by queue.c from inside its critical sections (see FreeRTOSConfig.h).
+
+void vHostTraceQueueSend( void *pxQueue )
+{
+	BENCH_Queue_TypeDef *q = BENCH_findQueue( pxQueue );
+	uint32_t depth;
+
+	if( q != NULL )
+	{
+		// The item has not been copied in yet
+		depth = uxQueueMessagesWaiting( pxQueue ) + 1;
+		if( depth > q->hwm )
+		{
+			q->hwm = depth;
+		}
+	}
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+	BENCH_Queue_TypeDef *q = BENCH_findQueue( pxQueue );
+
+	if( q != NULL )
+	{
+		q->dropped++;
+	}
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+	const CDH_CMD_TypeDef *cmd;
+	BENCH_Dest_TypeDef *d;
+	uint32_t i, seq;
+
+	for( i = 0; i < BENCH_DESTCOUNT; i++ )
+	{
+		d = &dests[i];
+		if( *d->queue != pxQueue )
+		{
+			continue;
+		}
+
+		// The command queues carry pool handles
+		cmd = FSW_CMDPOOL_get( *( const CDH_CMDhandle_TypeDef* )pvBuffer );
+
+		// Only count the hop into the destination's own queue
+		if( cmd->dest == d->dest && ( cmd->params[0] & ~BENCH_SEQMASK ) == BENCH_MAGIC )
+		{
+			seq = cmd->params[0] & BENCH_SEQMASK;
+			if( seq < benchCount && d->dispatched < benchCount / BENCH_DESTCOUNT + 1 )
+			{
+				d->latency[d->dispatched++] = ( uint32_t )( BENCH_now() - sendTime[seq] );
+			}
+		}
+		return;
+	}
+}
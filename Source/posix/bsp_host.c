@@ -0,0 +1,444 @@
+/***************************************************************************//**
+ * @file	bsp_host.c
+ * @brief	Host stand-ins for the CubeComputer BSP drivers.
+ *
+ * Implements the subset of the bspLib, microSD and hardware test API that the
+ * flight software links against, without touching any EFM32 peripherals. The
+ * debug UART is counted (and optionally echoed to stdout or written to a
+ * file), I2C transfers complete immediately and the ADC returns fixed nominal
+ * readings. The external memory banks are plain memory mapped below 4 GiB,
+ * where the 32 bit bank addresses can reach them.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <sys/mman.h>
+
+#include "includes.h"
+#include "host.h"
+
+bool     HOST_uartEcho = false;		///< Echo debug UART output to stdout.
+FILE    *HOST_uartCapture = NULL;	///< File debug UART output is also written to.
+uint32_t HOST_uartTxBytes = 0;		///< Bytes written to the debug UART.
+uint32_t HOST_uartTxCalls = 0;		///< Number of debug UART transmissions.
+uint32_t HOST_i2cTransfers = 0;		///< Number of I2C master transfers.
+
+/// Nominal ADC readings: two supply rails, two spare channels and 25 degC (8.8 fixed point).
+static uint16_t adcData[CHANNELCOUNT] = { 2048, 2048, 0, 0, 25 << 8 };
+
+#define HOST_EBI_BANKSIZE	( 1024 * 1024 )		///< Bytes of each emulated EBI bank.
+
+static uint8_t *ebiBank[4];						///< EEPROM, flash, SRAM1 and SRAM2.
+
+// UART ************************************************************************
+
+void BSP_UART_Init( USART_TypeDef *usart )
+{
+}
+
+void BSP_UART_txByte( USART_TypeDef *usart, uint8_t data )
+{
+	BSP_UART_txBuffer( usart, &data, 1, true );
+}
+
+/*
+ * Transmissions complete synchronously, so callers never see a transfer in
+ * progress.
+ */
+void BSP_UART_txBuffer( USART_TypeDef *usart, uint8_t *buff, uint16_t len, bool wait )
+{
+	BSP_UART_txQueue( usart, buff, len, portMAX_DELAY );
+}
+
+uint16_t BSP_UART_txQueue( USART_TypeDef *usart, const uint8_t *buff, uint16_t len, portTickType timeout )
+{
+	HOST_uartTxCalls++;
+	HOST_uartTxBytes += len;
+
+	if( HOST_uartEcho )
+	{
+		fwrite( buff, 1, len, stdout );
+		fflush( stdout );
+	}
+	if( HOST_uartCapture != NULL )
+	{
+		fwrite( buff, 1, len, HOST_uartCapture );
+	}
+
+	return len;
+}
+
+bool BSP_UART_txFlush( USART_TypeDef *usart, portTickType timeout )
+{
+	return true;
+}
+
+bool BSP_UART_txInProgress( void )
+{
+	return false;
+}
+
+void BSP_UART_getTxStats( USART_TypeDef *usart, BSP_UART_TxStats_TypeDef *stats )
+{
+	memset( stats, 0, sizeof( *stats ) );
+	stats->bytes = HOST_uartTxBytes;
+	stats->messages = HOST_uartTxCalls;
+}
+
+/*
+ * Nothing is ever received; waits time out so the reading task keeps its pace.
+ */
+bool BSP_UART_rxWait( portTickType timeout )
+{
+	vTaskDelay( timeout );
+	return false;
+}
+
+bool BSP_UART_rxWaitQuiet( portTickType timeout )
+{
+	vTaskDelay( timeout );
+	return false;
+}
+
+void BSP_UART_rxWakeFromISR( portBASE_TYPE *woken )
+{
+}
+
+void BSP_UART_rxPinIRQ( void )
+{
+}
+
+uint16_t BSP_UART_rxRead( uint8_t *buff, uint16_t len )
+{
+	return 0;
+}
+
+void BSP_UART_getRxStats( BSP_UART_RxStats_TypeDef *stats )
+{
+	memset( stats, 0, sizeof( *stats ) );
+}
+
+// I2C *************************************************************************
+
+void BSP_I2C_Init( I2C_TypeDef *i2c, bool master )
+{
+}
+
+void BSP_I2C_setSlaveMode( I2C_TypeDef *i2c, bool enable )
+{
+}
+
+/*
+ * No slaves are attached; reads return zeros and every transfer completes.
+ */
+BSP_I2C_Status_TypeDef BSP_I2C_masterTX( I2C_TypeDef *i2c, uint16_t address, BSP_I2C_ModeSelect_TydeDef flag,
+										 uint8_t *txBuffer, uint16_t txBufferSize,
+										 uint8_t *rxBuffer, uint16_t rxBufferSize )
+{
+	HOST_i2cTransfers++;
+
+	if( ( flag == bspI2cRead || flag == bspI2cWriteRead ) && rxBuffer != NULL )
+	{
+		memset( rxBuffer, 0, rxBufferSize );
+	}
+
+	return bspI2cOk;
+}
+
+/*
+ * Sessions complete as they start, counted like BSP_I2C_masterTX transfers.
+ */
+static uint8_t hostI2cCompleted = 0;
+
+BSP_I2C_Status_TypeDef BSP_I2C_masterStart( I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq, uint8_t count,
+											xSemaphoreHandle done )
+{
+	uint8_t i;
+
+	if( count == 0 )
+	{
+		return bspI2cUsageFault;
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		HOST_i2cTransfers++;
+		if( seq[i].flags & I2C_FLAG_READ )
+		{
+			memset( seq[i].buf[0].data, 0, seq[i].buf[0].len );
+		}
+		else if( seq[i].flags & I2C_FLAG_WRITE_READ )
+		{
+			memset( seq[i].buf[1].data, 0, seq[i].buf[1].len );
+		}
+	}
+	hostI2cCompleted = count;
+
+	if( done != NULL )
+	{
+		xSemaphoreGive( done );
+	}
+
+	return bspI2cInProgress;
+}
+
+BSP_I2C_Status_TypeDef BSP_I2C_masterStatus( I2C_TypeDef *i2c )
+{
+	return bspI2cOk;
+}
+
+uint8_t BSP_I2C_masterCompleted( I2C_TypeDef *i2c )
+{
+	return hostI2cCompleted;
+}
+
+BSP_I2C_Status_TypeDef BSP_I2C_masterAbort( I2C_TypeDef *i2c )
+{
+	return bspI2cOk;
+}
+
+bool BSP_I2C_masterIRQHandler( I2C_TypeDef *i2c )
+{
+	return false;
+}
+
+// ADC *************************************************************************
+
+void BSP_ADC_Init( void )
+{
+}
+
+void BSP_ADC_burst( void )
+{
+}
+
+void BSP_ADC_stop( void )
+{
+}
+
+void BSP_ADC_start( void )
+{
+}
+
+void BSP_ADC_setRate( uint16_t rateHz )
+{
+}
+
+void BSP_ADC_configChannel( ADC_Channel_TypeDef channel, uint16_t decimation, uint16_t window )
+{
+}
+
+uint16_t BSP_ADC_getData( ADC_Channel_TypeDef channel )
+{
+	return ( channel < CHANNELCOUNT ) ? adcData[channel] : 0;
+}
+
+int16_t BSP_ADC_getMean( ADC_Channel_TypeDef channel )
+{
+	return ( int16_t )BSP_ADC_getData( channel );
+}
+
+void BSP_ADC_getStats( ADC_Channel_TypeDef channel, BSP_ADC_Stats_TypeDef *stats )
+{
+	memset( stats, 0, sizeof( *stats ) );
+	stats->min = stats->max = stats->mean = ( int16_t )BSP_ADC_getData( channel );
+	stats->window = 1;
+}
+
+uint16_t* BSP_ADC_getDataBuff( void )
+{
+	return adcData;
+}
+
+// MISC ************************************************************************
+
+void BSP_DMA_Init( void )
+{
+}
+
+void BSP_WDG_Init( bool enableInt, bool enableExt )
+{
+}
+
+// RTC *************************************************************************
+
+static bool     rtcRunning;
+static uint64_t rtcStart;
+
+/*
+ * The timebase counts the host clock at the RTC's rate, from BSP_RTC_Init as
+ * the counter does; before it the time is 0.
+ */
+static uint64_t RTC_hostCounts( void )
+{
+	struct timespec now;
+
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return ( uint64_t )now.tv_sec * 32768 + ( ( uint64_t )now.tv_nsec << 15 ) / 1000000000ULL;
+}
+
+void BSP_RTC_Init( void )
+{
+	rtcStart = RTC_hostCounts();
+	rtcRunning = true;
+}
+
+bool BSP_RTC_compareArm( unsigned int comp, uint32_t count )
+{
+	return false;
+}
+
+void BSP_RTC_overflowIRQ( void )
+{
+}
+
+uint64_t BSP_RTC_getCounts( void )
+{
+	return rtcRunning ? RTC_hostCounts() - rtcStart : 0;
+}
+
+uint64_t BSP_RTC_getTimeUs( void )
+{
+	uint64_t counts = BSP_RTC_getCounts();
+
+	return ( counts / 32768 ) * 1000000 + ( ( counts % 32768 ) * 15625 ) / 512;
+}
+
+uint32_t BSP_RTC_getTimeSec( void )
+{
+	return ( uint32_t )( BSP_RTC_getCounts() / 32768 );
+}
+
+uint32_t BSP_RTC_getTimeMSec( void )
+{
+	return ( uint32_t )( ( ( BSP_RTC_getCounts() % 32768 ) * 1000 ) / 32768 );
+}
+
+// SLEEP ***********************************************************************
+
+static uint32_t sleepHolds;
+
+/*
+ * The host tick is a timer signal and never stops, so the core never sleeps.
+ * Time is the host clock at the RTC's rate, as the kernel's run time stats.
+ */
+uint32_t BSP_SLEEP_getTime( void )
+{
+	return ulHostRunTimeCounter();
+}
+
+void BSP_SLEEP_holdEM1( void )
+{
+	__sync_fetch_and_add( &sleepHolds, 1 );
+}
+
+void BSP_SLEEP_releaseEM1( void )
+{
+	__sync_fetch_and_sub( &sleepHolds, 1 );
+}
+
+/*
+ * Tasks on the host time themselves to the tick.
+ */
+uint32_t BSP_SLEEP_sinceTick( void )
+{
+	return 0;
+}
+
+void BSP_SLEEP_rtcIRQ( uint32_t flags )
+{
+}
+
+void BSP_SLEEP_getStats( BSP_SLEEP_Stats_TypeDef *stats )
+{
+	memset( stats, 0, sizeof( *stats ) );
+	stats->holds = ( uint16_t )sleepHolds;
+}
+
+void BSP_EBI_Init( void )
+{
+	uint8_t b;
+
+	for( b = 0; b < 4; b++ )
+	{
+		if( ebiBank[b] == NULL )
+		{
+			ebiBank[b] = mmap( NULL, HOST_EBI_BANKSIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0 );
+			if( ebiBank[b] == MAP_FAILED )
+			{
+				perror( "EBI bank" );
+				exit( 1 );
+			}
+		}
+	}
+}
+
+uint32_t EBI_BankAddress( uint32_t bank )
+{
+	switch( bank )
+	{
+	case EBI_BANK0:	return ( uint32_t )( uintptr_t )ebiBank[0];
+	case EBI_BANK1:	return ( uint32_t )( uintptr_t )ebiBank[1];
+	case EBI_BANK2:	return ( uint32_t )( uintptr_t )ebiBank[2];
+	default:		return ( uint32_t )( uintptr_t )ebiBank[3];
+	}
+}
+
+void BSP_EBI_enableSRAM( BSP_EBI_SRAMSelect_TypeDef module )
+{
+}
+
+void BSP_EBI_disableSRAM( BSP_EBI_SRAMSelect_TypeDef module )
+{
+}
+
+void MICROSD_Init( void )
+{
+}
+
+// Hardware tests are not available on the host ********************************
+
+void TEST_RTC( void )
+{
+	printString( "TEST_RTC: not available on host\n" );
+}
+
+void TEST_EBI( void )
+{
+	printString( "TEST_EBI: not available on host\n" );
+}
+
+void TEST_I2C( void )
+{
+	printString( "TEST_I2C: not available on host\n" );
+}
+
+void TEST_ADC( void )
+{
+	printString( "TEST_ADC: not available on host\n" );
+}
+
+void TEST_microSD( void )
+{
+	printString( "TEST_microSD: not available on host\n" );
+}
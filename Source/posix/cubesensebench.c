@@ -0,0 +1,546 @@
+/***************************************************************************//**
+ * @file	cubesensebench.c
+ * @brief	CubeSense telemetry codec benchmark and round-trip test for the host build.
+ *
+ * CSBENCH_decode() times the telemetry the ADCS module reads every control
+ * period through the generated decoders, the in-place accessors of the wire
+ * structures and CUBESENSE_decodeAll() over one burst, against a copy of the
+ * decoders they replaced, which cast the receive buffer to wider types.
+ *
+ * CSBENCH_fuzz() checks every CUBESENSE_TelemetryID_TypeDef: random frames at
+ * every buffer alignment must decode and encode back to the same bytes, known
+ * frames must decode to known values, and CUBESENSE_decodeAll() over random
+ * bursts must agree with the decoders frame by frame and reject truncated
+ * bursts and unknown IDs.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "CubeSense.1.h"
+
+#define CSBENCH_BURSTS		200000		///< Default control periods timed.
+#define CSBENCH_ITERATIONS	20000		///< Default random frames per telemetry ID.
+#define CSBENCH_IMAGEITER	4			///< Random frames per full image ID, which are 300 KiB each.
+#define CSBENCH_MAXFRAMES	16			///< Frames in a random burst.
+#define CSBENCH_MAXLEN		307200		///< Longest telemetry frame.
+
+/// A telemetry frame of the round-trip test.
+typedef struct
+{
+	CUBESENSE_TelemetryID_TypeDef	id;
+	const char						*name;
+	uint32_t						flag;			///< CUBESENSE_TelemetryFlag_TypeDef of the frame.
+	uint8_t							flagBytes[4];	///< Offsets of the bytes holding a flag in bit 0, 0xFF when unused.
+} CSBENCH_Tlm_TypeDef;
+
+static const CSBENCH_Tlm_TypeDef csbenchTlm[] =
+{
+	{ CubeSenseTlmIdIdentification,	"Identification",	CubeSenseTlmFlagIdentification,	{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdCommsStatus,	"CommsStatus",		CubeSenseTlmFlagCommsStatus,	{ 4, 5, 6, 7 } },
+	{ CubeSenseTlmIdTcAck,			"TcAck",			CubeSenseTlmFlagTcAck,			{ 1, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdNadirSensor,	"NadirSensor",		CubeSenseTlmFlagNadirSensor,	{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdSunSensor,		"SunSensor",		CubeSenseTlmFlagSunSensor,		{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdPower,			"Power",			CubeSenseTlmFlagPower,			{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdConfig,			"Config",			CubeSenseTlmFlagConfig,			{ 2, 7, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdImageFrame,		"ImageFrame",		CubeSenseTlmFlagImageFrame,		{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdImageFrameData,	"ImageFrameData",	CubeSenseTlmFlagImageFrameData,	{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdNadirImage,		"NadirImage",		CubeSenseTlmFlagNadirImage,		{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdSunImage,		"SunImage",			CubeSenseTlmFlagSunImage,		{ 0xFF, 0xFF, 0xFF, 0xFF } },
+	{ CubeSenseTlmIdNadirMask,		"NadirMask",		CubeSenseTlmFlagNadirMask,		{ 0xFF, 0xFF, 0xFF, 0xFF } },
+};
+
+#define CSBENCH_TLMCOUNT	( sizeof( csbenchTlm ) / sizeof( csbenchTlm[0] ) )
+
+static uint32_t csbenchBursts = CSBENCH_BURSTS;
+static uint32_t csbenchIterations = CSBENCH_ITERATIONS;
+static uint32_t csbenchSeed = 12345;
+
+static uint8_t csbenchImage[CSBENCH_MAXLEN];		///< Image buffer of the decoded image structures.
+
+static uint64_t CSBENCH_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t CSBENCH_random( void )
+{
+	csbenchSeed = csbenchSeed * 1103515245 + 12345;
+	return csbenchSeed >> 8;
+}
+
+/*
+ * The decoders as generated before the wire structures, for the baseline. They
+ * load 16 and 32-bit values through casts of the receive buffer, which the
+ * Cortex-M3 only tolerates at aligned offsets, and scaled the sensor and power
+ * values the wrong way round.
+ */
+static int8_t CSBENCH_legacyIdentification( CUBESENSE_TlmIdentification_TypeDef* identification, uint8_t* tlmBuffer )
+{
+	if( tlmBuffer == 0 )
+		return 0;
+
+	identification->runtimeSeconds = *( ( uint16_t* ) ( tlmBuffer + 0 ) );
+	identification->runtimeMilliseconds = *( ( uint16_t* ) ( tlmBuffer + 2 ) );
+	identification->firmwareMajorVersion = *( ( uint8_t* ) ( tlmBuffer + 4 ) );
+	identification->firmwareMinorVersion = *( ( uint8_t* ) ( tlmBuffer + 5 ) );
+
+	return 1;
+}
+
+static int8_t CSBENCH_legacyCommsStatus( CUBESENSE_TlmCommsStatus_TypeDef* commsStatus, uint8_t* tlmBuffer )
+{
+	if( tlmBuffer == 0 )
+		return 0;
+
+	commsStatus->tcCounter = *( ( uint16_t* ) ( tlmBuffer + 0 ) );
+	commsStatus->tlmCounter = *( ( uint16_t* ) ( tlmBuffer + 2 ) );
+	commsStatus->tcBufferOverrun = ( tlmBuffer[4] && 0x01 ) >> 0;
+	commsStatus->i2cTlmReadError = ( tlmBuffer[5] && 0x01 ) >> 0;
+	commsStatus->uartProtocolError = ( tlmBuffer[6] && 0x01 ) >> 0;
+	commsStatus->uartMsgIncomplete = ( tlmBuffer[7] && 0x01 ) >> 0;
+
+	return 1;
+}
+
+static int8_t CSBENCH_legacyNadirSensor( CUBESENSE_TlmNadirSensor_TypeDef* nadirSensor, uint8_t* tlmBuffer )
+{
+	int16_t rawNadirX;
+	int16_t rawNadirY;
+
+	if( tlmBuffer == 0 )
+		return 0;
+
+	rawNadirX = *( ( int16_t* ) ( tlmBuffer + 0 ) );
+	nadirSensor->nadirX = rawNadirX*100.0f;
+	rawNadirY = *( ( int16_t* ) ( tlmBuffer + 2 ) );
+	nadirSensor->nadirY = rawNadirY*100.0f;
+	nadirSensor->busyStatus = ( uint8_t ) tlmBuffer[4];
+	nadirSensor->result = ( uint8_t ) tlmBuffer[5];
+
+	return 1;
+}
+
+static int8_t CSBENCH_legacySunSensor( CUBESENSE_TlmSunSensor_TypeDef* sunSensor, uint8_t* tlmBuffer )
+{
+	int16_t rawSunX;
+	int32_t rawSunY;
+
+	if( tlmBuffer == 0 )
+		return 0;
+
+	rawSunX = *( ( int16_t* ) ( tlmBuffer + 0 ) );
+	sunSensor->sunX = rawSunX*100.0f;
+	rawSunY = *( ( int32_t* ) ( tlmBuffer + 2 ) );
+	sunSensor->sunY = rawSunY*100.0f;
+	sunSensor->busyStatus = ( uint8_t ) tlmBuffer[4];
+	sunSensor->result = ( uint8_t ) tlmBuffer[5];
+
+	return 1;
+}
+
+static int8_t CSBENCH_legacyPower( CUBESENSE_TlmPower_TypeDef* power, uint8_t* tlmBuffer )
+{
+	uint16_t rawCurrent3V3;
+	uint16_t rawCurrentNadirSram;
+	uint16_t rawCurrentSunSram;
+
+	if( tlmBuffer == 0 )
+		return 0;
+
+	rawCurrent3V3 = *( ( uint16_t* ) ( tlmBuffer + 0 ) );
+	power->current3V3 = rawCurrent3V3/1.29f;
+	rawCurrentNadirSram = *( ( uint16_t* ) ( tlmBuffer + 2 ) );
+	power->currentNadirSram = rawCurrentNadirSram/0.21f;
+	rawCurrentSunSram = *( ( uint16_t* ) ( tlmBuffer + 4 ) );
+	power->currentSunSram = rawCurrentSunSram/0.21f;
+	power->nadirPower = ( uint8_t ) tlmBuffer[5];
+	power->sunPower = ( uint8_t ) tlmBuffer[6];
+	power->nadirOvercurrent = ( uint8_t ) tlmBuffer[7];
+	power->sunOvercurrent = ( uint8_t ) tlmBuffer[8];
+
+	return 1;
+}
+
+// Decodes one frame into its structure in tlm, as CUBESENSE_decodeAll does
+static void CSBENCH_update( CUBESENSE_Telemetry_TypeDef *tlm, CUBESENSE_TelemetryID_TypeDef id, uint8_t *frame )
+{
+	switch( id )
+	{
+	case CubeSenseTlmIdIdentification:	CUBESENSE_updateTlmIdentification( &tlm->identification, frame );	break;
+	case CubeSenseTlmIdCommsStatus:		CUBESENSE_updateTlmCommsStatus( &tlm->commsStatus, frame );			break;
+	case CubeSenseTlmIdTcAck:			CUBESENSE_updateTlmTcAck( &tlm->tcAck, frame );						break;
+	case CubeSenseTlmIdNadirSensor:		CUBESENSE_updateTlmNadirSensor( &tlm->nadirSensor, frame );			break;
+	case CubeSenseTlmIdSunSensor:		CUBESENSE_updateTlmSunSensor( &tlm->sunSensor, frame );				break;
+	case CubeSenseTlmIdPower:			CUBESENSE_updateTlmPower( &tlm->power, frame );						break;
+	case CubeSenseTlmIdConfig:			CUBESENSE_updateTlmConfig( &tlm->config, frame );					break;
+	case CubeSenseTlmIdImageFrame:		CUBESENSE_updateTlmImageFrame( &tlm->imageFrame, frame );			break;
+	case CubeSenseTlmIdImageFrameData:	CUBESENSE_updateTlmImageFrameData( &tlm->imageFrameData, frame );	break;
+	case CubeSenseTlmIdNadirImage:		CUBESENSE_updateTlmNadirImage( &tlm->nadirImage, frame );			break;
+	case CubeSenseTlmIdSunImage:		CUBESENSE_updateTlmSunImage( &tlm->sunImage, frame );				break;
+	case CubeSenseTlmIdNadirMask:		CUBESENSE_updateTlmNadirMask( &tlm->nadirMask, frame );				break;
+	}
+}
+
+// Encodes the structure of one frame in tlm
+static int32_t CSBENCH_encode( uint8_t *frame, CUBESENSE_TelemetryID_TypeDef id, const CUBESENSE_Telemetry_TypeDef *tlm )
+{
+	switch( id )
+	{
+	case CubeSenseTlmIdIdentification:	return CUBESENSE_encodeTlmIdentification( frame, &tlm->identification );
+	case CubeSenseTlmIdCommsStatus:		return CUBESENSE_encodeTlmCommsStatus( frame, &tlm->commsStatus );
+	case CubeSenseTlmIdTcAck:			return CUBESENSE_encodeTlmTcAck( frame, &tlm->tcAck );
+	case CubeSenseTlmIdNadirSensor:		return CUBESENSE_encodeTlmNadirSensor( frame, &tlm->nadirSensor );
+	case CubeSenseTlmIdSunSensor:		return CUBESENSE_encodeTlmSunSensor( frame, &tlm->sunSensor );
+	case CubeSenseTlmIdPower:			return CUBESENSE_encodeTlmPower( frame, &tlm->power );
+	case CubeSenseTlmIdConfig:			return CUBESENSE_encodeTlmConfig( frame, &tlm->config );
+	case CubeSenseTlmIdImageFrame:		return CUBESENSE_encodeTlmImageFrame( frame, &tlm->imageFrame );
+	case CubeSenseTlmIdImageFrameData:	return CUBESENSE_encodeTlmImageFrameData( frame, &tlm->imageFrameData );
+	case CubeSenseTlmIdNadirImage:		return CUBESENSE_encodeTlmNadirImage( frame, &tlm->nadirImage );
+	case CubeSenseTlmIdSunImage:		return CUBESENSE_encodeTlmSunImage( frame, &tlm->sunImage );
+	case CubeSenseTlmIdNadirMask:		return CUBESENSE_encodeTlmNadirMask( frame, &tlm->nadirMask );
+	}
+	return -1;
+}
+
+// Clears the structures and points the image structures at their buffers
+static void CSBENCH_clear( CUBESENSE_Telemetry_TypeDef *tlm, uint8_t *imageBuffer )
+{
+	memset( tlm, 0, sizeof( *tlm ) );
+	tlm->imageFrame.imageBytes = imageBuffer;
+	tlm->nadirImage.imageBytes = imageBuffer;
+	tlm->sunImage.imageBytes = imageBuffer;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Times the five telemetry frames FSW_ADCS reads every control period.
+ ******************************************************************************/
+static int CSBENCH_decode( void )
+{
+	static const CUBESENSE_TelemetryID_TypeDef ids[] = { CubeSenseTlmIdIdentification, CubeSenseTlmIdCommsStatus,
+			CubeSenseTlmIdSunSensor, CubeSenseTlmIdNadirSensor, CubeSenseTlmIdPower };
+	static uint32_t frameBuffer[5][4];		// One aligned receive buffer per frame, as the legacy casts need
+	CUBESENSE_Telemetry_TypeDef tlm;
+	CUBESENSE_TlmIdentification_TypeDef identification;
+	CUBESENSE_TlmCommsStatus_TypeDef commsStatus;
+	CUBESENSE_TlmSunSensor_TypeDef sunSensor;
+	CUBESENSE_TlmNadirSensor_TypeDef nadirSensor;
+	CUBESENSE_TlmPower_TypeDef power;
+	uint8_t *frame[5];
+	uint8_t burst[64];
+	uint32_t i, j, burstLen = 0;
+	int32_t len;
+	volatile int32_t sink = 0;
+	float sumLegacy = 0.0f, sumUpdate = 0.0f;
+	int32_t sumAccessor = 0;
+	uint64_t t0, tLegacy, tUpdate, tAccessor, tAll;
+	int result = 0;
+
+	for( i = 0; i < 5; i++ )
+	{
+		frame[i] = ( uint8_t* )frameBuffer[i];
+		len = CUBESENSE_createTelemetryRequest( &burst[burstLen], ids[i] );
+		for( j = 0; j < ( uint32_t )len; j++ )
+		{
+			frame[i][j] = ( uint8_t )CSBENCH_random();
+		}
+		memcpy( &burst[burstLen + 1], frame[i], len );
+		burstLen += 1 + len;
+	}
+
+	t0 = CSBENCH_now();
+	for( i = 0; i < csbenchBursts; i++ )
+	{
+		frame[0][0] = ( uint8_t )i;
+		CSBENCH_legacyIdentification( &identification, frame[0] );
+		CSBENCH_legacyCommsStatus( &commsStatus, frame[1] );
+		CSBENCH_legacySunSensor( &sunSensor, frame[2] );
+		CSBENCH_legacyNadirSensor( &nadirSensor, frame[3] );
+		CSBENCH_legacyPower( &power, frame[4] );
+		sumLegacy += identification.runtimeSeconds + commsStatus.tcBufferOverrun + sunSensor.sunX + nadirSensor.nadirY + power.current3V3;
+	}
+	tLegacy = CSBENCH_now() - t0;
+
+	t0 = CSBENCH_now();
+	for( i = 0; i < csbenchBursts; i++ )
+	{
+		frame[0][0] = ( uint8_t )i;
+		CUBESENSE_updateTlmIdentification( &identification, frame[0] );
+		CUBESENSE_updateTlmCommsStatus( &commsStatus, frame[1] );
+		CUBESENSE_updateTlmSunSensor( &sunSensor, frame[2] );
+		CUBESENSE_updateTlmNadirSensor( &nadirSensor, frame[3] );
+		CUBESENSE_updateTlmPower( &power, frame[4] );
+		sumUpdate += identification.runtimeSeconds + commsStatus.tcBufferOverrun + sunSensor.sunX + nadirSensor.nadirY + power.current3V3;
+	}
+	tUpdate = CSBENCH_now() - t0;
+
+	// The fields read in place and in fixed point, from the frames as they sit in the burst
+	t0 = CSBENCH_now();
+	for( i = 0; i < csbenchBursts; i++ )
+	{
+		const CUBESENSE_WireIdentification_TypeDef *wireId = ( const CUBESENSE_WireIdentification_TypeDef* )&burst[1];
+		const CUBESENSE_WireCommsStatus_TypeDef *wireComms = ( const CUBESENSE_WireCommsStatus_TypeDef* )&burst[1 + 6 + 1];
+		const CUBESENSE_WireSunSensor_TypeDef *wireSun = ( const CUBESENSE_WireSunSensor_TypeDef* )&burst[1 + 6 + 1 + 8 + 1];
+		const CUBESENSE_WireNadirSensor_TypeDef *wireNadir = ( const CUBESENSE_WireNadirSensor_TypeDef* )&burst[1 + 6 + 1 + 8 + 1 + 6 + 1];
+		const CUBESENSE_WirePower_TypeDef *wirePower = ( const CUBESENSE_WirePower_TypeDef* )&burst[1 + 6 + 1 + 8 + 1 + 6 + 1 + 6 + 1];
+
+		burst[1] = ( uint8_t )i;
+		sumAccessor += CUBESENSE_Identification_runtimeSeconds( wireId ) + CUBESENSE_CommsStatus_tcBufferOverrun( wireComms )
+				+ CUBESENSE_SunSensor_sunX( wireSun ) + CUBESENSE_NadirSensor_nadirY( wireNadir )
+				+ CUBESENSE_Power_current3V3uA( wirePower );
+	}
+	tAccessor = CSBENCH_now() - t0;
+
+	t0 = CSBENCH_now();
+	for( i = 0; i < csbenchBursts; i++ )
+	{
+		burst[1] = ( uint8_t )i;
+		sink += CUBESENSE_decodeAll( &tlm, burst, burstLen );
+	}
+	tAll = CSBENCH_now() - t0;
+
+	if( sink != ( int32_t )( 5 * csbenchBursts ) || tlm.updated != ( CubeSenseTlmFlagIdentification | CubeSenseTlmFlagCommsStatus
+			| CubeSenseTlmFlagSunSensor | CubeSenseTlmFlagNadirSensor | CubeSenseTlmFlagPower ) )
+	{
+		printf( "decodeAll decoded %d frames, flags 0x%04X\n", ( int )sink, ( unsigned )tlm.updated );
+		result = 1;
+	}
+
+	printf( "\nCubeSense telemetry decode benchmark: %u control periods of 5 frames (%u bytes)\n",
+			( unsigned )csbenchBursts, ( unsigned )burstLen );
+	printf( "legacy casts     %7.1f ns/period\n", ( double )tLegacy / csbenchBursts );
+	printf( "update functions %7.1f ns/period\n", ( double )tUpdate / csbenchBursts );
+	printf( "wire accessors   %7.1f ns/period (fixed point, in place)\n", ( double )tAccessor / csbenchBursts );
+	printf( "decodeAll        %7.1f ns/period (one burst)\n", ( double )tAll / csbenchBursts );
+	printf( "(checksums %g %g %d)\n", ( double )sumLegacy, ( double )sumUpdate, ( int )sumAccessor );
+
+	return result;
+}
+
+// Checks the decoders against frames of known values
+static int CSBENCH_known( void )
+{
+	static const uint8_t identification[] = { 0x34, 0x12, 0xE8, 0x03, 2, 7 };
+	static const uint8_t commsStatus[] = { 0x02, 0x01, 0x04, 0x03, 0xFE, 0x01, 0x03, 0x00 };
+	static const uint8_t sunSensor[] = { 0x0A, 0x00, 0xF6, 0xFF, 1, 2 };
+	static const uint8_t power[] = { 100, 0, 0x00, 0x01, 10, 0, 1, 0, 1, 0 };
+	static const uint8_t imageFrameData[] = { 0x5F, 0x09, 0xA5 };
+	uint8_t buffer[16];
+	CUBESENSE_Telemetry_TypeDef tlm;
+	int result = 0;
+
+	CSBENCH_clear( &tlm, csbenchImage );
+
+	// At an odd address, where the legacy casts fault on the Cortex-M3
+	memcpy( buffer + 1, identification, sizeof( identification ) );
+	CUBESENSE_updateTlmIdentification( &tlm.identification, buffer + 1 );
+	result |= tlm.identification.runtimeSeconds != 0x1234 || tlm.identification.runtimeMilliseconds != 1000
+			|| tlm.identification.firmwareMajorVersion != 2 || tlm.identification.firmwareMinorVersion != 7;
+
+	memcpy( buffer + 3, commsStatus, sizeof( commsStatus ) );
+	CUBESENSE_updateTlmCommsStatus( &tlm.commsStatus, buffer + 3 );
+	result |= tlm.commsStatus.tcCounter != 0x0102 || tlm.commsStatus.tlmCounter != 0x0304 || tlm.commsStatus.tcBufferOverrun != 0
+			|| tlm.commsStatus.i2cTlmReadError != 1 || tlm.commsStatus.uartProtocolError != 1 || tlm.commsStatus.uartMsgIncomplete != 0;
+
+	memcpy( buffer + 1, sunSensor, sizeof( sunSensor ) );
+	CUBESENSE_updateTlmSunSensor( &tlm.sunSensor, buffer + 1 );
+	result |= tlm.sunSensor.sunX != 10 * 0.01f || tlm.sunSensor.sunY != -10 * 0.01f
+			|| tlm.sunSensor.busyStatus != 1 || tlm.sunSensor.result != 2;
+
+	memcpy( buffer + 1, power, sizeof( power ) );
+	CUBESENSE_updateTlmPower( &tlm.power, buffer + 1 );
+	result |= tlm.power.current3V3 != 100 * 1.29f || tlm.power.currentNadirSram != 256 * 0.21f || tlm.power.currentSunSram != 10 * 0.21f
+			|| tlm.power.nadirPower != 1 || tlm.power.sunPower != 0 || tlm.power.nadirOvercurrent != 1 || tlm.power.sunOvercurrent != 0;
+	result |= CUBESENSE_Power_current3V3uA( ( const CUBESENSE_WirePower_TypeDef* )( buffer + 1 ) ) != 129000
+			|| CUBESENSE_Power_currentNadirSramuA( ( const CUBESENSE_WirePower_TypeDef* )( buffer + 1 ) ) != 53760;
+
+	memcpy( buffer + 1, imageFrameData, sizeof( imageFrameData ) );
+	CUBESENSE_updateTlmImageFrameData( &tlm.imageFrameData, buffer + 1 );
+	result |= tlm.imageFrameData.frameNumber != 2399 || tlm.imageFrameData.checkSum != 0xA5;
+
+	printf( "known frames %s\n", result ? "FAILED" : "ok" );
+	return result;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Round trip of random frames of every telemetry ID, and of random bursts
+ *   through CUBESENSE_decodeAll.
+ ******************************************************************************/
+static int CSBENCH_fuzz( void )
+{
+	static uint8_t wire[CSBENCH_MAXLEN + 8];
+	static uint8_t encoded[CSBENCH_MAXLEN + 8];
+	static uint8_t burst[CSBENCH_MAXFRAMES * ( 128 + 1 )];
+	static CUBESENSE_Telemetry_TypeDef tlm, expected;
+	const CSBENCH_Tlm_TypeDef *t;
+	uint32_t i, j, k, n, iterations, frames, burstLen, offset, errors, totalFrames = 0;
+	int32_t len, decoded;
+	uint32_t updated;
+	uint8_t *frameAt[CSBENCH_MAXFRAMES];
+	int result = 0;
+
+	printf( "\nCubeSense telemetry round trip: %u random frames per ID, seed %u\n",
+			( unsigned )csbenchIterations, ( unsigned )csbenchSeed );
+	result |= CSBENCH_known();
+
+	for( t = csbenchTlm; t < csbenchTlm + CSBENCH_TLMCOUNT; t++ )
+	{
+		len = CUBESENSE_telemetryLength( t->id );
+		iterations = len > 128 ? CSBENCH_IMAGEITER : csbenchIterations;
+		errors = 0;
+
+		for( i = 0; i < iterations; i++ )
+		{
+			// Every alignment of the receive and transmit buffers
+			uint8_t *in = wire + ( i & 7 );
+			uint8_t *out = encoded + ( ( i >> 3 ) & 7 );
+
+			for( j = 0; j < ( uint32_t )len; j++ )
+			{
+				in[j] = ( uint8_t )CSBENCH_random();
+			}
+			CSBENCH_clear( &tlm, csbenchImage );
+			CSBENCH_update( &tlm, t->id, in );
+			if( CSBENCH_encode( out, t->id, &tlm ) != len )
+			{
+				errors++;
+				continue;
+			}
+			// Flags carry bit 0 only
+			for( k = 0; k < 4 && t->flagBytes[k] != 0xFF; k++ )
+			{
+				in[t->flagBytes[k]] &= 0x01;
+			}
+			if( memcmp( in, out, len ) != 0 )
+			{
+				errors++;
+			}
+		}
+		printf( "%-15s %6d bytes %6u frames %s\n", t->name, ( int )len, ( unsigned )iterations, errors ? "FAILED" : "ok" );
+		result |= errors != 0;
+	}
+
+	// Random bursts of the frames up to 128 bytes, each checked against the decoders
+	errors = 0;
+	for( n = 0; n < csbenchIterations; n++ )
+	{
+		frames = 1 + CSBENCH_random() % CSBENCH_MAXFRAMES;
+		burstLen = 0;
+		updated = 0;
+		CSBENCH_clear( &expected, csbenchImage );
+		for( i = 0; i < frames; i++ )
+		{
+			do
+			{
+				t = &csbenchTlm[CSBENCH_random() % CSBENCH_TLMCOUNT];
+				len = CUBESENSE_telemetryLength( t->id );
+			} while( len > 128 );
+
+			burst[burstLen] = t->id;
+			frameAt[i] = &burst[burstLen + 1];
+			for( j = 0; j < ( uint32_t )len; j++ )
+			{
+				frameAt[i][j] = ( uint8_t )CSBENCH_random();
+			}
+			CSBENCH_update( &expected, t->id, frameAt[i] );
+			if( t->id == CubeSenseTlmIdImageFrame )
+			{
+				expected.imageFrame.imageBytes = frameAt[i];
+			}
+			updated |= t->flag;
+			burstLen += 1 + len;
+		}
+		expected.updated = updated;
+
+		CSBENCH_clear( &tlm, csbenchImage );
+		decoded = CUBESENSE_decodeAll( &tlm, burst, burstLen );
+		if( decoded != ( int32_t )frames || memcmp( &tlm, &expected, sizeof( tlm ) ) != 0 )
+		{
+			errors++;
+		}
+
+		// Cut inside the last frame, or replace its ID with an unknown one
+		offset = frameAt[frames - 1] - burst - 1;
+		if( n & 1 )
+		{
+			decoded = CUBESENSE_decodeAll( &tlm, burst, offset + 1 + CSBENCH_random() % ( burstLen - offset - 1 ) );
+		}
+		else
+		{
+			burst[offset] = 0x55;
+			decoded = CUBESENSE_decodeAll( &tlm, burst, burstLen );
+		}
+		if( decoded != -1 )
+		{
+			errors++;
+		}
+		totalFrames += frames;
+	}
+	printf( "decodeAll       %6u bursts %6u frames %s\n", ( unsigned )csbenchIterations, ( unsigned )totalFrames,
+			errors ? "FAILED" : "ok" );
+	result |= errors != 0;
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int opt;
+	int result;
+
+	while( ( opt = getopt( argc, argv, "b:n:s:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'b':	csbenchBursts = strtoul( optarg, NULL, 0 );		break;
+		case 'n':	csbenchIterations = strtoul( optarg, NULL, 0 );	break;
+		case 's':	csbenchSeed = strtoul( optarg, NULL, 0 );		break;
+		default:
+			fprintf( stderr, "usage: %s [-b control periods] [-n iterations] [-s seed]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( csbenchBursts == 0 || csbenchIterations == 0 )
+	{
+		fprintf( stderr, "period or iteration count out of range\n" );
+		return 2;
+	}
+
+	result = CSBENCH_fuzz();
+	result |= CSBENCH_decode();
+	printf( "CubeSense telemetry codec %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
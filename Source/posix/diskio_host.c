@@ -0,0 +1,293 @@
+/***************************************************************************//**
+ * @file	diskio_host.c
+ * @brief	FatFs disk I/O layer for the host build.
+ *
+ * Replaces the SPI microSD driver with a sector image held in RAM, or in a
+ * host file when one is given, so the file system module runs unmodified on
+ * the host. The image is formatted on first use. Transfers pass through the
+ * same sector cache as on the target; the counters below count the image
+ * traffic behind it.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "includes.h"
+#include "diskcache.h"
+#include "host.h"
+
+#define HOST_DISK_SECTOR_SIZE	512
+
+static uint8_t *diskRam = NULL;				///< RAM image, when no image file is used.
+static FILE    *diskFile = NULL;			///< Image file, when one is used.
+static DWORD    diskSectors = 0;			///< Size of the image in sectors.
+static DSTATUS  diskStat = STA_NOINIT;
+
+uint32_t HOST_diskReads = 0;				///< Sectors read.
+uint32_t HOST_diskWrites = 0;				///< Sectors written.
+uint32_t HOST_diskSyncs = 0;				///< CTRL_SYNC requests.
+uint32_t HOST_diskWriteCmds = 0;			///< Image writes, single or multiple sector.
+
+static DRESULT HOST_DISK_read( BYTE *buff, DWORD sector, BYTE count );
+static DRESULT HOST_DISK_write( const BYTE *buff, DWORD sector, BYTE count );
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Creates the disk image and formats it if it holds no FAT volume.
+ *
+ * @param[in] path
+ *   Host file to use as the image, or NULL for a RAM image.
+ * @param[in] sizeMB
+ *   Size of a new image in MiB.
+ * @return
+ *   0 on success, -1 if the image could not be created or formatted.
+ ******************************************************************************/
+int HOST_DISK_Init( const char *path, uint32_t sizeMB )
+{
+	static FATFS fs;			// Stays registered until the FS module mounts its own
+	DIR dir;
+	long size;
+
+	if( path != NULL )
+	{
+		diskFile = fopen( path, "r+b" );
+		if( diskFile == NULL )
+		{
+			diskFile = fopen( path, "w+b" );
+		}
+		if( diskFile == NULL )
+		{
+			return -1;
+		}
+
+		fseek( diskFile, 0, SEEK_END );
+		size = ftell( diskFile );
+		if( size < HOST_DISK_SECTOR_SIZE )
+		{
+			size = ( long ) sizeMB * 1024 * 1024;
+			fseek( diskFile, size - 1, SEEK_SET );
+			fputc( 0, diskFile );
+		}
+		diskSectors = size / HOST_DISK_SECTOR_SIZE;
+	}
+	else
+	{
+		diskSectors = ( sizeMB * 1024 * 1024 ) / HOST_DISK_SECTOR_SIZE;
+		diskRam = calloc( diskSectors, HOST_DISK_SECTOR_SIZE );
+		if( diskRam == NULL )
+		{
+			return -1;
+		}
+	}
+
+	diskStat = 0;
+	HOST_DISK_setCache( DISKCACHE_LINES );
+
+	// Format the image if it does not hold a volume yet
+	f_mount( 0, &fs );
+	if( f_opendir( &dir, "/" ) == FR_NO_FILESYSTEM )
+	{
+		if( f_mkfs( 0, 0, 0 ) != FR_OK )
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Flushes and releases the disk image.
+ ******************************************************************************/
+void HOST_DISK_Close( void )
+{
+	DISKCACHE_flush();
+	if( diskFile != NULL )
+	{
+		fclose( diskFile );
+		diskFile = NULL;
+	}
+	free( diskRam );
+	diskRam = NULL;
+	diskStat = STA_NOINIT;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Writes back the sector cache and sets it up again with the given size.
+ *
+ * @param[in] lines
+ *   Number of cached sectors, at most DISKCACHE_LINES. 0 disables the cache.
+ ******************************************************************************/
+void HOST_DISK_setCache( uint16_t lines )
+{
+	if( !( diskStat & STA_NOINIT ) )
+	{
+		DISKCACHE_flush();
+	}
+	DISKCACHE_Init( NULL, lines, HOST_DISK_read, HOST_DISK_write );
+}
+
+static DRESULT HOST_DISK_read( BYTE *buff, DWORD sector, BYTE count )
+{
+	if( sector + count > diskSectors )
+	{
+		return RES_PARERR;
+	}
+
+	if( diskFile != NULL )
+	{
+		fseek( diskFile, ( long ) sector * HOST_DISK_SECTOR_SIZE, SEEK_SET );
+		if( fread( buff, HOST_DISK_SECTOR_SIZE, count, diskFile ) != count )
+		{
+			return RES_ERROR;
+		}
+	}
+	else
+	{
+		memcpy( buff, diskRam + sector * HOST_DISK_SECTOR_SIZE, count * HOST_DISK_SECTOR_SIZE );
+	}
+
+	HOST_diskReads += count;
+	return RES_OK;
+}
+
+static DRESULT HOST_DISK_write( const BYTE *buff, DWORD sector, BYTE count )
+{
+	if( sector + count > diskSectors )
+	{
+		return RES_PARERR;
+	}
+
+	if( diskFile != NULL )
+	{
+		fseek( diskFile, ( long ) sector * HOST_DISK_SECTOR_SIZE, SEEK_SET );
+		if( fwrite( buff, HOST_DISK_SECTOR_SIZE, count, diskFile ) != count )
+		{
+			return RES_ERROR;
+		}
+	}
+	else
+	{
+		memcpy( diskRam + sector * HOST_DISK_SECTOR_SIZE, buff, count * HOST_DISK_SECTOR_SIZE );
+	}
+
+	HOST_diskWrites += count;
+	HOST_diskWriteCmds++;
+	return RES_OK;
+}
+
+// FatFs disk I/O interface ****************************************************
+
+DSTATUS disk_initialize( BYTE drv )
+{
+	if( drv != 0 )
+	{
+		return STA_NOINIT;
+	}
+	return diskStat;
+}
+
+DSTATUS disk_status( BYTE drv )
+{
+	if( drv != 0 )
+	{
+		return STA_NOINIT;
+	}
+	return diskStat;
+}
+
+DRESULT disk_read( BYTE drv, BYTE *buff, DWORD sector, BYTE count )
+{
+	if( drv != 0 || count == 0 )
+	{
+		return RES_PARERR;
+	}
+	if( diskStat & STA_NOINIT )
+	{
+		return RES_NOTRDY;
+	}
+	return DISKCACHE_read( buff, sector, count );
+}
+
+DRESULT disk_write( BYTE drv, const BYTE *buff, DWORD sector, BYTE count )
+{
+	if( drv != 0 || count == 0 )
+	{
+		return RES_PARERR;
+	}
+	if( diskStat & STA_NOINIT )
+	{
+		return RES_NOTRDY;
+	}
+	return DISKCACHE_write( buff, sector, count );
+}
+
+DRESULT disk_ioctl( BYTE drv, BYTE ctrl, void *buff )
+{
+	if( drv != 0 )
+	{
+		return RES_PARERR;
+	}
+	if( diskStat & STA_NOINIT )
+	{
+		return RES_NOTRDY;
+	}
+
+	switch( ctrl )
+	{
+	case CTRL_SYNC:
+		HOST_diskSyncs++;
+		if( DISKCACHE_flush() != RES_OK )
+		{
+			return RES_ERROR;
+		}
+		if( diskFile != NULL )
+		{
+			fflush( diskFile );
+		}
+		return RES_OK;
+	case CTRL_INVALIDATE:
+		// The image stays ready, only the cached sectors go
+		DISKCACHE_flush();
+		DISKCACHE_invalidate();
+		return RES_OK;
+	case GET_SECTOR_COUNT:
+		*( DWORD* )buff = diskSectors;
+		return RES_OK;
+	case GET_SECTOR_SIZE:
+		*( WORD* )buff = HOST_DISK_SECTOR_SIZE;
+		return RES_OK;
+	case GET_BLOCK_SIZE:
+		*( DWORD* )buff = 1;
+		return RES_OK;
+	default:
+		return RES_PARERR;
+	}
+}
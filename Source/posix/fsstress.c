@@ -0,0 +1,774 @@
+/***************************************************************************//**
+ * @file	fsstress.c
+ * @brief	Host stress test of the reentrant FatFs configuration.
+ *
+ * Runs the writers that share the card in flight, each with its own FIL
+ * objects and buffers: the log writer on three rings, a housekeeping task
+ * appending samples with regular syncs, and payload tasks storing images.
+ * The same work is run once from a single task, as when every write was
+ * funnelled through the logger, and once from concurrent tasks. Every file
+ * is read back and checked, the file locks are exercised, and the FAT is
+ * walked to check that no cluster is lost or shared and that the free space
+ * comes back once the files are deleted.
+ *
+ * Usage: fsw_fsstress [-w tasks] [-m KiB]
+ *   -w  payload tasks (default 2, at most 8)
+ *   -m  data written per run in KiB (default 1024)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "ff.h"
+#include "diskio.h"
+#include "fsw_logwriter.h"
+#include "fsw_logformat.h"
+#include "host.h"
+
+#define STRESS_DISK_MB		64				///< RAM image size.
+#define STRESS_MAXPAYLOAD	8				///< Most payload tasks.
+#define STRESS_IMAGE		( 32 * 1024 )	///< Bytes per payload image.
+#define STRESS_CHUNK		4096			///< Largest payload write.
+#define STRESS_HK_SAMPLE	64				///< Bytes per housekeeping sample.
+#define STRESS_HK_SYNC		16				///< Housekeeping samples between syncs.
+#define STRESS_LOG_FLUSH	48				///< Log entries between timeout flushes.
+#define STRESS_RING_SECTORS	64				///< Size of each log ring.
+#define STRESS_HK_ID		100				///< Pattern id of the housekeeping file.
+
+/// A unit of work, run either by the single task or by a task of its own.
+typedef struct
+{
+	const char	*name;
+	int			( *run )( uint32_t arg );
+	uint32_t	arg;
+} STRESS_Job_TypeDef;
+
+static int STRESS_log( uint32_t arg );
+static int STRESS_housekeeping( uint32_t arg );
+static int STRESS_payload( uint32_t arg );
+
+static STRESS_Job_TypeDef jobs[2 + STRESS_MAXPAYLOAD];
+static uint32_t jobCount;
+
+static uint32_t stressKiB = 1024;
+static uint32_t payloadTasks = 2;
+static uint32_t imagesPerTask;
+static uint32_t hkSamples;
+static uint32_t logEntries;
+
+static xSemaphoreHandle jobDone;
+static volatile int jobFailures;
+static int stressResult = 1;
+
+// Per task file objects and buffers
+static FIL     payloadFil[STRESS_MAXPAYLOAD];
+static uint8_t payloadBuff[STRESS_MAXPAYLOAD][STRESS_CHUNK];
+static FIL     hkFil;
+static uint8_t hkBuff[STRESS_HK_SAMPLE];
+static FSW_LOGW_TypeDef logs[3];
+
+static const char *rings[] = { "/STRESS/ERR.LOG", "/STRESS/CMD.LOG", "/STRESS/WOD.LOG" };
+static const uint8_t types[] = { LOG_ERROR, LOG_CMD, LOG_WOD };
+
+// FUNCTIONS *******************************************************************
+
+static uint64_t STRESS_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint8_t STRESS_pattern( uint32_t id, uint32_t offset )
+{
+	return ( uint8_t )( id * 29 + offset + ( offset >> 9 ) * 7 );
+}
+
+static int STRESS_fail( const char *what, const char *path, FRESULT res )
+{
+	printf( "%s %s failed (%d)\n", what, path, ( int )res );
+	return 1;
+}
+
+/*
+ * Reads a file back and checks its size and its pattern.
+ */
+static int STRESS_check( FIL *fil, uint8_t *buff, UINT size, uint32_t id, const char *path, DWORD length )
+{
+	FRESULT res;
+	DWORD offset;
+	UINT i, br;
+
+	res = f_open( fil, path, FA_READ );
+	if( res != FR_OK )
+	{
+		return STRESS_fail( "open", path, res );
+	}
+	if( f_size( fil ) != length )
+	{
+		printf( "%s is %lu bytes, not %lu\n", path, ( unsigned long )f_size( fil ), ( unsigned long )length );
+		f_close( fil );
+		return 1;
+	}
+
+	for( offset = 0; offset < length; offset += br )
+	{
+		res = f_read( fil, buff, size, &br );
+		if( res != FR_OK || br == 0 )
+		{
+			f_close( fil );
+			return STRESS_fail( "read", path, res );
+		}
+		for( i = 0; i < br; i++ )
+		{
+			if( buff[i] != STRESS_pattern( id, offset + i ) )
+			{
+				f_close( fil );
+				printf( "%s: bad data at offset %lu\n", path, ( unsigned long )( offset + i ) );
+				return 1;
+			}
+		}
+		taskYIELD();
+	}
+
+	return f_close( fil ) == FR_OK ? 0 : 1;
+}
+
+/*
+ * Logs records over the three rings as the logging task does, then reopens
+ * them from the control block and checks that they continue where they
+ * stopped.
+ */
+static int STRESS_log( uint32_t arg )
+{
+	FS_LogRingState_TypeDef state[3];
+	FS_LogRecord_TypeDef record;
+	uint16_t fill[3];
+	uint32_t i, n;
+	int failed = 0;
+
+	FSW_LOGW_loadControlBlock( "/STRESS/LOG.BLK" );
+	for( n = 0; n < 3; n++ )
+	{
+		if( FSW_LOGW_Init( &logs[n], rings[n], types[n], STRESS_RING_SECTORS, FSW_LOGW_SYNC_TIMEOUT ) != FR_OK )
+		{
+			failed |= STRESS_fail( "open", rings[n], FR_OK );
+		}
+	}
+
+	for( i = 0; i < arg; i++ )
+	{
+		FSW_LOGFMT_record( &record, 1792152000 + i, 1, ( uint8_t )i );
+		FSW_LOGW_append( &logs[i % 3], &record, sizeof( record ) );
+		if( ( i + 1 ) % STRESS_LOG_FLUSH == 0 )
+		{
+			for( n = 0; n < 3; n++ )
+			{
+				if( logs[n].dirty )
+				{
+					FSW_LOGW_flush( &logs[n], FSW_LOGW_FLUSH_TIMEOUT );
+				}
+			}
+			taskYIELD();
+		}
+	}
+
+	for( n = 0; n < 3; n++ )
+	{
+		state[n] = *logs[n].state;
+		fill[n] = logs[n].fill;
+		FSW_LOGW_close( &logs[n] );
+		if( logs[n].stats.errors != 0 )
+		{
+			printf( "%s: %u log writer errors\n", rings[n], ( unsigned )logs[n].stats.errors );
+			failed = 1;
+		}
+	}
+
+	FSW_LOGW_loadControlBlock( "/STRESS/LOG.BLK" );
+	for( n = 0; n < 3; n++ )
+	{
+		if( FSW_LOGW_Init( &logs[n], rings[n], types[n], STRESS_RING_SECTORS, FSW_LOGW_SYNC_TIMEOUT ) != FR_OK
+				|| logs[n].state->seq != state[n].seq || logs[n].state->head != state[n].head
+				|| logs[n].state->tail != state[n].tail || logs[n].fill != fill[n] )
+		{
+			printf( "%s did not resume where it stopped\n", rings[n] );
+			failed = 1;
+		}
+		FSW_LOGW_close( &logs[n] );
+	}
+	FSW_LOGW_closeControlBlock();
+
+	return failed;
+}
+
+/*
+ * Appends housekeeping samples to one file, syncing it regularly, and reads
+ * it back.
+ */
+static int STRESS_housekeeping( uint32_t arg )
+{
+	const char *path = "/STRESS/HK.BIN";
+	FRESULT res;
+	UINT bw, i;
+	uint32_t s;
+
+	res = f_open( &hkFil, path, FA_CREATE_ALWAYS | FA_WRITE );
+	if( res != FR_OK )
+	{
+		return STRESS_fail( "create", path, res );
+	}
+
+	for( s = 0; s < arg; s++ )
+	{
+		for( i = 0; i < STRESS_HK_SAMPLE; i++ )
+		{
+			hkBuff[i] = STRESS_pattern( STRESS_HK_ID, s * STRESS_HK_SAMPLE + i );
+		}
+		res = f_write( &hkFil, hkBuff, STRESS_HK_SAMPLE, &bw );
+		if( res == FR_OK && ( s + 1 ) % STRESS_HK_SYNC == 0 )
+		{
+			res = f_sync( &hkFil );
+		}
+		if( res != FR_OK || bw != STRESS_HK_SAMPLE )
+		{
+			f_close( &hkFil );
+			return STRESS_fail( "write", path, res );
+		}
+		taskYIELD();
+	}
+
+	res = f_close( &hkFil );
+	if( res != FR_OK )
+	{
+		return STRESS_fail( "close", path, res );
+	}
+
+	return STRESS_check( &hkFil, hkBuff, sizeof( hkBuff ), STRESS_HK_ID, path, arg * STRESS_HK_SAMPLE );
+}
+
+/*
+ * Stores images in writes of varying size, reading each back once it is
+ * closed.
+ */
+static int STRESS_payload( uint32_t arg )
+{
+	FIL *fil = &payloadFil[arg];
+	uint8_t *buff = payloadBuff[arg];
+	char path[32];
+	uint32_t image, id, seed = arg * 7919 + 1;
+	DWORD offset;
+	UINT len, bw, i;
+	FRESULT res;
+
+	for( image = 0; image < imagesPerTask; image++ )
+	{
+		id = arg * 1000 + image;
+		sprintf( path, "/STRESS/P%u_%u.IMG", ( unsigned )arg, ( unsigned )image );
+
+		res = f_open( fil, path, FA_CREATE_ALWAYS | FA_WRITE );
+		if( res != FR_OK )
+		{
+			return STRESS_fail( "create", path, res );
+		}
+		for( offset = 0; offset < STRESS_IMAGE; offset += len )
+		{
+			seed = seed * 1103515245 + 12345;
+			len = 1 + ( seed >> 8 ) % STRESS_CHUNK;
+			if( len > STRESS_IMAGE - offset )
+			{
+				len = STRESS_IMAGE - offset;
+			}
+			for( i = 0; i < len; i++ )
+			{
+				buff[i] = STRESS_pattern( id, offset + i );
+			}
+			res = f_write( fil, buff, len, &bw );
+			if( res != FR_OK || bw != len )
+			{
+				f_close( fil );
+				return STRESS_fail( "write", path, res );
+			}
+			taskYIELD();
+		}
+		res = f_close( fil );
+		if( res != FR_OK )
+		{
+			return STRESS_fail( "close", path, res );
+		}
+
+		if( STRESS_check( fil, buff, STRESS_CHUNK, id, path, STRESS_IMAGE ) != 0 )
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * A file open for writing must be refused to every other open and to
+ * f_unlink until it is closed.
+ */
+static int STRESS_locks( void )
+{
+	const char *path = "/STRESS/LOCK.BIN";
+	FIL writer, other;
+	int failed = 0;
+
+	if( f_open( &writer, path, FA_CREATE_ALWAYS | FA_WRITE ) != FR_OK )
+	{
+		return STRESS_fail( "create", path, FR_OK );
+	}
+	if( f_open( &other, path, FA_READ ) != FR_LOCKED
+			|| f_open( &other, path, FA_OPEN_ALWAYS | FA_WRITE ) != FR_LOCKED
+			|| f_unlink( path ) != FR_LOCKED )
+	{
+		printf( "%s was not locked while open\n", path );
+		failed = 1;
+	}
+	f_close( &writer );
+
+	if( f_open( &other, path, FA_READ ) != FR_OK || f_close( &other ) != FR_OK || f_unlink( path ) != FR_OK )
+	{
+		printf( "%s stayed locked after closing\n", path );
+		failed = 1;
+	}
+
+	return failed;
+}
+
+// FAT CHECK *******************************************************************
+
+static FATFS   *fsckFs;
+static uint8_t *fsckUsed;				///< One bit per cluster reached from a directory.
+static uint32_t fsckClusters;			///< Clusters reached.
+static uint32_t fsckFiles;
+static uint32_t fsckDirs;
+static BYTE     fsckSector[512];
+static DWORD    fsckSectorNum;
+
+static DWORD STRESS_fatEntry( DWORD clust )
+{
+	DWORD offset = clust * ( ( fsckFs->fs_type == FS_FAT32 ) ? 4 : 2 );
+	DWORD sector = fsckFs->fatbase + offset / 512;
+	BYTE *p;
+
+	if( sector != fsckSectorNum )
+	{
+		if( disk_read( 0, fsckSector, sector, 1 ) != RES_OK )
+		{
+			return 1;					// Reads as a bad link
+		}
+		fsckSectorNum = sector;
+	}
+	p = &fsckSector[offset % 512];
+
+	if( fsckFs->fs_type == FS_FAT32 )
+	{
+		return ( p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( ( DWORD )p[3] << 24 ) ) & 0x0FFFFFFF;
+	}
+	return p[0] | ( p[1] << 8 );
+}
+
+/*
+ * Follows a cluster chain, marking its clusters. Fails on a link out of the
+ * volume, a cluster already marked or, for a file, a length that does not
+ * match its size.
+ */
+static int STRESS_walkChain( const char *path, DWORD clust, DWORD expected )
+{
+	DWORD eoc = ( fsckFs->fs_type == FS_FAT32 ) ? 0x0FFFFFF8 : 0xFFF8;
+	DWORD count = 0;
+
+	while( clust < eoc )
+	{
+		if( clust < 2 || clust >= fsckFs->n_fatent )
+		{
+			printf( "fsck: %s links to cluster %lu\n", path, ( unsigned long )clust );
+			return 1;
+		}
+		if( fsckUsed[clust / 8] & ( 1 << ( clust % 8 ) ) )
+		{
+			printf( "fsck: %s shares cluster %lu\n", path, ( unsigned long )clust );
+			return 1;
+		}
+		fsckUsed[clust / 8] |= 1 << ( clust % 8 );
+		fsckClusters++;
+		count++;
+		clust = STRESS_fatEntry( clust );
+	}
+
+	if( expected != 0 && count != expected )
+	{
+		printf( "fsck: %s has %lu clusters, its size needs %lu\n", path, ( unsigned long )count, ( unsigned long )expected );
+		return 1;
+	}
+	return 0;
+}
+
+static int STRESS_walkDir( char *path )
+{
+	DWORD bytesPerClust = fsckFs->csize * 512;
+	size_t len = strlen( path );
+	FILINFO info;
+	DIR dir;
+	FIL fil;
+	DWORD clust;
+	int failed = 0;
+
+	if( f_opendir( &dir, len ? path : "/" ) != FR_OK )
+	{
+		return STRESS_fail( "fsck: opendir", path, FR_OK );
+	}
+	fsckDirs++;
+
+	clust = dir.sclust;
+	if( clust == 0 && fsckFs->fs_type == FS_FAT32 )
+	{
+		clust = fsckFs->dirbase;
+	}
+	if( clust != 0 )
+	{
+		failed |= STRESS_walkChain( len ? path : "/", clust, 0 );
+	}
+
+	while( !failed && f_readdir( &dir, &info ) == FR_OK && info.fname[0] != 0 )
+	{
+		if( info.fname[0] == '.' )
+		{
+			continue;
+		}
+		sprintf( path + len, "/%s", info.fname );
+
+		if( info.fattrib & AM_DIR )
+		{
+			failed |= STRESS_walkDir( path );
+		}
+		else if( f_open( &fil, path, FA_READ ) != FR_OK )
+		{
+			failed |= STRESS_fail( "fsck: open", path, FR_OK );
+		}
+		else
+		{
+			fsckFiles++;
+			if( fil.sclust != 0 )
+			{
+				failed |= STRESS_walkChain( path, fil.sclust, ( f_size( &fil ) + bytesPerClust - 1 ) / bytesPerClust );
+			}
+			f_close( &fil );
+		}
+		path[len] = 0;
+	}
+
+	return failed;
+}
+
+/*
+ * Walks every directory and file and checks the FAT against them: every
+ * allocated cluster must be reached exactly once, and the free count kept by
+ * FatFs must match the FAT.
+ */
+static int STRESS_fsck( DWORD *freeClusters )
+{
+	char path[64] = "";
+	DWORD clust, allocated = 0;
+	int failed;
+
+	if( f_getfree( "", freeClusters, &fsckFs ) != FR_OK )
+	{
+		return STRESS_fail( "getfree", "/", FR_OK );
+	}
+	if( fsckFs->fs_type == FS_FAT12 )
+	{
+		printf( "fsck: FAT12 volume not checked\n" );
+		return 0;
+	}
+
+	fsckUsed = calloc( fsckFs->n_fatent / 8 + 1, 1 );
+	fsckClusters = fsckFiles = fsckDirs = 0;
+	fsckSectorNum = ( DWORD )-1;
+
+	failed = STRESS_walkDir( path );
+
+	for( clust = 2; clust < fsckFs->n_fatent; clust++ )
+	{
+		if( STRESS_fatEntry( clust ) != 0 )
+		{
+			allocated++;
+		}
+	}
+	if( !failed && allocated != fsckClusters )
+	{
+		printf( "fsck: %lu clusters allocated, %lu reached\n", ( unsigned long )allocated, ( unsigned long )fsckClusters );
+		failed = 1;
+	}
+	if( !failed && *freeClusters != fsckFs->n_fatent - 2 - allocated )
+	{
+		printf( "fsck: FatFs counts %lu free clusters, the FAT %lu\n", ( unsigned long )*freeClusters,
+				( unsigned long )( fsckFs->n_fatent - 2 - allocated ) );
+		failed = 1;
+	}
+
+	free( fsckUsed );
+	return failed;
+}
+
+/*
+ * Deletes everything in /STRESS and the directory itself.
+ */
+static void STRESS_clean( void )
+{
+	char path[32];
+	FILINFO info;
+	DIR dir;
+
+	if( f_opendir( &dir, "/STRESS" ) == FR_OK )
+	{
+		while( f_readdir( &dir, &info ) == FR_OK && info.fname[0] != 0 )
+		{
+			if( info.fname[0] != '.' )
+			{
+				sprintf( path, "/STRESS/%s", info.fname );
+				f_unlink( path );
+			}
+		}
+	}
+	f_unlink( "/STRESS" );
+}
+
+// TASKS ***********************************************************************
+
+static void STRESS_worker( void *pvParameters )
+{
+	STRESS_Job_TypeDef *job = pvParameters;
+
+	if( job->run( job->arg ) != 0 )
+	{
+		printf( "%s task failed\n", job->name );
+		jobFailures++;
+	}
+	xSemaphoreGive( jobDone );
+
+	vTaskSuspend( NULL );
+}
+
+/*
+ * Runs every job, either one after the other from this task or each from a
+ * task of its own, and reports the aggregate throughput.
+ */
+static int STRESS_run( bool concurrent )
+{
+	uint64_t bytes, t0, t;
+	uint32_t i;
+
+	bytes = ( uint64_t )payloadTasks * imagesPerTask * STRESS_IMAGE + hkSamples * STRESS_HK_SAMPLE
+			+ logEntries * sizeof( FS_LogRecord_TypeDef );
+	jobFailures = 0;
+
+	t0 = STRESS_now();
+	for( i = 0; i < jobCount; i++ )
+	{
+		if( concurrent )
+		{
+			xTaskCreate( STRESS_worker, ( const signed char * )jobs[i].name, 1024, &jobs[i], 1, NULL );
+		}
+		else if( jobs[i].run( jobs[i].arg ) != 0 )
+		{
+			printf( "%s failed\n", jobs[i].name );
+			jobFailures++;
+		}
+	}
+	if( concurrent )
+	{
+		for( i = 0; i < jobCount; i++ )
+		{
+			xSemaphoreTake( jobDone, portMAX_DELAY );
+		}
+	}
+	t = STRESS_now() - t0;
+
+	printf( "%-12s %5u %8.1f %10.2f %10.0f\n", concurrent ? "concurrent" : "single task",
+			( unsigned )( concurrent ? jobCount : 1 ), bytes / 1024.0, t / 1e6, bytes / 1024.0 / ( t / 1e9 ) );
+
+	return jobFailures != 0;
+}
+
+static void STRESS_task( void *pvParameters )
+{
+	DWORD freeBefore, freeAfter, freeNow;
+	int failed = 0;
+
+	jobDone = xSemaphoreCreateCounting( jobCount, 0 );
+
+	if( STRESS_fsck( &freeBefore ) != 0 )
+	{
+		printf( "volume inconsistent before the test\n" );
+		failed = 1;
+	}
+	f_mkdir( "/STRESS" );
+
+	// Allocate the rings outside the timed runs
+	failed |= STRESS_log( 0 );
+
+	printf( "FatFs stress: %u payload tasks, housekeeping and 3 logs, %u KiB per run\n", ( unsigned )payloadTasks,
+			( unsigned )stressKiB );
+	printf( "run          tasks      KiB    time ms      KiB/s\n" );
+	failed |= STRESS_run( false );
+	failed |= STRESS_run( true );
+
+	failed |= STRESS_locks();
+	printf( "file locks %s\n", failed ? "FAILED" : "ok" );
+
+	if( STRESS_fsck( &freeNow ) != 0 )
+	{
+		failed = 1;
+	}
+	printf( "fsck: %u files, %u directories, %u clusters in use %s\n", ( unsigned )fsckFiles, ( unsigned )fsckDirs,
+			( unsigned )fsckClusters, failed ? "FAILED" : "ok" );
+
+	STRESS_clean();
+	if( STRESS_fsck( &freeAfter ) != 0 || freeAfter != freeBefore )
+	{
+		printf( "free clusters %lu after cleaning up, %lu before\n", ( unsigned long )freeAfter, ( unsigned long )freeBefore );
+		failed = 1;
+	}
+
+	stressResult = failed;
+	printf( "FatFs stress %s\n", failed ? "FAILED" : "ok" );
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	uint32_t i, payloadKiB;
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "w:m:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'w':	payloadTasks = strtoul( optarg, NULL, 0 );	break;
+		case 'm':	stressKiB = strtoul( optarg, NULL, 0 );		break;
+		default:
+			fprintf( stderr, "usage: %s [-w tasks] [-m KiB]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( payloadTasks == 0 || payloadTasks > STRESS_MAXPAYLOAD || stressKiB < 64 || stressKiB > 4096 )
+	{
+		fprintf( stderr, "1 to %u payload tasks and 64 to 4096 KiB\n", STRESS_MAXPAYLOAD );
+		return 2;
+	}
+
+	// Three quarters images, the rest housekeeping and logs
+	payloadKiB = stressKiB * 3 / 4;
+	imagesPerTask = payloadKiB / ( STRESS_IMAGE / 1024 ) / payloadTasks;
+	if( imagesPerTask == 0 )
+	{
+		imagesPerTask = 1;
+	}
+	hkSamples = ( stressKiB - payloadKiB ) * 1024 / 2 / STRESS_HK_SAMPLE;
+	logEntries = ( stressKiB - payloadKiB ) * 1024 / 2 / sizeof( FS_LogRecord_TypeDef );
+
+	jobs[0] = ( STRESS_Job_TypeDef ){ "LOG", STRESS_log, logEntries };
+	jobs[1] = ( STRESS_Job_TypeDef ){ "HANDH", STRESS_housekeeping, hkSamples };
+	jobCount = 2;
+	for( i = 0; i < payloadTasks; i++ )
+	{
+		jobs[jobCount++] = ( STRESS_Job_TypeDef ){ "PAYLOAD", STRESS_payload, i };
+	}
+
+	if( HOST_DISK_Init( NULL, STRESS_DISK_MB ) != 0 )
+	{
+		fprintf( stderr, "could not create disk image\n" );
+		return 1;
+	}
+
+	xTaskCreate( STRESS_task, ( const signed char * )"STRESS", 1024, NULL, 2, NULL );
+	vTaskStartScheduler();
+
+	HOST_DISK_Close();
+
+	return stressResult;
+}
+
+/**********************************************************************************
+ * Stand-ins for the flight software
+ *********************************************************************************/
+
+time_t getOBC_time( void )
+{
+	return 1792152000;
+}
+
+DWORD get_fattime( void )
+{
+	return ( 28 << 25 ) | ( 2 << 21 ) | ( 1 << 16 );
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf( stderr, "stack overflow in task %s\n", pcTaskName );
+	abort();
+}
+
+void vApplicationIdleHook( void )
+{
+	vPortWaitForTick();
+}
+
+// The host FreeRTOSConfig.h traces queues for the dispatch benchmark
+void vHostTraceQueueSend( void *pxQueue )
+{
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+}
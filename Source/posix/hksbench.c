@@ -0,0 +1,661 @@
+/***************************************************************************//**
+ * @file	hksbench.c
+ * @brief	Housekeeping time series test and benchmark for the host build.
+ *
+ * The external SRAM is a plain array here. Every channel follows a 90 minute
+ * orbit with a little noise, f() below, with short and long gaps in the
+ * sampling, so every record the store should hold can be worked out again
+ * from the time alone.
+ *
+ * HKSBENCH_series() adds days of samples, then checks every record the three
+ * rings still hold, the gaps in them and the spilled blocks, decoded, against
+ * rollups worked out independently. It reports the memory used per day of
+ * data at each resolution and on the card.
+ *
+ * HKSBENCH_restart() steps the time back and forward past the sample ring
+ * and checks the rings start again, with the minutes so far spilled.
+ *
+ * HKSBENCH_concurrent() queries the rings from a reader thread while a writer
+ * thread adds samples flat out, and checks no record read is torn or stale.
+ *
+ * HKSBENCH_latency() times adding a sample and querying each ring for a
+ * single record, a downlink frame, a thousand records and the whole ring.
+ *
+ * Usage: fsw_hksbench [-d days] [-q queries] [-s seed]
+ *   -d  days of samples of the series test (default 3)
+ *   -q  queries timed per ring and size (default 2000)
+ *   -s  seed of the queried times (default 1)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "fsw_hkseries.h"
+
+#define HKSBENCH_DAYS		3				///< Default days of the series test.
+#define HKSBENCH_QUERIES	2000			///< Default queries timed per ring and size.
+#define HKSBENCH_START		1700000017UL	///< First sample of the series test, partway into a minute.
+#define HKSBENCH_ORBIT		5400			///< Orbit period, seconds.
+#define HKSBENCH_WRITES		2000000			///< Seconds added by the concurrent test's writer.
+#define HKSBENCH_MAXBLOCKS	4096			///< Spilled blocks kept, more than two months of minutes.
+#define HKSBENCH_SECONDSFRAME	28			///< Samples in a downlink frame.
+#define HKSBENCH_ROLLUPSFRAME	9			///< Rollups in a downlink frame.
+
+static const uint16_t hksbenchLen[FSW_HKS_TIERS] = { FSW_HKS_SECONDS, FSW_HKS_MINUTES, FSW_HKS_TENMINUTES };
+static const uint16_t hksbenchPeriod[FSW_HKS_TIERS] = { 1, 60, 600 };
+static const char *hksbenchTierName[FSW_HKS_TIERS] = { "seconds", "minutes", "ten minutes" };
+
+static uint32_t hksbenchDays = HKSBENCH_DAYS;
+static uint32_t hksbenchQueries = HKSBENCH_QUERIES;
+static uint32_t hksbenchSeed = 1;
+
+/// The external SRAM
+static uint16_t hksbenchSram[( FSW_HKS_MEMSIZE + 1 ) / 2];
+
+static uint8_t ( *hksbenchBlocks )[FSW_HKS_BLOCK];
+static uint32_t hksbenchSpilled;
+
+static volatile uint32_t hksbenchWritten;
+static volatile int hksbenchWriting;
+
+// FUNCTIONS *******************************************************************
+
+static uint64_t HKSBENCH_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t HKSBENCH_random( void )
+{
+	hksbenchSeed ^= hksbenchSeed << 13;
+	hksbenchSeed ^= hksbenchSeed >> 17;
+	hksbenchSeed ^= hksbenchSeed << 5;
+
+	return hksbenchSeed;
+}
+
+/*
+ * A channel's sample at a time: the ADC channels in millivolts and the
+ * temperature in 1/256 degrees, each swinging over the orbit, with noise
+ * hashed from the time.
+ */
+static int16_t HKSBENCH_f( uint8_t c, uint32_t t )
+{
+	double phase = 2.0 * M_PI * ( t % HKSBENCH_ORBIT ) / HKSBENCH_ORBIT;
+	uint32_t h = ( t + 1 ) * 2654435761UL ^ ( c + 1 ) * 40503UL;
+	int32_t noise;
+
+	h ^= h >> 15;
+	h *= 2246822519UL;
+	h ^= h >> 13;
+
+	if( c == FSW_HKS_CHANNELS - 1 )
+	{
+		noise = ( int32_t )( h % 65 ) - 32;
+		return ( int16_t )( 20 * 256 + lround( 8 * 256 * sin( phase ) ) + noise );
+	}
+	noise = ( int32_t )( h % 7 ) - 3;
+	return ( int16_t )( 800 + 500 * c + lround( 200 * sin( phase + c ) ) + noise );
+}
+
+/*
+ * Whether the series test skips a second: 20 s every hour and two and a half
+ * minutes every six hours.
+ */
+static int HKSBENCH_gap( uint32_t t )
+{
+	uint32_t s = t - HKSBENCH_START;
+
+	return ( s % 3600 >= 100 && s % 3600 < 120 ) || ( s % 21600 >= 3000 && s % 21600 < 3150 );
+}
+
+static int16_t HKSBENCH_sample( uint8_t c, uint32_t t, uint32_t start )
+{
+	return ( t < start || HKSBENCH_gap( t ) ) ? FSW_HKS_NODATA : HKSBENCH_f( c, t );
+}
+
+static void HKSBENCH_take( int32_t sum, int32_t n, int16_t min, int16_t max, FSW_HKS_Rollup_TypeDef *r )
+{
+	if( n == 0 )
+	{
+		r->min = r->max = r->mean = FSW_HKS_NODATA;
+		return;
+	}
+	r->min = min;
+	r->max = max;
+	r->mean = ( int16_t )( sum >= 0 ? ( sum + n / 2 ) / n : ( sum - n / 2 ) / n );
+}
+
+/*
+ * A minute's rollup of a channel, of the samples from start on.
+ */
+static void HKSBENCH_minute( uint8_t c, uint32_t minute, uint32_t start, FSW_HKS_Rollup_TypeDef *r )
+{
+	int32_t sum = 0, n = 0;
+	int16_t v, min = INT16_MAX, max = INT16_MIN;
+	uint32_t t;
+
+	for( t = minute * 60; t < minute * 60 + 60; t++ )
+	{
+		v = HKSBENCH_sample( c, t, start );
+		if( v != FSW_HKS_NODATA )
+		{
+			sum += v;
+			n++;
+			min = v < min ? v : min;
+			max = v > max ? v : max;
+		}
+	}
+	HKSBENCH_take( sum, n, min, max, r );
+}
+
+/*
+ * A record of a channel in a ring, worked out from the samples from start on.
+ */
+static void HKSBENCH_expected( uint8_t tier, uint8_t c, uint32_t index, uint32_t start, FSW_HKS_Rollup_TypeDef *r )
+{
+	FSW_HKS_Rollup_TypeDef m;
+	int32_t sum = 0, n = 0;
+	int16_t min = INT16_MAX, max = INT16_MIN;
+	uint32_t minute;
+
+	switch( tier )
+	{
+	case FSW_HKS_TIER_SECOND:
+		r->min = r->max = r->mean = HKSBENCH_sample( c, index, start );
+		break;
+	case FSW_HKS_TIER_MINUTE:
+		HKSBENCH_minute( c, index, start, r );
+		break;
+	default:
+		for( minute = index * 10; minute < index * 10 + 10; minute++ )
+		{
+			HKSBENCH_minute( c, minute, start, &m );
+			if( m.mean != FSW_HKS_NODATA )
+			{
+				sum += m.mean;
+				n++;
+				min = m.min < min ? m.min : min;
+				max = m.max > max ? m.max : max;
+			}
+		}
+		HKSBENCH_take( sum, n, min, max, r );
+		break;
+	}
+}
+
+static int HKSBENCH_same( const FSW_HKS_Rollup_TypeDef *a, const FSW_HKS_Rollup_TypeDef *b )
+{
+	return a->min == b->min && a->max == b->max && a->mean == b->mean;
+}
+
+static void HKSBENCH_spill( const uint8_t *block )
+{
+	if( hksbenchSpilled < HKSBENCH_MAXBLOCKS )
+	{
+		memcpy( hksbenchBlocks[hksbenchSpilled], block, FSW_HKS_BLOCK );
+	}
+	hksbenchSpilled++;
+}
+
+static void HKSBENCH_add( uint32_t t )
+{
+	int16_t values[FSW_HKS_CHANNELS];
+	uint8_t c;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		values[c] = HKSBENCH_f( c, t );
+	}
+	FSW_HKS_add( t, values );
+}
+
+/*
+ * Checks every record of every ring and channel against the samples from
+ * start to the last added, end.
+ */
+static int HKSBENCH_checkRings( uint32_t start, uint32_t end )
+{
+	static FSW_HKS_Rollup_TypeDef out[UINT16_MAX];
+	FSW_HKS_Rollup_TypeDef expected;
+	uint32_t first, next, oldest, i;
+	uint16_t n;
+	uint8_t tier, c;
+
+	for( tier = 0; tier < FSW_HKS_TIERS; tier++ )
+	{
+		// Records up to the last one closed, as far back as the ring holds
+		next = tier == FSW_HKS_TIER_SECOND ? end + 1 : ( end + 1 ) / hksbenchPeriod[tier];
+		oldest = start / hksbenchPeriod[tier];
+		if( next - oldest > hksbenchLen[tier] )
+		{
+			oldest = next - hksbenchLen[tier];
+		}
+
+		for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+		{
+			// From the start, which for a full ring has been overwritten
+			n = FSW_HKS_query( tier, c, start, out, UINT16_MAX, &first );
+			if( n != next - oldest || first != oldest * hksbenchPeriod[tier] )
+			{
+				printf( "%s, channel %u: %u records from %lu, expected %lu from %lu\n", hksbenchTierName[tier], c, n,
+						( unsigned long )first, ( unsigned long )( next - oldest ), ( unsigned long )( oldest * hksbenchPeriod[tier] ) );
+				return 1;
+			}
+			for( i = 0; i < n; i++ )
+			{
+				HKSBENCH_expected( tier, c, oldest + i, start, &expected );
+				if( !HKSBENCH_same( &out[i], &expected ) )
+				{
+					printf( "%s, channel %u, record at %lu: %d/%d/%d, expected %d/%d/%d\n", hksbenchTierName[tier], c,
+							( unsigned long )( ( oldest + i ) * hksbenchPeriod[tier] ), out[i].min, out[i].max, out[i].mean,
+							expected.min, expected.max, expected.mean );
+					return 1;
+				}
+			}
+
+			// Nothing after the last record, and a window partway into the ring
+			if( FSW_HKS_query( tier, c, next * hksbenchPeriod[tier], out, 1, &first ) != 0 ||
+				FSW_HKS_query( tier, c, ( next - 3 ) * hksbenchPeriod[tier] + hksbenchPeriod[tier] - 1, out, 2, &first ) != 2 ||
+				first != ( next - 3 ) * hksbenchPeriod[tier] )
+			{
+				printf( "%s, channel %u: window queries wrong\n", hksbenchTierName[tier], c );
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Decodes the spilled blocks and checks they hold every minute closed, from
+ * the first, against the samples from start.
+ */
+static int HKSBENCH_checkBlocks( uint32_t start, uint32_t minutes, uint32_t *bytes )
+{
+	FSW_HKS_Rollup_TypeDef out[FSW_HKS_BLOCK], expected;
+	FSW_HKS_BlockHeader_TypeDef header;
+	uint8_t copy[FSW_HKS_BLOCK];
+	uint32_t b, first, minute = start / 60, i;
+	uint16_t n;
+	uint8_t c;
+
+	*bytes = 0;
+	for( b = 0; b < hksbenchSpilled; b++ )
+	{
+		n = FSW_HKS_decodeBlock( hksbenchBlocks[b], &first, out, FSW_HKS_BLOCK );
+		if( n == 0 || first != minute * 60 )
+		{
+			printf( "block %lu: %u minutes from %lu, expected minute %lu\n", ( unsigned long )b, n,
+					( unsigned long )first, ( unsigned long )minute * 60 );
+			return 1;
+		}
+		for( i = 0; i < n; i++, minute++ )
+		{
+			for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+			{
+				HKSBENCH_minute( c, minute, start, &expected );
+				if( !HKSBENCH_same( &out[i * FSW_HKS_CHANNELS + c], &expected ) )
+				{
+					printf( "block %lu, minute %lu, channel %u: decoded differently\n", ( unsigned long )b,
+							( unsigned long )minute * 60, c );
+					return 1;
+				}
+			}
+		}
+		memcpy( &header, hksbenchBlocks[b], sizeof( header ) );
+		*bytes += sizeof( header ) + header.len;
+
+		// A bit flipped anywhere in the used bytes is refused
+		memcpy( copy, hksbenchBlocks[b], FSW_HKS_BLOCK );
+		copy[HKSBENCH_random() % ( sizeof( header ) + header.len )] ^= 1 << ( HKSBENCH_random() % 8 );
+		if( FSW_HKS_decodeBlock( copy, &first, out, FSW_HKS_BLOCK ) != 0 )
+		{
+			printf( "block %lu: decoded with a bit flipped\n", ( unsigned long )b );
+			return 1;
+		}
+	}
+
+	if( minute - start / 60 != minutes )
+	{
+		printf( "blocks hold %lu minutes, expected %lu\n", ( unsigned long )( minute - start / 60 ), ( unsigned long )minutes );
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Adds days of samples with gaps, checks the rings and the spilled blocks and
+ * reports the memory used per day.
+ */
+static int HKSBENCH_series( void )
+{
+	FSW_HKS_Stats_TypeDef stats;
+	uint32_t start = HKSBENCH_START, end = HKSBENCH_START + hksbenchDays * 86400 - 1;
+	uint32_t t, samples = 0, minutes, bytes;
+	double perDay = 86400.0 / ( end + 1 - start );
+
+	hksbenchSpilled = 0;
+	FSW_HKS_Init( ( uint8_t * )hksbenchSram, HKSBENCH_spill );
+
+	for( t = start; t <= end; t++ )
+	{
+		if( !HKSBENCH_gap( t ) )
+		{
+			HKSBENCH_add( t );
+			samples++;
+		}
+	}
+
+	FSW_HKS_getStats( &stats );
+	if( stats.samples != samples || stats.samples + stats.gaps != end + 1 - start || stats.restarts != 0 )
+	{
+		printf( "series: counted %lu samples and %lu gaps, expected %lu and %lu\n", ( unsigned long )stats.samples,
+				( unsigned long )stats.gaps, ( unsigned long )samples, ( unsigned long )( end + 1 - start - samples ) );
+		return 1;
+	}
+
+	if( HKSBENCH_checkRings( start, end ) != 0 )
+	{
+		return 1;
+	}
+
+	// Spill the minutes of the last, part filled block, as when the card is unmounted
+	FSW_HKS_spill();
+	FSW_HKS_getStats( &stats );
+	minutes = ( end + 1 ) / 60 - start / 60;
+	if( hksbenchSpilled > HKSBENCH_MAXBLOCKS || stats.spills != hksbenchSpilled || stats.spilledMinutes != minutes ||
+		HKSBENCH_checkBlocks( start, minutes, &bytes ) != 0 || bytes != stats.spilledBytes )
+	{
+		printf( "series: %lu blocks of %lu minutes spilled, expected %lu minutes\n", ( unsigned long )hksbenchSpilled,
+				( unsigned long )stats.spilledMinutes, ( unsigned long )minutes );
+		return 1;
+	}
+
+	printf( "series: %lu days, %lu samples and %lu gaps, every record in the rings and %lu blocks ok\n",
+			( unsigned long )hksbenchDays, ( unsigned long )stats.samples, ( unsigned long )stats.gaps, ( unsigned long )hksbenchSpilled );
+
+	printf( "memory: %lu bytes of SRAM for %u channels: %u h of seconds, %u h of minutes, %u days of ten minutes\n",
+			( unsigned long )FSW_HKS_MEMSIZE, FSW_HKS_CHANNELS, FSW_HKS_SECONDS / 3600, FSW_HKS_MINUTES / 60,
+			FSW_HKS_TENMINUTES / 144 );
+	printf( "memory per day of every channel: %lu bytes of seconds, %lu of minutes, %lu of ten minutes\n",
+			( unsigned long )( 86400UL * sizeof( int16_t ) * FSW_HKS_CHANNELS ),
+			( unsigned long )( 1440UL * sizeof( FSW_HKS_Rollup_TypeDef ) * FSW_HKS_CHANNELS ),
+			( unsigned long )( 144UL * sizeof( FSW_HKS_Rollup_TypeDef ) * FSW_HKS_CHANNELS ) );
+	printf( "spilled per day: %.0f bytes coded, %.1f blocks or %.0f bytes on the card, %.2f bytes per channel minute, %.2fx smaller than the rollups\n",
+			bytes * perDay, hksbenchSpilled * perDay, hksbenchSpilled * perDay * FSW_HKS_BLOCK,
+			( double )bytes / ( ( double )minutes * FSW_HKS_CHANNELS ),
+			( double )minutes * FSW_HKS_CHANNELS * sizeof( FSW_HKS_Rollup_TypeDef ) / bytes );
+
+	return 0;
+}
+
+/*
+ * Steps the time back, and forward past the sample ring, and checks the rings
+ * start again each time with what came before spilled.
+ */
+static int HKSBENCH_restart( void )
+{
+	FSW_HKS_Stats_TypeDef stats;
+	uint32_t start = HKSBENCH_START, last = 0, t;
+	const uint32_t jumps[] = { 7200 + 1234, 3 * 86400 + 45, 86400 - 4000 };
+	uint8_t j;
+
+	hksbenchSpilled = 0;
+	FSW_HKS_Init( ( uint8_t * )hksbenchSram, HKSBENCH_spill );
+
+	for( j = 0; j < sizeof( jumps ) / sizeof( jumps[0] ); j++ )
+	{
+		for( t = start; t < start + jumps[j]; t++ )
+		{
+			if( !HKSBENCH_gap( t ) )
+			{
+				HKSBENCH_add( t );
+				last = t;
+			}
+		}
+		if( HKSBENCH_checkRings( start, last ) != 0 )
+		{
+			printf( "restart %u: rings wrong\n", j );
+			return 1;
+		}
+		FSW_HKS_getStats( &stats );
+		if( stats.restarts != j )
+		{
+			printf( "restart %u: %u restarts counted\n", j, stats.restarts );
+			return 1;
+		}
+
+		// Back by a little over an hour, then forward by more than the sample ring
+		start = ( j % 2 == 0 ) ? last - 4000 : last + FSW_HKS_SECONDS + 17;
+	}
+
+	// Every run before a restart is spilled in whole, the last minutes not yet
+	FSW_HKS_getStats( &stats );
+	if( stats.restarts != sizeof( jumps ) / sizeof( jumps[0] ) - 1 || stats.spills != hksbenchSpilled || hksbenchSpilled == 0 )
+	{
+		printf( "restart: %u restarts and %u spills counted\n", stats.restarts, stats.spills );
+		return 1;
+	}
+
+	printf( "restart: %u restarts, rings started again and %lu blocks spilled, ok\n", stats.restarts,
+			( unsigned long )hksbenchSpilled );
+
+	return 0;
+}
+
+static void *HKSBENCH_writer( void *arg )
+{
+	uint32_t t;
+
+	( void )arg;
+	for( t = HKSBENCH_START; t < HKSBENCH_START + HKSBENCH_WRITES; t++ )
+	{
+		if( !HKSBENCH_gap( t ) )
+		{
+			HKSBENCH_add( t );
+			hksbenchWritten = t;
+		}
+		if( t % 64 == 0 )
+		{
+			sched_yield();
+		}
+	}
+	hksbenchWriting = 0;
+
+	return NULL;
+}
+
+/*
+ * Queries random windows of the seconds and minutes while a writer thread
+ * adds samples, and checks every record read.
+ */
+static int HKSBENCH_concurrent( void )
+{
+	FSW_HKS_Rollup_TypeDef out[256], expected;
+	pthread_t writer;
+	uint32_t queries = 0, records = 0, wrong = 0, first, now, i;
+	uint16_t n;
+	uint8_t tier, c;
+
+	FSW_HKS_Init( ( uint8_t * )hksbenchSram, NULL );
+	hksbenchWritten = 0;
+	hksbenchWriting = 1;
+	pthread_create( &writer, NULL, HKSBENCH_writer, NULL );
+
+	while( hksbenchWriting )
+	{
+		now = hksbenchWritten;
+		if( now == 0 )
+		{
+			sched_yield();
+			continue;
+		}
+		tier = HKSBENCH_random() % 2;
+		c = HKSBENCH_random() % FSW_HKS_CHANNELS;
+		n = FSW_HKS_query( tier, c, now - HKSBENCH_random() % ( hksbenchLen[tier] * hksbenchPeriod[tier] ), out,
+						   tier == FSW_HKS_TIER_SECOND ? 256 : 8, &first );
+		for( i = 0; i < n; i++ )
+		{
+			HKSBENCH_expected( tier, c, first / hksbenchPeriod[tier] + i, HKSBENCH_START, &expected );
+			if( !HKSBENCH_same( &out[i], &expected ) )
+			{
+				wrong++;
+			}
+		}
+		queries++;
+		records += n;
+		sched_yield();
+	}
+	pthread_join( writer, NULL );
+
+	printf( "concurrent: %lu queries of %lu records while %u samples were added, %lu wrong, %s\n",
+			( unsigned long )queries, ( unsigned long )records, HKSBENCH_WRITES, ( unsigned long )wrong,
+			wrong == 0 && queries != 0 ? "ok" : "FAILED" );
+
+	return wrong != 0 || queries == 0;
+}
+
+static int HKSBENCH_compare( const void *a, const void *b )
+{
+	uint32_t x = *( const uint32_t * )a, y = *( const uint32_t * )b;
+
+	return ( x > y ) - ( x < y );
+}
+
+/*
+ * Times adding a sample, and the queries of each ring for a record, a
+ * downlink frame, a thousand records and the whole ring, all from full rings.
+ */
+static void HKSBENCH_latency( void )
+{
+	static FSW_HKS_Rollup_TypeDef out[UINT16_MAX];
+	static int16_t orbit[HKSBENCH_ORBIT][FSW_HKS_CHANNELS];
+	uint32_t *ns = malloc( hksbenchQueries * sizeof( uint32_t ) );
+	uint32_t t, end, first, q, size, sizes[4];
+	uint64_t start;
+	uint8_t tier, s, c;
+
+	// The samples of an orbit, worked out before timing
+	for( t = 0; t < HKSBENCH_ORBIT; t++ )
+	{
+		for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+		{
+			orbit[t][c] = HKSBENCH_f( c, t );
+		}
+	}
+
+	FSW_HKS_Init( ( uint8_t * )hksbenchSram, HKSBENCH_spill );
+	hksbenchSpilled = 0;
+	end = HKSBENCH_START + FSW_HKS_TENMINUTES * 600;
+	start = HKSBENCH_now();
+	for( t = HKSBENCH_START; t < end; t++ )
+	{
+		FSW_HKS_add( t, orbit[t % HKSBENCH_ORBIT] );
+	}
+	printf( "add: %.0f ns per sample, spills included\n", ( double )( HKSBENCH_now() - start ) / ( end - HKSBENCH_START ) );
+
+	for( tier = 0; tier < FSW_HKS_TIERS; tier++ )
+	{
+		sizes[0] = 1;
+		sizes[1] = tier == FSW_HKS_TIER_SECOND ? HKSBENCH_SECONDSFRAME : HKSBENCH_ROLLUPSFRAME;
+		sizes[2] = 1024;
+		sizes[3] = hksbenchLen[tier];
+		for( s = 0; s < 4; s++ )
+		{
+			size = sizes[s];
+			for( q = 0; q < hksbenchQueries; q++ )
+			{
+				t = end - ( size + HKSBENCH_random() % ( hksbenchLen[tier] - size + 1 ) ) * hksbenchPeriod[tier];
+				start = HKSBENCH_now();
+				FSW_HKS_query( tier, HKSBENCH_random() % FSW_HKS_CHANNELS, t, out, size, &first );
+				ns[q] = ( uint32_t )( HKSBENCH_now() - start );
+			}
+			qsort( ns, hksbenchQueries, sizeof( uint32_t ), HKSBENCH_compare );
+			printf( "query %-11s %5lu records: median %6lu ns, p99 %6lu ns\n", hksbenchTierName[tier], ( unsigned long )size,
+					( unsigned long )ns[hksbenchQueries / 2], ( unsigned long )ns[hksbenchQueries * 99 / 100] );
+		}
+	}
+
+	free( ns );
+}
+
+int main( int argc, char **argv )
+{
+	int opt, result;
+
+	while( ( opt = getopt( argc, argv, "d:q:s:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'd':	hksbenchDays = strtoul( optarg, NULL, 0 );		break;
+		case 'q':	hksbenchQueries = strtoul( optarg, NULL, 0 );	break;
+		case 's':	hksbenchSeed = strtoul( optarg, NULL, 0 );		break;
+		default:
+			fprintf( stderr, "usage: %s [-d days] [-q queries] [-s seed]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( hksbenchDays == 0 || hksbenchDays > 60 || hksbenchQueries == 0 || hksbenchSeed == 0 )
+	{
+		fprintf( stderr, "days outside 1 to 60, or queries or seed 0\n" );
+		return 2;
+	}
+
+	hksbenchBlocks = malloc( HKSBENCH_MAXBLOCKS * FSW_HKS_BLOCK );
+
+	printf( "Housekeeping series, %u channels\n", FSW_HKS_CHANNELS );
+
+	result = HKSBENCH_series();
+	if( result == 0 )
+	{
+		result = HKSBENCH_restart();
+	}
+	if( result == 0 )
+	{
+		result = HKSBENCH_concurrent();
+	}
+	if( result == 0 )
+	{
+		HKSBENCH_latency();
+	}
+
+	printf( "Housekeeping series %s\n", result ? "FAILED" : "ok" );
+
+	free( hksbenchBlocks );
+
+	return result;
+}
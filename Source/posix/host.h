@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @file	host.h
+ * @brief	Host (POSIX) build support header.
+ *
+ * Declarations shared by the host stand-ins for the BSP, the disk image and
+ * the command dispatch benchmark.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __HOST_H
+#define __HOST_H
+
+// bsp_host.c
+extern bool     HOST_uartEcho;
+extern FILE    *HOST_uartCapture;
+extern uint32_t HOST_uartTxBytes;
+extern uint32_t HOST_uartTxCalls;
+extern uint32_t HOST_i2cTransfers;
+
+// diskio_host.c
+extern uint32_t HOST_diskReads;
+extern uint32_t HOST_diskWrites;
+extern uint32_t HOST_diskSyncs;
+extern uint32_t HOST_diskWriteCmds;
+
+int  HOST_DISK_Init( const char *path, uint32_t sizeMB );		///< Create (and format) the disk image.
+void HOST_DISK_Close( void );									///< Release the disk image.
+void HOST_DISK_setCache( uint16_t lines );						///< Resize the sector cache, 0 to disable it.
+
+// bench.c
+void BENCH_Init( uint32_t cmdCount );							///< Create the dispatch benchmark task.
+int  BENCH_result( void );										///< Exit status of the benchmark run.
+int  BENCH_scheduler( uint32_t count );							///< Time the command scheduler.
+int  BENCH_router( uint32_t count );							///< Time the command routing table against the old switches.
+int  BENCH_telemetry( uint32_t count );							///< Time the telemetry store replies against the old switch.
+int  BENCH_logger( uint32_t count );							///< Time the buffered log writer against a file open per entry.
+int  BENCH_cache( uint32_t count );								///< Count the card traffic of the logs with and without the sector cache.
+
+#endif // __HOST_H
@@ -0,0 +1,515 @@
+/***************************************************************************//**
+ * @file	i2cbench.c
+ * @brief	Host benchmark of the I2C master driver.
+ *
+ * Runs bsp_i2c.c and the emlib transfer state machine against the I2C
+ * peripheral model in i2cmodel.c from a FreeRTOS task. CubeSense image frames
+ * (telemetry 192, 128 bytes) are read and checked, and the modelled time of a
+ * frame is reported with the CPU time the interrupt driven driver uses, against
+ * the busy waiting driver it replaces. Injected faults check that each error
+ * is reported, counted and recovered from.
+ *
+ * The bus scheduler of the I2C manager is then run from its own task, on
+ * rounds of a telecommand, the CubeSense sun, nadir and power telemetry and an
+ * image frame, each at its own priority. It runs once with every message in a
+ * session of its own and once with the telemetry reads coalesced, and the
+ * order, data, sessions and latencies are checked.
+ *
+ * Usage: fsw_i2cbench [-n frames] [-r rounds]
+ *   -n  image frames read (default 64)
+ *   -r  rounds of the scheduler test (default 32)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "bsp_i2c.h"
+#include "fsw_i2cbus.h"
+#include "CubeSense.1.h"
+#include "i2cmodel.h"
+
+#define I2CBENCH_FRAMELEN	128			///< Bytes in an image frame.
+#define I2CBENCH_ROUNDMSGS	5			///< Messages queued per round of the scheduler test.
+
+/// A message of a scheduler test round, in the order it should complete.
+typedef struct
+{
+	uint8_t		id;						///< Telemetry or telecommand ID written.
+	uint8_t		priority;
+	uint16_t	rxLen;					///< 0 for the telecommand.
+	uint8_t		rx[I2CBENCH_FRAMELEN];
+	double		queuedNs;				///< Modelled time it was queued.
+} I2CBENCH_Msg_TypeDef;
+
+static uint32_t benchFrames = 64;
+static uint32_t benchRounds = 32;
+static int      benchResult = 1;
+static uint8_t  frame[I2CBENCH_FRAMELEN];
+
+static xQueueHandle benchI2Cqueue;		///< Served by the scheduler task, as FSW_COMM_I2Cqueue on the target.
+static xQueueHandle benchReplies;		///< Completed messages.
+static double       latencyNs[FSW_I2C_PRIOS];	///< Modelled time from queueing to completion, summed per priority.
+
+static I2CBENCH_Msg_TypeDef roundMsgs[I2CBENCH_ROUNDMSGS] =
+{
+	{ 0x01,							FSW_I2C_PRIO_HIGH,		0 },
+	{ CubeSenseTlmIdSunSensor,		FSW_I2C_PRIO_NORMAL,	6 },
+	{ CubeSenseTlmIdNadirSensor,	FSW_I2C_PRIO_NORMAL,	6 },
+	{ CubeSenseTlmIdPower,			FSW_I2C_PRIO_NORMAL,	10 },
+	{ CubeSenseTlmIdImageFrame,		FSW_I2C_PRIO_LOW,		I2CBENCH_FRAMELEN },
+};
+
+/// Order the round's messages are queued in: lowest priority first.
+static const uint8_t roundQueued[I2CBENCH_ROUNDMSGS] = { 4, 1, 2, 3, 0 };
+
+// FUNCTIONS *******************************************************************
+
+/*
+ * Reads one image frame from the CubeSense model and checks it.
+ */
+static BSP_I2C_Status_TypeDef I2CBENCH_readFrame( void )
+{
+	uint8_t id = CubeSenseTlmIdImageFrame;
+	BSP_I2C_Status_TypeDef status;
+	uint32_t i;
+
+	memset( frame, 0, sizeof( frame ) );
+	status = BSP_I2C_masterTX( BSP_I2C_SYS, HOST_I2C_CUBESENSE, bspI2cWriteRead, &id, 1, frame, I2CBENCH_FRAMELEN );
+	if( status != bspI2cOk )
+	{
+		return status;
+	}
+
+	for( i = 0; i < I2CBENCH_FRAMELEN; i++ )
+	{
+		if( frame[i] != HOST_I2C_tlmByte( id, i ) )
+		{
+			printf( "bad data in image frame byte %lu\n", ( unsigned long )i );
+			return bspI2cSwFault;
+		}
+	}
+
+	return bspI2cOk;
+}
+
+/*
+ * Reads the image frames and reports the modelled time of one frame.
+ */
+static int I2CBENCH_frames( void )
+{
+	uint32_t n;
+	double frames;
+
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+
+	for( n = 0; n < benchFrames; n++ )
+	{
+		if( I2CBENCH_readFrame() != bspI2cOk )
+		{
+			printf( "image frame %lu failed\n", ( unsigned long )n );
+			return 1;
+		}
+	}
+
+	frames = benchFrames;
+	printf( "driver           elapsed ms   CPU ms   CPU idle   interrupts\n" );
+	printf( "busy waiting     %10.3f %8.3f %8.1f %%\n",
+			HOST_i2cStats.polledNs * 1e-6 / frames, HOST_i2cStats.polledNs * 1e-6 / frames, 0.0 );
+	printf( "interrupt        %10.3f %8.3f %8.1f %%   %10.1f\n",
+			HOST_i2cStats.elapsedNs * 1e-6 / frames, HOST_i2cStats.cpuNs * 1e-6 / frames,
+			100.0 * ( 1.0 - HOST_i2cStats.cpuNs / HOST_i2cStats.elapsedNs ),
+			HOST_i2cStats.interrupts / frames );
+
+	return 0;
+}
+
+/*
+ * Runs a transfer with an injected fault and checks the status returned.
+ */
+static int I2CBENCH_fault( const char *name, HOST_I2C_Fault_TypeDef fault, uint32_t afterBytes,
+						   uint16_t address, uint16_t rxLen, BSP_I2C_Status_TypeDef expect )
+{
+	uint8_t id = CubeSenseTlmIdImageFrame;
+	BSP_I2C_Status_TypeDef status;
+
+	HOST_I2C_setFault( fault, afterBytes );
+	status = BSP_I2C_masterTX( BSP_I2C_SYS, address, bspI2cWriteRead, &id, 1, frame, rxLen );
+	HOST_I2C_setFault( hostI2cFaultNone, 0 );
+
+	printf( "%-16s status %3d %s\n", name, ( int )status, ( status == expect ) ? "ok" : "FAILED" );
+	if( status != expect )
+	{
+		return 1;
+	}
+
+	// The channel must be usable again
+	status = I2CBENCH_readFrame();
+	if( status != bspI2cOk )
+	{
+		printf( "%-16s no recovery, status %d\n", name, ( int )status );
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Starts a transfer without waiting, checks that a second one is refused while
+ * it runs, and waits for its completion semaphore.
+ */
+static int I2CBENCH_async( void )
+{
+	static uint8_t id = CubeSenseTlmIdImageFrame;
+	static I2C_TransferSeq_TypeDef seq;
+	xSemaphoreHandle done;
+	BSP_I2C_Status_TypeDef status;
+	int result = 0;
+
+	vSemaphoreCreateBinary( done );
+	xSemaphoreTake( done, 0 );
+
+	seq.addr        = HOST_I2C_CUBESENSE;
+	seq.flags       = bspI2cWriteRead;
+	seq.buf[0].data = &id;
+	seq.buf[0].len  = 1;
+	seq.buf[1].data = frame;
+	seq.buf[1].len  = I2CBENCH_FRAMELEN;
+
+	status = BSP_I2C_masterStart( BSP_I2C_SYS, &seq, 1, done );
+	if( status != bspI2cInProgress || BSP_I2C_masterStart( BSP_I2C_SYS, &seq, 1, done ) != bspI2cBusy )
+	{
+		result = 1;
+	}
+	else if( xSemaphoreTake( done, BSP_I2C_TIMEOUT_MS / portTICK_RATE_MS ) != pdTRUE ||
+			 BSP_I2C_masterStatus( BSP_I2C_SYS ) != bspI2cOk || frame[1] != HOST_I2C_tlmByte( id, 1 ) )
+	{
+		result = 1;
+	}
+
+	printf( "%-16s %s\n", "start and wait", result ? "FAILED" : "ok" );
+	vSemaphoreDelete( done );
+
+	return result;
+}
+
+/*
+ * Checks the channel counters against the transfers made.
+ */
+static int I2CBENCH_stats( uint32_t completed )
+{
+	BSP_I2C_Stats_TypeDef stats;
+	int result;
+
+	BSP_I2C_getStats( BSP_I2C_SYS, &stats );
+	printf( "counters: %lu transfers, %lu completed, %lu bytes written, %lu read, %lu interrupts\n"
+			"          %u NACK, %u bus error, %u arbitration lost, %u timeout, %u fault\n",
+			( unsigned long )stats.transfers, ( unsigned long )stats.completed,
+			( unsigned long )stats.txBytes, ( unsigned long )stats.rxBytes, ( unsigned long )stats.interrupts,
+			stats.nacks, stats.busErrors, stats.arbLost, stats.timeouts, stats.faults );
+
+	result = !( stats.completed == completed && stats.transfers == completed + 5 &&
+				stats.rxBytes == completed * I2CBENCH_FRAMELEN && stats.txBytes == completed &&
+				stats.nacks == 1 && stats.busErrors == 1 && stats.arbLost == 1 &&
+				stats.timeouts == 1 && stats.faults == 1 );
+	printf( "counters %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Queues a message of a scheduler test round.
+ */
+static int I2CBENCH_submit( I2CBENCH_Msg_TypeDef *m, uint16_t address )
+{
+	COMM_I2Cmsg_TypeDef msg;
+
+	FSW_I2CBUS_construct( &msg, m->rxLen ? bspI2cWriteRead : bspI2cWrite, &m->id, 1, m->rx, m->rxLen, 0, address );
+	msg.priority = m->priority;
+	msg.reply = benchReplies;
+	msg.context = m;
+
+	memset( m->rx, 0, sizeof( m->rx ) );
+	m->queuedNs = HOST_i2cStats.elapsedNs;
+
+	return FSW_I2CBUS_submit( benchI2Cqueue, &msg, 0 ) == pdTRUE ? 0 : 1;
+}
+
+/*
+ * Waits for a completed message and checks it against the one expected.
+ */
+static int I2CBENCH_reply( I2CBENCH_Msg_TypeDef *expect, BSP_I2C_Status_TypeDef status )
+{
+	COMM_I2Cmsg_TypeDef msg = { NULL };
+	uint32_t i;
+
+	if( xQueueReceive( benchReplies, &msg, 1000 / portTICK_RATE_MS ) != pdTRUE )
+	{
+		printf( "no reply\n" );
+		return 1;
+	}
+	if( msg.context != expect || msg.status != status )
+	{
+		printf( "reply for ID %u status %d, expected ID %u status %d\n",
+				( ( I2CBENCH_Msg_TypeDef* )msg.context )->id, msg.status, expect->id, ( int )status );
+		return 1;
+	}
+	latencyNs[expect->priority] += HOST_i2cStats.elapsedNs - expect->queuedNs;
+
+	for( i = 0; status == bspI2cOk && i < expect->rxLen; i++ )
+	{
+		if( expect->rx[i] != HOST_I2C_tlmByte( expect->id, i ) )
+		{
+			printf( "bad data in telemetry %u byte %lu\n", expect->id, ( unsigned long )i );
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Runs the scheduler test rounds with the given session length and reports
+ * the sessions, CPU time and latencies.
+ */
+static int I2CBENCH_schedule( uint8_t batch, FSW_I2CBUS_Stats_TypeDef *stats )
+{
+	uint32_t r;
+	uint8_t i;
+	int result = 0;
+	double rounds = benchRounds;
+
+	FSW_I2CBUS_Init( batch );
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+	memset( latencyNs, 0, sizeof( latencyNs ) );
+
+	for( r = 0; r < benchRounds && result == 0; r++ )
+	{
+		// Queued together, as the ADCS and payload tasks would in one period
+		for( i = 0; i < I2CBENCH_ROUNDMSGS; i++ )
+		{
+			result |= I2CBENCH_submit( &roundMsgs[roundQueued[i]], HOST_I2C_CUBESENSE );
+		}
+		for( i = 0; i < I2CBENCH_ROUNDMSGS && result == 0; i++ )
+		{
+			result |= I2CBENCH_reply( &roundMsgs[i], bspI2cOk );
+		}
+	}
+
+	FSW_I2CBUS_getStats( stats );
+	printf( "%5u %9.2f %10.2f %9.3f %11.3f %16.3f %8.3f %8.3f\n", batch,
+			stats->sessions / rounds, stats->transfers / rounds, HOST_i2cStats.cpuNs * 1e-6 / rounds,
+			HOST_i2cStats.elapsedNs * 1e-6 / rounds,
+			latencyNs[FSW_I2C_PRIO_HIGH] * 1e-6 / stats->latency[FSW_I2C_PRIO_HIGH].messages,
+			latencyNs[FSW_I2C_PRIO_NORMAL] * 1e-6 / stats->latency[FSW_I2C_PRIO_NORMAL].messages,
+			latencyNs[FSW_I2C_PRIO_LOW] * 1e-6 / stats->latency[FSW_I2C_PRIO_LOW].messages );
+
+	return result;
+}
+
+/*
+ * Compares the scheduler with and without coalescing, and checks that a
+ * failed message is reported without holding up the ones queued after it.
+ */
+static int I2CBENCH_scheduler( void )
+{
+	FSW_I2CBUS_Stats_TypeDef single, batched;
+	static I2CBENCH_Msg_TypeDef nacked = { CubeSenseTlmIdIdentification, FSW_I2C_PRIO_NORMAL, 6 };
+	double busNs;
+	int result;
+
+	printf( "\nI2C bus scheduler, mean of %lu rounds of 5 messages (modelled)\n", ( unsigned long )benchRounds );
+	printf( "batch  sessions  transfers    CPU ms  elapsed ms  latency ms high   normal      low\n" );
+
+	result = I2CBENCH_schedule( 1, &single );
+	if( result == 0 )
+	{
+		result = I2CBENCH_schedule( FSW_I2CBUS_BATCH, &batched );
+		busNs = HOST_i2cStats.busNs;
+	}
+	if( result != 0 )
+	{
+		printf( "scheduler order or data FAILED\n" );
+		return 1;
+	}
+
+	// The telecommand and the image frame run alone, the three telemetry reads together
+	result = !( single.sessions == 5 * benchRounds && single.coalesced == 0 &&
+				batched.sessions == 3 * benchRounds && batched.coalesced == 2 * benchRounds &&
+				batched.transfers == 5 * benchRounds && batched.latency[FSW_I2C_PRIO_LOW].failed == 0 );
+	printf( "sessions and coalescing %s\n", result ? "FAILED" : "ok" );
+
+	// The counted bus time is an estimate from the bytes, at the nominal bus clock
+	printf( "bus time counted %.3f ms, modelled %.3f ms\n", batched.busUs[FSW_I2C_BUS_SYS] * 1e-3, busNs * 1e-6 );
+	if( batched.busUs[FSW_I2C_BUS_SYS] * 1e3 < busNs * 0.9 || batched.busUs[FSW_I2C_BUS_SYS] * 1e3 > busNs * 1.1 )
+	{
+		printf( "bus time counter FAILED\n" );
+		result = 1;
+	}
+
+	// A NACK fails its own message only
+	if( I2CBENCH_submit( &nacked, 0x40 ) || I2CBENCH_submit( &roundMsgs[1], HOST_I2C_CUBESENSE ) ||
+		I2CBENCH_reply( &nacked, bspI2cNack ) || I2CBENCH_reply( &roundMsgs[1], bspI2cOk ) )
+	{
+		printf( "scheduler NACK FAILED\n" );
+		result = 1;
+	}
+	else
+	{
+		printf( "scheduler NACK ok\n" );
+	}
+
+	return result;
+}
+
+// TASKS ***********************************************************************
+
+static void I2CBENCH_task( void *pvParameters )
+{
+	BSP_I2C_Init( BSP_I2C_SYS, true );
+
+	printf( "I2C master driver, CubeSense image frame of %u bytes, mean of %lu (modelled)\n",
+			I2CBENCH_FRAMELEN, ( unsigned long )benchFrames );
+
+	benchResult = I2CBENCH_frames();
+	if( benchResult == 0 )
+	{
+		benchResult |= I2CBENCH_fault( "address NACK", hostI2cFaultNone, 0, 0x40, I2CBENCH_FRAMELEN, bspI2cNack );
+		benchResult |= I2CBENCH_fault( "arbitration", hostI2cFaultArbLost, 40, HOST_I2C_CUBESENSE, I2CBENCH_FRAMELEN, bspI2cArbLost );
+		benchResult |= I2CBENCH_fault( "bus error", hostI2cFaultBusErr, 2, HOST_I2C_CUBESENSE, I2CBENCH_FRAMELEN, bspI2cBusError );
+		benchResult |= I2CBENCH_fault( "stalled slave", hostI2cFaultStall, 10, HOST_I2C_CUBESENSE, I2CBENCH_FRAMELEN, bspI2cTimeout );
+		benchResult |= I2CBENCH_fault( "read of 0 bytes", hostI2cFaultNone, 0, HOST_I2C_CUBESENSE, 0, bspI2cUsageFault );
+		benchResult |= I2CBENCH_async();
+		benchResult |= I2CBENCH_stats( benchFrames + 6 );
+	}
+	if( benchResult == 0 )
+	{
+		benchResult |= I2CBENCH_scheduler();
+	}
+
+	// Every session, failed and aborted ones included, has released its EM1 hold
+	if( HOST_sleepHolds != 0 )
+	{
+		printf( "  EM1 holds %ld, expected 0\n", ( long )HOST_sleepHolds );
+		benchResult |= 1;
+	}
+	printf( "I2C master driver %s\n", benchResult ? "FAILED" : "ok" );
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+// Runs the bus scheduler, as FSW_I2C_manager does on the target
+static void I2CBENCH_manager( void *pvParameters )
+{
+	for( ;; )
+	{
+		FSW_I2CBUS_service( benchI2Cqueue, portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "n:r:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'n':	benchFrames = strtoul( optarg, NULL, 0 );	break;
+		case 'r':	benchRounds = strtoul( optarg, NULL, 0 );	break;
+		default:
+			fprintf( stderr, "usage: %s [-n frames] [-r rounds]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( benchFrames == 0 || benchRounds == 0 )
+	{
+		fprintf( stderr, "frame or round count out of range\n" );
+		return 2;
+	}
+
+	HOST_I2C_Init();
+
+	benchI2Cqueue = xQueueCreate( 6, sizeof( COMM_I2Cmsg_TypeDef ) );
+	benchReplies = xQueueCreate( I2CBENCH_ROUNDMSGS, sizeof( COMM_I2Cmsg_TypeDef ) );
+
+	// The scheduler runs below the tasks queueing messages, as the I2C manager does
+	xTaskCreate( I2CBENCH_task, ( const signed char * )"I2CBENCH", 1024, NULL, 2, NULL );
+	xTaskCreate( I2CBENCH_manager, ( const signed char * )"I2CMGR", 1024, NULL, 1, NULL );
+	vTaskStartScheduler();
+
+	return benchResult;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Interrupt handler of the main channel. On the target it is in comms.c,
+ *   which also runs the slave mode state machine.
+ ******************************************************************************/
+void I2C0_IRQHandler( void )
+{
+	BSP_I2C_masterIRQHandler( BSP_I2C_SYS );
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf( stderr, "stack overflow in task %s\n", pcTaskName );
+	abort();
+}
+
+// The bus moves while the tasks are blocked
+void vApplicationIdleHook( void )
+{
+	HOST_I2C_run();
+	vPortWaitForTick();
+}
+
+// The host FreeRTOSConfig.h traces queues for the dispatch benchmark
+void vHostTraceQueueSend( void *pxQueue )
+{
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+}
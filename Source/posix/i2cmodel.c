@@ -0,0 +1,549 @@
+/***************************************************************************//**
+ * @file	i2cmodel.c
+ * @brief	Host I2C peripheral model.
+ *
+ * Emulates the I2C0 and I2C1 master state machines behind the register blocks
+ * of i2cmodel.h, and a CubeSense slave on the main channel, so bsp_i2c.c and
+ * the emlib transfer state machine run unmodified on the host. The bus moves
+ * on whenever HOST_I2C_run is called, i.e. while the CPU is idle, and raises
+ * the interrupts the peripheral would.
+ *
+ * Every byte on the bus is timed, and the CPU is charged for the interrupts
+ * the driver takes. The same traffic is timed a second time as the busy
+ * waiting driver would have moved it: one I2C_Transfer call after another
+ * until the transfer completes.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "i2cmodel.h"
+#include "CubeSense.1.h"
+
+// CPU costs at the 48 MHz core clock
+#define I2C_CPU_HZ			48000000.0
+#define I2C_START_CYCLES	300			///< I2C_TransferInit and blocking the calling task.
+#define I2C_ISR_CYCLES		150			///< Interrupt entry, one I2C_Transfer step and exit.
+#define I2C_WAKE_CYCLES		600			///< Semaphore given from the interrupt and switching back to the task.
+#define I2C_POLL_CYCLES		60			///< One I2C_Transfer call of the busy waiting loop.
+
+#define I2C_HW( reg )		( *( volatile uint32_t * )&( reg ) )	///< Register the driver may only read.
+#define I2C_TXDATA_EMPTY	0xFFFFFFFF	///< TXDATA taken by the bus; the driver only writes bytes.
+#define I2C_BUSES			2
+#define I2C_TCLEN			4			///< Longest telecommand parameters kept by the CubeSense model.
+#define I2C_FRAMELEN		128			///< Bytes in an image frame.
+
+/// State of the bus as seen by the master.
+typedef enum
+{
+	busIdle,
+	busWrite,							///< Addressed for writing.
+	busRead								///< Addressed for reading.
+} I2C_BusState_TypeDef;
+
+/// One I2C peripheral and its bus.
+typedef struct
+{
+	I2C_TypeDef				*regs;
+	IRQn_Type				irq;
+	void					( *handler )( void );
+	I2C_BusState_TypeDef	state;
+	bool					rxNext;		///< Receive the next byte.
+	bool					idNext;		///< Next byte written is a telemetry or telecommand ID.
+	bool					stalled;	///< SCL held low until the transfer is aborted.
+	uint8_t					tlmId;		///< Telemetry requested from, or telecommand written to, the CubeSense model.
+	uint32_t				tlmIndex;	///< Next byte of the telemetry buffer.
+	uint32_t				xferBytes;	///< Bytes of the current transfer.
+	uint8_t					tc[I2C_TCLEN];	///< Telecommand parameters written after the ID.
+	uint8_t					tcLen;
+} I2C_Bus_TypeDef;
+
+/// Image download of the CubeSense model.
+typedef struct
+{
+	bool					active;		///< Initialized, so the frame telemetry returns the image.
+	uint8_t					image;
+	uint32_t				bytes;
+	uint16_t				frame;		///< Frame loaded.
+	int32_t					faultFrame;	///< Frame corrupted the next time it is read, or -1.
+} I2C_Image_TypeDef;
+
+void I2C0_IRQHandler( void );
+void I2C1_IRQHandler( void );
+
+I2C_TypeDef HOST_i2c0;								///< I2C0 registers seen by the driver.
+I2C_TypeDef HOST_i2c1;								///< I2C1 registers seen by the driver.
+uint32_t    HOST_i2cIrqEnabled;						///< Interrupts enabled by the driver, one bit per IRQn.
+
+HOST_I2C_Stats_TypeDef HOST_i2cStats;
+
+static I2C_Bus_TypeDef buses[I2C_BUSES] =
+{
+	{ &HOST_i2c0, I2C0_IRQn, I2C0_IRQHandler },
+	{ &HOST_i2c1, I2C1_IRQn, I2C1_IRQHandler },
+};
+
+static HOST_I2C_Fault_TypeDef fault = hostI2cFaultNone;
+static uint32_t faultAfter;
+static I2C_Image_TypeDef image;
+
+// FUNCTIONS *******************************************************************
+
+static double I2C_cyclesNs( uint32_t cycles )
+{
+	return cycles * 1.0e9 / I2C_CPU_HZ;
+}
+
+/*
+ * Bit time, from the clock divider set by I2C_BusFreqSet.
+ */
+static double I2C_bitNs( I2C_TypeDef *regs )
+{
+	static const uint8_t nSum[] = { 4 + 4, 6 + 3, 11 + 6, 4 + 4 };
+	uint32_t n = nSum[( regs->CTRL & _I2C_CTRL_CLHR_MASK ) >> _I2C_CTRL_CLHR_SHIFT];
+
+	return ( n * ( regs->CLKDIV + 1 ) + 4 ) * 1.0e9 / CMU_ClockFreqGet( cmuClock_HFPER );
+}
+
+static void I2C_charge( double busNs, uint32_t cycles )
+{
+	HOST_i2cStats.busNs += busNs;
+	HOST_i2cStats.elapsedNs += busNs + I2C_cyclesNs( cycles );
+	HOST_i2cStats.polledNs += busNs + I2C_cyclesNs( cycles );
+}
+
+/*
+ * Clocks one byte and its acknowledge. Returns false if an injected fault ends
+ * the transfer instead.
+ */
+static bool I2C_byte( I2C_Bus_TypeDef *bus )
+{
+	I2C_charge( 9 * I2C_bitNs( bus->regs ), 0 );
+	HOST_i2cStats.bytes++;
+
+	if( fault != hostI2cFaultNone && ++bus->xferBytes > faultAfter )
+	{
+		switch( fault )
+		{
+		case hostI2cFaultArbLost:
+			I2C_HW( bus->regs->IF ) |= I2C_IF_ARBLOST;
+			bus->state = busIdle;
+			break;
+		case hostI2cFaultBusErr:
+			I2C_HW( bus->regs->IF ) |= I2C_IF_BUSERR;
+			bus->state = busIdle;
+			break;
+		default:
+			bus->stalled = true;
+			break;
+		}
+		fault = hostI2cFaultNone;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Byte of the frame loaded by the CubeSense model, zero past the image.
+ */
+static uint8_t I2C_frameByte( uint32_t index )
+{
+	uint32_t offset = ( uint32_t )image.frame * I2C_FRAMELEN + index;
+
+	return ( offset < image.bytes ) ? HOST_I2C_imageByte( image.image, offset ) : 0;
+}
+
+/*
+ * Byte of a telemetry buffer sent by the CubeSense model. The image frame
+ * telemetry returns the loaded frame once a download is initialized.
+ */
+static uint8_t I2C_tlmByte( uint8_t id, uint32_t index )
+{
+	uint8_t byte;
+	uint32_t i;
+
+	if( !image.active )
+	{
+		return HOST_I2C_tlmByte( id, index );
+	}
+
+	switch( id )
+	{
+	case CubeSenseTlmIdImageFrameData:
+		if( index < 2 )
+		{
+			return ( uint8_t )( image.frame >> ( 8 * index ) );
+		}
+		for( byte = 0, i = 0; i < I2C_FRAMELEN; i++ )
+		{
+			byte ^= I2C_frameByte( i );
+		}
+		return byte;
+	case CubeSenseTlmIdImageFrame:
+		byte = I2C_frameByte( index );
+		if( image.frame == image.faultFrame && index == 5 )
+		{
+			byte ^= 0x5A;
+			image.faultFrame = -1;
+		}
+		return byte;
+	default:
+		return HOST_I2C_tlmByte( id, index );
+	}
+}
+
+/*
+ * Carries out a telecommand written to the CubeSense model.
+ */
+static void I2C_telecommand( I2C_Bus_TypeDef *bus )
+{
+	switch( bus->tlmId )
+	{
+	case 64:	// Initialize image download: image, size
+		image.active = true;
+		image.image = bus->tc[0];
+		image.bytes = ( uint32_t )( 640 >> bus->tc[1] ) * ( 480 >> bus->tc[1] );
+		image.frame = 0;
+		break;
+	case 65:	// Advance image download: next frame
+		image.frame = bus->tc[0] | ( bus->tc[1] << 8 );
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Carries out the command and data written by the driver since the last step.
+ * Returns true if the bus raised a flag.
+ */
+static bool I2C_step( I2C_Bus_TypeDef *bus )
+{
+	I2C_TypeDef *regs = bus->regs;
+	uint32_t cmd = regs->CMD;
+	uint32_t addr;
+
+	regs->CMD = 0;
+	I2C_HW( regs->IF ) &= ~regs->IFC;
+	regs->IFC = 0;
+
+	// The slave lets go of a stalled bus when the driver aborts, or starts again
+	if( cmd & ( I2C_CMD_ABORT | I2C_CMD_START ) && bus->stalled )
+	{
+		bus->state = busIdle;
+		bus->stalled = false;
+	}
+	if( cmd & I2C_CMD_ABORT )
+	{
+		bus->state = busIdle;
+		regs->TXDATA = I2C_TXDATA_EMPTY;
+	}
+	if( !( regs->CTRL & I2C_CTRL_EN ) || bus->stalled )
+	{
+		return false;
+	}
+
+	// START or repeated START, with the address byte
+	if( ( cmd & I2C_CMD_START ) && regs->TXDATA != I2C_TXDATA_EMPTY )
+	{
+		if( bus->state == busIdle )
+		{
+			bus->xferBytes = 0;
+			bus->tcLen = 0;
+			HOST_i2cStats.transfers++;
+			I2C_charge( 0, I2C_START_CYCLES );
+			HOST_i2cStats.cpuNs += I2C_cyclesNs( I2C_START_CYCLES );
+		}
+		I2C_charge( I2C_bitNs( regs ), 0 );
+
+		addr = regs->TXDATA;
+		regs->TXDATA = I2C_TXDATA_EMPTY;
+		if( !I2C_byte( bus ) )
+		{
+			return !bus->stalled;
+		}
+
+		if( bus == &buses[0] && ( addr & 0xFE ) == HOST_I2C_CUBESENSE )
+		{
+			I2C_HW( regs->IF ) |= I2C_IF_ACK;
+			bus->state = ( addr & 1 ) ? busRead : busWrite;
+			bus->rxNext = ( addr & 1 );
+			bus->idNext = !( addr & 1 );
+		}
+		else
+		{
+			I2C_HW( regs->IF ) |= I2C_IF_NACK;
+			bus->state = busWrite;
+		}
+		return true;
+	}
+
+	switch( bus->state )
+	{
+	case busWrite:
+		if( regs->TXDATA != I2C_TXDATA_EMPTY )
+		{
+			if( bus->idNext )
+			{
+				bus->tlmId = regs->TXDATA;
+				bus->tlmIndex = 0;
+				bus->idNext = false;
+			}
+			else if( bus->tcLen < I2C_TCLEN )
+			{
+				bus->tc[bus->tcLen++] = regs->TXDATA;
+			}
+			regs->TXDATA = I2C_TXDATA_EMPTY;
+			if( I2C_byte( bus ) )
+			{
+				I2C_HW( regs->IF ) |= I2C_IF_ACK;
+			}
+			return !bus->stalled;
+		}
+		break;
+	case busRead:
+		if( bus->rxNext || ( cmd & I2C_CMD_ACK ) )
+		{
+			bus->rxNext = false;
+			if( I2C_byte( bus ) )
+			{
+				I2C_HW( regs->RXDATA ) = I2C_tlmByte( bus->tlmId, bus->tlmIndex++ );
+				I2C_HW( regs->IF ) |= I2C_IF_RXDATAV;
+			}
+			return !bus->stalled;
+		}
+		break;
+	default:
+		break;
+	}
+
+	// STOP, after a NACK on the last byte read
+	if( ( cmd & I2C_CMD_STOP ) && bus->state != busIdle )
+	{
+		I2C_charge( I2C_bitNs( regs ), 0 );
+		if( bus->state == busWrite && bus->tcLen > 0 && bus->tlmId < 128 )
+		{
+			I2C_telecommand( bus );
+		}
+		bus->state = busIdle;
+		I2C_HW( regs->IF ) |= I2C_IF_MSTOP;
+		return true;
+	}
+
+	return false;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Resets both channels, the CubeSense model and the statistics.
+ ******************************************************************************/
+void HOST_I2C_Init( void )
+{
+	int i;
+
+	for( i = 0; i < I2C_BUSES; i++ )
+	{
+		memset( buses[i].regs, 0, sizeof( I2C_TypeDef ) );
+		buses[i].regs->TXDATA = I2C_TXDATA_EMPTY;
+		buses[i].state = busIdle;
+		buses[i].stalled = false;
+	}
+	HOST_i2cIrqEnabled = 0;
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+	fault = hostI2cFaultNone;
+	memset( &image, 0, sizeof( image ) );
+	image.faultFrame = -1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Lets both channels progress until they wait for the driver or the bus is
+ * idle, calling the interrupt handler for every enabled flag raised. Called
+ * from the idle hook, so the bus moves while the tasks are blocked.
+ ******************************************************************************/
+void HOST_I2C_run( void )
+{
+	I2C_Bus_TypeDef *bus;
+	I2C_TypeDef *regs;
+	uint32_t mask;
+	int i;
+
+	for( i = 0; i < I2C_BUSES; i++ )
+	{
+		bus = &buses[i];
+		regs = bus->regs;
+		mask = 1UL << ( bus->irq & 0x1F );
+
+		while( I2C_step( bus ) )
+		{
+			// The busy waiting driver runs the same step from its loop
+			HOST_i2cStats.polledNs += I2C_cyclesNs( I2C_POLL_CYCLES );
+
+			if( !( regs->IF & regs->IEN ) || !( HOST_i2cIrqEnabled & mask ) )
+			{
+				break;
+			}
+
+			HOST_i2cStats.interrupts++;
+			HOST_i2cStats.elapsedNs += I2C_cyclesNs( I2C_ISR_CYCLES );
+			HOST_i2cStats.cpuNs += I2C_cyclesNs( I2C_ISR_CYCLES );
+
+			// A task woken by the handler runs once the interrupt has returned
+			taskENTER_CRITICAL();
+			bus->handler();
+
+			// Reading RXDATA clears its flag
+			I2C_HW( regs->IF ) &= ~I2C_IF_RXDATAV;
+
+			// The emlib state machine disables the interrupts when it is done.
+			// I2C_TransferInit then clears every flag before reading them,
+			// which the model would only see on its next step.
+			if( regs->IEN == 0 )
+			{
+				HOST_i2cStats.elapsedNs += I2C_cyclesNs( I2C_WAKE_CYCLES );
+				HOST_i2cStats.cpuNs += I2C_cyclesNs( I2C_WAKE_CYCLES );
+				I2C_HW( regs->IF ) = 0;
+				regs->IFC = 0;
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Injects a fault into the next transfer, on either channel.
+ *
+ * @param[in] f
+ *   Fault to inject.
+ * @param[in] afterBytes
+ *   Bytes of the transfer, address included, that complete before the fault.
+ ******************************************************************************/
+void HOST_I2C_setFault( HOST_I2C_Fault_TypeDef f, uint32_t afterBytes )
+{
+	fault = f;
+	faultAfter = afterBytes;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns a byte of the telemetry buffer the CubeSense model sends for a
+ * telemetry ID.
+ *
+ * @param[in] id
+ *   Telemetry ID written before the read.
+ * @param[in] index
+ *   Byte index in the buffer.
+ * @return
+ *   The byte.
+ ******************************************************************************/
+uint8_t HOST_I2C_tlmByte( uint8_t id, uint32_t index )
+{
+	return ( uint8_t )( id + index * 13 + ( index >> 8 ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns a byte of the image the CubeSense model downloads.
+ *
+ * @param[in] img
+ *   Image selected by the download telecommand.
+ * @param[in] offset
+ *   Byte offset in the image.
+ * @return
+ *   The byte.
+ ******************************************************************************/
+uint8_t HOST_I2C_imageByte( uint8_t img, uint32_t offset )
+{
+	return ( uint8_t )( offset * 7 + ( offset >> 8 ) * 3 + img * 0x55 );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Corrupts a byte of an image frame the next time it is read, without
+ * changing the checksum reported for it.
+ *
+ * @param[in] frame
+ *   Frame to corrupt, or -1 for none.
+ ******************************************************************************/
+void HOST_I2C_setImageFault( int32_t frame )
+{
+	image.faultFrame = frame;
+}
+
+// CMSIS AND EMLIB STAND-INS *************************************************************
+
+void HOST_NVIC_EnableIRQ( IRQn_Type irq )
+{
+	HOST_i2cIrqEnabled |= 1UL << ( irq & 0x1F );
+}
+
+void HOST_NVIC_DisableIRQ( IRQn_Type irq )
+{
+	HOST_i2cIrqEnabled &= ~( 1UL << ( irq & 0x1F ) );
+}
+
+void CMU_ClockEnable( CMU_Clock_TypeDef clock, bool enable )
+{
+}
+
+uint32_t CMU_ClockFreqGet( CMU_Clock_TypeDef clock )
+{
+	return ( uint32_t )I2C_CPU_HZ;
+}
+
+void GPIO_PinModeSet( GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out )
+{
+}
+
+// SLEEP STAND-INS *************************************************************
+
+int32_t HOST_sleepHolds = 0;
+
+void BSP_SLEEP_holdEM1( void )
+{
+	__sync_fetch_and_add( &HOST_sleepHolds, 1 );
+}
+
+void BSP_SLEEP_releaseEM1( void )
+{
+	__sync_fetch_and_sub( &HOST_sleepHolds, 1 );
+}
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file	i2cmodel.h
+ * @brief	Host I2C peripheral model.
+ *
+ * Force-included ahead of bsp_i2c.c and em_i2c.c in the host build of the I2C
+ * driver benchmark. It pulls in the EFM32 peripheral headers and then points
+ * the I2C register blocks and the NVIC functions at host memory, so the driver
+ * and the emlib transfer state machine run unmodified against the bus model in
+ * i2cmodel.c.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __I2CMODEL_H
+#define __I2CMODEL_H
+
+#include "em_device.h"
+#include "em_bitband.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_i2c.h"
+
+extern I2C_TypeDef  HOST_i2c0;
+extern I2C_TypeDef  HOST_i2c1;
+extern uint32_t     HOST_i2cIrqEnabled;
+
+// Register blocks seen by the driver. The device header is include guarded,
+// so these survive its later inclusion by bsp_i2c.h.
+#undef  I2C0
+#undef  I2C1
+#define I2C0		( &HOST_i2c0 )
+#define I2C1		( &HOST_i2c1 )
+
+// The CMSIS NVIC functions are inline and already bound to the core's address.
+#define NVIC_EnableIRQ( irq )				HOST_NVIC_EnableIRQ( irq )
+#define NVIC_DisableIRQ( irq )				HOST_NVIC_DisableIRQ( irq )
+#define NVIC_ClearPendingIRQ( irq )			( ( void )( irq ) )
+#define NVIC_SetPriority( irq, priority )	( ( void )( irq ) )
+
+// Bit-band aliases do not exist on the host; I2C_Init sets register bits directly.
+#define BITBAND_Peripheral( addr, bit, val ) \
+	( *( addr ) = ( *( addr ) & ~( 1UL << ( bit ) ) ) | ( ( uint32_t )( ( val ) & 1 ) << ( bit ) ) )
+
+#define HOST_I2C_CUBESENSE	0x20		///< Address of the CubeSense model on the main channel.
+
+/// Faults the bus model can inject into the next transfer.
+typedef enum
+{
+	hostI2cFaultNone = 0,
+	hostI2cFaultArbLost,				///< The slave holds SDA low: arbitration lost.
+	hostI2cFaultBusErr,					///< A misplaced START or STOP is seen.
+	hostI2cFaultStall					///< The slave holds SCL low and the transfer never completes.
+} HOST_I2C_Fault_TypeDef;
+
+/// Modelled time of the transfers on both channels, for the driver as built
+/// and for the busy waiting driver it replaces.
+typedef struct
+{
+	uint64_t	bytes;			///< Bytes on the bus, addresses included.
+	uint32_t	transfers;		///< Transfers started.
+	uint32_t	interrupts;		///< Interrupts taken.
+	double		busNs;			///< Bus time, START to STOP.
+	double		elapsedNs;		///< Elapsed time with the interrupt driven driver.
+	double		cpuNs;			///< CPU time with the interrupt driven driver.
+	double		polledNs;		///< Elapsed (and CPU) time with busy waiting.
+} HOST_I2C_Stats_TypeDef;
+
+extern HOST_I2C_Stats_TypeDef HOST_i2cStats;
+
+void    HOST_I2C_Init( void );										///< Reset the bus model and its statistics.
+void    HOST_I2C_run( void );										///< Let the bus progress, taking the interrupts it raises.
+void    HOST_I2C_setFault( HOST_I2C_Fault_TypeDef fault, uint32_t afterBytes );	///< Inject a fault into the next transfer.
+uint8_t HOST_I2C_tlmByte( uint8_t id, uint32_t index );				///< Byte of a CubeSense telemetry buffer, as the model sends it.
+uint8_t HOST_I2C_imageByte( uint8_t image, uint32_t offset );		///< Byte of the image the CubeSense model downloads.
+void    HOST_I2C_setImageFault( int32_t frame );					///< Corrupt an image frame the next time it is read.
+void    HOST_NVIC_EnableIRQ( IRQn_Type irq );						///< Enable an interrupt of the model.
+void    HOST_NVIC_DisableIRQ( IRQn_Type irq );						///< Disable an interrupt of the model.
+
+/// EM1 holds the driver has taken and not released. The host never sleeps,
+/// so they are only counted, to check that they balance.
+extern int32_t HOST_sleepHolds;
+
+#endif // __I2CMODEL_H
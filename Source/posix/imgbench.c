@@ -0,0 +1,370 @@
+/***************************************************************************//**
+ * @file	imgbench.c
+ * @brief	Host benchmark of the CubeSense image download.
+ *
+ * Runs the image download task of fsw_imagedl.c with the bus scheduler, the
+ * I2C master driver and FatFs on the host disk image, against the CubeSense
+ * model in i2cmodel.c serving a test image. A full nadir image is downloaded
+ * with one frame corrupted on the bus, which must be read again, and a
+ * quarter size sun image is aborted partway and resumed. Both files are read
+ * back and checked against the test image.
+ *
+ * The frames per second and download times are reported from the modelled
+ * I2C time, in which the card writes are hidden behind the frames on the bus,
+ * and from the host ticks counted by the task.
+ *
+ * Usage: fsw_imgbench [-c frame] [-a frames]
+ *   -c  nadir image frame corrupted on the bus (default 1000)
+ *   -a  sun image frames stored before the download is aborted (default 200)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ff.h"
+#include "bsp_i2c.h"
+#include "fsw_i2cbus.h"
+#include "fsw_imagedl.h"
+#include "i2cmodel.h"
+#include "host.h"
+
+#define IMGBENCH_DISK_MB	16			///< RAM image size.
+#define IMGBENCH_POLL_MS	10			///< Interval of the download state polls.
+
+static int32_t  corruptFrame = 1000;
+static uint32_t abortFrames = 200;
+static int      benchResult = 1;
+static uint8_t  readBuff[FSW_IMG_BLOCKLEN];
+
+static xQueueHandle benchI2Cqueue;		///< Served by the scheduler task, as FSW_COMM_I2Cqueue on the target.
+
+// FUNCTIONS *******************************************************************
+
+static uint64_t IMGBENCH_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Waits for the download to leave the running state.
+ */
+static void IMGBENCH_wait( FSW_IMG_Stats_TypeDef *stats )
+{
+	do
+	{
+		vTaskDelay( IMGBENCH_POLL_MS / portTICK_RATE_MS );
+		FSW_IMG_getStats( stats );
+	} while( stats->state == FSW_IMG_RUNNING );
+}
+
+/*
+ * Reads the image file back and checks its size and contents.
+ */
+static int IMGBENCH_check( uint8_t image, uint32_t bytes )
+{
+	static FIL fil;
+	FRESULT res;
+	DWORD offset;
+	UINT i, br;
+	int result = 0;
+
+	res = f_open( &fil, FSW_IMG_PATH, FA_READ | FA_OPEN_EXISTING );
+	if( res != FR_OK )
+	{
+		printf( "open %s failed (%d)\n", FSW_IMG_PATH, ( int )res );
+		return 1;
+	}
+	if( f_size( &fil ) != bytes )
+	{
+		printf( "image file of %lu bytes, expected %lu\n", ( unsigned long )f_size( &fil ), ( unsigned long )bytes );
+		result = 1;
+	}
+
+	for( offset = 0; result == 0 && offset < bytes; offset += br )
+	{
+		res = f_read( &fil, readBuff, sizeof( readBuff ), &br );
+		if( res != FR_OK || br == 0 )
+		{
+			printf( "read at %lu failed (%d)\n", ( unsigned long )offset, ( int )res );
+			result = 1;
+			break;
+		}
+		for( i = 0; i < br; i++ )
+		{
+			if( readBuff[i] != HOST_I2C_imageByte( image, offset + i ) )
+			{
+				printf( "bad image byte at %lu\n", ( unsigned long )( offset + i ) );
+				result = 1;
+				break;
+			}
+		}
+	}
+
+	f_close( &fil );
+	return result;
+}
+
+/*
+ * Reports a finished download run, with the modelled I2C time since the
+ * model's statistics were cleared.
+ */
+static void IMGBENCH_report( const char *name, const FSW_IMG_Stats_TypeDef *stats, uint64_t wallNs )
+{
+	double i2cMs = HOST_i2cStats.elapsedNs * 1e-6;
+
+	printf( "%-12s %6lu %6lu %7u %10.3f %10.1f %9.1f %9lu %8lu\n", name,
+			( unsigned long )stats->framesRead, ( unsigned long )stats->nextFrame,
+			stats->checksumErrors + stats->i2cErrors,
+			stats->framesRead ? i2cMs / stats->framesRead : 0.0,
+			i2cMs > 0 ? stats->framesRead * 1e3 / i2cMs : 0.0, i2cMs,
+			( unsigned long )( stats->totalTicks * portTICK_RATE_MS ), ( unsigned long )( wallNs / 1000000 ) );
+}
+
+/*
+ * Downloads the full nadir image with a corrupted frame.
+ */
+static int IMGBENCH_full( void )
+{
+	FSW_IMG_Stats_TypeDef stats;
+	uint64_t start;
+	int result;
+
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+	HOST_I2C_setImageFault( corruptFrame );
+
+	start = IMGBENCH_now();
+	if( !FSW_IMG_start( FSW_IMG_NADIR, 0 ) )
+	{
+		printf( "nadir download not started\n" );
+		return 1;
+	}
+	IMGBENCH_wait( &stats );
+	IMGBENCH_report( "nadir 640x480", &stats, IMGBENCH_now() - start );
+
+	result = !( stats.state == FSW_IMG_DONE && stats.frames == 2400 && stats.nextFrame == stats.frames &&
+				stats.framesRead == stats.frames && stats.checksumErrors == ( corruptFrame < 2400 ? 1 : 0 ) &&
+				stats.i2cErrors == 0 );
+	if( result )
+	{
+		printf( "nadir download state %u, error %d FAILED\n", stats.state, stats.lastError );
+	}
+
+	return result | IMGBENCH_check( FSW_IMG_NADIR, 640 * 480 );
+}
+
+/*
+ * Downloads the quarter size sun image, aborting it partway and resuming it.
+ */
+static int IMGBENCH_resume( void )
+{
+	FSW_IMG_Stats_TypeDef stats;
+	uint32_t stored, frames;
+	uint64_t start;
+	int result;
+
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+
+	start = IMGBENCH_now();
+	if( !FSW_IMG_start( FSW_IMG_SUN, 1 ) )
+	{
+		printf( "sun download not started\n" );
+		return 1;
+	}
+	do
+	{
+		vTaskDelay( 1 );
+		FSW_IMG_getStats( &stats );
+	} while( stats.state == FSW_IMG_RUNNING && stats.nextFrame < abortFrames );
+	FSW_IMG_abort();
+	IMGBENCH_wait( &stats );
+	IMGBENCH_report( "sun aborted", &stats, IMGBENCH_now() - start );
+
+	stored = stats.nextFrame;
+	frames = stats.frames;
+	if( stats.state != FSW_IMG_ABORTED || stored == 0 || stored >= frames || stored % FSW_IMG_BLOCKFRAMES != 0 )
+	{
+		printf( "sun download state %u after abort at %lu of %lu frames FAILED\n",
+				stats.state, ( unsigned long )stored, ( unsigned long )frames );
+		return 1;
+	}
+
+	// Continues from the last frame recorded, which is at most FSW_IMG_SYNC_BLOCKS buffers back
+	memset( &HOST_i2cStats, 0, sizeof( HOST_i2cStats ) );
+	start = IMGBENCH_now();
+	if( !FSW_IMG_resume() )
+	{
+		printf( "sun download not resumed\n" );
+		return 1;
+	}
+	IMGBENCH_wait( &stats );
+	IMGBENCH_report( "sun resumed", &stats, IMGBENCH_now() - start );
+
+	result = !( stats.state == FSW_IMG_DONE && stats.nextFrame == frames && stats.resumes == 1 &&
+				stats.framesRead == frames - stored && stats.totalTicks >= stats.runTicks );
+	if( result )
+	{
+		printf( "sun download state %u, error %d, %lu frames read after resume FAILED\n",
+				stats.state, stats.lastError, ( unsigned long )stats.framesRead );
+	}
+
+	return result | IMGBENCH_check( FSW_IMG_SUN, 320 * 240 );
+}
+
+// TASKS ***********************************************************************
+
+static void IMGBENCH_task( void *pvParameters )
+{
+	BSP_I2C_Init( BSP_I2C_SYS, true );
+
+	printf( "CubeSense image download, %u byte frames in %u byte buffers (I2C modelled)\n",
+			FSW_IMG_FRAMELEN, FSW_IMG_BLOCKLEN );
+	printf( "download     frames stored retries I2C ms/frame   frames/s    I2C ms  total ms  wall ms\n" );
+
+	benchResult = IMGBENCH_full();
+	benchResult |= IMGBENCH_resume();
+	printf( "CubeSense image download %s\n", benchResult ? "FAILED" : "ok" );
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+// Runs the bus scheduler, as FSW_I2C_manager does on the target
+static void IMGBENCH_manager( void *pvParameters )
+{
+	FSW_I2CBUS_Init( FSW_I2CBUS_BATCH );
+	for( ;; )
+	{
+		FSW_I2CBUS_service( benchI2Cqueue, portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "c:a:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'c':	corruptFrame = strtol( optarg, NULL, 0 );	break;
+		case 'a':	abortFrames = strtoul( optarg, NULL, 0 );	break;
+		default:
+			fprintf( stderr, "usage: %s [-c frame] [-a frames]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( abortFrames == 0 || abortFrames >= 600 )
+	{
+		fprintf( stderr, "the sun image is aborted after 1 to 599 frames\n" );
+		return 2;
+	}
+
+	if( HOST_DISK_Init( NULL, IMGBENCH_DISK_MB ) != 0 )
+	{
+		fprintf( stderr, "could not create disk image\n" );
+		return 1;
+	}
+	HOST_I2C_Init();
+
+	benchI2Cqueue = xQueueCreate( 6, sizeof( COMM_I2Cmsg_TypeDef ) );
+	FSW_IMG_Init( benchI2Cqueue );
+
+	xTaskCreate( IMGBENCH_task, ( const signed char * )"IMGBENCH", 1024, NULL, 2, NULL );
+	xTaskCreate( IMGBENCH_manager, ( const signed char * )"I2CMGR", 1024, NULL, 1, NULL );
+	vTaskStartScheduler();
+
+	HOST_DISK_Close();
+
+	return benchResult;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Interrupt handler of the main channel. On the target it is in comms.c,
+ *   which also runs the slave mode state machine.
+ ******************************************************************************/
+void I2C0_IRQHandler( void )
+{
+	BSP_I2C_masterIRQHandler( BSP_I2C_SYS );
+}
+
+/**********************************************************************************
+ * Stand-ins for the flight software
+ *********************************************************************************/
+
+time_t getOBC_time( void )
+{
+	return 1792152000;
+}
+
+DWORD get_fattime( void )
+{
+	return ( 28 << 25 ) | ( 2 << 21 ) | ( 1 << 16 );
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf( stderr, "stack overflow in task %s\n", pcTaskName );
+	abort();
+}
+
+// The bus moves while the tasks are blocked
+void vApplicationIdleHook( void )
+{
+	HOST_I2C_run();
+	vPortWaitForTick();
+}
+
+// The host FreeRTOSConfig.h traces queues for the dispatch benchmark
+void vHostTraceQueueSend( void *pxQueue )
+{
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+}
@@ -0,0 +1,517 @@
+/***************************************************************************//**
+ * @file	linkbench.c
+ * @brief	Link protocol round-trip and fuzz test and benchmark for the host build.
+ *
+ * LINKBENCH_roundTrip() encodes random frames, biased towards the zero and
+ * 0xFF bytes COBS treats specially, and decodes them a byte at a time, alone,
+ * back to back and ended without their delimiter: each must come back as it
+ * was sent.
+ *
+ * LINKBENCH_fuzz() corrupts half of a stream of frames by flipping bits,
+ * inserting, deleting and truncating. Every frame left intact must still be
+ * received, the corrupted ones must be dropped, and the few a CRC-16 cannot
+ * tell from a good frame are counted against the 1 in 65536 expected.
+ *
+ * LINKBENCH_queue() passes frames from a producer thread to a consumer thread
+ * through a small FSW_LINK_Queue_TypeDef, both running flat out, and checks
+ * none is lost, repeated, reordered or torn.
+ *
+ * LINKBENCH_rate() times the encoder and the receiver in frames per second.
+ *
+ * Usage: fsw_linkbench [-n iterations] [-s seed]
+ *   -n  frames of the round-trip and fuzz tests (default 200000)
+ *   -s  seed of the random frames (default 1)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "fsw_link.h"
+
+#define LINKBENCH_ITERATIONS	200000		///< Default frames of the round-trip and fuzz tests.
+#define LINKBENCH_QUEUEFRAMES	1000000		///< Frames passed between the queue test's threads.
+#define LINKBENCH_QUEUELEN		16			///< Slots of the queue test, as deep as the telecommand queues.
+#define LINKBENCH_RATEFRAMES	1000000		///< Frames timed per payload length.
+#define LINKBENCH_STREAMLEN		64			///< Frames of a fuzzed stream.
+
+static uint32_t linkbenchIterations = LINKBENCH_ITERATIONS;
+static uint32_t linkbenchSeed = 1;
+
+static FSW_LINK_Frame_TypeDef queueSlots[LINKBENCH_QUEUELEN];
+static FSW_LINK_Queue_TypeDef queue;
+
+// FUNCTIONS *******************************************************************
+
+static uint64_t LINKBENCH_now( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t LINKBENCH_random( void )
+{
+	linkbenchSeed ^= linkbenchSeed << 13;
+	linkbenchSeed ^= linkbenchSeed >> 17;
+	linkbenchSeed ^= linkbenchSeed << 5;
+
+	return linkbenchSeed;
+}
+
+/*
+ * Fills a random frame; a quarter of its payload bytes are zero and a quarter
+ * 0xFF, and some payloads are all one or the other.
+ */
+static void LINKBENCH_randomFrame( FSW_LINK_Frame_TypeDef *frame )
+{
+	uint32_t kind = LINKBENCH_random() % 16;
+	uint32_t r;
+	uint8_t i;
+
+	frame->id = ( uint8_t )LINKBENCH_random();
+	frame->seq = ( uint8_t )LINKBENCH_random();
+	frame->len = ( uint8_t )( LINKBENCH_random() % ( FSW_LINK_MAXPAYLOAD + 1 ) );
+
+	for( i = 0; i < frame->len; i++ )
+	{
+		r = LINKBENCH_random();
+		switch( kind == 0 ? 0 : kind == 1 ? 1 : r % 4 )
+		{
+		case 0:		frame->payload[i] = 0x00;					break;
+		case 1:		frame->payload[i] = 0xFF;					break;
+		default:	frame->payload[i] = ( uint8_t )( r >> 8 );	break;
+		}
+	}
+}
+
+static int LINKBENCH_same( const FSW_LINK_Frame_TypeDef *a, const FSW_LINK_Frame_TypeDef *b )
+{
+	return a->id == b->id && a->seq == b->seq && a->len == b->len && memcmp( a->payload, b->payload, a->len ) == 0;
+}
+
+/*
+ * Encodes random frames and checks each decodes back to itself, alone, as
+ * part of a stream, and ended by FSW_LINK_rxEnd instead of its delimiter.
+ */
+static int LINKBENCH_roundTrip( void )
+{
+	FSW_LINK_Frame_TypeDef sent;
+	FSW_LINK_Decoder_TypeDef dec;
+	FSW_LINK_RxStatus_TypeDef status;
+	uint8_t encoded[FSW_LINK_FRAMEMAX];
+	uint64_t bytes = 0, payload = 0;
+	uint32_t n;
+	uint16_t len, i;
+	int noDelimiter;
+
+	FSW_LINK_rxInit( &dec );
+
+	for( n = 0; n < linkbenchIterations; n++ )
+	{
+		LINKBENCH_randomFrame( &sent );
+		len = FSW_LINK_encode( encoded, sent.id, sent.seq, sent.payload, sent.len );
+		if( len == 0 || len > FSW_LINK_FRAMEMAX || encoded[len - 1] != FSW_LINK_DELIMITER ||
+			memchr( encoded, FSW_LINK_DELIMITER, len - 1 ) != NULL )
+		{
+			printf( "frame %lu: encoded badly, %u bytes\n", ( unsigned long )n, len );
+			return 1;
+		}
+		bytes += len;
+		payload += sent.len;
+
+		// Every eighth frame is ended as an idle line or STOP would end it
+		noDelimiter = ( n % 8 == 7 );
+		for( i = 0; i < len - noDelimiter; i++ )
+		{
+			status = FSW_LINK_rxByte( &dec, encoded[i] );
+			if( i < len - 1 && status != linkRxNone )
+			{
+				printf( "frame %lu: ended at byte %u of %u\n", ( unsigned long )n, i, len );
+				return 1;
+			}
+		}
+		if( noDelimiter )
+		{
+			status = FSW_LINK_rxEnd( &dec );
+		}
+		if( status != linkRxFrame || !LINKBENCH_same( &dec.frame, &sent ) )
+		{
+			printf( "frame %lu: %u byte payload came back %s\n", ( unsigned long )n, sent.len,
+					status == linkRxFrame ? "different" : "dropped" );
+			return 1;
+		}
+		if( FSW_LINK_rxEnd( &dec ) != linkRxNone || FSW_LINK_rxByte( &dec, FSW_LINK_DELIMITER ) != linkRxNone )
+		{
+			printf( "frame %lu: delimiters after it taken as a frame\n", ( unsigned long )n );
+			return 1;
+		}
+	}
+
+	if( dec.stats.frames != linkbenchIterations || dec.stats.crcErrors != 0 || dec.stats.formatErrors != 0 )
+	{
+		printf( "round trip: counters wrong\n" );
+		return 1;
+	}
+
+	// A payload too long for a frame is refused
+	if( FSW_LINK_encode( encoded, 0, 0, sent.payload, FSW_LINK_MAXPAYLOAD + 1 ) != 0 && FSW_LINK_MAXPAYLOAD < 255 )
+	{
+		printf( "round trip: oversized payload encoded\n" );
+		return 1;
+	}
+
+	printf( "round trip: %lu frames, %.2f bytes per frame, %.1f %% over the payload and header, ok\n",
+			( unsigned long )linkbenchIterations, ( double )bytes / linkbenchIterations,
+			100.0 * ( bytes - payload - ( double )linkbenchIterations * FSW_LINK_HEADERLEN ) /
+			( payload + ( double )linkbenchIterations * FSW_LINK_HEADERLEN ) );
+
+	return 0;
+}
+
+/*
+ * Corrupts one encoded frame in place, leaving its delimiter. Returns its new
+ * length.
+ */
+static uint16_t LINKBENCH_corrupt( uint8_t *frame, uint16_t len )
+{
+	uint16_t pos = LINKBENCH_random() % ( len - 1 );
+	uint8_t bit;
+
+	switch( LINKBENCH_random() % 4 )
+	{
+	case 0:		// Flip a bit, possibly making a zero that splits the frame
+		bit = 1 << ( LINKBENCH_random() % 8 );
+		frame[pos] ^= bit;
+		break;
+	case 1:		// Insert a byte
+		memmove( &frame[pos + 1], &frame[pos], len - pos );
+		frame[pos] = ( uint8_t )LINKBENCH_random();
+		len++;
+		break;
+	case 2:		// Delete a byte
+		if( len > 2 )
+		{
+			memmove( &frame[pos], &frame[pos + 1], len - pos - 1 );
+			len--;
+		}
+		else
+		{
+			frame[0] ^= 0x80;
+		}
+		break;
+	default:	// Truncate
+		frame[pos] = FSW_LINK_DELIMITER;
+		len = pos + 1;
+		break;
+	}
+
+	return len;
+}
+
+/*
+ * Sends streams of frames with half of them corrupted through a receiver, and
+ * checks what it accepts.
+ */
+static int LINKBENCH_fuzz( void )
+{
+	FSW_LINK_Frame_TypeDef sent[LINKBENCH_STREAMLEN];
+	uint8_t corrupted[LINKBENCH_STREAMLEN];
+	uint8_t stream[LINKBENCH_STREAMLEN * ( FSW_LINK_FRAMEMAX + 1 )];
+	uint16_t start[LINKBENCH_STREAMLEN + 1];
+	FSW_LINK_Decoder_TypeDef dec;
+	FSW_LINK_RxStatus_TypeDef status;
+	uint32_t streams, pos, received, frame, i;
+	uint32_t intact = 0, bad = 0, undetected = 0, lost = 0, crcErrors = 0, formatErrors = 0;
+	double expected;
+
+	FSW_LINK_rxInit( &dec );
+
+	for( streams = 0; streams < linkbenchIterations / LINKBENCH_STREAMLEN; streams++ )
+	{
+		pos = 0;
+		for( i = 0; i < LINKBENCH_STREAMLEN; i++ )
+		{
+			LINKBENCH_randomFrame( &sent[i] );
+			start[i] = pos;
+			pos += FSW_LINK_encode( &stream[pos], sent[i].id, sent[i].seq, sent[i].payload, sent[i].len );
+			corrupted[i] = LINKBENCH_random() % 2;
+			if( corrupted[i] )
+			{
+				pos = start[i] + LINKBENCH_corrupt( &stream[start[i]], pos - start[i] );
+				bad++;
+			}
+			else
+			{
+				intact++;
+			}
+		}
+		start[LINKBENCH_STREAMLEN] = pos;
+
+		// Each frame accepted is matched to the frame whose bytes ended it
+		received = 0;
+		frame = 0;
+		for( i = 0; i < pos; i++ )
+		{
+			while( i >= start[frame + 1] )
+			{
+				frame++;
+			}
+			status = FSW_LINK_rxByte( &dec, stream[i] );
+			if( status == linkRxFrame )
+			{
+				if( !corrupted[frame] && i == start[frame + 1] - 1 && LINKBENCH_same( &dec.frame, &sent[frame] ) )
+				{
+					received++;
+				}
+				else if( !corrupted[frame] )
+				{
+					printf( "stream %lu: intact frame %lu received wrong\n", ( unsigned long )streams, ( unsigned long )frame );
+					return 1;
+				}
+				else
+				{
+					undetected++;
+				}
+			}
+			else if( status != linkRxNone )
+			{
+				crcErrors += ( status == linkRxErrCrc );
+				formatErrors += ( status == linkRxErrFormat );
+				lost += !corrupted[frame];
+			}
+		}
+		for( i = 0; i < LINKBENCH_STREAMLEN; i++ )
+		{
+			received += corrupted[i];
+		}
+		if( received != LINKBENCH_STREAMLEN || lost != 0 )
+		{
+			printf( "stream %lu: intact frames lost\n", ( unsigned long )streams );
+			return 1;
+		}
+	}
+
+	// A CRC-16 passes one random frame in 65536; allow four times that, and one
+	expected = bad / 65536.0;
+	printf( "fuzz: %lu intact frames all received, %lu corrupted: %lu CRC and %lu format errors, %lu undetected (%.2f expected) %s\n",
+			( unsigned long )intact, ( unsigned long )bad, ( unsigned long )crcErrors, ( unsigned long )formatErrors,
+			( unsigned long )undetected, expected, undetected <= 4 * expected + 1 ? "ok" : "FAILED" );
+
+	return undetected > 4 * expected + 1;
+}
+
+static void *LINKBENCH_producer( void *arg )
+{
+	FSW_LINK_Frame_TypeDef frame;
+	uint32_t n;
+
+	for( n = 0; n < LINKBENCH_QUEUEFRAMES; n++ )
+	{
+		frame.id = ( uint8_t )( n >> 8 );
+		frame.seq = ( uint8_t )n;
+		frame.len = 4 + n % ( FSW_LINK_MAXPAYLOAD - 3 );
+		memset( frame.payload, ( uint8_t )n, frame.len );
+		memcpy( frame.payload, &n, 4 );
+
+		// Yield when full, so the test also runs on a single core
+		while( !FSW_LINK_queuePush( &queue, &frame ) )
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Passes frames from a producer thread to this one through the queue.
+ */
+static int LINKBENCH_queue( void )
+{
+	pthread_t producer;
+	FSW_LINK_Frame_TypeDef *frame;
+	uint64_t start, ns;
+	uint32_t n, got, i;
+	int result = 0;
+
+	FSW_LINK_queueInit( &queue, queueSlots, LINKBENCH_QUEUELEN );
+
+	start = LINKBENCH_now();
+	pthread_create( &producer, NULL, LINKBENCH_producer, NULL );
+
+	for( n = 0; n < LINKBENCH_QUEUEFRAMES && result == 0; n++ )
+	{
+		while( ( frame = FSW_LINK_queuePeek( &queue ) ) == NULL )
+		{
+			sched_yield();
+		}
+
+		memcpy( &got, frame->payload, 4 );
+		if( got != n || frame->id != ( uint8_t )( n >> 8 ) || frame->seq != ( uint8_t )n || frame->len != 4 + n % ( FSW_LINK_MAXPAYLOAD - 3 ) )
+		{
+			printf( "queue: frame %lu arrived as %lu\n", ( unsigned long )n, ( unsigned long )got );
+			result = 1;
+		}
+		for( i = 4; i < frame->len && result == 0; i++ )
+		{
+			if( frame->payload[i] != ( uint8_t )n )
+			{
+				printf( "queue: frame %lu torn\n", ( unsigned long )n );
+				result = 1;
+			}
+		}
+
+		FSW_LINK_queuePop( &queue );
+	}
+
+	if( result != 0 )
+	{
+		// Let the producer finish
+		while( n++ < LINKBENCH_QUEUEFRAMES )
+		{
+			while( FSW_LINK_queuePeek( &queue ) == NULL )
+			{
+				sched_yield();
+			}
+			FSW_LINK_queuePop( &queue );
+		}
+	}
+	pthread_join( producer, NULL );
+	ns = LINKBENCH_now() - start;
+
+	printf( "queue: %lu frames between two threads through %u slots, %.1f Mframes/s, producer found it full %lu times, %s\n",
+			( unsigned long )LINKBENCH_QUEUEFRAMES, LINKBENCH_QUEUELEN, LINKBENCH_QUEUEFRAMES * 1e3 / ns,
+			( unsigned long )queue.dropped, result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Times the encoder and the receiver for a few payload lengths.
+ */
+static void LINKBENCH_rate( void )
+{
+	static const uint8_t lengths[] = { 0, 8, 28, FSW_LINK_MAXPAYLOAD };
+	static uint8_t encoded[256][FSW_LINK_FRAMEMAX];
+	static uint16_t encodedLen[256];
+	FSW_LINK_Frame_TypeDef frame;
+	FSW_LINK_Decoder_TypeDef dec;
+	uint64_t start, encodeNs, decodeNs, bytes;
+	uint32_t n, frames, sink = 0;
+	uint16_t i;
+	unsigned int l;
+
+	printf( "\n payload   frame   encode frames/s   receive frames/s   receive MB/s\n" );
+
+	for( l = 0; l < sizeof( lengths ); l++ )
+	{
+		for( n = 0; n < 256; n++ )
+		{
+			LINKBENCH_randomFrame( &frame );
+			frame.len = lengths[l];
+			encodedLen[n] = FSW_LINK_encode( encoded[n], frame.id, frame.seq, frame.payload, frame.len );
+		}
+
+		start = LINKBENCH_now();
+		for( n = 0; n < LINKBENCH_RATEFRAMES; n++ )
+		{
+			sink += FSW_LINK_encode( encoded[n & 255], ( uint8_t )n, ( uint8_t )n, frame.payload, frame.len );
+		}
+		encodeNs = LINKBENCH_now() - start;
+
+		FSW_LINK_rxInit( &dec );
+		bytes = 0;
+		start = LINKBENCH_now();
+		for( n = 0; n < LINKBENCH_RATEFRAMES; n++ )
+		{
+			for( i = 0; i < encodedLen[n & 255]; i++ )
+			{
+				FSW_LINK_rxByte( &dec, encoded[n & 255][i] );
+			}
+			bytes += encodedLen[n & 255];
+		}
+		decodeNs = LINKBENCH_now() - start;
+		frames = dec.stats.frames;
+
+		printf( "%8u %7u %18.0f %18.0f %14.1f%s\n", lengths[l], encodedLen[0],
+				LINKBENCH_RATEFRAMES * 1e9 / encodeNs, frames * 1e9 / decodeNs, bytes * 1e3 / decodeNs,
+				frames == LINKBENCH_RATEFRAMES ? "" : " (frames lost)" );
+	}
+
+	if( sink == 1 )
+	{
+		printf( "\n" );
+	}
+}
+
+// MAIN ************************************************************************
+
+int main( int argc, char **argv )
+{
+	int opt, result;
+
+	while( ( opt = getopt( argc, argv, "n:s:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'n':	linkbenchIterations = strtoul( optarg, NULL, 0 );	break;
+		case 's':	linkbenchSeed = strtoul( optarg, NULL, 0 );			break;
+		default:
+			fprintf( stderr, "usage: %s [-n iterations] [-s seed]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( linkbenchIterations < LINKBENCH_STREAMLEN || linkbenchSeed == 0 )
+	{
+		fprintf( stderr, "iterations below %u or seed 0\n", LINKBENCH_STREAMLEN );
+		return 2;
+	}
+
+	printf( "Link protocol, payloads of up to %u bytes\n", FSW_LINK_MAXPAYLOAD );
+
+	result = LINKBENCH_roundTrip();
+	if( result == 0 )
+	{
+		result = LINKBENCH_fuzz();
+	}
+	if( result == 0 )
+	{
+		result = LINKBENCH_queue();
+	}
+	if( result == 0 )
+	{
+		LINKBENCH_rate();
+	}
+
+	printf( "Link protocol %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
@@ -0,0 +1,295 @@
+/***************************************************************************//**
+ * @file	logdecode.c
+ * @brief	Host decoder for the binary log files.
+ *
+ * Prints the records of ring log files copied off the SD card or downlinked,
+ * oldest first, as text in the layout of the old text logs or as CSV. Each
+ * sector of a ring starts with a header carrying its sequence number; the
+ * sectors are put in order by it and their records printed up to the first
+ * erased slot. Erased sectors are skipped. Headers and records whose CRC does
+ * not match are reported and skipped. Given the log control block file, the
+ * ring states held by each of its copies are printed instead.
+ *
+ * Usage: fsw_logdecode [-c] file...
+ *   -c  print CSV instead of text
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fsw_logformat.h"
+
+#define LOGDEC_SECTOR		512			///< Size of a log sector.
+
+/// Names of the log types, indexed by LOG_CMD, LOG_WOD and LOG_ERROR.
+static const char *typeNames[] = { "?", "CMD", "WOD", "ERROR" };
+
+/// Names of the modules, indexed by the FSW_ destination macros in fsw_cdh.h.
+static const char *sourceNames[] = { "?", "ADCS", "CDH", "COMM", "FS", "HANDH", "MODES", "PAYLOAD", "POWER" };
+
+#define NAME( names, i )	( ( i ) < sizeof( names ) / sizeof( names[0] ) ? names[i] : "?" )
+
+/// A sector of a ring with an intact header.
+typedef struct
+{
+	unsigned long	offset;
+	uint32_t		seq;
+} Sector_TypeDef;
+
+static int compareSectors( const void *a, const void *b )
+{
+	uint32_t x = ( ( const Sector_TypeDef* )a )->seq;
+	uint32_t y = ( ( const Sector_TypeDef* )b )->seq;
+
+	return ( x > y ) - ( x < y );
+}
+
+static int isErased( const uint8_t *data, size_t len )
+{
+	size_t i;
+
+	for( i = 0; i < len; i++ )
+	{
+		if( data[i] != 0xFF )
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Prints the copies of a log control block file. Returns the number of bad
+ * copies found.
+ */
+static unsigned decodeControlBlock( const char *path, FILE *file, int csv )
+{
+	FS_LogControlBlock_TypeDef cb;
+	unsigned long offset;
+	unsigned bad = 0;
+	unsigned i;
+
+	for( offset = 0; fseek( file, ( long )offset, SEEK_SET ) == 0 && fread( &cb, sizeof( cb ), 1, file ) == 1;
+			offset += LOGDEC_SECTOR )
+	{
+		if( !FSW_LOGFMT_checkControlBlock( &cb ) )
+		{
+			fprintf( stderr, "%s: bad control block copy at offset %lu\n", path, offset );
+			bad++;
+			continue;
+		}
+
+		if( csv )
+		{
+			continue;
+		}
+
+		printf( "# %s: control block copy at offset %lu, generation %lu\n", path, offset, ( unsigned long )cb.generation );
+		for( i = 0; i < FS_LOG_RINGS; i++ )
+		{
+			printf( "%-6s sectors %u head %u tail %u seq %lu\n", NAME( typeNames, i + 1 ), ( unsigned )cb.ring[i].sectors,
+					( unsigned )cb.ring[i].head, ( unsigned )cb.ring[i].tail, ( unsigned long )cb.ring[i].seq );
+		}
+	}
+
+	return bad;
+}
+
+/*
+ * Decodes one log file. Returns the number of bad headers and records found.
+ */
+static unsigned decodeFile( const char *path, int csv )
+{
+	FILE *file;
+	FS_LogHeader_TypeDef header;
+	FS_LogRecord_TypeDef record;
+	Sector_TypeDef *sectors = NULL;
+	uint8_t data[LOGDEC_SECTOR];
+	unsigned long offset, count = 0, records = 0;
+	unsigned bad = 0;
+	uint32_t magic;
+	size_t n, pos;
+	char date[20];
+	time_t time;
+
+	file = fopen( path, "rb" );
+	if( file == NULL )
+	{
+		perror( path );
+		return 1;
+	}
+
+	if( fread( &magic, sizeof( magic ), 1, file ) == 1 && magic == FS_LOGCB_MAGIC )
+	{
+		bad = decodeControlBlock( path, file, csv );
+		fclose( file );
+		return bad;
+	}
+
+	// Find the sectors with intact headers
+	rewind( file );
+	for( offset = 0; ( n = fread( data, 1, LOGDEC_SECTOR, file ) ) != 0; offset += n )
+	{
+		if( n != LOGDEC_SECTOR )
+		{
+			fprintf( stderr, "%s: %u trailing bytes at offset %lu\n", path, ( unsigned )n, offset );
+			bad++;
+			break;
+		}
+
+		memcpy( &header, data, sizeof( header ) );
+		if( !FSW_LOGFMT_checkHeader( &header ) )
+		{
+			if( !isErased( data, sizeof( header ) ) )
+			{
+				fprintf( stderr, "%s: bad sector header at offset %lu\n", path, offset );
+				bad++;
+			}
+			continue;
+		}
+
+		sectors = realloc( sectors, ( count + 1 ) * sizeof( Sector_TypeDef ) );
+		if( sectors == NULL )
+		{
+			perror( path );
+			fclose( file );
+			return bad + 1;
+		}
+		sectors[count].offset = offset;
+		sectors[count].seq = header.seq;
+		count++;
+	}
+
+	if( count == 0 )
+	{
+		fprintf( stderr, "%s: not a version %u log file\n", path, FS_LOG_VERSION );
+		fclose( file );
+		return bad + 1;
+	}
+
+	qsort( sectors, count, sizeof( Sector_TypeDef ), compareSectors );
+
+	for( offset = 0; offset < count; offset++ )
+	{
+		fseek( file, ( long )sectors[offset].offset, SEEK_SET );
+		if( fread( data, LOGDEC_SECTOR, 1, file ) != 1 )
+		{
+			bad++;
+			break;
+		}
+		memcpy( &header, data, sizeof( header ) );
+
+		if( !csv && offset == 0 )
+		{
+			time = header.created;
+			strftime( date, sizeof( date ), "%Y-%m-%d %H:%M:%S", gmtime( &time ) );
+			printf( "# %s: %s log, oldest sector %lu started %s\n", path, NAME( typeNames, header.type ),
+					( unsigned long )header.seq, date );
+		}
+
+		for( pos = sizeof( header ); pos + sizeof( record ) <= LOGDEC_SECTOR; pos += sizeof( record ) )
+		{
+			if( isErased( &data[pos], sizeof( record ) ) )
+			{
+				break;
+			}
+			memcpy( &record, &data[pos], sizeof( record ) );
+
+			if( !FSW_LOGFMT_checkRecord( &record ) )
+			{
+				fprintf( stderr, "%s: bad CRC at offset %lu\n", path, sectors[offset].offset + ( unsigned long )pos );
+				bad++;
+				if( !csv )
+				{
+					continue;
+				}
+			}
+
+			time = record.exe_time;
+			strftime( date, sizeof( date ), "%Y-%m-%d %H:%M:%S", gmtime( &time ) );
+			records++;
+
+			if( csv )
+			{
+				printf( "%s,%lu,%s,%s,%u,%s,%lu,%s\n", path, sectors[offset].offset + ( unsigned long )pos,
+						NAME( typeNames, header.type ), NAME( sourceNames, record.source ), ( unsigned )record.id, date,
+						( unsigned long )record.exe_time, FSW_LOGFMT_checkRecord( &record ) ? "ok" : "bad" );
+			}
+			else
+			{
+				printf( "%-6s Source: %-8s %u\t%s\n", NAME( typeNames, header.type ), NAME( sourceNames, record.source ),
+						( unsigned )record.id, date );
+			}
+		}
+	}
+
+	if( !csv )
+	{
+		printf( "# %s: %lu records in %lu sectors\n", path, records, count );
+	}
+
+	free( sectors );
+	fclose( file );
+	return bad;
+}
+int main( int argc, char *argv[] )
+{
+	unsigned bad = 0;
+	int csv = 0;
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "c" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'c':	csv = 1;	break;
+		default:
+			fprintf( stderr, "usage: %s [-c] file...\n", argv[0] );
+			return 2;
+		}
+	}
+
+	if( optind >= argc )
+	{
+		fprintf( stderr, "usage: %s [-c] file...\n", argv[0] );
+		return 2;
+	}
+
+	if( csv )
+	{
+		printf( "file,offset,type,source,id,time,unix_time,crc\n" );
+	}
+
+	for( ; optind < argc; optind++ )
+	{
+		bad += decodeFile( argv[optind], csv );
+	}
+
+	return ( bad != 0 ) ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+/***************************************************************************//**
+ * @file	main.c
+ * @brief	Host (POSIX) build main.
+ *
+ * Brings up the flight software in the same order as the target main, on top
+ * of the FreeRTOS POSIX port, the host BSP stand-ins and a RAM or file backed
+ * disk image, and optionally runs the command dispatch benchmark.
+ *
+ * Usage: fsw_host [-n commands] [-k commands] [-r commands] [-t requests] [-l entries] [-c entries] [-d image] [-s sizeMB] [-x capture] [-v]
+ *   -n  commands to push through the benchmark (default 10000, 0 to just run)
+ *   -k  commands to load into the scheduler benchmark (default 10000, 0 to skip)
+ *   -r  commands to route in the router benchmark (default 1000000, 0 to skip)
+ *   -t  requests to answer in the telemetry benchmark (default 200000, 0 to skip)
+ *   -l  entries to log in the log writer benchmark (default 5000, 0 to skip)
+ *   -c  entries to log in the sector cache benchmark (default 6000, 0 to skip)
+ *   -d  host file to use as the SD card image (default: RAM)
+ *   -s  size of a new image in MiB (default 16)
+ *   -x  write the debug UART to a file, ending with a dump of the kernel trace
+ *       taken as the benchmark finishes, for fsw_tracedecode
+ *   -v  echo the debug UART to stdout
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "includes.h"
+#include "z_HILcomm.h"
+#include "fsw_cmdpool.h"
+#include "host.h"
+
+#include <unistd.h>
+
+uint8_t debugTLM, wdgEnable;
+
+xSemaphoreHandle printingMutex;		///< Mutex for the printing function.
+
+#ifndef HIL_sim
+static portSTACK_TYPE HIL_stack[ FSW_STACK_HIL ];
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *   Required by the FAT file system to timestamp files, with the OBC date and
+ *   time as on the target.
+ ******************************************************************************/
+DWORD get_fattime(void)
+{
+	time_t now = getOBC_time();
+	struct tm ts;
+
+	// FAT time starts in 1980; until the ground sets the date, the old fixed stamp
+	if(now < FATTIME_EPOCH)
+		return (28 << 25) | (2 << 21) | (1 << 16);
+
+	gmtime_r(&now, &ts);
+
+	return ((DWORD)(ts.tm_year - 80) << 25) | ((DWORD)(ts.tm_mon + 1) << 21) | ((DWORD)ts.tm_mday << 16)
+			| ((DWORD)ts.tm_hour << 11) | ((DWORD)ts.tm_min << 5) | ((DWORD)ts.tm_sec >> 1);
+}
+
+/***************************************************************************//**
+ * @brief Delays number of milliseconds.
+ * @param dlyTicks Number of ms to delay
+ ******************************************************************************/
+void Delay(uint32_t dlyTicks)
+{
+	usleep(dlyTicks * 1000);
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+	uint32_t benchCount = 10000;
+	uint32_t schedCount = 10000;
+	uint32_t routeCount = 1000000;
+	uint32_t telemetryCount = 200000;
+	uint32_t logCount = 5000;
+	uint32_t cacheCount = 6000;
+	uint32_t diskSizeMB = 16;
+	const char *diskImage = NULL;
+	const char *capture = NULL;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:k:r:t:l:c:d:s:x:v")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':	benchCount = strtoul(optarg, NULL, 0);	break;
+		case 'k':	schedCount = strtoul(optarg, NULL, 0);	break;
+		case 'r':	routeCount = strtoul(optarg, NULL, 0);	break;
+		case 't':	telemetryCount = strtoul(optarg, NULL, 0);	break;
+		case 'l':	logCount = strtoul(optarg, NULL, 0);	break;
+		case 'c':	cacheCount = strtoul(optarg, NULL, 0);	break;
+		case 'd':	diskImage = optarg;						break;
+		case 's':	diskSizeMB = strtoul(optarg, NULL, 0);	break;
+		case 'x':	capture = optarg;						break;
+		case 'v':	HOST_uartEcho = true;					break;
+		default:
+			fprintf(stderr, "usage: %s [-n commands] [-k commands] [-r commands] [-t requests] [-l entries] [-c entries] [-d image] [-s sizeMB] [-x capture] [-v]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (schedCount != 0 && BENCH_scheduler(schedCount) != 0)
+	{
+		return 1;
+	}
+
+	if (routeCount != 0 && BENCH_router(routeCount) != 0)
+	{
+		return 1;
+	}
+
+	if (telemetryCount != 0 && BENCH_telemetry(telemetryCount) != 0)
+	{
+		return 1;
+	}
+
+	// The debug UART, with the kernel trace the benchmark dumps at its end
+	if (capture != NULL && (HOST_uartCapture = fopen(capture, "wb")) == NULL)
+	{
+		fprintf(stderr, "could not create %s\n", capture);
+		return 1;
+	}
+
+	if (HOST_DISK_Init(diskImage, diskSizeMB) != 0)
+	{
+		fprintf(stderr, "could not create disk image\n");
+		return 1;
+	}
+
+	// Uses the disk before the FS module mounts it
+	if (logCount != 0 && BENCH_logger(logCount) != 0)
+	{
+		return 1;
+	}
+
+	if (cacheCount != 0 && BENCH_cache(cacheCount) != 0)
+	{
+		return 1;
+	}
+
+	BSP_DMA_Init();
+	BSP_WDG_Init (false, false);
+	BSP_RTC_Init();
+	BSP_EBI_Init();
+	BSP_TRACE_Init();
+	BSP_ADC_Init();
+
+	// Initializes UART and I2C communications
+	COMMS_init();
+
+	// Created before the modules, unlike the target, since FSW_FS_Init already prints
+	printingMutex = xSemaphoreCreateMutex();
+
+	// Flight Software
+	FSW_CMDPOOL_Init();
+	FSW_MODES_Init();
+	FSW_CDH_Init();
+	FSW_POWER_Init();
+	FSW_ADCS_Init();
+	FSW_HandH_Init();
+	FSW_COMM_Init();
+	FSW_PAYLOAD_Init();
+	FSW_FS_Init();
+	FSW_PERIODIC_Init();
+
+#ifndef HIL_sim
+	FSW_TASK_CREATE( HIL_TransceiverRX, "TaskTest", HIL_stack, NULL, 1 );
+#endif
+
+	if (benchCount != 0)
+	{
+		BENCH_Init(benchCount);
+	}
+
+	vTaskStartScheduler();
+
+	HOST_DISK_Close();
+	if (HOST_uartCapture != NULL)
+	{
+		fclose(HOST_uartCapture);
+	}
+
+	return (benchCount != 0) ? BENCH_result() : 0;
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf(stderr, "stack overflow in task %s\n", pcTaskName);
+	abort();
+}
+
+void vApplicationIdleHook( void )
+{
+	// Sleep until the next tick instead of spinning the host CPU
+	vPortWaitForTick();
+}
@@ -0,0 +1,233 @@
+/***************************************************************************//**
+ * @file	sdbench.c
+ * @brief	Host benchmark of the microSD driver.
+ *
+ * Runs microsd.c and diskio.c against the SPI card model in sdmodel.c from a
+ * FreeRTOS task, writes a pattern with single and multiple block transfers,
+ * reads it back and checks it. The modelled throughput of each pattern is
+ * reported for the DMA driver and for the polled driver it replaces, with
+ * the share of the transfer time the CPU spends in the driver.
+ *
+ * Usage: fsw_sdbench [-m KiB]
+ *   -m  data moved per pattern in KiB (default 1024)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "diskio.h"
+#include "microsd.h"
+#include "sdmodel.h"
+
+#define SDBENCH_SECTORS		( 64 * 1024 )	///< Card size, 32 MiB.
+#define SDBENCH_MULTI		16				///< Sectors per multiple block transfer.
+
+/// A transfer pattern.
+typedef struct
+{
+	const char	*name;
+	bool		write;
+	BYTE		count;			///< Sectors per disk_read/disk_write call.
+} SDBENCH_Pattern_TypeDef;
+
+static const SDBENCH_Pattern_TypeDef patterns[] =
+{
+	{ "write CMD24",    true,  1 },
+	{ "write CMD25x16", true,  SDBENCH_MULTI },
+	{ "read CMD17",     false, 1 },
+	{ "read CMD18x16",  false, SDBENCH_MULTI },
+};
+#define SDBENCH_PATTERNCOUNT	( sizeof( patterns ) / sizeof( patterns[0] ) )
+
+static uint32_t benchSectors = 2048;
+static int      benchResult = 1;
+static BYTE     buff[SDBENCH_MULTI * 512];
+
+// FUNCTIONS *******************************************************************
+
+static uint8_t SDBENCH_pattern( DWORD sector, uint32_t i )
+{
+	return ( uint8_t )( sector * 7 + i * 13 + ( i >> 9 ) );
+}
+
+/*
+ * Moves benchSectors sectors with the given pattern. Writes go to the second
+ * half of the card for the single block pattern, so each read pattern finds
+ * the data of its write pattern.
+ */
+static int SDBENCH_run( const SDBENCH_Pattern_TypeDef *p )
+{
+	DWORD base, sector;
+	uint32_t i;
+	double mb;
+
+	base = ( p->count == 1 ) ? SDBENCH_SECTORS / 2 : 0;
+	memset( &HOST_sdStats, 0, sizeof( HOST_sdStats ) );
+
+	for( sector = base; sector < base + benchSectors; sector += p->count )
+	{
+		if( p->write )
+		{
+			for( i = 0; i < p->count * 512; i++ )
+			{
+				buff[i] = SDBENCH_pattern( sector, i );
+			}
+			if( disk_write( 0, buff, sector, p->count ) != RES_OK )
+			{
+				printf( "%s: disk_write failed at sector %lu\n", p->name, ( unsigned long )sector );
+				return 1;
+			}
+		}
+		else
+		{
+			memset( buff, 0, sizeof( buff ) );
+			if( disk_read( 0, buff, sector, p->count ) != RES_OK )
+			{
+				printf( "%s: disk_read failed at sector %lu\n", p->name, ( unsigned long )sector );
+				return 1;
+			}
+			for( i = 0; i < p->count * 512; i++ )
+			{
+				if( buff[i] != SDBENCH_pattern( sector, i ) )
+				{
+					printf( "%s: bad data in sector %lu\n", p->name, ( unsigned long )( sector + i / 512 ) );
+					return 1;
+				}
+			}
+		}
+	}
+
+	mb = benchSectors * 512 / 1.0e6;
+	printf( "%-16s %8.3f %8.3f %7.1f %%   %9llu %9llu %7lu\n", p->name,
+			mb / ( HOST_sdStats.polledNs * 1e-9 ), mb / ( HOST_sdStats.dmaNs * 1e-9 ),
+			100.0 * HOST_sdStats.dmaCpuNs / HOST_sdStats.dmaNs,
+			( unsigned long long )HOST_sdStats.spiBytes, ( unsigned long long )HOST_sdStats.dmaBytes,
+			( unsigned long )HOST_sdStats.dmaXfers );
+
+	return 0;
+}
+
+// TASKS ***********************************************************************
+
+static void SDBENCH_task( void *pvParameters )
+{
+	uint32_t i;
+
+	MICROSD_Init();
+	if( disk_initialize( 0 ) & STA_NOINIT )
+	{
+		printf( "card initialisation failed\n" );
+	}
+	else
+	{
+		printf( "microSD driver, 12 MHz SPI, %lu KiB per pattern (modelled)\n", ( unsigned long )benchSectors / 2 );
+		printf( "pattern          polled MB/s  DMA MB/s  DMA CPU   SPI bytes DMA bytes DMA xfers\n" );
+
+		benchResult = 0;
+		for( i = 0; i < SDBENCH_PATTERNCOUNT && benchResult == 0; i++ )
+		{
+			benchResult = SDBENCH_run( &patterns[i] );
+		}
+		printf( "microSD driver %s\n", benchResult ? "FAILED" : "ok" );
+	}
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "m:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'm':	benchSectors = strtoul( optarg, NULL, 0 ) * 2;	break;
+		default:
+			fprintf( stderr, "usage: %s [-m KiB]\n", argv[0] );
+			return 2;
+		}
+	}
+
+	// Whole multiple block transfers, within half the card
+	benchSectors -= benchSectors % SDBENCH_MULTI;
+	if( benchSectors == 0 || benchSectors > SDBENCH_SECTORS / 2 )
+	{
+		fprintf( stderr, "pattern size out of range\n" );
+		return 2;
+	}
+
+	if( HOST_SD_Init( SDBENCH_SECTORS ) != 0 )
+	{
+		fprintf( stderr, "could not create card\n" );
+		return 1;
+	}
+
+	xTaskCreate( SDBENCH_task, ( const signed char * )"SDBENCH", 1024, NULL, 1, NULL );
+	vTaskStartScheduler();
+
+	HOST_SD_Close();
+
+	return benchResult;
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf( stderr, "stack overflow in task %s\n", pcTaskName );
+	abort();
+}
+
+void vApplicationIdleHook( void )
+{
+	vPortWaitForTick();
+}
+
+// The host FreeRTOSConfig.h traces queues for the dispatch benchmark
+void vHostTraceQueueSend( void *pxQueue )
+{
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+}
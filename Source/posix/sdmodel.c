@@ -0,0 +1,496 @@
+/***************************************************************************//**
+ * @file	sdmodel.c
+ * @brief	Host SPI microSD card model.
+ *
+ * Emulates an SDHC card in SPI mode behind the USART, GPIO, CMU and DMA
+ * functions used by microsd.c, so the driver and diskio.c run unmodified on
+ * the host. The card answers CMD0/8/9/12/16/17/18/24/25/55/58 and
+ * ACMD23/41, with a read access latency before every data block and a
+ * programming time after every written block.
+ *
+ * Every byte on the bus is also timed. The driver as built is timed with its
+ * DMA transfers; the same traffic is timed a second time as the polled driver
+ * would have moved it: 512-byte blocks sent one MICROSD_XferSpi call per byte,
+ * received by the 16-bit pipelined loop, and busy cards polled byte by byte.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdmodel.h"
+#include "microsd.h"
+#include "bsp_dma.h"
+
+// Card timing
+#define SD_NAC_US			100			///< Read access time, command or end of block to data token.
+#define SD_BUSY_US			250			///< Programming time of a written block.
+#define SD_STOP_BUSY_BYTES	8			///< Busy time after the stop transmission token.
+
+// CPU costs at the 48 MHz core clock
+#define SD_CPU_HZ			48000000.0
+#define SD_POLL_CYCLES		20			///< MICROSD_XferSpi call and loop overhead between two bytes.
+#define SD_DMA_DESCR_CYCLES	50			///< Writing one channel descriptor.
+#define SD_DMA_ARM_CYCLES	40			///< Arming one channel.
+#define SD_DMA_WAKE_CYCLES	600			///< Completion interrupt, semaphore and switching back to the task.
+
+#define SD_SECTOR_SIZE		512
+#define SD_FIFO_SIZE		2048		///< Card output queue, holds the longest response.
+#define SD_CHANNELS			DMA_CHANNEL_COUNT
+
+/// A DMA channel as configured by the driver.
+typedef struct
+{
+	DMA_CB_TypeDef	*cb;
+	bool			enableInt;
+	bool			srcInc;
+	bool			dstInc;
+	bool			armed;
+	uint8_t			*dst;
+	uint8_t			*src;
+	uint32_t		count;
+} SD_Channel_TypeDef;
+
+USART_TypeDef HOST_sdUsart;							///< USART registers seen by the driver.
+GPIO_TypeDef  HOST_sdGpio;							///< GPIO registers seen by the driver.
+DMA_TypeDef   HOST_sdDma;							///< DMA registers seen by the driver.
+DMA_CB_TypeDef cb[DMA_CHANNEL_COUNT];				///< DMA callbacks, as in bsp_dma.c.
+
+HOST_SD_Stats_TypeDef HOST_sdStats;
+
+static SD_Channel_TypeDef channels[SD_CHANNELS];
+static uint32_t spiHz = 100000;						///< Current SPI clock.
+
+static uint8_t  *image = NULL;						///< Card contents.
+static uint32_t imageSectors = 0;
+
+static uint8_t  fifo[SD_FIFO_SIZE];					///< Bytes the card is about to send.
+static bool     fifoWait[SD_FIFO_SIZE];				///< Byte is read access time or a data token.
+static uint32_t fifoHead, fifoCount;
+static bool     outWait;							///< Last byte sent was fifoWait.
+static uint32_t busyBytes;							///< Bytes the card still holds the bus low.
+
+static uint8_t  cmdFrame[6];						///< Command being received.
+static uint8_t  cmdLen;
+static bool     appCmd;								///< Last command was CMD55.
+static bool     idle = true;						///< Card not yet initialised by ACMD41.
+
+static bool     readMulti;							///< CMD18 in progress.
+static uint32_t readSector;
+static uint8_t  writeToken;							///< Start token awaited: 0xFE (CMD24), 0xFC (CMD25) or none.
+static bool     writeData;							///< Data block being received.
+static uint32_t writeSector, writePos;
+static uint8_t  writeBuf[SD_SECTOR_SIZE + 2];
+
+// FUNCTIONS *******************************************************************
+
+static double SD_byteNs( void )
+{
+	return 8.0e9 / spiHz;
+}
+
+static double SD_cyclesNs( uint32_t cycles )
+{
+	return cycles * 1.0e9 / SD_CPU_HZ;
+}
+
+static void SD_pushWait( uint8_t data, bool wait )
+{
+	if( fifoCount == SD_FIFO_SIZE )
+	{
+		fprintf( stderr, "sdmodel: card output overflow\n" );
+		abort();
+	}
+	fifoWait[( fifoHead + fifoCount ) % SD_FIFO_SIZE] = wait;
+	fifo[( fifoHead + fifoCount++ ) % SD_FIFO_SIZE] = data;
+}
+
+static void SD_push( uint8_t data )
+{
+	SD_pushWait( data, false );
+}
+
+/*
+ * Queues the read access time, the start token, a data block and its CRC.
+ */
+static void SD_pushBlock( const uint8_t *data, uint32_t len )
+{
+	uint32_t n;
+
+	for( n = ( uint32_t )( SD_NAC_US * 1000.0 / SD_byteNs() ) + 1; n; n-- )
+	{
+		SD_pushWait( 0xFF, true );
+	}
+	SD_pushWait( 0xFE, true );
+	while( len-- )
+	{
+		SD_push( *data++ );
+	}
+	SD_push( 0xFF );							// CRC, not checked by the driver
+	SD_push( 0xFF );
+}
+
+static void SD_command( uint8_t cmd, uint32_t arg )
+{
+	uint8_t r1, csd[16];
+	uint32_t csize;
+
+	// A new command ends whatever the card was sending
+	fifoCount = 0;
+	if( appCmd )
+	{
+		cmd |= 0x80;
+		appCmd = false;
+	}
+	r1 = idle ? 0x01 : 0x00;
+
+	SD_push( 0xFF );							// NCR
+	switch( cmd )
+	{
+	case CMD0:
+		idle = true;
+		SD_push( 0x01 );
+		break;
+	case CMD8:									// SDv2, 2.7-3.6 V
+		SD_push( r1 );
+		SD_push( 0x00 );
+		SD_push( 0x00 );
+		SD_push( 0x01 );
+		SD_push( arg & 0xFF );
+		break;
+	case CMD55:
+		appCmd = true;
+		SD_push( r1 );
+		break;
+	case ACMD41:
+		idle = false;
+		SD_push( 0x00 );
+		break;
+	case CMD58:									// Powered up, CCS set: block addressing
+		SD_push( r1 );
+		SD_push( 0xC0 );
+		SD_push( 0xFF );
+		SD_push( 0x80 );
+		SD_push( 0x00 );
+		break;
+	case CMD9:									// CSD version 2.0
+		memset( csd, 0, sizeof( csd ) );
+		csize = imageSectors / 1024 - 1;
+		csd[0] = 0x40;
+		csd[7] = ( csize >> 16 ) & 0x3F;
+		csd[8] = ( csize >> 8 ) & 0xFF;
+		csd[9] = csize & 0xFF;
+		SD_push( r1 );
+		SD_pushBlock( csd, sizeof( csd ) );
+		break;
+	case CMD12:
+		readMulti = false;
+		fifoCount = 0;
+		SD_push( 0xFF );						// Stuff byte
+		SD_push( 0xFF );
+		SD_push( r1 );
+		break;
+	case CMD17:
+	case CMD18:
+		if( arg >= imageSectors )
+		{
+			SD_push( r1 | 0x40 );				// Parameter error
+			break;
+		}
+		SD_push( r1 );
+		SD_pushBlock( image + arg * SD_SECTOR_SIZE, SD_SECTOR_SIZE );
+		readMulti = ( cmd == CMD18 );
+		readSector = arg + 1;
+		break;
+	case CMD24:
+	case CMD25:
+		if( arg >= imageSectors )
+		{
+			SD_push( r1 | 0x40 );
+			break;
+		}
+		SD_push( r1 );
+		writeToken = ( cmd == CMD24 ) ? 0xFE : 0xFC;
+		writeSector = arg;
+		break;
+	case CMD16:
+	case ACMD23:
+		SD_push( r1 );
+		break;
+	default:
+		SD_push( r1 | 0x04 );					// Illegal command
+		break;
+	}
+}
+
+/*
+ * Exchanges one byte with the card.
+ */
+static uint8_t SD_xfer( uint8_t data )
+{
+	uint8_t out;
+
+	// Card to host
+	if( fifoCount == 0 && readMulti )
+	{
+		if( readSector < imageSectors )
+		{
+			SD_pushBlock( image + readSector++ * SD_SECTOR_SIZE, SD_SECTOR_SIZE );
+		}
+		else
+		{
+			readMulti = false;
+		}
+	}
+	outWait = false;
+	if( fifoCount != 0 )
+	{
+		out = fifo[fifoHead];
+		outWait = fifoWait[fifoHead];
+		fifoHead = ( fifoHead + 1 ) % SD_FIFO_SIZE;
+		fifoCount--;
+	}
+	else if( busyBytes != 0 )
+	{
+		busyBytes--;
+		out = 0x00;
+	}
+	else
+	{
+		out = 0xFF;
+	}
+
+	// Host to card
+	if( writeData )
+	{
+		writeBuf[writePos++] = data;
+		if( writePos == sizeof( writeBuf ) )
+		{
+			memcpy( image + writeSector * SD_SECTOR_SIZE, writeBuf, SD_SECTOR_SIZE );
+			writeData = false;
+			SD_push( 0x05 );					// Data accepted
+			busyBytes = ( uint32_t )( SD_BUSY_US * 1000.0 / SD_byteNs() ) + 1;
+			if( writeToken == 0xFC && ++writeSector == imageSectors )
+			{
+				writeToken = 0;
+			}
+		}
+	}
+	else if( cmdLen != 0 || ( data & 0xC0 ) == 0x40 )
+	{
+		cmdFrame[cmdLen++] = data;
+		if( cmdLen == sizeof( cmdFrame ) )
+		{
+			cmdLen = 0;
+			writeToken = 0;
+			SD_command( cmdFrame[0] & 0x3F, ( ( uint32_t )cmdFrame[1] << 24 ) | ( ( uint32_t )cmdFrame[2] << 16 ) |
+						( ( uint32_t )cmdFrame[3] << 8 ) | cmdFrame[4] );
+		}
+	}
+	else if( writeToken != 0 && data == writeToken )
+	{
+		writeData = true;
+		writePos = 0;
+	}
+	else if( writeToken == 0xFC && data == 0xFD )
+	{
+		writeToken = 0;
+		busyBytes = SD_STOP_BUSY_BYTES;
+	}
+
+	return out;
+}
+
+/*
+ * Moves the bytes of an armed RX/TX channel pair through the card and calls
+ * the completion callback.
+ */
+static void SD_dmaRun( SD_Channel_TypeDef *rx, SD_Channel_TypeDef *tx )
+{
+	uint32_t i, ready = 0, wait = 0;
+	uint8_t data;
+
+	for( i = 0; i < tx->count; i++ )
+	{
+		data = SD_xfer( tx->src[tx->srcInc ? i : 0] );
+		rx->dst[rx->dstInc ? i : 0] = data;
+		if( ready == 0 && data == 0xFF )
+		{
+			ready = i + 1;
+		}
+		if( outWait )
+		{
+			wait++;
+		}
+	}
+	rx->armed = tx->armed = false;
+
+	HOST_sdStats.dmaBytes += tx->count;
+	HOST_sdStats.dmaXfers++;
+	HOST_sdStats.dmaNs += tx->count * SD_byteNs() + SD_cyclesNs( SD_DMA_WAKE_CYCLES );
+	HOST_sdStats.dmaCpuNs += SD_cyclesNs( SD_DMA_WAKE_CYCLES );
+
+	// The polled driver: the pipelined receive loop keeps the bus busy, the
+	// token poll, the transmit loop and the busy poll pay the call overhead
+	// on every byte and the busy poll stops at the first 0xFF.
+	if( rx->dstInc )
+	{
+		HOST_sdStats.polledNs += tx->count * SD_byteNs() + wait * SD_cyclesNs( SD_POLL_CYCLES );
+	}
+	else if( tx->srcInc )
+	{
+		HOST_sdStats.polledNs += tx->count * ( SD_byteNs() + SD_cyclesNs( SD_POLL_CYCLES ) );
+	}
+	else
+	{
+		HOST_sdStats.polledNs += ( ready ? ready : tx->count ) * ( SD_byteNs() + SD_cyclesNs( SD_POLL_CYCLES ) );
+	}
+
+	if( rx->cb != NULL && rx->enableInt )
+	{
+		rx->cb->cbFunc( rx - channels, true, rx->cb->userPtr );
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Creates a blank card and clears the statistics.
+ *
+ * @param[in] sectors
+ *   Card size in sectors, a multiple of 1024.
+ * @return
+ *   0 on success, -1 if the image could not be allocated.
+ ******************************************************************************/
+int HOST_SD_Init( uint32_t sectors )
+{
+	image = calloc( sectors, SD_SECTOR_SIZE );
+	if( image == NULL )
+	{
+		return -1;
+	}
+	imageSectors = sectors;
+	idle = true;
+	memset( &HOST_sdStats, 0, sizeof( HOST_sdStats ) );
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Releases the card.
+ ******************************************************************************/
+void HOST_SD_Close( void )
+{
+	free( image );
+	image = NULL;
+	imageSectors = 0;
+}
+
+// EMLIB STAND-INS *************************************************************
+
+void CMU_ClockEnable( CMU_Clock_TypeDef clock, bool enable )
+{
+}
+
+void GPIO_PinModeSet( GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out )
+{
+}
+
+void USART_InitSync( USART_TypeDef *usart, const USART_InitSync_TypeDef *init )
+{
+	spiHz = init->baudrate;
+}
+
+void USART_Reset( USART_TypeDef *usart )
+{
+}
+
+void USART_BaudrateSyncSet( USART_TypeDef *usart, uint32_t refFreq, uint32_t baudrate )
+{
+	spiHz = baudrate;
+}
+
+uint8_t USART_SpiTransfer( USART_TypeDef *usart, uint8_t data )
+{
+	double ns = SD_byteNs() + SD_cyclesNs( SD_POLL_CYCLES );
+
+	HOST_sdStats.spiBytes++;
+	HOST_sdStats.dmaNs += ns;
+	HOST_sdStats.dmaCpuNs += ns;
+	HOST_sdStats.polledNs += ns;
+
+	return SD_xfer( data );
+}
+
+void DMA_CfgChannel( unsigned int channel, DMA_CfgChannel_TypeDef *cfg )
+{
+	channels[channel].cb = cfg->cb;
+	channels[channel].enableInt = cfg->enableInt;
+}
+
+void DMA_CfgDescr( unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg )
+{
+	channels[channel].srcInc = ( cfg->srcInc != dmaDataIncNone );
+	channels[channel].dstInc = ( cfg->dstInc != dmaDataIncNone );
+
+	HOST_sdStats.dmaNs += SD_cyclesNs( SD_DMA_DESCR_CYCLES );
+	HOST_sdStats.dmaCpuNs += SD_cyclesNs( SD_DMA_DESCR_CYCLES );
+}
+
+void DMA_ActivateBasic( unsigned int channel, bool primary, bool useBurst, void *dst, void *src, unsigned int nMinus1 )
+{
+	SD_Channel_TypeDef *ch = &channels[channel];
+	SD_Channel_TypeDef *rx = NULL, *tx = NULL;
+	unsigned int i;
+
+	ch->dst = dst;
+	ch->src = src;
+	ch->count = nMinus1 + 1;
+	ch->armed = true;
+
+	HOST_sdStats.dmaNs += SD_cyclesNs( SD_DMA_ARM_CYCLES );
+	HOST_sdStats.dmaCpuNs += SD_cyclesNs( SD_DMA_ARM_CYCLES );
+
+	// The USART starts clocking once both directions are armed
+	for( i = 0; i < SD_CHANNELS; i++ )
+	{
+		if( channels[i].armed && channels[i].src == ( uint8_t* )&HOST_sdUsart.RXDATA )
+		{
+			rx = &channels[i];
+		}
+		if( channels[i].armed && channels[i].dst == ( uint8_t* )&HOST_sdUsart.TXDATA )
+		{
+			tx = &channels[i];
+		}
+	}
+	if( rx != NULL && tx != NULL )
+	{
+		SD_dmaRun( rx, tx );
+	}
+}
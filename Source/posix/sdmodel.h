@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @file	sdmodel.h
+ * @brief	Host SPI microSD card model.
+ *
+ * Force-included ahead of microsd.c in the host build of the microSD driver
+ * benchmark. It pulls in the EFM32 peripheral headers and then points the
+ * USART, GPIO and DMA register blocks at host memory, so the driver runs
+ * unmodified against the card model in sdmodel.c.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __SDMODEL_H
+#define __SDMODEL_H
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_usart.h"
+#include "em_dma.h"
+
+extern USART_TypeDef HOST_sdUsart;
+extern GPIO_TypeDef  HOST_sdGpio;
+extern DMA_TypeDef   HOST_sdDma;
+
+// Register blocks seen by the driver. The device header is include guarded,
+// so these survive its later inclusion by microsd.h.
+#undef  USART1
+#undef  USART2
+#undef  GPIO
+#undef  DMA
+#define USART1		( &HOST_sdUsart )
+#define USART2		( &HOST_sdUsart )
+#define GPIO		( &HOST_sdGpio )
+#define DMA			( &HOST_sdDma )
+
+/// Modelled time of the traffic seen by the card, for the driver as built and
+/// for the polled driver it replaces.
+typedef struct
+{
+	uint64_t	spiBytes;		///< Bytes exchanged by MICROSD_XferSpi.
+	uint64_t	dmaBytes;		///< Bytes exchanged by DMA.
+	uint32_t	dmaXfers;		///< DMA transfers.
+	double		dmaNs;			///< Elapsed time with DMA transfers.
+	double		dmaCpuNs;		///< CPU time with DMA transfers.
+	double		polledNs;		///< Elapsed (and CPU) time with polled transfers.
+} HOST_SD_Stats_TypeDef;
+
+extern HOST_SD_Stats_TypeDef HOST_sdStats;
+
+int  HOST_SD_Init( uint32_t sectors );			///< Create the card, with a blank image.
+void HOST_SD_Close( void );						///< Release the card.
+
+#endif // __SDMODEL_H
@@ -0,0 +1,675 @@
+/***************************************************************************//**
+ * @file	sleepbench.c
+ * @brief	Host test and benchmark of the RTC tick and the tickless idle.
+ *
+ * Runs bsp_sleep.c and bsp_rtc.c against the RTC and energy mode model in
+ * sleepmodel.c, with the kernel reduced to its tick count and the flight
+ * software to the periodic tasks it creates, each taking a fixed time to run:
+ * the four jobs of the schedule released every second, the telemetry stream
+ * every three, and the debug UART reader, which polls every tick until the
+ * line has been quiet for COMMS_UART_QUIETAFTER_MS and then waits for it to
+ * become active. The ADC interrupts for each DMA block, sampling either
+ * continuously or in the burst the housekeeping job starts each second, the
+ * housekeeping job's OBC time printout holds the UART transmit DMA for a few
+ * milliseconds and a ground frame arrives now and then.
+ *
+ * The same hour is run with the tick interrupting every tick and the 1 kHz
+ * millisecond clock the firmware kept on COMP0 before the RTC counter became
+ * the timebase, the idle task spinning as it did or sleeping in EM1 from the
+ * idle hook, and tickless, with the ADC sampling continuously, in bursts and
+ * stopped. For each the interrupts and wakeups per second, the time in each
+ * energy mode and the mean MCU current are reported; tickless, unless the ADC
+ * samples continuously, the core must spend most of the hour in EM2. Every tick must be counted at or after its time on
+ * the per-second grid, the kernel's tick must end where the RTC is, the
+ * timebase must read the model's count whenever a task runs or the RTC
+ * interrupts, the overflow pending or not, and never go back, no sleep
+ * may step the tick past the next task's timeout, no task may run a tick late,
+ * and the sleep times bsp_sleep.c accounts must match the model's.
+ *
+ * Usage: fsw_sleepbench [-s seconds] [-g seconds]
+ *   -s  seconds run in each configuration (default 3600)
+ *   -g  seconds between ground frames, 0 for none (default 30)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sleepmodel.h"
+#include "bsp_rtc.h"
+#include "bsp_sleep.h"
+#include "bsp_adc.h"
+#include "comms.h"
+#include "task.h"
+
+#define SLEEPBENCH_SECONDS		3600		///< Default seconds run in each configuration.
+#define SLEEPBENCH_GROUND_S		30			///< Default seconds between ground frames.
+#define SLEEPBENCH_TASKS		6
+
+#define SLEEPBENCH_TICK_US		4			///< Tick interrupt, the kernel's tick processing included.
+#define SLEEPBENCH_MS_US		2			///< Millisecond clock interrupt.
+#define SLEEPBENCH_OF_US		2			///< RTC overflow interrupt.
+#define SLEEPBENCH_MSCOUNTS		32			///< RTC counts in a tick of the millisecond clock, 1/1024 s.
+#define SLEEPBENCH_MSCOMP		0			///< Compare channel of the millisecond clock.
+#define SLEEPBENCH_ADC_US		40			///< ADC DMA block interrupt, decimating the block.
+#define SLEEPBENCH_PIN_US		3			///< UART RX pin interrupt.
+#define SLEEPBENCH_TXDONE_US	3			///< UART TX DMA interrupt.
+#define SLEEPBENCH_PRINT_US		3000		///< UART TX DMA time of the OBC time printout, 34 bytes at 115200 baud.
+#define SLEEPBENCH_ADC_BLOCKSUB	( ( uint64_t )BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS * BSP_ADC_BLOCK / BSP_ADC_RATE_HZ )	///< Model time between DMA block interrupts.
+#define SLEEPBENCH_EM2_MIN		0.9			///< Least share of the time in EM2 when tickless and the ADC is not held on.
+
+/// How the ADC samples.
+typedef enum
+{
+	SLEEPBENCH_ADC_STOPPED = 0,
+	SLEEPBENCH_ADC_CONTINUOUS,		///< BSP_ADC_start, holding the core in EM1 throughout.
+	SLEEPBENCH_ADC_BURST,			///< BSP_ADC_burst from the housekeeping job, holding EM1 while the burst runs.
+} SLEEPBENCH_Adc_TypeDef;
+
+/// A periodic task of the flight software.
+typedef struct
+{
+	const char		*name;
+	portTickType	period;			///< Ticks between releases, on the grid of vTaskDelayUntil; 0 for the UART reader.
+	uint32_t		costUs;			///< Time it runs for.
+} SLEEPBENCH_Task_TypeDef;
+
+/// A configuration of the tick and the idle task.
+typedef struct
+{
+	const char		*name;
+	bool			tickless;		///< The idle task stops the tick.
+	bool			idleEM1;		///< The idle hook sleeps in EM1 until the next interrupt, with the tick running.
+	SLEEPBENCH_Adc_TypeDef adc;		///< How the ADC samples.
+	bool			quiet;			///< The UART reader stops polling the quiet line.
+	bool			msClock;		///< The millisecond clock interrupts from COMP0, as before the timebase.
+} SLEEPBENCH_Config_TypeDef;
+
+static const SLEEPBENCH_Task_TypeDef task[SLEEPBENCH_TASKS] =
+{
+	{ "HIL_TransceiverRX",	0,		30 },
+	{ "ADCSexe",			100,	400 },
+	{ "PollUART",			100,	150 },
+	{ "HANDH_HK",			100,	1500 },
+	{ "SatModeMan",			100,	80 },
+	{ "TLMstream",			300,	600 },
+};
+
+static const SLEEPBENCH_Config_TypeDef config[] =
+{
+	{ "ticking, idle spins",		false,	false,	SLEEPBENCH_ADC_CONTINUOUS,	false,	true },
+	{ "ticking, idle hook EM1",		false,	true,	SLEEPBENCH_ADC_CONTINUOUS,	false,	true },
+	{ "tickless, ADC sampling",		true,	false,	SLEEPBENCH_ADC_CONTINUOUS,	true,	false },
+	{ "tickless, ADC bursts",		true,	false,	SLEEPBENCH_ADC_BURST,		true,	false },
+	{ "tickless, ADC stopped",		true,	false,	SLEEPBENCH_ADC_STOPPED,		true,	false },
+};
+
+void vPortSetupTimerInterrupt( void );
+void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime );
+
+static uint32_t sleepbenchSeconds = SLEEPBENCH_SECONDS;
+static uint32_t sleepbenchGround = SLEEPBENCH_GROUND_S;
+static const SLEEPBENCH_Config_TypeDef *cfg;
+
+// Kernel
+static portTickType kernelTick;
+static portTickType wake[SLEEPBENCH_TASKS];		// Tick each task is next ready at
+static uint32_t stepErrors;						// Steps past the next timeout
+static uint32_t earlyTicks;						// Ticks counted before their time
+static int64_t  worstLate;						// Latest a task ran after its tick, in model time
+
+// Millisecond clock background.c kept before the timebase
+static uint32_t sec;
+static uint16_t msec;
+static uint32_t msCount;
+
+// Timebase
+static uint64_t timeUs;							// Last BSP_RTC_getTimeUs read
+static uint32_t timeReads;
+static uint32_t timeErrors;						// Reads off the model's count, or going back
+
+// Interrupt sources
+static uint64_t adcNext;
+static uint32_t adcBlocks;						// DMA blocks left in the burst
+static uint64_t groundNext;
+static uint64_t txDone;
+static bool     rxQuiet;						// The UART reader waits for the line, its pin interrupt enabled
+static bool     rxPending;						// A frame the reader has not yet polled for
+static uint32_t interrupts;
+static uint32_t frames;
+static uint32_t framesRead;
+
+// FUNCTIONS *******************************************************************
+
+/*
+ * RTC count of tick n on the grid, the tick started at count 0.
+ */
+static uint64_t SLEEPBENCH_grid( uint64_t n )
+{
+	return ( n / configTICK_RATE_HZ ) * BSP_RTC_FREQ + ( ( n % configTICK_RATE_HZ ) * BSP_RTC_FREQ ) / configTICK_RATE_HZ;
+}
+
+static uint64_t SLEEPBENCH_count( void )
+{
+	return HOST_sleepNow / HOST_SLEEP_SUBCOUNTS;
+}
+
+static portTickType SLEEPBENCH_nextWake( void )
+{
+	portTickType next = wake[0];
+	int i;
+
+	for( i = 1; i < SLEEPBENCH_TASKS; i++ )
+	{
+		if( ( portTickType )( wake[i] - kernelTick ) < ( portTickType )( next - kernelTick ) )
+		{
+			next = wake[i];
+		}
+	}
+
+	return next;
+}
+
+static int SLEEPBENCH_ready( void )
+{
+	int i;
+
+	for( i = 0; i < SLEEPBENCH_TASKS; i++ )
+	{
+		if( ( portTickType )( kernelTick - wake[i] ) < 0x80000000UL )
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// KERNEL STAND-INS ************************************************************
+
+portBASE_TYPE xTaskIncrementTick( void )
+{
+	kernelTick++;
+
+	if( SLEEPBENCH_grid( kernelTick ) > SLEEPBENCH_count() + BSP_RTC_SYNCCOUNTS )
+	{
+		earlyTicks++;
+	}
+
+	return ( SLEEPBENCH_ready() >= 0 ) ? pdTRUE : pdFALSE;
+}
+
+void vTaskStepTick( portTickType xTicksToJump )
+{
+	// The kernel asserts this
+	if( xTicksToJump > ( portTickType )( SLEEPBENCH_nextWake() - kernelTick ) )
+	{
+		stepErrors++;
+	}
+
+	kernelTick += xTicksToJump;
+}
+
+eSleepModeStatus eTaskConfirmSleepModeStatus( void )
+{
+	return ( SLEEPBENCH_ready() >= 0 ) ? eAbortSleep : eStandardSleep;
+}
+
+void vPortYield( void )
+{
+}
+
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+// INTERRUPTS ******************************************************************
+
+/*
+ * Whether LETIMER0 triggers scans, so the DMA blocks interrupt.
+ */
+static bool SLEEPBENCH_adcSampling( void )
+{
+	return cfg->adc == SLEEPBENCH_ADC_CONTINUOUS || adcBlocks > 0;
+}
+
+/*
+ * Reads the timebase, as a task or an interrupt handler would.
+ */
+static void SLEEPBENCH_checkTime( void )
+{
+	uint64_t counts = BSP_RTC_getCounts();
+	uint64_t us = BSP_RTC_getTimeUs();
+
+	timeReads++;
+	if( counts != SLEEPBENCH_count() || us < timeUs )
+	{
+		if( timeErrors++ == 0 )
+		{
+			printf( "    timebase %llu counts, %llu us at count %llu, %llu us before\n", ( unsigned long long )counts,
+					( unsigned long long )us, ( unsigned long long )SLEEPBENCH_count(), ( unsigned long long )timeUs );
+		}
+	}
+	timeUs = us;
+}
+
+static void SLEEPBENCH_isr( uint32_t us )
+{
+	interrupts++;
+	HOST_SLEEP_pass( HOST_sleepNow + HOST_SLEEP_US( us ), hostSleepEM0Busy );
+}
+
+/*
+ * RTC_IRQHandler of background.c, with the millisecond clock it had before.
+ */
+static void SLEEPBENCH_rtcIRQ( void )
+{
+	uint32_t flags, elapsed, us = 0;
+
+	flags = RTC_IntGet() & HOST_rtc.enabled;
+
+	// Before the overflow is counted, so a pending one is read
+	SLEEPBENCH_checkTime();
+
+	if( flags & RTC_IF_OF )
+	{
+		BSP_RTC_overflowIRQ();
+		us += SLEEPBENCH_OF_US;
+	}
+
+	if( flags & RTC_IF_COMP0 )
+	{
+		RTC_IntClear( RTC_IFC_COMP0 );
+
+		elapsed = ( ( RTC_CounterGet() + BSP_RTC_SYNCCOUNTS - msCount ) & BSP_RTC_MASK ) / SLEEPBENCH_MSCOUNTS;
+		msCount = ( msCount + elapsed * SLEEPBENCH_MSCOUNTS ) & BSP_RTC_MASK;
+		elapsed += msec;
+		sec += elapsed / 1024;
+		msec = elapsed % 1024;
+
+		BSP_RTC_compareArm( SLEEPBENCH_MSCOMP, ( msCount + SLEEPBENCH_MSCOUNTS ) & BSP_RTC_MASK );
+		us += SLEEPBENCH_MS_US;
+	}
+
+	BSP_SLEEP_rtcIRQ( flags );
+	if( flags & RTC_IF_COMP1 )
+	{
+		us += SLEEPBENCH_TICK_US;
+	}
+
+	SLEEPBENCH_isr( us );
+}
+
+/*
+ * Takes the interrupts pending, each moving time on by its handler's run time.
+ */
+static void SLEEPBENCH_interrupts( void )
+{
+	bool taken;
+
+	do
+	{
+		taken = true;
+
+		if( HOST_rtc.flags & HOST_rtc.enabled )
+		{
+			SLEEPBENCH_rtcIRQ();
+		}
+		else if( SLEEPBENCH_adcSampling() && HOST_sleepNow >= adcNext )
+		{
+			adcNext += SLEEPBENCH_ADC_BLOCKSUB;
+			// The burst's last block stops the trigger and releases its hold, as burstBlockDone
+			if( cfg->adc == SLEEPBENCH_ADC_BURST && --adcBlocks == 0 )
+			{
+				BSP_SLEEP_releaseEM1();
+			}
+			SLEEPBENCH_isr( SLEEPBENCH_ADC_US );
+		}
+		else if( HOST_sleepNow >= txDone )
+		{
+			txDone = HOST_SLEEP_FOREVER;
+			BSP_SLEEP_releaseEM1();
+			SLEEPBENCH_isr( SLEEPBENCH_TXDONE_US );
+		}
+		else if( HOST_sleepNow >= groundNext )
+		{
+			groundNext += ( uint64_t )sleepbenchGround * BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS;
+			frames++;
+			rxPending = true;
+
+			// The start bit wakes the reader waiting for the line, as BSP_UART_rxPinIRQ
+			if( rxQuiet )
+			{
+				rxQuiet = false;
+				BSP_SLEEP_holdEM1();
+				wake[0] = kernelTick;
+				SLEEPBENCH_isr( SLEEPBENCH_PIN_US );
+			}
+		}
+		else
+		{
+			taken = false;
+		}
+	} while( taken );
+}
+
+uint64_t HOST_SLEEP_nextExternal( bool deep )
+{
+	uint64_t next = txDone;
+
+	if( SLEEPBENCH_adcSampling() && adcNext < next )
+	{
+		next = adcNext;
+	}
+
+	// Without the pin interrupt the frame lands in the DMA buffer unnoticed
+	if( rxQuiet && groundNext < next )
+	{
+		next = groundNext;
+	}
+
+	return next;
+}
+
+// TASKS ***********************************************************************
+
+/*
+ * COMMS_uartRx, polling every tick until the line has been quiet for
+ * COMMS_UART_QUIETAFTER_MS.
+ */
+static void SLEEPBENCH_uartReader( void )
+{
+	static portTickType lastRx;
+
+	if( rxQuiet )
+	{
+		// Timed out waiting for the line
+		rxQuiet = false;
+		BSP_SLEEP_holdEM1();
+	}
+
+	if( rxPending )
+	{
+		rxPending = false;
+		framesRead++;
+		lastRx = kernelTick;
+	}
+
+	if( cfg->quiet && ( portTickType )( kernelTick - lastRx ) >= COMMS_UART_QUIETAFTER_MS / portTICK_RATE_MS )
+	{
+		rxQuiet = true;
+		BSP_SLEEP_releaseEM1();
+		wake[0] = kernelTick + COMMS_UART_QUIET_MS / portTICK_RATE_MS;
+	}
+	else
+	{
+		wake[0] = kernelTick + COMMS_UART_POLL_MS / portTICK_RATE_MS;
+	}
+}
+
+static void SLEEPBENCH_runTask( int t )
+{
+	int64_t late = ( int64_t )( HOST_sleepNow - SLEEPBENCH_grid( wake[t] ) * HOST_SLEEP_SUBCOUNTS );
+
+	// A reader woken by the line has no grid time to be late for
+	if( !( t == 0 && rxPending ) && late > worstLate )
+	{
+		worstLate = late;
+	}
+
+	HOST_SLEEP_pass( HOST_sleepNow + HOST_SLEEP_US( task[t].costUs ), hostSleepEM0Busy );
+
+	// As the task ends, with any interrupt raised while it ran still pending
+	SLEEPBENCH_checkTime();
+
+	if( t == 0 )
+	{
+		SLEEPBENCH_uartReader();
+	}
+	else
+	{
+		wake[t] += task[t].period;
+	}
+
+	// The housekeeping job starts the next second's burst
+	if( t == 3 && cfg->adc == SLEEPBENCH_ADC_BURST && adcBlocks == 0 )
+	{
+		BSP_SLEEP_holdEM1();
+		adcBlocks = BSP_ADC_BURST / BSP_ADC_BLOCK;
+		adcNext = HOST_sleepNow + SLEEPBENCH_ADC_BLOCKSUB;
+	}
+
+	// The OBC time printout
+	if( t == 3 && txDone == HOST_SLEEP_FOREVER )
+	{
+		BSP_SLEEP_holdEM1();
+		txDone = HOST_sleepNow + HOST_SLEEP_US( SLEEPBENCH_PRINT_US );
+	}
+}
+
+// BENCH ***********************************************************************
+
+static int SLEEPBENCH_run( const SLEEPBENCH_Config_TypeDef *config )
+{
+	BSP_SLEEP_Stats_TypeDef before, stats;
+	uint32_t slept;
+	uint64_t end, next, modelSlept, count, ms, mode[hostSleepModes];
+	double total, seconds, current;
+	int i, t, result = 0;
+
+	cfg = config;
+	HOST_SLEEP_Init();
+	kernelTick = 0;
+	stepErrors = earlyTicks = 0;
+	worstLate = 0;
+	sec = msec = msCount = 0;
+	timeUs = 0;
+	timeReads = timeErrors = 0;
+	interrupts = frames = framesRead = 0;
+	rxQuiet = rxPending = false;
+	txDone = HOST_SLEEP_FOREVER;
+	adcNext = SLEEPBENCH_ADC_BLOCKSUB;
+	adcBlocks = 0;
+	// Half a period in, so none arrives as the run ends
+	groundNext = sleepbenchGround ? ( uint64_t )sleepbenchGround * BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS / 2 : HOST_SLEEP_FOREVER;
+	for( i = 0; i < SLEEPBENCH_TASKS; i++ )
+	{
+		wake[i] = 0;
+	}
+
+	// As at boot: the ADC sampling continuously and the UART reader hold EM1, then the scheduler starts
+	BSP_SLEEP_getStats( &before );
+	BSP_RTC_Init();
+	if( cfg->adc == SLEEPBENCH_ADC_CONTINUOUS )
+	{
+		BSP_SLEEP_holdEM1();
+	}
+	BSP_SLEEP_holdEM1();
+	if( cfg->msClock )
+	{
+		BSP_RTC_compareArm( SLEEPBENCH_MSCOMP, SLEEPBENCH_MSCOUNTS );
+		RTC_IntEnable( RTC_IEN_COMP0 );
+	}
+	vPortSetupTimerInterrupt();
+
+	end = ( uint64_t )sleepbenchSeconds * BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS;
+
+	while( HOST_sleepNow < end )
+	{
+		SLEEPBENCH_interrupts();
+
+		t = SLEEPBENCH_ready();
+		if( t >= 0 )
+		{
+			SLEEPBENCH_runTask( t );
+		}
+		else if( cfg->tickless
+				&& ( portTickType )( SLEEPBENCH_nextWake() - kernelTick ) >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+		{
+			vPortSuppressTicksAndSleep( SLEEPBENCH_nextWake() - kernelTick );
+		}
+		else if( cfg->idleEM1 )
+		{
+			EMU_EnterEM1();
+		}
+		else
+		{
+			next = HOST_RTC_nextEvent();
+			if( HOST_SLEEP_nextExternal( false ) < next )
+			{
+				next = HOST_SLEEP_nextExternal( false );
+			}
+			HOST_SLEEP_pass( next, hostSleepEM0Idle );
+		}
+	}
+	SLEEPBENCH_interrupts();
+
+	BSP_SLEEP_getStats( &stats );
+	stats.ticks -= before.ticks;
+	stats.sleeps -= before.sleeps;
+	slept = ( stats.em1Time - before.em1Time ) + ( stats.em2Time - before.em2Time );
+
+	// Undo the holds, for the next configuration
+	for( i = stats.holds; i > 0; i-- )
+	{
+		BSP_SLEEP_releaseEM1();
+	}
+
+	seconds = ( double )HOST_sleepNow / ( BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS );
+	total = 0;
+	for( i = 0; i < hostSleepModes; i++ )
+	{
+		mode[i] = HOST_sleepStats.time[i];
+		total += mode[i];
+	}
+	current = ( ( mode[hostSleepEM0Busy] + mode[hostSleepEM0Idle] ) * ( double )BSP_SLEEP_EM0_UA
+			+ mode[hostSleepEM1] * ( double )BSP_SLEEP_EM1_UA + mode[hostSleepEM2] * ( double )BSP_SLEEP_EM2_UA ) / total;
+
+	printf( "  %-24s %7.1f %9.1f %7.1f %6.2f %6.2f %6.2f %6.2f %8.0f %7.2f\n", cfg->name,
+			interrupts / seconds, HOST_sleepStats.wakeups / seconds, stats.ticks / seconds,
+			100.0 * mode[hostSleepEM0Busy] / total, 100.0 * mode[hostSleepEM0Idle] / total,
+			100.0 * mode[hostSleepEM1] / total, 100.0 * mode[hostSleepEM2] / total, current,
+			worstLate * 1000.0 / ( BSP_RTC_FREQ * HOST_SLEEP_SUBCOUNTS ) );
+
+	// The tick, the timebase and the millisecond clock end where the RTC is
+	count = SLEEPBENCH_count();
+	SLEEPBENCH_checkTime();
+	if( SLEEPBENCH_grid( kernelTick ) > count + BSP_RTC_SYNCCOUNTS
+		|| SLEEPBENCH_grid( kernelTick + 1 ) + BSP_RTC_SYNCCOUNTS <= count )
+	{
+		printf( "    tick %lu at count %llu, grid %llu\n", ( unsigned long )kernelTick,
+				( unsigned long long )count, ( unsigned long long )SLEEPBENCH_grid( kernelTick ) );
+		result = 1;
+	}
+
+	if( timeErrors )
+	{
+		printf( "    %lu of %lu timebase reads wrong\n", ( unsigned long )timeErrors, ( unsigned long )timeReads );
+		result = 1;
+	}
+
+	ms = ( uint64_t )sec * 1024 + msec;
+	if( cfg->msClock && ( ms < count / SLEEPBENCH_MSCOUNTS || ms > ( count + BSP_RTC_SYNCCOUNTS ) / SLEEPBENCH_MSCOUNTS ) )
+	{
+		printf( "    millisecond clock %llu at count %llu\n", ( unsigned long long )ms, ( unsigned long long )count );
+		result = 1;
+	}
+
+	if( earlyTicks || stepErrors )
+	{
+		printf( "    %lu ticks counted early, %lu steps past a timeout\n", ( unsigned long )earlyTicks, ( unsigned long )stepErrors );
+		result = 1;
+	}
+
+	if( worstLate >= ( int64_t )( SLEEPBENCH_grid( 1 ) * HOST_SLEEP_SUBCOUNTS ) )
+	{
+		printf( "    a task ran a tick late\n" );
+		result = 1;
+	}
+
+	if( cfg->tickless && cfg->adc != SLEEPBENCH_ADC_CONTINUOUS && mode[hostSleepEM2] < SLEEPBENCH_EM2_MIN * total )
+	{
+		printf( "    %.2f %% of the time in EM2\n", 100.0 * mode[hostSleepEM2] / total );
+		result = 1;
+	}
+
+	if( framesRead != frames )
+	{
+		printf( "    %lu of %lu ground frames read\n", ( unsigned long )framesRead, ( unsigned long )frames );
+		result = 1;
+	}
+
+	// Each sleep's accounted time is whole counts of the model's
+	modelSlept = ( mode[hostSleepEM1] + mode[hostSleepEM2] ) / HOST_SLEEP_SUBCOUNTS;
+	if( cfg->tickless && ( ( uint64_t )slept + stats.sleeps < modelSlept || slept > modelSlept + stats.sleeps ) )
+	{
+		printf( "    %lu counts accounted asleep, %llu modelled\n", ( unsigned long )slept,
+				( unsigned long long )modelSlept );
+		result = 1;
+	}
+
+	return result;
+}
+
+int main( int argc, char **argv )
+{
+	int opt, i, result = 0;
+
+	while( ( opt = getopt( argc, argv, "s:g:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 's':	sleepbenchSeconds = strtoul( optarg, NULL, 0 );	break;
+		case 'g':	sleepbenchGround = strtoul( optarg, NULL, 0 );	break;
+		default:
+			fprintf( stderr, "usage: %s [-s seconds] [-g seconds]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( sleepbenchSeconds == 0 || sleepbenchSeconds > 36 * 3600 )
+	{
+		fprintf( stderr, "seconds 0 or past the 32 bit RTC time\n" );
+		return 2;
+	}
+
+	printf( "RTC tick and tickless idle, %u s per configuration, a ground frame every %u s (modelled)\n",
+			sleepbenchSeconds, sleepbenchGround );
+	printf( "  %-24s %7s %9s %7s %6s %6s %6s %6s %8s %7s\n", "configuration", "irq/s", "wakeups/s", "ticks/s",
+			"EM0 %", "idle %", "EM1 %", "EM2 %", "mean uA", "late ms" );
+
+	for( i = 0; i < ( int )( sizeof( config ) / sizeof( config[0] ) ); i++ )
+	{
+		result |= SLEEPBENCH_run( &config[i] );
+	}
+
+	printf( "RTC tick and tickless idle %s\n", result ? "FAILED" : "ok" );
+
+	return result;
+}
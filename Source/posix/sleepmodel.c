@@ -0,0 +1,191 @@
+/***************************************************************************//**
+ * @file	sleepmodel.c
+ * @brief	Host RTC and energy mode model.
+ *
+ * Emulates the RTC behind the functions of sleepmodel.h, on a model clock the
+ * benchmark moves on by the time each task and interrupt handler takes. The
+ * counter is the model time in 1/32768 s, wrapped to 24 bits, and a compare
+ * flag is raised as the counter changes to its compare value, the overflow
+ * flag as it changes to zero.
+ *
+ * A sleep entered with an interrupt pending returns at once, as WFI does with
+ * interrupts masked. Otherwise the model time moves on to the next interrupt,
+ * from the RTC or from the benchmark's other sources, and the time is tallied
+ * in the energy mode slept in.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sleepmodel.h"
+
+#define RTC_MASK		0xFFFFFF
+
+HOST_RTC_TypeDef HOST_rtc;							///< RTC registers seen by the drivers.
+HOST_SLEEP_Stats_TypeDef HOST_sleepStats;
+uint64_t HOST_sleepNow;								///< Model time, in HOST_SLEEP_SUBCOUNTS of an RTC count.
+
+// FUNCTIONS *******************************************************************
+
+/*
+ * Model time the counter next changes to value, after now.
+ */
+static uint64_t RTC_nextMatch( uint32_t value )
+{
+	uint64_t count = HOST_sleepNow / HOST_SLEEP_SUBCOUNTS + 1;
+
+	count += ( value - ( uint32_t )count ) & RTC_MASK;
+
+	return count * HOST_SLEEP_SUBCOUNTS;
+}
+
+void HOST_SLEEP_Init( void )
+{
+	memset( &HOST_rtc, 0, sizeof( HOST_rtc ) );
+	memset( &HOST_sleepStats, 0, sizeof( HOST_sleepStats ) );
+	HOST_sleepNow = 0;
+}
+
+uint32_t HOST_RTC_counter( void )
+{
+	return ( uint32_t )( HOST_sleepNow / HOST_SLEEP_SUBCOUNTS ) & RTC_MASK;
+}
+
+uint64_t HOST_RTC_nextEvent( void )
+{
+	uint64_t next = HOST_SLEEP_FOREVER;
+	uint64_t match;
+
+	if( !HOST_rtc.running )
+	{
+		return next;
+	}
+
+	if( HOST_rtc.flags & HOST_rtc.enabled )
+	{
+		return HOST_sleepNow;
+	}
+
+	if( HOST_rtc.enabled & RTC_IEN_COMP0 )
+	{
+		next = RTC_nextMatch( HOST_rtc.comp[0] );
+	}
+
+	if( HOST_rtc.enabled & RTC_IEN_COMP1 )
+	{
+		match = RTC_nextMatch( HOST_rtc.comp[1] );
+		next = ( match < next ) ? match : next;
+	}
+
+	if( HOST_rtc.enabled & RTC_IEN_OF )
+	{
+		match = RTC_nextMatch( 0 );
+		next = ( match < next ) ? match : next;
+	}
+
+	return next;
+}
+
+void HOST_SLEEP_pass( uint64_t until, HOST_SLEEP_Mode_TypeDef mode )
+{
+	if( until <= HOST_sleepNow )
+	{
+		return;
+	}
+
+	if( HOST_rtc.running )
+	{
+		if( RTC_nextMatch( HOST_rtc.comp[0] ) <= until )
+		{
+			HOST_rtc.flags |= RTC_IF_COMP0;
+		}
+
+		if( RTC_nextMatch( HOST_rtc.comp[1] ) <= until )
+		{
+			HOST_rtc.flags |= RTC_IF_COMP1;
+		}
+
+		if( RTC_nextMatch( 0 ) <= until )
+		{
+			HOST_rtc.flags |= RTC_IF_OF;
+		}
+	}
+
+	HOST_sleepStats.time[mode] += until - HOST_sleepNow;
+	HOST_sleepNow = until;
+}
+
+void HOST_SLEEP_enter( bool deep )
+{
+	uint64_t wake, external;
+
+	HOST_sleepStats.sleeps++;
+
+	wake = HOST_RTC_nextEvent();
+	external = HOST_SLEEP_nextExternal( deep );
+	wake = ( external < wake ) ? external : wake;
+
+	// WFI falls through an interrupt already pending
+	if( wake <= HOST_sleepNow )
+	{
+		return;
+	}
+
+	if( wake == HOST_SLEEP_FOREVER )
+	{
+		printf( "sleepmodel: sleep in EM%d with no interrupt to wake it\n", deep ? 2 : 1 );
+		exit( 1 );
+	}
+
+	HOST_SLEEP_pass( wake, deep ? hostSleepEM2 : hostSleepEM1 );
+	HOST_sleepStats.wakeups++;
+}
+
+// EMLIB STAND-INS *************************************************************
+
+void RTC_Init( const RTC_Init_TypeDef *init )
+{
+	HOST_rtc.running = init->enable;
+}
+
+void RTC_Enable( bool enable )
+{
+	HOST_rtc.running = enable;
+}
+
+void RTC_CompareSet( unsigned int comp, uint32_t value )
+{
+	HOST_rtc.comp[comp & 1] = value & RTC_MASK;
+}
+
+uint32_t RTC_CompareGet( unsigned int comp )
+{
+	return HOST_rtc.comp[comp & 1];
+}
+
+void CMU_ClockEnable( CMU_Clock_TypeDef clock, bool enable )
+{
+}
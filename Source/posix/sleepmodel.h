@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file	sleepmodel.h
+ * @brief	Host RTC and energy mode model.
+ *
+ * Force-included ahead of bsp_sleep.c and bsp_rtc.c in the host build of the
+ * sleep benchmark. It points the RTC, EMU and interrupt masking functions at
+ * the model in sleepmodel.c, in which time only passes when the benchmark or
+ * a sleep moves it on, so the tick and the tickless idle run unmodified and
+ * every count of a simulated hour can be checked.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __SLEEPMODEL_H
+#define __SLEEPMODEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_rtc.h"
+#include "em_emu.h"
+
+#define HOST_SLEEP_SUBCOUNTS	1024		///< Model time steps in an RTC count, about 30 ns each.
+#define HOST_SLEEP_FOREVER		UINT64_MAX	///< No event pending.
+
+/// Model time in HOST_SLEEP_SUBCOUNTS of an RTC count, from microseconds.
+#define HOST_SLEEP_US( us )		( ( uint64_t )( us ) * 32768 * HOST_SLEEP_SUBCOUNTS / 1000000 )
+
+/// Energy modes the model tallies time in.
+typedef enum
+{
+	hostSleepEM0Busy,		///< Running a task or an interrupt handler.
+	hostSleepEM0Idle,		///< Running the idle task without sleeping.
+	hostSleepEM1,
+	hostSleepEM2,
+	hostSleepModes
+} HOST_SLEEP_Mode_TypeDef;
+
+/// The model's RTC registers.
+typedef struct
+{
+	uint32_t	comp[2];	///< Compare values.
+	uint32_t	flags;		///< IF.
+	uint32_t	enabled;	///< IEN.
+	bool		running;
+} HOST_RTC_TypeDef;
+
+/// What the model counted.
+typedef struct
+{
+	uint64_t	time[hostSleepModes];	///< Model time spent in each mode.
+	uint32_t	sleeps;					///< Sleeps the core entered.
+	uint32_t	wakeups;				///< Sleeps ended by an interrupt, each waking the core.
+	uint32_t	masked;					///< Interrupt masking sections entered.
+} HOST_SLEEP_Stats_TypeDef;
+
+extern HOST_RTC_TypeDef HOST_rtc;
+extern HOST_SLEEP_Stats_TypeDef HOST_sleepStats;
+extern uint64_t HOST_sleepNow;
+
+// The inline emlib RTC and EMU functions act on the model instead. The headers
+// are include guarded, so these survive their later inclusion.
+#define RTC_CounterGet()				HOST_RTC_counter()
+#define RTC_IntGet()					( HOST_rtc.flags )
+#define RTC_IntSet( f )					( HOST_rtc.flags |= ( f ) )
+#define RTC_IntClear( f )				( HOST_rtc.flags &= ~( f ) )
+#define RTC_IntEnable( f )				( HOST_rtc.enabled |= ( f ) )
+#define RTC_IntDisable( f )				( HOST_rtc.enabled &= ~( f ) )
+#define EMU_EnterEM1()					HOST_SLEEP_enter( false )
+#define EMU_EnterEM2( restore )			HOST_SLEEP_enter( true )
+
+// The CMSIS core functions are inline and bound to the core.
+#define __disable_irq()					( HOST_sleepStats.masked++ )
+#define __enable_irq()					( ( void ) 0 )
+#define NVIC_EnableIRQ( irq )			( ( void )( irq ) )
+#define NVIC_SetPriority( irq, priority )	( ( void )( irq ) )
+
+void     HOST_SLEEP_Init( void );								///< Reset the model time, RTC and statistics.
+uint32_t HOST_RTC_counter( void );								///< RTC counter now.
+uint64_t HOST_RTC_nextEvent( void );							///< Model time an enabled RTC flag is next raised.
+void     HOST_SLEEP_pass( uint64_t until, HOST_SLEEP_Mode_TypeDef mode );	///< Move time on in a mode, raising the RTC flags.
+void     HOST_SLEEP_enter( bool deep );							///< Sleep until an interrupt, as WFI with interrupts masked.
+
+/// Model time of the next interrupt from outside the RTC, provided by the
+/// benchmark. A sleep ends at it or at the next RTC interrupt.
+uint64_t HOST_SLEEP_nextExternal( bool deep );
+
+#endif // __SLEEPMODEL_H
@@ -0,0 +1,534 @@
+/***************************************************************************//**
+ * @file	tracedecode.c
+ * @brief	Host decoder for kernel trace dumps.
+ *
+ * Reads debug UART captures holding dumps of the kernel trace, sent by the
+ * HandH trace telecommand as link frames, and prints for each dump the CPU
+ * share of every task, taken from the context switches, the occupancy of
+ * every queue and a histogram of how late each interrupt that records it ran.
+ * Other frames and bytes in the capture are skipped. Frames missing from a
+ * dump are reported, and the dump decoded from what arrived.
+ *
+ * Usage: fsw_tracedecode [-q] file...
+ *   -q  print the occupancy timeline of the queues as CSV instead
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fsw_link.h"
+#include "bsp_trace.h"
+
+/// Frames of a dump, as sent by FSW_HANDH_CMDtrace.
+#define TRACEDEC_ID			0x08		///< Link frame ID of a trace dump.
+#define TRACEDEC_HEADER		0			///< Kinds of frame, the first byte of the payload.
+#define TRACEDEC_TASKS		1
+#define TRACEDEC_QUEUES		2
+#define TRACEDEC_EVENTS		3
+#define TRACEDEC_NAMELEN	10			///< configMAX_TASK_NAME_LEN of the flight build.
+#define TRACEDEC_TASKLEN	( 6 + TRACEDEC_NAMELEN )
+#define TRACEDEC_EVENTLEN	8
+
+#define TRACEDEC_RATE		32768.0		///< RTC counts a second.
+#define TRACEDEC_BINS		9			///< Latency histogram bins: 0, 1, 2, 3, 4-7, ... 64 counts and more.
+#define TRACEDEC_BAR		40			///< Width of the longest histogram bar.
+
+/// Names of the queue types, indexed by queueQUEUE_TYPE_BASE to queueQUEUE_TYPE_RECURSIVE_MUTEX.
+static const char *queueTypes[] = { "queue", "mutex", "counting", "binary", "recursive" };
+
+#define NAME( names, i )	( ( i ) < sizeof( names ) / sizeof( names[0] ) ? names[i] : "?" )
+
+/// A task of the dump.
+typedef struct
+{
+	int			known;
+	uint8_t		priority;
+	uint32_t	runTime;		///< Kernel run time counter since start up.
+	char		name[TRACEDEC_NAMELEN + 1];
+} Task_TypeDef;
+
+/// A dump being put together from its frames.
+typedef struct
+{
+	int			started;		///< Header received.
+	unsigned	missing;		///< Frames lost, from gaps in the sequence numbers.
+	uint8_t		seq;			///< Sequence number of the next frame.
+	uint32_t	written;		///< Events recorded since the ring was cleared.
+	uint16_t	dumped;			///< Events in the dump.
+	uint32_t	time;			///< RTC time of the dump, once recording stopped.
+	uint8_t		tasks;
+	uint8_t		queues;
+	Task_TypeDef				task[256];
+	BSP_TRACE_Queue_TypeDef		queue[256];
+	BSP_TRACE_Event_TypeDef		*event;
+	uint32_t	events;
+} Dump_TypeDef;
+
+static Dump_TypeDef dump;
+
+static uint16_t get16( const uint8_t *p )
+{
+	return ( uint16_t )( p[0] | ( p[1] << 8 ) );
+}
+
+static uint32_t get32( const uint8_t *p )
+{
+	return ( uint32_t )p[0] | ( ( uint32_t )p[1] << 8 ) | ( ( uint32_t )p[2] << 16 ) | ( ( uint32_t )p[3] << 24 );
+}
+
+static const char *taskName( uint8_t number, char *buf )
+{
+	if( dump.task[number].known )
+	{
+		return dump.task[number].name;
+	}
+	sprintf( buf, "#%u", ( unsigned )number );
+	return buf;
+}
+
+static unsigned latencyBin( uint16_t late )
+{
+	unsigned bin;
+
+	if( late < 4 )
+	{
+		return late;
+	}
+	for( bin = 4; bin < TRACEDEC_BINS - 1 && late >= ( 8u << ( bin - 4 ) ); bin++ );
+	return bin;
+}
+
+/*
+ * Prints the CPU share of each task. The time between two context switches
+ * is the share of the task switched in by the first; the last runs until the
+ * recording stopped.
+ */
+static void printTasks( void )
+{
+	uint64_t busy[256] = { 0 };
+	uint32_t switches[256] = { 0 };
+	uint32_t i, start = 0, last = 0;
+	int current = -1;
+	double span;
+	char buf[8];
+
+	for( i = 0; i < dump.events; i++ )
+	{
+		if( current >= 0 )
+		{
+			busy[current] += dump.event[i].time - last;
+		}
+		last = dump.event[i].time;
+
+		if( dump.event[i].type == BSP_TRACE_SWITCH )
+		{
+			if( current < 0 )
+			{
+				start = last;
+			}
+			current = dump.event[i].id;
+			switches[current]++;
+		}
+	}
+	if( current < 0 )
+	{
+		printf( "no context switches\n" );
+		return;
+	}
+	busy[current] += dump.time - last;
+	span = ( double )( uint32_t )( dump.time - start );
+
+	printf( "%-4s %-10s %4s %7s %9s %12s\n", "task", "name", "prio", "cpu %", "switches", "run time s" );
+	for( i = 0; i < 256; i++ )
+	{
+		if( !dump.task[i].known && switches[i] == 0 )
+		{
+			continue;
+		}
+		printf( "%-4u %-10s %4u %7.2f %9lu %12.3f\n", ( unsigned )i, taskName( ( uint8_t )i, buf ),
+				( unsigned )dump.task[i].priority, ( span > 0 ) ? 100.0 * ( double )busy[i] / span : 0.0,
+				( unsigned long )switches[i], dump.task[i].runTime / TRACEDEC_RATE );
+	}
+}
+
+/*
+ * Prints the operations on each queue and how full it was. A queue's items
+ * are known from its first operation in the dump; the mean is over the time
+ * from then until the recording stopped.
+ */
+static void printQueues( void )
+{
+	static struct
+	{
+		uint32_t sends, receives, fails, fromIsr, first, last;
+		uint16_t items, max;
+		uint64_t area;
+	} q[256];
+	const BSP_TRACE_Event_TypeDef *e;
+	uint32_t i;
+	uint8_t type;
+	int any = 0;
+
+	memset( q, 0, sizeof( q ) );
+	for( i = 0; i < dump.events; i++ )
+	{
+		e = &dump.event[i];
+		type = e->type & ~BSP_TRACE_FROMISR;
+		if( type < BSP_TRACE_SEND || type > BSP_TRACE_SENDFAIL )
+		{
+			continue;
+		}
+
+		if( q[e->id].sends + q[e->id].receives + q[e->id].fails == 0 )
+		{
+			q[e->id].first = e->time;
+		}
+		else
+		{
+			q[e->id].area += ( uint64_t )q[e->id].items * ( uint32_t )( e->time - q[e->id].last );
+		}
+		q[e->id].last = e->time;
+		q[e->id].items = e->value;
+		if( e->value > q[e->id].max )
+		{
+			q[e->id].max = e->value;
+		}
+
+		if( type == BSP_TRACE_SEND )
+		{
+			q[e->id].sends++;
+		}
+		else if( type == BSP_TRACE_RECEIVE )
+		{
+			q[e->id].receives++;
+		}
+		else
+		{
+			q[e->id].fails++;
+		}
+		if( e->type & BSP_TRACE_FROMISR )
+		{
+			q[e->id].fromIsr++;
+		}
+	}
+
+	printf( "%-5s %-9s %6s %8s %8s %6s %7s %5s %6s\n", "queue", "type", "length", "sends", "receives", "full", "fromISR", "max", "mean" );
+	for( i = 0; i < 256; i++ )
+	{
+		if( q[i].sends + q[i].receives + q[i].fails == 0 )
+		{
+			continue;
+		}
+		any = 1;
+		q[i].area += ( uint64_t )q[i].items * ( uint32_t )( dump.time - q[i].last );
+		printf( "%-5u %-9s %6u %8lu %8lu %6lu %7lu %5u %6.2f\n", ( unsigned )i,
+				( i != 0 && i <= dump.queues ) ? NAME( queueTypes, dump.queue[i].type ) : "?",
+				( unsigned )dump.queue[i].length, ( unsigned long )q[i].sends, ( unsigned long )q[i].receives,
+				( unsigned long )q[i].fails, ( unsigned long )q[i].fromIsr, ( unsigned )q[i].max,
+				( dump.time != q[i].first ) ? ( double )q[i].area / ( uint32_t )( dump.time - q[i].first ) : ( double )q[i].items );
+	}
+	if( !any )
+	{
+		printf( "no queue operations\n" );
+	}
+}
+
+/*
+ * Prints a histogram of the lateness of each interrupt, in RTC counts.
+ */
+static void printInterrupts( void )
+{
+	static const char *binNames[TRACEDEC_BINS] = { "0", "1", "2", "3", "4-7", "8-15", "16-31", "32-63", "64+" };
+	static uint32_t hist[256][TRACEDEC_BINS];
+	uint32_t count[256] = { 0 };
+	uint16_t worst[256] = { 0 };
+	uint32_t i, b, peak;
+	int any = 0;
+
+	memset( hist, 0, sizeof( hist ) );
+	for( i = 0; i < dump.events; i++ )
+	{
+		if( dump.event[i].type != BSP_TRACE_ISR )
+		{
+			continue;
+		}
+		hist[dump.event[i].id][latencyBin( dump.event[i].value )]++;
+		count[dump.event[i].id]++;
+		if( dump.event[i].value > worst[dump.event[i].id] )
+		{
+			worst[dump.event[i].id] = dump.event[i].value;
+		}
+	}
+
+	for( i = 0; i < 256; i++ )
+	{
+		if( count[i] == 0 )
+		{
+			continue;
+		}
+		any = 1;
+
+		printf( "IRQ %u%s: %lu interrupts, worst %u counts (%.0f us) late\n", ( unsigned )i, ( i == 30 ) ? " (RTC tick)" : "",
+				( unsigned long )count[i], ( unsigned )worst[i], worst[i] * 1e6 / TRACEDEC_RATE );
+		for( b = 0, peak = 1; b < TRACEDEC_BINS; b++ )
+		{
+			if( hist[i][b] > peak )
+			{
+				peak = hist[i][b];
+			}
+		}
+		for( b = 0; b < TRACEDEC_BINS; b++ )
+		{
+			printf( "  %6s counts %8lu %.*s\n", binNames[b], ( unsigned long )hist[i][b],
+					( int )( ( hist[i][b] * TRACEDEC_BAR + peak - 1 ) / peak ),
+					"########################################" );
+		}
+	}
+	if( !any )
+	{
+		printf( "no interrupt latencies\n" );
+	}
+}
+
+/*
+ * Prints the items in each queue after each operation, in seconds from the
+ * first event.
+ */
+static void printTimeline( const char *path )
+{
+	static const char *ops[] = { "?", "?", "send", "receive", "full" };
+	const BSP_TRACE_Event_TypeDef *e;
+	uint32_t i;
+
+	for( i = 0; i < dump.events; i++ )
+	{
+		e = &dump.event[i];
+		if( ( e->type & ~BSP_TRACE_FROMISR ) < BSP_TRACE_SEND || ( e->type & ~BSP_TRACE_FROMISR ) > BSP_TRACE_SENDFAIL )
+		{
+			continue;
+		}
+		printf( "%s,%.6f,%u,%s,%s,%u\n", path, ( uint32_t )( e->time - dump.event[0].time ) / TRACEDEC_RATE,
+				( unsigned )e->id, NAME( ops, e->type & ~BSP_TRACE_FROMISR ), ( e->type & BSP_TRACE_FROMISR ) ? "isr" : "task",
+				( unsigned )e->value );
+	}
+}
+
+/*
+ * Prints a complete dump and clears it for the next. Returns 1 if frames of
+ * it were lost.
+ */
+static unsigned finishDump( const char *path, int timeline )
+{
+	unsigned bad;
+
+	if( !dump.started )
+	{
+		return 0;
+	}
+
+	// The last frames of the dump were lost
+	if( dump.events < dump.dumped && dump.missing == 0 )
+	{
+		dump.missing = 1;
+	}
+	if( dump.missing != 0 )
+	{
+		fprintf( stderr, "%s: %u frames of a dump lost, %lu of %u events received\n", path, dump.missing,
+				( unsigned long )dump.events, ( unsigned )dump.dumped );
+	}
+
+	if( timeline )
+	{
+		printTimeline( path );
+	}
+	else
+	{
+		printf( "# %s: %u events of %lu recorded, %.3f s", path, ( unsigned )dump.dumped, ( unsigned long )dump.written,
+				( dump.events != 0 ) ? ( uint32_t )( dump.time - dump.event[0].time ) / TRACEDEC_RATE : 0.0 );
+		printf( ", %u tasks, %u queues\n", ( unsigned )dump.tasks, ( unsigned )dump.queues );
+		printTasks();
+		printf( "\n" );
+		printQueues();
+		printf( "\n" );
+		printInterrupts();
+		printf( "\n" );
+	}
+
+	bad = ( dump.missing != 0 ) ? 1 : 0;
+	free( dump.event );
+	memset( &dump, 0, sizeof( dump ) );
+	return bad;
+}
+
+/*
+ * Adds a trace frame to the dump. Returns 1 if a dump was printed with
+ * frames missing.
+ */
+static unsigned addFrame( const char *path, const FSW_LINK_Frame_TypeDef *frame, int timeline )
+{
+	const uint8_t *p = frame->payload;
+	unsigned bad = 0;
+	uint32_t i, first;
+	uint8_t number;
+
+	if( frame->len == 0 )
+	{
+		return 0;
+	}
+
+	if( p[0] == TRACEDEC_HEADER && frame->len >= 13 )
+	{
+		bad = finishDump( path, timeline );
+		dump.started = 1;
+		dump.written = get32( &p[1] );
+		dump.dumped = get16( &p[5] );
+		dump.time = get32( &p[7] );
+		dump.tasks = p[11];
+		dump.queues = p[12];
+		dump.event = malloc( ( dump.dumped + 1 ) * sizeof( BSP_TRACE_Event_TypeDef ) );
+		dump.seq = ( uint8_t )( frame->seq + 1 );
+		return bad;
+	}
+
+	if( !dump.started )
+	{
+		return 0;
+	}
+	if( frame->seq != dump.seq )
+	{
+		dump.missing += ( uint8_t )( frame->seq - dump.seq );
+	}
+	dump.seq = ( uint8_t )( frame->seq + 1 );
+
+	switch( p[0] )
+	{
+	case TRACEDEC_TASKS:
+		for( i = 1; i + TRACEDEC_TASKLEN <= frame->len; i += TRACEDEC_TASKLEN )
+		{
+			number = p[i];
+			dump.task[number].known = 1;
+			dump.task[number].priority = p[i + 1];
+			dump.task[number].runTime = get32( &p[i + 2] );
+			memcpy( dump.task[number].name, &p[i + 6], TRACEDEC_NAMELEN );
+			dump.task[number].name[TRACEDEC_NAMELEN] = '\0';
+		}
+		break;
+
+	case TRACEDEC_QUEUES:
+		number = p[1];
+		for( i = 2; i + 3 <= frame->len; i += 3, number++ )
+		{
+			dump.queue[number].length = get16( &p[i] );
+			dump.queue[number].type = p[i + 2];
+		}
+		break;
+
+	case TRACEDEC_EVENTS:
+		for( i = 1; i + TRACEDEC_EVENTLEN <= frame->len && dump.events < dump.dumped; i += TRACEDEC_EVENTLEN )
+		{
+			first = dump.events++;
+			dump.event[first].time = get32( &p[i] );
+			dump.event[first].type = p[i + 4];
+			dump.event[first].id = p[i + 5];
+			dump.event[first].value = get16( &p[i + 6] );
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * Decodes the dumps in one capture. Returns the number of dumps with frames
+ * missing.
+ */
+static unsigned decodeFile( const char *path, int timeline )
+{
+	FSW_LINK_Decoder_TypeDef dec;
+	FILE *file;
+	unsigned bad = 0;
+	int c;
+
+	file = fopen( path, "rb" );
+	if( file == NULL )
+	{
+		perror( path );
+		return 1;
+	}
+
+	FSW_LINK_rxInit( &dec );
+	while( ( c = fgetc( file ) ) != EOF )
+	{
+		if( FSW_LINK_rxByte( &dec, ( uint8_t )c ) == linkRxFrame && dec.frame.id == TRACEDEC_ID )
+		{
+			bad += addFrame( path, &dec.frame, timeline );
+		}
+	}
+	bad += finishDump( path, timeline );
+
+	fclose( file );
+	return bad;
+}
+
+int main( int argc, char *argv[] )
+{
+	unsigned bad = 0;
+	int timeline = 0;
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "q" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'q':	timeline = 1;	break;
+		default:
+			fprintf( stderr, "usage: %s [-q] file...\n", argv[0] );
+			return 2;
+		}
+	}
+
+	if( optind >= argc )
+	{
+		fprintf( stderr, "usage: %s [-q] file...\n", argv[0] );
+		return 2;
+	}
+
+	if( timeline )
+	{
+		printf( "file,time,queue,operation,from,items\n" );
+	}
+
+	for( ; optind < argc; optind++ )
+	{
+		bad += decodeFile( argv[optind], timeline );
+	}
+
+	return ( bad != 0 ) ? 1 : 0;
+}
@@ -0,0 +1,533 @@
+/***************************************************************************//**
+ * @file	uartbench.c
+ * @brief	Host benchmark of the UART receive and transmit paths.
+ *
+ * Runs bsp_uart.c against the line and DMA model in uartmodel.c from a
+ * FreeRTOS task. Terminal traffic, frames of 1 to 1024 bytes with an idle
+ * line between them, is replayed at each baud rate and read back the way
+ * COMMS_uartRx reads it: waiting on the receive ring a tick at a time and
+ * ending a frame when the line has been idle for COMMS_UART_IDLE_MS. Every
+ * byte must arrive in order and every frame must be found at its length. The
+ * modelled interrupts and CPU time of the DMA ring are reported against the
+ * interrupt per byte it replaces.
+ *
+ * A burst longer than the ring is then sent while the task is held off, and
+ * the bytes lost must be counted as overruns and the newest kept.
+ *
+ * The transmit queues are loaded by three tasks sending messages of up to
+ * 606 bytes on the debug UART and a fourth on the miscellaneous UART. Every
+ * message must leave whole, in order and uncorrupted, and the line rate
+ * reached and the modelled CPU time are reported against callers busy
+ * waiting for their transfers. A message too large for the free buffers,
+ * queued without waiting, must be cut short and the rest counted as dropped.
+ *
+ * Usage: fsw_uartbench [-n frames] [-m messages] [-s seed]
+ *   -n  frames replayed at each baud rate (default 30)
+ *   -m  messages sent by each transmitting task (default 40)
+ *   -s  seed of the frame lengths, gaps and messages (default 1)
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "bsp_uart.h"
+#include "bsp_dma.h"
+#include "comms.h"
+#include "uartmodel.h"
+
+#define UARTBENCH_MAXFRAMES		1024		///< Most frames replayed at one baud rate.
+#define UARTBENCH_MAXLEN		1024		///< Longest frame.
+#define UARTBENCH_BURST			2048		///< Bytes of the overrun test.
+#define UARTBENCH_PRODUCERS		3			///< Tasks sending on the debug UART; one more sends on the miscellaneous UART.
+#define UARTBENCH_HEADER		6			///< Message header: sync, task, sequence and length.
+#define UARTBENCH_MSGMAX		600			///< Longest message payload.
+#define UARTBENCH_SYNC			0xA5
+
+static uint32_t benchFrames = 30;
+static uint32_t benchMessages = 40;
+static uint32_t benchSeed = 1;
+static int      benchResult = 1;
+
+static const uint32_t baudrates[] = { 115200, 460800, 921600 };
+
+static uint16_t frameLen[UARTBENCH_MAXFRAMES];
+static uint8_t  frameData[UARTBENCH_MAXLEN];
+
+static xSemaphoreHandle producersDone;
+
+// FUNCTIONS *******************************************************************
+
+/*
+ * Reads what the ring holds and checks it against the line. Returns the
+ * bytes read, or -1 if one is wrong.
+ */
+static int32_t UARTBENCH_read( uint32_t *position )
+{
+	uint8_t buff[64];
+	uint16_t len, i;
+	int32_t total = 0;
+
+	while( ( len = BSP_UART_rxRead( buff, sizeof( buff ) ) ) > 0 )
+	{
+		HOST_UART_chargeRead( len );
+
+		for( i = 0; i < len; i++ )
+		{
+			if( buff[i] != HOST_UART_lineByte( *position + i ) )
+			{
+				printf( "bad data at byte %lu\n", ( unsigned long )( *position + i ) );
+				return -1;
+			}
+		}
+		*position += len;
+		total += len;
+	}
+
+	return total;
+}
+
+/*
+ * Replays the frames at a baud rate, finds them by the idle line and reports
+ * the modelled cost.
+ */
+static int UARTBENCH_replay( uint32_t baudrate )
+{
+	BSP_UART_RxStats_TypeDef before, after;
+	portTickType lastRx = 0, start;
+	uint32_t n, i, position = 0, found = 0, len = 0, gap;
+	double charsPerTick = baudrate / 10.0 / configTICK_RATE_HZ;
+	double kib, lineS, legacyCpu, dmaCpu;
+	int32_t got;
+
+	BSP_UART_getRxStats( &before );
+	HOST_UART_Init( baudrate );
+
+	// Idle gaps of three to six ticks, so each is longer than the idle time with a tick to spare
+	for( n = 0; n < benchFrames; n++ )
+	{
+		frameLen[n] = 1 + rand() % UARTBENCH_MAXLEN;
+		for( i = 0; i < frameLen[n]; i++ )
+		{
+			frameData[i] = ( uint8_t )rand();
+		}
+		gap = ( uint32_t )( charsPerTick * ( COMMS_UART_IDLE_MS / portTICK_RATE_MS + 1 + rand() % 4 ) );
+		HOST_UART_send( frameData, frameLen[n], gap );
+	}
+
+	start = xTaskGetTickCount();
+	while( found < benchFrames )
+	{
+		BSP_UART_rxWait( COMMS_UART_POLL_MS / portTICK_RATE_MS );
+
+		got = UARTBENCH_read( &position );
+		if( got < 0 )
+		{
+			return 1;
+		}
+		if( got > 0 )
+		{
+			len += got;
+			lastRx = xTaskGetTickCount();
+		}
+		else if( len > 0 && xTaskGetTickCount() - lastRx >= COMMS_UART_IDLE_MS / portTICK_RATE_MS )
+		{
+			if( len != frameLen[found] )
+			{
+				printf( "frame %lu of %lu bytes found as %lu\n", ( unsigned long )found,
+						( unsigned long )frameLen[found], ( unsigned long )len );
+				return 1;
+			}
+			found++;
+			len = 0;
+		}
+
+		if( xTaskGetTickCount() - start > 60 * configTICK_RATE_HZ )
+		{
+			printf( "%lu of %lu frames found\n", ( unsigned long )found, ( unsigned long )benchFrames );
+			return 1;
+		}
+	}
+
+	BSP_UART_getRxStats( &after );
+	if( after.bytes - before.bytes != HOST_uartStats.bytes || after.overruns != before.overruns ||
+		after.interrupts - before.interrupts != HOST_uartStats.interrupts || HOST_uartStats.lost != 0 )
+	{
+		printf( "counters FAILED: %lu bytes read, %lu overruns, %lu lost\n", ( unsigned long )( after.bytes - before.bytes ),
+				( unsigned long )( after.overruns - before.overruns ), ( unsigned long )HOST_uartStats.lost );
+		return 1;
+	}
+
+	// CPU load while the line is busy, as it would be with the line always busy
+	kib = HOST_uartStats.bytes / 1024.0;
+	lineS = HOST_uartStats.lineNs * 1e-9;
+	legacyCpu = HOST_uartStats.legacyNs * 1e-9;
+	dmaCpu = HOST_uartStats.cpuNs * 1e-9;
+	printf( "%7lu %7lu %6lu %9.1f %7.1f %9.1f %7.1f %8.2f %% %6.2f %%\n", ( unsigned long )baudrate,
+			( unsigned long )HOST_uartStats.bytes, ( unsigned long )found,
+			HOST_uartStats.bytes / kib, HOST_uartStats.interrupts / kib,
+			legacyCpu * 1e6 / kib, dmaCpu * 1e6 / kib,
+			100.0 * legacyCpu / lineS, 100.0 * dmaCpu / lineS );
+
+	return 0;
+}
+
+/*
+ * Sends a burst longer than the ring while the task sleeps, then checks the
+ * bytes overwritten are counted and the newest are read in order.
+ */
+static int UARTBENCH_overrun( void )
+{
+	static uint8_t burst[UARTBENCH_BURST];
+	BSP_UART_RxStats_TypeDef before, after;
+	uint32_t i, lost;
+	uint16_t got;
+	int result;
+
+	for( i = 0; i < UARTBENCH_BURST; i++ )
+	{
+		burst[i] = ( uint8_t )rand();
+	}
+
+	BSP_UART_getRxStats( &before );
+	HOST_UART_Init( baudrates[0] );
+	HOST_UART_send( burst, UARTBENCH_BURST, 0 );
+	vTaskDelay( ( portTickType )( UARTBENCH_BURST * 10.0 * configTICK_RATE_HZ / baudrates[0] ) + 2 );
+
+	// Only the last ring of bytes is still there
+	got = BSP_UART_rxRead( frameData, UARTBENCH_MAXLEN );
+	BSP_UART_getRxStats( &after );
+	lost = after.overruns - before.overruns;
+
+	for( i = 0; i < got; i++ )
+	{
+		if( frameData[i] != HOST_UART_lineByte( lost + i ) )
+		{
+			printf( "overrun: bad data at byte %lu\n", ( unsigned long )( lost + i ) );
+			return 1;
+		}
+	}
+
+	result = !( HOST_UART_pending() == 0 && got == BSP_UART_RXRING && lost == UARTBENCH_BURST - BSP_UART_RXRING );
+	printf( "overrun: %u byte burst, %u read, %lu counted as overruns %s\n", UARTBENCH_BURST,
+			got, ( unsigned long )lost, result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+/*
+ * Payload byte of a message.
+ */
+static uint8_t UARTBENCH_payload( uint8_t producer, uint16_t seq, uint16_t i )
+{
+	return ( uint8_t )( producer * 61 + seq * 7 + i * 13 + ( i >> 8 ) );
+}
+
+/*
+ * Parses the messages a UART sent and checks each producer's arrived whole
+ * and in order.
+ */
+static int UARTBENCH_check( USART_TypeDef *usart, uint8_t first, uint8_t count )
+{
+	const uint8_t *line;
+	uint32_t sent, pos = 0;
+	uint16_t next[UARTBENCH_PRODUCERS + 1] = { 0 };
+	uint16_t seq, len, i;
+	uint8_t id;
+
+	sent = HOST_UART_txLine( usart, &line );
+	while( pos < sent )
+	{
+		id = line[pos + 1];
+		if( pos + UARTBENCH_HEADER > sent || line[pos] != UARTBENCH_SYNC || id < first || id >= first + count )
+		{
+			printf( "bad message header at byte %lu\n", ( unsigned long )pos );
+			return 1;
+		}
+		seq = line[pos + 2] | ( line[pos + 3] << 8 );
+		len = line[pos + 4] | ( line[pos + 5] << 8 );
+		if( seq != next[id] || pos + UARTBENCH_HEADER + len > sent )
+		{
+			printf( "task %u message %u out of order or cut short\n", id, seq );
+			return 1;
+		}
+		pos += UARTBENCH_HEADER;
+		for( i = 0; i < len; i++ )
+		{
+			if( line[pos + i] != UARTBENCH_payload( id, seq, i ) )
+			{
+				printf( "task %u message %u: bad data at byte %u\n", id, seq, i );
+				return 1;
+			}
+		}
+		pos += len;
+		next[id]++;
+	}
+
+	for( id = first; id < first + count; id++ )
+	{
+		if( next[id] != benchMessages )
+		{
+			printf( "task %u: %u of %lu messages sent\n", id, next[id], ( unsigned long )benchMessages );
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Queues messages as fast as the transmit queue takes them, a few at a time.
+ */
+static void UARTBENCH_producer( void *pvParameters )
+{
+	uint8_t id = ( uint8_t )( uintptr_t )pvParameters;
+	USART_TypeDef *usart = ( id < UARTBENCH_PRODUCERS ) ? BSP_UART_DEBUG : BSP_UART_MISC;
+	uint8_t msg[UARTBENCH_HEADER + UARTBENCH_MSGMAX];
+	uint16_t seq, len, i;
+
+	for( seq = 0; seq < benchMessages; seq++ )
+	{
+		len = 1 + rand() % UARTBENCH_MSGMAX;
+		msg[0] = UARTBENCH_SYNC;
+		msg[1] = id;
+		msg[2] = ( uint8_t )seq;
+		msg[3] = ( uint8_t )( seq >> 8 );
+		msg[4] = ( uint8_t )len;
+		msg[5] = ( uint8_t )( len >> 8 );
+		for( i = 0; i < len; i++ )
+		{
+			msg[UARTBENCH_HEADER + i] = UARTBENCH_payload( id, seq, i );
+		}
+
+		BSP_UART_txBuffer( usart, msg, UARTBENCH_HEADER + len, false );
+
+		if( seq % 4 == 3 )
+		{
+			vTaskDelay( 1 );
+		}
+	}
+
+	xSemaphoreGive( producersDone );
+	vTaskDelete( NULL );
+}
+
+/*
+ * Loads both transmit queues from several tasks, checks what the lines carried
+ * and reports the line rate reached and the modelled CPU time.
+ */
+static int UARTBENCH_tx( void )
+{
+	BSP_UART_TxStats_TypeDef debug, misc;
+	portTickType start, ticks;
+	uint32_t i;
+	double lineRate;
+	int result;
+
+	HOST_UART_Init( baudrates[1] );
+	producersDone = xSemaphoreCreateCounting( UARTBENCH_PRODUCERS + 1, 0 );
+
+	start = xTaskGetTickCount();
+	for( i = 0; i <= UARTBENCH_PRODUCERS; i++ )
+	{
+		xTaskCreate( UARTBENCH_producer, ( const signed char * )"PRODUCER", 1024, ( void * )( uintptr_t )i, 1 + i % 2, NULL );
+	}
+	for( i = 0; i <= UARTBENCH_PRODUCERS; i++ )
+	{
+		xSemaphoreTake( producersDone, portMAX_DELAY );
+	}
+	BSP_UART_txFlush( BSP_UART_DEBUG, portMAX_DELAY );
+	BSP_UART_txFlush( BSP_UART_MISC, portMAX_DELAY );
+	ticks = xTaskGetTickCount() - start;
+
+	BSP_UART_getTxStats( BSP_UART_DEBUG, &debug );
+	BSP_UART_getTxStats( BSP_UART_MISC, &misc );
+	lineRate = debug.bytes * 10.0 / baudrates[1] / ( ticks * portTICK_RATE_MS * 1e-3 );
+
+	printf( "\nTransmit queues, %u tasks on the debug UART and 1 on the miscellaneous UART, %lu baud (modelled)\n",
+			UARTBENCH_PRODUCERS, ( unsigned long )baudrates[1] );
+	printf( "debug: %lu messages, %lu bytes in %lu ms, %.0f %% of the line rate\n",
+			( unsigned long )debug.messages, ( unsigned long )debug.bytes,
+			( unsigned long )( ticks * portTICK_RATE_MS ), 100.0 * lineRate );
+	printf( "       %lu transfers, at most %u of %u buffers queued, %lu waits for a buffer (%lu ticks), %lu bytes dropped\n",
+			( unsigned long )debug.transfers, debug.maxQueued, BSP_UART_TXSLOTS,
+			( unsigned long )debug.waits, ( unsigned long )debug.waitTicks, ( unsigned long )debug.dropped );
+	printf( "misc:  %lu messages, %lu bytes, %lu transfers\n",
+			( unsigned long )misc.messages, ( unsigned long )misc.bytes, ( unsigned long )misc.transfers );
+	printf( "CPU time: busy waiting %.1f ms, queued %.1f ms\n",
+			HOST_uartStats.txNs * 1e-6, HOST_uartStats.txCpuNs * 1e-6 );
+
+	result = UARTBENCH_check( BSP_UART_DEBUG, 0, UARTBENCH_PRODUCERS ) ||
+			 UARTBENCH_check( BSP_UART_MISC, UARTBENCH_PRODUCERS, 1 ) ||
+			 debug.messages != UARTBENCH_PRODUCERS * benchMessages || misc.messages != benchMessages ||
+			 debug.dropped != 0 || misc.dropped != 0 ||
+			 debug.bytes + misc.bytes != HOST_uartStats.txBytes;
+	printf( "transmit order and data %s\n", result ? "FAILED" : "ok" );
+
+	vSemaphoreDelete( producersDone );
+
+	return result;
+}
+
+/*
+ * Queues a message larger than the transmit buffers without waiting, and
+ * checks the part that did not fit is dropped and counted.
+ */
+static int UARTBENCH_backpressure( void )
+{
+	static uint8_t big[2 * BSP_UART_TXSLOTS * BSP_UART_TXSLOTLEN];
+	BSP_UART_TxStats_TypeDef before, after;
+	uint16_t queued;
+	int result;
+
+	BSP_UART_getTxStats( BSP_UART_DEBUG, &before );
+	queued = BSP_UART_txQueue( BSP_UART_DEBUG, big, sizeof( big ), 0 );
+	BSP_UART_getTxStats( BSP_UART_DEBUG, &after );
+	BSP_UART_txFlush( BSP_UART_DEBUG, portMAX_DELAY );
+
+	result = !( queued == BSP_UART_TXSLOTS * BSP_UART_TXSLOTLEN && after.dropped - before.dropped == sizeof( big ) - queued );
+	printf( "backpressure: %u of %u bytes queued without waiting, %lu dropped %s\n", queued, ( unsigned )sizeof( big ),
+			( unsigned long )( after.dropped - before.dropped ), result ? "FAILED" : "ok" );
+
+	return result;
+}
+
+// TASKS ***********************************************************************
+
+static void UARTBENCH_task( void *pvParameters )
+{
+	uint32_t i;
+
+	BSP_DMA_Init();
+	BSP_UART_Init( BSP_UART_DEBUG );
+	BSP_UART_Init( BSP_UART_MISC );
+
+	printf( "Debug UART receive, %lu frames of 1 to %u bytes per baud rate (modelled)\n",
+			( unsigned long )benchFrames, UARTBENCH_MAXLEN );
+	printf( "                          interrupts/KiB    CPU us/KiB     CPU while receiving\n" );
+	printf( "   baud   bytes frames  per byte     DMA  per byte     DMA  per byte      DMA\n" );
+
+	benchResult = 0;
+	for( i = 0; i < sizeof( baudrates ) / sizeof( baudrates[0] ) && benchResult == 0; i++ )
+	{
+		benchResult |= UARTBENCH_replay( baudrates[i] );
+	}
+	if( benchResult == 0 )
+	{
+		benchResult |= UARTBENCH_overrun();
+	}
+	if( benchResult == 0 )
+	{
+		benchResult |= UARTBENCH_tx();
+	}
+	if( benchResult == 0 )
+	{
+		benchResult |= UARTBENCH_backpressure();
+	}
+
+	// The receiver holds EM1 for good; every transmission has released its hold
+	BSP_UART_txFlush( BSP_UART_DEBUG, portMAX_DELAY );
+	BSP_UART_txFlush( BSP_UART_MISC, portMAX_DELAY );
+	if( HOST_sleepHolds != 1 )
+	{
+		printf( "  EM1 holds %ld, expected 1\n", ( long )HOST_sleepHolds );
+		benchResult |= 1;
+	}
+	printf( "UART receive and transmit %s\n", benchResult ? "FAILED" : "ok" );
+
+	vTaskEndScheduler();
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int opt;
+
+	while( ( opt = getopt( argc, argv, "n:m:s:" ) ) != -1 )
+	{
+		switch( opt )
+		{
+		case 'n':	benchFrames = strtoul( optarg, NULL, 0 );	break;
+		case 'm':	benchMessages = strtoul( optarg, NULL, 0 );	break;
+		case 's':	benchSeed = strtoul( optarg, NULL, 0 );		break;
+		default:
+			fprintf( stderr, "usage: %s [-n frames] [-m messages] [-s seed]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( benchFrames == 0 || benchFrames > UARTBENCH_MAXFRAMES || benchMessages == 0 || benchMessages > 1000 )
+	{
+		fprintf( stderr, "frame or message count out of range\n" );
+		return 2;
+	}
+	srand( benchSeed );
+
+	xTaskCreate( UARTBENCH_task, ( const signed char * )"UARTBENCH", 1024, NULL, 2, NULL );
+	vTaskStartScheduler();
+
+	return benchResult;
+}
+
+/**********************************************************************************
+ * FreeRTOS functions
+ *********************************************************************************/
+
+void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName )
+{
+	fprintf( stderr, "stack overflow in task %s\n", pcTaskName );
+	abort();
+}
+
+// The line moves while the tasks are blocked, a tick at a time once it has caught up
+void vApplicationIdleHook( void )
+{
+	if( !HOST_UART_run() )
+	{
+		vPortWaitForTick();
+	}
+}
+
+// The host FreeRTOSConfig.h traces queues for the dispatch benchmark
+void vHostTraceQueueSend( void *pxQueue )
+{
+}
+
+void vHostTraceQueueSendFailed( void *pxQueue )
+{
+}
+
+void vHostTraceQueueReceive( void *pxQueue, const void *pvBuffer )
+{
+}
@@ -0,0 +1,535 @@
+/***************************************************************************//**
+ * @file	uartmodel.c
+ * @brief	Host UART and DMA model.
+ *
+ * Emulates the receive line of the debug UART and the parts of the DMA
+ * controller bsp_uart.c uses, behind the register blocks of uartmodel.h, so
+ * the driver runs unmodified on the host. The emlib DMA functions are
+ * implemented here on the driver's descriptor table: pointers are wider than
+ * the controller's registers on the host, so em_dma.c is not built.
+ *
+ * Bytes queued on the line arrive at the baud rate, measured against the RTOS
+ * tick, whenever HOST_UART_run is called, i.e. while the CPU is idle. The DMA
+ * writes each byte through the active descriptor, counting it down as the
+ * controller does, and takes the interrupt when a cycle completes. The CPU is
+ * charged for the interrupts and the reads of the ring, and a second time for
+ * an interrupt per byte, as the receive path it replaces would have taken.
+ *
+ * Transmit cycles take the line time of their bytes on each UART, one after
+ * the other, and the bytes are captured as the far end would see them. The
+ * CPU is charged for copying them into the transmit buffers and for the
+ * interrupt ending each cycle.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uartmodel.h"
+
+// CPU costs at the 48 MHz core clock
+#define UART_CPU_HZ			48000000.0
+#define UART_BYTE_CYCLES	120			///< Interrupt per byte: entry, reading RXDATA, the parser step and exit.
+#define UART_ISR_CYCLES		150			///< DMA interrupt: entry, the callback re-arming a half and exit.
+#define UART_WAKE_CYCLES	600			///< Semaphore given from the interrupt and switching to the task.
+#define UART_READ_CYCLES	200			///< Waking the task on its timeout and locating the DMA's position.
+#define UART_COPY_CYCLES	2			///< Copying a byte out of the ring, or into a transmit buffer.
+
+#define UART_LINELEN		( 1 << 20 )	///< Bytes the line can carry in one run of the model.
+#define UART_CHARBITS		10			///< Start, 8 data and stop bits.
+#define UART_PORTS			2			///< Debug and miscellaneous UARTs.
+
+#define DMA_CYCLE( descr )	( ( ( descr )->CTRL & _DMA_CTRL_CYCLE_CTRL_MASK ) >> _DMA_CTRL_CYCLE_CTRL_SHIFT )
+#define DMA_NMINUS1( descr )	( ( ( descr )->CTRL & _DMA_CTRL_N_MINUS_1_MASK ) >> _DMA_CTRL_N_MINUS_1_SHIFT )
+
+USART_TypeDef HOST_usart0;							///< Debug UART registers seen by the driver.
+USART_TypeDef HOST_usart2;							///< Miscellaneous UART registers seen by the driver.
+
+HOST_UART_Stats_TypeDef HOST_uartStats;
+
+extern DMA_DESCRIPTOR_TypeDef dmaControlBlock[];
+
+static uint8_t  line[UART_LINELEN];					// Bytes queued on the line
+static uint64_t lineSlot[UART_LINELEN];				// Character time each byte arrives at
+static uint32_t lineQueued;
+static uint32_t lineCarried;
+static uint64_t lineEnd;							// Character time after the last byte queued
+static double   charsPerTick;
+static double   charNs;
+static portTickType startTick;
+
+static DMA_CB_TypeDef *chanCb[DMA_CHAN_COUNT];		// Callbacks; the descriptors' USER word cannot hold a host pointer
+static bool     chanInt[DMA_CHAN_COUNT];
+static bool     chanAlt[DMA_CHAN_COUNT];			// Alternate descriptor active
+static uint32_t basicActive;						// Basic cycles started, one bit per channel
+static uint64_t basicDone[DMA_CHAN_COUNT];			// Character time a basic cycle ends at
+static int      basicPort[DMA_CHAN_COUNT];			// UART a basic cycle writes, or -1
+
+static uint8_t  txLine[UART_PORTS][UART_LINELEN];	// Bytes sent on each UART
+static uint32_t txSent[UART_PORTS];
+static uint64_t txFree[UART_PORTS];					// Character time each UART's line is free from
+static uint64_t txIsrTime;							// Character time of the transmission ending in the interrupt being taken
+static int      rxChannel = -1;						// Channel requested by the debug UART's received data
+
+// FUNCTIONS *******************************************************************
+
+static double UART_cyclesNs( uint32_t cycles )
+{
+	return cycles * 1.0e9 / UART_CPU_HZ;
+}
+
+static uint64_t UART_now( void )
+{
+	return ( uint64_t )( ( xTaskGetTickCount() - startTick ) * charsPerTick );
+}
+
+static int UART_port( USART_TypeDef *usart )
+{
+	return ( usart == &HOST_usart0 ) ? 0 : ( usart == &HOST_usart2 ) ? 1 : -1;
+}
+
+static DMA_DESCRIPTOR_TypeDef *DMA_descr( unsigned int channel, bool primary )
+{
+	return primary ? &dmaControlBlock[channel] : &dmaControlBlock[16 + channel];
+}
+
+/*
+ * End address of a transfer, as the controller expects it in the descriptor.
+ */
+static void *DMA_end( void *start, uint32_t ctrl, uint32_t incMask, uint32_t incShift, unsigned int nMinus1 )
+{
+	uint32_t inc = ( ctrl & incMask ) >> incShift;
+
+	if( inc == 3 )		// _DMA_CTRL_SRC_INC_NONE, _DMA_CTRL_DST_INC_NONE
+	{
+		return start;
+	}
+	return ( uint8_t * )start + ( nMinus1 << inc );
+}
+
+/*
+ * Sets up a descriptor as DMA_Prepare and DMA_RefreshPingPong do. NULL
+ * addresses leave those of the previous cycle.
+ */
+static void DMA_setup( unsigned int channel, bool primary, uint32_t cycleCtrl, void *dst, void *src, unsigned int nMinus1 )
+{
+	DMA_DESCRIPTOR_TypeDef *descr = DMA_descr( channel, primary );
+	uint32_t tmp;
+
+	if( src )
+	{
+		descr->SRCEND = DMA_end( src, descr->CTRL, _DMA_CTRL_SRC_INC_MASK, _DMA_CTRL_SRC_INC_SHIFT, nMinus1 );
+	}
+	if( dst )
+	{
+		descr->DSTEND = DMA_end( dst, descr->CTRL, _DMA_CTRL_DST_INC_MASK, _DMA_CTRL_DST_INC_SHIFT, nMinus1 );
+	}
+
+	tmp  = descr->CTRL & ~( _DMA_CTRL_CYCLE_CTRL_MASK | _DMA_CTRL_N_MINUS_1_MASK );
+	tmp |= nMinus1 << _DMA_CTRL_N_MINUS_1_SHIFT;
+	tmp |= cycleCtrl << _DMA_CTRL_CYCLE_CTRL_SHIFT;
+	descr->CTRL = tmp;
+}
+
+/*
+ * Takes the interrupt of a completed cycle as DMA_IRQHandler does. A task
+ * woken by the callback runs once the interrupt has returned.
+ */
+static void DMA_interrupt( unsigned int channel )
+{
+	DMA_CB_TypeDef *cb = chanCb[channel];
+	uint32_t primaryCpy;
+
+	if( !chanInt[channel] || !cb )
+	{
+		return;
+	}
+
+	if( ( int )channel == rxChannel )
+	{
+		HOST_uartStats.interrupts++;
+		HOST_uartStats.cpuNs += UART_cyclesNs( UART_ISR_CYCLES + UART_WAKE_CYCLES );
+	}
+	else
+	{
+		HOST_uartStats.txInterrupts++;
+		HOST_uartStats.txCpuNs += UART_cyclesNs( UART_ISR_CYCLES + UART_WAKE_CYCLES );
+	}
+
+	taskENTER_CRITICAL();
+	primaryCpy = cb->primary;
+	cb->primary ^= 1;
+	if( cb->cbFunc )
+	{
+		cb->cbFunc( channel, ( bool )primaryCpy, cb->userPtr );
+	}
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Writes a received byte through the active descriptor of the receive
+ * channel, writing back the count as the controller does after each
+ * arbitration. Returns true if the byte completed the cycle.
+ */
+static bool DMA_rxByte( uint8_t byte )
+{
+	DMA_DESCRIPTOR_TypeDef *descr;
+	uint32_t cycle, nMinus1;
+	uint8_t *dst;
+
+	if( rxChannel < 0 )
+	{
+		HOST_uartStats.lost++;
+		return false;
+	}
+
+	descr = DMA_descr( rxChannel, !chanAlt[rxChannel] );
+	cycle = DMA_CYCLE( descr );
+	if( cycle == _DMA_CTRL_CYCLE_CTRL_INVALID )
+	{
+		// The channel has stopped; the byte overflows the USART
+		HOST_uartStats.lost++;
+		return false;
+	}
+
+	nMinus1 = DMA_NMINUS1( descr );
+	dst = ( uint8_t * )descr->DSTEND - nMinus1;
+	*dst = byte;
+
+	if( nMinus1 > 0 )
+	{
+		descr->CTRL = ( descr->CTRL & ~_DMA_CTRL_N_MINUS_1_MASK ) | ( ( nMinus1 - 1 ) << _DMA_CTRL_N_MINUS_1_SHIFT );
+		return false;
+	}
+
+	// Cycle complete: a ping-pong cycle carries on with the other descriptor
+	descr->CTRL &= ~_DMA_CTRL_CYCLE_CTRL_MASK;
+	if( cycle == _DMA_CTRL_CYCLE_CTRL_PINGPONG )
+	{
+		chanAlt[rxChannel] = !chanAlt[rxChannel];
+	}
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Empties the line, resets the statistics and starts the line clock.
+ *
+ * @param[in] baudrate
+ *   Baud rate of the line, 8-N-1.
+ ******************************************************************************/
+void HOST_UART_Init( uint32_t baudrate )
+{
+	lineQueued = 0;
+	lineCarried = 0;
+	lineEnd = 0;
+	memset( txSent, 0, sizeof( txSent ) );
+	memset( txFree, 0, sizeof( txFree ) );
+	charsPerTick = ( double )baudrate / UART_CHARBITS / configTICK_RATE_HZ;
+	charNs = UART_CHARBITS * 1.0e9 / baudrate;
+	startTick = xTaskGetTickCount();
+	memset( &HOST_uartStats, 0, sizeof( HOST_uartStats ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Queues bytes on the line. They follow the bytes already queued, or the
+ * present if the line is idle, after an idle gap.
+ *
+ * @param[in] data
+ *   Bytes to send.
+ * @param[in] len
+ *   Number of bytes.
+ * @param[in] gapChars
+ *   Idle line before the first byte, in character times.
+ ******************************************************************************/
+void HOST_UART_send( const uint8_t *data, uint32_t len, uint32_t gapChars )
+{
+	uint64_t now = UART_now();
+	uint32_t i;
+
+	if( lineEnd < now )
+	{
+		lineEnd = now;
+	}
+	lineEnd += gapChars;
+
+	for( i = 0; i < len && lineQueued < UART_LINELEN; i++ )
+	{
+		line[lineQueued] = data[i];
+		lineSlot[lineQueued++] = lineEnd++;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns the bytes queued that the line has not yet carried.
+ ******************************************************************************/
+uint32_t HOST_UART_pending( void )
+{
+	return lineQueued - lineCarried;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns the byte the line carried at a position, counted from
+ * HOST_UART_Init.
+ ******************************************************************************/
+uint8_t HOST_UART_lineByte( uint32_t position )
+{
+	return ( position < lineQueued ) ? line[position] : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Completes the transmissions whose bytes have left and delivers the bytes
+ * due by the current tick, until one of them raises an interrupt. Called
+ * from the idle hook, so the line moves while the tasks are blocked, and
+ * returns after an interrupt so a task it woke runs first.
+ *
+ * @return
+ *   Returns true if it stopped at an interrupt, with more bytes possibly due.
+ ******************************************************************************/
+bool HOST_UART_run( void )
+{
+	uint64_t now = UART_now();
+	DMA_DESCRIPTOR_TypeDef *descr;
+	unsigned int channel, n;
+	int port;
+
+	// Transmissions whose last byte has left
+	for( channel = 0; channel < DMA_CHAN_COUNT; channel++ )
+	{
+		if( ( basicActive & ( 1UL << channel ) ) && basicDone[channel] <= now )
+		{
+			basicActive &= ~( 1UL << channel );
+			descr = DMA_descr( channel, !chanAlt[channel] );
+			port = basicPort[channel];
+			n = DMA_NMINUS1( descr ) + 1;
+			if( port >= 0 && txSent[port] + n <= UART_LINELEN )
+			{
+				memcpy( &txLine[port][txSent[port]], ( uint8_t * )descr->SRCEND - ( n - 1 ), n );
+				txSent[port] += n;
+			}
+			descr->CTRL &= ~_DMA_CTRL_CYCLE_CTRL_MASK;
+			txIsrTime = basicDone[channel];
+			DMA_interrupt( channel );
+			txIsrTime = 0;
+			return true;
+		}
+	}
+
+	while( lineCarried < lineQueued && lineSlot[lineCarried] < now )
+	{
+		HOST_uartStats.bytes++;
+		HOST_uartStats.lineNs += charNs;
+		HOST_uartStats.legacyNs += UART_cyclesNs( UART_BYTE_CYCLES );
+
+		if( DMA_rxByte( line[lineCarried++] ) )
+		{
+			DMA_interrupt( rxChannel );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Charges the CPU for a read of the ring by the receiving task.
+ *
+ * @param[in] bytes
+ *   Bytes copied out of the ring.
+ ******************************************************************************/
+void HOST_UART_chargeRead( uint32_t bytes )
+{
+	HOST_uartStats.reads++;
+	HOST_uartStats.cpuNs += UART_cyclesNs( UART_READ_CYCLES + bytes * UART_COPY_CYCLES );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Returns the bytes a UART has sent since HOST_UART_Init.
+ *
+ * @param[in] usart
+ *   UART registers, as the driver addresses them.
+ * @param[out] data
+ *   Set to the bytes sent.
+ * @return
+ *   Number of bytes sent.
+ ******************************************************************************/
+uint32_t HOST_UART_txLine( USART_TypeDef *usart, const uint8_t **data )
+{
+	int port = UART_port( usart );
+
+	if( port < 0 )
+	{
+		return 0;
+	}
+	*data = txLine[port];
+	return txSent[port];
+}
+
+// EMLIB STAND-INS *************************************************************
+
+void DMA_Init( DMA_Init_TypeDef *init )
+{
+	memset( chanCb, 0, sizeof( chanCb ) );
+	basicActive = 0;
+	rxChannel = -1;
+}
+
+void DMA_CfgChannel( unsigned int channel, DMA_CfgChannel_TypeDef *cfg )
+{
+	chanCb[channel] = cfg->cb;
+	chanInt[channel] = cfg->enableInt;
+
+	if( cfg->select == DMAREQ_USART0_RXDATAV )
+	{
+		rxChannel = channel;
+	}
+}
+
+void DMA_CfgDescr( unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg )
+{
+	DMA_descr( channel, primary )->CTRL =
+		( cfg->dstInc << _DMA_CTRL_DST_INC_SHIFT ) |
+		( cfg->size << _DMA_CTRL_DST_SIZE_SHIFT ) |
+		( cfg->srcInc << _DMA_CTRL_SRC_INC_SHIFT ) |
+		( cfg->size << _DMA_CTRL_SRC_SIZE_SHIFT ) |
+		( ( uint32_t )( cfg->hprot ) << _DMA_CTRL_SRC_PROT_CTRL_SHIFT ) |
+		( cfg->arbRate << _DMA_CTRL_R_POWER_SHIFT ) |
+		DMA_CTRL_CYCLE_CTRL_INVALID;
+}
+
+void DMA_ActivateBasic( unsigned int channel, bool primary, bool useBurst, void *dst, void *src, unsigned int nMinus1 )
+{
+	if( chanCb[channel] )
+	{
+		chanCb[channel]->primary = primary;
+	}
+	chanAlt[channel] = !primary;
+	DMA_setup( channel, primary, dmaCycleCtrlBasic, dst, src, nMinus1 );
+
+	// A transmission follows the one in progress on its UART; the interrupt is taken once it has left
+	basicPort[channel] = ( dst == ( void * )&HOST_usart0.TXDATA ) ? 0 : ( dst == ( void * )&HOST_usart2.TXDATA ) ? 1 : -1;
+	// A transmission chained from the interrupt starts as the last one ends, not at the tick it was seen
+	basicDone[channel] = txIsrTime ? txIsrTime : UART_now();
+	if( basicPort[channel] >= 0 )
+	{
+		if( basicDone[channel] < txFree[basicPort[channel]] )
+		{
+			basicDone[channel] = txFree[basicPort[channel]];
+		}
+		basicDone[channel] += nMinus1 + 1;
+		txFree[basicPort[channel]] = basicDone[channel];
+
+		HOST_uartStats.txBytes += nMinus1 + 1;
+		HOST_uartStats.txNs += ( nMinus1 + 1 ) * charNs;
+		HOST_uartStats.txCpuNs += UART_cyclesNs( ( nMinus1 + 1 ) * UART_COPY_CYCLES );
+	}
+	basicActive |= 1UL << channel;
+}
+
+void DMA_ActivatePingPong( unsigned int channel, bool useBurst,
+						   void *primDst, void *primSrc, unsigned int primNMinus1,
+						   void *altDst, void *altSrc, unsigned int altNMinus1 )
+{
+	DMA_setup( channel, false, dmaCycleCtrlPingPong, altDst, altSrc, altNMinus1 );
+	DMA_setup( channel, true, dmaCycleCtrlPingPong, primDst, primSrc, primNMinus1 );
+
+	if( chanCb[channel] )
+	{
+		chanCb[channel]->primary = true;
+	}
+	chanAlt[channel] = false;
+}
+
+void DMA_RefreshPingPong( unsigned int channel, bool primary, bool useBurst,
+						  void *dst, void *src, unsigned int nMinus1, bool stop )
+{
+	DMA_setup( channel, primary, stop ? dmaCycleCtrlBasic : dmaCycleCtrlPingPong, dst, src, nMinus1 );
+}
+
+void USART_Reset( USART_TypeDef *usart )
+{
+	memset( usart, 0, sizeof( USART_TypeDef ) );
+}
+
+void USART_InitAsync( USART_TypeDef *usart, const USART_InitAsync_TypeDef *init )
+{
+}
+
+void USART_Tx( USART_TypeDef *usart, uint8_t data )
+{
+}
+
+uint8_t USART_Rx( USART_TypeDef *usart )
+{
+	return 0;
+}
+
+void CMU_ClockEnable( CMU_Clock_TypeDef clock, bool enable )
+{
+}
+
+void GPIO_PinModeSet( GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out )
+{
+}
+
+void GPIO_IntConfig( GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable )
+{
+}
+
+// SLEEP STAND-INS *************************************************************
+
+int32_t HOST_sleepHolds = 0;
+
+void BSP_SLEEP_holdEM1( void )
+{
+	__sync_fetch_and_add( &HOST_sleepHolds, 1 );
+}
+
+void BSP_SLEEP_releaseEM1( void )
+{
+	__sync_fetch_and_sub( &HOST_sleepHolds, 1 );
+}
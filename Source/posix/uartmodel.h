@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * @file	uartmodel.h
+ * @brief	Host UART and DMA model.
+ *
+ * Force-included ahead of bsp_uart.c and bsp_dma.c in the host build of the
+ * UART benchmark. It pulls in the EFM32 peripheral headers and then
+ * points the USART register blocks and the NVIC functions at host memory, so
+ * the driver runs unmodified against the line and DMA controller model in
+ * uartmodel.c.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __UARTMODEL_H
+#define __UARTMODEL_H
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_usart.h"
+#include "em_dma.h"
+
+extern USART_TypeDef HOST_usart0;
+extern USART_TypeDef HOST_usart2;
+
+// Register blocks seen by the driver. The device header is include guarded,
+// so these survive its later inclusion by bsp_uart.h.
+#undef  USART0
+#undef  USART2
+#define USART0		( &HOST_usart0 )
+#define USART2		( &HOST_usart2 )
+
+// The CMSIS NVIC functions are inline and already bound to the core's address.
+#define NVIC_EnableIRQ( irq )				( ( void )( irq ) )
+#define NVIC_DisableIRQ( irq )				( ( void )( irq ) )
+#define NVIC_ClearPendingIRQ( irq )			( ( void )( irq ) )
+#define NVIC_SetPriority( irq, priority )	( ( void )( irq ) )
+
+// The emlib GPIO interrupt flag functions are inline and bound to the GPIO's address.
+#define GPIO_IntClear( flags )				( ( void )( flags ) )
+#define GPIO_IntDisable( flags )			( ( void )( flags ) )
+
+/// Modelled CPU time of the debug UART receive path, for the DMA ring as
+/// built and for the interrupt per byte it replaces, and of the transmit
+/// queues.
+typedef struct
+{
+	uint64_t	bytes;			///< Bytes received on the line.
+	uint64_t	lost;			///< Bytes the DMA could not take, its cycle having stopped.
+	uint32_t	interrupts;		///< DMA interrupts taken.
+	uint32_t	reads;			///< Reads of the ring by the receiving task.
+	double		lineNs;			///< Time the line was carrying bytes.
+	double		cpuNs;			///< CPU time with the DMA ring.
+	double		legacyNs;		///< CPU time with an interrupt per byte.
+	uint64_t	txBytes;		///< Bytes sent, on either UART.
+	uint32_t	txInterrupts;	///< DMA interrupts ending a transmission.
+	double		txNs;			///< Line time of the bytes sent.
+	double		txCpuNs;		///< CPU time of the transmit queues: copying and interrupts.
+} HOST_UART_Stats_TypeDef;
+
+extern HOST_UART_Stats_TypeDef HOST_uartStats;
+
+void    HOST_UART_Init( uint32_t baudrate );						///< Reset the line model and its statistics.
+void    HOST_UART_send( const uint8_t *data, uint32_t len, uint32_t gapChars );	///< Queue bytes on the line, after an idle gap.
+uint32_t HOST_UART_pending( void );									///< Bytes queued that the line has not yet carried.
+uint8_t HOST_UART_lineByte( uint32_t position );					///< Byte the line carried at a position.
+bool    HOST_UART_run( void );										///< Let the line progress to the current tick, taking the interrupts it raises.
+void    HOST_UART_chargeRead( uint32_t bytes );						///< Charge a read of the ring by the receiving task.
+uint32_t HOST_UART_txLine( USART_TypeDef *usart, const uint8_t **data );	///< Bytes a UART has sent.
+
+/// EM1 holds the driver has taken and not released. The host never sleeps,
+/// so they are only counted, to check that they balance.
+extern int32_t HOST_sleepHolds;
+
+#endif // __UARTMODEL_H
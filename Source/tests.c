@@ -22,10 +22,12 @@
  ******************************************************************************/
 void TEST_RTC (void)
 {
+	uint64_t now = BSP_RTC_getTimeUs();
+
 	if(VERBOSE)
-		debugLen = sprintf((char*)debugStr,"\n\nTime: %d.%03d", (int)sec, (int)msec);
+		debugLen = sprintf((char*)debugStr,"\n\nTime: %d.%03d", (int)(now / 1000000), (int)((now / 1000) % 1000));
 	else
-		debugLen = sprintf((char*)debugStr,"%d.%03d;", (int)sec, (int)msec);
+		debugLen = sprintf((char*)debugStr,"%d.%03d;", (int)(now / 1000000), (int)((now / 1000) % 1000));
 
 	BSP_UART_txBuffer(BSP_UART_DEBUG,(uint8_t*)debugStr,debugLen,true);
 }
@@ -247,8 +249,6 @@ void TEST_I2C(void)
  ******************************************************************************/
 void TEST_ADC (void)
 {
-	  BSP_ADC_update(1);
-
 	  if (VERBOSE)
 	  {
 		  debugLen = sprintf((char*)debugStr,"\n\nChannel 0 (mV): %d",BSP_ADC_getData(CHANNEL0));
@@ -58,5 +58,6 @@
 xQueueHandle FSW_ADCS_CMDqueue;			///< ADCS module command queue
 
 void FSW_ADCS_Init( void );				///< Initialize the ADCS module.
+void FSW_ADCS_ADCSexe( void );			///< Periodic job: run the ADCS libraries for the satellite mode.
 
 #endif /* FSW_ADCS_H_ */
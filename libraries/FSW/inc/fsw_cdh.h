@@ -77,6 +77,20 @@
 #define CDH_CMD_PARAMLEN 	1			///< Maximum number of parameters to be included in a single command.
 #define CDH_DIARY_CMDCOUNT	4			///< Maximum number of commands held in a single diary structure.
 
+/// Definitions for the command routing table
+#define CDH_ROUTE_DESTCOUNT	9			///< Rows in the routing table, destinations 0 to FSW_POWER.
+#define CDH_ROUTE_IDCOUNT	8			///< Command ids 0x00 to 0x07 per destination.
+
+#define CDH_MODE(mode)		( 1 << (mode) )		///< Satellite mode (current_state) as a bit in CDH_Route_TypeDef.modes
+#define CDH_MODES_ALL		( CDH_MODE(DETUMBLING_MODE) | CDH_MODE(SAFE_MODE) | CDH_MODE(NOMINAL_MODE) | CDH_MODE(LINK_MODE) | CDH_MODE(ERP_MODE) )
+
+/// Error codes placed in CDH_CMD_TypeDef.error when a command is rejected.
+#define CDH_CMDERR_NONE		0x00		///< Command is valid.
+#define CDH_CMDERR_DEST		0x01		///< Unknown destination module.
+#define CDH_CMDERR_ID		0x02		///< Destination has no command with this id.
+#define CDH_CMDERR_LEN		0x03		///< Too few parameters.
+#define CDH_CMDERR_MODE		0x04		///< Command not allowed in the current satellite mode.
+
 xQueueHandle FSW_CDH_CMDqueue;			///< Main management level command queue
 xQueueHandle FSW_CDH_DIARYqueue;		///< Main management level Diary queue.
 
@@ -89,15 +103,25 @@ typedef struct{
 	uint8_t len;						///< number of parameters
 	uint8_t error;						///< Error flag
 	uint8_t processed;					///< Processed flag
-	uint8_t resched_cnt;				///< Number of times the CMD needs to be periodically executed
+	uint8_t resched_cnt;				///< Number of times the CMD needs to be periodically executed after exe_time
+	uint16_t resched_period;			///< Seconds between periodic executions (fits in the struct padding)
 } CDH_CMD_TypeDef;
 
-/// Structure used for a diary entry containing multiple commands.
+/// Handle of a command block in the command pool (see fsw_cmdpool.h). The command queues carry these instead of the commands.
+typedef uint8_t CDH_CMDhandle_TypeDef;
+
+/// Structure used for a diary entry containing multiple commands. This is the layout received from the ground.
 typedef struct{
 	CDH_CMD_TypeDef CMDlist[CDH_DIARY_CMDCOUNT];	///< Array to hold commands
 	uint8_t CmdCount;								///< The number of commands in this diary
 }CDH_Diary_TypeDef;
 
+/// Diary as passed on the diary queue, with its commands already in the command pool.
+typedef struct{
+	CDH_CMDhandle_TypeDef CMDlist[CDH_DIARY_CMDCOUNT];	///< Handles of the commands
+	uint8_t CmdCount;									///< The number of commands in this diary
+}CDH_DiaryRef_TypeDef;
+
 /// Structure used for passing data between tasks
 typedef struct{
 	uint8_t data;						///< The data being passed
@@ -105,6 +129,25 @@ typedef struct{
 	uint8_t source;						///< The module where the data originates
 }CDH_DATA_TypeDef;
 
+/// Command handler. Runs in the task of the queue the command is routed to.
+typedef void (*CDH_CMDhandler_TypeDef)( const CDH_CMD_TypeDef *CMD );
+
+/// Entry in the command routing table. Each module defines a const row of these, indexed by command id.
+typedef struct{
+	CDH_CMDhandler_TypeDef handler;		///< Executes the command. NULL for unused ids.
+	xQueueHandle *queue;				///< Queue of the task that runs the handler, NULL to run it in the C&DH task.
+	uint8_t paramLen;					///< Number of parameters the command needs.
+	uint8_t modes;						///< Satellite modes in which the command is allowed, see CDH_MODE().
+}CDH_Route_TypeDef;
+
+/// Counters of commands rejected by the router, reported in telemetry.
+typedef struct{
+	uint16_t rejected;					///< Commands rejected since start up.
+	uint8_t lastError;					///< CDH_CMDERR_ code of the last rejected command.
+	uint8_t lastDest;					///< Destination of the last rejected command.
+	uint8_t lastId;						///< I.D. of the last rejected command.
+}CDH_RouteStats_TypeDef;
+
 /// Structure used to hold TLM data for the real time stream
 typedef struct{
 	uint8_t *TLM;				///< The telemetry that needs to be streamed
@@ -115,6 +158,20 @@ typedef struct{
 CDH_CMD_TypeDef sim_Data;
 /*******************************************************************************************************************************/
 
+/*ROUTING TABLE ROWS. DEFINED IN EACH MODULE NEXT TO ITS HANDLERS.**************************************************************/
+extern const CDH_Route_TypeDef FSW_ADCS_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_CDH_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_COMM_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_FS_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_HANDH_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_MODES_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_PAYLOAD_routes[CDH_ROUTE_IDCOUNT];
+extern const CDH_Route_TypeDef FSW_POWER_routes[CDH_ROUTE_IDCOUNT];
+/*******************************************************************************************************************************/
+
 void FSW_CDH_Init( void );					///< Initialize the C&DH module.
+uint8_t FSW_CDH_route( const CDH_CMD_TypeDef *CMD, const CDH_Route_TypeDef **route );	///< Look up and validate a command.
+uint8_t FSW_CDH_execute( CDH_CMDhandle_TypeDef handle );								///< Run a command received on a module queue and release it.
+void FSW_CDH_getRouteStats( CDH_RouteStats_TypeDef *stats );							///< Snapshot of the router's reject counters.
 
 #endif /* FSW_CDH_H_ */
@@ -0,0 +1,71 @@
+/***************************************************************************//**
+ * @file	fsw_cmdpool.h
+ * @brief	FSW command block pool header file.
+ *
+ * This header file contains the interface to the pool of command blocks that
+ * are passed between modules by handle instead of by value.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_CMDPOOL_H_
+#define FSW_CMDPOOL_H_
+
+#include <stdint.h>
+
+#include "fsw_cdh.h"		// for command typedef
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+#define CDH_CMDPOOL_LEN		48			///< Number of command blocks. Equal to the command queue slots; a command is dropped when the pool is empty, as when its queue is full.
+#define CDH_CMD_NOHANDLE	0xFF		///< Invalid command handle.
+
+/// Command pool usage, reported in telemetry.
+typedef struct{
+	uint32_t allocs;					///< Blocks handed out since start up.
+	uint16_t exhausted;					///< Allocations refused because no block was free.
+	uint8_t inUse;						///< Blocks currently in use.
+	uint8_t hwm;						///< Most blocks ever in use at once.
+}FSW_CMDPOOL_Stats_TypeDef;
+
+void FSW_CMDPOOL_Init( void );											///< Initialise the command pool. Call before any module is initialised.
+CDH_CMDhandle_TypeDef FSW_CMDPOOL_alloc( void );						///< Take a block, with a reference count of one.
+CDH_CMD_TypeDef *FSW_CMDPOOL_get( CDH_CMDhandle_TypeDef handle );		///< The command held in a block.
+void FSW_CMDPOOL_retain( CDH_CMDhandle_TypeDef handle );				///< Add a reference to a block.
+void FSW_CMDPOOL_release( CDH_CMDhandle_TypeDef handle );				///< Drop a reference, freeing the block on the last one.
+portBASE_TYPE FSW_CMDPOOL_send( xQueueHandle queue, const CDH_CMD_TypeDef *CMD, portTickType ticksToWait );			///< Copy a command into a block and queue it.
+portBASE_TYPE FSW_CMDPOOL_forward( xQueueHandle queue, CDH_CMDhandle_TypeDef handle, portTickType ticksToWait );	///< Pass a block on to another queue.
+portBASE_TYPE FSW_CMDPOOL_sendDiary( xQueueHandle queue, const CDH_Diary_TypeDef *diary, portTickType ticksToWait );	///< Copy a diary's commands into blocks and queue the diary.
+void FSW_CMDPOOL_getStats( FSW_CMDPOOL_Stats_TypeDef *stats );			///< Snapshot of the pool usage counters.
+
+#endif /* FSW_CMDPOOL_H_ */
@@ -0,0 +1,52 @@
+/***************************************************************************//**
+ * @file	fsw_crc.h
+ * @brief	FSW CRC header file.
+ *
+ * This header file contains the CRC-16 used to protect log records and other
+ * data that leaves the OBC.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_CRC_H_
+#define FSW_CRC_H_
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup CRC
+ * @brief API for the CRC functions.
+ * @{
+ ******************************************************************************/
+
+#define FSW_CRC16_INIT		0xFFFF		///< Initial value of a CRC-16/CCITT-FALSE calculation.
+
+uint16_t FSW_CRC16_update( uint16_t crc, const void *data, uint32_t len );	///< Continue a CRC-16/CCITT-FALSE over len bytes.
+
+#endif /* FSW_CRC_H_ */
@@ -42,6 +42,9 @@
 #include "queue.h"
 #include "fsw_cdh.h"		// for command typedef
 #include "comms.h"			// for printing
+#include "fsw_logwriter.h"
+#include "fsw_logformat.h"		// for the log types and records
+#include "diskcache.h"			// for the cache counters
 
 /***************************************************************************//**
  * @addtogroup FSW_Library
@@ -55,11 +58,10 @@
  * @{
  ******************************************************************************/
 #define BUFSIZE 512						///< BUFSIZE should be between 512 and 1024, depending on available ram on efm32
-#define MAX_LOG_SIZE 1000				///< Maximum size of a log file in bytes
-
-#define LOG_CMD 	1					///< Macros for the 'type' field in the logentry structure
-#define LOG_WOD 	2
-#define LOG_ERROR 	3
+#define LOG_RING_SECTORS 512				///< Size of each log's ring file in sectors (256 KiB, 31744 entries)
+#define LOG_CNTRLBLOCK "/LOGCTRL.BLK"		///< Log control block file, holding where each log ring continues
+#define LOG_FLUSH_MS 5000				///< Longest time a log entry is buffered in RAM before it is written to the card
+#define LOG_SYNC_POLICY FSW_LOGW_SYNC_TIMEOUT	///< When log flushes are followed by f_sync. Changed with FS command 0x04.
 
 typedef struct{
 	uint32_t exe_time;					///< execution time of cmd or time of error detected
@@ -74,5 +76,7 @@ xQueueHandle FSW_FS_CMDqueue;			///< FS command queue
 FS_LogEntry_TypeDef log_entry;
 
 void FSW_FS_Init( void );
+void FSW_FS_getLogStats( FSW_LOGW_Stats_TypeDef *stats, uint16_t *rate );	///< Log writer counters summed over the logs, and entries per second.
+void FSW_FS_getCacheStats( DISKCACHE_Stats_TypeDef *stats );				///< Sector cache counters.
 
 #endif /* FSW_FILESYSTEM_H_ */
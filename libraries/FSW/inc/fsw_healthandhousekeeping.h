@@ -65,9 +65,17 @@ typedef struct{
 xQueueHandle FSW_HANDH_CMDqueue;		///< Health and Housekeeping module command queue
 xQueueHandle FSW_HANDH_DATAqueue;		///< Health and Housekeeping module command queue
 
-time_t OBC_time;						///< Date and time for the OBC
+#define FSW_HANDH_TRIM_MAXPPB	200000		///< Largest rate correction of the OBC clock, 200 ppm, ten times the crystal's tolerance.
+#define FSW_HANDH_SYNC_MINUS	600000000	///< Shortest interval between time syncs the clock rate is corrected from, 10 minutes.
 
 void FSW_HandH_Init( void );
 time_t getOBC_time( void );				///< Getter function for OBC_time
+int64_t FSW_HANDH_getTimeUs( void );	///< OBC date and time in microseconds since 1970.
+void FSW_HANDH_syncTime( int64_t timeUs );	///< Set the OBC date and time from the ground, correcting the clock rate.
+void FSW_HANDH_trimTime( int32_t ppb );	///< Set the rate correction of the OBC clock.
+
+void FSW_HANDH_HKexe( void );			///< Periodic job: sample the housekeeping and publish the telemetry.
+void FSW_HANDH_TLMstream( void );		///< Periodic job: send the real-time telemetry stream.
+void FSW_HANDH_writeHK( uint8_t slot );	///< Append a spilled housekeeping block to the spill file. File system task only.
 
 #endif /* FSW_HEALTHANDHOUSEKEEPING_H_ */
@@ -0,0 +1,131 @@
+/***************************************************************************//**
+ * @file	fsw_hkseries.h
+ * @brief	FSW housekeeping time series header file.
+ *
+ * This header file describes the store of housekeeping history kept between
+ * ground passes. A sample of every channel is added once a second and kept at
+ * three resolutions, each a ring in memory handed to the store, normally the
+ * external SRAM: the samples themselves, and minute and ten minute rollups of
+ * their minimum, maximum and mean. A record's index in its ring is its time
+ * over its period, so a gap in the samples is kept as FSW_HKS_NODATA and the
+ * time of every record follows from its position.
+ *
+ * The minute rollups are also delta and varint coded into sector sized blocks,
+ * which are handed to a spill function to be kept on the card once full, so
+ * history older than the rings can still be downlinked.
+ *
+ * One task adds the samples. Range queries may run in any task: a query
+ * copies again if the records it copied were overwritten meanwhile.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_HKSERIES_H_
+#define FSW_HKSERIES_H_
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup HandH
+ * @brief API for the housekeeping time series.
+ * @{
+ ******************************************************************************/
+
+#define FSW_HKS_CHANNELS	5			///< Channels sampled: the ADC channels, CHANNEL0 to CHANNEL3 and TEMPERATURE.
+#define FSW_HKS_NODATA		INT16_MIN	///< Value of a second without a sample, and of a rollup without any.
+
+/// Records kept at each resolution.
+#ifndef FSW_HKS_SECONDS
+#define FSW_HKS_SECONDS		7200		///< Samples, two hours.
+#endif
+#ifndef FSW_HKS_MINUTES
+#define FSW_HKS_MINUTES		2880		///< Minute rollups, two days.
+#endif
+#ifndef FSW_HKS_TENMINUTES
+#define FSW_HKS_TENMINUTES	2016		///< Ten minute rollups, two weeks.
+#endif
+
+/// Macros for the tier argument of FSW_HKS_query.
+#define FSW_HKS_TIER_SECOND		0
+#define FSW_HKS_TIER_MINUTE		1
+#define FSW_HKS_TIER_TENMINUTE	2
+#define FSW_HKS_TIERS			3
+
+#define FSW_HKS_BLOCK		512			///< Spilled block, a sector.
+#define FSW_HKS_MAGIC		0x4B48		///< "HK", the first two bytes of every spilled block.
+#define FSW_HKS_VERSION		1			///< Block format version. Increment whenever the header or coding changes.
+
+/// Memory handed to FSW_HKS_Init: the three rings, each with a record spare for the one being written.
+#define FSW_HKS_MEMSIZE		( ( ( FSW_HKS_SECONDS + 1 ) * sizeof( int16_t ) + \
+							  ( FSW_HKS_MINUTES + 1 + FSW_HKS_TENMINUTES + 1 ) * sizeof( FSW_HKS_Rollup_TypeDef ) ) * FSW_HKS_CHANNELS )
+
+/// A channel over a period. A sample has all three equal.
+typedef struct{
+	int16_t min;
+	int16_t max;
+	int16_t mean;						///< Rounded mean of the samples, or of the minute means for ten minutes.
+}FSW_HKS_Rollup_TypeDef;
+
+/// Start of every spilled block. The minute rollups that follow are
+/// consecutive, every channel of a minute together. Each channel is coded as
+/// three zigzag varints: its mean less the previous minute's, the mean less
+/// the minimum and the maximum less the mean. The first minute's previous
+/// means are 0, so every block decodes alone. Unused bytes are 0xFF.
+typedef struct{
+	uint16_t magic;						///< FSW_HKS_MAGIC
+	uint8_t version;					///< FSW_HKS_VERSION of the writer
+	uint8_t channels;					///< FSW_HKS_CHANNELS of the writer
+	uint32_t first;						///< Time of the first minute, a multiple of 60.
+	uint16_t count;						///< Minutes in the block.
+	uint16_t len;						///< Bytes of coded minutes after the header.
+	uint16_t reserved;
+	uint16_t crc;						///< CRC-16 of the preceding bytes of the header and of the coded minutes.
+}FSW_HKS_BlockHeader_TypeDef;
+
+/// Keeps a full block. Runs in the task adding the samples.
+typedef void ( *FSW_HKS_SpillFunc )( const uint8_t *block );
+
+/// Store counters, reported in telemetry.
+typedef struct{
+	uint32_t samples;					///< Samples added.
+	uint32_t gaps;						///< Seconds without a sample, kept as FSW_HKS_NODATA.
+	uint16_t restarts;					///< Times the time stepped back, or forward past the sample ring, and the rings were emptied.
+	uint16_t spills;					///< Blocks spilled.
+	uint32_t spilledMinutes;			///< Minute rollups spilled.
+	uint32_t spilledBytes;				///< Bytes of headers and coded minutes spilled, without the unused bytes.
+}FSW_HKS_Stats_TypeDef;
+
+void     FSW_HKS_Init( uint8_t *mem, FSW_HKS_SpillFunc spill );								///< Set up empty rings in FSW_HKS_MEMSIZE bytes.
+void     FSW_HKS_add( uint32_t time, const int16_t *values );								///< Add a sample of every channel.
+uint16_t FSW_HKS_query( uint8_t tier, uint8_t channel, uint32_t from, FSW_HKS_Rollup_TypeDef *out, uint16_t max, uint32_t *first );	///< Copy out the records of a channel from a time on.
+void     FSW_HKS_spill( void );																///< Spill the minutes coded so far.
+void     FSW_HKS_getStats( FSW_HKS_Stats_TypeDef *stats );									///< Copy the counters.
+uint16_t FSW_HKS_decodeBlock( const uint8_t *block, uint32_t *first, FSW_HKS_Rollup_TypeDef *out, uint16_t max );	///< Decode a spilled block.
+
+#endif /* FSW_HKSERIES_H_ */
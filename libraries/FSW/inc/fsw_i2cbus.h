@@ -0,0 +1,127 @@
+/***************************************************************************//**
+ * @file	fsw_i2cbus.h
+ * @brief	FSW I2C bus scheduler header file.
+ *
+ * This header file contains the interface to the I2C bus scheduler run by the
+ * FSW_I2C_manager task. Modules queue read, write and write-read messages for
+ * either I2C channel with a priority, and are told of the result through a
+ * callback or a reply queue. Reads of the same slave and priority waiting
+ * together are run back to back in one bus session.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_I2CBUS_H_
+#define FSW_I2CBUS_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "bsp_i2c.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+#define FSW_I2CBUS_PENDING		12		///< Messages taken from the queue and waiting for the bus.
+#define FSW_I2CBUS_BATCH		4		///< Most transfers run in one bus session.
+#define FSW_I2CBUS_RETRY_MS		10		///< Wait before trying a channel again that another master user holds.
+#define FSW_I2CBUS_BITRATE		93500	///< Bus clock of I2C_INIT_DEFAULT, for the bus time counters.
+
+/// Macros for the bus field of an I2C message.
+#define FSW_I2C_BUS_SYS			0		///< BSP_I2C_SYS, the main channel.
+#define FSW_I2C_BUS_SUB			1		///< BSP_I2C_SUB, the subsystem channel.
+#define FSW_I2C_BUSES			2
+
+/// Priorities of I2C messages. Lower values are served first, in order of arrival within a priority.
+typedef enum{
+	FSW_I2C_PRIO_HIGH = 0,				///< Telecommands, e.g. actuator settings.
+	FSW_I2C_PRIO_NORMAL,				///< Periodic telemetry.
+	FSW_I2C_PRIO_LOW,					///< Bulk transfers, e.g. image frames.
+	FSW_I2C_PRIOS
+}FSW_I2C_Priority_TypeDef;
+
+typedef struct COMM_I2Cmsg COMM_I2Cmsg_TypeDef;
+
+/// Called by the scheduler, in the FSW_I2C_manager task, when a message completes. Must not block.
+typedef void ( *COMM_I2Cdone_TypeDef )( const COMM_I2Cmsg_TypeDef *msg );
+
+/// I2C message. Copied into the queue, but the buffers must stay valid until the message completes.
+struct COMM_I2Cmsg{
+	uint8_t* buffer;							///< Data to be sent over I2C
+	uint8_t source;								///< Module were the message originated
+	uint8_t dest;								///< I2C read/write address
+	uint32_t msgLen;							///< Length of the data to be sent
+	uint8_t* rxBuffer;							///< Buffer for the data read, for read and write-read messages
+	uint16_t rxLen;								///< Length of the data to be read
+	uint8_t flag;								///< Transfer type, a BSP_I2C_ModeSelect_TydeDef
+	uint8_t bus;								///< FSW_I2C_BUS_SYS or FSW_I2C_BUS_SUB
+	uint8_t priority;							///< A FSW_I2C_Priority_TypeDef
+	int8_t status;								///< Result, a BSP_I2C_Status_TypeDef, set when the message completes
+	COMM_I2Cdone_TypeDef done;					///< Called when the message completes, or NULL
+	xQueueHandle reply;							///< Receives a copy of the completed message, or NULL
+	void* context;								///< For the sender, e.g. the record the callback updates
+	portTickType queued;						///< Tick the message was queued, set by FSW_I2CBUS_submit
+};
+
+/// Latency counters of one priority, from queueing to completion, in ticks.
+typedef struct{
+	uint32_t messages;					///< Messages completed.
+	uint32_t failed;					///< Of which failed.
+	uint32_t totalTicks;				///< Sum of their latencies.
+	uint16_t maxTicks;					///< Longest latency.
+}FSW_I2CBUS_Latency_TypeDef;
+
+/// Scheduler counters, reported in telemetry.
+typedef struct{
+	uint32_t sessions;					///< Bus sessions run.
+	uint32_t transfers;					///< Transfers run in them.
+	uint32_t coalesced;					///< Transfers run in the session of an earlier message instead of their own.
+	uint32_t busUs[FSW_I2C_BUSES];		///< Bus time of the transfers completed, from their bytes at FSW_I2CBUS_BITRATE.
+	uint32_t windowTicks;				///< Ticks since the counters were reset.
+	uint16_t utilisation[FSW_I2C_BUSES];	///< Bus time over the window, in 0.1 %.
+	uint16_t busyRetries;				///< Sessions put off because a channel was in use outside the scheduler.
+	uint16_t replyLost;					///< Completed messages whose reply queue was full.
+	FSW_I2CBUS_Latency_TypeDef latency[FSW_I2C_PRIOS];
+}FSW_I2CBUS_Stats_TypeDef;
+
+void FSW_I2CBUS_Init( uint8_t batch );			///< Set up the scheduler.
+void FSW_I2CBUS_construct( COMM_I2Cmsg_TypeDef *msg, BSP_I2C_ModeSelect_TydeDef flag, uint8_t *txBuffer, uint32_t txLen,
+						   uint8_t *rxBuffer, uint16_t rxLen, uint8_t source, uint8_t dest );	///< Fill in a message.
+portBASE_TYPE FSW_I2CBUS_submit( xQueueHandle queue, COMM_I2Cmsg_TypeDef *msg, portTickType wait );	///< Queue a message.
+void FSW_I2CBUS_service( xQueueHandle queue, portTickType wait );	///< Take queued messages and run the next bus session.
+void FSW_I2CBUS_getStats( FSW_I2CBUS_Stats_TypeDef *stats );		///< Copy the counters.
+void FSW_I2CBUS_resetStats( void );									///< Clear the counters and start a new window.
+
+/** @} (end addtogroup C&DH) */
+/** @} (end addtogroup FSW_Library) */
+
+#endif /* FSW_I2CBUS_H_ */
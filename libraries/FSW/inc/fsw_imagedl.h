@@ -0,0 +1,105 @@
+/***************************************************************************//**
+ * @file	fsw_imagedl.h
+ * @brief	FSW CubeSense image download header file.
+ *
+ * This header file contains the interface to the image download task, which
+ * reads a CubeSense image a 128 byte frame at a time over I2C and stores it in
+ * a preallocated file on the SD card. Frames are collected in two sector sized
+ * buffers, so one is written to the card while the next frames are read, and
+ * each frame is checked against the frame number and XOR checksum CubeSense
+ * reports for it. Progress is recorded on the card, so an interrupted download
+ * resumes where it stopped.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_IMAGEDL_H_
+#define FSW_IMAGEDL_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Payload
+ * @brief API for the Payload interface module.
+ * @{
+ ******************************************************************************/
+
+#define FSW_IMG_FRAMELEN		128		///< Bytes in a CubeSense image frame.
+#define FSW_IMG_BLOCKFRAMES		4		///< Frames per buffer. One sector, so each buffer is one whole sector write.
+#define FSW_IMG_BLOCKLEN		( FSW_IMG_FRAMELEN * FSW_IMG_BLOCKFRAMES )
+#define FSW_IMG_SYNC_BLOCKS		32		///< Buffers written between progress records (16 KiB). Frames after the last record are read again on resume.
+#define FSW_IMG_RETRIES			4		///< Attempts per frame before the download stops.
+#define FSW_IMG_RETRY_MS		10		///< Wait before reading a frame again, e.g. one CubeSense has not loaded yet.
+#define FSW_IMG_MAXSIZE			4		///< Largest image size code; size n is ( 640 >> n ) x ( 480 >> n ) pixels.
+
+#define FSW_IMG_PATH			"/IMAGES/IMAGE.BIN"		///< The image file, preallocated to the image size.
+#define FSW_IMG_RECORDPATH		"/IMAGES/IMAGE.RES"		///< Progress record of the download.
+
+/// Macros for the image argument of FSW_IMG_start, as CubeSense selects its cameras.
+#define FSW_IMG_NADIR			0
+#define FSW_IMG_SUN				1
+
+/// Download states.
+typedef enum{
+	FSW_IMG_IDLE = 0,					///< No download since start up.
+	FSW_IMG_RUNNING,
+	FSW_IMG_DONE,						///< The image file is complete.
+	FSW_IMG_ABORTED,					///< Stopped by FSW_IMG_abort. Can be resumed.
+	FSW_IMG_FAILED						///< Stopped by an I2C, checksum or file error. Can be resumed.
+}FSW_IMG_State_TypeDef;
+
+/// Download progress and counters, reported in telemetry.
+typedef struct{
+	uint32_t frames;					///< Frames in the image.
+	uint32_t nextFrame;					///< Frames stored so far.
+	uint32_t framesRead;				///< Frames read and checked by this run, repeats excluded.
+	uint32_t runTicks;					///< Duration of this run.
+	uint32_t totalTicks;				///< Duration of the download over all its runs.
+	uint16_t framesPerSec;				///< framesRead over runTicks.
+	uint16_t checksumErrors;			///< Frames read again after a wrong frame number or checksum.
+	uint16_t i2cErrors;					///< Frames read again after an I2C error.
+	uint16_t resumes;					///< Runs that continued an interrupted download.
+	uint8_t state;						///< A FSW_IMG_State_TypeDef.
+	uint8_t image;						///< FSW_IMG_NADIR or FSW_IMG_SUN.
+	uint8_t size;						///< Image size code.
+	int8_t lastError;					///< FatFs result or I2C status that stopped the last failed run, 0 if none.
+}FSW_IMG_Stats_TypeDef;
+
+void    FSW_IMG_Init( xQueueHandle i2cQueue );			///< Create the image download task.
+uint8_t FSW_IMG_start( uint8_t image, uint8_t size );	///< Start downloading a new image.
+uint8_t FSW_IMG_resume( void );							///< Continue the download recorded on the card.
+void    FSW_IMG_abort( void );							///< Stop the download in progress, keeping it resumable.
+void    FSW_IMG_getStats( FSW_IMG_Stats_TypeDef *stats );	///< Copy the progress and counters.
+
+/** @} (end addtogroup Payload) */
+/** @} (end addtogroup FSW_Library) */
+
+#endif /* FSW_IMAGEDL_H_ */
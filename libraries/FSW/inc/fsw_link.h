@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * @file	fsw_link.h
+ * @brief	FSW link protocol header file.
+ *
+ * This header file describes the frames telecommands, telemetry requests and
+ * telemetry replies are carried in on the debug UART and the I2C slave
+ * interface. It depends on nothing but stdint.h, so the host tools can share it.
+ *
+ * A frame is an ID, a sequence number, the payload length, up to
+ * FSW_LINK_MAXPAYLOAD bytes of payload and a CRC-16 of all of these. It is COBS
+ * encoded, which removes every zero byte at a cost of one byte in 254, and ends
+ * with a zero delimiter. A receiver that joins mid-stream or loses bytes is back
+ * in step at the next delimiter, and an idle line or an I2C STOP ends a frame
+ * as the delimiter does.
+ *
+ * Replies carry the ID and sequence number of their request. Telecommands are
+ * passed from the receiver to the task executing them through a
+ * FSW_LINK_Queue_TypeDef, which needs no lock as long as there is only one
+ * producer, such as an interrupt handler, and one consumer.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_LINK_H_
+#define FSW_LINK_H_
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the link protocol.
+ * @{
+ ******************************************************************************/
+
+#ifndef FSW_LINK_MAXPAYLOAD
+#define FSW_LINK_MAXPAYLOAD	64			///< Longest payload of a frame, at most 255 bytes.
+#endif
+
+#define FSW_LINK_DELIMITER	0x00		///< Ends every frame.
+#define FSW_LINK_HEADERLEN	3			///< ID, sequence number and payload length.
+#define FSW_LINK_CRCLEN		2			///< CRC-16 of the header and payload, least significant byte first.
+#define FSW_LINK_RAWMAX		( FSW_LINK_HEADERLEN + FSW_LINK_MAXPAYLOAD + FSW_LINK_CRCLEN )	///< Longest frame before encoding.
+#define FSW_LINK_FRAMEMAX	( FSW_LINK_RAWMAX + FSW_LINK_RAWMAX / 254 + 2 )					///< Longest encoded frame, with its delimiter.
+
+/// A frame, laid out as it is before encoding so the receiver decodes into it in place.
+typedef struct{
+	uint8_t id;											///< Telecommand or telemetry ID
+	uint8_t seq;										///< Sequence number, echoed in the reply
+	uint8_t len;										///< Bytes of payload
+	uint8_t payload[FSW_LINK_MAXPAYLOAD + FSW_LINK_CRCLEN];	///< Payload, followed by its CRC while it is received
+}FSW_LINK_Frame_TypeDef;
+
+/// What a byte given to the receiver completed.
+typedef enum{
+	linkRxNone,							///< Nothing, the frame is still being received.
+	linkRxFrame,						///< A frame, received intact.
+	linkRxErrCrc,						///< A frame dropped for a CRC mismatch.
+	linkRxErrFormat						///< A frame dropped for being too short or too long, a length that disagrees with its size, or broken COBS coding.
+}FSW_LINK_RxStatus_TypeDef;
+
+/// Receiver counters.
+typedef struct{
+	uint32_t frames;					///< Frames received intact
+	uint16_t crcErrors;					///< Frames dropped for a CRC mismatch
+	uint16_t formatErrors;				///< Frames dropped for their size or coding
+}FSW_LINK_RxStats_TypeDef;
+
+/// Receiver of one link.
+typedef struct{
+	FSW_LINK_Frame_TypeDef frame;		///< Frame being received. Valid after linkRxFrame until the next byte.
+	uint16_t rawLen;					///< Bytes of the frame decoded
+	uint8_t remaining;					///< Bytes left in the COBS block, 0 if a code byte is next
+	uint8_t zero;						///< Whether a zero follows the COBS block
+	uint8_t overflow;					///< Whether the frame outgrew FSW_LINK_RAWMAX; the rest of it is dropped
+	FSW_LINK_RxStats_TypeDef stats;
+}FSW_LINK_Decoder_TypeDef;
+
+/// Lock-free queue of frames between one producer and one consumer.
+typedef struct{
+	FSW_LINK_Frame_TypeDef *slot;		///< Storage, a power of two frames long
+	uint16_t mask;						///< Slots - 1
+	volatile uint16_t head;				///< Frames pushed. Written only by the producer.
+	volatile uint16_t tail;				///< Frames popped. Written only by the consumer.
+	uint16_t dropped;					///< Frames the producer found no room for. Written only by the producer.
+}FSW_LINK_Queue_TypeDef;
+
+uint16_t FSW_LINK_encode( uint8_t *out, uint8_t id, uint8_t seq, const uint8_t *payload, uint8_t len );	///< Encode a frame, returning its length.
+
+void     FSW_LINK_rxInit( FSW_LINK_Decoder_TypeDef *dec );												///< Reset a receiver and its counters.
+FSW_LINK_RxStatus_TypeDef FSW_LINK_rxByte( FSW_LINK_Decoder_TypeDef *dec, uint8_t byte );				///< Receive a byte.
+FSW_LINK_RxStatus_TypeDef FSW_LINK_rxEnd( FSW_LINK_Decoder_TypeDef *dec );								///< End the frame being received, at an idle line or STOP.
+
+uint8_t  FSW_LINK_queueInit( FSW_LINK_Queue_TypeDef *queue, FSW_LINK_Frame_TypeDef *slots, uint16_t len );	///< Set up a queue over a power of two slots.
+uint8_t  FSW_LINK_queuePush( FSW_LINK_Queue_TypeDef *queue, const FSW_LINK_Frame_TypeDef *frame );		///< Copy a frame in, from the producer.
+FSW_LINK_Frame_TypeDef *FSW_LINK_queuePeek( FSW_LINK_Queue_TypeDef *queue );							///< Oldest frame, for the consumer, or NULL.
+void     FSW_LINK_queuePop( FSW_LINK_Queue_TypeDef *queue );											///< Release the oldest frame, from the consumer.
+uint16_t FSW_LINK_queueCount( const FSW_LINK_Queue_TypeDef *queue );									///< Frames queued.
+
+#endif /* FSW_LINK_H_ */
@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ * @file	fsw_logformat.h
+ * @brief	FSW binary log format header file.
+ *
+ * This header file describes the binary log files written by the file system
+ * module. It is shared with the host log decoder, so it depends on nothing but
+ * stdint.h.
+ *
+ * Each log is a ring of preallocated sectors in one file. Every sector starts
+ * with a FS_LogHeader_TypeDef followed by FS_LogRecord_TypeDef records, and the
+ * unused end of a sector is left erased (0xFF). The sector sequence numbers in
+ * the headers give the order of the sectors around the ring. Where the next
+ * entry goes is kept in the double-buffered FS_LogControlBlock_TypeDef, one
+ * copy in each of the first two sectors of the control block file.
+ *
+ * Everything is stored as laid out in memory on the OBC (little endian). The
+ * header and records are a multiple of 8 bytes and fill a sector exactly.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_LOGFORMAT_H_
+#define FSW_LOGFORMAT_H_
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Filesystem
+ * @brief API for the file system interface module.
+ * @{
+ ******************************************************************************/
+
+#define LOG_CMD 	1					///< Macros for the 'type' field in the logentry structure and the log file header
+#define LOG_WOD 	2
+#define LOG_ERROR 	3
+#define LOG_SYNC 	4					///< Not logged. Flushes and syncs the buffered entries of every log.
+#define LOG_HKSPILL	5					///< Not logged. Appends the housekeeping block in spill slot id to the spill file.
+
+#define FS_LOG_MAGIC		0x474C		///< "LG", the first two bytes of every log sector.
+#define FS_LOG_VERSION		2			///< Format version. Increment whenever the header, record or control block layout changes.
+#define FS_LOG_RINGS		3			///< Logs in the control block, indexed by log type - 1.
+#define FS_LOGCB_MAGIC		0x42434C46	///< "FLCB", the first four bytes of each control block copy.
+
+/// Start of every sector of a log.
+typedef struct{
+	uint16_t magic;						///< FS_LOG_MAGIC
+	uint8_t version;					///< FS_LOG_VERSION of the writer
+	uint8_t type;						///< LOG_CMD, LOG_WOD or LOG_ERROR
+	uint32_t seq;						///< Sectors written to the log before this one
+	uint32_t created;					///< OBC time at which the sector was started
+	uint8_t recordSize;					///< Size of the records that follow, in bytes
+	uint8_t reserved;
+	uint16_t crc;						///< CRC-16 of the preceding bytes of the header
+}FS_LogHeader_TypeDef;
+
+/// One log entry as stored in a log file.
+typedef struct{
+	uint32_t exe_time;					///< execution time of cmd or time of error detected
+	uint8_t source;						///< The source of the log entry
+	uint8_t id;							///< Indicator for what error, cmd, or telemetry is being logged
+	uint16_t crc;						///< CRC-16 of the preceding bytes of the record
+}FS_LogRecord_TypeDef;
+
+/// Where a ring log continues.
+typedef struct{
+	uint32_t seq;						///< Sequence number of the head sector
+	uint16_t head;						///< Sector the next entry goes to
+	uint16_t tail;						///< Sector holding the oldest entries
+	uint16_t sectors;					///< Size of the ring in sectors, 0 if the log has not been created
+	uint16_t reserved;
+}FS_LogRingState_TypeDef;
+
+/// One copy of the log control block.
+typedef struct{
+	uint32_t magic;						///< FS_LOGCB_MAGIC
+	uint32_t generation;				///< Incremented on every update. The copy with the highest is current.
+	FS_LogRingState_TypeDef ring[FS_LOG_RINGS];
+	uint8_t version;					///< FS_LOG_VERSION of the writer
+	uint8_t reserved;
+	uint16_t crc;						///< CRC-16 of the preceding bytes of the copy
+}FS_LogControlBlock_TypeDef;
+
+void    FSW_LOGFMT_header( FS_LogHeader_TypeDef *header, uint8_t type, uint32_t seq, uint32_t created );	///< Fill in a sector header.
+void    FSW_LOGFMT_record( FS_LogRecord_TypeDef *record, uint32_t exe_time, uint8_t source, uint8_t id );	///< Fill in a record.
+uint8_t FSW_LOGFMT_checkHeader( const FS_LogHeader_TypeDef *header );									///< Whether a header is intact and of this version.
+uint8_t FSW_LOGFMT_checkRecord( const FS_LogRecord_TypeDef *record );									///< Whether a record's CRC matches.
+void    FSW_LOGFMT_sealControlBlock( FS_LogControlBlock_TypeDef *cb );									///< Fill in the magic, version and CRC of a control block copy.
+uint8_t FSW_LOGFMT_checkControlBlock( const FS_LogControlBlock_TypeDef *cb );							///< Whether a control block copy is intact and of this version.
+
+#endif /* FSW_LOGFORMAT_H_ */
@@ -0,0 +1,102 @@
+/***************************************************************************//**
+ * @file	fsw_logwriter.h
+ * @brief	FSW buffered log writer header file.
+ *
+ * This header file contains the interface to the log writer, which keeps each
+ * log in a preallocated ring of sectors and collects entries in a sector sized
+ * RAM buffer so that the card is written a sector at a time instead of once
+ * per entry. Where each ring continues is kept in a double-buffered control
+ * block so that logging resumes after a reset without searching the card.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_LOGWRITER_H_
+#define FSW_LOGWRITER_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "ff.h"
+#include "fsw_logformat.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Filesystem
+ * @brief API for the file system interface module.
+ * @{
+ ******************************************************************************/
+
+#define FSW_LOGW_SECTOR			512		///< Buffer size. Equal to the card's sector size so every flush is a whole sector write.
+
+/// Macros for the syncPolicy field: when a flush is followed by f_sync (directory entry update and CTRL_SYNC).
+#define FSW_LOGW_SYNC_FLUSH		0		///< After every flush.
+#define FSW_LOGW_SYNC_TIMEOUT	1		///< After timeout and explicit flushes, not when a sector fills.
+#define FSW_LOGW_SYNC_EXPLICIT	2		///< Only after explicit flushes and when the log is closed.
+
+/// Macros for the reason argument of FSW_LOGW_flush.
+#define FSW_LOGW_FLUSH_FULL		0		///< The buffer holds a full sector.
+#define FSW_LOGW_FLUSH_TIMEOUT	1		///< Entries have waited too long in the buffer.
+#define FSW_LOGW_FLUSH_SYNC		2		///< Requested by command or before the log is closed.
+
+/// Log writer counters, reported in telemetry.
+typedef struct{
+	uint32_t entries;					///< Entries appended.
+	uint32_t entryBytes;				///< Bytes of entries appended.
+	uint32_t sectorWrites;				///< One per flush, f_sync and control block update. An upper bound on the card writes made for the log.
+	uint16_t flushes;					///< Buffer flushes.
+	uint16_t syncs;						///< f_sync calls.
+	uint16_t overwrites;				///< Sectors of old entries overwritten because the ring was full.
+	uint16_t errors;					///< FatFs calls that failed.
+}FSW_LOGW_Stats_TypeDef;
+
+/// Log writer instance. One per log type.
+typedef struct{
+	FIL file;							///< The ring file.
+	const char *path;					///< Path of the ring file.
+	FS_LogRingState_TypeDef *state;		///< This log's entry in the control block.
+	uint8_t buffer[FSW_LOGW_SECTOR];	///< The head sector: header, records and erased (0xFF) space.
+	uint16_t fill;						///< Bytes used in buffer, including the header.
+	uint8_t dirty;						///< Whether buffer holds entries not yet written to the card.
+	uint8_t isOpen;						///< Whether file is open.
+	uint8_t unsynced;					///< Whether data was written since the last f_sync.
+	uint8_t syncPolicy;					///< One of the FSW_LOGW_SYNC_ macros.
+	uint8_t type;						///< LOG_CMD, LOG_WOD or LOG_ERROR.
+	portTickType pendingSince;			///< Tick at which the oldest unflushed entry was appended.
+	FSW_LOGW_Stats_TypeDef stats;
+}FSW_LOGW_TypeDef;
+
+FRESULT FSW_LOGW_loadControlBlock( const char *path );													///< Open the control block file and restore its newest intact copy.
+FRESULT FSW_LOGW_closeControlBlock( void );																///< Close the control block file once the writers are closed.
+FRESULT FSW_LOGW_Init( FSW_LOGW_TypeDef *log, const char *path, uint8_t type, uint16_t sectors, uint8_t syncPolicy );	///< Open a ring log, creating it if needed, and resume after its last entry.
+FRESULT FSW_LOGW_append( FSW_LOGW_TypeDef *log, const void *entry, uint16_t len );					///< Add an entry, writing the buffer out whenever a sector fills.
+FRESULT FSW_LOGW_flush( FSW_LOGW_TypeDef *log, uint8_t reason );									///< Write out the buffered entries.
+uint8_t FSW_LOGW_due( const FSW_LOGW_TypeDef *log, portTickType now, portTickType timeout );		///< Whether the oldest buffered entry is older than timeout.
+FRESULT FSW_LOGW_close( FSW_LOGW_TypeDef *log );													///< Flush, sync and close the log.
+void    FSW_LOGW_pinMetadata( const FSW_LOGW_TypeDef *log );											///< Keep the sectors rewritten by the log's syncs in the sector cache.
+
+#endif /* FSW_LOGWRITER_H_ */
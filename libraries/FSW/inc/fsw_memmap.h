@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @file	fsw_memmap.h
+ * @brief	FSW memory map header file.
+ *
+ * This header file contains the stack of every flight software task. The
+ * stacks are static arrays of the modules that own the tasks, so the linker
+ * places them and the map file and the ramreport build target show them per
+ * module. What the kernel still allocates, the TCBs, queues, semaphores and
+ * timers, comes from the heap_1 heap while the modules are initialised, and
+ * nothing is allocated or freed once the scheduler runs.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_MEMMAP_H_
+#define FSW_MEMMAP_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+/// Task stacks, in words.
+#define FSW_STACK_CDH_CMD			240		///< processCMD
+#define FSW_STACK_CDH_DIARY			240		///< processDIARY
+#define FSW_STACK_COMM_MANAGER		240		///< COMMmanager
+#define FSW_STACK_COMM_I2C			240		///< I2Cmanager
+#define FSW_STACK_COMM_PROCESS		240		///< ProcessTLMTCM
+#define FSW_STACK_FS_CMD			240		///< FS_CMDmanager
+#define FSW_STACK_FS_LOG			240		///< FS_LOGmanager
+#define FSW_STACK_HANDH_CMD			240		///< HANDH_CMDmanager
+#define FSW_STACK_HANDH_DATA		240		///< HANDH_DATAmanager
+#define FSW_STACK_ADCS				240		///< ADCSmanager
+#define FSW_STACK_PAYLOAD			240		///< PAYLOADmanager
+#define FSW_STACK_POWER				240		///< POWERmanager
+#define FSW_STACK_MODES				240		///< MODESmanager
+#define FSW_STACK_IMG				240		///< IMGdownload
+#define FSW_STACK_HANDH_HK			240		///< FSW_HANDH_HKexe, periodic
+#define FSW_STACK_SATMODEMAN		240		///< FSW_MODES_SatModeMan, periodic
+#define FSW_STACK_ADCSEXE			240		///< FSW_ADCS_ADCSexe, periodic
+#define FSW_STACK_POLLUART			240		///< FSW_COMM_pollUART, periodic, HIL only
+#define FSW_STACK_TLMSTREAM			240		///< FSW_HANDH_TLMstream, periodic, HIL only
+#define FSW_STACK_HIL				240		///< TaskTest, the HIL menu
+
+/// Creates a task on a static stack, an array of portSTACK_TYPE whose size is
+/// the stack depth. The kernel allocates only the TCB. A task on a static
+/// stack must never be deleted.
+#define FSW_TASK_CREATE( code, name, stack, parameters, priority )											\
+		xTaskGenericCreate( ( code ), ( const signed char * )( name ),										\
+				( unsigned short )( sizeof( stack ) / sizeof( portSTACK_TYPE ) ), ( parameters ), ( priority ), \
+				NULL, ( stack ), NULL )
+
+#endif /* FSW_MEMMAP_H_ */
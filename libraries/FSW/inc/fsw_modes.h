@@ -65,5 +65,6 @@ enum events { MODEsafe, MODEnominal, MODElink, MODEerp, MAX_EVENTS } new_event;
 xQueueHandle FSW_MODES_CMDqueue;			///< Modes module command queue.
 
 void FSW_MODES_Init( void );				///< Initialize the modes module.
+void FSW_MODES_SatModeMan( void );			///< Periodic job: mode actions and transitions of the satellite.
 
 #endif /* FSW_MODES_H_ */
@@ -0,0 +1,86 @@
+/***************************************************************************//**
+ * @file	fsw_periodic.h
+ * @brief	FSW periodic task schedule header file.
+ *
+ * This header file contains the interface to the schedule of the periodic
+ * flight software tasks. Each periodic task is a job, a function that does
+ * one period's work and returns, listed in the schedule table with its period,
+ * deadline, priority and stack, a static array of its own. The schedule creates
+ * a task for every job on its stack and releases it on a fixed grid of ticks.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_PERIODIC_H_
+#define FSW_PERIODIC_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the periodic task schedule.
+ * @{
+ ******************************************************************************/
+
+#define FSW_PERIODIC_MAXTASKS	5			///< Most jobs in the schedule table. Sizes the telemetry.
+
+/// Priorities of the periodic tasks, rate monotonic: the shorter the period,
+/// the higher the priority. The command and data managers, which block on
+/// their queues, run below them at priority 1.
+#define FSW_PERIODIC_PRIO_1S	3			///< Jobs released every second.
+#define FSW_PERIODIC_PRIO_SLOW	2			///< Jobs released less often.
+
+/// A job of the schedule table.
+typedef struct{
+	void ( *job )( void );					///< One period's work. Must return, and never block for long.
+	const char *name;						///< Task name.
+	uint16_t periodMs;						///< Time between releases, a whole number of ticks.
+	uint16_t deadlineMs;					///< Time after its release the job must have finished by, at most the period.
+	unsigned portBASE_TYPE priority;		///< Task priority, by period.
+	portSTACK_TYPE *stack;					///< Task stack, a static array of stackDepth words.
+	unsigned short stackDepth;				///< Task stack, in words. Its FSW_STACK_ define in fsw_memmap.h.
+}FSW_PERIODIC_Task_TypeDef;
+
+/// Timing of a job, reported in telemetry. Times are from the job's release
+/// on the tick grid, measured on the RTC.
+typedef struct{
+	uint32_t releases;						///< Periods run.
+	uint32_t misses;						///< Periods finished after the deadline.
+	uint32_t worstJitterUs;					///< Latest start after a release.
+	uint32_t worstResponseUs;				///< Latest finish after a release.
+}FSW_PERIODIC_Stats_TypeDef;
+
+void    FSW_PERIODIC_Init( void );										///< Create a task for every job in the schedule table. Call after every module is initialised.
+uint8_t FSW_PERIODIC_count( void );										///< Jobs in the schedule table.
+void    FSW_PERIODIC_getStats( uint8_t task, FSW_PERIODIC_Stats_TypeDef *stats );	///< Snapshot of a job's timing.
+
+#endif /* FSW_PERIODIC_H_ */
@@ -0,0 +1,76 @@
+/***************************************************************************//**
+ * @file	fsw_scheduler.h
+ * @brief	FSW time-tagged command scheduler header file.
+ *
+ * This header file contains the interface to the fixed capacity command
+ * scheduler used by the C&DH module to hold time-tagged commands.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_SCHEDULER_H_
+#define FSW_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include "fsw_cdh.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+#define FSW_SCHED_NONE		0xFFFF			///< Invalid handle / unused heap position.
+
+/// A command held by the scheduler.
+typedef struct{
+	CDH_CMD_TypeDef CMD;					///< The scheduled command.
+	uint32_t seq;							///< Insertion order, breaks ties between equal execution times.
+	uint16_t heapIndex;						///< Position in the heap, FSW_SCHED_NONE when the slot is free.
+}FSW_SCHED_Entry_TypeDef;
+
+/// Scheduler instance. Storage is supplied by the owner so no memory is allocated at run time.
+typedef struct{
+	FSW_SCHED_Entry_TypeDef *pool;			///< Command slots, capacity entries.
+	uint16_t *heap;							///< Min-heap of slot indices ordered by execution time, capacity entries.
+	uint16_t *freeSlots;					///< Stack of unused slot indices, capacity entries.
+	uint16_t capacity;						///< Maximum number of scheduled commands.
+	uint16_t count;							///< Number of scheduled commands.
+	uint16_t freeCount;						///< Number of unused slots.
+	uint32_t seq;							///< Next insertion sequence number.
+}FSW_SCHED_TypeDef;
+
+void     FSW_SCHED_Init( FSW_SCHED_TypeDef *sched, FSW_SCHED_Entry_TypeDef *pool, uint16_t *heap, uint16_t *freeSlots, uint16_t capacity );	///< Initialise an empty scheduler.
+uint16_t FSW_SCHED_insert( FSW_SCHED_TypeDef *sched, const CDH_CMD_TypeDef *CMD );		///< Schedule a command, returns its handle.
+uint8_t  FSW_SCHED_cancel( FSW_SCHED_TypeDef *sched, uint16_t handle );					///< Remove a scheduled command.
+const CDH_CMD_TypeDef *FSW_SCHED_peek( const FSW_SCHED_TypeDef *sched );				///< The earliest scheduled command.
+uint8_t  FSW_SCHED_popDue( FSW_SCHED_TypeDef *sched, uint32_t now, CDH_CMD_TypeDef *CMD );	///< Remove the earliest command if it is due.
+
+#endif /* FSW_SCHEDULER_H_ */
@@ -0,0 +1,89 @@
+/***************************************************************************//**
+ * @file	fsw_tlmstore.h
+ * @brief	FSW telemetry store header file.
+ *
+ * This header file describes the table of telemetry values served to the
+ * ground. Each telemetry ID has one producer, the module that owns the values,
+ * which publishes a new snapshot whenever it updates them. A telemetry request
+ * is answered with the latest snapshot, so the UART and I2C reply paths copy a
+ * few bytes instead of gathering the values themselves, and take the same time
+ * for every ID.
+ *
+ * Every entry is double buffered: a producer writes the buffer the readers are
+ * not using and then publishes it by counting the update. An interrupt handler
+ * reading an entry always sees a complete snapshot, even if it interrupted the
+ * producer halfway through an update. A task reading an entry copies it again
+ * if a producer published while it was copying.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef FSW_TLMSTORE_H_
+#define FSW_TLMSTORE_H_
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Sofware (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the telemetry store.
+ * @{
+ ******************************************************************************/
+
+#define FSW_TLM_IDBASE		0x80		///< First telemetry ID.
+#define FSW_TLM_IDCOUNT		32			///< Telemetry IDs in the store, from FSW_TLM_IDBASE.
+#define FSW_TLM_MAXLEN		32			///< Longest telemetry value, in bytes.
+
+/// Telemetry IDs, and the module publishing each.
+#define FSW_TLM_STATUS		0x80		///< Seconds since boot, firmware version. Comms.
+#define FSW_TLM_COMMSTATUS	0x81		///< Telecommands and telemetry requests served, comms error. Comms.
+#define FSW_TLM_TCMDACK		0x82		///< Last telecommand, whether all have been executed, its error. Comms.
+#define FSW_TLM_TIME		0x83		///< Seconds since start up and milliseconds, from the RTC. Read live by comms, not stored.
+#define FSW_TLM_CMDPOOL		0x84		///< Command pool usage. HandH.
+#define FSW_TLM_ROUTER		0x85		///< Command router rejections. HandH.
+#define FSW_TLM_LOGWRITER	0x86		///< Log writer counters. HandH.
+#define FSW_TLM_CACHE		0x87		///< Sector cache counters. HandH.
+#define FSW_TLM_LINK		0x88		///< Link protocol counters. Comms.
+#define FSW_TLM_HKSERIES	0x89		///< Housekeeping series counters. HandH.
+#define FSW_TLM_ENERGY		0x8A		///< Time in each energy mode, sleeps and ticks over the last second. HandH.
+#define FSW_TLM_TASKS		0x8B		///< CPU share of the busiest tasks over the last second. HandH.
+#define FSW_TLM_SCHEDULE	0x8C		///< Deadline misses, worst start jitter and response of each periodic job. HandH.
+#define FSW_TLM_OBCTIME		0x92		///< OBC date and time, clock trim, error at the last sync and syncs. HandH.
+
+/// One telemetry ID's value.
+typedef struct{
+	volatile uint32_t published;					///< Updates published. The latest is in data[published & 1].
+	uint8_t len[2];									///< Bytes of each buffer
+	uint8_t data[2][FSW_TLM_MAXLEN];
+}FSW_TLM_Entry_TypeDef;
+
+uint8_t  FSW_TLM_publish( uint8_t id, const void *data, uint8_t len );	///< Publish a new value, from the ID's producer.
+uint8_t  FSW_TLM_read( uint8_t id, uint8_t *data );					///< Copy out the latest value, from a task or an interrupt handler.
+uint32_t FSW_TLM_updates( uint8_t id );								///< Updates published for an ID.
+
+#endif /* FSW_TLMSTORE_H_ */
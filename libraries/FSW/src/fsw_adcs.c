@@ -28,6 +28,7 @@
  ******************************************************************************/
 
 #include "fsw_adcs.h"
+#include "fsw_memmap.h"
 
 /***************************************************************************//**
  * @addtogroup FSW_Library
@@ -50,13 +51,55 @@
 static uint8_t FSW_ADCS_mode = 0;					///< Current mode for ADCS module.			for a mode 0=off, 1=safe, 2=on, 4=ERP
 static uint8_t FSW_ADCS_MSV = 0;					///< Module Status Vector for ADCS module.
 
+/// CubeSense telemetry read through the I2C bus scheduler.
+typedef struct{
+	uint8_t id;										///< Telemetry ID, also the request written
+	volatile uint8_t busy;							///< Queued and not yet completed
+	uint8_t tlm[16];								///< Telemetry read
+}ADCS_CubeSenseTlm_TypeDef;
+
+static ADCS_CubeSenseTlm_TypeDef FSW_ADCS_tlmIdentification = { CubeSenseTlmIdIdentification };
+static ADCS_CubeSenseTlm_TypeDef FSW_ADCS_tlmCommsStatus = { CubeSenseTlmIdCommsStatus };
+static ADCS_CubeSenseTlm_TypeDef FSW_ADCS_tlmSun = { CubeSenseTlmIdSunSensor };
+static ADCS_CubeSenseTlm_TypeDef FSW_ADCS_tlmNadir = { CubeSenseTlmIdNadirSensor };
+static ADCS_CubeSenseTlm_TypeDef FSW_ADCS_tlmPower = { CubeSenseTlmIdPower };
+
+static CUBESENSE_TlmIdentification_TypeDef FSW_ADCS_cubeSenseId;			///< Last CubeSense telemetry read
+static CUBESENSE_TlmCommsStatus_TypeDef FSW_ADCS_cubeSenseComms;
+static CUBESENSE_TlmSunSensor_TypeDef FSW_ADCS_cubeSenseSun;
+static CUBESENSE_TlmNadirSensor_TypeDef FSW_ADCS_cubeSenseNadir;
+static CUBESENSE_TlmPower_TypeDef FSW_ADCS_cubeSensePower;
+
 static void FSW_ADCS_reportHealthStatus( void );	///< Reports the subsystem's mode and MSV
 static void FSW_ADCS_modeChange( uint8_t newMode );	///< Changes the mode and runs associated procedures
 static void FSW_ADCS_readTelemetry( void );			///< Debugging function.
 static void FSW_ADCS_runAlgorithm( void );			///< Debugging function.
+static void FSW_ADCS_requestCubeSense( ADCS_CubeSenseTlm_TypeDef *tlm );	///< Queue a CubeSense telemetry read.
+static void FSW_ADCS_cubeSenseDone( const COMM_I2Cmsg_TypeDef *msg );		///< Update the CubeSense telemetry read.
 
 static void FSW_ADCS_manager( void *pvParameters );	///< Processes and executes commands on the ADCS command queue.
-static void FSW_ADCS_ADCSexe( void *pvParameters );	///< Runs ADCS libraries each second according to what mode the satellite is in.
+static portSTACK_TYPE FSW_ADCS_managerStack[ FSW_STACK_ADCS ];
+
+static void FSW_ADCS_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_ADCS_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+static void FSW_ADCS_CMDreadTelemetry( const CDH_CMD_TypeDef *CMD );
+static void FSW_ADCS_CMDrunAlgorithm( const CDH_CMD_TypeDef *CMD );
+static void FSW_ADCS_CMDcubeSenseStatus( const CDH_CMD_TypeDef *CMD );
+static void FSW_ADCS_CMDcubeSenseComms( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_ADCS_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,								NULL,				0,	0				},		// 0x00
+		{ FSW_ADCS_CMDreportHealth,			&FSW_ADCS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Transmit the module's mode and MSV over UART
+		{ FSW_ADCS_CMDmodeChange,			&FSW_ADCS_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x02 Change the module's mode
+		{ FSW_ADCS_CMDreadTelemetry,		&FSW_ADCS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x03 Test CMD
+		{ FSW_ADCS_CMDrunAlgorithm,			&FSW_ADCS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x04 Test CMD
+		{ FSW_ADCS_CMDcubeSenseStatus,		&FSW_ADCS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x05 Send a status TLM request to CubeSense
+		{ FSW_ADCS_CMDcubeSenseComms,		&FSW_ADCS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x06 Send a comm status TLM request to CubeSense
+		{ NULL,								NULL,				0,	0				}		// 0x07
+};
+/*************************************************************************************************************************************/
 
 // FUNCTIONS *************************************************************************************************************************
 
@@ -69,7 +112,7 @@ static void FSW_ADCS_ADCSexe( void *pvParameters );	///< Runs ADCS libraries eac
 
 void FSW_ADCS_Init( void )
 {
-	FSW_ADCS_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_ADCS_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
 
 	if( FSW_ADCS_CMDqueue == NULL )
 	{
@@ -81,8 +124,7 @@ void FSW_ADCS_Init( void )
 		FSW_ADCS_mode = 1;
 		FSW_ADCS_MSV = 0;
 
-		xTaskCreate( FSW_ADCS_manager, "ADCSmanager", 240, NULL, 1, NULL );
-		xTaskCreate( FSW_ADCS_ADCSexe, "ADCSexe", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_ADCS_manager, "ADCSmanager", FSW_ADCS_managerStack, NULL, 1 );
 	}
 }
 
@@ -97,18 +139,13 @@ void FSW_ADCS_Init( void )
 
 static void FSW_ADCS_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_ADCS_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_ADCS_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_ADCS_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_ADCS_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -156,6 +193,11 @@ static void FSW_ADCS_modeChange( uint8_t newMode )
 void FSW_ADCS_readTelemetry( void )
 {
 	printString("ADCS module: Reading Telemetry Data\n");
+
+	// Queued together, so the I2C manager reads them in one bus session
+	FSW_ADCS_requestCubeSense( &FSW_ADCS_tlmSun );
+	FSW_ADCS_requestCubeSense( &FSW_ADCS_tlmNadir );
+	FSW_ADCS_requestCubeSense( &FSW_ADCS_tlmPower );
 }
 
 void FSW_ADCS_runAlgorithm( void )
@@ -163,75 +205,152 @@ void FSW_ADCS_runAlgorithm( void )
 	printString("ADCS module: Running ADCS algorithms\n");
 }
 
-// TASKS *****************************************************************************************************************************
-
 /***************************************************************************//**
  * @author Andre Heunis
- * @date   05/09/2013
+ * @date   16/10/2026
  *
- * Subsystem manager for ADCS interface module. Processes and executes commands
- * on the ADCS command queue.
+ * This function queues a CubeSense telemetry read for the I2C manager, unless
+ * the last read of the same telemetry has not completed yet. The telemetry is
+ * decoded by FSW_ADCS_cubeSenseDone when it arrives.
+ *
+ * @param[in] tlm
+ *   Telemetry to read.
  ******************************************************************************/
 
-static void FSW_ADCS_manager( void *pvParameters )
+static void FSW_ADCS_requestCubeSense( ADCS_CubeSenseTlm_TypeDef *tlm )
 {
-	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
-	uint8_t I2Cbuffer[64];				///< Buffer for data to be sent over I2C bus
-	int32_t I2Clen = 0;					///< Length of data to be sent over I2C bus
 	COMM_I2Cmsg_TypeDef I2Cmsg;			///< Structure to populate with desired I2C message
+	int32_t tlmLen;
 
-	while(1)
+	if( tlm->busy )
 	{
-		Status = xQueueReceive( FSW_ADCS_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		return;
+	}
 
-		if(Status == pdPASS)
+	// Add tlm id to buffer and retrieve length of TLM to be received
+	tlmLen = CUBESENSE_createTelemetryRequest( &tlm->id, ( CUBESENSE_TelemetryID_TypeDef )tlm->id );
+	if( tlmLen <= 0 || tlmLen > sizeof( tlm->tlm ) )
+	{
+		return;
+	}
+
+	FSW_I2CBUS_construct( &I2Cmsg, bspI2cWriteRead, &tlm->id, 1, tlm->tlm, ( uint16_t )tlmLen, FSW_ADCS, I2CADDR_CUBESENSE_W );
+	I2Cmsg.done = FSW_ADCS_cubeSenseDone;
+	I2Cmsg.context = tlm;
+
+	tlm->busy = 1;
+	if( FSW_I2CBUS_submit( FSW_COMM_I2Cqueue, &I2Cmsg, 0 ) != pdTRUE )
+	{
+		tlm->busy = 0;
+		FSW_ADCS_MSV |= ERROR_CMDINV;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Called by the I2C manager when a CubeSense telemetry read completes. Decodes
+ * the telemetry into its structure if it was read.
+ *
+ * @param[in] msg
+ *   The completed message.
+ ******************************************************************************/
+
+static void FSW_ADCS_cubeSenseDone( const COMM_I2Cmsg_TypeDef *msg )
+{
+	ADCS_CubeSenseTlm_TypeDef *tlm = ( ADCS_CubeSenseTlm_TypeDef* )msg->context;
+
+	if( msg->status == bspI2cOk )
+	{
+		switch( tlm->id )
 		{
-			switch(ReceivedCMD.id)
-			{
-			case 0x01:													// Transmit the module's mode and MSV over UART
-				FSW_ADCS_reportHealthStatus();
-				break;
+		case CubeSenseTlmIdIdentification:
+			CUBESENSE_updateTlmIdentification( &FSW_ADCS_cubeSenseId, tlm->tlm );
+			break;
+		case CubeSenseTlmIdCommsStatus:
+			CUBESENSE_updateTlmCommsStatus( &FSW_ADCS_cubeSenseComms, tlm->tlm );
+			break;
+		case CubeSenseTlmIdSunSensor:
+			CUBESENSE_updateTlmSunSensor( &FSW_ADCS_cubeSenseSun, tlm->tlm );
+			break;
+		case CubeSenseTlmIdNadirSensor:
+			CUBESENSE_updateTlmNadirSensor( &FSW_ADCS_cubeSenseNadir, tlm->tlm );
+			break;
+		case CubeSenseTlmIdPower:
+			CUBESENSE_updateTlmPower( &FSW_ADCS_cubeSensePower, tlm->tlm );
+			break;
+		default:
+			break;
+		}
+	}
+
+	tlm->busy = 0;
+}
 
-			case 0x02:													// Change the modules mode and run any associated procedures
-				FSW_ADCS_modeChange( (uint8_t)ReceivedCMD.params[0] );
-				break;
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the ADCS module's entries in the routing table.
+ * They run in the FSW_ADCS_manager task.
+ ******************************************************************************/
 
-			case 0x03:													// Test CMD
-				FSW_ADCS_readTelemetry();
-				break;
+static void FSW_ADCS_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_reportHealthStatus();
+}
 
-			case 0x04:													// Test CMD
-				FSW_ADCS_runAlgorithm();
-				break;
+static void FSW_ADCS_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_modeChange( (uint8_t)CMD->params[0] );
+}
 
-			case 0x05:													// Send a status TLM request to CubeSense
-				// Add tlm id to buffer and retrieve length of TLM to be received
-				I2Clen = CUBESENSE_createTelemetryRequest(I2Cbuffer, CubeSenseTlmIdIdentification);
+static void FSW_ADCS_CMDreadTelemetry( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_readTelemetry();
+}
 
-				// Construct data (TLM buffer and length) to send to the I2C manager. Will need to include I2C write address of CubeSense somehow
-				FSW_COMM_constructI2Cmsg( &I2Cmsg, I2Cbuffer, FSW_ADCS, I2CADDR_CUBESENSE_W, I2Clen );
+static void FSW_ADCS_CMDrunAlgorithm( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_runAlgorithm();
+}
 
-				// Send buffer and length to i2c manager to be transmitted to CubeSense
-				xQueueSendToBack( FSW_COMM_I2Cqueue, &I2Cmsg, 0 );
+static void FSW_ADCS_CMDcubeSenseStatus( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_requestCubeSense( &FSW_ADCS_tlmIdentification );
+}
 
-				// Receive TLM data back here?
+static void FSW_ADCS_CMDcubeSenseComms( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_ADCS_requestCubeSense( &FSW_ADCS_tlmCommsStatus );
+}
 
-				// Update TLM structure?
-				int8_t CUBESENSE_updateTlmIdentification(CUBESENSE_TlmIdentification_TypeDef* identification, uint8_t* tlmBuffer);
-				break;
+// TASKS *****************************************************************************************************************************
 
-			case 0x06:													// Send a comm status TLM request to CubeSense
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   05/09/2013
+ *
+ * Subsystem manager for ADCS interface module. Processes and executes commands
+ * on the ADCS command queue.
+ ******************************************************************************/
 
-				//int8_t CUBESENSE_updateTlmCommsStatus(CUBESENSE_TlmCommsStatus_TypeDef* commsStatus, uint8_t* tlmBuffer);
-				//int8_t CUBESENSE_updateTlmCommsStatus(CUBESENSE_TlmCommsStatus_TypeDef* commsStatus, uint8_t* tlmBuffer);
+static void FSW_ADCS_manager( void *pvParameters )
+{
+	portBASE_TYPE Status;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
-				break;
+	while(1)
+	{
+		Status = xQueueReceive( FSW_ADCS_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
-			default:
-				FSW_ADCS_MSV &= ERROR_CMDINV;
-				while(1);
-				break;
+		if(Status == pdPASS)
+		{
+			// Runs the handler listed in FSW_ADCS_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
+			{
+				FSW_ADCS_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
@@ -244,44 +363,36 @@ static void FSW_ADCS_manager( void *pvParameters )
  * @author Andre Heunis
  * @date   17/10/2013
  *
- * Runs ADCS libraries periodically each second according to what mode the
- * satellite is in.
+ * Job to run the ADCS libraries according to what mode the satellite is in,
+ * released every second by the periodic task schedule.
  ******************************************************************************/
 
-static void FSW_ADCS_ADCSexe( void *pvParameters )
+void FSW_ADCS_ADCSexe( void )
 {
-	while(1)
+	switch( current_state )
 	{
-		switch( current_state )
-		{
-		case DETUMBLING_MODE:
-			// Detumble the satellite, read sensors continuously to see when satellite is detumbled
-			break;
-
-		case SAFE_MODE:
-			// Point towards nadir
-			break;
+	case DETUMBLING_MODE:
+		// Detumble the satellite, read sensors continuously to see when satellite is detumbled
+		break;
 
-		case ERP_MODE:
-			// Point towards sun
-			break;
+	case SAFE_MODE:
+		// Point towards nadir
+		break;
 
-		case NOMINAL_MODE:
-			// Point towards sun
-			break;
+	case ERP_MODE:
+		// Point towards sun
+		break;
 
-		case LINK_MODE:
-			// Point antenna towards ground station
-			break;
+	case NOMINAL_MODE:
+		// Point towards sun
+		break;
 
-		default:
-			//printString( "unknown state\n" );
-			break;
-		}
+	case LINK_MODE:
+		// Point antenna towards ground station
+		break;
 
-		vTaskDelay( 1000/portTICK_RATE_MS );
+	default:
+		//printString( "unknown state\n" );
+		break;
 	}
-
-	// Delete the task if it ever breaks out of the loop above
-	vTaskDelete( NULL );
 }
@@ -29,13 +29,22 @@
  ******************************************************************************/
 
 #include "fsw_cdh.h"
+#include "fsw_scheduler.h"
+#include "fsw_cmdpool.h"
+#include "fsw_memmap.h"
 
 #define CMD_QLEN		6
 #define DIARY_QLEN		6
+#define SCHED_LEN		256			///< Maximum number of time-tagged commands held at once.
+#define SCHED_MAXWAIT	3600		///< Longest the schedule timer is armed for in seconds. Re-armed on expiry.
+#define SCHED_RETRYMS	100			///< Re-check period when the timer expires before OBC time catches up.
+#define SCHED_REARMMS	10			///< Longest processCMD waits for room in the timer command queue.
 
 /// Definitions for FSW_CDH_HEALTH masks.
 #define ERROR_INIT		0x01		///< Module initialization error.
 #define ERROR_CMDINV	0x02		///< Invalid command received.
+#define ERROR_SCHEDFULL	0x04		///< Time-tagged command dropped, schedule full.
+#define ERROR_SCHEDTIMER	0x08		///< Schedule timer could not be re-armed, timer command queue full.
 
 /***************************************************************************//**
  * @addtogroup FSW_Library
@@ -53,28 +62,63 @@ static uint8_t FSW_CDH_MSV = 0;								///< Health status byte for C&DH module
 static uint8_t FSW_CDH_mode = 0;
 
 // Data used to schedule commands
-typedef struct node{
-	CDH_CMD_TypeDef CMD_entry;
-	struct node *next;
-}NODE;
-
-xSemaphoreHandle LinkedListMutex;							///< Prevents simultaneously adding and removing an element from the CMD schedule linked list
-NODE *rootNode;												///< The constant first node in the LL
-NODE *currentNode;											///< Temporary NODE used to traverse the LL
-NODE *prevNode;												///< Tracks the node behind the current node
-NODE *tempNode;												///< Used to add a new list element in the middle of the list
-
-// Software timers for command scheduling
-xTimerHandle CMDsched_timer;
+static FSW_SCHED_TypeDef CMDschedule;						///< Pending time-tagged commands, earliest first
+static FSW_SCHED_Entry_TypeDef CMDschedule_pool[SCHED_LEN];
+static uint16_t CMDschedule_heap[SCHED_LEN];
+static uint16_t CMDschedule_free[SCHED_LEN];
+
+static xSemaphoreHandle CMDschedMutex;						///< Serialises the schedule between processCMD and the timer callback
+
+// Single software timer, always armed for the earliest scheduled command
+static xTimerHandle CMDsched_timer;
+static volatile bool CMDsched_pending;						///< The last re-arm failed, processCMD retries it
 static void CMDsched_Callback( xTimerHandle xTimer );		///< Callback function to schedule CMD when timer expires
+static portBASE_TYPE CMDsched_rearm( portTickType retryTicks, portTickType blockTicks );	///< Arms the schedule timer for the earliest command
 
-static void scheduleCMD( CDH_CMD_TypeDef CMD );
+static void scheduleCMD( const CDH_CMD_TypeDef *CMD );
 static void testCMD_initialize( void );						///< Definitions for commands
 static void FSW_CDH_reportHealthStatus( void );				///< Reports the subsystem's mode and MSV
 static void FSW_CDH_modeChange( uint8_t newMode );			///< Changes the module's mode and runs any associated procedures
 
 static void FSW_CDH_processCMD( void *pvParameters );		///< Processes commands on the management level command queue.
 static void FSW_CDH_processDIARY( void *pvParameters );		///< Processes diaries on the management level diary queue.
+static portSTACK_TYPE FSW_CDH_processCMDstack[ FSW_STACK_CDH_CMD ];
+static portSTACK_TYPE FSW_CDH_processDIARYstack[ FSW_STACK_CDH_DIARY ];
+
+static void FSW_CDH_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_CDH_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+static void CMDreject( CDH_CMD_TypeDef *CMD, uint8_t error );	///< Flags and counts a rejected command
+
+/*ROUTING TABLE***********************************************************************************************************************/
+// Commands run in the C&DH task itself, so no queue
+const CDH_Route_TypeDef FSW_CDH_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,						NULL,	0,	0				},		// 0x00
+		{ FSW_CDH_CMDreportHealth,	NULL,	0,	CDH_MODES_ALL	},		// 0x01 Return status telemetry
+		{ FSW_CDH_CMDmodeChange,	NULL,	1,	CDH_MODES_ALL	},		// 0x02 Change the module's mode
+		{ NULL,						NULL,	0,	0				},		// 0x03
+		{ NULL,						NULL,	0,	0				},		// 0x04
+		{ NULL,						NULL,	0,	0				},		// 0x05
+		{ NULL,						NULL,	0,	0				},		// 0x06
+		{ NULL,						NULL,	0,	0				}		// 0x07
+};
+
+// Row of every destination, indexed by CDH_CMD_TypeDef.dest and then by CDH_CMD_TypeDef.id
+static const CDH_Route_TypeDef * const CDH_routeTable[CDH_ROUTE_DESTCOUNT] = {
+
+		NULL,
+		FSW_ADCS_routes,		// FSW_ADCS
+		FSW_CDH_routes,			// FSW_CDH
+		FSW_COMM_routes,		// FSW_COMM
+		FSW_FS_routes,			// FSW_FS
+		FSW_HANDH_routes,		// FSW_HANDH
+		FSW_MODES_routes,		// FSW_MODES
+		FSW_PAYLOAD_routes,		// FSW_PAYLOAD
+		FSW_POWER_routes		// FSW_POWER
+};
+
+static CDH_RouteStats_TypeDef CDH_routeStats;					///< Commands rejected by the router
+/*************************************************************************************************************************************/
 
 // FUNCTIONS *************************************************************************************************************************
 
@@ -87,19 +131,18 @@ static void FSW_CDH_processDIARY( void *pvParameters );		///< Processes diaries
  ******************************************************************************/
 void FSW_CDH_Init( void )
 {
-	// Create the first node of the linked list to store scheduled commands
-	rootNode = (NODE *) malloc( sizeof(NODE) );
-	rootNode->next = 0;																// Initially root points to NULL. (no CMDs queued yet)
-	rootNode->CMD_entry.id = 0x99;	// FOR DEBUGGING
-	currentNode = rootNode;															// Set the pointer used to traverse the list to the first list entry
+	// Static schedule for time-tagged commands and the single timer that drives it
+	FSW_SCHED_Init( &CMDschedule, CMDschedule_pool, CMDschedule_heap, CMDschedule_free, SCHED_LEN );
+	CMDschedMutex = xSemaphoreCreateMutex();
+	CMDsched_timer = xTimerCreate( ( const signed char * )"CMDsched_timer", 1, pdFALSE, ( void * ) 1, CMDsched_Callback );
 
-	FSW_CDH_CMDqueue = xQueueCreate( CMD_QLEN, sizeof( CDH_CMD_TypeDef ) );			// Receives CMD's
-	FSW_CDH_DIARYqueue = xQueueCreate( DIARY_QLEN, sizeof( CDH_Diary_TypeDef ) );	// Receives diarys
+	FSW_CDH_CMDqueue = xQueueCreate( CMD_QLEN, sizeof( CDH_CMDhandle_TypeDef ) );		// Receives CMD's
+	FSW_CDH_DIARYqueue = xQueueCreate( DIARY_QLEN, sizeof( CDH_DiaryRef_TypeDef ) );	// Receives diarys
 
-	if( ( FSW_CDH_DIARYqueue != NULL ) && ( FSW_CDH_CMDqueue != NULL ) )
+	if( ( FSW_CDH_DIARYqueue != NULL ) && ( FSW_CDH_CMDqueue != NULL ) && ( CMDschedMutex != NULL ) && ( CMDsched_timer != NULL ) )
 	{
-		xTaskCreate( FSW_CDH_processCMD, "processCMD", 240, NULL, 1, NULL );		// Continuously processes commands waiting on the command queue
-		xTaskCreate( FSW_CDH_processDIARY, "processDIARY", 240, NULL, 1, NULL );	// Continuously processes diaries waiting on the diary queue
+		FSW_TASK_CREATE( FSW_CDH_processCMD, "processCMD", FSW_CDH_processCMDstack, NULL, 1 );		// Continuously processes commands waiting on the command queue
+		FSW_TASK_CREATE( FSW_CDH_processDIARY, "processDIARY", FSW_CDH_processDIARYstack, NULL, 1 );	// Continuously processes diaries waiting on the diary queue
 
 		FSW_CDH_MSV = 0;
 		FSW_CDH_mode = 1;
@@ -118,119 +161,267 @@ void FSW_CDH_Init( void )
  * @date   14/10/2013
  *
  * This function schedules a command for execution at a future date by adding it
- * to the queue for scheduled commands and setting a timer to read from that
- * queue at the required time. The command is inserted into the queue in
- * chronological order.
+ * to the command schedule and re-arming the schedule timer if the command is
+ * now the earliest. Commands whose execution time has already passed are
+ * dropped.
  *
- * @param[in]
- * 		The CMD to be scheduled
+ * @param[in] CMD
+ * 		The CMD to be scheduled. It is copied into the schedule.
  ******************************************************************************/
-static void scheduleCMD( CDH_CMD_TypeDef CMD )
+static void scheduleCMD( const CDH_CMD_TypeDef *CMD )
 {
-	xSemaphoreTake( LinkedListMutex, portMAX_DELAY );
+	uint16_t handle;
+
+	if( getOBC_time() >= CMD->exe_time )
 	{
-		if( CMD.resched_cnt == 0 )				// If multiple periodic executions are NOT required...
-		{
-			// Initialize freeRTOS software timer for scheduling commands
-			// How can separate timers have the same handle, id, etc?
-			if( getOBC_time() < CMD.exe_time )
-			{
-				CMDsched_timer =  xTimerCreate
-						( "CMDsched_timer",
-								( CMD.exe_time - getOBC_time() )*1000/portTICK_RATE_MS,
-								pdFALSE,
-								( void * ) 1,
-								CMDsched_Callback );
-
-				// Store CMD in the linked list for extraction by timer callback function
-				currentNode = rootNode;
-
-				// Check if no other commands are pending execution
-				if( rootNode->next == NULL )
-				{
-					rootNode->next = (NODE *)malloc( sizeof(NODE) );	// Create a new node
-					currentNode = rootNode->next;
-					if( currentNode != NULL )
-					{
-						currentNode->CMD_entry = CMD;						// Store scheduled CMD
-						currentNode->next = NULL;							// Next pointer is NULL
-					}
-					else
-					{
-						// out of memory error
-					}
-				}
-				else
-				{
-					// Increment past root node to prevent comparison to rootNodes exe time of zero
-					do{
-						prevNode = currentNode;
-						currentNode = currentNode->next;
-					}while( CMD.exe_time < currentNode->CMD_entry.exe_time );		// Find point in the list to enter new node
-
-					tempNode = (NODE *)malloc( sizeof(NODE) );						// assign new memory for the new CMD
-
-					if( tempNode != NULL )
-					{
-						prevNode->next = tempNode;
-						tempNode->next = currentNode;
-						tempNode->CMD_entry = CMD;
-					}
-					else
-					{
-						// out of memory error
-					}
-				}
+		return;
+	}
 
-				// Start timer
-				xTimerStart( CMDsched_timer, 0 );
-			}
+	xSemaphoreTake( CMDschedMutex, portMAX_DELAY );
+	{
+		handle = FSW_SCHED_insert( &CMDschedule, CMD );
+
+		if( handle == FSW_SCHED_NONE )
+		{
+			FSW_CDH_MSV |= ERROR_SCHEDFULL;
 		}
-		else											// ...else initialise timer with a reload
+		else if( CMDschedule_pool[handle].heapIndex == 0 || CMDsched_pending )	// New earliest command
 		{
-			// Initialise timers with autoreload capabilities
+			CMDsched_rearm( 0, SCHED_REARMMS / portTICK_RATE_MS );
 		}
 	}
-	xSemaphoreGive( LinkedListMutex );
+	xSemaphoreGive( CMDschedMutex );
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Arms the schedule timer to expire when the earliest scheduled command is due,
+ * or stops it if nothing is scheduled. Must be called with CMDschedMutex held.
+ * The timer commands go through the timer daemon's queue, which a burst of new
+ * earliest commands can fill. A command that does not fit sets ERROR_SCHEDTIMER
+ * and leaves the re-arm pending, and processCMD tries again until it fits.
+ *
+ * @param[in] retryTicks
+ * 		Period to use if the earliest command is already due by OBC time but has
+ * 		not been dispatched, 0 to compute it from the execution time alone.
+ * @param[in] blockTicks
+ * 		Ticks to wait for room in the timer queue. Must be 0 in the timer callback.
+ * @return
+ * 		pdPASS if the timer command was queued.
+ ******************************************************************************/
+static portBASE_TYPE CMDsched_rearm( portTickType retryTicks, portTickType blockTicks )
+{
+	portBASE_TYPE result;
+	const CDH_CMD_TypeDef *next = FSW_SCHED_peek( &CMDschedule );
+	uint32_t now, wait;
+	portTickType ticks;
+
+	if( next == NULL )
+	{
+		result = xTimerStop( CMDsched_timer, blockTicks );
+	}
+	else
+	{
+		now = getOBC_time();
+		wait = ( next->exe_time > now ) ? next->exe_time - now : 0;
+		if( wait > SCHED_MAXWAIT )
+		{
+			wait = SCHED_MAXWAIT;
+		}
+
+		ticks = ( wait * 1000 ) / portTICK_RATE_MS;
+		if( ticks == 0 )
+		{
+			ticks = ( retryTicks != 0 ) ? retryTicks : 1;
+		}
+
+		result = xTimerChangePeriod( CMDsched_timer, ticks, blockTicks );
+	}
+
+	CMDsched_pending = ( result != pdPASS );
+	if( CMDsched_pending )
+	{
+		FSW_CDH_MSV |= ERROR_SCHEDTIMER;
+	}
+
+	return result;
+}
 
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   10/10/2013
- * This function is called when a timer used to schedule a CMD expires. It
- * assumes that the queue containing all the scheduled commands is in order
- * and that the front item is the next to be executed.
+ * This function is called when the schedule timer expires. Every command that
+ * is due is sent to the command queue with an exe_time of 0 for instant
+ * execution. Periodic commands with repetitions left are put back on the
+ * schedule for their next execution. The timer is then re-armed for the next
+ * command. It runs in the timer daemon, so it never waits: if processCMD holds
+ * the schedule, the timer is only set to look again SCHED_RETRYMS later.
  * @param[in] xTimer
  				Timer from which the callback function was run
  ******************************************************************************/
-// TODO: Possibly use mutual exclusion to prevent this function reading from the LL while a new CMD is being added to it
 static void CMDsched_Callback( xTimerHandle xTimer )
 {
 	CDH_CMD_TypeDef CMD;
+	uint32_t now = getOBC_time();
 
-	xSemaphoreTake( LinkedListMutex, portMAX_DELAY );
+	// processCMD is changing the schedule, look again shortly
+	if( xSemaphoreTake( CMDschedMutex, 0 ) != pdPASS )
 	{
-		//loop through list to find the end
-		currentNode = rootNode;
+		if( xTimerChangePeriod( xTimer, SCHED_RETRYMS / portTICK_RATE_MS, 0 ) != pdPASS )
+		{
+			CMDsched_pending = true;
+			FSW_CDH_MSV |= ERROR_SCHEDTIMER;
+		}
+		return;
+	}
 
-		while( currentNode->next != NULL )
+	while( FSW_SCHED_popDue( &CMDschedule, now, &CMD ) )
+	{
+		if( CMD.resched_cnt != 0 && CMD.resched_period != 0 )
 		{
-			prevNode = currentNode;
-			currentNode = currentNode->next;
+			CMD.resched_cnt--;
+			CMD.exe_time += CMD.resched_period;
+			FSW_SCHED_insert( &CMDschedule, &CMD );				// Can not fail, a slot was just freed
 		}
 
-		// Extract the last element of the list and execute it
-		CMD = currentNode->CMD_entry;
 		CMD.exe_time = 0;										// Resend CMD with an exe_time of 0, resulting in instant execution
-		xQueueSendToBack( FSW_CDH_CMDqueue, &CMD, 0 );
+		CMD.resched_cnt = 0;
+		FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &CMD, 0 );
+	}
+
+	// The timer may expire just before OBC time increments; poll until it does
+	CMDsched_rearm( SCHED_RETRYMS / portTICK_RATE_MS, 0 );
+	xSemaphoreGive( CMDschedMutex );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function looks a command up in the routing table and checks that it may
+ * be executed: the destination and id must have a handler, the command must
+ * carry at least the parameters the handler needs and the satellite must be in
+ * a mode that allows it.
+ *
+ * @param[in] CMD
+ * 		The command to route.
+ * @param[out] route
+ * 		Set to the command's routing table entry if it is valid.
+ * @return
+ * 		CDH_CMDERR_NONE, or the CDH_CMDERR_ code of the check that failed.
+ ******************************************************************************/
+uint8_t FSW_CDH_route( const CDH_CMD_TypeDef *CMD, const CDH_Route_TypeDef **route )
+{
+	const CDH_Route_TypeDef *entry;
+
+	if( CMD->dest >= CDH_ROUTE_DESTCOUNT || CDH_routeTable[CMD->dest] == NULL )
+	{
+		return CDH_CMDERR_DEST;
+	}
+
+	if( CMD->id >= CDH_ROUTE_IDCOUNT || CDH_routeTable[CMD->dest][CMD->id].handler == NULL )
+	{
+		return CDH_CMDERR_ID;
+	}
+
+	entry = &CDH_routeTable[CMD->dest][CMD->id];
+
+	if( CMD->len < entry->paramLen )
+	{
+		return CDH_CMDERR_LEN;
+	}
+
+	if( ( entry->modes & CDH_MODE( current_state ) ) == 0 )
+	{
+		return CDH_CMDERR_MODE;
+	}
+
+	*route = entry;
+	return CDH_CMDERR_NONE;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function is called by a module manager for every command it receives.
+ * The command is validated again, since modules also queue commands to
+ * themselves without going through the C&DH task and the satellite mode may
+ * have changed since routing, and then handed to its handler. The command
+ * block is released afterwards.
+ *
+ * @param[in] handle
+ * 		The command block received on the module's command queue.
+ * @return
+ * 		CDH_CMDERR_NONE if the command was executed, otherwise the reason it was
+ * 		rejected.
+ ******************************************************************************/
+uint8_t FSW_CDH_execute( CDH_CMDhandle_TypeDef handle )
+{
+	CDH_CMD_TypeDef *CMD = FSW_CMDPOOL_get( handle );
+	const CDH_Route_TypeDef *route;
+	uint8_t error;
+
+	error = FSW_CDH_route( CMD, &route );
 
-		// Free the memory used by the last element
-		currentNode = prevNode;									// first set currentNode to previous list entry
-		free( prevNode->next );									// free memory pointed to by previous entry ( i.e. the currentNode entry )
-		currentNode->next = NULL;								// set currentNode entry next pointer to NULL
+	if( error == CDH_CMDERR_NONE )
+	{
+		route->handler( CMD );
+	}
+	else
+	{
+		CMDreject( CMD, error );
 	}
-	xSemaphoreGive( LinkedListMutex );
+
+	FSW_CMDPOOL_release( handle );
+
+	return error;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[out] stats
+ * 		Receives a consistent copy of the reject counters. May be called from
+ * 		the UART interrupt handler.
+ ******************************************************************************/
+void FSW_CDH_getRouteStats( CDH_RouteStats_TypeDef *stats )
+{
+	unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		*stats = CDH_routeStats;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Marks a command as rejected and records it in the router's counters.
+ *
+ * @param[in] CMD
+ * 		The rejected command.
+ * @param[in] error
+ * 		CDH_CMDERR_ code giving the reason.
+ ******************************************************************************/
+static void CMDreject( CDH_CMD_TypeDef *CMD, uint8_t error )
+{
+	CMD->error = error;
+
+	taskENTER_CRITICAL();
+	{
+		CDH_routeStats.rejected++;
+		CDH_routeStats.lastError = error;
+		CDH_routeStats.lastDest = CMD->dest;
+		CDH_routeStats.lastId = CMD->id;
+	}
+	taskEXIT_CRITICAL();
 }
 
 /***************************************************************************//**
@@ -245,7 +436,7 @@ static void testCMD_initialize( void )
 	// Used to command MATLAB to print out mode changes (fsw_modes.c) as well as poll the UART for new data (fsw_comm.c)
 	sim_Data.id = 0x03;
 	sim_Data.dest = FSW_COMM;
-	sim_Data.len = 0;
+	sim_Data.len = 1;
 }
 
 /***************************************************************************//**
@@ -259,18 +450,13 @@ static void testCMD_initialize( void )
 
 static void FSW_CDH_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_CDH_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_CDH_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_CDH_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_CDH_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -308,6 +494,23 @@ static void FSW_CDH_modeChange( uint8_t newMode )
 	}
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the C&DH module's entries in the routing table.
+ ******************************************************************************/
+
+static void FSW_CDH_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_CDH_reportHealthStatus();
+}
+
+static void FSW_CDH_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_CDH_modeChange( (uint8_t)CMD->params[0] );
+}
+
 // TASKS *****************************************************************************************************************************************************************
 
 /***************************************************************************//**
@@ -324,72 +527,61 @@ static void FSW_CDH_modeChange( uint8_t newMode )
 static void FSW_CDH_processCMD( void *pvParameters )
 {
 	portBASE_TYPE CMD_Q_Status;
-	CDH_CMD_TypeDef ReceivedCMD;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
+	CDH_CMD_TypeDef *ReceivedCMD;
+	const CDH_Route_TypeDef *route;
+	uint8_t error;
 
 	while(1)
 	{
-		CMD_Q_Status = xQueueReceive( FSW_CDH_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		// A schedule timer re-arm that did not fit in the timer queue is retried here
+		if( CMDsched_pending )
+		{
+			xSemaphoreTake( CMDschedMutex, portMAX_DELAY );
+			CMDsched_rearm( 0, SCHED_REARMMS / portTICK_RATE_MS );
+			xSemaphoreGive( CMDschedMutex );
+		}
+
+		CMD_Q_Status = xQueueReceive( FSW_CDH_CMDqueue, &ReceivedHandle,
+				CMDsched_pending ? SCHED_RETRYMS / portTICK_RATE_MS : portMAX_DELAY );
 
 		if(CMD_Q_Status == pdPASS)
 		{
-			if( ReceivedCMD.exe_time != 0 )													// If scheduling is required...
+			ReceivedCMD = FSW_CMDPOOL_get( ReceivedHandle );
+
+			if( ReceivedCMD->exe_time != 0 )												// If scheduling is required...
 			{
 				scheduleCMD( ReceivedCMD );
+				FSW_CMDPOOL_release( ReceivedHandle );
 			}
 			else																			// CMD processing
 			{/*
-				if( ReceivedCMD.id != 0x03 && ReceivedCMD.id != FSW_COMM )
+				if( ReceivedCMD->id != 0x03 && ReceivedCMD->id != FSW_COMM )
 				{
 					FS_LogEntry_TypeDef cmd_LogEntry;										// Log the command before sending it to the relevant module
-					cmd_LogEntry.exe_time = OBC_time;
+					cmd_LogEntry.exe_time = getOBC_time();
 					cmd_LogEntry.type = LOG_CMD;
-					cmd_LogEntry.source = ReceivedCMD.dest;
-					cmd_LogEntry.id = ReceivedCMD.id;
+					cmd_LogEntry.source = ReceivedCMD->dest;
+					cmd_LogEntry.id = ReceivedCMD->id;
 					xQueueSendToBack( FSW_FS_LOGqueue, &cmd_LogEntry, 0 );
 				}
 				*/
-				switch(ReceivedCMD.dest)
+				error = FSW_CDH_route( ReceivedCMD, &route );						// One table lookup routes and validates the command
+
+				if( error != CDH_CMDERR_NONE )
+				{
+					CMDreject( ReceivedCMD, error );
+					FSW_CDH_MSV |= ERROR_CMDINV;
+					FSW_CMDPOOL_release( ReceivedHandle );
+				}
+				else if( route->queue == NULL )											// C&DH command, execute here
 				{
-				case FSW_ADCS:
-					xQueueSendToBack( FSW_ADCS_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-				case FSW_CDH:
-					if( ReceivedCMD.id == 0x01 )											// Return status telemetry
-						FSW_CDH_reportHealthStatus();
-					else if( ReceivedCMD.id == 0x02 )										// Change the modules mode and run any associated procedures
-						FSW_CDH_modeChange( (uint8_t)ReceivedCMD.params[0] );
-					break;
-
-				case FSW_COMM:
-					xQueueSendToBack( FSW_COMM_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-					//TODO: First check if a SD card is present. For all modules, first check if subsystem is enabled
-					/*case FSW_FS:
-					xQueueSendToBack( FSW_FS_CMDqueue, &ReceivedCMD, 0 );
-					break;*/
-
-				case FSW_HANDH:
-					xQueueSendToBack( FSW_HANDH_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-				case FSW_MODES:
-					xQueueSendToBack( FSW_MODES_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-				case FSW_PAYLOAD:
-					xQueueSendToBack( FSW_PAYLOAD_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-				case FSW_POWER:
-					xQueueSendToBack( FSW_POWER_CMDqueue, &ReceivedCMD, 0 );
-					break;
-
-				default:
-					FSW_CDH_MSV &= ERROR_CMDINV;
-					while(1);
-					break;
+					route->handler( ReceivedCMD );
+					FSW_CMDPOOL_release( ReceivedHandle );
+				}
+				else
+				{
+					FSW_CMDPOOL_forward( *route->queue, ReceivedHandle, 0 );
 				}
 			}
 		}
@@ -413,7 +605,7 @@ static void FSW_CDH_processCMD( void *pvParameters )
 static void FSW_CDH_processDIARY( void *pvParameters )
 {
 	portBASE_TYPE DIARY_Q_Status;
-	CDH_Diary_TypeDef ReceivedDIARY;
+	CDH_DiaryRef_TypeDef ReceivedDIARY;
 	int DiaryEntry;
 
 	while(1)
@@ -425,47 +617,7 @@ static void FSW_CDH_processDIARY( void *pvParameters )
 			// Loop through every command in the diary and dispatch it to the relevant module
 			for( DiaryEntry = 0; DiaryEntry < ReceivedDIARY.CmdCount; DiaryEntry++ )
 			{
-				xQueueSendToBack( FSW_CDH_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-				/*
-				switch(ReceivedDIARY.CMDlist[DiaryEntry].dest)
-				{
-				case FSW_ADCS:
-					xQueueSendToBack( FSW_ADCS_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_CDH:
-					xQueueSendToBack( FSW_CDH_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_COMM:
-					xQueueSendToBack( FSW_COMM_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_FS:
-					xQueueSendToBack( FSW_FS_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_HANDH:
-					xQueueSendToBack( FSW_HANDH_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_MODES:
-					xQueueSendToBack( FSW_MODES_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_PAYLOAD:
-					xQueueSendToBack( FSW_PAYLOAD_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				case FSW_POWER:
-					xQueueSendToBack( FSW_POWER_CMDqueue, &ReceivedDIARY.CMDlist[DiaryEntry], 0 );
-					break;
-
-				default:
-					FSW_CDH_MSV &= ERROR_CMDINV;
-					break;
-				}
-				*/
+				FSW_CMDPOOL_forward( FSW_CDH_CMDqueue, ReceivedDIARY.CMDlist[DiaryEntry], 0 );	// Routed by processCMD
 			}
 		}
 
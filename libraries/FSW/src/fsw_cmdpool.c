@@ -0,0 +1,310 @@
+/***************************************************************************//**
+ * @file	fsw_cmdpool.c
+ * @brief	FSW command block pool source file.
+ *
+ * Commands are held in a fixed pool of reference counted blocks and the
+ * command queues carry only the 1-byte block handle. A command is copied once,
+ * into a block, where it originates. From there ownership of the reference
+ * moves with the handle: a successful xQueueSend hands it to the receiver, and
+ * the task that finally consumes the command releases it. A send that fails
+ * leaves the reference with the sender, which must release it
+ * (FSW_CMDPOOL_send() and FSW_CMDPOOL_forward() do this).
+ *
+ * Because queues no longer hold commands by value, CDH_CMD_PARAMLEN can grow
+ * without growing every queue.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "fsw_cmdpool.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+static CDH_CMD_TypeDef CMDpool[CDH_CMDPOOL_LEN];				///< The command blocks
+static uint8_t CMDpool_refCount[CDH_CMDPOOL_LEN];				///< References held on each block, 0 when free
+static CDH_CMDhandle_TypeDef CMDpool_free[CDH_CMDPOOL_LEN];	///< Stack of free handles
+static uint8_t CMDpool_freeCount = 0;
+
+static FSW_CMDPOOL_Stats_TypeDef CMDpool_stats;
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function marks every command block free and clears the usage counters.
+ ******************************************************************************/
+void FSW_CMDPOOL_Init( void )
+{
+	uint8_t i;
+
+	for( i = 0; i < CDH_CMDPOOL_LEN; i++ )
+	{
+		CMDpool_refCount[i] = 0;
+		CMDpool_free[i] = CDH_CMDPOOL_LEN - 1 - i;
+	}
+	CMDpool_freeCount = CDH_CMDPOOL_LEN;
+
+	CMDpool_stats.allocs = 0;
+	CMDpool_stats.exhausted = 0;
+	CMDpool_stats.inUse = 0;
+	CMDpool_stats.hwm = 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function takes a free command block. The caller holds the only
+ * reference to it.
+ *
+ * @return
+ * 		Handle of the block, or CDH_CMD_NOHANDLE if the pool is exhausted.
+ ******************************************************************************/
+CDH_CMDhandle_TypeDef FSW_CMDPOOL_alloc( void )
+{
+	CDH_CMDhandle_TypeDef handle = CDH_CMD_NOHANDLE;
+
+	taskENTER_CRITICAL();
+	{
+		if( CMDpool_freeCount != 0 )
+		{
+			handle = CMDpool_free[--CMDpool_freeCount];
+			CMDpool_refCount[handle] = 1;
+
+			CMDpool_stats.allocs++;
+			if( ++CMDpool_stats.inUse > CMDpool_stats.hwm )
+			{
+				CMDpool_stats.hwm = CMDpool_stats.inUse;
+			}
+		}
+		else
+		{
+			CMDpool_stats.exhausted++;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return handle;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] handle
+ * 		A block the caller holds a reference to.
+ * @return
+ * 		The command held in the block.
+ ******************************************************************************/
+CDH_CMD_TypeDef *FSW_CMDPOOL_get( CDH_CMDhandle_TypeDef handle )
+{
+	return &CMDpool[handle];
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function adds a reference to a block, for handing the same command to
+ * more than one consumer. Each reference is released separately.
+ *
+ * @param[in] handle
+ * 		A block the caller holds a reference to.
+ ******************************************************************************/
+void FSW_CMDPOOL_retain( CDH_CMDhandle_TypeDef handle )
+{
+	taskENTER_CRITICAL();
+	{
+		CMDpool_refCount[handle]++;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function drops a reference to a block. The block returns to the pool
+ * when its last reference is released.
+ *
+ * @param[in] handle
+ * 		A block the caller holds a reference to. CDH_CMD_NOHANDLE is ignored.
+ ******************************************************************************/
+void FSW_CMDPOOL_release( CDH_CMDhandle_TypeDef handle )
+{
+	if( handle >= CDH_CMDPOOL_LEN )
+	{
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( CMDpool_refCount[handle] != 0 && --CMDpool_refCount[handle] == 0 )
+		{
+			CMDpool_free[CMDpool_freeCount++] = handle;
+			CMDpool_stats.inUse--;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function is where a command enters the system: it copies the command
+ * into a new block and sends the block's handle to a queue.
+ *
+ * @param[in] queue
+ * 		Destination command queue.
+ * @param[in] CMD
+ * 		The command.
+ * @param[in] ticksToWait
+ * 		How long to wait for space on the queue.
+ * @return
+ * 		pdPASS if the command was queued, errQUEUE_FULL if the queue was full or
+ * 		the pool exhausted.
+ ******************************************************************************/
+portBASE_TYPE FSW_CMDPOOL_send( xQueueHandle queue, const CDH_CMD_TypeDef *CMD, portTickType ticksToWait )
+{
+	CDH_CMDhandle_TypeDef handle = FSW_CMDPOOL_alloc();
+
+	if( handle == CDH_CMD_NOHANDLE )
+	{
+		return errQUEUE_FULL;
+	}
+
+	CMDpool[handle] = *CMD;
+
+	return FSW_CMDPOOL_forward( queue, handle, ticksToWait );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function passes the caller's reference to a block on to a queue. If the
+ * queue is full the reference is released, so the caller never owns the block
+ * after this call.
+ *
+ * @param[in] queue
+ * 		Destination command queue.
+ * @param[in] handle
+ * 		A block the caller holds a reference to.
+ * @param[in] ticksToWait
+ * 		How long to wait for space on the queue.
+ * @return
+ * 		pdPASS if the block was queued, errQUEUE_FULL otherwise.
+ ******************************************************************************/
+portBASE_TYPE FSW_CMDPOOL_forward( xQueueHandle queue, CDH_CMDhandle_TypeDef handle, portTickType ticksToWait )
+{
+	if( xQueueSendToBack( queue, &handle, ticksToWait ) != pdPASS )
+	{
+		FSW_CMDPOOL_release( handle );
+		return errQUEUE_FULL;
+	}
+
+	return pdPASS;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies every command in a received diary into its own block
+ * and sends the handles on the diary queue. Nothing is queued unless every
+ * command got a block.
+ *
+ * @param[in] queue
+ * 		Destination diary queue.
+ * @param[in] diary
+ * 		The diary as received.
+ * @param[in] ticksToWait
+ * 		How long to wait for space on the queue.
+ * @return
+ * 		pdPASS if the diary was queued, errQUEUE_FULL otherwise.
+ ******************************************************************************/
+portBASE_TYPE FSW_CMDPOOL_sendDiary( xQueueHandle queue, const CDH_Diary_TypeDef *diary, portTickType ticksToWait )
+{
+	CDH_DiaryRef_TypeDef ref;
+	uint8_t i;
+
+	ref.CmdCount = ( diary->CmdCount < CDH_DIARY_CMDCOUNT ) ? diary->CmdCount : CDH_DIARY_CMDCOUNT;
+
+	for( i = 0; i < ref.CmdCount; i++ )
+	{
+		ref.CMDlist[i] = FSW_CMDPOOL_alloc();
+
+		if( ref.CMDlist[i] == CDH_CMD_NOHANDLE )
+		{
+			break;
+		}
+
+		CMDpool[ref.CMDlist[i]] = diary->CMDlist[i];
+	}
+
+	if( i == ref.CmdCount && xQueueSendToBack( queue, &ref, ticksToWait ) == pdPASS )
+	{
+		return pdPASS;
+	}
+
+	while( i != 0 )
+	{
+		FSW_CMDPOOL_release( ref.CMDlist[--i] );
+	}
+
+	return errQUEUE_FULL;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function may be called from the UART interrupt handler when the pool
+ * status telemetry is requested.
+ *
+ * @param[out] stats
+ * 		Receives a consistent copy of the pool usage counters.
+ ******************************************************************************/
+void FSW_CMDPOOL_getStats( FSW_CMDPOOL_Stats_TypeDef *stats )
+{
+	unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		*stats = CMDpool_stats;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
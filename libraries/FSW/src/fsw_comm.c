@@ -30,6 +30,8 @@
 
 // for printing
 #include "comms.h"
+#include "fsw_cmdpool.h"
+#include "fsw_memmap.h"
 
 #define CMD_Qlen	6
 
@@ -61,11 +63,6 @@ static xQueueHandle FSW_transceiver_queue;
 
 //ADDED FROM HIL CODE FOR SIMULATION PURPOSES ONLY*************************************************************************************
 
-// Handle required to suspend the task while processing TCMD/TLM
-xTaskHandle Poll_UART_Handle;
-
-portTickType xLastWakeTime;		///< Used to delay the poll_UART task
-
 //TODO: Ideally use the processed flag in the CMD structure instead
 uint8_t CMD_processed = 1;		// Used to flag when no commands are waiting to be processed
 
@@ -84,15 +81,45 @@ static void FSW_COMM_modeChange( uint8_t newMode );			///< Changes the module's
 
 static void FSW_COMM_manager( void *pvParameters );			///< Subsystem manager
 static void FSW_I2C_manager( void *pvParameters );
+static portSTACK_TYPE FSW_COMM_managerStack[ FSW_STACK_COMM_MANAGER ];
+static portSTACK_TYPE FSW_I2C_managerStack[ FSW_STACK_COMM_I2C ];
 
 #ifdef HIL_sim
-static void Poll_UART( void *pvParameters );				///< Continuously polls the UART for TCMDs and TLM requests
 static void Process_TLM_TCM( void *pvParameters );			///< Processes any queued TLM requests and TCMDs
+static portSTACK_TYPE Process_TLM_TCMstack[ FSW_STACK_COMM_PROCESS ];
 static uint8_t process_TLM(uint8_t id, uint8_t *txBuffer);
 static void process_TCMD( CDH_CMD_TypeDef ReceivedCMD );
 static uint8_t identify_TCMD_len( uint8_t tcmd_id );
 #endif
 
+static void FSW_COMM_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_COMM_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+#ifdef HIL_sim
+static void FSW_COMM_CMDinitTransfer( const CDH_CMD_TypeDef *CMD );
+static void FSW_COMM_CMDreturnTLM( const CDH_CMD_TypeDef *CMD );
+static void FSW_COMM_CMDstreamTLM( const CDH_CMD_TypeDef *CMD );
+#endif
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_COMM_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,							NULL,				0,	0				},		// 0x00
+		{ FSW_COMM_CMDreportHealth,		&FSW_COMM_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Report health status
+		{ FSW_COMM_CMDmodeChange,		&FSW_COMM_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x02 Change the module's mode
+#ifdef HIL_sim
+		{ FSW_COMM_CMDinitTransfer,		&FSW_COMM_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x03 Initiate transfer command to Matlab
+		{ FSW_COMM_CMDreturnTLM,		&FSW_COMM_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x04 Return the requested telemetry to matlab simulation
+		{ FSW_COMM_CMDstreamTLM,		&FSW_COMM_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x05 Send telemetry data gathered by the HandH module to Matlab
+#else
+		{ NULL,							NULL,				0,	0				},		// 0x03
+		{ NULL,							NULL,				0,	0				},		// 0x04
+		{ NULL,							NULL,				0,	0				},		// 0x05
+#endif
+		{ NULL,							NULL,				0,	0				},		// 0x06
+		{ NULL,							NULL,				0,	0				}		// 0x07
+};
+/*************************************************************************************************************************************/
+
 // FUNCTIONS *************************************************************************************************************************
 
 /***************************************************************************//**
@@ -105,9 +132,9 @@ static uint8_t identify_TCMD_len( uint8_t tcmd_id );
 
 void FSW_COMM_Init( void )
 {
-	FSW_COMM_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
-	FSW_transceiver_queue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );	///< Holds command read from the transceiver ( the UART for now )
-	FSW_COMM_I2Cqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );			///< Holds TLM and TCMDs that need to be transmitted over the I2C bus
+	FSW_COMM_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
+	FSW_transceiver_queue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );	///< Holds command read from the transceiver ( the UART for now )
+	FSW_COMM_I2Cqueue = xQueueCreate( CMD_Qlen, sizeof( COMM_I2Cmsg_TypeDef ) );		///< Holds TLM and TCMDs that need to be transmitted over the I2C bus
 
 	if( FSW_COMM_CMDqueue == NULL )
 	{
@@ -116,12 +143,11 @@ void FSW_COMM_Init( void )
 	}
 	else
 	{
-		xTaskCreate( FSW_COMM_manager, "COMMmanager", 240, NULL, 1, NULL );
-		xTaskCreate( FSW_I2C_manager, "I2Cmanager", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_COMM_manager, "COMMmanager", FSW_COMM_managerStack, NULL, 1 );
+		FSW_TASK_CREATE( FSW_I2C_manager, "I2Cmanager", FSW_I2C_managerStack, NULL, 1 );
 
 #ifdef HIL_sim
-		xTaskCreate( Poll_UART, "PollUART", 240, NULL, 1, &Poll_UART_Handle );			///< Polls the transceiver for commands received from the GS ( the UART for now )
-		xTaskCreate( Process_TLM_TCM, "ProcessTLMTCM", 240, NULL, 1, NULL );				///< Processes commands queued by Poll_UART
+		FSW_TASK_CREATE( Process_TLM_TCM, "ProcessTLMTCM", Process_TLM_TCMstack, NULL, 1 );				///< Processes commands queued by FSW_COMM_pollUART
 #endif
 
 		FSW_COMM_MSV = 0;
@@ -140,18 +166,13 @@ void FSW_COMM_Init( void )
 
 static void FSW_COMM_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_COMM_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_COMM_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_COMM_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_COMM_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -191,14 +212,14 @@ static void FSW_COMM_modeChange( uint8_t newMode )
  * @author Andre Heunis
  * @date   14/02/2013
  *
- *
+ * This function fills in a message that writes \b I2Cbuffer to the slave at
+ * \b dest on the main I2C channel, at normal priority. See
+ * FSW_I2CBUS_construct for reads and the other fields.
  ******************************************************************************/
 
 void FSW_COMM_constructI2Cmsg( COMM_I2Cmsg_TypeDef* I2Cmsg, uint8_t* I2Cbuffer, uint8_t source, uint8_t dest, uint32_t msgLen )
 {
-
-
-
+	FSW_I2CBUS_construct( I2Cmsg, bspI2cWrite, I2Cbuffer, msgLen, NULL, 0, source, dest );
 }
 
 #ifdef HIL_sim
@@ -260,18 +281,18 @@ static void process_TCMD( CDH_CMD_TypeDef ReceivedCMD )
 	case 0x11:	// Set mode
 		ReceivedCMD.id = 0x02;	//id
 
-		xQueueSendToBack( FSW_CDH_CMDqueue, &ReceivedCMD, 0 );
+		FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &ReceivedCMD, 0 );
 
 		break;
 	 */
 	/*
 	case 0x12:	// Retrieve health of all subsystems
-		xQueueSendToBack( FSW_CDH_CMDqueue, &sysHealthCMD, 0 );
+		FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sysHealthCMD, 0 );
 		break;
 		*/
 /*
 	case 0x13:	// Set OBC date and time
-		xQueueSendToBack( FSW_CDH_CMDqueue, &setTimeCMD, 0 );
+		FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &setTimeCMD, 0 );
 		break;
 */
 	default:
@@ -350,17 +371,12 @@ static uint8_t process_TLM(uint8_t id, uint8_t *txBuffer)
 		while(1);
 		break;
 	}
-	if( BSP_UART_txInProgress() )
+	if( id != 0x80 )
 	{
-		commsErr = COMMS_ERROR_UARTTLM;
-		// TODO: sort out the occurence of this error
-		while(1);
-	}
-	else
-	{
-		if( id != 0x80 )
+		// An error only if the transmit queue stays full
+		if( BSP_UART_txQueue(BSP_UART_DEBUG, uartTxBuffer, tlmLen, COMMS_UART_TXTIMEOUT_MS / portTICK_RATE_MS) < tlmLen )
 		{
-			BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, tlmLen, true);
+			commsErr = COMMS_ERROR_UARTTLM;
 		}
 	}
 
@@ -369,6 +385,43 @@ static uint8_t process_TLM(uint8_t id, uint8_t *txBuffer)
 
 #endif
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the telecommunications module's entries in the routing table.
+ * They run in the FSW_COMM_manager task.
+ ******************************************************************************/
+
+static void FSW_COMM_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_COMM_reportHealthStatus();
+}
+
+static void FSW_COMM_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_COMM_modeChange( (uint8_t)CMD->params[0] );
+}
+#ifdef HIL_sim
+
+static void FSW_COMM_CMDinitTransfer( const CDH_CMD_TypeDef *CMD )
+{
+	addToBuffer_uint8 ( &(uartTxBuffer[0]), CMD->params[0] );
+	BSP_UART_txBuffer( BSP_UART_DEBUG, uartTxBuffer, 1, false );
+}
+
+static void FSW_COMM_CMDreturnTLM( const CDH_CMD_TypeDef *CMD )
+{
+	process_TLM ( CMD->params[0], uartTxBuffer );
+}
+
+static void FSW_COMM_CMDstreamTLM( const CDH_CMD_TypeDef *CMD )
+{
+	// A link frame with ID 0x06, the telemetry stream update, built by the HandH module
+	BSP_UART_txBuffer( BSP_UART_DEBUG, (uint8_t*)CMD->params[0], CMD->len, false );
+}
+#endif
+
 // TASKS ****************************************************************************************************************************************************************************
 
 /***************************************************************************//**
@@ -386,54 +439,18 @@ static uint8_t process_TLM(uint8_t id, uint8_t *txBuffer)
 static void FSW_COMM_manager( void *pvParameters )
 {
 	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
-	uint8_t* buffer;
-	int TLM_index = 0;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_COMM_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_COMM_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch( ReceivedCMD.id )
+			// Runs the handler listed in FSW_COMM_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:							///< Report health status
-				FSW_COMM_reportHealthStatus();
-				break;
-
-			case 0x02:							///< Change the modules mode and run any associated procedures
-				FSW_COMM_modeChange( (uint8_t)ReceivedCMD.params[0] );
-				break;
-#ifdef HIL_sim
-			case 0x03:							///< Initiate transfer command to Matlab
-				addToBuffer_uint8 ( &(uartTxBuffer[0]), ReceivedCMD.params[0] );
-				BSP_UART_txBuffer( BSP_UART_DEBUG, uartTxBuffer, 1, false );
-				break;
-
-			case 0x04:							///< Return the requested telemetry to matlab simulation
-				process_TLM ( ReceivedCMD.params[0], uartTxBuffer );
-				break;
-
-			case 0x05:							///< Send telemetry data to Matlab every second. Data is gathered and sent from HandH module
-				buffer = (uint8_t*)ReceivedCMD.params[0];
-
-				addToBuffer_uint8 ( &(uartTxBuffer[0]), 0x06 );						///< 0x06 is id for telemetry stream update
-				BSP_UART_txBuffer( BSP_UART_DEBUG, uartTxBuffer, 1, false );		///< Should be able to send true instead of false
-
-				while( TLM_index < ReceivedCMD.len )
-				{
-					addToBuffer_uint8 ( &(uartTxBuffer[TLM_index]), *(buffer+TLM_index) );
-					TLM_index++;
-				}
-
-				BSP_UART_txBuffer( BSP_UART_DEBUG, uartTxBuffer, TLM_index, false );		///< Should be able to send true instead of false
-				TLM_index = 0;
-				break;
-#endif
-			default:
-				FSW_COMM_MSV &= ERROR_CMDINV;
-				break;
+				FSW_COMM_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
@@ -447,19 +464,18 @@ static void FSW_COMM_manager( void *pvParameters )
  * @date   13/02/2013
  *
  * This task handles all communication (sending and receiving) on the I2C bus.
- * As no other task will write to the I2C bus, no mutual exclusion is required.
+ * It owns both I2C channels and runs the bus scheduler on the messages queued
+ * on FSW_COMM_I2Cqueue. The main channel is set up as master by COMMS_init.
  ******************************************************************************/
 
 static void FSW_I2C_manager( void *pvParameters )
 {
-	portBASE_TYPE Status;
-	COMM_I2Cmsg_TypeDef ReceivedMSG;
+	BSP_I2C_Init( BSP_I2C_SUB, true );
+	FSW_I2CBUS_Init( FSW_I2CBUS_BATCH );
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_COMM_I2Cqueue, &ReceivedMSG, portMAX_DELAY );
-
-
+		FSW_I2CBUS_service( FSW_COMM_I2Cqueue, portMAX_DELAY );
 	}
 
 	// Delete the task if it ever breaks out of the loop above
@@ -472,34 +488,23 @@ static void FSW_I2C_manager( void *pvParameters )
  * @author Andre Heunis
  * @date   05/09/2013
  *
- * This task fulfills the roll done by the UART interrupt handler in the
- * cubecomputer BSP. The UART is polled periodically and when data is detected,
- * the ID of the data is used to place a structure on a queue for processing by
- * the Process_TLM_TCM task.
+ * This job fulfills the roll done by the UART interrupt handler in the
+ * cubecomputer BSP. The UART is polled every second, released by the periodic
+ * task schedule, and when data is detected, the ID of the data is used to
+ * place a structure on a queue for processing by the Process_TLM_TCM task.
  ******************************************************************************/
 
-static void Poll_UART( void *pvParameters )
+void FSW_COMM_pollUART( void )
 {
-	//xLastWakeTime = xTaskGetTickCount();
-
-	while(1)
+	if( current_state == SAFE_MODE || current_state == LINK_MODE )
 	{
-		if( current_state == SAFE_MODE || current_state == LINK_MODE )
+		// Periodically send request for any data that needs to be sent from the simulation
+		if( CMD_processed == 1 )
 		{
-			// Periodically send request for any data that needs to be sent from the simulation
-			if( CMD_processed == 1 )
-			{
-				sim_Data.params[0] = 0x01;
-				xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
-			}
+			sim_Data.params[0] = 0x01;
+			FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 		}
-
-		//vTaskDelayUntil( &xLastWakeTime, 1000/portTICK_RATE_MS );
-		vTaskDelay(  1000/portTICK_RATE_MS  );
 	}
-
-	// Delete the task if it ever breaks out of the loop above
-	vTaskDelete( NULL );
 }
 
 /***************************************************************************//**
@@ -584,7 +589,7 @@ static void Process_TLM_TCM( void *pvParameters )
 				*/
 
 				// send the diary to the processDIARY task in fsw_cdh.h and reset flags
-				xQueueSendToBack( FSW_CDH_DIARYqueue, &tempDIARY, 0 );
+				FSW_CMDPOOL_sendDiary( FSW_CDH_DIARYqueue, &tempDIARY, 0 );
 
 				tempCMD.processed = 1;
 				CMD_processed = 1;
@@ -613,7 +618,7 @@ static void Process_TLM_TCM( void *pvParameters )
 				// Telemetry request received
 				if( id == 0x02 )
 				{
-					xQueueSendToBack( FSW_CDH_CMDqueue, &tempCMD, 0 );
+					FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &tempCMD, 0 );
 
 					tempCMD.processed = 1;
 					CMD_processed = 1;
@@ -622,7 +627,7 @@ static void Process_TLM_TCM( void *pvParameters )
 				// Telecommand received
 				else if ( id == 0x01 )
 				{
-					xQueueSendToBack( FSW_CDH_CMDqueue, &tempCMD, 0 );
+					FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &tempCMD, 0 );
 
 					tempCMD.processed = 1;
 					CMD_processed = 1;
@@ -29,6 +29,8 @@
  ******************************************************************************/
 
 #include "fsw_filesystem.h"
+#include "fsw_memmap.h"
+#include "fsw_healthandhousekeeping.h"	// for writing spilled housekeeping blocks
 
 #define FS_Qlen	6
 
@@ -58,33 +60,25 @@
 static uint8_t FSW_FS_MSV = 0;		///< Health status byte for C&DH module
 static uint8_t FSW_FS_mode = 0;
 
-// FAT file system variables
-FIL File_object;						///< File object
+// FAT file system variables. FatFs locks the volume itself (_FS_REENTRANT), so
+// any task may use the file system with FIL objects and buffers of its own.
 FATFS Fatfs;							///< File system object
 uint8_t Reset_signature;				///< Indicates cause of the previous reset
-FRESULT func_result;					///< Used to store return value of open, seek, read, and write functions
 DSTATUS result_sdCard;					///< Used to store return value of disk functions (stores micro-sd status)
-UINT bytes_read, bytes_written;			///< Current # of bytes read/written during a read/write operation
-int8_t write_buffer[BUFSIZE];			///< Temp buffer for writing to a file
-int8_t read_buffer[BUFSIZE];			///< Temp buffer for reading from a file
-DWORD index_errlog = 0;					///< Position in error log file to write to
-DWORD index_cmdlog = 0;					///< Position in command log file to write to
-DWORD index_wodlog = 0;					///< Position in WOD log file to write to
-char err_logPath[30] = {0};				///< Name of the current log file. need separate ones for different logs
-char cmd_logPath[30] = {0};				///< Name of the current log file. need separate ones for different logs
 
-int16_t numBytestoWrite;					///< Number of bytes to write
-static uint8_t cmdString[] 	= "CMD:   ";	///< First part of a CMD log entry
-static uint8_t errString[] 	= "ERROR: ";	///< First part of an error log entry
-static uint8_t WODString[] 	= "WOD:   ";	///< First part of an error log entry
+static FSW_LOGW_TypeDef FSW_FS_errLog;		///< Buffered writer for the error log
+static FSW_LOGW_TypeDef FSW_FS_cmdLog;		///< Buffered writer for the command log
+static FSW_LOGW_TypeDef FSW_FS_wodLog;		///< Buffered writer for the WOD log
+static uint16_t FSW_FS_logRate = 0;			///< Entries logged per second, over the last second
 
-static uint8_t module_strings[9][9] = {{"Source: "},{"ADCS    "},{"CDH     "},{"COMM    "},{"FS      "},{"HANDH   "},{"MODES   "},{"PAYLOAD "},{"POWER   "}};
+int16_t numBytestoWrite;					///< Number of bytes to write
 
 
 static void FSW_FS_reportHealthStatus( void );					///< Reports the subsystems mode and MSV
 static void FSW_FS_modeChange( uint8_t newMode );				///< Changes the module's mode and runs any associated procedures
 
 static void FATFS_Init( void );
+static void FATFS_pinMetadata( void );
 static void create_logEntry( int8_t *write_buffer, int16_t numBytestoWrite, DWORD *index_errlog );
 static void log_ERROR( FS_LogEntry_TypeDef logEntry );
 static void log_WOD( FS_LogEntry_TypeDef logEntry );
@@ -93,6 +87,27 @@ static void read_test( void ); 									// FOR TESTING LOGGING
 
 static void FSW_FS_CMDmanager( void *pvParameters );
 static void FSW_FS_LOGmanager( void *pvParameters );
+static portSTACK_TYPE FSW_FS_CMDmanagerStack[ FSW_STACK_FS_CMD ];
+static portSTACK_TYPE FSW_FS_LOGmanagerStack[ FSW_STACK_FS_LOG ];
+
+static void FSW_FS_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_FS_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+static void FSW_FS_CMDflushLogs( const CDH_CMD_TypeDef *CMD );
+static void FSW_FS_CMDsetSyncPolicy( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_FS_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,						NULL,				0,	0				},		// 0x00
+		{ FSW_FS_CMDreportHealth,	&FSW_FS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Report the health of this subsystem
+		{ FSW_FS_CMDmodeChange,		&FSW_FS_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x02 Change the module's mode
+		{ FSW_FS_CMDflushLogs,		&FSW_FS_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x03 Write the buffered log entries to the card
+		{ FSW_FS_CMDsetSyncPolicy,	&FSW_FS_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x04 Set when log flushes are followed by f_sync
+		{ NULL,						NULL,				0,	0				},		// 0x05
+		{ NULL,						NULL,				0,	0				},		// 0x06
+		{ NULL,						NULL,				0,	0				}		// 0x07
+};
+/*************************************************************************************************************************************/
 
 // FUNCTIONS *************************************************************************************************************************
 
@@ -104,13 +119,13 @@ static void FSW_FS_LOGmanager( void *pvParameters );
  ******************************************************************************/
 void FSW_FS_Init( void )
 {
-	FSW_FS_CMDqueue = xQueueCreate( FS_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_FS_CMDqueue = xQueueCreate( FS_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
 	FSW_FS_LOGqueue = xQueueCreate( FS_Qlen, sizeof( FS_LogEntry_TypeDef ) );
 
 	if( FSW_FS_CMDqueue != NULL && FSW_FS_LOGqueue != NULL )
 	{
-		xTaskCreate( FSW_FS_CMDmanager, "FS_CMDmanager", 240, NULL, 1, NULL );
-		xTaskCreate( FSW_FS_LOGmanager, "FS_LOGmanager", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_FS_CMDmanager, "FS_CMDmanager", FSW_FS_CMDmanagerStack, NULL, 1 );
+		FSW_TASK_CREATE( FSW_FS_LOGmanager, "FS_LOGmanager", FSW_FS_LOGmanagerStack, NULL, 1 );
 
 		FSW_FS_MSV = 0;
 		FSW_FS_mode = FSW_MODE_ON;
@@ -183,9 +198,9 @@ static void FATFS_Init( void )
 	// 3. DETECT RESET CONDITIONS *
 	// ****************************
 	// Check for log control block
-	if( f_stat("/LOGCNTRLBLOCK.txt", NULL) != FR_OK)
+	if( FSW_LOGW_loadControlBlock( LOG_CNTRLBLOCK ) != FR_OK )
 	{
-		// Initial power on reset or corrupt data. Set flag to create directories, log files and control block file normally as with initial power on
+		// Initial power on reset or corrupt data. The log rings are created afresh in section 5
 	}
 	else
 	{
@@ -233,6 +248,19 @@ static void FATFS_Init( void )
 		FSW_FS_MSV &= ERR_CORRSIG;
 	}
 
+	// *******************
+	// 5. OPEN LOG RINGS *
+	// *******************
+	// Each log continues where the control block says it stopped, or is preallocated if it is new
+	FSW_LOGW_Init( &FSW_FS_errLog, "/ERRORLOG/RING.LOG", LOG_ERROR, LOG_RING_SECTORS, LOG_SYNC_POLICY );
+	FSW_LOGW_Init( &FSW_FS_cmdLog, "/CMDLOG/RING.LOG", LOG_CMD, LOG_RING_SECTORS, LOG_SYNC_POLICY );
+	FSW_LOGW_Init( &FSW_FS_wodLog, "/WODLOG/RING.LOG", LOG_WOD, LOG_RING_SECTORS, LOG_SYNC_POLICY );
+
+	// *******************************
+	// 6. CACHE FILE SYSTEM METADATA *
+	// *******************************
+	FATFS_pinMetadata();
+
 
 /*
 	// Check for existing files
@@ -261,6 +289,21 @@ static void FATFS_Init( void )
 */
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function pins the sectors rewritten on every log sync in the sector
+ * cache, so they stay cached while log data streams through.
+ ******************************************************************************/
+static void FATFS_pinMetadata( void )
+{
+	DISKCACHE_unpinAll();
+	FSW_LOGW_pinMetadata( &FSW_FS_errLog );
+	FSW_LOGW_pinMetadata( &FSW_FS_cmdLog );
+	FSW_LOGW_pinMetadata( &FSW_FS_wodLog );
+}
+
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   05/09/2013
@@ -272,18 +315,13 @@ static void FATFS_Init( void )
 
 static void FSW_FS_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_FS_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_FS_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_FS_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_FS_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -425,273 +463,48 @@ static void create_logEntry( int8_t *write_buffer, int16_t numBytestoWrite, DWOR
  * @author Andre Heunis
  * @date   07/10/2013
  *
- * Format error log data and place it in the error log
- * e.g:ERROR <subsytem> <error_id> <time_detected>
+ * Append an error record to the error log. The record is decoded to
+ * e.g:ERROR <subsytem> <error_id> <time_detected> on the ground.
  ******************************************************************************/
 
 static void log_ERROR( FS_LogEntry_TypeDef logEntry )
 {
-	bytes_written = 0;							// Reset number of bytes written
-	int16_t i = 0;								// Buffer copy counter
-	char temp_id[4] = {0};						// Temporarily stores string conversion of error id
-
-	// Do conversion to human readable time
-	char buf[20];								// 20 characters required for time. 23 for extra log indicator in file name e.g. CMD<date>
-	struct tm ts;
-	time_t time = logEntry.exe_time;
-	ts = *gmtime(&time);
-	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ts);
-
-	// Create buffer to write to log file
-	// Indicate an error log entry
-	strcpy( write_buffer, errString );
-	i += sizeof(errString);
-
-	// Indicate the source of the error
-	strcpy( &write_buffer[i], &module_strings[0] );
-	i += sizeof(module_strings[0]);
-	strcpy( &write_buffer[i], &module_strings[logEntry.source] );
-	i += sizeof(module_strings[logEntry.source]);
-
-	// Indicate the id of the particular error
-	sprintf(temp_id, "%d\t", (int)(logEntry.id));
-	strcpy( &write_buffer[i], temp_id );
-	i += sizeof( temp_id );
-
-	// Write the OBC time to log entry
-	strcpy( &write_buffer[i], buf );
-	i += sizeof(buf);
-
-	write_buffer[i] = '\r';
-	write_buffer[i+1] = '\n';
-	numBytestoWrite = i+2;
-
-	// Entry created, now write to the correct file
-	f_chdir("../ERRORLOG");
+	FS_LogRecord_TypeDef record;
 
-	// Open the file for write
-	func_result = f_open(&File_object, err_logPath, FA_WRITE);
-
-	// If no log file exists, create a new one
-	if (func_result != FR_OK)
-	{
-		// Change the file name
-		time_t time = OBC_time;
-		ts = *gmtime(&time);
-		strftime(err_logPath, sizeof(err_logPath), "%d%H%M%S.txt", &ts);						//Adding year or month or any text in front of day causes invalid filename error
-
-		func_result = f_open(&File_object, err_logPath, FA_CREATE_ALWAYS | FA_WRITE );
-#ifndef HIL_sim
-		if( func_result == FR_INVALID_NAME )
-			printString( "invalidname\n" );
-		else
-			printString( "newlog\n" );
-#endif
-	}
-
-	//Check if current log file is to large (more than 1KB for now)(f_size). Start a new file if it is
-	if( f_size( &File_object ) >= MAX_LOG_SIZE)
-	{
-		// Close the large file
-		f_close(&File_object);
-
-		// Change the file name
-		time_t time = OBC_time;
-		ts = *gmtime(&time);
-		strftime(err_logPath, sizeof(err_logPath), "%d%H%M%S.txt", &ts);
-
-		// Create a new file
-		func_result = f_open(&File_object, err_logPath, FA_CREATE_ALWAYS | FA_WRITE );
-		index_errlog = 0;
-	}
-
-	// Set the file pointer
-	f_lseek(&File_object, index_errlog);
-
-	// Write a buffer to file
-	func_result = f_write(&File_object, write_buffer, numBytestoWrite, &bytes_written);
-
-	// Increment the file pointer if a buffer was written
-	index_errlog += numBytestoWrite;
-
-	// Close the file
-	f_close(&File_object);
+	FSW_LOGFMT_record( &record, logEntry.exe_time, logEntry.source, logEntry.id );
+	FSW_LOGW_append( &FSW_FS_errLog, &record, sizeof( record ) );
 }
 
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   07/10/2013
  *
- * Format whole orbit data and place it in the WOD log
- * e.g:WOD at <time_of_readings>
- * 		-battery voltage/temp etc.
+ * Append a whole orbit data record to the WOD log. The record identifies the
+ * telemetry by id; the readings themselves are not logged yet.
  ******************************************************************************/
 
 static void log_WOD( FS_LogEntry_TypeDef logEntry )
 {
-	bytes_written = 0;			// Reset number of bytes written
-	int16_t i = 0;				// Buffer copy counter
-	char temp_id[4] = {0};		// Temporarily stores string conversion of WOD id
-
-	// Do conversion to human readable time
-	char buf[20];
-	struct tm ts;
-	time_t time = logEntry.exe_time;
-	ts = *gmtime(&time);
-	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ts);
-
-	// Create buffer to write to log file
-	// Indicate a WOD log entry
-	strcpy( write_buffer, WODString );
-	i += sizeof(WODString);
-
-	// FORMAT CORRECTLY FOR WOD
-	// Indicate the source of the WOD
-	/*
-	strcpy( &write_buffer[i], SOURCEstring );
-	i += sizeof(SOURCEstring);
-	strcpy( &write_buffer[i], ADCSstring );
-	i += sizeof(ADCSstring);
-	 */
-	/*
-	// Indicate the id of the particular WOD
-	sprintf(temp_id, "%d\t", (int)(logEntry.id));
-	strcpy( &write_buffer[i], temp_id );
-	i += sizeof( temp_id );
-	 */
-	/*
-	// Write the OBC time to log entry
-	strcpy( &write_buffer[i], buf );
-	i += sizeof(buf);
-	 */
-	/*
-	write_buffer[i] = '\r';
-	write_buffer[i+1] = '\n';
-	numBytestoWrite = i+2;
-
-	// Entry created, now write to the correct file
-	f_chdir("../WODLOG");
+	FS_LogRecord_TypeDef record;
 
-	// Open the file for write
-	func_result = f_open(&File_object, ERRLOG_FILENAME, FA_WRITE);
-
-	if (func_result != FR_OK)
-	{
-		func_result = f_open(&File_object, ERRLOG_FILENAME, FA_CREATE_ALWAYS | FA_WRITE );
-	}
-
-	// Set the file pointer
-	f_lseek(&File_object, index_errlog);
-
-	// Write a buffer to file
-	func_result = f_write(&File_object, write_buffer, numBytestoWrite, &bytes_written);
-
-	// Increment the file pointer if a buffer was written
-	index_errlog += numBytestoWrite;
-
-	// Close the file
-	f_close(&File_object);
-
-	printString("Error logged\n");
-	 */
+	FSW_LOGFMT_record( &record, logEntry.exe_time, logEntry.source, logEntry.id );
+	FSW_LOGW_append( &FSW_FS_wodLog, &record, sizeof( record ) );
 }
 
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   07/10/2013
  *
- * Format CMD log data and place it in the CMD log
- * e.g:CMD <subsytem> <cmd_id> <time_executed>
+ * Append a command record to the CMD log. The record is decoded to
+ * e.g:CMD <subsytem> <cmd_id> <time_executed> on the ground.
  ******************************************************************************/
 
 static void log_CMD( FS_LogEntry_TypeDef logEntry )
 {
-	bytes_written = 0;			// Reset number of bytes written
-	int16_t i = 0;				// Buffer copy counter
-	char temp_id[4] = {0};		// Temporarily stores string conversion of CMD id
-
-	// Do conversion to human readable time
-	char buf[20];
-	struct tm ts;
-	time_t time = logEntry.exe_time;
-	ts = *gmtime(&time);
-	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ts);
-
-	// Create buffer to write to log file
-	// Indicate an error log entry
-	strcpy( write_buffer, cmdString );
-	i += sizeof(cmdString);
-
-	// Indicate the source of the CMD
-	strcpy( &write_buffer[i], &module_strings[0] );
-	i += sizeof( module_strings[0] );
-	strcpy( &write_buffer[i], &module_strings[logEntry.source] );
-	i += sizeof(module_strings[logEntry.source]);
-
-	// Indicate the id of the particular CMD
-	sprintf(temp_id, "%d\t", (int)(logEntry.id));
-	strcpy( &write_buffer[i], temp_id );
-	i += sizeof( temp_id );
-
-	// Write the OBC time to log entry
-	strcpy( &write_buffer[i], buf );
-	i += sizeof(buf);
-
-	write_buffer[i] = '\r';
-	write_buffer[i+1] = '\n';
-	numBytestoWrite = i+2;
-
-	// Entry created, now write to the correct file
-	f_chdir("../CMDLOG");
-
-	// Open the file for write
-	func_result = f_open(&File_object, cmd_logPath, FA_WRITE);
-
-	// If no log file exists, create a new one
-	if (func_result != FR_OK)
-	{
-		// Change the file name
-		time_t time = OBC_time;
-		ts = *gmtime(&time);
-		strftime(cmd_logPath, sizeof(cmd_logPath), "%d%H%M%S.txt", &ts);						//Adding year or month or any text in front of day causes invalid filename error
-
-		func_result = f_open(&File_object, cmd_logPath, FA_CREATE_ALWAYS | FA_WRITE );
-#ifndef HIL_sim
-		if( func_result == FR_INVALID_NAME )
-			printString( "invalidname\n" );
-		else
-			printString( "new log file\n" );
-#endif
-	}
-
-	//Check if current log file is to large (more than 2KB for now)(f_size). Start a new file if it is
-	if( f_size( &File_object ) >= MAX_LOG_SIZE) 												// <- File probably needs to be opened into this file object before f_size will work
-	{
-		// Close the large file
-		f_close(&File_object);
-
-		// Change the file name
-		time_t time = OBC_time;
-		ts = *gmtime(&time);
-		strftime(cmd_logPath, sizeof(cmd_logPath), "%d%H%M%S.txt", &ts);
-
-		// Create a new file
-		func_result = f_open(&File_object, cmd_logPath, FA_CREATE_ALWAYS | FA_WRITE );
-		index_cmdlog = 0;
-	}
-
-	// Set the file pointer
-	f_lseek(&File_object, index_cmdlog);
-
-	// Write a buffer to file
-	func_result = f_write(&File_object, write_buffer, numBytestoWrite, &bytes_written);
+	FS_LogRecord_TypeDef record;
 
-	// Increment the file pointer if a buffer was written
-	index_cmdlog += numBytestoWrite;
-
-	// Close the file
-	f_close(&File_object);
-	printString( "log created\n" );
+	FSW_LOGFMT_record( &record, logEntry.exe_time, logEntry.source, logEntry.id );
+	FSW_LOGW_append( &FSW_FS_cmdLog, &record, sizeof( record ) );
 }
 
 /***************************************************************************//**
@@ -767,6 +580,103 @@ static void read_test( void )
 	}
 }
  */
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the file system module's entries in the routing table.
+ * They run in the FSW_FS_CMDmanager task.
+ ******************************************************************************/
+
+static void FSW_FS_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_FS_reportHealthStatus();
+}
+
+static void FSW_FS_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_FS_modeChange( (uint8_t)CMD->params[0] );
+}
+
+static void FSW_FS_CMDflushLogs( const CDH_CMD_TypeDef *CMD )
+{
+	FS_LogEntry_TypeDef syncEntry = { 0, LOG_SYNC, FSW_FS, 0 };
+
+	// The log files belong to the FSW_FS_LOGmanager task
+	xQueueSendToBack( FSW_FS_LOGqueue, &syncEntry, 0 );
+}
+
+static void FSW_FS_CMDsetSyncPolicy( const CDH_CMD_TypeDef *CMD )
+{
+	if( CMD->params[0] > FSW_LOGW_SYNC_EXPLICIT )
+	{
+		FSW_FS_MSV |= ERR_CMDINV;
+		return;
+	}
+
+	FSW_FS_errLog.syncPolicy = (uint8_t)CMD->params[0];
+	FSW_FS_cmdLog.syncPolicy = (uint8_t)CMD->params[0];
+	FSW_FS_wodLog.syncPolicy = (uint8_t)CMD->params[0];
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sums the counters of the log writers for telemetry.
+ *
+ * @param[out] stats
+ * 		Counters summed over the error, command and WOD logs.
+ * @param[out] rate
+ * 		Entries logged over the last second.
+ ******************************************************************************/
+void FSW_FS_getLogStats( FSW_LOGW_Stats_TypeDef *stats, uint16_t *rate )
+{
+	const FSW_LOGW_TypeDef *logs[] = { &FSW_FS_errLog, &FSW_FS_cmdLog, &FSW_FS_wodLog };
+	unsigned portBASE_TYPE savedMask;
+	uint8_t i;
+
+	memset( stats, 0, sizeof( FSW_LOGW_Stats_TypeDef ) );
+
+	// May be called from any task or interrupt
+	savedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		for( i = 0; i < sizeof( logs ) / sizeof( logs[0] ); i++ )
+		{
+			stats->entries += logs[i]->stats.entries;
+			stats->entryBytes += logs[i]->stats.entryBytes;
+			stats->sectorWrites += logs[i]->stats.sectorWrites;
+			stats->flushes += logs[i]->stats.flushes;
+			stats->syncs += logs[i]->stats.syncs;
+			stats->overwrites += logs[i]->stats.overwrites;
+			stats->errors += logs[i]->stats.errors;
+		}
+		*rate = FSW_FS_logRate;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( savedMask );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the sector cache counters for telemetry.
+ *
+ * @param[out] stats
+ * 		Cache counters.
+ ******************************************************************************/
+void FSW_FS_getCacheStats( DISKCACHE_Stats_TypeDef *stats )
+{
+	unsigned portBASE_TYPE savedMask;
+
+	// May be called from any task or interrupt
+	savedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		DISKCACHE_getStats( stats );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( savedMask );
+}
+
 // TASKS ************************************************************************************************************************************************************
 
 /***************************************************************************//**
@@ -780,31 +690,18 @@ static void read_test( void )
 static void FSW_FS_CMDmanager( void *pvParameters )
 {
 	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_FS_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_FS_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch(ReceivedCMD.id)
+			// Runs the handler listed in FSW_FS_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:
-				FSW_FS_reportHealthStatus();
-				break;
-
-			case 0x02:
-				FSW_FS_modeChange((uint8_t)ReceivedCMD.params[0] );
-				break;
-
-			case 0x03:
-				// Add a log struct to the logging queue to queue an event.
-				break;
-
-			default:
-				FSW_FS_MSV &= ERR_CMDINV;
-				break;
+				FSW_FS_MSV |= ERR_CMDINV;
 			}
 		}
 	}
@@ -817,19 +714,33 @@ static void FSW_FS_CMDmanager( void *pvParameters )
  * @author Andre Heunis
  * @date   07/10/2013
  *
- * Test function. Read from the log file.
+ * This task writes the entries received on FSW_FS_LOGqueue to the log files.
+ * Entries are buffered by the log writers and reach the card a sector at a
+ * time, or once they have waited LOG_FLUSH_MS, or on a LOG_SYNC request.
+ * LOG_HKSPILL requests append the housekeeping blocks spilled by HandH to
+ * their file.
  ******************************************************************************/
 
 static void FSW_FS_LOGmanager( void *pvParameters )
 {
 	portBASE_TYPE Status;
 	FS_LogEntry_TypeDef LogEntry;
+	portTickType now, rateStart;
+	uint32_t entries, rateEntries = 0;
+
+	rateStart = xTaskGetTickCount();
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_FS_LOGqueue, &LogEntry, portMAX_DELAY );
+		// Wake up at least once a second to flush entries that have waited too long
+		Status = xQueueReceive( FSW_FS_LOGqueue, &LogEntry, 1000 / portTICK_RATE_MS );
 
-		if( Status == pdPASS && FSW_FS_mode == 1 )
+		if( Status == pdPASS && LogEntry.type == LOG_HKSPILL )
+		{
+			// Written here so the housekeeping job never waits on the card. Its slot is freed even if the card is not mounted.
+			FSW_HANDH_writeHK( LogEntry.id );
+		}
+		else if( Status == pdPASS && FSW_FS_mode == 1 )
 		{
 			// log the received log entry
 			// Only log if the module is fully operational.
@@ -841,6 +752,12 @@ static void FSW_FS_LOGmanager( void *pvParameters )
 					log_WOD( LogEntry );
 				else if( LogEntry.type == LOG_CMD )
 					log_CMD( LogEntry );
+				else if( LogEntry.type == LOG_SYNC )
+				{
+					FSW_LOGW_flush( &FSW_FS_errLog, FSW_LOGW_FLUSH_SYNC );
+					FSW_LOGW_flush( &FSW_FS_cmdLog, FSW_LOGW_FLUSH_SYNC );
+					FSW_LOGW_flush( &FSW_FS_wodLog, FSW_LOGW_FLUSH_SYNC );
+				}
 			}
 			else
 			{
@@ -848,9 +765,26 @@ static void FSW_FS_LOGmanager( void *pvParameters )
 				// disk needs to be periodically checked with disk_status() to update module mode
 			}
 		}
+
+		now = xTaskGetTickCount();
+
+		if( FSW_LOGW_due( &FSW_FS_errLog, now, LOG_FLUSH_MS / portTICK_RATE_MS ) )
+			FSW_LOGW_flush( &FSW_FS_errLog, FSW_LOGW_FLUSH_TIMEOUT );
+		if( FSW_LOGW_due( &FSW_FS_cmdLog, now, LOG_FLUSH_MS / portTICK_RATE_MS ) )
+			FSW_LOGW_flush( &FSW_FS_cmdLog, FSW_LOGW_FLUSH_TIMEOUT );
+		if( FSW_LOGW_due( &FSW_FS_wodLog, now, LOG_FLUSH_MS / portTICK_RATE_MS ) )
+			FSW_LOGW_flush( &FSW_FS_wodLog, FSW_LOGW_FLUSH_TIMEOUT );
+
+		// Update the logging rate once a second
+		if( ( portTickType )( now - rateStart ) >= 1000 / portTICK_RATE_MS )
+		{
+			entries = FSW_FS_errLog.stats.entries + FSW_FS_cmdLog.stats.entries + FSW_FS_wodLog.stats.entries;
+			FSW_FS_logRate = (uint16_t)( ( entries - rateEntries ) * ( 1000 / portTICK_RATE_MS ) / ( now - rateStart ) );
+			rateEntries = entries;
+			rateStart = now;
+		}
 	}
 
 	// Delete the task if it ever breaks out of the loop above
 	vTaskDelete( NULL );
 }
-
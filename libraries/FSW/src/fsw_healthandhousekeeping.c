@@ -6,6 +6,10 @@
  * functions including retrieving the health of various subsystems, determining if
  * corrective procedures should be run, and running housekeeping procedures
  * such as maintaining the date and time.
+ *
+ * The OBC date and time is not counted here but read from the RTC timebase,
+ * offset to the date the ground last set and corrected for the rate error of
+ * the crystal, which the ground's successive settings reveal.
  * @author	Andre Heunis
  * @date	02/09/2013
  *******************************************************************************
@@ -30,7 +34,16 @@
  *
  ******************************************************************************/
 
+#include <string.h>
 #include "fsw_healthandhousekeeping.h"
+#include "fsw_cmdpool.h"
+#include "fsw_link.h"
+#include "fsw_filesystem.h"
+#include "fsw_tlmstore.h"
+#include "fsw_hkseries.h"
+#include "fsw_memmap.h"
+#include "fsw_periodic.h"
+#include "bsp_sleep.h"
 
 #define CMD_Qlen	6
 #define DATA_Qlen	6
@@ -44,12 +57,25 @@
 #define TLMID_V2			0x02
 #define TLMID_OBCTEMP		0x03
 
-// For sending data of variable length over UART
-#define UART_ESCAPECHAR 0x1F
-#define UART_SOM        0x7F
-#define UART_EOM        0xFF
+#define TLMSTREAM_ID		0x06		///< Link frame ID of a TLM stream update
+#define HKSERIES_ID			0x07		///< Link frame ID of downlinked housekeeping records
+#define TRACE_ID			0x08		///< Link frame ID of a kernel trace dump
+
+#define HKS_MEM				BSP_EBI_SRAM2_BASE	///< External SRAM holding the housekeeping series
+#define HKS_SPILLPATH		"/HKSERIES.BIN"		///< File the spilled blocks of minute rollups are appended to
+#define HKS_SPILLSLOTS		4					///< Spilled blocks waiting for the file system task
+#define HKS_SPILLMEM		( HKS_MEM + ( ( FSW_HKS_MEMSIZE + 3 ) & ~3 ) )	///< The spill slots, after the series in the external SRAM
+
+#define HANDH_MAXTASKS		24		///< Tasks the task telemetry can account for, the idle and timer tasks included
+#define HANDH_TLMTASKS		10		///< Busiest tasks reported in the task telemetry
 
-static xTaskHandle IncrementOBCTime_handle;
+/// Kinds of trace dump frame, the first byte of the payload
+#define TRACE_HEADER		0
+#define TRACE_TASKS			1
+#define TRACE_QUEUES		2
+#define TRACE_EVENTS		3
+#define TRACE_TASKLEN		( 6 + configMAX_TASK_NAME_LEN )				///< Bytes of a task in a frame
+#define TRACE_EVENTLEN		8											///< Bytes of an event in a frame
 
 static uint8_t FSW_HANDH_MSV = 0;			///< Health status byte for HandH module.
 static uint8_t FSW_HANDH_mode = 0;
@@ -57,6 +83,22 @@ static uint8_t FSW_HANDH_mode = 0;
 HANDH_EnviroTLM_Typedef HAND_EnviroTLM;			///< Structure to hold environmental TLM
 HANDH_EnviroTLMselection_Typedef HANDH_EnviroTLMselection;	///< Flags to indicate which telemetry to send
 
+static FIL FSW_HANDH_hkFile;				///< Spilled housekeeping blocks
+static uint8_t FSW_HANDH_hkFileOpen = 0;
+static uint16_t FSW_HANDH_hkSpillErrors = 0;	///< Blocks that could not be written to the card, and were lost
+static volatile uint8_t FSW_HANDH_hkSlotBusy[HKS_SPILLSLOTS];	///< Set by the spill, cleared by the file system task once written
+static uint8_t FSW_HANDH_hkPrimed = 0;		///< Whether the last housekeeping run started an ADC burst, so its window is fresh
+
+static xTaskStatusType FSW_HANDH_tasks[HANDH_MAXTASKS];		///< Task states, kept off the task's stack
+static uint32_t FSW_HANDH_taskTime[HANDH_MAXTASKS + 1];		///< Run time of each task number at the last report
+static uint32_t FSW_HANDH_totalTime = 0;					///< Run time clock at the last report
+
+static int64_t  FSW_HANDH_syncTimeUs = 0;		///< OBC time set by the last sync, in us since 1970
+static uint64_t FSW_HANDH_syncUptimeUs = 0;		///< RTC time of the last sync
+static int32_t  FSW_HANDH_trimPpb = 0;			///< Rate correction of the RTC, in parts per billion
+static int32_t  FSW_HANDH_syncErrorUs = 0;		///< OBC time less the ground's at the last sync, saturated
+static uint16_t FSW_HANDH_syncs = 0;			///< Syncs since start up
+
 // TODO: These should possibly be moved to their corresponding modules
 // Health
 static void process_ADCShealth( uint8_t healthStatus );
@@ -72,16 +114,46 @@ static void FSW_HANDH_modeChange( uint8_t newMode );			///< Changes the module's
 static void FSW_HANDH_reportSysHealth( void );
 
 // OBC time
-static void setDate_and_Time( time_t epoch_num );
+static int64_t FSW_HANDH_timeAt( uint64_t uptimeUs );
 static void printOBCtime( void );
-static void IncrementOBCTime( void *pvParameters );
+
+// Telemetry
+static void FSW_HANDH_publishTLM( void );
+static void FSW_HANDH_publishEnergy( void );
+static void FSW_HANDH_publishTasks( void );
+static void FSW_HANDH_publishSchedule( void );
+
+// Housekeeping series
+static void FSW_HANDH_sampleHK( void );
+static void FSW_HANDH_spillHK( const uint8_t *block );
 
 // Satellite and module management
 static void FSW_HANDH_CMDmanager( void *pvParameters );			///< Subsystem command manager for the Health and Housekeeping module
 static void FSW_HANDH_DATAmanager( void *pvParameters );		///< Subsystem data manager for the Health and Housekeeping module
-
-// Real-time telemetry stream
-static void FSW_HANDH_TLMSTREAMmanager( void *pvParameters );
+static portSTACK_TYPE FSW_HANDH_CMDmanagerStack[ FSW_STACK_HANDH_CMD ];
+static portSTACK_TYPE FSW_HANDH_DATAmanagerStack[ FSW_STACK_HANDH_DATA ];
+
+static void FSW_HANDH_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDsetTime( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDreportTime( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDdownlinkHK( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDtrimTime( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDtrace( const CDH_CMD_TypeDef *CMD );
+static void FSW_HANDH_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_HANDH_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,							NULL,					0,	0				},		// 0x00
+		{ FSW_HANDH_CMDreportHealth,	&FSW_HANDH_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Report the health of this subsystem
+		{ FSW_HANDH_CMDsetTime,			&FSW_HANDH_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x02 Set OBC date and time
+		{ FSW_HANDH_CMDreportTime,		&FSW_HANDH_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x03 Return requested OBC date and time
+		{ FSW_HANDH_CMDdownlinkHK,		&FSW_HANDH_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x04 Downlink housekeeping records
+		{ FSW_HANDH_CMDtrimTime,		&FSW_HANDH_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x05 Set the rate correction of the OBC clock
+		{ FSW_HANDH_CMDtrace,			&FSW_HANDH_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x06 Dump, stop or restart the kernel trace
+		{ FSW_HANDH_CMDmodeChange,		&FSW_HANDH_CMDqueue,	1,	CDH_MODES_ALL	}		// 0x07 Change the module's mode
+};
+/*************************************************************************************************************************************/
 
 /*ADDED FOR HIL SIMULATION PURPOSES******************************************/
 //#ifdef HIL_sim
@@ -95,14 +167,127 @@ extern uint8_t adcs_H, cdh_H, comm_H, handh_H, payload_H, power_H;
  * @author Andre Heunis
  * @date   09/10/2013
  *
- * Getter function for the OBC_time
+ * Getter function for the OBC time, from the RTC timebase and the last sync
  * @param[out] OBC_time
- 				Current OBC_time
+ 				Current OBC time, UNIX seconds
  ******************************************************************************/
 
 time_t getOBC_time( void )
 {
-	return OBC_time;
+	return ( time_t )( FSW_HANDH_getTimeUs() / 1000000 );
+}
+
+/*
+ * OBC time at an RTC time: the time of the last sync, moved on by the RTC
+ * time since, corrected by the trim. The correction is taken per millisecond,
+ * so it cannot overflow in the life of the mission.
+ */
+static int64_t FSW_HANDH_timeAt( uint64_t uptimeUs )
+{
+	int64_t elapsed = ( int64_t )( uptimeUs - FSW_HANDH_syncUptimeUs );
+
+	return FSW_HANDH_syncTimeUs + elapsed + ( elapsed / 1000 ) * FSW_HANDH_trimPpb / 1000000;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the OBC date and time. Until the ground first sets
+ * it, it is the time since start up.
+ *
+ * @return
+ * 	The OBC date and time in microseconds since 1970.
+ ******************************************************************************/
+int64_t FSW_HANDH_getTimeUs( void )
+{
+	int64_t time;
+
+	taskENTER_CRITICAL();
+	time = FSW_HANDH_timeAt( BSP_RTC_getTimeUs() );
+	taskEXIT_CRITICAL();
+
+	return time;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets the OBC date and time to the ground's. The OBC time's
+ * error at a sync, over the time since the last, is the error of the trimmed
+ * clock rate, so after at least FSW_HANDH_SYNC_MINUS the trim is corrected by
+ * it. An error larger than the rate could have made is a step of the ground's
+ * time instead, and leaves the trim alone.
+ *
+ * @param[in] timeUs
+ * 	The ground's date and time in microseconds since 1970.
+ ******************************************************************************/
+void FSW_HANDH_syncTime( int64_t timeUs )
+{
+	uint64_t now;
+	int64_t error, span, trim;
+
+	taskENTER_CRITICAL();
+
+	now = BSP_RTC_getTimeUs();
+	error = FSW_HANDH_timeAt( now ) - timeUs;
+	span = ( int64_t )( now - FSW_HANDH_syncUptimeUs );
+
+	if( FSW_HANDH_syncs > 0 && span >= FSW_HANDH_SYNC_MINUS
+		&& llabs( error ) <= ( span / 1000 ) * FSW_HANDH_TRIM_MAXPPB / 1000000 )
+	{
+		trim = FSW_HANDH_trimPpb - error * 1000 / ( span / 1000000 );
+		if( trim > FSW_HANDH_TRIM_MAXPPB )
+		{
+			trim = FSW_HANDH_TRIM_MAXPPB;
+		}
+		else if( trim < -FSW_HANDH_TRIM_MAXPPB )
+		{
+			trim = -FSW_HANDH_TRIM_MAXPPB;
+		}
+		FSW_HANDH_trimPpb = ( int32_t )trim;
+	}
+
+	FSW_HANDH_syncErrorUs = ( error > INT32_MAX ) ? INT32_MAX : ( error < INT32_MIN ) ? INT32_MIN : ( int32_t )error;
+	FSW_HANDH_syncTimeUs = timeUs;
+	FSW_HANDH_syncUptimeUs = now;
+	FSW_HANDH_syncs++;
+
+	taskEXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets the rate correction of the OBC clock, e.g. from a
+ * ground measurement of the crystal, without stepping the time.
+ *
+ * @param[in] ppb
+ * 	Parts per billion the RTC runs slow by, limited to FSW_HANDH_TRIM_MAXPPB.
+ ******************************************************************************/
+void FSW_HANDH_trimTime( int32_t ppb )
+{
+	uint64_t now;
+
+	if( ppb > FSW_HANDH_TRIM_MAXPPB )
+	{
+		ppb = FSW_HANDH_TRIM_MAXPPB;
+	}
+	else if( ppb < -FSW_HANDH_TRIM_MAXPPB )
+	{
+		ppb = -FSW_HANDH_TRIM_MAXPPB;
+	}
+
+	taskENTER_CRITICAL();
+
+	now = BSP_RTC_getTimeUs();
+	FSW_HANDH_syncTimeUs = FSW_HANDH_timeAt( now );
+	FSW_HANDH_syncUptimeUs = now;
+	FSW_HANDH_trimPpb = ppb;
+
+	taskEXIT_CRITICAL();
 }
 
 /***************************************************************************//**
@@ -111,15 +296,16 @@ time_t getOBC_time( void )
  *
  * This function initializes the FSW's HandH interface module. Two queues are
  * initialized to receive commands and data. Two manager tasks are initialized
- * to read from these queues. An additional task is initialized to manage time
- * on the OBC.
+ * to read from these queues. The housekeeping and telemetry stream jobs are
+ * run by the periodic task schedule.
  ******************************************************************************/
 void FSW_HandH_Init( void )
 {
-	OBC_time = 0;
+	// The external SRAM must be initialised
+	FSW_HKS_Init( ( uint8_t * )HKS_MEM, FSW_HANDH_spillHK );
 
-	FSW_HANDH_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
-	FSW_HANDH_DATAqueue = xQueueCreate( DATA_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_HANDH_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
+	FSW_HANDH_DATAqueue = xQueueCreate( DATA_Qlen, sizeof( CDH_DATA_TypeDef ) );
 
 	if( FSW_HANDH_CMDqueue == NULL || FSW_HANDH_DATAqueue == NULL )
 	{
@@ -128,11 +314,13 @@ void FSW_HandH_Init( void )
 	}
 	else
 	{
-		xTaskCreate( IncrementOBCTime, "IncrementOBCTime", 240, NULL, 1, &IncrementOBCTime_handle );
-		xTaskCreate( FSW_HANDH_CMDmanager, "HANDH_CMDmanager", 240, NULL, 1, NULL );
-		xTaskCreate( FSW_HANDH_DATAmanager, "HANDH_DATAmanager", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_HANDH_CMDmanager, "HANDH_CMDmanager", FSW_HANDH_CMDmanagerStack, NULL, 1 );
+		FSW_TASK_CREATE( FSW_HANDH_DATAmanager, "HANDH_DATAmanager", FSW_HANDH_DATAmanagerStack, NULL, 1 );
 #ifdef HIL_sim
-		xTaskCreate( FSW_HANDH_TLMSTREAMmanager, "FSW_HANDH_TLMSTREAMmanager", 240, NULL, 1, NULL );
+		// Always enabled for testing
+		HANDH_EnviroTLMselection.HANDH_V1_flag = 1;
+		HANDH_EnviroTLMselection.HANDH_V2_flag = 1;
+		HANDH_EnviroTLMselection.HANDH_OBCtemp_flag = 1;
 #endif
 
 		FSW_HANDH_MSV = 0;
@@ -140,25 +328,6 @@ void FSW_HandH_Init( void )
 	}
 }
 
-/***************************************************************************//**
- * @author Andre Heunis
- * @date   11/09/2013
- *
- * Set the OBC date and time to the specified UNIX time stamp value
- ******************************************************************************/
-
-static void setDate_and_Time( time_t epoch_num )
-{
-	// suspend the task incrementing the date and time
-	vTaskSuspend( IncrementOBCTime_handle );
-
-	// set the new value for date and time
-	OBC_time = epoch_num;
-
-	// resume the task incrementing date and time
-	vTaskResume( IncrementOBCTime_handle );
-}
-
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   11/09/2013
@@ -174,12 +343,12 @@ static void FSW_HANDH_reportSysHealth( void )
 
 	// TODO: Rethink this function
 	// Send commands to all subsystems. Make 0x01 the general return health command
-	sendStatus = xQueueSendToBack( FSW_CDH_CMDqueue, &FSW_ADCS_ReportHealth, 0 );
-	sendStatus = xQueueSendToBack( FSW_CDH_CMDqueue, &FSW_CDH_ReportHealth, 0 );
-	sendStatus = xQueueSendToBack( FSW_CDH_CMDqueue, &FSW_COMM_ReportHealth, 0 );
+	sendStatus = FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &FSW_ADCS_ReportHealth, 0 );
+	sendStatus = FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &FSW_CDH_ReportHealth, 0 );
+	sendStatus = FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &FSW_COMM_ReportHealth, 0 );
 	FSW_HANDH_reportHealthStatus();
-	sendStatus = xQueueSendToBack( FSW_CDH_CMDqueue, &FSW_PAYLOAD_ReportHealth, 0 );
-	sendStatus = xQueueSendToBack( FSW_CDH_CMDqueue, &FSW_POWER_ReportHealth, 0 );
+	sendStatus = FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &FSW_PAYLOAD_ReportHealth, 0 );
+	sendStatus = FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &FSW_POWER_ReportHealth, 0 );
 }
 */
 
@@ -194,18 +363,13 @@ static void FSW_HANDH_reportSysHealth( void )
 
 static void FSW_HANDH_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_HANDH_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_HANDH_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_HANDH_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_HANDH_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -213,7 +377,8 @@ static void FSW_HANDH_reportHealthStatus( void )
  * @date   8/11/2013
  *
  * This function runs any procedures that might be associated with changing
- * the mode
+ * the mode. The housekeeping job samples the ADC in bursts while the module
+ * is on, so no mode starts it; switching off ends any burst under way.
  ******************************************************************************/
 
 static void FSW_HANDH_modeChange( uint8_t newMode )
@@ -224,7 +389,7 @@ static void FSW_HANDH_modeChange( uint8_t newMode )
 	switch( newMode )
 	{
 	case FSW_MODE_OFF:
-
+		BSP_ADC_stop();
 	break;
 
 	case FSW_MODE_ON:
@@ -326,30 +491,599 @@ static void process_POWERhealth( uint8_t healthStatus )
 	//printString("EPS ERROR!!!\n");
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the H&H module's entries in the routing table.
+ * They run in the FSW_HANDH_CMDmanager task.
+ ******************************************************************************/
+
+static void FSW_HANDH_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_HANDH_reportHealthStatus();
+}
+
+// TODO: In the simulation, 0x02 is for setting the satellite mode
+// Parameter: UNIX time in seconds, taken as the start of that second
+static void FSW_HANDH_CMDsetTime( const CDH_CMD_TypeDef *CMD )
+{
+	//HandH_logCMD( CMD );
+	FSW_HANDH_syncTime( ( int64_t )CMD->params[0] * 1000000 );
+}
+
+static void FSW_HANDH_CMDreportTime( const CDH_CMD_TypeDef *CMD )
+{
+	uint8_t report[4];
+
+	addToBuffer_uint32 ( report, (uint32_t)getOBC_time() );
+
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 4, false);
+}
+
+// Parameter: parts per billion the RTC crystal runs slow by, two's complement
+static void FSW_HANDH_CMDtrimTime( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_HANDH_trimTime( ( int32_t )CMD->params[0] );
+}
+
+// Parameter: tier in bits 31..28, channel in bits 27..24 and how many seconds
+// back to start in bits 23..0. Every record from then on is sent, in frames
+// of the tier, channel, time of the first record and record count, followed
+// by the means for samples and by the minimum, maximum and mean for rollups.
+static void FSW_HANDH_CMDdownlinkHK( const CDH_CMD_TypeDef *CMD )
+{
+	static const uint16_t period[FSW_HKS_TIERS] = { 1, 60, 600 };
+	FSW_HKS_Rollup_TypeDef records[( FSW_LINK_MAXPAYLOAD - 7 ) / 2];
+	uint8_t payload[FSW_LINK_MAXPAYLOAD];
+	uint8_t frame[FSW_LINK_FRAMEMAX];
+	uint8_t tier = ( uint8_t )( CMD->params[0] >> 28 );
+	uint8_t channel = ( uint8_t )( ( CMD->params[0] >> 24 ) & 0x0F );
+	uint32_t back = CMD->params[0] & 0x00FFFFFF;
+	uint32_t now, from, first;
+	uint16_t len, n, i;
+	uint8_t seq = 0;
+
+	if( tier >= FSW_HKS_TIERS )
+	{
+		return;
+	}
+
+	now = (uint32_t)getOBC_time();
+	from = ( now > back ) ? now - back : 0;
+	while( ( n = FSW_HKS_query( tier, channel, from, records,
+								( tier == FSW_HKS_TIER_SECOND ) ? ( FSW_LINK_MAXPAYLOAD - 7 ) / 2 : ( FSW_LINK_MAXPAYLOAD - 7 ) / 6,
+								&first ) ) != 0 )
+	{
+		addToBuffer_uint8 ( &(payload[0]), tier );
+		addToBuffer_uint8 ( &(payload[1]), channel );
+		addToBuffer_uint32( &(payload[2]), first );
+		addToBuffer_uint8 ( &(payload[6]), (uint8_t)n );
+		len = 7;
+		for( i = 0; i < n; i++ )
+		{
+			if( tier != FSW_HKS_TIER_SECOND )
+			{
+				addToBuffer_uint16( &(payload[len]), (uint16_t)records[i].min );
+				addToBuffer_uint16( &(payload[len + 2]), (uint16_t)records[i].max );
+				len += 4;
+			}
+			addToBuffer_uint16( &(payload[len]), (uint16_t)records[i].mean );
+			len += 2;
+		}
+
+		len = FSW_LINK_encode( frame, HKSERIES_ID, seq++, payload, (uint8_t)len );
+		BSP_UART_txBuffer( BSP_UART_DEBUG, frame, len, true );
+
+		from = first + n * period[tier];
+	}
+}
+
+// Parameter: 0 to dump the kernel trace and restart it on a clear ring, 1 to
+// stop it so the ring keeps the events up to now, 2 to clear the ring and
+// restart it. A dump is a delimiter, so a receiver that joined mid-stream
+// starts clean, and TRACE_ID frames numbered from 0, the kind first in each:
+// a header of the events recorded and dumped, the RTC time and the task and
+// queue counts; the tasks' numbers, priorities, run times and names; the
+// queues' lengths and types; and the events, oldest first. Recording stops
+// while the ring is read, so the dump is not traced.
+static void FSW_HANDH_CMDtrace( const CDH_CMD_TypeDef *CMD )
+{
+	BSP_TRACE_Event_TypeDef events[( FSW_LINK_MAXPAYLOAD - 1 ) / TRACE_EVENTLEN];
+	BSP_TRACE_Queue_TypeDef queue;
+	uint8_t payload[FSW_LINK_MAXPAYLOAD];
+	uint8_t frame[FSW_LINK_FRAMEMAX];
+	unsigned portBASE_TYPE count, i, j, number;
+	uint32_t written, next;
+	uint16_t len, n;
+	uint8_t queues, seq = 0;
+
+	if( CMD->params[0] == 1 )
+	{
+		BSP_TRACE_enable( false );
+		return;
+	}
+	if( CMD->params[0] != 0 )
+	{
+		BSP_TRACE_enable( true );
+		return;
+	}
+
+	BSP_TRACE_enable( false );
+	written = BSP_TRACE_written();
+	next = ( written > BSP_TRACE_EVENTS ) ? written - BSP_TRACE_EVENTS : 0;
+	queues = BSP_TRACE_queues();
+
+	frame[0] = FSW_LINK_DELIMITER;
+	BSP_UART_txBuffer( BSP_UART_DEBUG, frame, 1, true );
+
+	addToBuffer_uint8 ( &(payload[0]), TRACE_HEADER );
+	addToBuffer_uint32( &(payload[1]), written );
+	addToBuffer_uint16( &(payload[5]), (uint16_t)( written - next ) );
+	addToBuffer_uint32( &(payload[7]), BSP_SLEEP_getTime() );
+	addToBuffer_uint8 ( &(payload[11]), (uint8_t)uxTaskGetNumberOfTasks() );
+	addToBuffer_uint8 ( &(payload[12]), queues );
+	len = FSW_LINK_encode( frame, TRACE_ID, seq++, payload, 13 );
+	BSP_UART_txBuffer( BSP_UART_DEBUG, frame, len, true );
+
+	// Tasks are sent in order of their number, as the order of the states changes between calls. The states are
+	// shared with the task telemetry, which may preempt this.
+	for( number = 0; ; )
+	{
+		vTaskSuspendAll();
+		count = uxTaskGetSystemState( FSW_HANDH_tasks, HANDH_MAXTASKS, NULL );
+		addToBuffer_uint8( &(payload[0]), TRACE_TASKS );
+		len = 1;
+		while( len + TRACE_TASKLEN <= FSW_LINK_MAXPAYLOAD )
+		{
+			// The task with the next number
+			for( i = 0, j = count; i < count; i++ )
+			{
+				if( FSW_HANDH_tasks[i].xTaskNumber > number
+						&& ( j == count || FSW_HANDH_tasks[i].xTaskNumber < FSW_HANDH_tasks[j].xTaskNumber ) )
+				{
+					j = i;
+				}
+			}
+			if( j == count )
+			{
+				break;
+			}
+			number = FSW_HANDH_tasks[j].xTaskNumber;
+
+			addToBuffer_uint8 ( &(payload[len]), (uint8_t)number );
+			addToBuffer_uint8 ( &(payload[len + 1]), (uint8_t)FSW_HANDH_tasks[j].uxCurrentPriority );
+			addToBuffer_uint32( &(payload[len + 2]), (uint32_t)FSW_HANDH_tasks[j].ulRunTimeCounter );
+			memset( &(payload[len + 6]), 0, configMAX_TASK_NAME_LEN );
+			strncpy( (char*)&(payload[len + 6]), (const char*)FSW_HANDH_tasks[j].pcTaskName, configMAX_TASK_NAME_LEN );
+			len += TRACE_TASKLEN;
+		}
+		xTaskResumeAll();
+
+		if( len == 1 )
+		{
+			break;
+		}
+		len = FSW_LINK_encode( frame, TRACE_ID, seq++, payload, (uint8_t)len );
+		BSP_UART_txBuffer( BSP_UART_DEBUG, frame, len, true );
+	}
+
+	for( i = 1; i <= queues && i <= BSP_TRACE_MAXQUEUES; i += j )
+	{
+		addToBuffer_uint8( &(payload[0]), TRACE_QUEUES );
+		addToBuffer_uint8( &(payload[1]), (uint8_t)i );
+		len = 2;
+		for( j = 0; i + j <= queues && i + j <= BSP_TRACE_MAXQUEUES && len + 3 <= FSW_LINK_MAXPAYLOAD; j++ )
+		{
+			BSP_TRACE_getQueue( (uint8_t)( i + j ), &queue );
+			addToBuffer_uint16( &(payload[len]), queue.length );
+			addToBuffer_uint8 ( &(payload[len + 2]), queue.type );
+			len += 3;
+		}
+		len = FSW_LINK_encode( frame, TRACE_ID, seq++, payload, (uint8_t)len );
+		BSP_UART_txBuffer( BSP_UART_DEBUG, frame, len, true );
+	}
+
+	while( ( n = BSP_TRACE_read( next, events, sizeof( events ) / sizeof( events[0] ) ) ) != 0 )
+	{
+		addToBuffer_uint8( &(payload[0]), TRACE_EVENTS );
+		len = 1;
+		for( i = 0; i < n; i++ )
+		{
+			addToBuffer_uint32( &(payload[len]), events[i].time );
+			addToBuffer_uint8 ( &(payload[len + 4]), events[i].type );
+			addToBuffer_uint8 ( &(payload[len + 5]), events[i].id );
+			addToBuffer_uint16( &(payload[len + 6]), events[i].value );
+			len += TRACE_EVENTLEN;
+		}
+		len = FSW_LINK_encode( frame, TRACE_ID, seq++, payload, (uint8_t)len );
+		BSP_UART_txBuffer( BSP_UART_DEBUG, frame, len, true );
+
+		next += n;
+	}
+
+	BSP_TRACE_enable( true );
+}
+
+static void FSW_HANDH_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_HANDH_modeChange( (uint8_t)CMD->params[0] );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Publishes the OBC time and the C&DH, file system and housekeeping series
+ * counters to the telemetry store once a second, so telemetry requests are
+ * answered without calling the getters, some of which mask interrupts, from
+ * the I2C interrupt.
+ ******************************************************************************/
+static void FSW_HANDH_publishTLM( void )
+{
+	uint8_t tlm[28];
+	FSW_CMDPOOL_Stats_TypeDef poolStats;
+	CDH_RouteStats_TypeDef routeStats;
+	FSW_LOGW_Stats_TypeDef logStats;
+	uint16_t logRate;
+	DISKCACHE_Stats_TypeDef cacheStats;
+	FSW_HKS_Stats_TypeDef hkStats;
+
+	FSW_CMDPOOL_getStats( &poolStats );
+	addToBuffer_uint8 ( &(tlm[0]), poolStats.inUse );
+	addToBuffer_uint8 ( &(tlm[1]), poolStats.hwm );
+	addToBuffer_uint16( &(tlm[2]), poolStats.exhausted );
+	addToBuffer_uint32( &(tlm[4]), poolStats.allocs );
+	FSW_TLM_publish( FSW_TLM_CMDPOOL, tlm, 8 );
+
+	FSW_CDH_getRouteStats( &routeStats );
+	addToBuffer_uint16( &(tlm[0]), routeStats.rejected );
+	addToBuffer_uint8 ( &(tlm[2]), routeStats.lastError );
+	addToBuffer_uint8 ( &(tlm[3]), routeStats.lastDest );
+	addToBuffer_uint8 ( &(tlm[4]), routeStats.lastId );
+	FSW_TLM_publish( FSW_TLM_ROUTER, tlm, 5 );
+
+	FSW_FS_getLogStats( &logStats, &logRate );
+	addToBuffer_uint32( &(tlm[0]), logStats.entries );
+	addToBuffer_uint16( &(tlm[4]), logRate );
+	addToBuffer_uint32( &(tlm[6]), logStats.entryBytes );
+	addToBuffer_uint32( &(tlm[10]), logStats.sectorWrites );
+	addToBuffer_uint16( &(tlm[14]), logStats.syncs );
+	addToBuffer_uint16( &(tlm[16]), logStats.errors );
+	FSW_TLM_publish( FSW_TLM_LOGWRITER, tlm, 18 );
+
+	FSW_FS_getCacheStats( &cacheStats );
+	addToBuffer_uint32( &(tlm[0]), cacheStats.reads );
+	addToBuffer_uint32( &(tlm[4]), cacheStats.readHits );
+	addToBuffer_uint32( &(tlm[8]), cacheStats.writes );
+	addToBuffer_uint32( &(tlm[12]), cacheStats.writeHits );
+	addToBuffer_uint32( &(tlm[16]), cacheStats.diskWrites );
+	addToBuffer_uint32( &(tlm[20]), cacheStats.diskWriteCmds );
+	addToBuffer_uint16( &(tlm[24]), cacheStats.pinned );
+	addToBuffer_uint16( &(tlm[26]), cacheStats.dirty );
+	FSW_TLM_publish( FSW_TLM_CACHE, tlm, 28 );
+
+	addToBuffer_uint32( &(tlm[0]), (uint32_t)getOBC_time() );
+	addToBuffer_uint32( &(tlm[4]), (uint32_t)FSW_HANDH_trimPpb );
+	addToBuffer_uint32( &(tlm[8]), (uint32_t)FSW_HANDH_syncErrorUs );
+	addToBuffer_uint16( &(tlm[12]), FSW_HANDH_syncs );
+	FSW_TLM_publish( FSW_TLM_OBCTIME, tlm, 14 );
+
+	FSW_HKS_getStats( &hkStats );
+	addToBuffer_uint32( &(tlm[0]), hkStats.samples );
+	addToBuffer_uint32( &(tlm[4]), hkStats.gaps );
+	addToBuffer_uint16( &(tlm[8]), hkStats.restarts );
+	addToBuffer_uint16( &(tlm[10]), hkStats.spills );
+	addToBuffer_uint32( &(tlm[12]), hkStats.spilledBytes );
+	addToBuffer_uint16( &(tlm[16]), FSW_HANDH_hkSpillErrors );
+	FSW_TLM_publish( FSW_TLM_HKSERIES, tlm, 18 );
+
+	FSW_HANDH_publishEnergy();
+	FSW_HANDH_publishTasks();
+	FSW_HANDH_publishSchedule();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Publishes the time the MCU spent in EM0, EM1 and EM2 since the last report,
+ * in per mille, the sleeps, ticks and suppressed ticks in that time, the EM1
+ * holds, and the average MCU current estimated from the time in each mode.
+ ******************************************************************************/
+static void FSW_HANDH_publishEnergy( void )
+{
+	static BSP_SLEEP_Stats_TypeDef last;
+	static uint32_t lastTime = 0;
+	BSP_SLEEP_Stats_TypeDef stats;
+	uint32_t now, span, em0, em1, em2, current;
+	uint8_t tlm[17];
+
+	BSP_SLEEP_getStats( &stats );
+	now = BSP_SLEEP_getTime();
+
+	span = now - lastTime;
+	em1 = stats.em1Time - last.em1Time;
+	em2 = stats.em2Time - last.em2Time;
+	if( span < em1 + em2 )
+		span = em1 + em2;		// the sleep in progress was counted after the clock was read
+	if( span == 0 )
+		span = 1;
+	em0 = span - em1 - em2;
+
+	current = ( uint32_t )( ( ( uint64_t )em0 * BSP_SLEEP_EM0_UA + ( uint64_t )em1 * BSP_SLEEP_EM1_UA
+			+ ( uint64_t )em2 * BSP_SLEEP_EM2_UA ) / span );
+
+	addToBuffer_uint16( &(tlm[0]), ( uint16_t )( ( ( uint64_t )em0 * 1000 ) / span ) );
+	addToBuffer_uint16( &(tlm[2]), ( uint16_t )( ( ( uint64_t )em1 * 1000 ) / span ) );
+	addToBuffer_uint16( &(tlm[4]), ( uint16_t )( ( ( uint64_t )em2 * 1000 ) / span ) );
+	addToBuffer_uint16( &(tlm[6]), ( uint16_t )( stats.sleeps - last.sleeps ) );
+	addToBuffer_uint16( &(tlm[8]), ( uint16_t )( stats.ticks - last.ticks ) );
+	addToBuffer_uint16( &(tlm[10]), ( uint16_t )( stats.suppressed - last.suppressed ) );
+	addToBuffer_uint16( &(tlm[12]), ( uint16_t )( stats.aborted - last.aborted ) );
+	addToBuffer_uint8 ( &(tlm[14]), ( uint8_t )stats.holds );
+	addToBuffer_uint16( &(tlm[15]), ( uint16_t )current );
+	FSW_TLM_publish( FSW_TLM_ENERGY, tlm, 17 );
+
+	last = stats;
+	lastTime = now;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Publishes the number of tasks and the CPU share of the busiest
+ * HANDH_TLMTASKS since the last report, in 0.1 %, from the kernel's run time
+ * stats. Tasks are identified by their task number, their order of creation.
+ * The idle task's share includes the time slept.
+ ******************************************************************************/
+static void FSW_HANDH_publishTasks( void )
+{
+	unsigned long total;
+	unsigned portBASE_TYPE count, i, j, n;
+	uint32_t span, run, number;
+	uint16_t share[HANDH_TLMTASKS];
+	uint8_t numbers[HANDH_TLMTASKS];
+	uint8_t tlm[1 + 3 * HANDH_TLMTASKS];
+	uint16_t permille;
+
+	count = uxTaskGetSystemState( FSW_HANDH_tasks, HANDH_MAXTASKS, &total );
+
+	span = ( uint32_t )total - FSW_HANDH_totalTime;
+	FSW_HANDH_totalTime = ( uint32_t )total;
+	if( span == 0 )
+		span = 1;
+
+	// Keep the busiest, busiest first
+	n = 0;
+	for( i = 0; i < count; i++ )
+	{
+		number = FSW_HANDH_tasks[i].xTaskNumber;
+		if( number > HANDH_MAXTASKS )
+			continue;
+
+		run = ( uint32_t )FSW_HANDH_tasks[i].ulRunTimeCounter - FSW_HANDH_taskTime[number];
+		FSW_HANDH_taskTime[number] = ( uint32_t )FSW_HANDH_tasks[i].ulRunTimeCounter;
+		permille = ( uint16_t )( ( ( uint64_t )run * 1000 ) / span );
+
+		if( n < HANDH_TLMTASKS )
+			j = n++;
+		else if( permille > share[n - 1] )
+			j = n - 1;
+		else
+			continue;
+
+		for( ; j > 0 && share[j - 1] < permille; j-- )
+		{
+			share[j] = share[j - 1];
+			numbers[j] = numbers[j - 1];
+		}
+		share[j] = permille;
+		numbers[j] = ( uint8_t )number;
+	}
+
+	addToBuffer_uint8( &(tlm[0]), ( uint8_t )count );
+	for( i = 0; i < n; i++ )
+	{
+		addToBuffer_uint8 ( &(tlm[1 + 3 * i]), numbers[i] );
+		addToBuffer_uint16( &(tlm[2 + 3 * i]), share[i] );
+	}
+	FSW_TLM_publish( FSW_TLM_TASKS, tlm, ( uint8_t )( 1 + 3 * n ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Publishes the number of periodic jobs and, for each in the order of the
+ * schedule table, the deadlines it missed, its worst start jitter in us and
+ * its worst response in 0.1 ms, all since start up. Times saturate at 16 bits.
+ ******************************************************************************/
+static void FSW_HANDH_publishSchedule( void )
+{
+	FSW_PERIODIC_Stats_TypeDef stats;
+	uint8_t tlm[1 + 6 * FSW_PERIODIC_MAXTASKS];
+	uint8_t count, i;
+	uint32_t response;
+
+	count = FSW_PERIODIC_count();
+	if( count > FSW_PERIODIC_MAXTASKS )
+		count = FSW_PERIODIC_MAXTASKS;
+	addToBuffer_uint8( &(tlm[0]), count );
+
+	for( i = 0; i < count; i++ )
+	{
+		FSW_PERIODIC_getStats( i, &stats );
+		response = stats.worstResponseUs / 100;
+
+		addToBuffer_uint16( &(tlm[1 + 6 * i]), ( uint16_t )( ( stats.misses > 0xFFFF ) ? 0xFFFF : stats.misses ) );
+		addToBuffer_uint16( &(tlm[3 + 6 * i]), ( uint16_t )( ( stats.worstJitterUs > 0xFFFF ) ? 0xFFFF : stats.worstJitterUs ) );
+		addToBuffer_uint16( &(tlm[5 + 6 * i]), ( uint16_t )( ( response > 0xFFFF ) ? 0xFFFF : response ) );
+	}
+
+	FSW_TLM_publish( FSW_TLM_SCHEDULE, tlm, ( uint8_t )( 1 + 6 * count ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Adds the second's sample of the ADC channels to the housekeeping series:
+ * the mean over each channel's last window, the burst the previous run of
+ * the housekeeping started at the default ADC configuration.
+ ******************************************************************************/
+static void FSW_HANDH_sampleHK( void )
+{
+	int16_t values[FSW_HKS_CHANNELS];
+	uint8_t c;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		values[c] = BSP_ADC_getMean( (ADC_Channel_TypeDef)c );
+	}
+
+	FSW_HKS_add( (uint32_t)getOBC_time(), values );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Copies a full block of minute rollups to a free spill slot in the external
+ * SRAM and queues it for the file system task, which writes it with
+ * FSW_HANDH_writeHK. The card is never waited on here, as the spill is made
+ * by the housekeeping job. A block with no free slot or no room in the queue
+ * is counted and dropped.
+ *
+ * @param[in] block
+ * 		FSW_HKS_BLOCK bytes.
+ ******************************************************************************/
+static void FSW_HANDH_spillHK( const uint8_t *block )
+{
+	FS_LogEntry_TypeDef entry = { 0, LOG_HKSPILL, FSW_HANDH, 0 };
+	uint8_t slot;
+
+	for( slot = 0; slot < HKS_SPILLSLOTS; slot++ )
+	{
+		if( !FSW_HANDH_hkSlotBusy[slot] )
+		{
+			break;
+		}
+	}
+	if( slot == HKS_SPILLSLOTS )
+	{
+		taskENTER_CRITICAL();
+		FSW_HANDH_hkSpillErrors++;
+		taskEXIT_CRITICAL();
+		return;
+	}
+
+	memcpy( ( uint8_t * )HKS_SPILLMEM + slot * FSW_HKS_BLOCK, block, FSW_HKS_BLOCK );
+	FSW_HANDH_hkSlotBusy[slot] = 1;
+
+	entry.exe_time = ( uint32_t )getOBC_time();
+	entry.id = slot;
+	if( xQueueSendToBack( FSW_FS_LOGqueue, &entry, 0 ) != pdTRUE )
+	{
+		FSW_HANDH_hkSlotBusy[slot] = 0;
+		taskENTER_CRITICAL();
+		FSW_HANDH_hkSpillErrors++;
+		taskEXIT_CRITICAL();
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Appends a spilled block to the spill file, opening it on first use, and
+ * frees its slot. A block that cannot be written is counted and dropped, and
+ * the file is opened again for the next. Called by the file system task for
+ * each block FSW_HANDH_spillHK queues.
+ *
+ * @param[in] slot
+ * 		Spill slot holding the block.
+ ******************************************************************************/
+void FSW_HANDH_writeHK( uint8_t slot )
+{
+	const uint8_t *block = ( const uint8_t * )HKS_SPILLMEM + slot * FSW_HKS_BLOCK;
+	FRESULT res = FR_OK;
+	UINT written = 0;
+
+	if( slot >= HKS_SPILLSLOTS )
+	{
+		return;
+	}
+
+	if( !FSW_HANDH_hkFileOpen )
+	{
+		res = f_open( &FSW_HANDH_hkFile, HKS_SPILLPATH, FA_WRITE | FA_OPEN_ALWAYS );
+		if( res == FR_OK )
+		{
+			res = f_lseek( &FSW_HANDH_hkFile, f_size( &FSW_HANDH_hkFile ) );
+			FSW_HANDH_hkFileOpen = 1;
+		}
+	}
+
+	if( res == FR_OK )
+	{
+		res = f_write( &FSW_HANDH_hkFile, block, FSW_HKS_BLOCK, &written );
+	}
+	if( res == FR_OK )
+	{
+		res = f_sync( &FSW_HANDH_hkFile );
+	}
+
+	if( res != FR_OK || written != FSW_HKS_BLOCK )
+	{
+		taskENTER_CRITICAL();
+		FSW_HANDH_hkSpillErrors++;
+		taskEXIT_CRITICAL();
+		if( FSW_HANDH_hkFileOpen )
+		{
+			f_close( &FSW_HANDH_hkFile );
+			FSW_HANDH_hkFileOpen = 0;
+		}
+	}
+
+	FSW_HANDH_hkSlotBusy[slot] = 0;
+}
+
 // TASKS *******************************************************************************************************************************************************************
 
 /***************************************************************************//**
  * @author Andre Heunis
  * @date   11/09/2013
  *
- * Task to update the OBC date and time every second.
+ * Job to sample the housekeeping and publish the telemetry, released every
+ * second by the periodic task schedule. It no longer counts the OBC date and
+ * time, which is read from the RTC.
  ******************************************************************************/
 
-static void IncrementOBCTime( void *pvParameters )
+void FSW_HANDH_HKexe( void )
 {
-	while(1)
+	// The ADC is not sampled while the module is off; the series records the gap
+	if( FSW_HANDH_mode == FSW_MODE_OFF )
 	{
-		vTaskDelay(1000/portTICK_RATE_MS);	// more accurate to use delay until?
-
-		OBC_time++;
+		FSW_HANDH_hkPrimed = 0;
+	}
+	else
+	{
+		// The first run after start up or after being off has no burst to read
+		if( FSW_HANDH_hkPrimed )
+		{
+			FSW_HANDH_sampleHK();
+		}
+		// Ready next second's sample; EM1 is held only while the burst runs
+		BSP_ADC_burst();
+		FSW_HANDH_hkPrimed = 1;
+	}
+	FSW_HANDH_publishTLM();
 
 #ifndef HIL_sim
-		printOBCtime();
+	printOBCtime();
 #endif
-	}
-
-	// Delete the task if it ever breaks out of the loop above
-	vTaskDelete( NULL );
 }
 
 
@@ -363,48 +1097,19 @@ static void IncrementOBCTime( void *pvParameters )
 
 static void FSW_HANDH_CMDmanager( void *pvParameters )
 {
-	CDH_CMD_TypeDef ReceivedCMD;
 	portBASE_TYPE Status;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_HANDH_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_HANDH_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch(ReceivedCMD.id)
+			// Runs the handler listed in FSW_HANDH_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:	// Report the health of this subsystem
-				FSW_HANDH_reportHealthStatus();
-				break;
-
-			// TODO: In the simulation, 0x02 is for setting the satellite mode
-			case 0x02:	// Set OBC date and time
-				//HandH_logCMD( ReceivedCMD );
-				setDate_and_Time((time_t)(ReceivedCMD.params[0]));
-				break;
-
-			case 0x03: // Return requested OBC date and time
-				addToBuffer_uint32 ( uartTxBuffer, (uint32_t)OBC_time );
-
-				if( !BSP_UART_txInProgress() )
-				{
-					BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 4, true);
-				}
-				else
-				{
-					while(1);
-				}
-				break;
-				/*
-			case 0x04:	// request the health of all subsystems
-				FSW_HANDH_reportSysHealth();
-				break;
-				*/
-			default:	// Set the 2nd bit to indicate an unknown CMD was received
-				FSW_HANDH_MSV &= ERROR_CMDINV;
-				while(1);
-				break;
+				FSW_HANDH_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
@@ -473,91 +1178,74 @@ static void FSW_HANDH_DATAmanager( void *pvParameters )
  * @author Andre Heunis
  * @date   05/09/2013
  *
- * Task to handle the real-time TLM stream. This stream transmits the TLM
- * specified by the user at the rate specified by the user.
+ * Job to handle the real-time TLM stream, released every three seconds by the
+ * periodic task schedule. This stream transmits the TLM specified by the user.
  ******************************************************************************/
 
-static void FSW_HANDH_TLMSTREAMmanager( void *pvParameters )
+void FSW_HANDH_TLMstream( void )
 {
+	static uint8_t TLM_buffer[FSW_LINK_FRAMEMAX];	///< TLM frame to send to fsw_comm for transmission, still referenced after the job returns
+	static uint8_t TLM_seq = 0;
 	CDH_CMD_TypeDef Telemetry;
-	uint8_t TLM_buffer[50];						///< TLM buf to send to fsw_comm for transmission
+	uint8_t TLM_payload[16];					///< Selected TLM fields
 	uint8_t TLM_buffer_index = 0;
 	float OBCTEMP = 0;
 	unsigned long long_OBCTEMP = 0;
 
-	// Always enabled for testing
-	HANDH_EnviroTLMselection.HANDH_V1_flag = 1;
-	HANDH_EnviroTLMselection.HANDH_V2_flag = 1;
-	HANDH_EnviroTLMselection.HANDH_OBCtemp_flag = 1;
+	// Update all the telemetry fields
+	HAND_EnviroTLM.HANDH_V1 = BSP_ADC_getData(CHANNEL0);
+	HAND_EnviroTLM.HANDH_V2 = BSP_ADC_getData(CHANNEL1);
+	//HAND_EnviroTLM.HANDH_OBCtemp = BSP_ADC_getData(TEMPERATURE);
 
-	while(1)
+	// Construct the fields to send
+	if( HANDH_EnviroTLMselection.HANDH_V1_flag )
 	{
-		// TLM is sent every 3 seconds
-		vTaskDelay(3000/portTICK_RATE_MS);
-		BSP_ADC_update(1);
-
-		// Update all the telemetry fields
-		HAND_EnviroTLM.HANDH_V1 = BSP_ADC_getData(CHANNEL0);
-		HAND_EnviroTLM.HANDH_V2 = BSP_ADC_getData(CHANNEL1);
-		//HAND_EnviroTLM.HANDH_OBCtemp = BSP_ADC_getData(TEMPERATURE);
-
-		// Construct buffer to send
-		TLM_buffer[TLM_buffer_index++] = UART_ESCAPECHAR;
-		TLM_buffer[TLM_buffer_index++] = UART_SOM;
-
-		if( HANDH_EnviroTLMselection.HANDH_V1_flag )
-		{
-			TLM_buffer[TLM_buffer_index++] = TLMID_V1;
-			TLM_buffer[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL0)&0x00FF);
-			TLM_buffer[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL0)&0xFF00)>>8;
-		}
-		if( HANDH_EnviroTLMselection.HANDH_V2_flag )
-		{
-			TLM_buffer[TLM_buffer_index++] = TLMID_V2;
-			TLM_buffer[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL1)&0x00FF);
-			TLM_buffer[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL1)&0xFF00)>>8;
-		}
-		if( HANDH_EnviroTLMselection.HANDH_OBCtemp_flag )
-		{
-			TLM_buffer[TLM_buffer_index++] = TLMID_OBCTEMP;
-
-			// Break the float into 4 bytes
-			OBCTEMP = BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE));
-			long_OBCTEMP = *(unsigned long*)&OBCTEMP;
+		TLM_payload[TLM_buffer_index++] = TLMID_V1;
+		TLM_payload[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL0)&0x00FF);
+		TLM_payload[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL0)&0xFF00)>>8;
+	}
+	if( HANDH_EnviroTLMselection.HANDH_V2_flag )
+	{
+		TLM_payload[TLM_buffer_index++] = TLMID_V2;
+		TLM_payload[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL1)&0x00FF);
+		TLM_payload[TLM_buffer_index++] = (BSP_ADC_getData(CHANNEL1)&0xFF00)>>8;
+	}
+	if( HANDH_EnviroTLMselection.HANDH_OBCtemp_flag )
+	{
+		TLM_payload[TLM_buffer_index++] = TLMID_OBCTEMP;
 
-			TLM_buffer[TLM_buffer_index++] = (long_OBCTEMP & 0xFF);
-			TLM_buffer[TLM_buffer_index++] = (long_OBCTEMP & 0xFF00) >> 8;
-			TLM_buffer[TLM_buffer_index++] = (long_OBCTEMP & 0xFF0000) >> 16;
-			TLM_buffer[TLM_buffer_index++] = (long_OBCTEMP & 0xFF000000) >> 24;
-		}
+		// Break the float into 4 bytes
+		OBCTEMP = BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE));
+		long_OBCTEMP = *(unsigned long*)&OBCTEMP;
 
+		TLM_payload[TLM_buffer_index++] = (long_OBCTEMP & 0xFF);
+		TLM_payload[TLM_buffer_index++] = (long_OBCTEMP & 0xFF00) >> 8;
+		TLM_payload[TLM_buffer_index++] = (long_OBCTEMP & 0xFF0000) >> 16;
+		TLM_payload[TLM_buffer_index++] = (long_OBCTEMP & 0xFF000000) >> 24;
+	}
 
-		TLM_buffer[TLM_buffer_index++] = UART_ESCAPECHAR;
-		TLM_buffer[TLM_buffer_index++] = UART_EOM;
+	// Framed, so the receiver finds its start and checks it with the CRC
+	TLM_buffer_index = FSW_LINK_encode( TLM_buffer, TLMSTREAM_ID, TLM_seq++, TLM_payload, TLM_buffer_index );
 
-		// Send telemetry. Currently just a command with a telemetry value as the parameter.
-		// Dont allow a different module (e.g fsw_comms.c) to gather the telemetry. Must be done here
-		Telemetry.id = 0x05;
-		Telemetry.params[0] = TLM_buffer;
-		Telemetry.len = TLM_buffer_index;
-		//Telemetry.params[0] = BSP_ADC_getData(CHANNEL1);	// Sample a voltage on the OBC
-		//Telemetry.params[0] = BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE));				// requires different conversions to byte arrays
+	// Send telemetry. Currently just a command with a telemetry value as the parameter.
+	// Dont allow a different module (e.g fsw_comms.c) to gather the telemetry. Must be done here
+	Telemetry.id = 0x05;
+	Telemetry.params[0] = TLM_buffer;
+	Telemetry.len = TLM_buffer_index;
+	//Telemetry.params[0] = BSP_ADC_getData(CHANNEL1);	// Sample a voltage on the OBC
+	//Telemetry.params[0] = BSP_ADC_temp2Float(BSP_ADC_getData(TEMPERATURE));				// requires different conversions to byte arrays
 
 /*
-		addToBuffer_uint16(&(txBuffer[0]),BSP_ADC_getData(CHANNEL0));
-		addToBuffer_uint16(&(txBuffer[2]),BSP_ADC_getData(CHANNEL1));
-		addToBuffer_uint16(&(txBuffer[4]),BSP_ADC_getData(CHANNEL2));
-		addToBuffer_uint16(&(txBuffer[6]),BSP_ADC_getData(CHANNEL3));
-		addToBuffer_uint16(&(txBuffer[8]),BSP_ADC_getData(TEMPERATURE));*/
-		//tlmLen = 10;
-
-		xQueueSendToBack( FSW_COMM_CMDqueue, &Telemetry, 0 );
-		TLM_buffer_index = 0;
-	}
-
-	// Delete the task if it ever breaks out of the loop above
-	vTaskDelete( NULL );
+	addToBuffer_uint16(&(txBuffer[0]),BSP_ADC_getData(CHANNEL0));
+	addToBuffer_uint16(&(txBuffer[2]),BSP_ADC_getData(CHANNEL1));
+	addToBuffer_uint16(&(txBuffer[4]),BSP_ADC_getData(CHANNEL2));
+	addToBuffer_uint16(&(txBuffer[6]),BSP_ADC_getData(CHANNEL3));
+	addToBuffer_uint16(&(txBuffer[8]),BSP_ADC_getData(TEMPERATURE));*/
+	//tlmLen = 10;
+
+	FSW_CMDPOOL_send( FSW_COMM_CMDqueue, &Telemetry, 0 );
 }
+
 // TEST FUNCTIONS *********************************************************************************************************************
 
 // Prints the current OBC date and time
@@ -565,7 +1253,7 @@ static void printOBCtime( void )
 {
 	char buf[21];
 
-	time_t now = OBC_time;
+	time_t now = getOBC_time();
 
 	struct tm ts;
 
@@ -0,0 +1,584 @@
+/***************************************************************************//**
+ * @file	fsw_hkseries.c
+ * @brief	FSW housekeeping time series source file.
+ *
+ * This file contains the housekeeping rings, their rollups, the range query
+ * and the block coding of the minute rollups.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fsw_hkseries.h"
+#include "fsw_crc.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup HandH
+ * @brief API for the housekeeping time series.
+ * @{
+ ******************************************************************************/
+
+/// Orders the ring writes against the index updates, for the compiler and the core.
+#define HKS_BARRIER()		__sync_synchronize()
+
+#define HKS_HEADERLEN		sizeof( FSW_HKS_BlockHeader_TypeDef )
+#define HKS_MINUTEMAX		( FSW_HKS_CHANNELS * 3 * 3 )		///< Longest coded minute: three varints of at most three bytes per channel.
+
+/// One resolution of the series.
+typedef struct{
+	void *ring;							///< int16_t samples for seconds, FSW_HKS_Rollup_TypeDef otherwise, FSW_HKS_CHANNELS per record.
+	uint16_t len;						///< Records kept.
+	uint16_t slots;						///< Records in the ring, one more than kept for the one being written.
+	uint16_t period;					///< Seconds per record.
+	volatile uint32_t next;				///< Index of the next record. A record's index is its time over the period.
+	volatile uint32_t first;			///< Index of the first record since the rings were emptied.
+}HKS_Tier_TypeDef;
+
+/// A channel's rollup being collected.
+typedef struct{
+	int16_t min;
+	int16_t max;
+	int32_t sum;
+	uint16_t n;
+}HKS_Sum_TypeDef;
+
+static HKS_Tier_TypeDef HKS_tier[FSW_HKS_TIERS];
+static HKS_Sum_TypeDef HKS_minute[FSW_HKS_CHANNELS];		///< Samples of the minute being collected
+static HKS_Sum_TypeDef HKS_tenMinute[FSW_HKS_CHANNELS];	///< Minute means of the ten minutes being collected
+static volatile uint32_t HKS_generation;					///< Counts the times the rings were emptied, for the queries.
+static uint8_t HKS_started;
+
+static FSW_HKS_SpillFunc HKS_spillFunc;
+static uint8_t HKS_block[FSW_HKS_BLOCK];					///< Header, then the minutes coded so far
+static uint16_t HKS_blockLen;								///< Bytes of coded minutes
+static uint16_t HKS_blockCount;								///< Minutes coded
+static uint32_t HKS_blockFirst;								///< Time of the first
+static int16_t HKS_blockMean[FSW_HKS_CHANNELS];				///< Means of the last, predicting the next
+
+static FSW_HKS_Stats_TypeDef HKS_stats;
+
+// FUNCTIONS *************************************************************************************************************************
+
+static void HKS_sumAdd( HKS_Sum_TypeDef *sum, int16_t min, int16_t max, int16_t mean )
+{
+	if( mean == FSW_HKS_NODATA )
+	{
+		return;
+	}
+	if( sum->n == 0 || min < sum->min )
+	{
+		sum->min = min;
+	}
+	if( sum->n == 0 || max > sum->max )
+	{
+		sum->max = max;
+	}
+	sum->sum += mean;
+	sum->n++;
+}
+
+/*
+ * Completes a rollup, with the mean rounded half away from zero, and starts
+ * the next.
+ */
+static void HKS_sumTake( HKS_Sum_TypeDef *sum, FSW_HKS_Rollup_TypeDef *rollup )
+{
+	if( sum->n == 0 )
+	{
+		rollup->min = rollup->max = rollup->mean = FSW_HKS_NODATA;
+	}
+	else
+	{
+		rollup->min = sum->min;
+		rollup->max = sum->max;
+		rollup->mean = ( int16_t )( ( sum->sum + ( sum->sum < 0 ? -( int32_t )sum->n : ( int32_t )sum->n ) / 2 ) / ( int32_t )sum->n );
+	}
+	sum->sum = 0;
+	sum->n = 0;
+}
+
+static void HKS_push( HKS_Tier_TypeDef *tier, uint32_t index, const FSW_HKS_Rollup_TypeDef *rollups )
+{
+	memcpy( ( FSW_HKS_Rollup_TypeDef * )tier->ring + ( index % tier->slots ) * FSW_HKS_CHANNELS, rollups,
+			FSW_HKS_CHANNELS * sizeof( FSW_HKS_Rollup_TypeDef ) );
+	HKS_BARRIER();
+	tier->next = index + 1;
+}
+
+static uint8_t HKS_putVarint( uint8_t *out, int32_t value )
+{
+	uint32_t zigzag = ( ( uint32_t )value << 1 ) ^ ( value < 0 ? 0xFFFFFFFFUL : 0 );
+	uint8_t n = 0;
+
+	while( zigzag >= 0x80 )
+	{
+		out[n++] = ( uint8_t )( zigzag | 0x80 );
+		zigzag >>= 7;
+	}
+	out[n++] = ( uint8_t )zigzag;
+
+	return n;
+}
+
+static uint8_t HKS_getVarint( const uint8_t *in, const uint8_t *end, int32_t *value )
+{
+	uint32_t zigzag = 0;
+	uint8_t n = 0;
+
+	do
+	{
+		if( in + n >= end || n == 5 )
+		{
+			return 0;
+		}
+		zigzag |= ( uint32_t )( in[n] & 0x7F ) << ( 7 * n );
+	} while( in[n++] & 0x80 );
+
+	*value = ( int32_t )( zigzag >> 1 ) ^ -( int32_t )( zigzag & 1 );
+
+	return n;
+}
+
+static uint8_t HKS_code( uint8_t *out, const FSW_HKS_Rollup_TypeDef *rollups, const int16_t *prevMean )
+{
+	uint8_t c, len = 0;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		len += HKS_putVarint( &out[len], ( int32_t )rollups[c].mean - prevMean[c] );
+		len += HKS_putVarint( &out[len], ( int32_t )rollups[c].mean - rollups[c].min );
+		len += HKS_putVarint( &out[len], ( int32_t )rollups[c].max - rollups[c].mean );
+	}
+
+	return len;
+}
+
+/*
+ * Codes a minute into the block, spilling the block first if the minute does
+ * not fit or does not follow the last.
+ */
+static void HKS_codeMinute( uint32_t minute, const FSW_HKS_Rollup_TypeDef *rollups )
+{
+	uint8_t coded[HKS_MINUTEMAX];
+	uint8_t len, c;
+
+	if( HKS_blockCount != 0 && HKS_blockFirst / 60 + HKS_blockCount != minute )
+	{
+		FSW_HKS_spill();
+	}
+
+	len = HKS_code( coded, rollups, HKS_blockMean );
+	if( HKS_HEADERLEN + HKS_blockLen + len > FSW_HKS_BLOCK )
+	{
+		FSW_HKS_spill();
+		len = HKS_code( coded, rollups, HKS_blockMean );
+	}
+
+	if( HKS_blockCount == 0 )
+	{
+		HKS_blockFirst = minute * 60;
+	}
+	memcpy( &HKS_block[HKS_HEADERLEN + HKS_blockLen], coded, len );
+	HKS_blockLen += len;
+	HKS_blockCount++;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		HKS_blockMean[c] = rollups[c].mean;
+	}
+}
+
+/*
+ * Rolls up a completed minute, and the ten minutes it completes.
+ */
+static void HKS_closeMinute( uint32_t minute )
+{
+	FSW_HKS_Rollup_TypeDef rollups[FSW_HKS_CHANNELS];
+	uint8_t c;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		HKS_sumTake( &HKS_minute[c], &rollups[c] );
+		HKS_sumAdd( &HKS_tenMinute[c], rollups[c].min, rollups[c].max, rollups[c].mean );
+	}
+	HKS_push( &HKS_tier[FSW_HKS_TIER_MINUTE], minute, rollups );
+	HKS_codeMinute( minute, rollups );
+
+	if( ( minute + 1 ) % 10 == 0 )
+	{
+		for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+		{
+			HKS_sumTake( &HKS_tenMinute[c], &rollups[c] );
+		}
+		HKS_push( &HKS_tier[FSW_HKS_TIER_TENMINUTE], minute / 10, rollups );
+	}
+}
+
+/*
+ * Keeps the sample of a second, NULL for none.
+ */
+static void HKS_addSecond( uint32_t time, const int16_t *values )
+{
+	HKS_Tier_TypeDef *tier = &HKS_tier[FSW_HKS_TIER_SECOND];
+	int16_t *record = ( int16_t * )tier->ring + ( time % tier->slots ) * FSW_HKS_CHANNELS;
+	int16_t value;
+	uint8_t c;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		value = values ? values[c] : FSW_HKS_NODATA;
+		record[c] = value;
+		HKS_sumAdd( &HKS_minute[c], value, value, value );
+	}
+	HKS_BARRIER();
+	tier->next = time + 1;
+
+	if( ( time + 1 ) % 60 == 0 )
+	{
+		HKS_closeMinute( time / 60 );
+	}
+}
+
+/*
+ * Empties the rings, starting them at a time.
+ */
+static void HKS_restart( uint32_t time )
+{
+	uint8_t t, c;
+
+	FSW_HKS_spill();
+
+	HKS_generation++;
+	HKS_BARRIER();
+	for( t = 0; t < FSW_HKS_TIERS; t++ )
+	{
+		HKS_tier[t].first = time / HKS_tier[t].period;
+		HKS_tier[t].next = HKS_tier[t].first;
+	}
+	HKS_BARRIER();
+	HKS_generation++;
+
+	for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+	{
+		HKS_minute[c].n = 0;
+		HKS_minute[c].sum = 0;
+		HKS_tenMinute[c].n = 0;
+		HKS_tenMinute[c].sum = 0;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets up empty rings and clears the counters.
+ *
+ * @param[in] mem
+ * 		FSW_HKS_MEMSIZE bytes, 2 byte aligned, for the rings.
+ * @param[in] spill
+ * 		Keeps the full blocks of minute rollups, or NULL to drop them.
+ ******************************************************************************/
+void FSW_HKS_Init( uint8_t *mem, FSW_HKS_SpillFunc spill )
+{
+	static const uint16_t len[FSW_HKS_TIERS] = { FSW_HKS_SECONDS, FSW_HKS_MINUTES, FSW_HKS_TENMINUTES };
+	static const uint16_t period[FSW_HKS_TIERS] = { 1, 60, 600 };
+	uint8_t t;
+
+	for( t = 0; t < FSW_HKS_TIERS; t++ )
+	{
+		HKS_tier[t].ring = mem;
+		HKS_tier[t].len = len[t];
+		HKS_tier[t].slots = len[t] + 1;
+		HKS_tier[t].period = period[t];
+		HKS_tier[t].next = 0;
+		HKS_tier[t].first = 0;
+		mem += HKS_tier[t].slots * FSW_HKS_CHANNELS * ( t == FSW_HKS_TIER_SECOND ? sizeof( int16_t ) : sizeof( FSW_HKS_Rollup_TypeDef ) );
+	}
+
+	HKS_spillFunc = spill;
+	HKS_blockLen = 0;
+	HKS_blockCount = 0;
+	HKS_started = 0;
+	memset( &HKS_stats, 0, sizeof( HKS_stats ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function adds a sample of every channel for a second. Seconds skipped
+ * since the last sample are kept as FSW_HKS_NODATA. If the time stepped back,
+ * or forward by more than the sample ring holds, the rings are emptied and
+ * start again at this sample. Only one task may add samples.
+ *
+ * @param[in] time
+ * 		OBC time of the sample.
+ * @param[in] values
+ * 		FSW_HKS_CHANNELS values.
+ ******************************************************************************/
+void FSW_HKS_add( uint32_t time, const int16_t *values )
+{
+	uint32_t next = HKS_tier[FSW_HKS_TIER_SECOND].next;
+
+	if( !HKS_started || time < next || time - next >= FSW_HKS_SECONDS )
+	{
+		if( HKS_started )
+		{
+			HKS_stats.restarts++;
+		}
+		HKS_restart( time );
+		HKS_started = 1;
+		next = time;
+	}
+
+	for( ; next < time; next++ )
+	{
+		HKS_addSecond( next, NULL );
+		HKS_stats.gaps++;
+	}
+
+	HKS_addSecond( time, values );
+	HKS_stats.samples++;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies out the records of a channel from a time on, starting
+ * with the oldest still kept if that time has been overwritten. Samples are
+ * returned as rollups with all three values equal.
+ *
+ * @param[in] tier
+ * 		One of the FSW_HKS_TIER_ macros.
+ * @param[in] channel
+ * 		Channel, below FSW_HKS_CHANNELS.
+ * @param[in] from
+ * 		OBC time of the first record wanted.
+ * @param[out] out
+ * 		The records, one per period of the tier.
+ * @param[in] max
+ * 		Most records to copy.
+ * @param[out] first
+ * 		Time of the first record copied.
+ * @return
+ * 		Records copied, 0 if there are none from that time or the arguments
+ * 		are invalid.
+ ******************************************************************************/
+uint16_t FSW_HKS_query( uint8_t tier, uint8_t channel, uint32_t from, FSW_HKS_Rollup_TypeDef *out, uint16_t max, uint32_t *first )
+{
+	const HKS_Tier_TypeDef *t;
+	const int16_t *sample;
+	const FSW_HKS_Rollup_TypeDef *rollup;
+	uint32_t generation, next, oldest, index, after;
+	uint16_t i, n;
+
+	if( tier >= FSW_HKS_TIERS || channel >= FSW_HKS_CHANNELS )
+	{
+		return 0;
+	}
+
+	t = &HKS_tier[tier];
+	do
+	{
+		generation = HKS_generation;
+		HKS_BARRIER();
+		next = t->next;
+		oldest = t->first;
+		if( next - oldest > t->len )
+		{
+			oldest = next - t->len;
+		}
+
+		index = from / t->period;
+		if( index < oldest )
+		{
+			index = oldest;
+		}
+		n = ( index < next ) ? ( ( next - index < max ) ? next - index : max ) : 0;
+
+		for( i = 0; i < n; i++ )
+		{
+			if( tier == FSW_HKS_TIER_SECOND )
+			{
+				sample = ( const int16_t * )t->ring + ( ( index + i ) % t->slots ) * FSW_HKS_CHANNELS + channel;
+				out[i].min = out[i].max = out[i].mean = *sample;
+			}
+			else
+			{
+				rollup = ( const FSW_HKS_Rollup_TypeDef * )t->ring + ( ( index + i ) % t->slots ) * FSW_HKS_CHANNELS + channel;
+				out[i] = *rollup;
+			}
+		}
+
+		// Record index's slot is rewritten once the writer is on index + slots
+		HKS_BARRIER();
+		after = t->next;
+	} while( ( generation & 1 ) || generation != HKS_generation || ( n != 0 && index + t->slots <= after ) );
+
+	*first = index * t->period;
+
+	return n;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function hands the minutes coded so far to the spill function as a
+ * block, for instance before the card is unmounted. It is called whenever a
+ * block fills and when the rings are emptied.
+ ******************************************************************************/
+void FSW_HKS_spill( void )
+{
+	FSW_HKS_BlockHeader_TypeDef header;
+	uint16_t crc;
+
+	if( HKS_blockCount == 0 )
+	{
+		return;
+	}
+
+	header.magic = FSW_HKS_MAGIC;
+	header.version = FSW_HKS_VERSION;
+	header.channels = FSW_HKS_CHANNELS;
+	header.first = HKS_blockFirst;
+	header.count = HKS_blockCount;
+	header.len = HKS_blockLen;
+	header.reserved = 0;
+	crc = FSW_CRC16_update( FSW_CRC16_INIT, &header, offsetof( FSW_HKS_BlockHeader_TypeDef, crc ) );
+	header.crc = FSW_CRC16_update( crc, &HKS_block[HKS_HEADERLEN], HKS_blockLen );
+
+	memcpy( HKS_block, &header, HKS_HEADERLEN );
+	memset( &HKS_block[HKS_HEADERLEN + HKS_blockLen], 0xFF, FSW_HKS_BLOCK - HKS_HEADERLEN - HKS_blockLen );
+
+	if( HKS_spillFunc )
+	{
+		HKS_spillFunc( HKS_block );
+	}
+
+	HKS_stats.spills++;
+	HKS_stats.spilledMinutes += HKS_blockCount;
+	HKS_stats.spilledBytes += HKS_HEADERLEN + HKS_blockLen;
+
+	HKS_blockCount = 0;
+	HKS_blockLen = 0;
+	memset( HKS_blockMean, 0, sizeof( HKS_blockMean ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the store counters.
+ *
+ * @param[out] stats
+ * 		The counters.
+ ******************************************************************************/
+void FSW_HKS_getStats( FSW_HKS_Stats_TypeDef *stats )
+{
+	*stats = HKS_stats;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function checks and decodes a spilled block.
+ *
+ * @param[in] block
+ * 		FSW_HKS_BLOCK bytes.
+ * @param[out] first
+ * 		Time of the first minute.
+ * @param[out] out
+ * 		The minute rollups, FSW_HKS_CHANNELS per minute.
+ * @param[in] max
+ * 		Rollups out holds.
+ * @return
+ * 		Minutes decoded, 0 if the block is damaged, of another format or does
+ * 		not fit in out.
+ ******************************************************************************/
+uint16_t FSW_HKS_decodeBlock( const uint8_t *block, uint32_t *first, FSW_HKS_Rollup_TypeDef *out, uint16_t max )
+{
+	FSW_HKS_BlockHeader_TypeDef header;
+	const uint8_t *in, *end;
+	int16_t mean[FSW_HKS_CHANNELS] = { 0 };
+	int32_t delta, below, above;
+	uint16_t crc, i;
+	uint8_t c, n;
+
+	memcpy( &header, block, HKS_HEADERLEN );
+	if( header.magic != FSW_HKS_MAGIC || header.version != FSW_HKS_VERSION || header.channels != FSW_HKS_CHANNELS ||
+		header.len > FSW_HKS_BLOCK - HKS_HEADERLEN || ( uint32_t )header.count * FSW_HKS_CHANNELS > max )
+	{
+		return 0;
+	}
+
+	crc = FSW_CRC16_update( FSW_CRC16_INIT, block, offsetof( FSW_HKS_BlockHeader_TypeDef, crc ) );
+	if( FSW_CRC16_update( crc, &block[HKS_HEADERLEN], header.len ) != header.crc )
+	{
+		return 0;
+	}
+
+	in = &block[HKS_HEADERLEN];
+	end = in + header.len;
+	for( i = 0; i < header.count; i++ )
+	{
+		for( c = 0; c < FSW_HKS_CHANNELS; c++ )
+		{
+			if( ( n = HKS_getVarint( in, end, &delta ) ) == 0 )
+			{
+				return 0;
+			}
+			in += n;
+			if( ( n = HKS_getVarint( in, end, &below ) ) == 0 )
+			{
+				return 0;
+			}
+			in += n;
+			if( ( n = HKS_getVarint( in, end, &above ) ) == 0 )
+			{
+				return 0;
+			}
+			in += n;
+
+			mean[c] = ( int16_t )( mean[c] + delta );
+			out->mean = mean[c];
+			out->min = ( int16_t )( mean[c] - below );
+			out->max = ( int16_t )( mean[c] + above );
+			out++;
+		}
+	}
+
+	*first = header.first;
+
+	return ( in == end ) ? header.count : 0;
+}
@@ -0,0 +1,451 @@
+/***************************************************************************//**
+ * @file	fsw_i2cbus.c
+ * @brief	FSW I2C bus scheduler.
+ *
+ * The scheduler takes the messages queued for the I2C channels into a small
+ * pending table and serves them highest priority first. A read or write-read
+ * message is run together with the other reads of the same slave and priority
+ * waiting on the same channel, e.g. the CubeSense sun, nadir and power
+ * telemetry, as one session of BSP_I2C_masterStart: the interrupt starts each
+ * transfer as soon as the previous one ends, and the task is woken once for
+ * the lot.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "fsw_i2cbus.h"
+#include "task.h"
+#include "semphr.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+/// A message waiting for the bus.
+typedef struct{
+	COMM_I2Cmsg_TypeDef msg;
+	uint32_t order;						///< Arrival number, for first come first served within a priority
+	uint8_t used;
+}I2CBUS_Pending_TypeDef;
+
+static I2CBUS_Pending_TypeDef I2CBUS_pending[FSW_I2CBUS_PENDING];
+static uint8_t I2CBUS_pendingCount = 0;
+static uint32_t I2CBUS_arrivals = 0;
+static uint8_t I2CBUS_batch = 1;							///< Most transfers per session
+static xSemaphoreHandle I2CBUS_done = NULL;					///< Given by the I2C interrupt at the end of a session
+static FSW_I2CBUS_Stats_TypeDef I2CBUS_stats;
+static portTickType I2CBUS_statsSince = 0;
+
+static I2C_TypeDef* const I2CBUS_channels[FSW_I2C_BUSES] = { BSP_I2C_SYS, BSP_I2C_SUB };
+
+static uint8_t FSW_I2CBUS_take( xQueueHandle queue, portTickType wait );
+static int8_t FSW_I2CBUS_next( const int8_t *exclude, uint8_t excluded, const COMM_I2Cmsg_TypeDef *match );
+static void FSW_I2CBUS_run( const int8_t *batch, uint8_t count );
+static void FSW_I2CBUS_complete( uint8_t slot, BSP_I2C_Status_TypeDef status );
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets up the scheduler with an empty pending table and clears
+ * its counters. It is called by the task that runs the scheduler, before
+ * FSW_I2CBUS_service.
+ *
+ * @param[in] batch
+ *   Most transfers run in one bus session, at most FSW_I2CBUS_BATCH. 1 runs
+ *   every message in a session of its own.
+ ******************************************************************************/
+void FSW_I2CBUS_Init( uint8_t batch )
+{
+	if( I2CBUS_done == NULL )
+	{
+		vSemaphoreCreateBinary( I2CBUS_done );
+		xSemaphoreTake( I2CBUS_done, 0 );
+	}
+
+	memset( I2CBUS_pending, 0, sizeof( I2CBUS_pending ) );
+	I2CBUS_pendingCount = 0;
+
+	if( batch == 0 )
+	{
+		batch = 1;
+	}
+	I2CBUS_batch = ( batch > FSW_I2CBUS_BATCH ) ? FSW_I2CBUS_BATCH : batch;
+
+	FSW_I2CBUS_resetStats();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function fills in a message for the main channel at normal priority,
+ * without a callback or reply queue. The sender changes these fields before
+ * queueing the message where needed.
+ *
+ * @param[out] msg
+ *   Message to fill in.
+ * @param[in] flag
+ *   Transfer type. A read only uses the receive buffer.
+ * @param[in] txBuffer
+ *   Data to write, e.g. a telemetry request.
+ * @param[in] txLen
+ *   Bytes to write.
+ * @param[in] rxBuffer
+ *   Buffer for the data read.
+ * @param[in] rxLen
+ *   Bytes to read.
+ * @param[in] source
+ *   Module sending the message.
+ * @param[in] dest
+ *   I2C write address of the slave.
+ ******************************************************************************/
+void FSW_I2CBUS_construct( COMM_I2Cmsg_TypeDef *msg, BSP_I2C_ModeSelect_TydeDef flag, uint8_t *txBuffer, uint32_t txLen,
+						   uint8_t *rxBuffer, uint16_t rxLen, uint8_t source, uint8_t dest )
+{
+	memset( msg, 0, sizeof( COMM_I2Cmsg_TypeDef ) );
+
+	msg->buffer   = txBuffer;
+	msg->msgLen   = txLen;
+	msg->rxBuffer = rxBuffer;
+	msg->rxLen    = rxLen;
+	msg->flag     = ( uint8_t )flag;
+	msg->source   = source;
+	msg->dest     = dest;
+	msg->bus      = FSW_I2C_BUS_SYS;
+	msg->priority = FSW_I2C_PRIO_NORMAL;
+	msg->status   = bspI2cInProgress;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function stamps a message with the current tick, from which its
+ * latency is counted, and queues it for the scheduler.
+ *
+ * @param[in] queue
+ *   Queue read by the scheduler, FSW_COMM_I2Cqueue.
+ * @param[in] msg
+ *   Message to queue. It is copied.
+ * @param[in] wait
+ *   Ticks to wait for room in the queue.
+ * @return
+ *   pdTRUE if the message was queued.
+ ******************************************************************************/
+portBASE_TYPE FSW_I2CBUS_submit( xQueueHandle queue, COMM_I2Cmsg_TypeDef *msg, portTickType wait )
+{
+	msg->queued = xTaskGetTickCount();
+	msg->status = bspI2cInProgress;
+
+	return xQueueSendToBack( queue, msg, wait );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function moves the queued messages into the pending table, waiting for
+ * one if none are pending, and runs one bus session: the highest priority
+ * message and, if it is a read, the other reads of the same slave pending on
+ * the same channel at the same priority, so a session never carries lower
+ * priority work. Each message of the session is completed, except those
+ * after a failed transfer, which stay pending. Called in a loop by the task
+ * that owns the channels.
+ *
+ * @param[in] queue
+ *   Queue to take messages from.
+ * @param[in] wait
+ *   Ticks to wait for a message when none are pending.
+ ******************************************************************************/
+void FSW_I2CBUS_service( xQueueHandle queue, portTickType wait )
+{
+	int8_t batch[FSW_I2CBUS_BATCH];
+	uint8_t count;
+	int8_t slot;
+	uint8_t flag;
+
+	if( FSW_I2CBUS_take( queue, wait ) == 0 )
+	{
+		return;
+	}
+
+	batch[0] = FSW_I2CBUS_next( NULL, 0, NULL );
+	count = 1;
+
+	// Telemetry reads of the same slave share the session
+	flag = I2CBUS_pending[batch[0]].msg.flag;
+	if( flag == bspI2cRead || flag == bspI2cWriteRead )
+	{
+		while( count < I2CBUS_batch )
+		{
+			slot = FSW_I2CBUS_next( batch, count, &I2CBUS_pending[batch[0]].msg );
+			if( slot < 0 )
+			{
+				break;
+			}
+			batch[count++] = slot;
+		}
+	}
+
+	FSW_I2CBUS_run( batch, count );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the scheduler counters, with the bus utilisation over
+ * the time since they were reset.
+ *
+ * @param[out] stats
+ *   Copy of the counters.
+ ******************************************************************************/
+void FSW_I2CBUS_getStats( FSW_I2CBUS_Stats_TypeDef *stats )
+{
+	uint32_t windowMs;
+	uint8_t i;
+
+	taskENTER_CRITICAL();
+	*stats = I2CBUS_stats;
+	stats->windowTicks = xTaskGetTickCount() - I2CBUS_statsSince;
+	taskEXIT_CRITICAL();
+
+	windowMs = stats->windowTicks * portTICK_RATE_MS;
+	for( i = 0; i < FSW_I2C_BUSES; i++ )
+	{
+		stats->utilisation[i] = ( windowMs != 0 ) ? ( uint16_t )( stats->busUs[i] / windowMs ) : 0;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function clears the scheduler counters and starts a new utilisation
+ * window.
+ ******************************************************************************/
+void FSW_I2CBUS_resetStats( void )
+{
+	taskENTER_CRITICAL();
+	memset( &I2CBUS_stats, 0, sizeof( I2CBUS_stats ) );
+	I2CBUS_statsSince = xTaskGetTickCount();
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Moves queued messages into free pending slots. Blocks for the first one if
+ * none are pending. Returns the number of messages pending.
+ */
+static uint8_t FSW_I2CBUS_take( xQueueHandle queue, portTickType wait )
+{
+	uint8_t i;
+
+	for( i = 0; i < FSW_I2CBUS_PENDING && I2CBUS_pendingCount < FSW_I2CBUS_PENDING; i++ )
+	{
+		if( I2CBUS_pending[i].used )
+		{
+			continue;
+		}
+		if( xQueueReceive( queue, &I2CBUS_pending[i].msg, ( I2CBUS_pendingCount == 0 ) ? wait : 0 ) != pdTRUE )
+		{
+			break;
+		}
+		I2CBUS_pending[i].order = I2CBUS_arrivals++;
+		I2CBUS_pending[i].used = 1;
+		I2CBUS_pendingCount++;
+	}
+
+	return I2CBUS_pendingCount;
+}
+
+/*
+ * Returns the pending slot to serve next: highest priority, then earliest
+ * arrival. Slots in exclude are skipped, and if match is given only reads of
+ * the same slave on the same channel at the same priority qualify. -1 if there
+ * is none.
+ */
+static int8_t FSW_I2CBUS_next( const int8_t *exclude, uint8_t excluded, const COMM_I2Cmsg_TypeDef *match )
+{
+	const I2CBUS_Pending_TypeDef *p;
+	int8_t best = -1;
+	uint8_t i, j;
+
+	for( i = 0; i < FSW_I2CBUS_PENDING; i++ )
+	{
+		p = &I2CBUS_pending[i];
+		if( !p->used )
+		{
+			continue;
+		}
+		for( j = 0; j < excluded && exclude[j] != ( int8_t )i; j++ );
+		if( j < excluded )
+		{
+			continue;
+		}
+		if( match != NULL && ( p->msg.bus != match->bus || p->msg.dest != match->dest || p->msg.priority != match->priority ||
+							   ( p->msg.flag != bspI2cRead && p->msg.flag != bspI2cWriteRead ) ) )
+		{
+			continue;
+		}
+		if( best < 0 || p->msg.priority < I2CBUS_pending[best].msg.priority ||
+			( p->msg.priority == I2CBUS_pending[best].msg.priority && ( int32_t )( p->order - I2CBUS_pending[best].order ) < 0 ) )
+		{
+			best = ( int8_t )i;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * Runs the messages in batch as one session and completes them.
+ */
+static void FSW_I2CBUS_run( const int8_t *batch, uint8_t count )
+{
+	I2C_TransferSeq_TypeDef seq[FSW_I2CBUS_BATCH];
+	const COMM_I2Cmsg_TypeDef *msg;
+	BSP_I2C_Status_TypeDef status;
+	I2C_TypeDef *i2c;
+	uint8_t bus, completed, i;
+
+	bus = I2CBUS_pending[batch[0]].msg.bus;
+	if( bus >= FSW_I2C_BUSES )
+	{
+		FSW_I2CBUS_complete( batch[0], bspI2cUsageFault );
+		return;
+	}
+	i2c = I2CBUS_channels[bus];
+
+	for( i = 0; i < count; i++ )
+	{
+		msg = &I2CBUS_pending[batch[i]].msg;
+
+		seq[i].addr  = msg->dest;
+		seq[i].flags = msg->flag;
+		if( msg->flag == bspI2cRead )
+		{
+			seq[i].buf[0].data = msg->rxBuffer;
+			seq[i].buf[0].len  = msg->rxLen;
+		}
+		else
+		{
+			seq[i].buf[0].data = msg->buffer;
+			seq[i].buf[0].len  = ( uint16_t )msg->msgLen;
+			seq[i].buf[1].data = msg->rxBuffer;
+			seq[i].buf[1].len  = msg->rxLen;
+		}
+	}
+
+	status = BSP_I2C_masterStart( i2c, seq, count, I2CBUS_done );
+	if( status == bspI2cBusy )
+	{
+		// A BSP_I2C_masterTX caller has the channel; the messages stay pending
+		I2CBUS_stats.busyRetries++;
+		vTaskDelay( FSW_I2CBUS_RETRY_MS / portTICK_RATE_MS );
+		return;
+	}
+
+	if( status == bspI2cInProgress )
+	{
+		if( xSemaphoreTake( I2CBUS_done, ( count * BSP_I2C_TIMEOUT_MS ) / portTICK_RATE_MS ) != pdTRUE )
+		{
+			BSP_I2C_masterAbort( i2c );
+			xSemaphoreTake( I2CBUS_done, 0 );	// in case it completed while aborting
+		}
+		status = BSP_I2C_masterStatus( i2c );
+	}
+	completed = BSP_I2C_masterCompleted( i2c );
+
+	I2CBUS_stats.sessions++;
+	I2CBUS_stats.transfers += ( completed < count ) ? completed + 1 : count;
+	I2CBUS_stats.coalesced += ( completed < count ) ? completed : count - 1;
+
+	for( i = 0; i < completed && i < count; i++ )
+	{
+		msg = &I2CBUS_pending[batch[i]].msg;
+
+		// START, address and data bytes each with their acknowledge, repeated START and STOP
+		I2CBUS_stats.busUs[bus] += ( ( 2 + 9 * ( 1 + ( ( msg->flag == bspI2cRead ) ? msg->rxLen : msg->msgLen ) ) +
+									 ( ( msg->flag == bspI2cWriteRead ) ? 1 + 9 * ( 1 + msg->rxLen ) : 0 ) ) *
+									 1000000UL ) / FSW_I2CBUS_BITRATE;
+
+		FSW_I2CBUS_complete( batch[i], bspI2cOk );
+	}
+	if( completed < count )
+	{
+		FSW_I2CBUS_complete( batch[completed], status );
+	}
+}
+
+/*
+ * Frees a pending slot, counts the message's latency and reports its result.
+ */
+static void FSW_I2CBUS_complete( uint8_t slot, BSP_I2C_Status_TypeDef status )
+{
+	COMM_I2Cmsg_TypeDef msg = I2CBUS_pending[slot].msg;
+	FSW_I2CBUS_Latency_TypeDef *latency;
+	portTickType ticks;
+
+	I2CBUS_pending[slot].used = 0;
+	I2CBUS_pendingCount--;
+
+	msg.status = ( int8_t )status;
+	ticks = xTaskGetTickCount() - msg.queued;
+
+	latency = &I2CBUS_stats.latency[( msg.priority < FSW_I2C_PRIOS ) ? msg.priority : FSW_I2C_PRIO_LOW];
+	latency->messages++;
+	latency->totalTicks += ticks;
+	if( ticks > latency->maxTicks )
+	{
+		latency->maxTicks = ( ticks > 0xFFFF ) ? 0xFFFF : ( uint16_t )ticks;
+	}
+	if( status != bspI2cOk )
+	{
+		latency->failed++;
+	}
+
+	if( msg.done != NULL )
+	{
+		msg.done( &msg );
+	}
+	if( msg.reply != NULL && xQueueSendToBack( msg.reply, &msg, 0 ) != pdTRUE )
+	{
+		I2CBUS_stats.replyLost++;
+	}
+}
+
+/** @} (end addtogroup C&DH) */
+/** @} (end addtogroup FSW_Library) */
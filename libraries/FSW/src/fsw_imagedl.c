@@ -0,0 +1,710 @@
+/***************************************************************************//**
+ * @file	fsw_imagedl.c
+ * @brief	FSW CubeSense image download source file.
+ *
+ * This file contains the image download task. A frame is read as the
+ * ImageFrameData and ImageFrame telemetry of CubeSense, queued together at low
+ * priority so the bus scheduler runs them in one session, after an
+ * AdvanceImageDownload telecommand that loads the frame. Verified frames are
+ * collected in one of two sector sized buffers; when a buffer is full the
+ * next frame is queued first and the buffer is written to the image file
+ * while that frame is on the bus.
+ *
+ * The image file is allocated to the full image size before the first frame,
+ * and a progress record is rewritten after every FSW_IMG_SYNC_BLOCKS buffers,
+ * after the image file itself is synced, so the record never counts frames
+ * that are not on the card.
+ * @author	Andre Heunis
+ * @date	2026/10/16
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fsw_imagedl.h"
+#include "fsw_cdh.h"
+#include "fsw_comm.h"
+#include "fsw_crc.h"
+#include "fsw_memmap.h"
+#include "task.h"
+#include "ff.h"
+#include "CubeSense.1.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Payload
+ * @brief API for the Payload interface module.
+ * @{
+ ******************************************************************************/
+
+#define IMG_REQUEST_QLEN	2
+#define IMG_REPLY_QLEN		3			///< The messages of one frame.
+#define IMG_TIMEOUT_MS		1000		///< Longest wait to queue a message, or for it to complete.
+#define IMG_RECORD_MAGIC	0x31474D49	///< "IMG1"
+#define IMG_CHECK_ERROR		-16			///< lastError of a frame whose number or checksum stayed wrong.
+
+/// Request to the download task.
+typedef struct{
+	uint8_t resume;
+	uint8_t image;
+	uint8_t size;
+}IMG_Request_TypeDef;
+
+/// Progress record, rewritten in place in FSW_IMG_RECORDPATH.
+typedef struct{
+	uint32_t magic;
+	uint32_t nextFrame;					///< Frames in the image file, synced before the record was written.
+	uint32_t totalTicks;				///< Duration of the runs up to the record.
+	uint16_t frames;
+	uint8_t image;
+	uint8_t size;
+	uint16_t crc;						///< CRC-16 of the fields above.
+}IMG_Record_TypeDef;
+
+/// Messages of a frame, told apart by their context.
+enum{
+	IMG_MSG_TCMD = 1,
+	IMG_MSG_FRAMEDATA,
+	IMG_MSG_FRAME
+};
+
+static xQueueHandle IMG_i2cQueue = NULL;				///< Served by the bus scheduler
+static xQueueHandle IMG_requests = NULL;
+static xQueueHandle IMG_replies = NULL;				///< Completed I2C messages
+static volatile uint8_t IMG_abortFlag = 0;
+static uint8_t IMG_pending = 0;						///< Messages queued whose reply has not been taken
+static FSW_IMG_Stats_TypeDef IMG_stats;
+static IMG_Record_TypeDef IMG_record;
+static portTickType IMG_runStart;
+static uint32_t IMG_priorTicks;						///< totalTicks of the record the run started from
+
+static FIL IMG_file;
+static FIL IMG_recordFile;
+static uint8_t IMG_blocks[2][FSW_IMG_BLOCKLEN];		///< One collects frames while the other is written
+static uint8_t IMG_frameData[3];
+static uint8_t IMG_tcmd[3];
+static uint8_t IMG_tlmFrame = CubeSenseTlmIdImageFrame;
+static uint8_t IMG_tlmFrameData = CubeSenseTlmIdImageFrameData;
+
+static uint32_t FSW_IMG_bytes( uint8_t size );
+static uint8_t FSW_IMG_request( uint8_t resume, uint8_t image, uint8_t size );
+static uint8_t FSW_IMG_submit( BSP_I2C_ModeSelect_TydeDef flag, uint8_t *tx, uint8_t txLen, uint8_t *rx, uint16_t rxLen, uint32_t kind );
+static uint8_t FSW_IMG_readFrame( uint16_t frame, uint8_t *rx, uint8_t advance );
+static int8_t FSW_IMG_wait( uint8_t queued, uint8_t expected );
+static uint8_t FSW_IMG_drain( void );
+static uint8_t FSW_IMG_check( uint16_t frame, const uint8_t *rx );
+static FRESULT FSW_IMG_open( const IMG_Request_TypeDef *req );
+static FRESULT FSW_IMG_write( const uint8_t *block, UINT len );
+static FRESULT FSW_IMG_saveProgress( uint32_t stored );
+static void FSW_IMG_download( const IMG_Request_TypeDef *req );
+
+static void FSW_IMG_task( void *pvParameters );		///< Runs the downloads requested.
+static portSTACK_TYPE IMG_taskStack[ FSW_STACK_IMG ];
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function creates the image download task and its queues.
+ *
+ * @param[in] i2cQueue
+ *   Queue of the I2C bus scheduler, FSW_COMM_I2Cqueue.
+ ******************************************************************************/
+void FSW_IMG_Init( xQueueHandle i2cQueue )
+{
+	IMG_i2cQueue = i2cQueue;
+	memset( &IMG_stats, 0, sizeof( IMG_stats ) );
+
+	IMG_requests = xQueueCreate( IMG_REQUEST_QLEN, sizeof( IMG_Request_TypeDef ) );
+	IMG_replies = xQueueCreate( IMG_REPLY_QLEN, sizeof( COMM_I2Cmsg_TypeDef ) );
+
+	if( IMG_requests != NULL && IMG_replies != NULL )
+	{
+		FSW_TASK_CREATE( FSW_IMG_task, "IMGdownload", IMG_taskStack, NULL, 1 );
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function requests a new download, which replaces the image file and
+ * progress record on the card.
+ *
+ * @param[in] image
+ *   FSW_IMG_NADIR or FSW_IMG_SUN.
+ * @param[in] size
+ *   Image size code, 0 for the full 640 x 480 image up to FSW_IMG_MAXSIZE.
+ * @return
+ *   1 if the download was requested, 0 if the arguments are out of range or
+ *   a download is running.
+ ******************************************************************************/
+uint8_t FSW_IMG_start( uint8_t image, uint8_t size )
+{
+	if( image > FSW_IMG_SUN || size > FSW_IMG_MAXSIZE )
+	{
+		return 0;
+	}
+
+	return FSW_IMG_request( 0, image, size );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function requests that the download recorded on the card continues
+ * from the last frame recorded, e.g. after an abort, a failed frame or a
+ * reset. CubeSense must still hold the image.
+ *
+ * @return
+ *   1 if the download was requested, 0 if a download is running.
+ ******************************************************************************/
+uint8_t FSW_IMG_resume( void )
+{
+	return FSW_IMG_request( 1, 0, 0 );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function stops the download in progress after the frame on the bus.
+ * The frames collected in whole buffers are stored and recorded first.
+ ******************************************************************************/
+void FSW_IMG_abort( void )
+{
+	IMG_abortFlag = 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the download progress and counters.
+ *
+ * @param[out] stats
+ *   Copy of the progress and counters.
+ ******************************************************************************/
+void FSW_IMG_getStats( FSW_IMG_Stats_TypeDef *stats )
+{
+	taskENTER_CRITICAL();
+	*stats = IMG_stats;
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Bytes in an image of the given size code.
+ */
+static uint32_t FSW_IMG_bytes( uint8_t size )
+{
+	return ( uint32_t )( 640 >> size ) * ( 480 >> size );
+}
+
+/*
+ * Queues a request for the download task, unless a download is running.
+ */
+static uint8_t FSW_IMG_request( uint8_t resume, uint8_t image, uint8_t size )
+{
+	IMG_Request_TypeDef req = { resume, image, size };
+
+	if( IMG_requests == NULL || IMG_stats.state == FSW_IMG_RUNNING )
+	{
+		return 0;
+	}
+
+	return ( xQueueSendToBack( IMG_requests, &req, 0 ) == pdTRUE ) ? 1 : 0;
+}
+
+/*
+ * Queues a low priority message to CubeSense, replying to the download task.
+ */
+static uint8_t FSW_IMG_submit( BSP_I2C_ModeSelect_TydeDef flag, uint8_t *tx, uint8_t txLen, uint8_t *rx, uint16_t rxLen, uint32_t kind )
+{
+	COMM_I2Cmsg_TypeDef msg;
+
+	FSW_I2CBUS_construct( &msg, flag, tx, txLen, rx, rxLen, FSW_PAYLOAD, I2CADDR_CUBESENSE_W );
+	msg.priority = FSW_I2C_PRIO_LOW;
+	msg.reply = IMG_replies;
+	msg.context = ( void* )kind;
+
+	if( FSW_I2CBUS_submit( IMG_i2cQueue, &msg, IMG_TIMEOUT_MS / portTICK_RATE_MS ) != pdTRUE )
+	{
+		return 0;
+	}
+	IMG_pending++;
+	return 1;
+}
+
+/*
+ * Queues the messages that read a frame: the telecommand loading it, if
+ * asked, and the two telemetry reads, which the scheduler runs back to back.
+ * Returns the messages queued, fewer than asked for if the queue stayed full.
+ */
+static uint8_t FSW_IMG_readFrame( uint16_t frame, uint8_t *rx, uint8_t advance )
+{
+	uint8_t len;
+
+	if( advance )
+	{
+		len = ( uint8_t )CUBESENSE_createTcmdAdvanceImageDownload( IMG_tcmd, frame );
+		if( !FSW_IMG_submit( bspI2cWrite, IMG_tcmd, len, NULL, 0, IMG_MSG_TCMD ) )
+		{
+			return 0;
+		}
+	}
+
+	if( !FSW_IMG_submit( bspI2cWriteRead, &IMG_tlmFrameData, 1, IMG_frameData, sizeof( IMG_frameData ), IMG_MSG_FRAMEDATA ) )
+	{
+		return advance;
+	}
+	if( !FSW_IMG_submit( bspI2cWriteRead, &IMG_tlmFrame, 1, rx, FSW_IMG_FRAMELEN, IMG_MSG_FRAME ) )
+	{
+		return advance + 1;
+	}
+
+	return advance + 2;
+}
+
+/*
+ * Waits for the messages queued and returns the first failure among them,
+ * bspI2cBusy if fewer were queued than expected, or bspI2cTimeout if one did
+ * not complete in time.
+ */
+static int8_t FSW_IMG_wait( uint8_t queued, uint8_t expected )
+{
+	COMM_I2Cmsg_TypeDef msg;
+	int8_t status = ( queued == expected ) ? bspI2cOk : bspI2cBusy;
+
+	while( queued > 0 )
+	{
+		if( xQueueReceive( IMG_replies, &msg, IMG_TIMEOUT_MS / portTICK_RATE_MS ) != pdTRUE )
+		{
+			return bspI2cTimeout;
+		}
+		queued--;
+		IMG_pending--;
+
+		if( status == bspI2cOk && msg.status != bspI2cOk )
+		{
+			status = msg.status;
+		}
+	}
+
+	return status;
+}
+
+/*
+ * Waits for the replies of messages left queued when a run gave up waiting
+ * for them. Until they complete the bus may still write into IMG_blocks,
+ * IMG_frameData or read IMG_tcmd, so no run may use them. Returns 0 if a
+ * reply did not come in time.
+ */
+static uint8_t FSW_IMG_drain( void )
+{
+	COMM_I2Cmsg_TypeDef stale;
+
+	while( IMG_pending > 0 )
+	{
+		if( xQueueReceive( IMG_replies, &stale, IMG_TIMEOUT_MS / portTICK_RATE_MS ) != pdTRUE )
+		{
+			return 0;
+		}
+		IMG_pending--;
+	}
+
+	return 1;
+}
+
+/*
+ * Checks a frame read against the frame number and XOR checksum CubeSense
+ * reported for the frame it had loaded.
+ */
+static uint8_t FSW_IMG_check( uint16_t frame, const uint8_t *rx )
+{
+	CUBESENSE_TlmImageFrameData_TypeDef data;
+	uint8_t checkSum = 0;
+	uint16_t i;
+
+	CUBESENSE_updateTlmImageFrameData( &data, IMG_frameData );
+
+	for( i = 0; i < FSW_IMG_FRAMELEN; i++ )
+	{
+		checkSum ^= rx[i];
+	}
+
+	return ( data.frameNumber == frame && data.checkSum == checkSum ) ? 1 : 0;
+}
+
+/*
+ * Opens the image file and progress record of the download requested, and
+ * positions the image file at the first frame to read. A new download
+ * allocates the whole image file and records that no frames are stored yet.
+ * A resumed one takes the image from a valid record, whose image file must
+ * have the size of that image.
+ */
+static FRESULT FSW_IMG_open( const IMG_Request_TypeDef *req )
+{
+	FRESULT res;
+	UINT br;
+	uint32_t bytes;
+
+	f_mkdir( "/IMAGES" );
+
+	if( req->resume )
+	{
+		res = f_open( &IMG_recordFile, FSW_IMG_RECORDPATH, FA_READ | FA_WRITE | FA_OPEN_EXISTING );
+		if( res == FR_OK )
+		{
+			res = f_read( &IMG_recordFile, &IMG_record, sizeof( IMG_record ), &br );
+		}
+		if( res == FR_OK && ( br != sizeof( IMG_record ) || IMG_record.magic != IMG_RECORD_MAGIC ||
+				IMG_record.crc != FSW_CRC16_update( FSW_CRC16_INIT, &IMG_record, offsetof( IMG_Record_TypeDef, crc ) ) ||
+				IMG_record.size > FSW_IMG_MAXSIZE || IMG_record.nextFrame > IMG_record.frames ) )
+		{
+			res = FR_NO_FILE;
+		}
+		if( res == FR_OK )
+		{
+			res = f_open( &IMG_file, FSW_IMG_PATH, FA_WRITE | FA_OPEN_EXISTING );
+		}
+		if( res == FR_OK && f_size( &IMG_file ) != FSW_IMG_bytes( IMG_record.size ) )
+		{
+			res = FR_NO_FILE;
+		}
+	}
+	else
+	{
+		bytes = FSW_IMG_bytes( req->size );
+
+		memset( &IMG_record, 0, sizeof( IMG_record ) );
+		IMG_record.magic = IMG_RECORD_MAGIC;
+		IMG_record.frames = ( uint16_t )( ( bytes + FSW_IMG_FRAMELEN - 1 ) / FSW_IMG_FRAMELEN );
+		IMG_record.image = req->image;
+		IMG_record.size = req->size;
+
+		res = f_open( &IMG_recordFile, FSW_IMG_RECORDPATH, FA_READ | FA_WRITE | FA_CREATE_ALWAYS );
+		if( res == FR_OK )
+		{
+			res = f_open( &IMG_file, FSW_IMG_PATH, FA_WRITE | FA_CREATE_ALWAYS );
+		}
+
+		// Seeking past the end allocates the clusters, so the card cannot fill up halfway
+		if( res == FR_OK )
+		{
+			res = f_lseek( &IMG_file, bytes );
+		}
+		if( res == FR_OK && f_tell( &IMG_file ) != bytes )
+		{
+			res = FR_DENIED;
+		}
+		if( res == FR_OK )
+		{
+			res = FSW_IMG_saveProgress( 0 );
+		}
+	}
+
+	if( res == FR_OK )
+	{
+		res = f_lseek( &IMG_file, IMG_record.nextFrame * FSW_IMG_FRAMELEN );
+	}
+
+	return res;
+}
+
+/*
+ * Writes a buffer of frames to the image file.
+ */
+static FRESULT FSW_IMG_write( const uint8_t *block, UINT len )
+{
+	FRESULT res;
+	UINT bw;
+
+	res = f_write( &IMG_file, block, len, &bw );
+	if( res == FR_OK && bw != len )
+	{
+		res = FR_DENIED;
+	}
+
+	return res;
+}
+
+/*
+ * Syncs the image file, then rewrites the progress record with the frames
+ * stored in it.
+ */
+static FRESULT FSW_IMG_saveProgress( uint32_t stored )
+{
+	FRESULT res;
+	UINT bw;
+
+	IMG_stats.runTicks = xTaskGetTickCount() - IMG_runStart;
+	IMG_stats.totalTicks = IMG_priorTicks + IMG_stats.runTicks;
+
+	res = f_sync( &IMG_file );
+	if( res == FR_OK )
+	{
+		IMG_record.nextFrame = stored;
+		IMG_record.totalTicks = IMG_stats.totalTicks;
+		IMG_record.crc = FSW_CRC16_update( FSW_CRC16_INIT, &IMG_record, offsetof( IMG_Record_TypeDef, crc ) );
+		res = f_lseek( &IMG_recordFile, 0 );
+	}
+	if( res == FR_OK )
+	{
+		res = f_write( &IMG_recordFile, &IMG_record, sizeof( IMG_record ), &bw );
+	}
+	if( res == FR_OK && bw != sizeof( IMG_record ) )
+	{
+		res = FR_DENIED;
+	}
+	if( res == FR_OK )
+	{
+		res = f_sync( &IMG_recordFile );
+	}
+
+	return res;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function runs a download until the image is stored, it is aborted, or
+ * a frame fails FSW_IMG_RETRIES times. A failed frame is loaded and read
+ * again after FSW_IMG_RETRY_MS. Whatever the outcome, the whole buffers
+ * collected are stored and recorded, so the download can be resumed. A run
+ * does not start while messages of a run that timed out are still queued.
+ *
+ * @param[in] req
+ *   Download requested.
+ ******************************************************************************/
+static void FSW_IMG_download( const IMG_Request_TypeDef *req )
+{
+	FRESULT res;
+	uint32_t frame, stored, frames, bytes;
+	uint32_t pendingFrames = 0;				// Frames of the full buffer not yet written
+	UINT pendingLen = 0;
+	uint16_t blocks = 0;
+	uint8_t cur = 0, advance, queued = 0, attempts = 0;
+	uint8_t len;
+	int8_t status = bspI2cOk;
+
+	IMG_abortFlag = 0;
+	IMG_runStart = xTaskGetTickCount();
+	IMG_stats.state = FSW_IMG_RUNNING;
+	IMG_stats.framesRead = 0;
+	IMG_stats.runTicks = 0;
+	IMG_stats.framesPerSec = 0;
+	IMG_stats.checksumErrors = 0;
+	IMG_stats.i2cErrors = 0;
+	IMG_stats.lastError = 0;
+	IMG_priorTicks = 0;
+
+	// The buffers are the bus's until the messages of a timed out run complete
+	if( !FSW_IMG_drain() )
+	{
+		IMG_stats.lastError = bspI2cTimeout;
+		IMG_stats.state = FSW_IMG_FAILED;
+		return;
+	}
+
+	res = FSW_IMG_open( req );
+	if( res == FR_OK )
+	{
+		IMG_priorTicks = IMG_record.totalTicks;
+		IMG_stats.image = IMG_record.image;
+		IMG_stats.size = IMG_record.size;
+		IMG_stats.frames = IMG_record.frames;
+		IMG_stats.nextFrame = IMG_record.nextFrame;
+		IMG_stats.resumes += req->resume;
+	}
+
+	frames = IMG_record.frames;
+	bytes = FSW_IMG_bytes( IMG_record.size );
+	frame = stored = IMG_record.nextFrame;
+
+	// CubeSense loads frame 0 when the download is initialized. A resumed download asks for its frame.
+	advance = req->resume;
+	if( res == FR_OK && !req->resume )
+	{
+		len = ( uint8_t )CUBESENSE_createTcmdInitializeImageDownload( IMG_tcmd, IMG_record.image, IMG_record.size );
+		status = FSW_IMG_wait( FSW_IMG_submit( bspI2cWrite, IMG_tcmd, len, NULL, 0, IMG_MSG_TCMD ), 1 );
+	}
+	if( res == FR_OK && status == bspI2cOk && frame < frames )
+	{
+		queued = FSW_IMG_readFrame( frame, &IMG_blocks[cur][( frame % FSW_IMG_BLOCKFRAMES ) * FSW_IMG_FRAMELEN], advance );
+	}
+
+	while( res == FR_OK && status == bspI2cOk && frame < frames )
+	{
+		// Store the buffer filled before this frame while the frame is on the bus
+		if( pendingFrames > 0 )
+		{
+			res = FSW_IMG_write( IMG_blocks[cur ^ 1], pendingLen );
+			if( res == FR_OK )
+			{
+				stored += pendingFrames;
+				IMG_stats.nextFrame = stored;
+				if( ++blocks % FSW_IMG_SYNC_BLOCKS == 0 )
+				{
+					res = FSW_IMG_saveProgress( stored );
+				}
+			}
+			pendingFrames = 0;
+		}
+
+		status = FSW_IMG_wait( queued, advance ? 3 : 2 );
+		if( res != FR_OK || status == bspI2cTimeout )
+		{
+			break;
+		}
+
+		if( status != bspI2cOk || !FSW_IMG_check( frame, &IMG_blocks[cur][( frame % FSW_IMG_BLOCKFRAMES ) * FSW_IMG_FRAMELEN] ) )
+		{
+			if( status != bspI2cOk )
+			{
+				IMG_stats.i2cErrors++;
+			}
+			else
+			{
+				IMG_stats.checksumErrors++;
+				status = IMG_CHECK_ERROR;
+			}
+			if( ++attempts >= FSW_IMG_RETRIES )
+			{
+				break;
+			}
+
+			// Load the frame again, in case CubeSense had not loaded it yet
+			vTaskDelay( FSW_IMG_RETRY_MS / portTICK_RATE_MS );
+			status = bspI2cOk;
+			advance = 1;
+			queued = FSW_IMG_readFrame( frame, &IMG_blocks[cur][( frame % FSW_IMG_BLOCKFRAMES ) * FSW_IMG_FRAMELEN], advance );
+			continue;
+		}
+
+		attempts = 0;
+		IMG_stats.framesRead++;
+		frame++;
+
+		// A full buffer, or the last frame: the other buffer collects the next frames
+		if( frame % FSW_IMG_BLOCKFRAMES == 0 || frame == frames )
+		{
+			pendingFrames = frame - stored;
+			pendingLen = ( frame == frames ) ? ( UINT )( bytes - stored * FSW_IMG_FRAMELEN ) : FSW_IMG_BLOCKLEN;
+			cur ^= 1;
+		}
+
+		if( frame == frames || IMG_abortFlag )
+		{
+			break;
+		}
+
+		advance = 1;
+		queued = FSW_IMG_readFrame( frame, &IMG_blocks[cur][( frame % FSW_IMG_BLOCKFRAMES ) * FSW_IMG_FRAMELEN], advance );
+	}
+
+	// Store and record the frames verified before the download stopped
+	if( res == FR_OK && pendingFrames > 0 )
+	{
+		res = FSW_IMG_write( IMG_blocks[cur ^ 1], pendingLen );
+		if( res == FR_OK )
+		{
+			stored += pendingFrames;
+			IMG_stats.nextFrame = stored;
+		}
+	}
+	if( IMG_file.fs != NULL )
+	{
+		if( res == FR_OK )
+		{
+			res = FSW_IMG_saveProgress( stored );
+		}
+		f_close( &IMG_file );
+	}
+	if( IMG_recordFile.fs != NULL )
+	{
+		f_close( &IMG_recordFile );
+	}
+
+	IMG_stats.runTicks = xTaskGetTickCount() - IMG_runStart;
+	IMG_stats.totalTicks = IMG_priorTicks + IMG_stats.runTicks;
+	if( IMG_stats.runTicks > 0 )
+	{
+		IMG_stats.framesPerSec = ( uint16_t )( IMG_stats.framesRead * configTICK_RATE_HZ / IMG_stats.runTicks );
+	}
+
+	if( res != FR_OK )
+	{
+		IMG_stats.lastError = ( int8_t )res;
+		IMG_stats.state = FSW_IMG_FAILED;
+	}
+	else if( status != bspI2cOk )
+	{
+		IMG_stats.lastError = status;
+		IMG_stats.state = FSW_IMG_FAILED;
+	}
+	else if( stored < frames )
+	{
+		IMG_stats.state = FSW_IMG_ABORTED;
+	}
+	else
+	{
+		IMG_stats.state = FSW_IMG_DONE;
+	}
+}
+
+// TASKS *****************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Runs the downloads requested by FSW_IMG_start and FSW_IMG_resume, one at a
+ * time.
+ ******************************************************************************/
+static void FSW_IMG_task( void *pvParameters )
+{
+	IMG_Request_TypeDef req;
+
+	while(1)
+	{
+		if( xQueueReceive( IMG_requests, &req, portMAX_DELAY ) == pdPASS )
+		{
+			FSW_IMG_download( &req );
+		}
+	}
+
+	// Delete the task if it ever breaks out of the loop above
+	vTaskDelete( NULL );
+}
+
+/** @} (end addtogroup Payload) */
+/** @} (end addtogroup FSW_Library) */
@@ -0,0 +1,377 @@
+/***************************************************************************//**
+ * @file	fsw_link.c
+ * @brief	FSW link protocol source file.
+ *
+ * This file contains the frame encoder, the byte at a time receiver, which is
+ * cheap enough to run in an interrupt handler, and the single producer, single
+ * consumer frame queue.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fsw_link.h"
+#include "fsw_crc.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the link protocol.
+ * @{
+ ******************************************************************************/
+
+/// Orders the queue's slot accesses against its index updates, for the compiler and the core (a DMB on the Cortex-M3).
+#define LINK_BARRIER()		__sync_synchronize()
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function builds a frame and COBS encodes it, ending it with the
+ * delimiter. Each COBS block is a code byte, one more than the number of
+ * non-zero bytes that follow it, and then those bytes; a zero follows every
+ * block shorter than 254 bytes except the last.
+ *
+ * @param[out] out
+ * 		The encoded frame, FSW_LINK_FRAMEMAX bytes long.
+ * @param[in] id
+ * 		Telecommand or telemetry ID.
+ * @param[in] seq
+ * 		Sequence number.
+ * @param[in] payload
+ * 		The payload.
+ * @param[in] len
+ * 		Bytes of payload, up to FSW_LINK_MAXPAYLOAD.
+ * @return
+ * 		Bytes of the encoded frame, or 0 if the payload is too long.
+ ******************************************************************************/
+uint16_t FSW_LINK_encode( uint8_t *out, uint8_t id, uint8_t seq, const uint8_t *payload, uint8_t len )
+{
+	uint8_t raw[FSW_LINK_RAWMAX];
+	uint16_t rawLen, crc, i;
+	uint16_t codePos = 0;
+	uint16_t outLen = 1;
+	uint8_t code = 1;
+
+	if( len > FSW_LINK_MAXPAYLOAD )
+	{
+		return 0;
+	}
+
+	raw[0] = id;
+	raw[1] = seq;
+	raw[2] = len;
+	memcpy( &raw[FSW_LINK_HEADERLEN], payload, len );
+	crc = FSW_CRC16_update( FSW_CRC16_INIT, raw, FSW_LINK_HEADERLEN + len );
+	raw[FSW_LINK_HEADERLEN + len] = ( uint8_t )crc;
+	raw[FSW_LINK_HEADERLEN + len + 1] = ( uint8_t )( crc >> 8 );
+	rawLen = FSW_LINK_HEADERLEN + len + FSW_LINK_CRCLEN;
+
+	for( i = 0; i < rawLen; i++ )
+	{
+		if( raw[i] == 0 )
+		{
+			out[codePos] = code;
+			codePos = outLen++;
+			code = 1;
+		}
+		else
+		{
+			out[outLen++] = raw[i];
+			if( ++code == 0xFF )
+			{
+				out[codePos] = code;
+				codePos = outLen++;
+				code = 1;
+			}
+		}
+	}
+	out[codePos] = code;
+	out[outLen++] = FSW_LINK_DELIMITER;
+
+	return outLen;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function resets a receiver, dropping any frame it was receiving, and
+ * clears its counters.
+ *
+ * @param[out] dec
+ * 		The receiver.
+ ******************************************************************************/
+void FSW_LINK_rxInit( FSW_LINK_Decoder_TypeDef *dec )
+{
+	memset( dec, 0, sizeof( *dec ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function gives a received byte to a receiver. A delimiter ends the
+ * frame, and the frame is checked. Otherwise the byte is decoded into the
+ * frame; the zero a COBS block stands for is only added once the next block
+ * starts, since the last block of a frame stands for none.
+ *
+ * @param[in,out] dec
+ * 		The receiver.
+ * @param[in] byte
+ * 		The byte.
+ * @return
+ * 		linkRxFrame once a frame has been received intact, an error if a frame
+ * 		was dropped, otherwise linkRxNone.
+ ******************************************************************************/
+FSW_LINK_RxStatus_TypeDef FSW_LINK_rxByte( FSW_LINK_Decoder_TypeDef *dec, uint8_t byte )
+{
+	uint8_t *raw = ( uint8_t * )&dec->frame;
+
+	if( byte == FSW_LINK_DELIMITER )
+	{
+		return FSW_LINK_rxEnd( dec );
+	}
+
+	if( dec->overflow )
+	{
+		return linkRxNone;
+	}
+
+	if( dec->remaining == 0 )
+	{
+		// Code byte
+		if( dec->zero )
+		{
+			if( dec->rawLen < FSW_LINK_RAWMAX )
+			{
+				raw[dec->rawLen++] = 0;
+			}
+			else
+			{
+				dec->overflow = 1;
+			}
+		}
+		dec->remaining = byte - 1;
+		dec->zero = ( byte != 0xFF );
+	}
+	else
+	{
+		if( dec->rawLen < FSW_LINK_RAWMAX )
+		{
+			raw[dec->rawLen++] = byte;
+		}
+		else
+		{
+			dec->overflow = 1;
+		}
+		dec->remaining--;
+	}
+
+	return linkRxNone;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function ends the frame being received, as a delimiter does. It is
+ * called when the line goes idle or the I2C master sends a STOP, so a frame
+ * without its delimiter is still taken, and a partial frame is dropped rather
+ * than joined to the next.
+ *
+ * @param[in,out] dec
+ * 		The receiver.
+ * @return
+ * 		linkRxFrame if the frame is intact, an error if it was dropped, or
+ * 		linkRxNone if no frame was being received.
+ ******************************************************************************/
+FSW_LINK_RxStatus_TypeDef FSW_LINK_rxEnd( FSW_LINK_Decoder_TypeDef *dec )
+{
+	const uint8_t *raw = ( const uint8_t * )&dec->frame;
+	FSW_LINK_RxStatus_TypeDef status;
+	uint16_t crc;
+
+	if( dec->rawLen == 0 && dec->remaining == 0 && !dec->zero && !dec->overflow )
+	{
+		return linkRxNone;
+	}
+
+	if( dec->overflow || dec->remaining != 0 || dec->rawLen < FSW_LINK_HEADERLEN + FSW_LINK_CRCLEN ||
+		dec->frame.len != dec->rawLen - FSW_LINK_HEADERLEN - FSW_LINK_CRCLEN )
+	{
+		dec->stats.formatErrors++;
+		status = linkRxErrFormat;
+	}
+	else
+	{
+		crc = FSW_CRC16_update( FSW_CRC16_INIT, raw, dec->rawLen - FSW_LINK_CRCLEN );
+		if( raw[dec->rawLen - 2] == ( uint8_t )crc && raw[dec->rawLen - 1] == ( uint8_t )( crc >> 8 ) )
+		{
+			dec->stats.frames++;
+			status = linkRxFrame;
+		}
+		else
+		{
+			dec->stats.crcErrors++;
+			status = linkRxErrCrc;
+		}
+	}
+
+	dec->rawLen = 0;
+	dec->remaining = 0;
+	dec->zero = 0;
+	dec->overflow = 0;
+
+	return status;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets up an empty queue over the given slots.
+ *
+ * @param[out] queue
+ * 		The queue.
+ * @param[in] slots
+ * 		Storage for the queued frames.
+ * @param[in] len
+ * 		Number of slots, a power of two.
+ * @return
+ * 		1 on success, 0 if len is not a power of two.
+ ******************************************************************************/
+uint8_t FSW_LINK_queueInit( FSW_LINK_Queue_TypeDef *queue, FSW_LINK_Frame_TypeDef *slots, uint16_t len )
+{
+	if( len == 0 || ( len & ( len - 1 ) ) != 0 )
+	{
+		return 0;
+	}
+
+	queue->slot = slots;
+	queue->mask = len - 1;
+	queue->head = 0;
+	queue->tail = 0;
+	queue->dropped = 0;
+
+	return 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies a frame into the queue. Only the producer may call it.
+ * The frame is in its slot before the head moves past it, so the consumer
+ * never sees it half written.
+ *
+ * @param[in,out] queue
+ * 		The queue.
+ * @param[in] frame
+ * 		The frame.
+ * @return
+ * 		1 if the frame was queued, 0 if the queue was full and it was dropped.
+ ******************************************************************************/
+uint8_t FSW_LINK_queuePush( FSW_LINK_Queue_TypeDef *queue, const FSW_LINK_Frame_TypeDef *frame )
+{
+	uint16_t head = queue->head;
+
+	if( ( uint16_t )( head - queue->tail ) > queue->mask )
+	{
+		queue->dropped++;
+		return 0;
+	}
+
+	memcpy( &queue->slot[head & queue->mask], frame, FSW_LINK_HEADERLEN + frame->len );
+	LINK_BARRIER();
+	queue->head = head + 1;
+
+	return 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the oldest queued frame, which stays in the queue until
+ * FSW_LINK_queuePop. Only the consumer may call it.
+ *
+ * @param[in] queue
+ * 		The queue.
+ * @return
+ * 		The frame, or NULL if the queue is empty.
+ ******************************************************************************/
+FSW_LINK_Frame_TypeDef *FSW_LINK_queuePeek( FSW_LINK_Queue_TypeDef *queue )
+{
+	uint16_t tail = queue->tail;
+
+	if( tail == queue->head )
+	{
+		return NULL;
+	}
+	LINK_BARRIER();
+
+	return &queue->slot[tail & queue->mask];
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function hands the oldest frame's slot back to the producer. Only the
+ * consumer may call it, after FSW_LINK_queuePeek returned a frame.
+ *
+ * @param[in,out] queue
+ * 		The queue.
+ ******************************************************************************/
+void FSW_LINK_queuePop( FSW_LINK_Queue_TypeDef *queue )
+{
+	LINK_BARRIER();
+	queue->tail = queue->tail + 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the number of frames queued. Either side may call it;
+ * the other side may change it at any time.
+ *
+ * @param[in] queue
+ * 		The queue.
+ * @return
+ * 		Frames queued.
+ ******************************************************************************/
+uint16_t FSW_LINK_queueCount( const FSW_LINK_Queue_TypeDef *queue )
+{
+	return ( uint16_t )( queue->head - queue->tail );
+}
@@ -0,0 +1,162 @@
+/***************************************************************************//**
+ * @file	fsw_logformat.c
+ * @brief	FSW binary log format source file.
+ *
+ * This file contains the functions that build and check the sector headers,
+ * records and control block of the binary log files. It is also built into the host log decoder.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "fsw_logformat.h"
+#include "fsw_crc.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Filesystem
+ * @brief API for the filesystem interface module.
+ * @{
+ ******************************************************************************/
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function fills in the header written at the start of each log sector.
+ *
+ * @param[out] header
+ * 		The header.
+ * @param[in] type
+ * 		LOG_CMD, LOG_WOD or LOG_ERROR.
+ * @param[in] seq
+ * 		Number of sectors written to the log before this one.
+ * @param[in] created
+ * 		OBC time at which the sector is started.
+ ******************************************************************************/
+void FSW_LOGFMT_header( FS_LogHeader_TypeDef *header, uint8_t type, uint32_t seq, uint32_t created )
+{
+	header->magic = FS_LOG_MAGIC;
+	header->version = FS_LOG_VERSION;
+	header->type = type;
+	header->seq = seq;
+	header->created = created;
+	header->recordSize = sizeof( FS_LogRecord_TypeDef );
+	header->reserved = 0;
+	header->crc = FSW_CRC16_update( FSW_CRC16_INIT, header, offsetof( FS_LogHeader_TypeDef, crc ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function fills in a log record.
+ *
+ * @param[out] record
+ * 		The record.
+ * @param[in] exe_time
+ * 		Execution time of the command, or the time the error was detected.
+ * @param[in] source
+ * 		Module the entry comes from.
+ * @param[in] id
+ * 		I.D. of the command or error.
+ ******************************************************************************/
+void FSW_LOGFMT_record( FS_LogRecord_TypeDef *record, uint32_t exe_time, uint8_t source, uint8_t id )
+{
+	record->exe_time = exe_time;
+	record->source = source;
+	record->id = id;
+	record->crc = FSW_CRC16_update( FSW_CRC16_INIT, record, offsetof( FS_LogRecord_TypeDef, crc ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] header
+ * 		A header read from the start of a log sector.
+ * @return
+ * 		1 if the header is intact and describes records of this version,
+ * 		otherwise 0.
+ ******************************************************************************/
+uint8_t FSW_LOGFMT_checkHeader( const FS_LogHeader_TypeDef *header )
+{
+	return ( header->magic == FS_LOG_MAGIC && header->version == FS_LOG_VERSION
+			&& header->recordSize == sizeof( FS_LogRecord_TypeDef )
+			&& header->crc == FSW_CRC16_update( FSW_CRC16_INIT, header, offsetof( FS_LogHeader_TypeDef, crc ) ) ) ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] record
+ * 		A record read from a log file.
+ * @return
+ * 		1 if the record's CRC matches its contents, otherwise 0.
+ ******************************************************************************/
+uint8_t FSW_LOGFMT_checkRecord( const FS_LogRecord_TypeDef *record )
+{
+	return ( record->crc == FSW_CRC16_update( FSW_CRC16_INIT, record, offsetof( FS_LogRecord_TypeDef, crc ) ) ) ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function fills in the magic number, version and CRC of a control block
+ * copy, after its ring states and generation have been set.
+ *
+ * @param[in,out] cb
+ * 		The control block copy.
+ ******************************************************************************/
+void FSW_LOGFMT_sealControlBlock( FS_LogControlBlock_TypeDef *cb )
+{
+	cb->magic = FS_LOGCB_MAGIC;
+	cb->version = FS_LOG_VERSION;
+	cb->reserved = 0;
+	cb->crc = FSW_CRC16_update( FSW_CRC16_INIT, cb, offsetof( FS_LogControlBlock_TypeDef, crc ) );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] cb
+ * 		A control block copy read from the card.
+ * @return
+ * 		1 if the copy is intact and of this version, otherwise 0.
+ ******************************************************************************/
+uint8_t FSW_LOGFMT_checkControlBlock( const FS_LogControlBlock_TypeDef *cb )
+{
+	return ( cb->magic == FS_LOGCB_MAGIC && cb->version == FS_LOG_VERSION
+			&& cb->crc == FSW_CRC16_update( FSW_CRC16_INIT, cb, offsetof( FS_LogControlBlock_TypeDef, crc ) ) ) ? 1 : 0;
+}
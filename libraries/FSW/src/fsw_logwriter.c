@@ -0,0 +1,617 @@
+/***************************************************************************//**
+ * @file	fsw_logwriter.c
+ * @brief	FSW buffered log writer source file.
+ *
+ * This file contains the log writer used by the file system module. Each log
+ * is a file of preallocated sectors used as a ring, so a full card overwrites
+ * the oldest entries and no files are created while logging. A writer collects
+ * entries in a RAM copy of the ring's head sector and writes the whole sector
+ * when it is full, when the oldest entry has waited too long or when a flush
+ * is requested, so the card never has to read-modify-write.
+ *
+ * The head, tail and sequence number of every ring are kept in a control block
+ * with two copies in separate sectors, written alternately. A reset during an
+ * update leaves the other copy intact. The control block is updated whenever a
+ * ring moves on to a new sector, before anything is written to that sector, so
+ * after a reset a writer only has to read its head sector to resume.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "fsw_logwriter.h"
+#include "fsw_healthandhousekeeping.h"		// for the OBC time
+#include "diskcache.h"
+#include "task.h"
+
+#define LOGW_CB_COPIES		2			///< Copies of the control block, one per sector of its file.
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup Filesystem
+ * @brief API for the filesystem interface module.
+ * @{
+ ******************************************************************************/
+
+static FS_LogControlBlock_TypeDef LOGW_cb;		///< Current control block. Shared by the writers.
+static FIL LOGW_cbFile;							///< The control block file
+static uint8_t LOGW_cbSector[FSW_LOGW_SECTOR];	///< A control block copy padded to a whole sector, so it is written straight to the card
+static uint8_t LOGW_cbOpen = 0;					///< Whether LOGW_cbFile is open
+static DWORD LOGW_cbSize = 0;					///< Size of the control block file as last synced
+
+static FRESULT FSW_LOGW_saveControlBlock( void );
+static FRESULT FSW_LOGW_erase( FSW_LOGW_TypeDef *log, uint16_t sectors );
+static FRESULT FSW_LOGW_resume( FSW_LOGW_TypeDef *log );
+static void FSW_LOGW_startSector( FSW_LOGW_TypeDef *log );
+static void FSW_LOGW_advance( FSW_LOGW_TypeDef *log );
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function opens the control block file, creating it if needed, and
+ * restores the intact copy with the highest generation. Call it before the
+ * writers are initialised.
+ *
+ * @param[in] path
+ * 		Path of the control block file.
+ * @return
+ * 		FR_OK if a copy was restored, FR_NO_FILE if no intact copy was found
+ * 		and every ring will be started afresh, or the result of the FatFs call
+ * 		that failed.
+ ******************************************************************************/
+FRESULT FSW_LOGW_loadControlBlock( const char *path )
+{
+	FS_LogControlBlock_TypeDef copy;
+	FRESULT result;
+	UINT bytes;
+	uint8_t i, found = 0;
+
+	memset( &LOGW_cb, 0, sizeof( LOGW_cb ) );
+
+	if( LOGW_cbOpen )
+	{
+		f_close( &LOGW_cbFile );
+		LOGW_cbOpen = 0;
+	}
+
+	result = f_open( &LOGW_cbFile, path, FA_OPEN_ALWAYS | FA_READ | FA_WRITE );
+	if( result != FR_OK )
+	{
+		return result;
+	}
+	LOGW_cbOpen = 1;
+	LOGW_cbSize = f_size( &LOGW_cbFile );
+
+	for( i = 0; i < LOGW_CB_COPIES; i++ )
+	{
+		if( ( DWORD )i * FSW_LOGW_SECTOR < f_size( &LOGW_cbFile )
+				&& f_lseek( &LOGW_cbFile, ( DWORD )i * FSW_LOGW_SECTOR ) == FR_OK
+				&& f_read( &LOGW_cbFile, &copy, sizeof( copy ), &bytes ) == FR_OK && bytes == sizeof( copy )
+				&& FSW_LOGFMT_checkControlBlock( &copy ) && ( !found || copy.generation > LOGW_cb.generation ) )
+		{
+			LOGW_cb = copy;
+			found = 1;
+		}
+	}
+
+	return found ? FR_OK : FR_NO_FILE;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function closes the control block file, after every writer has been
+ * closed, so that the file is no longer locked.
+ *
+ * @return
+ * 		FR_OK, or the result of f_close.
+ ******************************************************************************/
+FRESULT FSW_LOGW_closeControlBlock( void )
+{
+	if( !LOGW_cbOpen )
+	{
+		return FR_OK;
+	}
+
+	LOGW_cbOpen = 0;
+	return f_close( &LOGW_cbFile );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function writes the control block over its older copy. A whole sector
+ * write goes straight to the card, so the file only has to be synced while
+ * it is still growing to its full size.
+ ******************************************************************************/
+static FRESULT FSW_LOGW_saveControlBlock( void )
+{
+	FRESULT result;
+	DWORD offset;
+	UINT bytes;
+
+	if( !LOGW_cbOpen )
+	{
+		return FR_NOT_READY;
+	}
+
+	LOGW_cb.generation++;
+	FSW_LOGFMT_sealControlBlock( &LOGW_cb );
+	memset( LOGW_cbSector, 0xFF, FSW_LOGW_SECTOR );
+	memcpy( LOGW_cbSector, &LOGW_cb, sizeof( LOGW_cb ) );
+
+	offset = ( LOGW_cb.generation % LOGW_CB_COPIES ) * FSW_LOGW_SECTOR;
+	result = f_lseek( &LOGW_cbFile, offset );
+	if( result == FR_OK )
+	{
+		result = f_write( &LOGW_cbFile, LOGW_cbSector, FSW_LOGW_SECTOR, &bytes );
+	}
+	if( result == FR_OK && bytes != FSW_LOGW_SECTOR )
+	{
+		result = FR_DENIED;				// Card full
+	}
+	if( result == FR_OK && offset + FSW_LOGW_SECTOR > LOGW_cbSize )
+	{
+		result = f_sync( &LOGW_cbFile );
+		LOGW_cbSize = f_size( &LOGW_cbFile );
+	}
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function opens a ring log. A ring that the control block does not know,
+ * or whose size has changed, is preallocated and erased. Otherwise the head
+ * sector named by the control block is read back and logging continues after
+ * its last intact entry.
+ *
+ * @param[in] log
+ * 		The writer.
+ * @param[in] path
+ * 		Path of the ring file, in a directory that exists.
+ * @param[in] type
+ * 		LOG_CMD, LOG_WOD or LOG_ERROR.
+ * @param[in] sectors
+ * 		Size of the ring in sectors.
+ * @param[in] syncPolicy
+ * 		One of the FSW_LOGW_SYNC_ macros.
+ * @return
+ * 		FR_OK, or the result of the FatFs call that failed.
+ ******************************************************************************/
+FRESULT FSW_LOGW_Init( FSW_LOGW_TypeDef *log, const char *path, uint8_t type, uint16_t sectors, uint8_t syncPolicy )
+{
+	FRESULT result;
+
+	memset( log, 0, sizeof( FSW_LOGW_TypeDef ) );
+
+	log->path = path;
+	log->type = type;
+	log->syncPolicy = syncPolicy;
+	log->state = &LOGW_cb.ring[type - 1];
+
+	result = f_open( &log->file, path, FA_OPEN_ALWAYS | FA_READ | FA_WRITE );
+	if( result != FR_OK )
+	{
+		log->stats.errors++;
+		return result;
+	}
+	log->isOpen = 1;
+
+	if( log->state->sectors != sectors || f_size( &log->file ) != ( DWORD )sectors * FSW_LOGW_SECTOR )
+	{
+		result = FSW_LOGW_erase( log, sectors );
+	}
+	else
+	{
+		result = FSW_LOGW_resume( log );
+	}
+
+	if( result != FR_OK )
+	{
+		log->stats.errors++;
+	}
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function allocates the ring's sectors by writing them erased and starts
+ * the ring afresh at its first sector.
+ ******************************************************************************/
+static FRESULT FSW_LOGW_erase( FSW_LOGW_TypeDef *log, uint16_t sectors )
+{
+	FRESULT result;
+	UINT bytes;
+	uint16_t i;
+
+	memset( log->buffer, 0xFF, FSW_LOGW_SECTOR );
+
+	result = f_lseek( &log->file, 0 );
+	for( i = 0; i < sectors && result == FR_OK; i++ )
+	{
+		result = f_write( &log->file, log->buffer, FSW_LOGW_SECTOR, &bytes );
+		if( result == FR_OK && bytes != FSW_LOGW_SECTOR )
+		{
+			result = FR_DENIED;			// Card full
+		}
+	}
+	if( result == FR_OK )
+	{
+		result = f_truncate( &log->file );
+	}
+	if( result == FR_OK )
+	{
+		result = f_sync( &log->file );
+	}
+	if( result != FR_OK )
+	{
+		return result;
+	}
+
+	log->state->seq = 0;
+	log->state->head = 0;
+	log->state->tail = 0;
+	log->state->sectors = sectors;
+	FSW_LOGW_startSector( log );
+
+	return FSW_LOGW_saveControlBlock();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function reads back the head sector and counts the intact entries in
+ * it. If the sector was never written, or its header is from an earlier lap of
+ * the ring, the sector is started afresh.
+ ******************************************************************************/
+static FRESULT FSW_LOGW_resume( FSW_LOGW_TypeDef *log )
+{
+	FS_LogHeader_TypeDef header;
+	FS_LogRecord_TypeDef record;
+	FRESULT result;
+	UINT bytes;
+	uint16_t fill;
+
+	result = f_lseek( &log->file, ( DWORD )log->state->head * FSW_LOGW_SECTOR );
+	if( result == FR_OK )
+	{
+		result = f_read( &log->file, log->buffer, FSW_LOGW_SECTOR, &bytes );
+	}
+	if( result != FR_OK )
+	{
+		return result;
+	}
+
+	memcpy( &header, log->buffer, sizeof( header ) );
+	if( bytes != FSW_LOGW_SECTOR || !FSW_LOGFMT_checkHeader( &header )
+			|| header.seq != log->state->seq || header.type != log->type )
+	{
+		FSW_LOGW_startSector( log );
+		return FR_OK;
+	}
+
+	// Entries up to the first erased or torn one
+	for( fill = sizeof( header ); fill + sizeof( record ) <= FSW_LOGW_SECTOR; fill += sizeof( record ) )
+	{
+		memcpy( &record, &log->buffer[fill], sizeof( record ) );
+		if( !FSW_LOGFMT_checkRecord( &record ) )
+		{
+			break;
+		}
+	}
+	memset( &log->buffer[fill], 0xFF, FSW_LOGW_SECTOR - fill );
+	log->fill = fill;
+
+	if( log->fill + sizeof( record ) > FSW_LOGW_SECTOR )
+	{
+		FSW_LOGW_advance( log );
+	}
+
+	return FR_OK;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function starts the head sector in the buffer: erased, with a header
+ * carrying the ring's sequence number. Nothing is written to the card until
+ * an entry is flushed.
+ ******************************************************************************/
+static void FSW_LOGW_startSector( FSW_LOGW_TypeDef *log )
+{
+	FS_LogHeader_TypeDef header;
+
+	FSW_LOGFMT_header( &header, log->type, log->state->seq, ( uint32_t )getOBC_time() );
+	memset( log->buffer, 0xFF, FSW_LOGW_SECTOR );
+	memcpy( log->buffer, &header, sizeof( header ) );
+	log->fill = sizeof( header );
+	log->dirty = 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function moves the ring on to its next sector, overwriting the oldest
+ * one once the ring is full, and records the move in the control block.
+ ******************************************************************************/
+static void FSW_LOGW_advance( FSW_LOGW_TypeDef *log )
+{
+	FS_LogRingState_TypeDef *state = log->state;
+
+	state->head = ( state->head + 1 ) % state->sectors;
+	state->seq++;
+
+	// From the second lap on, the sector after the head holds the oldest entries
+	if( state->seq >= state->sectors )
+	{
+		state->tail = ( state->head + 1 ) % state->sectors;
+		log->stats.overwrites++;
+	}
+
+	if( FSW_LOGW_saveControlBlock() == FR_OK )
+	{
+		log->stats.sectorWrites++;
+	}
+	else
+	{
+		log->stats.errors++;
+	}
+
+	FSW_LOGW_startSector( log );
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function adds an entry to the head sector. An entry that does not fit
+ * in the rest of the sector starts the next one. The sector is written out as
+ * soon as it is full, and the head only moves on once it has been written: a
+ * full sector that failed stays buffered and is written again by the next
+ * append, which is refused until it succeeds.
+ *
+ * @param[in] log
+ * 		The writer.
+ * @param[in] entry
+ * 		The entry.
+ * @param[in] len
+ * 		Length of the entry in bytes.
+ * @return
+ * 		FR_OK, or the result of the FatFs call that failed.
+ ******************************************************************************/
+FRESULT FSW_LOGW_append( FSW_LOGW_TypeDef *log, const void *entry, uint16_t len )
+{
+	FRESULT result = FR_OK;
+
+	if( !log->isOpen || len > FSW_LOGW_SECTOR - sizeof( FS_LogHeader_TypeDef ) )
+	{
+		log->stats.errors++;
+		return log->isOpen ? FR_INVALID_PARAMETER : FR_NOT_READY;
+	}
+
+	if( log->fill + len > FSW_LOGW_SECTOR )
+	{
+		result = FSW_LOGW_flush( log, FSW_LOGW_FLUSH_FULL );
+		if( result != FR_OK )
+		{
+			return result;
+		}
+		FSW_LOGW_advance( log );
+	}
+
+	if( !log->dirty )
+	{
+		log->pendingSince = xTaskGetTickCount();
+	}
+
+	memcpy( &log->buffer[log->fill], entry, len );
+	log->fill += len;
+	log->dirty = 1;
+
+	log->stats.entries++;
+	log->stats.entryBytes += len;
+
+	if( log->fill == FSW_LOGW_SECTOR )
+	{
+		result = FSW_LOGW_flush( log, FSW_LOGW_FLUSH_FULL );
+		if( result == FR_OK )
+		{
+			FSW_LOGW_advance( log );
+		}
+	}
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function writes the head sector to the card and, depending on the
+ * reason and the sync policy, follows it with f_sync. Entries that could not
+ * be written stay buffered for the next flush.
+ *
+ * @param[in] log
+ * 		The writer.
+ * @param[in] reason
+ * 		One of the FSW_LOGW_FLUSH_ macros.
+ * @return
+ * 		FR_OK, or the result of the FatFs call that failed.
+ ******************************************************************************/
+FRESULT FSW_LOGW_flush( FSW_LOGW_TypeDef *log, uint8_t reason )
+{
+	FRESULT result;
+	UINT bytes;
+
+	if( !log->isOpen )
+	{
+		return FR_OK;
+	}
+
+	if( log->dirty )
+	{
+		// A whole sector at a sector boundary goes straight to the card, past the FatFs buffer
+		result = f_lseek( &log->file, ( DWORD )log->state->head * FSW_LOGW_SECTOR );
+		if( result == FR_OK )
+		{
+			result = f_write( &log->file, log->buffer, FSW_LOGW_SECTOR, &bytes );
+		}
+		if( result != FR_OK || bytes != FSW_LOGW_SECTOR )
+		{
+			log->stats.errors++;
+			return ( result != FR_OK ) ? result : FR_DISK_ERR;
+		}
+
+		log->dirty = 0;
+		log->stats.flushes++;
+		log->stats.sectorWrites++;
+		log->unsynced = 1;
+	}
+
+	if( log->unsynced && ( reason == FSW_LOGW_FLUSH_SYNC || log->syncPolicy == FSW_LOGW_SYNC_FLUSH
+			|| ( reason == FSW_LOGW_FLUSH_TIMEOUT && log->syncPolicy == FSW_LOGW_SYNC_TIMEOUT ) ) )
+	{
+		result = f_sync( &log->file );
+		if( result != FR_OK )
+		{
+			log->stats.errors++;
+			return result;
+		}
+
+		log->unsynced = 0;
+		log->stats.syncs++;
+		log->stats.sectorWrites++;
+	}
+
+	return FR_OK;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] log
+ * 		The writer.
+ * @param[in] now
+ * 		The current tick count.
+ * @param[in] timeout
+ * 		Longest time in ticks that an entry may stay in the buffer.
+ * @return
+ * 		1 if buffered entries have waited timeout ticks or more, otherwise 0.
+ ******************************************************************************/
+uint8_t FSW_LOGW_due( const FSW_LOGW_TypeDef *log, portTickType now, portTickType timeout )
+{
+	return ( log->dirty && ( portTickType )( now - log->pendingSince ) >= timeout ) ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function flushes and syncs the buffered entries and closes the ring
+ * file. The control block stays open for the other writers.
+ *
+ * @param[in] log
+ * 		The writer.
+ * @return
+ * 		FR_OK, or the result of the FatFs call that failed.
+ ******************************************************************************/
+FRESULT FSW_LOGW_close( FSW_LOGW_TypeDef *log )
+{
+	FRESULT result;
+
+	if( !log->isOpen )
+	{
+		return FR_OK;
+	}
+
+	FSW_LOGW_flush( log, FSW_LOGW_FLUSH_SYNC );
+
+	result = f_close( &log->file );
+	if( result != FR_OK )
+	{
+		log->stats.errors++;
+	}
+
+	log->isOpen = 0;
+	log->unsynced = 0;
+
+	return result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function pins the sectors that every sync of the log rewrites in the
+ * sector cache: the FATs and root directory of its volume, its directory
+ * entry and that of the control block. Ranges shared with other logs are
+ * pinned once.
+ *
+ * @param[in] log
+ * 		The writer, open.
+ ******************************************************************************/
+void FSW_LOGW_pinMetadata( const FSW_LOGW_TypeDef *log )
+{
+	FATFS *fs = log->file.fs;
+
+	if( !log->isOpen || fs == NULL )
+	{
+		return;
+	}
+
+	DISKCACHE_pin( fs->fatbase, fs->fsize * fs->n_fats );
+	if( fs->fs_type == FS_FAT32 )
+	{
+		DISKCACHE_pin( fs->database + ( fs->dirbase - 2 ) * fs->csize, fs->csize );
+	}
+	else
+	{
+		DISKCACHE_pin( fs->dirbase, fs->n_rootdir / ( FSW_LOGW_SECTOR / 32 ) );
+	}
+	DISKCACHE_pin( log->file.dir_sect, 1 );
+	if( LOGW_cbOpen )
+	{
+		DISKCACHE_pin( LOGW_cbFile.dir_sect, 1 );
+	}
+}
@@ -31,6 +31,8 @@
  ******************************************************************************/
 
 #include "fsw_modes.h"
+#include "fsw_cmdpool.h"
+#include "fsw_memmap.h"
 
 /***************************************************************************//**
  * @addtogroup FSW_Library
@@ -97,7 +99,24 @@ static uint8_t FSW_MODES_mode = 1;
 static void FSW_MODES_reportHealthStatus( void );
 
 static void FSW_MODES_manager( void *pvParameters );		///< Processes and executes commands on the ADCS command queue
-static void FSW_MODES_SatModeMan( void *pvParameters );		///<
+static portSTACK_TYPE FSW_MODES_managerStack[ FSW_STACK_MODES ];
+
+static void FSW_MODES_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_MODES_CMDstateEvent( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_MODES_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,							NULL,					0,	0				},		// 0x00
+		{ FSW_MODES_CMDreportHealth,	&FSW_MODES_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Report module health
+		{ NULL,							NULL,					0,	0				},		// 0x02
+		{ FSW_MODES_CMDstateEvent,		&FSW_MODES_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x03 Process a state event
+		{ NULL,							NULL,					0,	0				},		// 0x04
+		{ NULL,							NULL,					0,	0				},		// 0x05
+		{ NULL,							NULL,					0,	0				},		// 0x06
+		{ NULL,							NULL,					0,	0				}		// 0x07
+};
+/*************************************************************************************************************************************/
 
 
 // FUNCTIONS *************************************************************************************************************************
@@ -113,7 +132,7 @@ void FSW_MODES_Init( void )
 {
 	current_state = DETUMBLING_MODE;
 
-	FSW_MODES_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_MODES_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
 
 	if( FSW_MODES_CMDqueue == NULL )
 	{
@@ -122,8 +141,7 @@ void FSW_MODES_Init( void )
 	}
 	else
 	{
-		xTaskCreate( FSW_MODES_manager, "MODESmanager", 240, NULL, 1, NULL );
-		xTaskCreate( FSW_MODES_SatModeMan, "HANDH_SatModeMan", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_MODES_manager, "MODESmanager", FSW_MODES_managerStack, NULL, 1 );
 
 		FSW_MODES_MSV = 0;
 		FSW_MODES_mode = 1;
@@ -138,7 +156,7 @@ void Detumble_proc ( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x02;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 // No TCMDS during detumbling
@@ -154,7 +172,7 @@ void Safe_proc ( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x03;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 // User command to enter nominal mode
@@ -164,7 +182,7 @@ void Safe_cmdCHANGE ( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x03;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 // Satellite reaches time when it should orientate for communication
@@ -174,7 +192,7 @@ void Nominal_proc ( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x04;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 // No user commands can be received during nominal mode (no downlink)
@@ -190,7 +208,7 @@ void Link_proc ( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x03;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 // TCMD to end communication orientation
@@ -223,7 +241,7 @@ void MODE_safe( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x02;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 void MODE_nominal( void )
@@ -232,7 +250,7 @@ void MODE_nominal( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x03;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 static void MODE_link( void )
@@ -241,7 +259,7 @@ static void MODE_link( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x04;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 static void MODE_erp( void )
@@ -250,7 +268,7 @@ static void MODE_erp( void )
 
 	// Send message to MatLab to print the mode change
 	sim_Data.params[0] = 0x05;
-	xQueueSendToBack( FSW_CDH_CMDqueue, &sim_Data, 0 );
+	FSW_CMDPOOL_send( FSW_CDH_CMDqueue, &sim_Data, 0 );
 }
 
 /***************************************************************************//**
@@ -274,6 +292,31 @@ static void FSW_MODES_reportHealthStatus( void )
 }
 
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the modes module's entries in the routing table.
+ * They run in the FSW_MODES_manager task.
+ ******************************************************************************/
+
+static void FSW_MODES_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_MODES_reportHealthStatus();
+}
+
+static void FSW_MODES_CMDstateEvent( const CDH_CMD_TypeDef *CMD )
+{
+	if( CMD->params[0] < MAX_EVENTS )
+	{
+		state_table [current_state][CMD->params[0]] (); 			/* call the action procedure */
+	}
+	else
+	{
+		FSW_MODES_MSV |= ERROR_CMDINV;
+	}
+}
+
 // TASKS *****************************************************************************************************************************
 
 /***************************************************************************//**
@@ -287,27 +330,18 @@ static void FSW_MODES_reportHealthStatus( void )
 static void FSW_MODES_manager( void *pvParameters )
 {
 	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_MODES_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_MODES_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch(ReceivedCMD.id)
+			// Runs the handler listed in FSW_MODES_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:															// Report module health
-				FSW_MODES_reportHealthStatus();
-				break;
-
-			case 0x03:															// Process a state event
-				state_table [current_state][ReceivedCMD.params[0]] (); 			/* call the action procedure */
-				break;
-
-			default:
-				FSW_MODES_MSV &= ERROR_CMDINV;
-				break;
+				FSW_MODES_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
@@ -320,78 +354,82 @@ static void FSW_MODES_manager( void *pvParameters )
  * @author Andre Heunis
  * @date   29/10/2013
  *
- * Task to manage mode actions and mode transitions for the entire satellite.
+ * Job to manage mode actions and mode transitions for the entire satellite,
+ * released every second by the periodic task schedule. A mode that lasts
+ * several seconds counts the periods it has been in, so no mode blocks the
+ * job or keeps it running.
  ******************************************************************************/
 
-static void FSW_MODES_SatModeMan( void *pvParameters )
+void FSW_MODES_SatModeMan( void )
 {
+	static enum states last_state = MAX_STATES;
+	static uint16_t periods = 0;			// Seconds since the mode was first seen
 	CDH_CMD_TypeDef MODE_change;
+
 	MODE_change.dest = FSW_MODES;
 	MODE_change.id = 0x03;
+	MODE_change.len = 1;
 
-	while(1)
+	if( current_state != last_state )
 	{
-		switch( current_state )
-		{
-		case DETUMBLING_MODE:
-			// check if all subsystems running correctly
-			// check if satellite is stable enough for nominal operation
-			// check power levels are high enough to turn on remaining systems
-			// If above conditions are valid, progress to nominal operation
-
-			vTaskDelay( 1000/portTICK_RATE_MS );
+		last_state = current_state;
+		periods = 0;
+	}
+	else if( periods < 0xFFFF )
+	{
+		periods++;
+	}
 
-			// Progress to safe mode after 1 second
+	switch( current_state )
+	{
+	case DETUMBLING_MODE:
+		// check if all subsystems running correctly
+		// check if satellite is stable enough for nominal operation
+		// check power levels are high enough to turn on remaining systems
+		// If above conditions are valid, progress to nominal operation
+
+		// Progress to safe mode after 1 second
+		if( periods == 1 )
+		{
 			MODE_change.params[0] = 0;
-			xQueueSendToBack( FSW_MODES_CMDqueue, &MODE_change, 0 );
-			break;
-
-		case SAFE_MODE:
-			// Poll transceiver board for received commands
-			// Process any initialization commands or mode change to nominal mode
-			// Change ADCS algorithm to nominal (sun pointing)
-			// Progress to Nominal
-
-			vTaskDelay( 1000/portTICK_RATE_MS );
-
-			break;
-
-		case  NOMINAL_MODE:
-			// Accept any TCMDs
-			// Monitor subsystem status
-			// Enter ERP if subsystem status shows errors
-			// At a certain position (SGP4), enter uplink mode (first check battery power levels)
-
-			vTaskDelay( 5000/portTICK_RATE_MS );
-
-			// Progress to Link mode after 5 seconds
+			FSW_CMDPOOL_send( FSW_MODES_CMDqueue, &MODE_change, 0 );
+		}
+		break;
+
+	case SAFE_MODE:
+		// Poll transceiver board for received commands
+		// Process any initialization commands or mode change to nominal mode
+		// Change ADCS algorithm to nominal (sun pointing)
+		// Progress to Nominal
+		break;
+
+	case  NOMINAL_MODE:
+		// Accept any TCMDs
+		// Monitor subsystem status
+		// Enter ERP if subsystem status shows errors
+		// At a certain position (SGP4), enter uplink mode (first check battery power levels)
+
+		// Progress to Link mode after 5 seconds
+		if( periods == 5 )
+		{
 			MODE_change.params[0] = 2;
-			xQueueSendToBack( FSW_MODES_CMDqueue, &MODE_change, 0 );
-			break;
-
-		case LINK_MODE:
-			// High priority task running to accept data uplinked from the GS
-			// Enter ERP if subsystem status shows errors
-			// At a certain position (SGP4) or due to TCMD to end link, transfer to Nominal
-
-			vTaskDelay( 1000/portTICK_RATE_MS );
-
-			break;
-
-		case ERP_MODE:
-			// Run particular ERP for a detected error
-			// Reject all non-ERP commands (remember to log that a command was missed)
-			// Enter safe mode once procedure is complete
-
-
-			break;
-
-		default:
-
-			break;
+			FSW_CMDPOOL_send( FSW_MODES_CMDqueue, &MODE_change, 0 );
 		}
+		break;
+
+	case LINK_MODE:
+		// High priority task running to accept data uplinked from the GS
+		// Enter ERP if subsystem status shows errors
+		// At a certain position (SGP4) or due to TCMD to end link, transfer to Nominal
+		break;
+
+	case ERP_MODE:
+		// Run particular ERP for a detected error
+		// Reject all non-ERP commands (remember to log that a command was missed)
+		// Enter safe mode once procedure is complete
+		break;
+
+	default:
+		break;
 	}
-
-	// Delete the task if it ever breaks out of the loop above
-	vTaskDelete( NULL );
 }
@@ -29,6 +29,7 @@
 
 // for printing
 #include "comms.h"
+#include "fsw_memmap.h"
 
 #define CMD_Qlen	6
 
@@ -36,6 +37,9 @@
 #define ERROR_INIT 		0x01		///< Module initialization error.
 #define ERROR_CMDINV 	0x02		///< Invalid command received.
 
+/// Satellite modes in which the payload may be switched. Not while detumbling or in ERP.
+#define PAYLOAD_CMDMODES	( CDH_MODE(SAFE_MODE) | CDH_MODE(NOMINAL_MODE) | CDH_MODE(LINK_MODE) )
+
 /***************************************************************************//**
  * @addtogroup FSW_Library
  * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
@@ -55,6 +59,28 @@ static void FSW_PAYLOAD_reportHealthStatus( void );		///< Reports the subsystem'
 static void FSW_PAYLOAD_modeChange( uint8_t newMode );	///< Changes the module's mode and runs associated procedures
 
 static void FSW_PAYLOAD_manager( void *pvParameters );	///< Payload subsystem manager
+static portSTACK_TYPE FSW_PAYLOAD_managerStack[ FSW_STACK_PAYLOAD ];
+
+static void FSW_PAYLOAD_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_PAYLOAD_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+static void FSW_PAYLOAD_CMDimageStart( const CDH_CMD_TypeDef *CMD );
+static void FSW_PAYLOAD_CMDimageResume( const CDH_CMD_TypeDef *CMD );
+static void FSW_PAYLOAD_CMDimageAbort( const CDH_CMD_TypeDef *CMD );
+static void FSW_PAYLOAD_CMDimageStatus( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_PAYLOAD_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,								NULL,					0,	0					},		// 0x00
+		{ FSW_PAYLOAD_CMDreportHealth,		&FSW_PAYLOAD_CMDqueue,	0,	CDH_MODES_ALL		},		// 0x01 Report the health of this subsystem
+		{ FSW_PAYLOAD_CMDmodeChange,		&FSW_PAYLOAD_CMDqueue,	1,	PAYLOAD_CMDMODES	},		// 0x02 Change the module's mode
+		{ FSW_PAYLOAD_CMDimageStart,		&FSW_PAYLOAD_CMDqueue,	1,	PAYLOAD_CMDMODES	},		// 0x03 Download a CubeSense image: camera | size << 8
+		{ FSW_PAYLOAD_CMDimageResume,		&FSW_PAYLOAD_CMDqueue,	0,	PAYLOAD_CMDMODES	},		// 0x04 Resume the image download recorded on the card
+		{ FSW_PAYLOAD_CMDimageAbort,		&FSW_PAYLOAD_CMDqueue,	0,	CDH_MODES_ALL		},		// 0x05 Abort the image download
+		{ FSW_PAYLOAD_CMDimageStatus,		&FSW_PAYLOAD_CMDqueue,	0,	CDH_MODES_ALL		},		// 0x06 Transmit the image download progress over UART
+		{ NULL,								NULL,					0,	0					}		// 0x07
+};
+/*************************************************************************************************************************************/
 
 // FUNCTIONS *************************************************************************************************************************
 
@@ -68,7 +94,7 @@ static void FSW_PAYLOAD_manager( void *pvParameters );	///< Payload subsystem ma
 
 void FSW_PAYLOAD_Init( void )
 {
-	FSW_PAYLOAD_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_PAYLOAD_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
 
 	if( FSW_PAYLOAD_CMDqueue == NULL )
 	{
@@ -77,7 +103,8 @@ void FSW_PAYLOAD_Init( void )
 	}
 	else
 	{
-		xTaskCreate( FSW_PAYLOAD_manager, "PAYLOADmanager", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_PAYLOAD_manager, "PAYLOADmanager", FSW_PAYLOAD_managerStack, NULL, 1 );
+		FSW_IMG_Init( FSW_COMM_I2Cqueue );
 
 		FSW_PAYLOAD_MSV = 0;
 		FSW_PAYLOAD_mode = 1;
@@ -95,18 +122,13 @@ void FSW_PAYLOAD_Init( void )
 
 static void FSW_PAYLOAD_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_PAYLOAD_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_PAYLOAD_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_PAYLOAD_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_PAYLOAD_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -142,6 +164,69 @@ static void FSW_PAYLOAD_modeChange( uint8_t newMode )
 	}
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the payload module's entries in the routing table.
+ * They run in the FSW_PAYLOAD_manager task.
+ ******************************************************************************/
+
+static void FSW_PAYLOAD_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_PAYLOAD_reportHealthStatus();
+}
+
+static void FSW_PAYLOAD_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_PAYLOAD_modeChange( (uint8_t)CMD->params[0] );
+}
+
+static void FSW_PAYLOAD_CMDimageStart( const CDH_CMD_TypeDef *CMD )
+{
+	if( !FSW_IMG_start( (uint8_t)CMD->params[0], (uint8_t)( CMD->params[0] >> 8 ) ) )
+	{
+		FSW_PAYLOAD_MSV |= ERROR_CMDINV;
+	}
+}
+
+static void FSW_PAYLOAD_CMDimageResume( const CDH_CMD_TypeDef *CMD )
+{
+	if( !FSW_IMG_resume() )
+	{
+		FSW_PAYLOAD_MSV |= ERROR_CMDINV;
+	}
+}
+
+static void FSW_PAYLOAD_CMDimageAbort( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_IMG_abort();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Transmits the image download state, frames stored, frames in the image,
+ * frames per second of the last run and total download time in ms.
+ ******************************************************************************/
+
+static void FSW_PAYLOAD_CMDimageStatus( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_IMG_Stats_TypeDef stats;
+	uint8_t report[17];
+
+	FSW_IMG_getStats( &stats );
+
+	addToBuffer_uint8 ( &(report[0]), stats.state );
+	addToBuffer_uint32( &(report[1]), stats.nextFrame );
+	addToBuffer_uint32( &(report[5]), stats.frames );
+	addToBuffer_uint32( &(report[9]), stats.framesPerSec );
+	addToBuffer_uint32( &(report[13]), stats.totalTicks * portTICK_RATE_MS );
+
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 17, false);
+}
+
 // TASKS *****************************************************************************************************************************
 
 /***************************************************************************//**
@@ -155,28 +240,18 @@ static void FSW_PAYLOAD_modeChange( uint8_t newMode )
 static void FSW_PAYLOAD_manager( void *pvParameters )
 {
 	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_PAYLOAD_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_PAYLOAD_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch(ReceivedCMD.id)
+			// Runs the handler listed in FSW_PAYLOAD_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:
-				FSW_PAYLOAD_reportHealthStatus();
-				break;
-
-			case 0x02:
-				FSW_PAYLOAD_modeChange( (uint8_t)ReceivedCMD.params[0] );
-				break;
-
-			default:
-				FSW_PAYLOAD_MSV &= ERROR_CMDINV;
-				while(1);
-				break;
+				FSW_PAYLOAD_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
@@ -0,0 +1,231 @@
+/***************************************************************************//**
+ * @file	fsw_periodic.c
+ * @brief	FSW periodic task schedule source file.
+ *
+ * Every periodic job of the flight software is listed in FSW_PERIODIC_table
+ * and run by a task of its own, created from the table. The task releases the
+ * job with vTaskDelayUntil on a grid of ticks that starts with the scheduler,
+ * so a late or long period never shifts the later ones, and a job that
+ * overruns is released again at once until it has caught up.
+ *
+ * Priorities are rate monotonic, so a job is only ever delayed by jobs that
+ * run more often and by interrupts. The command and data managers, which
+ * block on their queues, run below every periodic job.
+ *
+ * Each release is timed on the RTC from its tick on the grid: the start
+ * jitter, how long after the tick the job starts, and the response, how long
+ * after it the job finishes. A response past the deadline is a miss. Both are
+ * exact to an RTC count, 30.5 us.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "fsw_periodic.h"
+#include "fsw_memmap.h"
+#include "fsw_adcs.h"
+#include "fsw_comm.h"
+#include "fsw_healthandhousekeeping.h"
+#include "fsw_modes.h"
+#include "bsp_sleep.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the periodic task schedule.
+ * @{
+ ******************************************************************************/
+
+// Stacks of the jobs, one array each so the map file shows every job's stack
+static portSTACK_TYPE FSW_PERIODIC_hkStack[ FSW_STACK_HANDH_HK ];
+static portSTACK_TYPE FSW_PERIODIC_satModeStack[ FSW_STACK_SATMODEMAN ];
+static portSTACK_TYPE FSW_PERIODIC_adcsStack[ FSW_STACK_ADCSEXE ];
+#ifdef HIL_sim
+static portSTACK_TYPE FSW_PERIODIC_pollUARTStack[ FSW_STACK_POLLUART ];
+static portSTACK_TYPE FSW_PERIODIC_tlmStreamStack[ FSW_STACK_TLMSTREAM ];
+#endif
+
+/*SCHEDULE TABLE**********************************************************************************************************************/
+// Jobs released on the same tick at the same priority run in the order listed
+static const FSW_PERIODIC_Task_TypeDef FSW_PERIODIC_table[] = {
+
+		// job						name			period	deadline	priority				stack							stack depth
+		{ FSW_HANDH_HKexe,			"HANDH_HK",		1000,	100,		FSW_PERIODIC_PRIO_1S,	FSW_PERIODIC_hkStack,			FSW_STACK_HANDH_HK		},		// Housekeeping sample and telemetry
+		{ FSW_MODES_SatModeMan,		"SatModeMan",	1000,	100,		FSW_PERIODIC_PRIO_1S,	FSW_PERIODIC_satModeStack,		FSW_STACK_SATMODEMAN	},		// Satellite mode transitions
+		{ FSW_ADCS_ADCSexe,			"ADCSexe",		1000,	500,		FSW_PERIODIC_PRIO_1S,	FSW_PERIODIC_adcsStack,			FSW_STACK_ADCSEXE		},		// ADCS algorithms
+#ifdef HIL_sim
+		{ FSW_COMM_pollUART,		"PollUART",		1000,	500,		FSW_PERIODIC_PRIO_1S,	FSW_PERIODIC_pollUARTStack,		FSW_STACK_POLLUART		},		// Requests from the simulation
+		{ FSW_HANDH_TLMstream,		"TLMstream",	3000,	1000,		FSW_PERIODIC_PRIO_SLOW,	FSW_PERIODIC_tlmStreamStack,	FSW_STACK_TLMSTREAM		},		// Real-time telemetry stream
+#endif
+};
+
+#define FSW_PERIODIC_COUNT	( sizeof( FSW_PERIODIC_table ) / sizeof( FSW_PERIODIC_table[0] ) )
+/*************************************************************************************************************************************/
+
+static FSW_PERIODIC_Stats_TypeDef FSW_PERIODIC_stats[FSW_PERIODIC_COUNT];
+
+static void FSW_PERIODIC_task( void *pvParameters );			///< Releases one job of the schedule table
+static uint32_t FSW_PERIODIC_sinceRelease( portTickType release );
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function creates a task for every job in the schedule table. Every
+ * job is first released as the scheduler starts. It is called after every
+ * module is initialised, as the jobs use their queues.
+ ******************************************************************************/
+void FSW_PERIODIC_Init( void )
+{
+	uint8_t i;
+
+	for( i = 0; i < FSW_PERIODIC_COUNT; i++ )
+	{
+		FSW_PERIODIC_stats[i].releases = 0;
+		FSW_PERIODIC_stats[i].misses = 0;
+		FSW_PERIODIC_stats[i].worstJitterUs = 0;
+		FSW_PERIODIC_stats[i].worstResponseUs = 0;
+
+		// The table holds the stack's depth, as FSW_TASK_CREATE cannot size it through a pointer
+		xTaskGenericCreate( FSW_PERIODIC_task, ( const signed char * )FSW_PERIODIC_table[i].name, FSW_PERIODIC_table[i].stackDepth,
+				( void * )&FSW_PERIODIC_table[i], FSW_PERIODIC_table[i].priority, NULL, FSW_PERIODIC_table[i].stack, NULL );
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @return
+ * 		Number of jobs in the schedule table.
+ ******************************************************************************/
+uint8_t FSW_PERIODIC_count( void )
+{
+	return ( uint8_t )FSW_PERIODIC_COUNT;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the timing of a job.
+ *
+ * @param[in] task
+ * 		Position of the job in the schedule table.
+ * @param[out] stats
+ * 		Copy of the job's timing, zero for a position past the table.
+ ******************************************************************************/
+void FSW_PERIODIC_getStats( uint8_t task, FSW_PERIODIC_Stats_TypeDef *stats )
+{
+	if( task >= FSW_PERIODIC_COUNT )
+	{
+		stats->releases = 0;
+		stats->misses = 0;
+		stats->worstJitterUs = 0;
+		stats->worstResponseUs = 0;
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	*stats = FSW_PERIODIC_stats[task];
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Microseconds since the grid time of tick release. The tick count and the
+ * RTC are read together, so no tick is counted in between.
+ */
+static uint32_t FSW_PERIODIC_sinceRelease( portTickType release )
+{
+	portTickType now;
+	uint32_t counts;
+
+	taskENTER_CRITICAL();
+	now = xTaskGetTickCount();
+	counts = BSP_SLEEP_sinceTick();
+	taskEXIT_CRITICAL();
+
+	// 1000000/32768 = 15625/512, exact
+	return ( uint32_t )( now - release ) * portTICK_RATE_MS * 1000 + ( counts * 15625 ) / 512;
+}
+
+// TASKS *****************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Task to release a job of the schedule table every period, timing each
+ * release.
+ *
+ * @param[in] pvParameters
+ * 		The job's entry in the schedule table.
+ ******************************************************************************/
+static void FSW_PERIODIC_task( void *pvParameters )
+{
+	const FSW_PERIODIC_Task_TypeDef *task = ( const FSW_PERIODIC_Task_TypeDef * )pvParameters;
+	FSW_PERIODIC_Stats_TypeDef *stats = &FSW_PERIODIC_stats[task - FSW_PERIODIC_table];
+	portTickType release, period;
+	uint32_t start, finish;
+
+	period = task->periodMs / portTICK_RATE_MS;
+
+	// The first release is the tick the scheduler started on
+	release = 0;
+	start = FSW_PERIODIC_sinceRelease( release );
+
+	while(1)
+	{
+		task->job();
+		finish = FSW_PERIODIC_sinceRelease( release );
+
+		taskENTER_CRITICAL();
+		stats->releases++;
+		if( start > stats->worstJitterUs )
+		{
+			stats->worstJitterUs = start;
+		}
+		if( finish > stats->worstResponseUs )
+		{
+			stats->worstResponseUs = finish;
+		}
+		if( finish > ( uint32_t )task->deadlineMs * 1000 )
+		{
+			stats->misses++;
+		}
+		taskEXIT_CRITICAL();
+
+		// Moves release on a period, and returns at once if that tick has passed
+		vTaskDelayUntil( &release, period );
+		start = FSW_PERIODIC_sinceRelease( release );
+	}
+
+	// Delete the task if it ever breaks out of the loop above
+	vTaskDelete( NULL );
+}
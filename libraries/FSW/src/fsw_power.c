@@ -29,6 +29,7 @@
 
 // for printing
 #include "comms.h"
+#include "fsw_memmap.h"
 
 #define CMD_Qlen	6
 
@@ -57,6 +58,26 @@ static void FSW_POWER_checkSC( void );					///< Test functions for receiving com
 static void FSW_POWER_readVI( void );
 
 static void FSW_POWER_manager( void *pvParameters );	///< Subsystem manager for the power module
+static portSTACK_TYPE FSW_POWER_managerStack[ FSW_STACK_POWER ];
+
+static void FSW_POWER_CMDreportHealth( const CDH_CMD_TypeDef *CMD );
+static void FSW_POWER_CMDmodeChange( const CDH_CMD_TypeDef *CMD );
+static void FSW_POWER_CMDcheckSC( const CDH_CMD_TypeDef *CMD );
+static void FSW_POWER_CMDreadVI( const CDH_CMD_TypeDef *CMD );
+
+/*ROUTING TABLE***********************************************************************************************************************/
+const CDH_Route_TypeDef FSW_POWER_routes[CDH_ROUTE_IDCOUNT] = {
+
+		{ NULL,							NULL,					0,	0				},		// 0x00
+		{ FSW_POWER_CMDreportHealth,	&FSW_POWER_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x01 Report the health of this subsystem
+		{ FSW_POWER_CMDmodeChange,		&FSW_POWER_CMDqueue,	1,	CDH_MODES_ALL	},		// 0x02 Change the module's mode
+		{ FSW_POWER_CMDcheckSC,			&FSW_POWER_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x03 Test CMD
+		{ FSW_POWER_CMDreadVI,			&FSW_POWER_CMDqueue,	0,	CDH_MODES_ALL	},		// 0x04 Test CMD
+		{ NULL,							NULL,					0,	0				},		// 0x05
+		{ NULL,							NULL,					0,	0				},		// 0x06
+		{ NULL,							NULL,					0,	0				}		// 0x07
+};
+/*************************************************************************************************************************************/
 
 // FUNCTIONS *************************************************************************************************************************
 
@@ -70,7 +91,7 @@ static void FSW_POWER_manager( void *pvParameters );	///< Subsystem manager for
 
 void FSW_POWER_Init( void )
 {
-	FSW_POWER_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMD_TypeDef ) );
+	FSW_POWER_CMDqueue = xQueueCreate( CMD_Qlen, sizeof( CDH_CMDhandle_TypeDef ) );
 
 	// Periodically sends subsystem commands to the command queue.
 	if( FSW_POWER_CMDqueue == NULL )
@@ -79,7 +100,7 @@ void FSW_POWER_Init( void )
 	}
 	else
 	{
-		xTaskCreate( FSW_POWER_manager, "POWERmanager", 240, NULL, 1, NULL );
+		FSW_TASK_CREATE( FSW_POWER_manager, "POWERmanager", FSW_POWER_managerStack, NULL, 1 );
 
 		FSW_POWER_MSV = 0;
 		FSW_POWER_mode = 1;
@@ -97,18 +118,13 @@ void FSW_POWER_Init( void )
 
 static void FSW_POWER_reportHealthStatus( void )
 {
-	addToBuffer_uint8 ( &(uartTxBuffer[0]), FSW_POWER_mode );
-	addToBuffer_uint8 ( &(uartTxBuffer[1]), FSW_POWER_MSV );
+	uint8_t report[2];
+
+	addToBuffer_uint8 ( &(report[0]), FSW_POWER_mode );
+	addToBuffer_uint8 ( &(report[1]), FSW_POWER_MSV );
 
 	// Transmit the 2 values
-	if( !BSP_UART_txInProgress() )
-	{
-		BSP_UART_txBuffer(BSP_UART_DEBUG, uartTxBuffer, 2, true);
-	}
-	else
-	{
-		while(1);
-	}
+	BSP_UART_txBuffer(BSP_UART_DEBUG, report, 2, false);
 }
 
 /***************************************************************************//**
@@ -161,6 +177,34 @@ static void FSW_POWER_readVI( void )
 	printString("Power module: Reading power levels\n");
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Command handlers for the power module's entries in the routing table.
+ * They run in the FSW_POWER_manager task.
+ ******************************************************************************/
+
+static void FSW_POWER_CMDreportHealth( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_POWER_reportHealthStatus();
+}
+
+static void FSW_POWER_CMDmodeChange( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_POWER_modeChange( (uint8_t)CMD->params[0] );
+}
+
+static void FSW_POWER_CMDcheckSC( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_POWER_checkSC();
+}
+
+static void FSW_POWER_CMDreadVI( const CDH_CMD_TypeDef *CMD )
+{
+	FSW_POWER_readVI();
+}
+
 // TASKS *****************************************************************************************************************************
 
 /***************************************************************************//**
@@ -174,35 +218,18 @@ static void FSW_POWER_readVI( void )
 void FSW_POWER_manager( void *pvParameters )
 {
 	portBASE_TYPE Status;
-	CDH_CMD_TypeDef ReceivedCMD;
+	CDH_CMDhandle_TypeDef ReceivedHandle;
 
 	while(1)
 	{
-		Status = xQueueReceive( FSW_POWER_CMDqueue, &ReceivedCMD, portMAX_DELAY );
+		Status = xQueueReceive( FSW_POWER_CMDqueue, &ReceivedHandle, portMAX_DELAY );
 
 		if(Status == pdPASS)
 		{
-			switch(ReceivedCMD.id)
+			// Runs the handler listed in FSW_POWER_routes and releases the command
+			if( FSW_CDH_execute( ReceivedHandle ) != CDH_CMDERR_NONE )
 			{
-			case 0x01:
-				FSW_POWER_reportHealthStatus();
-				break;
-
-			case 0x02:
-				FSW_POWER_modeChange( (uint8_t)ReceivedCMD.params[0] );
-				break;
-
-			case 0x03:
-				FSW_POWER_checkSC();
-				break;
-
-			case 0x04:
-				FSW_POWER_readVI();
-				break;
-
-			default:
-				FSW_POWER_MSV &= ERROR_CMDINV;
-				break;
+				FSW_POWER_MSV |= ERROR_CMDINV;
 			}
 		}
 	}
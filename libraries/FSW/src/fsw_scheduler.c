@@ -0,0 +1,291 @@
+/***************************************************************************//**
+ * @file	fsw_scheduler.c
+ * @brief	FSW time-tagged command scheduler source file.
+ *
+ * A fixed capacity scheduler for time-tagged commands. Commands are held in a
+ * static pool of slots and ordered by execution time in a binary min-heap of
+ * slot indices, giving O(log n) insert and cancel and O(1) access to the next
+ * command due. Each slot records its heap position so a command can be
+ * cancelled by handle without searching.
+ *
+ * The scheduler does no locking and knows nothing of timers; the C&DH module
+ * serialises access and drives a single software timer from FSW_SCHED_peek().
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "fsw_scheduler.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the Command and Data Handling module.
+ * @{
+ ******************************************************************************/
+
+static uint8_t FSW_SCHED_before( const FSW_SCHED_TypeDef *sched, uint16_t a, uint16_t b );
+static void FSW_SCHED_place( FSW_SCHED_TypeDef *sched, uint16_t pos, uint16_t slot );
+static uint16_t FSW_SCHED_siftUp( FSW_SCHED_TypeDef *sched, uint16_t pos );
+static void FSW_SCHED_siftDown( FSW_SCHED_TypeDef *sched, uint16_t pos );
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function initialises an empty scheduler over storage provided by the
+ * caller. All three arrays must hold capacity entries.
+ *
+ * @param[in] sched
+ * 		Scheduler to initialise.
+ * @param[in] pool
+ * 		Command slots.
+ * @param[in] heap
+ * 		Heap storage.
+ * @param[in] freeSlots
+ * 		Free slot stack storage.
+ * @param[in] capacity
+ * 		Number of commands that can be scheduled, less than FSW_SCHED_NONE.
+ ******************************************************************************/
+void FSW_SCHED_Init( FSW_SCHED_TypeDef *sched, FSW_SCHED_Entry_TypeDef *pool, uint16_t *heap, uint16_t *freeSlots, uint16_t capacity )
+{
+	uint16_t i;
+
+	sched->pool = pool;
+	sched->heap = heap;
+	sched->freeSlots = freeSlots;
+	sched->capacity = capacity;
+	sched->count = 0;
+	sched->seq = 0;
+
+	// Hand out low slots first
+	for( i = 0; i < capacity; i++ )
+	{
+		pool[i].heapIndex = FSW_SCHED_NONE;
+		freeSlots[i] = capacity - 1 - i;
+	}
+	sched->freeCount = capacity;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function adds a command to the schedule.
+ *
+ * @param[in] sched
+ * 		The scheduler.
+ * @param[in] CMD
+ * 		The command to schedule. exe_time is the OBC time it is due at.
+ * @return
+ * 		Handle of the scheduled command, or FSW_SCHED_NONE if the schedule is full.
+ ******************************************************************************/
+uint16_t FSW_SCHED_insert( FSW_SCHED_TypeDef *sched, const CDH_CMD_TypeDef *CMD )
+{
+	uint16_t slot;
+
+	if( sched->freeCount == 0 )
+	{
+		return FSW_SCHED_NONE;
+	}
+
+	slot = sched->freeSlots[--sched->freeCount];
+	sched->pool[slot].CMD = *CMD;
+	sched->pool[slot].seq = sched->seq++;
+
+	FSW_SCHED_place( sched, sched->count, slot );
+	FSW_SCHED_siftUp( sched, sched->count++ );
+
+	return slot;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function removes a scheduled command.
+ *
+ * @param[in] sched
+ * 		The scheduler.
+ * @param[in] handle
+ * 		Handle returned by FSW_SCHED_insert().
+ * @return
+ * 		1 if the command was removed, 0 if the handle is not scheduled.
+ ******************************************************************************/
+uint8_t FSW_SCHED_cancel( FSW_SCHED_TypeDef *sched, uint16_t handle )
+{
+	uint16_t pos, last;
+
+	if( handle >= sched->capacity || sched->pool[handle].heapIndex == FSW_SCHED_NONE )
+	{
+		return 0;
+	}
+
+	pos = sched->pool[handle].heapIndex;
+	last = sched->heap[--sched->count];
+
+	// Move the last heap entry into the hole and restore the heap order
+	if( pos != sched->count )
+	{
+		FSW_SCHED_place( sched, pos, last );
+		if( FSW_SCHED_siftUp( sched, pos ) == pos )
+		{
+			FSW_SCHED_siftDown( sched, pos );
+		}
+	}
+
+	sched->pool[handle].heapIndex = FSW_SCHED_NONE;
+	sched->freeSlots[sched->freeCount++] = handle;
+
+	return 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @param[in] sched
+ * 		The scheduler.
+ * @return
+ * 		The command with the earliest execution time, or NULL if none is
+ * 		scheduled. Valid until the schedule is next modified.
+ ******************************************************************************/
+const CDH_CMD_TypeDef *FSW_SCHED_peek( const FSW_SCHED_TypeDef *sched )
+{
+	if( sched->count == 0 )
+	{
+		return NULL;
+	}
+
+	return &sched->pool[sched->heap[0]].CMD;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function removes and returns the earliest command if it is due. Due
+ * commands are returned in execution time order, and in the order they were
+ * scheduled when their execution times are equal.
+ *
+ * @param[in] sched
+ * 		The scheduler.
+ * @param[in] now
+ * 		Current OBC time.
+ * @param[out] CMD
+ * 		Receives the due command.
+ * @return
+ * 		1 if a command was returned, 0 if no command is due.
+ ******************************************************************************/
+uint8_t FSW_SCHED_popDue( FSW_SCHED_TypeDef *sched, uint32_t now, CDH_CMD_TypeDef *CMD )
+{
+	uint16_t slot;
+
+	if( sched->count == 0 )
+	{
+		return 0;
+	}
+
+	slot = sched->heap[0];
+	if( sched->pool[slot].CMD.exe_time > now )
+	{
+		return 0;
+	}
+
+	*CMD = sched->pool[slot].CMD;
+	FSW_SCHED_cancel( sched, slot );
+
+	return 1;
+}
+
+/*
+ * Heap order: earlier execution time first, then earlier insertion.
+ */
+static uint8_t FSW_SCHED_before( const FSW_SCHED_TypeDef *sched, uint16_t a, uint16_t b )
+{
+	const FSW_SCHED_Entry_TypeDef *ea = &sched->pool[a];
+	const FSW_SCHED_Entry_TypeDef *eb = &sched->pool[b];
+
+	if( ea->CMD.exe_time != eb->CMD.exe_time )
+	{
+		return ea->CMD.exe_time < eb->CMD.exe_time;
+	}
+
+	return (int32_t)( ea->seq - eb->seq ) < 0;
+}
+
+static void FSW_SCHED_place( FSW_SCHED_TypeDef *sched, uint16_t pos, uint16_t slot )
+{
+	sched->heap[pos] = slot;
+	sched->pool[slot].heapIndex = pos;
+}
+
+/*
+ * Returns the final position of the entry.
+ */
+static uint16_t FSW_SCHED_siftUp( FSW_SCHED_TypeDef *sched, uint16_t pos )
+{
+	uint16_t slot = sched->heap[pos];
+	uint16_t parent;
+
+	while( pos > 0 )
+	{
+		parent = ( pos - 1 ) / 2;
+		if( !FSW_SCHED_before( sched, slot, sched->heap[parent] ) )
+		{
+			break;
+		}
+		FSW_SCHED_place( sched, pos, sched->heap[parent] );
+		pos = parent;
+	}
+	FSW_SCHED_place( sched, pos, slot );
+
+	return pos;
+}
+
+static void FSW_SCHED_siftDown( FSW_SCHED_TypeDef *sched, uint16_t pos )
+{
+	uint16_t slot = sched->heap[pos];
+	uint32_t child;
+
+	while( ( child = 2 * (uint32_t)pos + 1 ) < sched->count )
+	{
+		if( child + 1 < sched->count && FSW_SCHED_before( sched, sched->heap[child + 1], sched->heap[child] ) )
+		{
+			child++;
+		}
+		if( !FSW_SCHED_before( sched, sched->heap[child], slot ) )
+		{
+			break;
+		}
+		FSW_SCHED_place( sched, pos, sched->heap[child] );
+		pos = child;
+	}
+	FSW_SCHED_place( sched, pos, slot );
+}
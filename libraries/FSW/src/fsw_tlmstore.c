@@ -0,0 +1,151 @@
+/***************************************************************************//**
+ * @file	fsw_tlmstore.c
+ * @brief	FSW telemetry store source file.
+ *
+ * This file contains the telemetry snapshot table and its publish and read
+ * functions.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "fsw_tlmstore.h"
+
+/***************************************************************************//**
+ * @addtogroup FSW_Library
+ * @brief Flight Software (<b>FSW</b>) Module Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup C&DH
+ * @brief API for the telemetry store.
+ * @{
+ ******************************************************************************/
+
+/// Orders the buffer accesses against the update count, for the compiler and the core.
+#define TLM_BARRIER()		__sync_synchronize()
+
+/// Every telemetry ID's latest value. Zeroed at startup, which reads as empty.
+static FSW_TLM_Entry_TypeDef FSW_TLM_store[FSW_TLM_IDCOUNT];
+
+// FUNCTIONS *************************************************************************************************************************
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function publishes a new value for a telemetry ID. It is written to the
+ * buffer readers are not using, and becomes the latest once it is complete.
+ * Only the ID's producer may call it, and never from an interrupt handler.
+ *
+ * @param[in] id
+ * 		Telemetry ID.
+ * @param[in] data
+ * 		The value.
+ * @param[in] len
+ * 		Bytes of the value, up to FSW_TLM_MAXLEN.
+ * @return
+ * 		1 on success, 0 for an ID outside the store or a value too long.
+ ******************************************************************************/
+uint8_t FSW_TLM_publish( uint8_t id, const void *data, uint8_t len )
+{
+	FSW_TLM_Entry_TypeDef *entry;
+	uint32_t next;
+
+	if( ( uint8_t )( id - FSW_TLM_IDBASE ) >= FSW_TLM_IDCOUNT || len > FSW_TLM_MAXLEN )
+	{
+		return 0;
+	}
+
+	entry = &FSW_TLM_store[id - FSW_TLM_IDBASE];
+	next = entry->published + 1;
+	memcpy( entry->data[next & 1], data, len );
+	entry->len[next & 1] = len;
+	TLM_BARRIER();
+	entry->published = next;
+
+	return 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies out the latest value of a telemetry ID. In an
+ * interrupt handler no producer can run while it copies, so it copies once;
+ * in a task it copies again if a producer published in the meantime.
+ *
+ * @param[in] id
+ * 		Telemetry ID.
+ * @param[out] data
+ * 		The value, FSW_TLM_MAXLEN bytes long.
+ * @return
+ * 		Bytes of the value, 0 if the ID is outside the store or has not been
+ * 		published.
+ ******************************************************************************/
+uint8_t FSW_TLM_read( uint8_t id, uint8_t *data )
+{
+	const FSW_TLM_Entry_TypeDef *entry;
+	uint32_t published;
+	uint8_t len;
+
+	if( ( uint8_t )( id - FSW_TLM_IDBASE ) >= FSW_TLM_IDCOUNT )
+	{
+		return 0;
+	}
+
+	entry = &FSW_TLM_store[id - FSW_TLM_IDBASE];
+	do
+	{
+		published = entry->published;
+		TLM_BARRIER();
+		len = entry->len[published & 1];
+		memcpy( data, entry->data[published & 1], len );
+		TLM_BARRIER();
+	} while( entry->published != published );
+
+	return len;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the number of values published for a telemetry ID.
+ *
+ * @param[in] id
+ * 		Telemetry ID.
+ * @return
+ * 		Updates published, 0 for an ID outside the store.
+ ******************************************************************************/
+uint32_t FSW_TLM_updates( uint8_t id )
+{
+	if( ( uint8_t )( id - FSW_TLM_IDBASE ) >= FSW_TLM_IDCOUNT )
+	{
+		return 0;
+	}
+
+	return FSW_TLM_store[id - FSW_TLM_IDBASE].published;
+}
@@ -22,12 +22,13 @@ void HIL_TransceiverRX( void *pvParameters )
 	printString("c/w/e: Test log entries\n p: OBCtemp");
 	printString("i: i2c 'status' TLM\n I: i2c 'comm status TLM\n'");
 	printString("'r': Reset MCU\n'a': Print test string\n");
+	printString("IDs are sent in link frames, see fsw_link.h\n");
 
 	while(1)
 	{
+		// Waits for UART data, so it also paces the loop
+		COMMS_uartRx();
 		COMMS_processTCMD();
-
-		vTaskDelay( 500/portTICK_RATE_MS );
 	}
 
 	// Delete the task if it ever breaks out of the loop above
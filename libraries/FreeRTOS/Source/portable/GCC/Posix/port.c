@@ -0,0 +1,327 @@
+/*
+    FreeRTOS V7.5.2 - POSIX host simulator port.
+
+    Every task is backed by a host thread.  Only the thread belonging to
+    pxCurrentTCB runs; a context switch resumes the next thread and parks the
+    current one on its own event.  The thread bookkeeping lives at the top of
+    the task's FreeRTOS stack, so it is allocated and freed along with the
+    task.
+
+    The tick is produced by a separate host thread that only increments a
+    pending count.  The running task consumes pending ticks when its critical
+    nesting returns to zero, which gives the kernel the same "tick never
+    lands inside a critical section" guarantee as the hardware ports without
+    delivering signals into libc.  Yields requested inside a critical section
+    are likewise deferred to the matching exit, mirroring PendSV behaviour.
+
+    1 tab == 4 spaces!
+*/
+
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------*/
+
+typedef struct
+{
+	pthread_mutex_t xMutex;
+	pthread_cond_t xCond;
+	portBASE_TYPE xSignalled;
+} xThreadEvent;
+
+typedef struct
+{
+	pthread_t xThread;
+	pdTASK_CODE pxCode;
+	void *pvParameters;
+	volatile portBASE_TYPE xDying;
+	xThreadEvent xEvent;
+} xThreadState;
+
+/* Number of stack words reserved at the top of each task stack for the
+thread bookkeeping. */
+#define portTHREAD_STATE_WORDS	( ( sizeof( xThreadState ) + sizeof( portSTACK_TYPE ) - 1 ) / sizeof( portSTACK_TYPE ) )
+
+/* The first member of the TCB is always pxTopOfStack. */
+extern void * volatile pxCurrentTCB;
+
+/*-----------------------------------------------------------*/
+
+/* Only ever touched by the thread that is currently running a task. */
+static unsigned portBASE_TYPE uxCriticalNesting = 0;
+static portBASE_TYPE xYieldPending = pdFALSE;
+static portBASE_TYPE xSchedulerStarted = pdFALSE;
+
+/* Tick source shared with the tick thread. */
+static pthread_t xTickThread;
+static pthread_mutex_t xTickMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xTickCond = PTHREAD_COND_INITIALIZER;
+static volatile unsigned long ulPendingTicks = 0;
+static volatile portBASE_TYPE xTickStop = pdFALSE;
+
+/* Signalled by vPortEndScheduler() to release xPortStartScheduler(). */
+static xThreadEvent xEndEvent = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, pdFALSE };
+
+/*-----------------------------------------------------------*/
+
+static void prvSignalEvent( xThreadEvent *pxEvent )
+{
+	pthread_mutex_lock( &pxEvent->xMutex );
+	pxEvent->xSignalled = pdTRUE;
+	pthread_cond_signal( &pxEvent->xCond );
+	pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitEvent( xThreadEvent *pxEvent )
+{
+	pthread_mutex_lock( &pxEvent->xMutex );
+	while( pxEvent->xSignalled == pdFALSE )
+	{
+		pthread_cond_wait( &pxEvent->xCond, &pxEvent->xMutex );
+	}
+	pxEvent->xSignalled = pdFALSE;
+	pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static xThreadState *prvGetThreadState( void *pxTCB )
+{
+	return ( xThreadState * ) ( *( portSTACK_TYPE ** ) pxTCB + 1 );
+}
+/*-----------------------------------------------------------*/
+
+/* Park the calling thread until it is scheduled again, or exit it if its task
+has been deleted in the meantime. */
+static void prvSuspendSelf( xThreadState *pxThread )
+{
+	prvWaitEvent( &pxThread->xEvent );
+	if( pxThread->xDying != pdFALSE )
+	{
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvThreadEntry( void *pvParameters )
+{
+xThreadState *pxThread = ( xThreadState * ) pvParameters;
+
+	prvSuspendSelf( pxThread );
+
+	/* First time this task runs.  The thread that switched to it is left
+	holding a nesting of one inside prvYield(); a new task starts at zero. */
+	uxCriticalNesting = 0;
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* Tasks must not return, but clean up properly if one does. */
+	vTaskDelete( NULL );
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTickThread( void *pvParameters )
+{
+struct timespec xNext;
+const long lPeriodNs = 1000000000L / configTICK_RATE_HZ;
+
+	( void ) pvParameters;
+	clock_gettime( CLOCK_MONOTONIC, &xNext );
+
+	while( xTickStop == pdFALSE )
+	{
+		xNext.tv_nsec += lPeriodNs;
+		if( xNext.tv_nsec >= 1000000000L )
+		{
+			xNext.tv_nsec -= 1000000000L;
+			xNext.tv_sec++;
+		}
+		clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL );
+
+		pthread_mutex_lock( &xTickMutex );
+		__atomic_add_fetch( &ulPendingTicks, 1, __ATOMIC_SEQ_CST );
+		pthread_cond_broadcast( &xTickCond );
+		pthread_mutex_unlock( &xTickMutex );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/* Switch to whichever task vTaskSwitchContext() selects.  Called with a
+critical nesting of zero; the nesting is held at one across the switch so the
+resumed task, which parked at the same point, drops it back to zero. */
+static void prvYield( void )
+{
+xThreadState *pxFrom, *pxTo;
+
+	uxCriticalNesting++;
+	xYieldPending = pdFALSE;
+
+	pxFrom = prvGetThreadState( pxCurrentTCB );
+	vTaskSwitchContext();
+	pxTo = prvGetThreadState( pxCurrentTCB );
+
+	if( pxFrom != pxTo )
+	{
+		prvSignalEvent( &pxTo->xEvent );
+		prvSuspendSelf( pxFrom );
+		uxCriticalNesting = 1;
+	}
+
+	uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+/* Run the tick handler for every tick that elapsed since the last safe point,
+then perform any switch that was requested.  Only called at nesting zero. */
+static void prvServicePending( void )
+{
+unsigned long ulTicks;
+
+	ulTicks = __atomic_exchange_n( &ulPendingTicks, 0, __ATOMIC_SEQ_CST );
+	if( ulTicks != 0 )
+	{
+		uxCriticalNesting++;
+		while( ulTicks-- != 0 )
+		{
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				xYieldPending = pdTRUE;
+			}
+		}
+		uxCriticalNesting--;
+	}
+
+	if( xYieldPending != pdFALSE )
+	{
+		prvYield();
+	}
+}
+/*-----------------------------------------------------------*/
+
+portSTACK_TYPE *pxPortInitialiseStack( portSTACK_TYPE *pxTopOfStack, pdTASK_CODE pxCode, void *pvParameters )
+{
+xThreadState *pxThread;
+pthread_attr_t xAttr;
+sigset_t xAllSignals, xOldSignals;
+
+	/* Carve the thread bookkeeping out of the top of the task stack. */
+	pxTopOfStack -= portTHREAD_STATE_WORDS - 1;
+	pxThread = ( xThreadState * ) pxTopOfStack;
+
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pxThread->xDying = pdFALSE;
+	pthread_mutex_init( &pxThread->xEvent.xMutex, NULL );
+	pthread_cond_init( &pxThread->xEvent.xCond, NULL );
+	pxThread->xEvent.xSignalled = pdFALSE;
+
+	/* Task threads never handle signals; leave that to the host main
+	thread. */
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xOldSignals );
+	pthread_attr_init( &xAttr );
+	pthread_create( &pxThread->xThread, &xAttr, prvThreadEntry, pxThread );
+	pthread_attr_destroy( &xAttr );
+	pthread_sigmask( SIG_SETMASK, &xOldSignals, NULL );
+
+	return pxTopOfStack - 1;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortStartScheduler( void )
+{
+sigset_t xAllSignals, xOldSignals;
+
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xOldSignals );
+	pthread_create( &xTickThread, NULL, prvTickThread, NULL );
+	pthread_sigmask( SIG_SETMASK, &xOldSignals, NULL );
+
+	xSchedulerStarted = pdTRUE;
+	prvSignalEvent( &( prvGetThreadState( pxCurrentTCB )->xEvent ) );
+
+	/* The calling thread is not a task; it just waits for the scheduler to be
+	ended. */
+	prvWaitEvent( &xEndEvent );
+	pthread_join( xTickThread, NULL );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	xSchedulerStarted = pdFALSE;
+	xTickStop = pdTRUE;
+	prvSignalEvent( &xEndEvent );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	if( uxCriticalNesting != 0 )
+	{
+		/* Defer to the matching exit, as PendSV would on the target. */
+		xYieldPending = pdTRUE;
+	}
+	else
+	{
+		prvYield();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( uxCriticalNesting > 0 )
+	{
+		uxCriticalNesting--;
+		if( ( uxCriticalNesting == 0 ) && ( xSchedulerStarted != pdFALSE ) )
+		{
+			prvServicePending();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortWaitForTick( void )
+{
+	pthread_mutex_lock( &xTickMutex );
+	while( ( __atomic_load_n( &ulPendingTicks, __ATOMIC_SEQ_CST ) == 0 ) && ( xTickStop == pdFALSE ) )
+	{
+		pthread_cond_wait( &xTickCond, &xTickMutex );
+	}
+	pthread_mutex_unlock( &xTickMutex );
+
+	if( uxCriticalNesting == 0 )
+	{
+		prvServicePending();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+xThreadState *pxThread = prvGetThreadState( pxTCB );
+
+	/* The thread is parked (or was never started).  Release it so it exits,
+	and wait for that before the stack holding its state is freed. */
+	pxThread->xDying = pdTRUE;
+	prvSignalEvent( &pxThread->xEvent );
+	pthread_join( pxThread->xThread, NULL );
+	pthread_cond_destroy( &pxThread->xEvent.xCond );
+	pthread_mutex_destroy( &pxThread->xEvent.xMutex );
+}
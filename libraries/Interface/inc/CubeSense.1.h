@@ -42,6 +42,37 @@ typedef enum {
     CubeSenseTlmIdSunImage = 195, ///< Full sun image (UART only)
     CubeSenseTlmIdNadirMask = 200, ///< 5 masked areas each specified by 4 coordinates
 } CUBESENSE_TelemetryID_TypeDef;
+
+/// Length of each telemetry frame, in bytes.
+#define CUBESENSE_TLMLEN_IDENTIFICATION     6
+#define CUBESENSE_TLMLEN_COMMS_STATUS       8
+#define CUBESENSE_TLMLEN_TC_ACK             3
+#define CUBESENSE_TLMLEN_NADIR_SENSOR       6
+#define CUBESENSE_TLMLEN_SUN_SENSOR         6
+#define CUBESENSE_TLMLEN_POWER              10
+#define CUBESENSE_TLMLEN_CONFIG             13
+#define CUBESENSE_TLMLEN_IMAGE_FRAME        128
+#define CUBESENSE_TLMLEN_IMAGE_FRAME_DATA   3
+#define CUBESENSE_TLMLEN_NADIR_IMAGE        307200
+#define CUBESENSE_TLMLEN_SUN_IMAGE          307200
+#define CUBESENSE_TLMLEN_NADIR_MASK         40
+
+/// Flags of CUBESENSE_Telemetry_TypeDef.updated, one for each telemetry frame decoded.
+typedef enum {
+    CubeSenseTlmFlagIdentification = 0x0001, ///< Identification telemetry
+    CubeSenseTlmFlagCommsStatus = 0x0002, ///< Communication Status telemetry
+    CubeSenseTlmFlagTcAck = 0x0004, ///< Telecommand Acknowledge telemetry
+    CubeSenseTlmFlagNadirSensor = 0x0008, ///< Nadir Sensor telemetry
+    CubeSenseTlmFlagSunSensor = 0x0010, ///< Sun Sensor telemetry
+    CubeSenseTlmFlagPower = 0x0020, ///< Power telemetry
+    CubeSenseTlmFlagConfig = 0x0040, ///< Configuration telemetry
+    CubeSenseTlmFlagImageFrame = 0x0080, ///< Image Frame telemetry
+    CubeSenseTlmFlagImageFrameData = 0x0100, ///< Image Frame Data telemetry
+    CubeSenseTlmFlagNadirImage = 0x0200, ///< Full Nadir Image telemetry
+    CubeSenseTlmFlagSunImage = 0x0400, ///< Full Sun Image telemetry
+    CubeSenseTlmFlagNadirMask = 0x0800, ///< Request Masking Areas telemetry
+} CUBESENSE_TelemetryFlag_TypeDef;
+
 /*
 /// deg enumeration
 typedef enum {
@@ -230,10 +261,337 @@ typedef struct{
 } CUBESENSE_TlmNadirMask_TypeDef;
 
 
+/*******************************************************************************
+ *****************************   WIRE FORMAT   *********************************
+ ******************************************************************************/
+
+/*
+ * The wire structures lay out each telemetry frame as sent: byte arrays in the
+ * order of the frame, with multi-byte values little-endian. They have no
+ * padding and an alignment of 1, so a pointer to a receive buffer at any
+ * address may be used as one, and the accessors below read the values from it
+ * without copying the frame or loading misaligned words.
+ */
+#define CUBESENSE_WIRE_SIZE_CHECK(name, len) typedef char CUBESENSE_Wire##name##_SizeCheck[(sizeof(CUBESENSE_Wire##name##_TypeDef) == (len)) ? 1 : -1]
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Identification telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t runtimeSeconds[2]; ///< uint16_t
+    uint8_t runtimeMilliseconds[2]; ///< uint16_t
+    uint8_t firmwareMajorVersion;
+    uint8_t firmwareMinorVersion;
+} CUBESENSE_WireIdentification_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(Identification, CUBESENSE_TLMLEN_IDENTIFICATION);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Communication Status telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t tcCounter[2]; ///< uint16_t
+    uint8_t tlmCounter[2]; ///< uint16_t
+    uint8_t tcBufferOverrun; ///< Flag in bit 0
+    uint8_t i2cTlmReadError; ///< Flag in bit 0
+    uint8_t uartProtocolError; ///< Flag in bit 0
+    uint8_t uartMsgIncomplete; ///< Flag in bit 0
+} CUBESENSE_WireCommsStatus_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(CommsStatus, CUBESENSE_TLMLEN_COMMS_STATUS);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Telecommand Acknowledge telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t lastTcId;
+    uint8_t isProcessed; ///< Flag in bit 0
+    uint8_t lastTcError;
+} CUBESENSE_WireTcAck_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(TcAck, CUBESENSE_TLMLEN_TC_ACK);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Nadir Sensor telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t nadirX[2]; ///< int16_t, in units of 0.01
+    uint8_t nadirY[2]; ///< int16_t, in units of 0.01
+    uint8_t busyStatus;
+    uint8_t result;
+} CUBESENSE_WireNadirSensor_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(NadirSensor, CUBESENSE_TLMLEN_NADIR_SENSOR);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Sun Sensor telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t sunX[2]; ///< int16_t, in units of 0.01
+    uint8_t sunY[2]; ///< int16_t, in units of 0.01
+    uint8_t busyStatus;
+    uint8_t result;
+} CUBESENSE_WireSunSensor_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(SunSensor, CUBESENSE_TLMLEN_SUN_SENSOR);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Power telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t current3V3[2]; ///< uint16_t, in units of 1.29
+    uint8_t currentNadirSram[2]; ///< uint16_t, in units of 0.21
+    uint8_t currentSunSram[2]; ///< uint16_t, in units of 0.21
+    uint8_t nadirPower;
+    uint8_t sunPower;
+    uint8_t nadirOvercurrent;
+    uint8_t sunOvercurrent;
+} CUBESENSE_WirePower_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(Power, CUBESENSE_TLMLEN_POWER);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Configuration telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t nadirThreshold;
+    uint8_t sunThreshold;
+    uint8_t nadirAutoAdjust; ///< Flag in bit 0
+    uint8_t nadirExposure;
+    uint8_t nadirAgc;
+    uint8_t nadirBlueGain;
+    uint8_t nadirRedGain;
+    uint8_t sunAutoAdjust; ///< Flag in bit 0
+    uint8_t sunExposure;
+    uint8_t sunAgc;
+    uint8_t sunBlueGain;
+    uint8_t sunRedGain;
+    uint8_t autoPowerDown;
+} CUBESENSE_WireConfig_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(Config, CUBESENSE_TLMLEN_CONFIG);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Image Frame telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t imageBytes[128];
+} CUBESENSE_WireImageFrame_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(ImageFrame, CUBESENSE_TLMLEN_IMAGE_FRAME);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Image Frame Data telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t frameNumber[2]; ///< uint16_t
+    uint8_t checkSum;
+} CUBESENSE_WireImageFrameData_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(ImageFrameData, CUBESENSE_TLMLEN_IMAGE_FRAME_DATA);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Full Nadir Image telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t imageBytes[307200];
+} CUBESENSE_WireNadirImage_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(NadirImage, CUBESENSE_TLMLEN_NADIR_IMAGE);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Full Sun Image telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t imageBytes[307200];
+} CUBESENSE_WireSunImage_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(SunImage, CUBESENSE_TLMLEN_SUN_IMAGE);
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense Request Masking Areas telemetry frame as sent.
+ ******************************************************************************/
+typedef struct{
+    uint8_t area1Xmin[2]; ///< uint16_t
+    uint8_t area1Xmax[2]; ///< uint16_t
+    uint8_t area1Ymin[2]; ///< uint16_t
+    uint8_t area1Ymax[2]; ///< uint16_t
+    uint8_t area2Xmin[2]; ///< uint16_t
+    uint8_t area2Xmax[2]; ///< uint16_t
+    uint8_t area2Ymin[2]; ///< uint16_t
+    uint8_t area2Ymax[2]; ///< uint16_t
+    uint8_t area3Xmin[2]; ///< uint16_t
+    uint8_t area3Xmax[2]; ///< uint16_t
+    uint8_t area3Ymin[2]; ///< uint16_t
+    uint8_t area3Ymax[2]; ///< uint16_t
+    uint8_t area4Xmin[2]; ///< uint16_t
+    uint8_t area4Xmax[2]; ///< uint16_t
+    uint8_t area4Ymin[2]; ///< uint16_t
+    uint8_t area4Ymax[2]; ///< uint16_t
+    uint8_t area5Xmin[2]; ///< uint16_t
+    uint8_t area5Xmax[2]; ///< uint16_t
+    uint8_t area5Ymin[2]; ///< uint16_t
+    uint8_t area5Ymax[2]; ///< uint16_t
+} CUBESENSE_WireNadirMask_TypeDef;
+
+CUBESENSE_WIRE_SIZE_CHECK(NadirMask, CUBESENSE_TLMLEN_NADIR_MASK);
+
+/*******************************************************************************
+ *****************************   ACCESSORS   ***********************************
+ ******************************************************************************/
+
+/// Reads a little-endian uint16_t at any alignment.
+static inline uint16_t CUBESENSE_getUint16(const uint8_t* bytes)
+{
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+/// Reads a little-endian int16_t at any alignment.
+static inline int16_t CUBESENSE_getInt16(const uint8_t* bytes)
+{
+    return (int16_t)CUBESENSE_getUint16(bytes);
+}
+
+/// Writes a little-endian uint16_t at any alignment.
+static inline void CUBESENSE_putUint16(uint8_t* bytes, uint16_t value)
+{
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+}
+
+/// Identification telemetry fields, read in place from the frame.
+static inline uint16_t CUBESENSE_Identification_runtimeSeconds(const CUBESENSE_WireIdentification_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->runtimeSeconds); }
+static inline uint16_t CUBESENSE_Identification_runtimeMilliseconds(const CUBESENSE_WireIdentification_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->runtimeMilliseconds); }
+static inline uint8_t CUBESENSE_Identification_firmwareMajorVersion(const CUBESENSE_WireIdentification_TypeDef* tlm) { return tlm->firmwareMajorVersion; }
+static inline uint8_t CUBESENSE_Identification_firmwareMinorVersion(const CUBESENSE_WireIdentification_TypeDef* tlm) { return tlm->firmwareMinorVersion; }
+
+/// Communication Status telemetry fields, read in place from the frame.
+static inline uint16_t CUBESENSE_CommsStatus_tcCounter(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->tcCounter); }
+static inline uint16_t CUBESENSE_CommsStatus_tlmCounter(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->tlmCounter); }
+static inline uint8_t CUBESENSE_CommsStatus_tcBufferOverrun(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return tlm->tcBufferOverrun & 0x01; }
+static inline uint8_t CUBESENSE_CommsStatus_i2cTlmReadError(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return tlm->i2cTlmReadError & 0x01; }
+static inline uint8_t CUBESENSE_CommsStatus_uartProtocolError(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return tlm->uartProtocolError & 0x01; }
+static inline uint8_t CUBESENSE_CommsStatus_uartMsgIncomplete(const CUBESENSE_WireCommsStatus_TypeDef* tlm) { return tlm->uartMsgIncomplete & 0x01; }
+
+/// Telecommand Acknowledge telemetry fields, read in place from the frame.
+static inline uint8_t CUBESENSE_TcAck_lastTcId(const CUBESENSE_WireTcAck_TypeDef* tlm) { return tlm->lastTcId; }
+static inline uint8_t CUBESENSE_TcAck_isProcessed(const CUBESENSE_WireTcAck_TypeDef* tlm) { return tlm->isProcessed & 0x01; }
+static inline uint8_t CUBESENSE_TcAck_lastTcError(const CUBESENSE_WireTcAck_TypeDef* tlm) { return tlm->lastTcError; }
+
+/// Nadir Sensor telemetry fields, read in place from the frame.
+static inline int16_t CUBESENSE_NadirSensor_nadirX(const CUBESENSE_WireNadirSensor_TypeDef* tlm) { return CUBESENSE_getInt16(tlm->nadirX); } ///< Raw value, scaled by 0.01 in the decoded structure
+static inline int16_t CUBESENSE_NadirSensor_nadirY(const CUBESENSE_WireNadirSensor_TypeDef* tlm) { return CUBESENSE_getInt16(tlm->nadirY); } ///< Raw value, scaled by 0.01 in the decoded structure
+static inline uint8_t CUBESENSE_NadirSensor_busyStatus(const CUBESENSE_WireNadirSensor_TypeDef* tlm) { return tlm->busyStatus; }
+static inline uint8_t CUBESENSE_NadirSensor_result(const CUBESENSE_WireNadirSensor_TypeDef* tlm) { return tlm->result; }
+
+/// Sun Sensor telemetry fields, read in place from the frame.
+static inline int16_t CUBESENSE_SunSensor_sunX(const CUBESENSE_WireSunSensor_TypeDef* tlm) { return CUBESENSE_getInt16(tlm->sunX); } ///< Raw value, scaled by 0.01 in the decoded structure
+static inline int16_t CUBESENSE_SunSensor_sunY(const CUBESENSE_WireSunSensor_TypeDef* tlm) { return CUBESENSE_getInt16(tlm->sunY); } ///< Raw value, scaled by 0.01 in the decoded structure
+static inline uint8_t CUBESENSE_SunSensor_busyStatus(const CUBESENSE_WireSunSensor_TypeDef* tlm) { return tlm->busyStatus; }
+static inline uint8_t CUBESENSE_SunSensor_result(const CUBESENSE_WireSunSensor_TypeDef* tlm) { return tlm->result; }
+
+/// Power telemetry fields, read in place from the frame.
+static inline uint16_t CUBESENSE_Power_current3V3(const CUBESENSE_WirePower_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->current3V3); } ///< Raw value, scaled by 1.29 in the decoded structure
+static inline int32_t CUBESENSE_Power_current3V3uA(const CUBESENSE_WirePower_TypeDef* tlm) { return (int32_t)CUBESENSE_getUint16(tlm->current3V3) * 1290; } ///< Current in uA, without floating point
+static inline uint16_t CUBESENSE_Power_currentNadirSram(const CUBESENSE_WirePower_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->currentNadirSram); } ///< Raw value, scaled by 0.21 in the decoded structure
+static inline int32_t CUBESENSE_Power_currentNadirSramuA(const CUBESENSE_WirePower_TypeDef* tlm) { return (int32_t)CUBESENSE_getUint16(tlm->currentNadirSram) * 210; } ///< Current in uA, without floating point
+static inline uint16_t CUBESENSE_Power_currentSunSram(const CUBESENSE_WirePower_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->currentSunSram); } ///< Raw value, scaled by 0.21 in the decoded structure
+static inline int32_t CUBESENSE_Power_currentSunSramuA(const CUBESENSE_WirePower_TypeDef* tlm) { return (int32_t)CUBESENSE_getUint16(tlm->currentSunSram) * 210; } ///< Current in uA, without floating point
+static inline uint8_t CUBESENSE_Power_nadirPower(const CUBESENSE_WirePower_TypeDef* tlm) { return tlm->nadirPower; }
+static inline uint8_t CUBESENSE_Power_sunPower(const CUBESENSE_WirePower_TypeDef* tlm) { return tlm->sunPower; }
+static inline uint8_t CUBESENSE_Power_nadirOvercurrent(const CUBESENSE_WirePower_TypeDef* tlm) { return tlm->nadirOvercurrent; }
+static inline uint8_t CUBESENSE_Power_sunOvercurrent(const CUBESENSE_WirePower_TypeDef* tlm) { return tlm->sunOvercurrent; }
+
+/// Configuration telemetry fields, read in place from the frame.
+static inline uint8_t CUBESENSE_Config_nadirThreshold(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirThreshold; }
+static inline uint8_t CUBESENSE_Config_sunThreshold(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunThreshold; }
+static inline uint8_t CUBESENSE_Config_nadirAutoAdjust(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirAutoAdjust & 0x01; }
+static inline uint8_t CUBESENSE_Config_nadirExposure(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirExposure; }
+static inline uint8_t CUBESENSE_Config_nadirAgc(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirAgc; }
+static inline uint8_t CUBESENSE_Config_nadirBlueGain(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirBlueGain; }
+static inline uint8_t CUBESENSE_Config_nadirRedGain(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->nadirRedGain; }
+static inline uint8_t CUBESENSE_Config_sunAutoAdjust(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunAutoAdjust & 0x01; }
+static inline uint8_t CUBESENSE_Config_sunExposure(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunExposure; }
+static inline uint8_t CUBESENSE_Config_sunAgc(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunAgc; }
+static inline uint8_t CUBESENSE_Config_sunBlueGain(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunBlueGain; }
+static inline uint8_t CUBESENSE_Config_sunRedGain(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->sunRedGain; }
+static inline uint8_t CUBESENSE_Config_autoPowerDown(const CUBESENSE_WireConfig_TypeDef* tlm) { return tlm->autoPowerDown; }
+
+/// Image Frame telemetry fields, read in place from the frame.
+static inline const uint8_t* CUBESENSE_ImageFrame_imageBytes(const CUBESENSE_WireImageFrame_TypeDef* tlm) { return tlm->imageBytes; }
+
+/// Image Frame Data telemetry fields, read in place from the frame.
+static inline uint16_t CUBESENSE_ImageFrameData_frameNumber(const CUBESENSE_WireImageFrameData_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->frameNumber); }
+static inline uint8_t CUBESENSE_ImageFrameData_checkSum(const CUBESENSE_WireImageFrameData_TypeDef* tlm) { return tlm->checkSum; }
+
+/// Full Nadir Image telemetry fields, read in place from the frame.
+static inline const uint8_t* CUBESENSE_NadirImage_imageBytes(const CUBESENSE_WireNadirImage_TypeDef* tlm) { return tlm->imageBytes; }
+
+/// Full Sun Image telemetry fields, read in place from the frame.
+static inline const uint8_t* CUBESENSE_SunImage_imageBytes(const CUBESENSE_WireSunImage_TypeDef* tlm) { return tlm->imageBytes; }
+
+/// Request Masking Areas telemetry fields, read in place from the frame.
+static inline uint16_t CUBESENSE_NadirMask_area1Xmin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area1Xmin); }
+static inline uint16_t CUBESENSE_NadirMask_area1Xmax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area1Xmax); }
+static inline uint16_t CUBESENSE_NadirMask_area1Ymin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area1Ymin); }
+static inline uint16_t CUBESENSE_NadirMask_area1Ymax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area1Ymax); }
+static inline uint16_t CUBESENSE_NadirMask_area2Xmin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area2Xmin); }
+static inline uint16_t CUBESENSE_NadirMask_area2Xmax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area2Xmax); }
+static inline uint16_t CUBESENSE_NadirMask_area2Ymin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area2Ymin); }
+static inline uint16_t CUBESENSE_NadirMask_area2Ymax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area2Ymax); }
+static inline uint16_t CUBESENSE_NadirMask_area3Xmin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area3Xmin); }
+static inline uint16_t CUBESENSE_NadirMask_area3Xmax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area3Xmax); }
+static inline uint16_t CUBESENSE_NadirMask_area3Ymin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area3Ymin); }
+static inline uint16_t CUBESENSE_NadirMask_area3Ymax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area3Ymax); }
+static inline uint16_t CUBESENSE_NadirMask_area4Xmin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area4Xmin); }
+static inline uint16_t CUBESENSE_NadirMask_area4Xmax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area4Xmax); }
+static inline uint16_t CUBESENSE_NadirMask_area4Ymin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area4Ymin); }
+static inline uint16_t CUBESENSE_NadirMask_area4Ymax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area4Ymax); }
+static inline uint16_t CUBESENSE_NadirMask_area5Xmin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area5Xmin); }
+static inline uint16_t CUBESENSE_NadirMask_area5Xmax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area5Xmax); }
+static inline uint16_t CUBESENSE_NadirMask_area5Ymin(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area5Ymin); }
+static inline uint16_t CUBESENSE_NadirMask_area5Ymax(const CUBESENSE_WireNadirMask_TypeDef* tlm) { return CUBESENSE_getUint16(tlm->area5Ymax); }
+
+/***************************************************************************//**
+ * @brief
+ *   CubeSense telemetry decoded by CUBESENSE_decodeAll.
+ * @details
+ *   The image structures point into the burst decoded.
+ ******************************************************************************/
+typedef struct{
+    uint32_t updated; ///< CUBESENSE_TelemetryFlag_TypeDef flags of the telemetry decoded
+    CUBESENSE_TlmIdentification_TypeDef identification;
+    CUBESENSE_TlmCommsStatus_TypeDef commsStatus;
+    CUBESENSE_TlmTcAck_TypeDef tcAck;
+    CUBESENSE_TlmNadirSensor_TypeDef nadirSensor;
+    CUBESENSE_TlmSunSensor_TypeDef sunSensor;
+    CUBESENSE_TlmPower_TypeDef power;
+    CUBESENSE_TlmConfig_TypeDef config;
+    CUBESENSE_TlmImageFrame_TypeDef imageFrame;
+    CUBESENSE_TlmImageFrameData_TypeDef imageFrameData;
+    CUBESENSE_TlmNadirImage_TypeDef nadirImage;
+    CUBESENSE_TlmSunImage_TypeDef sunImage;
+    CUBESENSE_TlmNadirMask_TypeDef nadirMask;
+} CUBESENSE_Telemetry_TypeDef;
+
+
 /*******************************************************************************
  *****************************   PROTOTYPES   **********************************
  ******************************************************************************/
 
+int32_t CUBESENSE_telemetryLength(CUBESENSE_TelemetryID_TypeDef tlmId);
 int32_t CUBESENSE_createTelemetryRequest(uint8_t *tlmReqBuffer, CUBESENSE_TelemetryID_TypeDef tlmId);
 
 int8_t CUBESENSE_updateTlmIdentification(CUBESENSE_TlmIdentification_TypeDef* identification, uint8_t* tlmBuffer);
@@ -249,6 +607,21 @@ int8_t CUBESENSE_updateTlmNadirImage(CUBESENSE_TlmNadirImage_TypeDef* nadirImage
 int8_t CUBESENSE_updateTlmSunImage(CUBESENSE_TlmSunImage_TypeDef* sunImage, uint8_t* tlmBuffer);
 int8_t CUBESENSE_updateTlmNadirMask(CUBESENSE_TlmNadirMask_TypeDef* nadirMask, uint8_t* tlmBuffer);
 
+int32_t CUBESENSE_encodeTlmIdentification(uint8_t* tlmBuffer, const CUBESENSE_TlmIdentification_TypeDef* identification);
+int32_t CUBESENSE_encodeTlmCommsStatus(uint8_t* tlmBuffer, const CUBESENSE_TlmCommsStatus_TypeDef* commsStatus);
+int32_t CUBESENSE_encodeTlmTcAck(uint8_t* tlmBuffer, const CUBESENSE_TlmTcAck_TypeDef* tcAck);
+int32_t CUBESENSE_encodeTlmNadirSensor(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirSensor_TypeDef* nadirSensor);
+int32_t CUBESENSE_encodeTlmSunSensor(uint8_t* tlmBuffer, const CUBESENSE_TlmSunSensor_TypeDef* sunSensor);
+int32_t CUBESENSE_encodeTlmPower(uint8_t* tlmBuffer, const CUBESENSE_TlmPower_TypeDef* power);
+int32_t CUBESENSE_encodeTlmConfig(uint8_t* tlmBuffer, const CUBESENSE_TlmConfig_TypeDef* config);
+int32_t CUBESENSE_encodeTlmImageFrame(uint8_t* tlmBuffer, const CUBESENSE_TlmImageFrame_TypeDef* imageFrame);
+int32_t CUBESENSE_encodeTlmImageFrameData(uint8_t* tlmBuffer, const CUBESENSE_TlmImageFrameData_TypeDef* imageFrameData);
+int32_t CUBESENSE_encodeTlmNadirImage(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirImage_TypeDef* nadirImage);
+int32_t CUBESENSE_encodeTlmSunImage(uint8_t* tlmBuffer, const CUBESENSE_TlmSunImage_TypeDef* sunImage);
+int32_t CUBESENSE_encodeTlmNadirMask(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirMask_TypeDef* nadirMask);
+
+int32_t CUBESENSE_decodeAll(CUBESENSE_Telemetry_TypeDef* tlm, uint8_t* burst, uint32_t burstLen);
+
 int8_t CUBESENSE_createTcmdReset(uint8_t* tcBuffer, uint8_t resetType);
 int8_t CUBESENSE_createTcmdSetCameraPower(uint8_t* tcBuffer, uint8_t nadPower, uint8_t sunPower);
 int8_t CUBESENSE_createTcmdCaptureDetect(uint8_t* tcBuffer, uint8_t captureSelect, uint8_t detectSelect, uint8_t shift);
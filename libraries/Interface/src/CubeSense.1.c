@@ -3,8 +3,42 @@
  * Please do not modify the contents of this file manually.                         *
  ***********************************************************************************/
 
+#include <string.h>
 #include "CubeSense.1.h"
 
+/// Rounds to the nearest integer, for the fixed point values of telemetry.
+static int32_t CUBESENSE_round(float value)
+{
+    return (int32_t)((value < 0.0f) ? (value - 0.5f) : (value + 0.5f));
+}
+
+/***************************************************************************//**
+ * This function returns the length of a telemetry frame.
+ * @param[in] tlmID
+ *   Telemetry ID.
+ * @return
+ *   Returns the length of the telemetry frame, or -1 for an unknown ID.
+ ******************************************************************************/
+int32_t CUBESENSE_telemetryLength(CUBESENSE_TelemetryID_TypeDef tlmId)
+{
+    switch(tlmId)
+    {
+        case CubeSenseTlmIdIdentification : return CUBESENSE_TLMLEN_IDENTIFICATION;
+        case CubeSenseTlmIdCommsStatus : return CUBESENSE_TLMLEN_COMMS_STATUS;
+        case CubeSenseTlmIdTcAck : return CUBESENSE_TLMLEN_TC_ACK;
+        case CubeSenseTlmIdNadirSensor : return CUBESENSE_TLMLEN_NADIR_SENSOR;
+        case CubeSenseTlmIdSunSensor : return CUBESENSE_TLMLEN_SUN_SENSOR;
+        case CubeSenseTlmIdPower : return CUBESENSE_TLMLEN_POWER;
+        case CubeSenseTlmIdConfig : return CUBESENSE_TLMLEN_CONFIG;
+        case CubeSenseTlmIdImageFrame : return CUBESENSE_TLMLEN_IMAGE_FRAME;
+        case CubeSenseTlmIdImageFrameData : return CUBESENSE_TLMLEN_IMAGE_FRAME_DATA;
+        case CubeSenseTlmIdNadirImage : return CUBESENSE_TLMLEN_NADIR_IMAGE;
+        case CubeSenseTlmIdSunImage : return CUBESENSE_TLMLEN_SUN_IMAGE;
+        case CubeSenseTlmIdNadirMask : return CUBESENSE_TLMLEN_NADIR_MASK;
+        default: return -1;
+    }
+}
+
 /***************************************************************************//**
  * This function sets up a telemetry request by adding the ID of the
  * specified telemetry to the buffer for transmission and returns the length
@@ -22,22 +56,7 @@ int32_t CUBESENSE_createTelemetryRequest(uint8_t *tlmReqBuffer, CUBESENSE_Teleme
     // add id to telemetry buffer to be transmitted
     *tlmReqBuffer = (uint8_t)tlmId;
     // return length of telemetry to be received
-    switch(tlmId)
-    {
-        case CubeSenseTlmIdIdentification : return 6;
-        case CubeSenseTlmIdCommsStatus : return 8;
-        case CubeSenseTlmIdTcAck : return 3;
-        case CubeSenseTlmIdNadirSensor : return 6;
-        case CubeSenseTlmIdSunSensor : return 6;
-        case CubeSenseTlmIdPower : return 10;
-        case CubeSenseTlmIdConfig : return 13;
-        case CubeSenseTlmIdImageFrame : return 128;
-        case CubeSenseTlmIdImageFrameData : return 3;
-        case CubeSenseTlmIdNadirImage : return 307200;
-        case CubeSenseTlmIdSunImage : return 307200;
-        case CubeSenseTlmIdNadirMask : return 40;
-        default: return -1;
-    }
+    return CUBESENSE_telemetryLength(tlmId);
 }
 
 /***************************************************************************//**
@@ -48,19 +67,21 @@ int32_t CUBESENSE_createTelemetryRequest(uint8_t *tlmReqBuffer, CUBESENSE_Teleme
  * @param[out] identification
  *   Pointer to the CubeSense Identification structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmIdentification(CUBESENSE_TlmIdentification_TypeDef* identification, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireIdentification_TypeDef* wire = (const CUBESENSE_WireIdentification_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    identification->runtimeSeconds = *( (uint16_t*) (tlmBuffer + 0) );
-    identification->runtimeMilliseconds = *( (uint16_t*) (tlmBuffer + 2) );
-    identification->firmwareMajorVersion = *( (uint8_t*) (tlmBuffer + 4) );
-    identification->firmwareMinorVersion = *( (uint8_t*) (tlmBuffer + 5) );
+    identification->runtimeSeconds = CUBESENSE_Identification_runtimeSeconds(wire);
+    identification->runtimeMilliseconds = CUBESENSE_Identification_runtimeMilliseconds(wire);
+    identification->firmwareMajorVersion = CUBESENSE_Identification_firmwareMajorVersion(wire);
+    identification->firmwareMinorVersion = CUBESENSE_Identification_firmwareMinorVersion(wire);
 
     return 1;
 }
@@ -73,21 +94,23 @@ int8_t CUBESENSE_updateTlmIdentification(CUBESENSE_TlmIdentification_TypeDef* id
  * @param[out] commsStatus
  *   Pointer to the CubeSense Communication Status structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmCommsStatus(CUBESENSE_TlmCommsStatus_TypeDef* commsStatus, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireCommsStatus_TypeDef* wire = (const CUBESENSE_WireCommsStatus_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    commsStatus->tcCounter = *( (uint16_t*) (tlmBuffer + 0) );
-    commsStatus->tlmCounter = *( (uint16_t*) (tlmBuffer + 2) );
-    commsStatus->tcBufferOverrun = (tlmBuffer[4] && 0x01) >> 0;
-    commsStatus->i2cTlmReadError = (tlmBuffer[5] && 0x01) >> 0;
-    commsStatus->uartProtocolError = (tlmBuffer[6] && 0x01) >> 0;
-    commsStatus->uartMsgIncomplete = (tlmBuffer[7] && 0x01) >> 0;
+    commsStatus->tcCounter = CUBESENSE_CommsStatus_tcCounter(wire);
+    commsStatus->tlmCounter = CUBESENSE_CommsStatus_tlmCounter(wire);
+    commsStatus->tcBufferOverrun = CUBESENSE_CommsStatus_tcBufferOverrun(wire);
+    commsStatus->i2cTlmReadError = CUBESENSE_CommsStatus_i2cTlmReadError(wire);
+    commsStatus->uartProtocolError = CUBESENSE_CommsStatus_uartProtocolError(wire);
+    commsStatus->uartMsgIncomplete = CUBESENSE_CommsStatus_uartMsgIncomplete(wire);
 
     return 1;
 }
@@ -100,18 +123,20 @@ int8_t CUBESENSE_updateTlmCommsStatus(CUBESENSE_TlmCommsStatus_TypeDef* commsSta
  * @param[out] tcAck
  *   Pointer to the CubeSense Telecommand Acknowledge structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmTcAck(CUBESENSE_TlmTcAck_TypeDef* tcAck, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireTcAck_TypeDef* wire = (const CUBESENSE_WireTcAck_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    tcAck->lastTcId = *( (uint8_t*) (tlmBuffer + 0) );
-    tcAck->isProcessed = (tlmBuffer[1] && 0x01) >> 0;
-    tcAck->lastTcError = *( (uint8_t*) (tlmBuffer + 2) );
+    tcAck->lastTcId = CUBESENSE_TcAck_lastTcId(wire);
+    tcAck->isProcessed = CUBESENSE_TcAck_isProcessed(wire);
+    tcAck->lastTcError = CUBESENSE_TcAck_lastTcError(wire);
 
     return 1;
 }
@@ -124,24 +149,21 @@ int8_t CUBESENSE_updateTlmTcAck(CUBESENSE_TlmTcAck_TypeDef* tcAck, uint8_t* tlmB
  * @param[out] nadirSensor
  *   Pointer to the CubeSense Nadir Sensor structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmNadirSensor(CUBESENSE_TlmNadirSensor_TypeDef* nadirSensor, uint8_t* tlmBuffer)
 {
-    int16_t rawNadirX;
-    int16_t rawNadirY;
+    const CUBESENSE_WireNadirSensor_TypeDef* wire = (const CUBESENSE_WireNadirSensor_TypeDef*) tlmBuffer;
 
     if (tlmBuffer == 0)
         return 0;
 
-    rawNadirX = *( (int16_t*) (tlmBuffer + 0) );
-    nadirSensor->nadirX = rawNadirX*100.0f;
-    rawNadirY = *( (int16_t*) (tlmBuffer + 2) );
-    nadirSensor->nadirY = rawNadirY*100.0f;
-    nadirSensor->busyStatus = (uint8_t) tlmBuffer[4];
-    nadirSensor->result = (uint8_t) tlmBuffer[5];
+    nadirSensor->nadirX = CUBESENSE_NadirSensor_nadirX(wire)*0.01f;
+    nadirSensor->nadirY = CUBESENSE_NadirSensor_nadirY(wire)*0.01f;
+    nadirSensor->busyStatus = CUBESENSE_NadirSensor_busyStatus(wire);
+    nadirSensor->result = CUBESENSE_NadirSensor_result(wire);
 
     return 1;
 }
@@ -154,24 +176,21 @@ int8_t CUBESENSE_updateTlmNadirSensor(CUBESENSE_TlmNadirSensor_TypeDef* nadirSen
  * @param[out] sunSensor
  *   Pointer to the CubeSense Sun Sensor structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmSunSensor(CUBESENSE_TlmSunSensor_TypeDef* sunSensor, uint8_t* tlmBuffer)
 {
-    int16_t rawSunX;
-    int32_t rawSunY;
+    const CUBESENSE_WireSunSensor_TypeDef* wire = (const CUBESENSE_WireSunSensor_TypeDef*) tlmBuffer;
 
     if (tlmBuffer == 0)
         return 0;
 
-    rawSunX = *( (int16_t*) (tlmBuffer + 0) );
-    sunSensor->sunX = rawSunX*100.0f;
-    rawSunY = *( (int32_t*) (tlmBuffer + 2) );
-    sunSensor->sunY = rawSunY*100.0f;
-    sunSensor->busyStatus = (uint8_t) tlmBuffer[4];
-    sunSensor->result = (uint8_t) tlmBuffer[5];
+    sunSensor->sunX = CUBESENSE_SunSensor_sunX(wire)*0.01f;
+    sunSensor->sunY = CUBESENSE_SunSensor_sunY(wire)*0.01f;
+    sunSensor->busyStatus = CUBESENSE_SunSensor_busyStatus(wire);
+    sunSensor->result = CUBESENSE_SunSensor_result(wire);
 
     return 1;
 }
@@ -184,29 +203,24 @@ int8_t CUBESENSE_updateTlmSunSensor(CUBESENSE_TlmSunSensor_TypeDef* sunSensor, u
  * @param[out] power
  *   Pointer to the CubeSense Power structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmPower(CUBESENSE_TlmPower_TypeDef* power, uint8_t* tlmBuffer)
 {
-    uint16_t rawCurrent3V3;
-    uint16_t rawCurrentNadirSram;
-    uint16_t rawCurrentSunSram;
+    const CUBESENSE_WirePower_TypeDef* wire = (const CUBESENSE_WirePower_TypeDef*) tlmBuffer;
 
     if (tlmBuffer == 0)
         return 0;
 
-    rawCurrent3V3 = *( (uint16_t*) (tlmBuffer + 0) );
-    power->current3V3 = rawCurrent3V3/1.29f;
-    rawCurrentNadirSram = *( (uint16_t*) (tlmBuffer + 2) );
-    power->currentNadirSram = rawCurrentNadirSram/0.21f;
-    rawCurrentSunSram = *( (uint16_t*) (tlmBuffer + 4) );
-    power->currentSunSram = rawCurrentSunSram/0.21f;
-    power->nadirPower = (uint8_t) tlmBuffer[5];
-    power->sunPower = (uint8_t) tlmBuffer[6];
-    power->nadirOvercurrent = (uint8_t) tlmBuffer[7];
-    power->sunOvercurrent = (uint8_t) tlmBuffer[8];
+    power->current3V3 = CUBESENSE_Power_current3V3(wire)*1.29f;
+    power->currentNadirSram = CUBESENSE_Power_currentNadirSram(wire)*0.21f;
+    power->currentSunSram = CUBESENSE_Power_currentSunSram(wire)*0.21f;
+    power->nadirPower = CUBESENSE_Power_nadirPower(wire);
+    power->sunPower = CUBESENSE_Power_sunPower(wire);
+    power->nadirOvercurrent = CUBESENSE_Power_nadirOvercurrent(wire);
+    power->sunOvercurrent = CUBESENSE_Power_sunOvercurrent(wire);
 
     return 1;
 }
@@ -219,28 +233,30 @@ int8_t CUBESENSE_updateTlmPower(CUBESENSE_TlmPower_TypeDef* power, uint8_t* tlmB
  * @param[out] config
  *   Pointer to the CubeSense Configuration structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmConfig(CUBESENSE_TlmConfig_TypeDef* config, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireConfig_TypeDef* wire = (const CUBESENSE_WireConfig_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    config->nadirThreshold = *( (uint8_t*) (tlmBuffer + 0) );
-    config->sunThreshold = *( (uint8_t*) (tlmBuffer + 1) );
-    config->nadirAutoAdjust = (tlmBuffer[2] && 0x01) >> 0;
-    config->nadirExposure = *( (uint8_t*) (tlmBuffer + 3) );
-    config->nadirAgc = *( (uint8_t*) (tlmBuffer + 4) );
-    config->nadirBlueGain = *( (uint8_t*) (tlmBuffer + 5) );
-    config->nadirRedGain = *( (uint8_t*) (tlmBuffer + 6) );
-    config->sunAutoAdjust = (tlmBuffer[7] && 0x01) >> 0;
-    config->sunExposure = *( (uint8_t*) (tlmBuffer + 8) );
-    config->sunAgc = *( (uint8_t*) (tlmBuffer + 9) );
-    config->sunBlueGain = *( (uint8_t*) (tlmBuffer + 10) );
-    config->sunRedGain = *( (uint8_t*) (tlmBuffer + 11) );
-    config->autoPowerDown = *( (uint8_t*) (tlmBuffer + 12) );
+    config->nadirThreshold = CUBESENSE_Config_nadirThreshold(wire);
+    config->sunThreshold = CUBESENSE_Config_sunThreshold(wire);
+    config->nadirAutoAdjust = CUBESENSE_Config_nadirAutoAdjust(wire);
+    config->nadirExposure = CUBESENSE_Config_nadirExposure(wire);
+    config->nadirAgc = CUBESENSE_Config_nadirAgc(wire);
+    config->nadirBlueGain = CUBESENSE_Config_nadirBlueGain(wire);
+    config->nadirRedGain = CUBESENSE_Config_nadirRedGain(wire);
+    config->sunAutoAdjust = CUBESENSE_Config_sunAutoAdjust(wire);
+    config->sunExposure = CUBESENSE_Config_sunExposure(wire);
+    config->sunAgc = CUBESENSE_Config_sunAgc(wire);
+    config->sunBlueGain = CUBESENSE_Config_sunBlueGain(wire);
+    config->sunRedGain = CUBESENSE_Config_sunRedGain(wire);
+    config->autoPowerDown = CUBESENSE_Config_autoPowerDown(wire);
 
     return 1;
 }
@@ -253,16 +269,18 @@ int8_t CUBESENSE_updateTlmConfig(CUBESENSE_TlmConfig_TypeDef* config, uint8_t* t
  * @param[out] imageFrame
  *   Pointer to the CubeSense Image Frame structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmImageFrame(CUBESENSE_TlmImageFrame_TypeDef* imageFrame, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireImageFrame_TypeDef* wire = (const CUBESENSE_WireImageFrame_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    memcpy(imageFrame->imageBytes, tlmBuffer + 0, 128);
+    memcpy(imageFrame->imageBytes, CUBESENSE_ImageFrame_imageBytes(wire), 128);
 
     return 1;
 }
@@ -275,17 +293,19 @@ int8_t CUBESENSE_updateTlmImageFrame(CUBESENSE_TlmImageFrame_TypeDef* imageFrame
  * @param[out] imageFrameData
  *   Pointer to the CubeSense Image Frame Data structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmImageFrameData(CUBESENSE_TlmImageFrameData_TypeDef* imageFrameData, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireImageFrameData_TypeDef* wire = (const CUBESENSE_WireImageFrameData_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    imageFrameData->frameNumber = *( (uint16_t*) (tlmBuffer + 0) );
-    imageFrameData->checkSum = *( (uint8_t*) (tlmBuffer + 2) );
+    imageFrameData->frameNumber = CUBESENSE_ImageFrameData_frameNumber(wire);
+    imageFrameData->checkSum = CUBESENSE_ImageFrameData_checkSum(wire);
 
     return 1;
 }
@@ -298,16 +318,18 @@ int8_t CUBESENSE_updateTlmImageFrameData(CUBESENSE_TlmImageFrameData_TypeDef* im
  * @param[out] nadirImage
  *   Pointer to the CubeSense Full Nadir Image structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmNadirImage(CUBESENSE_TlmNadirImage_TypeDef* nadirImage, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireNadirImage_TypeDef* wire = (const CUBESENSE_WireNadirImage_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    memcpy(nadirImage->imageBytes, tlmBuffer + 0, 307200);
+    memcpy(nadirImage->imageBytes, CUBESENSE_NadirImage_imageBytes(wire), 307200);
 
     return 1;
 }
@@ -320,16 +342,18 @@ int8_t CUBESENSE_updateTlmNadirImage(CUBESENSE_TlmNadirImage_TypeDef* nadirImage
  * @param[out] sunImage
  *   Pointer to the CubeSense Full Sun Image structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmSunImage(CUBESENSE_TlmSunImage_TypeDef* sunImage, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireSunImage_TypeDef* wire = (const CUBESENSE_WireSunImage_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    memcpy(sunImage->imageBytes, tlmBuffer + 0, 307200);
+    memcpy(sunImage->imageBytes, CUBESENSE_SunImage_imageBytes(wire), 307200);
 
     return 1;
 }
@@ -342,39 +366,430 @@ int8_t CUBESENSE_updateTlmSunImage(CUBESENSE_TlmSunImage_TypeDef* sunImage, uint
  * @param[out] nadirMask
  *   Pointer to the CubeSense Request Masking Areas structure.
  * @param[in] tlmBuffer
- *   Pointer to the supplied telemetry buffer.
+ *   Pointer to the supplied telemetry buffer, at any alignment.
  * @return
  *   Returns true if the update was an success.
  ******************************************************************************/
 int8_t CUBESENSE_updateTlmNadirMask(CUBESENSE_TlmNadirMask_TypeDef* nadirMask, uint8_t* tlmBuffer)
 {
+    const CUBESENSE_WireNadirMask_TypeDef* wire = (const CUBESENSE_WireNadirMask_TypeDef*) tlmBuffer;
+
     if (tlmBuffer == 0)
         return 0;
 
-    nadirMask->area1Xmin = *( (uint16_t*) (tlmBuffer + 0) );
-    nadirMask->area1Xmax = *( (uint16_t*) (tlmBuffer + 2) );
-    nadirMask->area1Ymin = *( (uint16_t*) (tlmBuffer + 4) );
-    nadirMask->area1Ymax = *( (uint16_t*) (tlmBuffer + 6) );
-    nadirMask->area2Xmin = *( (uint16_t*) (tlmBuffer + 8) );
-    nadirMask->area2Xmax = *( (uint16_t*) (tlmBuffer + 10) );
-    nadirMask->area2Ymin = *( (uint16_t*) (tlmBuffer + 12) );
-    nadirMask->area2Ymax = *( (uint16_t*) (tlmBuffer + 14) );
-    nadirMask->area3Xmin = *( (uint16_t*) (tlmBuffer + 16) );
-    nadirMask->area3Xmax = *( (uint16_t*) (tlmBuffer + 18) );
-    nadirMask->area3Ymin = *( (uint16_t*) (tlmBuffer + 20) );
-    nadirMask->area3Ymax = *( (uint16_t*) (tlmBuffer + 22) );
-    nadirMask->area4Xmin = *( (uint16_t*) (tlmBuffer + 24) );
-    nadirMask->area4Xmax = *( (uint16_t*) (tlmBuffer + 26) );
-    nadirMask->area4Ymin = *( (uint16_t*) (tlmBuffer + 28) );
-    nadirMask->area4Ymax = *( (uint16_t*) (tlmBuffer + 30) );
-    nadirMask->area5Xmin = *( (uint16_t*) (tlmBuffer + 32) );
-    nadirMask->area5Xmax = *( (uint16_t*) (tlmBuffer + 34) );
-    nadirMask->area5Ymin = *( (uint16_t*) (tlmBuffer + 36) );
-    nadirMask->area5Ymax = *( (uint16_t*) (tlmBuffer + 38) );
+    nadirMask->area1Xmin = CUBESENSE_NadirMask_area1Xmin(wire);
+    nadirMask->area1Xmax = CUBESENSE_NadirMask_area1Xmax(wire);
+    nadirMask->area1Ymin = CUBESENSE_NadirMask_area1Ymin(wire);
+    nadirMask->area1Ymax = CUBESENSE_NadirMask_area1Ymax(wire);
+    nadirMask->area2Xmin = CUBESENSE_NadirMask_area2Xmin(wire);
+    nadirMask->area2Xmax = CUBESENSE_NadirMask_area2Xmax(wire);
+    nadirMask->area2Ymin = CUBESENSE_NadirMask_area2Ymin(wire);
+    nadirMask->area2Ymax = CUBESENSE_NadirMask_area2Ymax(wire);
+    nadirMask->area3Xmin = CUBESENSE_NadirMask_area3Xmin(wire);
+    nadirMask->area3Xmax = CUBESENSE_NadirMask_area3Xmax(wire);
+    nadirMask->area3Ymin = CUBESENSE_NadirMask_area3Ymin(wire);
+    nadirMask->area3Ymax = CUBESENSE_NadirMask_area3Ymax(wire);
+    nadirMask->area4Xmin = CUBESENSE_NadirMask_area4Xmin(wire);
+    nadirMask->area4Xmax = CUBESENSE_NadirMask_area4Xmax(wire);
+    nadirMask->area4Ymin = CUBESENSE_NadirMask_area4Ymin(wire);
+    nadirMask->area4Ymax = CUBESENSE_NadirMask_area4Ymax(wire);
+    nadirMask->area5Xmin = CUBESENSE_NadirMask_area5Xmin(wire);
+    nadirMask->area5Xmax = CUBESENSE_NadirMask_area5Xmax(wire);
+    nadirMask->area5Ymin = CUBESENSE_NadirMask_area5Ymin(wire);
+    nadirMask->area5Ymax = CUBESENSE_NadirMask_area5Ymax(wire);
 
     return 1;
 }
 
+/***************************************************************************//**
+ * This function creates the CubeSense Identification telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] identification
+ *   Pointer to the CubeSense Identification structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmIdentification(uint8_t* tlmBuffer, const CUBESENSE_TlmIdentification_TypeDef* identification)
+{
+    CUBESENSE_WireIdentification_TypeDef* wire = (CUBESENSE_WireIdentification_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->runtimeSeconds, (uint16_t)identification->runtimeSeconds);
+    CUBESENSE_putUint16(wire->runtimeMilliseconds, (uint16_t)identification->runtimeMilliseconds);
+    wire->firmwareMajorVersion = identification->firmwareMajorVersion;
+    wire->firmwareMinorVersion = identification->firmwareMinorVersion;
+
+    return CUBESENSE_TLMLEN_IDENTIFICATION;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Communication Status telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] commsStatus
+ *   Pointer to the CubeSense Communication Status structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmCommsStatus(uint8_t* tlmBuffer, const CUBESENSE_TlmCommsStatus_TypeDef* commsStatus)
+{
+    CUBESENSE_WireCommsStatus_TypeDef* wire = (CUBESENSE_WireCommsStatus_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->tcCounter, (uint16_t)commsStatus->tcCounter);
+    CUBESENSE_putUint16(wire->tlmCounter, (uint16_t)commsStatus->tlmCounter);
+    wire->tcBufferOverrun = commsStatus->tcBufferOverrun & 0x01;
+    wire->i2cTlmReadError = commsStatus->i2cTlmReadError & 0x01;
+    wire->uartProtocolError = commsStatus->uartProtocolError & 0x01;
+    wire->uartMsgIncomplete = commsStatus->uartMsgIncomplete & 0x01;
+
+    return CUBESENSE_TLMLEN_COMMS_STATUS;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Telecommand Acknowledge telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] tcAck
+ *   Pointer to the CubeSense Telecommand Acknowledge structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmTcAck(uint8_t* tlmBuffer, const CUBESENSE_TlmTcAck_TypeDef* tcAck)
+{
+    CUBESENSE_WireTcAck_TypeDef* wire = (CUBESENSE_WireTcAck_TypeDef*) tlmBuffer;
+
+    wire->lastTcId = tcAck->lastTcId;
+    wire->isProcessed = tcAck->isProcessed & 0x01;
+    wire->lastTcError = tcAck->lastTcError;
+
+    return CUBESENSE_TLMLEN_TC_ACK;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Nadir Sensor telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] nadirSensor
+ *   Pointer to the CubeSense Nadir Sensor structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmNadirSensor(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirSensor_TypeDef* nadirSensor)
+{
+    CUBESENSE_WireNadirSensor_TypeDef* wire = (CUBESENSE_WireNadirSensor_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->nadirX, (uint16_t)CUBESENSE_round(nadirSensor->nadirX/0.01f));
+    CUBESENSE_putUint16(wire->nadirY, (uint16_t)CUBESENSE_round(nadirSensor->nadirY/0.01f));
+    wire->busyStatus = nadirSensor->busyStatus;
+    wire->result = nadirSensor->result;
+
+    return CUBESENSE_TLMLEN_NADIR_SENSOR;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Sun Sensor telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] sunSensor
+ *   Pointer to the CubeSense Sun Sensor structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmSunSensor(uint8_t* tlmBuffer, const CUBESENSE_TlmSunSensor_TypeDef* sunSensor)
+{
+    CUBESENSE_WireSunSensor_TypeDef* wire = (CUBESENSE_WireSunSensor_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->sunX, (uint16_t)CUBESENSE_round(sunSensor->sunX/0.01f));
+    CUBESENSE_putUint16(wire->sunY, (uint16_t)CUBESENSE_round(sunSensor->sunY/0.01f));
+    wire->busyStatus = sunSensor->busyStatus;
+    wire->result = sunSensor->result;
+
+    return CUBESENSE_TLMLEN_SUN_SENSOR;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Power telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] power
+ *   Pointer to the CubeSense Power structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmPower(uint8_t* tlmBuffer, const CUBESENSE_TlmPower_TypeDef* power)
+{
+    CUBESENSE_WirePower_TypeDef* wire = (CUBESENSE_WirePower_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->current3V3, (uint16_t)CUBESENSE_round(power->current3V3/1.29f));
+    CUBESENSE_putUint16(wire->currentNadirSram, (uint16_t)CUBESENSE_round(power->currentNadirSram/0.21f));
+    CUBESENSE_putUint16(wire->currentSunSram, (uint16_t)CUBESENSE_round(power->currentSunSram/0.21f));
+    wire->nadirPower = power->nadirPower;
+    wire->sunPower = power->sunPower;
+    wire->nadirOvercurrent = power->nadirOvercurrent;
+    wire->sunOvercurrent = power->sunOvercurrent;
+
+    return CUBESENSE_TLMLEN_POWER;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Configuration telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] config
+ *   Pointer to the CubeSense Configuration structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmConfig(uint8_t* tlmBuffer, const CUBESENSE_TlmConfig_TypeDef* config)
+{
+    CUBESENSE_WireConfig_TypeDef* wire = (CUBESENSE_WireConfig_TypeDef*) tlmBuffer;
+
+    wire->nadirThreshold = config->nadirThreshold;
+    wire->sunThreshold = config->sunThreshold;
+    wire->nadirAutoAdjust = config->nadirAutoAdjust & 0x01;
+    wire->nadirExposure = config->nadirExposure;
+    wire->nadirAgc = config->nadirAgc;
+    wire->nadirBlueGain = config->nadirBlueGain;
+    wire->nadirRedGain = config->nadirRedGain;
+    wire->sunAutoAdjust = config->sunAutoAdjust & 0x01;
+    wire->sunExposure = config->sunExposure;
+    wire->sunAgc = config->sunAgc;
+    wire->sunBlueGain = config->sunBlueGain;
+    wire->sunRedGain = config->sunRedGain;
+    wire->autoPowerDown = config->autoPowerDown;
+
+    return CUBESENSE_TLMLEN_CONFIG;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Image Frame telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] imageFrame
+ *   Pointer to the CubeSense Image Frame structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmImageFrame(uint8_t* tlmBuffer, const CUBESENSE_TlmImageFrame_TypeDef* imageFrame)
+{
+    CUBESENSE_WireImageFrame_TypeDef* wire = (CUBESENSE_WireImageFrame_TypeDef*) tlmBuffer;
+
+    memcpy(wire->imageBytes, imageFrame->imageBytes, 128);
+
+    return CUBESENSE_TLMLEN_IMAGE_FRAME;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Image Frame Data telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] imageFrameData
+ *   Pointer to the CubeSense Image Frame Data structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmImageFrameData(uint8_t* tlmBuffer, const CUBESENSE_TlmImageFrameData_TypeDef* imageFrameData)
+{
+    CUBESENSE_WireImageFrameData_TypeDef* wire = (CUBESENSE_WireImageFrameData_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->frameNumber, (uint16_t)imageFrameData->frameNumber);
+    wire->checkSum = imageFrameData->checkSum;
+
+    return CUBESENSE_TLMLEN_IMAGE_FRAME_DATA;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Full Nadir Image telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] nadirImage
+ *   Pointer to the CubeSense Full Nadir Image structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmNadirImage(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirImage_TypeDef* nadirImage)
+{
+    CUBESENSE_WireNadirImage_TypeDef* wire = (CUBESENSE_WireNadirImage_TypeDef*) tlmBuffer;
+
+    memcpy(wire->imageBytes, nadirImage->imageBytes, 307200);
+
+    return CUBESENSE_TLMLEN_NADIR_IMAGE;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Full Sun Image telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] sunImage
+ *   Pointer to the CubeSense Full Sun Image structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmSunImage(uint8_t* tlmBuffer, const CUBESENSE_TlmSunImage_TypeDef* sunImage)
+{
+    CUBESENSE_WireSunImage_TypeDef* wire = (CUBESENSE_WireSunImage_TypeDef*) tlmBuffer;
+
+    memcpy(wire->imageBytes, sunImage->imageBytes, 307200);
+
+    return CUBESENSE_TLMLEN_SUN_IMAGE;
+}
+
+/***************************************************************************//**
+ * This function creates the CubeSense Request Masking Areas telemetry frame
+ * of the supplied structure, as CubeSense sends it.
+ *
+ * @param[out] tlmBuffer
+ *   Pointer to the telemetry buffer, at any alignment.
+ * @param[in] nadirMask
+ *   Pointer to the CubeSense Request Masking Areas structure.
+ * @return
+ *   Returns the length of the telemetry frame.
+ ******************************************************************************/
+int32_t CUBESENSE_encodeTlmNadirMask(uint8_t* tlmBuffer, const CUBESENSE_TlmNadirMask_TypeDef* nadirMask)
+{
+    CUBESENSE_WireNadirMask_TypeDef* wire = (CUBESENSE_WireNadirMask_TypeDef*) tlmBuffer;
+
+    CUBESENSE_putUint16(wire->area1Xmin, (uint16_t)nadirMask->area1Xmin);
+    CUBESENSE_putUint16(wire->area1Xmax, (uint16_t)nadirMask->area1Xmax);
+    CUBESENSE_putUint16(wire->area1Ymin, (uint16_t)nadirMask->area1Ymin);
+    CUBESENSE_putUint16(wire->area1Ymax, (uint16_t)nadirMask->area1Ymax);
+    CUBESENSE_putUint16(wire->area2Xmin, (uint16_t)nadirMask->area2Xmin);
+    CUBESENSE_putUint16(wire->area2Xmax, (uint16_t)nadirMask->area2Xmax);
+    CUBESENSE_putUint16(wire->area2Ymin, (uint16_t)nadirMask->area2Ymin);
+    CUBESENSE_putUint16(wire->area2Ymax, (uint16_t)nadirMask->area2Ymax);
+    CUBESENSE_putUint16(wire->area3Xmin, (uint16_t)nadirMask->area3Xmin);
+    CUBESENSE_putUint16(wire->area3Xmax, (uint16_t)nadirMask->area3Xmax);
+    CUBESENSE_putUint16(wire->area3Ymin, (uint16_t)nadirMask->area3Ymin);
+    CUBESENSE_putUint16(wire->area3Ymax, (uint16_t)nadirMask->area3Ymax);
+    CUBESENSE_putUint16(wire->area4Xmin, (uint16_t)nadirMask->area4Xmin);
+    CUBESENSE_putUint16(wire->area4Xmax, (uint16_t)nadirMask->area4Xmax);
+    CUBESENSE_putUint16(wire->area4Ymin, (uint16_t)nadirMask->area4Ymin);
+    CUBESENSE_putUint16(wire->area4Ymax, (uint16_t)nadirMask->area4Ymax);
+    CUBESENSE_putUint16(wire->area5Xmin, (uint16_t)nadirMask->area5Xmin);
+    CUBESENSE_putUint16(wire->area5Xmax, (uint16_t)nadirMask->area5Xmax);
+    CUBESENSE_putUint16(wire->area5Ymin, (uint16_t)nadirMask->area5Ymin);
+    CUBESENSE_putUint16(wire->area5Ymax, (uint16_t)nadirMask->area5Ymax);
+
+    return CUBESENSE_TLMLEN_NADIR_MASK;
+}
+
+/***************************************************************************//**
+ * This function decodes a burst of telemetry frames in one pass, each frame
+ * preceded by its telemetry ID, into the structures of
+ * \link CUBESENSE_Telemetry_TypeDef CUBESENSE_Telemetry_TypeDef \endlink.
+ * The image structures are pointed at their frames in the burst instead of
+ * copying them.
+ *
+ * @param[out] tlm
+ *   Pointer to the telemetry structures. The flag of each frame decoded is
+ *   set in updated.
+ * @param[in] burst
+ *   Pointer to the frames, at any alignment.
+ * @param[in] burstLen
+ *   Length of the burst.
+ * @return
+ *   Returns the number of frames decoded, or -1 if a frame has an unknown ID
+ *   or runs past the end of the burst. The frames before it are decoded.
+ ******************************************************************************/
+int32_t CUBESENSE_decodeAll(CUBESENSE_Telemetry_TypeDef* tlm, uint8_t* burst, uint32_t burstLen)
+{
+    uint32_t offset = 0;
+    int32_t frames = 0;
+    int32_t tlmLen;
+    uint8_t* frame;
+
+    tlm->updated = 0;
+
+    while (offset < burstLen)
+    {
+        tlmLen = CUBESENSE_telemetryLength((CUBESENSE_TelemetryID_TypeDef) burst[offset]);
+        if (tlmLen < 0 || (uint32_t) tlmLen > burstLen - offset - 1)
+            return -1;
+        frame = burst + offset + 1;
+
+        switch (burst[offset])
+        {
+            case CubeSenseTlmIdIdentification :
+                CUBESENSE_updateTlmIdentification(&tlm->identification, frame);
+                tlm->updated |= CubeSenseTlmFlagIdentification;
+                break;
+            case CubeSenseTlmIdCommsStatus :
+                CUBESENSE_updateTlmCommsStatus(&tlm->commsStatus, frame);
+                tlm->updated |= CubeSenseTlmFlagCommsStatus;
+                break;
+            case CubeSenseTlmIdTcAck :
+                CUBESENSE_updateTlmTcAck(&tlm->tcAck, frame);
+                tlm->updated |= CubeSenseTlmFlagTcAck;
+                break;
+            case CubeSenseTlmIdNadirSensor :
+                CUBESENSE_updateTlmNadirSensor(&tlm->nadirSensor, frame);
+                tlm->updated |= CubeSenseTlmFlagNadirSensor;
+                break;
+            case CubeSenseTlmIdSunSensor :
+                CUBESENSE_updateTlmSunSensor(&tlm->sunSensor, frame);
+                tlm->updated |= CubeSenseTlmFlagSunSensor;
+                break;
+            case CubeSenseTlmIdPower :
+                CUBESENSE_updateTlmPower(&tlm->power, frame);
+                tlm->updated |= CubeSenseTlmFlagPower;
+                break;
+            case CubeSenseTlmIdConfig :
+                CUBESENSE_updateTlmConfig(&tlm->config, frame);
+                tlm->updated |= CubeSenseTlmFlagConfig;
+                break;
+            case CubeSenseTlmIdImageFrame :
+                tlm->imageFrame.imageBytes = frame;
+                tlm->updated |= CubeSenseTlmFlagImageFrame;
+                break;
+            case CubeSenseTlmIdImageFrameData :
+                CUBESENSE_updateTlmImageFrameData(&tlm->imageFrameData, frame);
+                tlm->updated |= CubeSenseTlmFlagImageFrameData;
+                break;
+            case CubeSenseTlmIdNadirImage :
+                tlm->nadirImage.imageBytes = frame;
+                tlm->updated |= CubeSenseTlmFlagNadirImage;
+                break;
+            case CubeSenseTlmIdSunImage :
+                tlm->sunImage.imageBytes = frame;
+                tlm->updated |= CubeSenseTlmFlagSunImage;
+                break;
+            case CubeSenseTlmIdNadirMask :
+                CUBESENSE_updateTlmNadirMask(&tlm->nadirMask, frame);
+                tlm->updated |= CubeSenseTlmFlagNadirMask;
+                break;
+            default :
+                return -1;
+        }
+
+        offset += 1 + tlmLen;
+        frames++;
+    }
+
+    return frames;
+}
+
 /***************************************************************************//**
  * This function creates a Reset command
  * from the supplied parameters.
@@ -620,8 +1035,8 @@ int8_t CUBESENSE_createTcmdSetSunBoresight(uint8_t* tcBuffer, uint16_t xpixel, u
     // write telecommand ID to first element in buffer
     tcBuffer[0] = 50;
 
-    *( (uint16_t*)(tcBuffer + 1) ) = xpixel;
-    *( (uint16_t*)(tcBuffer + 3) ) = ypixel;
+    CUBESENSE_putUint16(tcBuffer + 1, xpixel);
+    CUBESENSE_putUint16(tcBuffer + 3, ypixel);
     return 5;
 }
 
@@ -643,8 +1058,8 @@ int8_t CUBESENSE_createTcmdSetNadirBoresight(uint8_t* tcBuffer, uint16_t xpixel,
     // write telecommand ID to first element in buffer
     tcBuffer[0] = 51;
 
-    *( (uint16_t*)(tcBuffer + 1) ) = xpixel;
-    *( (uint16_t*)(tcBuffer + 3) ) = ypixel;
+    CUBESENSE_putUint16(tcBuffer + 1, xpixel);
+    CUBESENSE_putUint16(tcBuffer + 3, ypixel);
     return 5;
 }
 
@@ -673,10 +1088,10 @@ int8_t CUBESENSE_createTcmdSetNadirMask(uint8_t* tcBuffer, uint8_t areaNumber, u
     tcBuffer[0] = 52;
 
     *( (uint8_t*)(tcBuffer + 1) ) = areaNumber;
-    *( (uint16_t*)(tcBuffer + 2) ) = xmin;
-    *( (uint16_t*)(tcBuffer + 4) ) = xmax;
-    *( (uint16_t*)(tcBuffer + 6) ) = ymin;
-    *( (uint16_t*)(tcBuffer + 8) ) = ymax;
+    CUBESENSE_putUint16(tcBuffer + 2, xmin);
+    CUBESENSE_putUint16(tcBuffer + 4, xmax);
+    CUBESENSE_putUint16(tcBuffer + 6, ymin);
+    CUBESENSE_putUint16(tcBuffer + 8, ymax);
     return 10;
 }
 
@@ -719,7 +1134,7 @@ int8_t CUBESENSE_createTcmdAdvanceImageDownload(uint8_t* tcBuffer, uint16_t next
     // write telecommand ID to first element in buffer
     tcBuffer[0] = 65;
 
-    *( (uint16_t*)(tcBuffer + 1) ) = nextFrame;
+    CUBESENSE_putUint16(tcBuffer + 1, nextFrame);
     return 3;
 }
 
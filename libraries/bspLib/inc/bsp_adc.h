@@ -45,7 +45,31 @@
  * @{
  ******************************************************************************/
 
-#define BSP_ADC_temp2Float(temp_u)		(((float)temp_u)/256.0)
+#define BSP_ADC_temp2Float(temp_u)		(((float)(int16_t)(temp_u))/256.0)
+
+/// Scans per second, each converting the four scan channels and then the
+/// temperature. LETIMER0 triggers them through PRS channel BSP_ADC_PRSCH and
+/// the DMA takes the results, so sampling costs no CPU time. Sampling runs
+/// in bursts, so the rate only sets how long a burst keeps the core in EM1.
+#define BSP_ADC_RATE_HZ			1024
+#define BSP_ADC_MAXRATE_HZ		4096		///< Fastest scan rate, well inside the conversion time of a scan.
+#define BSP_ADC_PRSCH			0			///< PRS channel carrying the LETIMER0 trigger to the ADC.
+
+/// Scans in each half of the DMA ping-pong buffers. The results are
+/// processed a half at a time, so at the default rate the DMA interrupts
+/// twice every 15.6 ms, once for the scan channels and once for the
+/// temperature.
+#define BSP_ADC_BLOCK			16
+
+/// Scans of a burst, a whole number of DMA blocks and at most 127 of them.
+/// 62.5 ms in EM1 at the default rate; the housekeeping reads the channels
+/// once a second and starts a burst each time.
+#define BSP_ADC_BURST			64
+
+#define BSP_ADC_SCANCOUNT		4			///< Channels in the scan, CHANNEL0 to CHANNEL3.
+#define BSP_ADC_DECIMATION		16			///< Default samples averaged into each value, four values a burst.
+#define BSP_ADC_MAXDECIMATION	4096		///< Most samples averaged into a value.
+#define BSP_ADC_WINDOW			4			///< Default values per min/max/mean window, one window a burst.
 
 /// Available ADC channels.
 typedef enum
@@ -58,11 +82,28 @@ typedef enum
 	CHANNELCOUNT		///< Count of ADC channels used
 } ADC_Channel_TypeDef;
 
-void      BSP_ADC_Init(void); ///< Initialise the ADC module.
-void      BSP_ADC_update(uint8_t wait); ///< Update all ADC values.
-uint8_t   BSP_ADC_isUpdateComplete(void); ///< Returns the progress of a update.
-uint16_t  BSP_ADC_getData(ADC_Channel_TypeDef channel); ///< Returns the ADC data buffer.
-uint16_t* BSP_ADC_getDataBuff(void); ///< Returns the value of a specified ADC channel.
+/// Values of a channel over its last complete window, in mV for CHANNEL0 to
+/// CHANNEL3 and in 1/256 degrees Celsius for TEMPERATURE.
+typedef struct
+{
+	int16_t  min;		///< Smallest value in the window.
+	int16_t  max;		///< Largest value in the window.
+	int16_t  mean;		///< Mean of the values in the window.
+	uint16_t window;	///< Values in a window.
+	uint32_t windows;	///< Windows completed since the channel was configured.
+	uint32_t values;	///< Values produced since the channel was configured.
+} BSP_ADC_Stats_TypeDef;
+
+void      BSP_ADC_Init(void); ///< Initialise the ADC module, not yet sampling.
+void      BSP_ADC_burst(void); ///< Sample BSP_ADC_BURST scans, then let the core enter EM2 again.
+void      BSP_ADC_stop(void); ///< Stop sampling and let the core enter EM2.
+void      BSP_ADC_start(void); ///< Sample continuously until BSP_ADC_stop.
+void      BSP_ADC_setRate(uint16_t rateHz); ///< Set the scans per second.
+void      BSP_ADC_configChannel(ADC_Channel_TypeDef channel, uint16_t decimation, uint16_t window); ///< Set the samples per value and values per window of a channel.
+uint16_t  BSP_ADC_getData(ADC_Channel_TypeDef channel); ///< Returns the latest value of a specified ADC channel.
+int16_t   BSP_ADC_getMean(ADC_Channel_TypeDef channel); ///< Returns the mean over the last window of a specified ADC channel.
+void      BSP_ADC_getStats(ADC_Channel_TypeDef channel, BSP_ADC_Stats_TypeDef *stats); ///< Copy the window statistics of a specified ADC channel.
+uint16_t* BSP_ADC_getDataBuff(void); ///< Returns the ADC data buffer.
 
 /** @} (end addtogroup ADC) */
 /** @} (end addtogroup BSP_Library) */
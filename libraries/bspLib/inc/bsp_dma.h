@@ -52,13 +52,24 @@ extern "C" {
 /// DMA channels for different CubeComputer peripherals.
 typedef enum
 {
-	DMA_CHANNEL_ADC_SCAN = 0, ///< ADC scan channel.
-	DMA_CHANNEL_ADC_SNGL = 1, ///< ADC single sample channel.
-	DMA_CHANNEL_DEBUG_TX = 2, ///< UART transmit channel.
-	DMA_CHANNEL_DEBUG_RX = 3, ///< UART receive channel.
-	DMA_CHANNEL_COUNT    = 4  ///< Total number of channels.
+	DMA_CHANNEL_ADC_SCAN   = 0, ///< ADC scan channel.
+	DMA_CHANNEL_ADC_SNGL   = 1, ///< ADC single sample channel.
+	DMA_CHANNEL_DEBUG_TX   = 2, ///< Debug UART transmit channel.
+	DMA_CHANNEL_DEBUG_RX   = 3, ///< Debug UART receive channel.
+	DMA_CHANNEL_MICROSD_TX = 4, ///< MicroSD SPI transmit channel.
+	DMA_CHANNEL_MICROSD_RX = 5, ///< MicroSD SPI receive channel.
+	DMA_CHANNEL_MISC_TX    = 6, ///< Miscellaneous UART transmit channel.
+	DMA_CHANNEL_COUNT      = 7  ///< Total number of channels.
 } DMA_Channel_TypeDef;
 
+/// DMA interrupt priority. Callbacks use FreeRTOS ...FromISR functions, so it may not be
+/// above configMAX_SYSCALL_INTERRUPT_PRIORITY (0xa0, i.e. 5 with the EFM32's 3 priority bits).
+#define DMA_IRQ_PRIORITY	5
+
+/// Alternate descriptor of a channel. The controller keeps them 0x100 bytes
+/// after the primary descriptors, at DMA->ALTCTRLBASE.
+#define DMA_ALTDESCRIPTOR( channel )	( &dmaControlBlock[16 + ( channel )] )
+
 extern DMA_DESCRIPTOR_TypeDef dmaControlBlock[]; ///< DMA descriptor configuration block.
 extern DMA_CB_TypeDef cb[]; ///< DMA callback function configuration block.
 
@@ -32,6 +32,8 @@
 #define __BSP_I2C_H
 
 #include "em_i2c.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
 
 /***************************************************************************//**
  * @addtogroup BSP_Library
@@ -60,12 +62,56 @@ typedef enum
 	bspI2CWriteWrite = I2C_FLAG_WRITE_WRITE ///< Indicate write sequence using two buffers: S+ADDR(W)+DATA0+DATA1+P.
 } BSP_I2C_ModeSelect_TydeDef;
 
+/// Result of a master transfer. The emlib transfer results, and the driver's own.
+typedef enum
+{
+	bspI2cOk         = i2cTransferDone,       ///< Transfer completed.
+	bspI2cInProgress = i2cTransferInProgress, ///< Transfer started, and not yet completed.
+	bspI2cNack       = i2cTransferNack,       ///< Address or data byte not acknowledged by the slave.
+	bspI2cBusError   = i2cTransferBusErr,     ///< Misplaced START or STOP condition on the bus.
+	bspI2cArbLost    = i2cTransferArbLost,    ///< Arbitration lost, e.g. to a slave holding SDA low.
+	bspI2cUsageFault = i2cTransferUsageFault, ///< Invalid transfer, e.g. a read of 0 bytes.
+	bspI2cSwFault    = i2cTransferSwFault,    ///< Transfer state machine fault.
+	bspI2cTimeout    = -6,                    ///< Transfer not completed in time, and aborted.
+	bspI2cBusy       = -7                     ///< Another master transfer is in progress on the channel.
+} BSP_I2C_Status_TypeDef;
+
+/// Master transfer counters of an I2C channel.
+typedef struct
+{
+	uint32_t transfers;   ///< Transfers started.
+	uint32_t completed;   ///< Transfers completed without error.
+	uint32_t txBytes;     ///< Bytes written by completed transfers.
+	uint32_t rxBytes;     ///< Bytes read by completed transfers.
+	uint32_t interrupts;  ///< Interrupts handled for master transfers.
+	uint16_t nacks;       ///< Transfers ended by a NACK.
+	uint16_t busErrors;   ///< Transfers ended by a bus error.
+	uint16_t arbLost;     ///< Transfers ended by arbitration loss.
+	uint16_t timeouts;    ///< Transfers aborted after BSP_I2C_TIMEOUT_MS.
+	uint16_t faults;      ///< Transfers refused or ended by a usage or state machine fault.
+	int8_t   lastError;   ///< Status of the last failed transfer, bspI2cOk if none failed.
+} BSP_I2C_Stats_TypeDef;
+
+/// I2C interrupt priority. Completion uses FreeRTOS ...FromISR functions, so it may not be
+/// above configMAX_SYSCALL_INTERRUPT_PRIORITY (see DMA_IRQ_PRIORITY).
+#define BSP_I2C_IRQ_PRIORITY	5
+
+/// Longest master transfer, in milliseconds. A 128 byte read takes 12 ms at 93.5 kHz.
+#define BSP_I2C_TIMEOUT_MS		50
+
 void BSP_I2C_Init (I2C_TypeDef *i2c, bool master); 					///< Initialise the specified I2C channel.
 void BSP_I2C_setSlaveMode (I2C_TypeDef *i2c, bool enable); 			///< Enable or disable slave mode for the specified I2C channel.
-uint32_t BSP_I2C_masterTX (I2C_TypeDef *i2c, uint16_t address,
+BSP_I2C_Status_TypeDef BSP_I2C_masterTX (I2C_TypeDef *i2c, uint16_t address,
 						BSP_I2C_ModeSelect_TydeDef flag,
 						uint8_t *txBuffer, uint16_t txBufferSize,
 						uint8_t *rxBuffer, uint16_t rxBufferSize); 	///< Transmit and/or receive a buffer of data over the specified I2C channel.
+BSP_I2C_Status_TypeDef BSP_I2C_masterStart (I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq, uint8_t count,
+						xSemaphoreHandle done);						///< Start a session of master transfers without waiting for it.
+BSP_I2C_Status_TypeDef BSP_I2C_masterStatus (I2C_TypeDef *i2c);		///< Status of the last master session started.
+uint8_t BSP_I2C_masterCompleted (I2C_TypeDef *i2c);					///< Transfers of the last master session that completed.
+BSP_I2C_Status_TypeDef BSP_I2C_masterAbort (I2C_TypeDef *i2c);		///< Abort the master transfer in progress.
+bool BSP_I2C_masterIRQHandler (I2C_TypeDef *i2c);					///< Run a master transfer from the channel's interrupt handler.
+void BSP_I2C_getStats (I2C_TypeDef *i2c, BSP_I2C_Stats_TypeDef *stats);	///< Copy the master transfer counters of the specified I2C channel.
 
 /** @} (end addtogroup I2C) */
 /** @} (end addtogroup BSP_Library) */
@@ -4,6 +4,10 @@
  *
  * This header file contains all the required definitions and function
  * prototypes through which to control the CubeComputer's Real Time Clock (RTC).
+ *
+ * The RTC counter runs free and is the timebase of the OBC: every time, from
+ * the seconds since start up to the date and time, is read from it, so none
+ * needs an interrupt to keep it and none drifts from the others.
  * @author	Pieter J. Botma
  * @date	14/05/2012
  *******************************************************************************
@@ -46,12 +50,18 @@
  * @{
  ******************************************************************************/
 
-void     BSP_RTC_Init (); ///< Initialise RTC.
-void     BSP_RTC_tick (); ///< Increment RTC  in milliseconds.
-void     BSP_RTC_setTime (uint32_t time); ///< Set the time of the RTC.
-uint32_t BSP_RTC_getTimeSec(); ///< Return the current seconds counter of the RTC.
-uint32_t BSP_RTC_getTimeMSec(); ///< Return the current milliseconds counter of the RTC.
+#define BSP_RTC_FREQ		32768		///< RTC counts per second, the LFXO undivided.
+#define BSP_RTC_MASK		0xFFFFFF	///< The RTC counter is 24 bits wide and runs free.
+#define BSP_RTC_SYNCCOUNTS	3			///< Counts before a compare value written takes effect.
+#define BSP_RTC_TICKCOMP	1			///< Compare channel of the RTOS tick, see bsp_sleep.c. Channel 0 is free.
 
+void     BSP_RTC_Init (); ///< Initialise RTC.
+bool     BSP_RTC_compareArm (unsigned int comp, uint32_t count); ///< Set a compare value, raising its flag if the counter is already there.
+void     BSP_RTC_overflowIRQ (void); ///< Count an overflow of the counter, from the RTC interrupt.
+uint64_t BSP_RTC_getCounts (void); ///< Counts since the RTC was initialised, the counter extended by its overflows.
+uint64_t BSP_RTC_getTimeUs (void); ///< Microseconds since the RTC was initialised.
+uint32_t BSP_RTC_getTimeSec(); ///< Return the seconds since the RTC was initialised.
+uint32_t BSP_RTC_getTimeMSec(); ///< Return the milliseconds of the current second.
 
 /** @} (end addtogroup RTC) */
 /** @} (end addtogroup BSP_Library) */
@@ -0,0 +1,88 @@
+/***************************************************************************//**
+ * @file	bsp_sleep.h
+ * @brief	BSP sleep header file.
+ *
+ * This header file contains the definitions and function prototypes of the
+ * RTOS tick and tickless idle. The RTC, not the SysTick, interrupts for each
+ * tick, so the tick keeps counting in EM2. When every task is blocked the idle
+ * task stops the tick until the first task's timeout and sleeps until then, in
+ * EM2 unless a driver holds the core in EM1 for a peripheral that needs the
+ * high frequency clocks.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __BSP_SLEEP_H
+#define __BSP_SLEEP_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/***************************************************************************//**
+ * @addtogroup BSP_Library
+ * @brief Board Support Package (<b>BSP</b>) Driver Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup SLEEP
+ * @brief API for the RTOS tick and the energy modes the idle task sleeps in.
+ * @{
+ ******************************************************************************/
+
+/// Longest sleep, in ticks. Half the span of the 24-bit RTC counter, so the
+/// tick grid can always tell how far it has moved.
+#define BSP_SLEEP_MAXTICKS		( ( portTickType ) ( 256 * configTICK_RATE_HZ ) )
+
+/// Typical supply current of the MCU in each energy mode, in uA, from the
+/// EFM32GG datasheet at 48 MHz, peripherals excluded. Used to estimate the
+/// average current from the time spent in each.
+#define BSP_SLEEP_EM0_UA		10500		///< 219 uA/MHz, running from flash.
+#define BSP_SLEEP_EM1_UA		3840		///< 80 uA/MHz, core stopped.
+#define BSP_SLEEP_EM2_UA		1			///< LFXO and RTC running.
+
+/// Sleep counters. Times are in RTC counts, 1/32768 s, and wrap like
+/// BSP_SLEEP_getTime, so rates are taken from differences.
+typedef struct
+{
+	uint32_t em1Time;     ///< Time slept in EM1.
+	uint32_t em2Time;     ///< Time slept in EM2.
+	uint32_t sleeps;      ///< Sleeps entered, each ended by the interrupt that woke the core.
+	uint32_t em2Sleeps;   ///< Sleeps entered in EM2.
+	uint32_t ticks;       ///< Tick interrupts.
+	uint32_t suppressed;  ///< Ticks stepped over while asleep instead of interrupting.
+	uint32_t aborted;     ///< Sleeps abandoned because a task became ready first.
+	uint16_t holds;       ///< Drivers holding the core in EM1 now.
+} BSP_SLEEP_Stats_TypeDef;
+
+uint32_t BSP_SLEEP_getTime (void);									///< RTC time in counts since the RTC was started, 32 bits wide.
+void     BSP_SLEEP_holdEM1 (void);									///< Keep the core out of EM2, for a peripheral that needs the HF clocks.
+void     BSP_SLEEP_releaseEM1 (void);								///< Release a hold taken by BSP_SLEEP_holdEM1.
+uint32_t BSP_SLEEP_sinceTick (void);								///< RTC counts since the last tick the kernel counted, from a critical section.
+void     BSP_SLEEP_rtcIRQ (uint32_t flags);							///< Handle the RTC tick flag, from the RTC interrupt.
+void     BSP_SLEEP_getStats (BSP_SLEEP_Stats_TypeDef *stats);		///< Copy the sleep counters.
+
+/** @} (end addtogroup SLEEP) */
+/** @} (end addtogroup BSP_Library) */
+
+#endif // __BSP_SLEEP_H
@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * @file	bsp_trace.h
+ * @brief	BSP kernel trace header file.
+ *
+ * This header file contains the definitions and function prototypes of the
+ * kernel trace recorder. The trace hooks of FreeRTOSConfig.h record every
+ * context switch and every queue, semaphore and mutex operation, and the tick
+ * interrupt records how late it ran, as 8 byte events stamped with the run
+ * time stats clock, the RTC. The events are kept in a ring that overwrites
+ * the oldest, so it always holds the latest BSP_TRACE_EVENTS.
+ *
+ * It is included by FreeRTOSConfig.h, so it must not include the kernel
+ * headers.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __BSP_TRACE_H
+#define __BSP_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/***************************************************************************//**
+ * @addtogroup BSP_Library
+ * @brief Board Support Package (<b>BSP</b>) Driver Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup TRACE
+ * @brief API for the kernel trace recorder.
+ * @{
+ ******************************************************************************/
+
+/// Events the ring holds, a power of two. 8 bytes each.
+#ifndef BSP_TRACE_EVENTS
+#define BSP_TRACE_EVENTS		512
+#endif
+
+/// Queues whose length and type are kept for the dump. Queues created after
+/// these are still numbered.
+#define BSP_TRACE_MAXQUEUES		32
+
+/// Event types.
+#define BSP_TRACE_SWITCH		0x01		///< A task was switched in. id: its task number.
+#define BSP_TRACE_SEND			0x02		///< An item was sent. id: queue number, value: items waiting after.
+#define BSP_TRACE_RECEIVE		0x03		///< An item was received. id: queue number, value: items waiting after.
+#define BSP_TRACE_SENDFAIL		0x04		///< A send found the queue full. id: queue number, value: items waiting.
+#define BSP_TRACE_ISR			0x05		///< An interrupt ran. id: IRQ number, value: RTC counts it ran after its event.
+#define BSP_TRACE_FROMISR		0x80		///< Added to a queue event made from an interrupt handler.
+
+/// A trace event. Times are the low 32 bits of the RTC counts, the kernel's
+/// run time stats clock.
+typedef struct
+{
+	uint32_t time;     ///< RTC counts when the event was recorded.
+	uint8_t  type;     ///< BSP_TRACE_SWITCH to BSP_TRACE_ISR, with BSP_TRACE_FROMISR.
+	uint8_t  id;       ///< Task, queue or IRQ number.
+	uint16_t value;    ///< Queue items or lateness, saturated.
+} BSP_TRACE_Event_TypeDef;
+
+/// A queue, as created.
+typedef struct
+{
+	uint16_t length;   ///< Items it holds.
+	uint8_t  type;     ///< queueQUEUE_TYPE_BASE to queueQUEUE_TYPE_RECURSIVE_MUTEX.
+} BSP_TRACE_Queue_TypeDef;
+
+void     BSP_TRACE_Init (void);												///< Clear the ring and start recording.
+void     BSP_TRACE_enable (bool enable);									///< Start, clearing the ring, or stop recording.
+uint32_t BSP_TRACE_written (void);											///< Events recorded since the ring was cleared.
+uint16_t BSP_TRACE_read (uint32_t first, BSP_TRACE_Event_TypeDef *events, uint16_t max);	///< Copy events out of the ring, with recording stopped.
+uint8_t  BSP_TRACE_queues (void);											///< Queues numbered so far.
+void     BSP_TRACE_getQueue (uint8_t number, BSP_TRACE_Queue_TypeDef *queue);	///< Length and type of a queue.
+
+// Kernel hooks, see FreeRTOSConfig.h
+void     BSP_TRACE_switchedIn (unsigned long task);							///< Record a context switch.
+uint8_t  BSP_TRACE_queueCreated (unsigned long length, uint8_t type);		///< Number a new queue.
+void     BSP_TRACE_queueEvent (uint8_t type, uint8_t queue, unsigned long waiting);	///< Record a queue operation.
+void     BSP_TRACE_isr (uint8_t irq, uint32_t late);						///< Record how late an interrupt ran.
+
+/** @} (end addtogroup TRACE) */
+/** @} (end addtogroup BSP_Library) */
+
+#endif // __BSP_TRACE_H
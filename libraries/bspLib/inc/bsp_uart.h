@@ -32,6 +32,8 @@
 #define __BSP_UART_H
 
 #include "em_usart.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
 
 /***************************************************************************//**
  * @addtogroup BSP_Library
@@ -51,7 +53,10 @@
 #define BSP_UART_DEBUG_CLOCK 	cmuClock_USART0				///< Debug UART clock select
 #define BSP_UART_DEBUG_LOC		USART_ROUTE_LOCATION_LOC1	///< Debug UART route location
 #define BSP_UART_DEBUG_DMAREQ	DMAREQ_USART0_TXEMPTY
+#define BSP_UART_DEBUG_RXDMAREQ	DMAREQ_USART0_RXDATAV
 #define BSP_UART_DEBUG_RX_IRQn	USART0_RX_IRQn
+#define BSP_UART_DEBUG_RXPORT	gpioPortE					///< Debug UART RX pin, E6
+#define BSP_UART_DEBUG_RXPIN	6
 
 #define	BSP_UART_MISC  			USART2  					///< Miscellaneous UART channel mapped to MCU USART1.
 #define BSP_UART_MISC_CLOCK		cmuClock_USART2  			///< Miscellaneous UART clock select
@@ -67,7 +72,10 @@
 #define BSP_UART_DEBUG_CLOCK 	cmuClock_UART1				///< Debug UART clock select
 #define BSP_UART_DEBUG_LOC		UART_ROUTE_LOCATION_LOC2	///< Debug UART route location
 #define BSP_UART_DEBUG_DMAREQ	DMAREQ_UART1_TXEMPTY
+#define BSP_UART_DEBUG_RXDMAREQ	DMAREQ_UART1_RXDATAV
 #define BSP_UART_DEBUG_RX_IRQn	UART1_RX_IRQn
+#define BSP_UART_DEBUG_RXPORT	gpioPortB					///< Debug UART RX pin, B10
+#define BSP_UART_DEBUG_RXPIN	10
 
 #define	BSP_UART_MISC  			UART0  						///< Miscellaneous UART channel mapped to MCU USART1.
 #define BSP_UART_MISC_CLOCK		cmuClock_UART0  			///< Miscellaneous UART clock select
@@ -79,13 +87,62 @@
 
 #endif
 
+/// Bytes in each half of the debug UART receive ring. The DMA fills one half
+/// while the other is read, so a half must outlast the longest time the
+/// reading task may be held off: 128 bytes is 11 ms at 115200 baud.
+#define BSP_UART_RXHALF			128
+#define BSP_UART_RXRING			( 2 * BSP_UART_RXHALF )	///< Bytes in the debug UART receive ring.
+
+/// The debug UART RX pin interrupts on the first falling edge after a quiet
+/// wait starts, through the even pin interrupt it shares with the EDAC error
+/// lines. It gives the receive semaphore, so its priority may not be above
+/// configMAX_SYSCALL_INTERRUPT_PRIORITY (see DMA_IRQ_PRIORITY).
+#define BSP_UART_RXPIN_IRQn			GPIO_EVEN_IRQn
+#define BSP_UART_RXPIN_IRQ_PRIORITY	5
+
+/// Receive counters of the debug UART.
+typedef struct
+{
+	uint32_t bytes;       ///< Bytes read from the ring.
+	uint32_t interrupts;  ///< DMA interrupts taken, one per filled half.
+	uint32_t overruns;    ///< Bytes overwritten by the DMA before they were read.
+	uint32_t quietWaits;  ///< Quiet waits, with the receiver allowed to stop in EM2.
+	uint32_t pinWakes;    ///< Quiet waits ended by an edge on the RX pin.
+} BSP_UART_RxStats_TypeDef;
+
+/// Transmit buffers of each UART channel. A message is copied into as many
+/// buffers as it needs and the DMA sends them in order, so callers return as
+/// soon as their data is copied.
+#define BSP_UART_TXSLOTS		8
+#define BSP_UART_TXSLOTLEN		128		///< Bytes in each transmit buffer.
+
+/// Transmit counters of a UART channel.
+typedef struct
+{
+	uint32_t bytes;       ///< Bytes sent.
+	uint32_t messages;    ///< Messages queued, whole or in part.
+	uint32_t transfers;   ///< DMA transfers, one per buffer sent.
+	uint32_t waits;       ///< Times a caller blocked for a free buffer.
+	uint32_t waitTicks;   ///< Ticks callers spent blocked for free buffers.
+	uint32_t dropped;     ///< Bytes not queued because no buffer was freed in time.
+	uint16_t maxQueued;   ///< Most buffers queued at once.
+} BSP_UART_TxStats_TypeDef;
 
 void    BSP_UART_Init     (USART_TypeDef *usart); 							  				///< Initialise specified UART.
 void    BSP_UART_txByte   (USART_TypeDef *usart, uint8_t data); 			  				///< Transmit one byte of data over specified UART.
-void 	BSP_UART_txBuffer (USART_TypeDef *usart, uint8_t *buff, uint8_t len, bool wait); 	///< Transmit data buffer over specified UART.
+void 	BSP_UART_txBuffer (USART_TypeDef *usart, uint8_t *buff, uint16_t len, bool wait); 	///< Transmit data buffer over specified UART.
+uint16_t BSP_UART_txQueue (USART_TypeDef *usart, const uint8_t *buff, uint16_t len, portTickType timeout);	///< Queue data for transmission, blocking at most until the timeout for buffers.
+bool    BSP_UART_txFlush  (USART_TypeDef *usart, portTickType timeout);					///< Wait until the data queued has been sent.
 bool 	BSP_UART_txInProgress (void);														///< Returns the progress of the UART DMA transmission
+void    BSP_UART_getTxStats (USART_TypeDef *usart, BSP_UART_TxStats_TypeDef *stats);		///< Copy the transmit counters of a UART channel.
 uint8_t BSP_UART_rxByte   (USART_TypeDef *usart); 							  				///< Receive a byte of data over specified UART.
 void    BSP_UART_rxBuffer (USART_TypeDef *usart, uint8_t *buff, uint8_t len); 				///< Receive data buffer over specified UART.
+bool    BSP_UART_rxWait   (portTickType timeout);											///< Wait for debug UART data, at most until the timeout.
+bool    BSP_UART_rxWaitQuiet (portTickType timeout);										///< Wait for the idle debug UART line to become active, letting the core sleep in EM2.
+void    BSP_UART_rxWakeFromISR (portBASE_TYPE *woken);										///< End a wait for debug UART data early, from an interrupt handler.
+void    BSP_UART_rxPinIRQ (void);															///< Handle the RX pin interrupt, from GPIO_EVEN_IRQHandler.
+uint16_t BSP_UART_rxRead  (uint8_t *buff, uint16_t len);									///< Read debug UART data received so far.
+void    BSP_UART_getRxStats (BSP_UART_RxStats_TypeDef *stats);								///< Copy the debug UART receive counters.
 
 /** @} (end addtogroup UART) */
 /** @} (end addtogroup BSP_Library) */
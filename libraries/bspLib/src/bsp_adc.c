@@ -1,9 +1,18 @@
 /***************************************************************************//**
- * @file	bsp_adc.h
- * @brief	BSP ADC header file.
+ * @file	bsp_adc.c
+ * @brief	BSP ADC source file.
  *
- * This header file contains all the required definitions and function
- * prototypes through which to control the CubeComputer's ADC module.
+ * This file contains the ADC sampling engine. LETIMER0 triggers a scan of the
+ * four ADC channels and a temperature conversion at a fixed rate, and the DMA
+ * moves the results into ping-pong buffers. Each half is processed when it
+ * fills: every channel averages its own number of samples into a value, scaled
+ * with integer arithmetic, and keeps the minimum, maximum and mean of its values
+ * over a window.
+ *
+ * The ADC and DMA need the HF clocks, so the core is held out of EM2 while
+ * scans are triggered. Sampling therefore runs in bursts of BSP_ADC_BURST
+ * scans, a window at the default configuration, which the user starts once
+ * per window; the trigger stops and the hold is released as the burst ends.
  * @author	Pieter J. Botma
  * @date	15/05/2012
  *******************************************************************************
@@ -30,8 +39,10 @@
 
 #include "bsp_adc.h"
 #include "bsp_dma.h"
+#include "bsp_sleep.h"
 #include "em_cmu.h"
-#include "em_emu.h"
+#include "em_letimer.h"
+#include "em_prs.h"
 
 /***************************************************************************//**
  * @addtogroup BSP_Library
@@ -45,33 +56,145 @@
  * @{
  ******************************************************************************/
 
-volatile uint8_t isScanComplete,///< ADC scan complete flag (current & voltage).
-		isSingleComplete; 		///< ADC single flag (temperature).
-uint16_t adcData [CHANNELCOUNT];///< ADC channel data buffer.
-
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
-float adc0_calTemp0; ///< On-chip calibration temperature
-float adc0_temp0Read1V25; ///< On-chip calibration reading
+// Temperature slope: 1.25 V / 4096 per LSB over -1.92 mV per degree, exactly
+// 15625 / 384 (40.690) 1/256 degrees per LSB. Reference manual section 28.3.4.2.
+#define ADC_TEMPGAIN_NUM	15625
+#define ADC_TEMPGAIN_DEN	384
+
+/// Averaging and windowing state of a channel. Written only by the DMA callbacks
+/// once sampling has started.
+typedef struct
+{
+	uint16_t decimation;		// Samples per value
+	uint16_t samples;			// Samples in the value being averaged
+	uint32_t sum;				// Their sum
+	uint16_t values;			// Values in the window being collected
+	int16_t  min;
+	int16_t  max;
+	int32_t  windowSum;
+	BSP_ADC_Stats_TypeDef stats;	// The last complete window
+} ADC_ChannelState_TypeDef;
+
+uint16_t adcData [CHANNELCOUNT];///< Latest value of each channel.
+
+static ADC_ChannelState_TypeDef adcState [CHANNELCOUNT];
+
+static uint16_t scanBuff [2][BSP_ADC_BLOCK * BSP_ADC_SCANCOUNT];	// DMA ping-pong halves of scan results
+static uint16_t tempBuff [2][BSP_ADC_BLOCK];						// and of temperature results
+
+static bool adcRunning = false; ///< Whether LETIMER0 triggers scans continuously, holding EM1
+static volatile uint8_t burstLeft = 0; ///< DMA block callbacks until the burst ends, holding EM1 while non-zero
+
+static int32_t adc0_calTemp0; ///< On-chip calibration temperature
+static int32_t adc0_temp0Read1V25; ///< On-chip calibration reading
+
+/*
+ * Scales the sum of n samples of a channel: 16 bit oversampled scan results to
+ * mV of the 1.25 V reference, rounded, and 12 bit temperature results to 1/256
+ * degrees, rounded. n is at most BSP_ADC_MAXDECIMATION, so no product overflows.
+ */
+static int16_t toValue (ADC_Channel_TypeDef channel, uint32_t sum, uint16_t n)
+{
+	uint32_t mean;
+	int32_t diff;
+
+	if (channel == TEMPERATURE)
+	{
+		// Mean reading below the calibration reading, in 1/16 LSB
+		diff = adc0_temp0Read1V25 * 16 - (int32_t)((sum * 16 + n / 2) / n);
+		diff *= ADC_TEMPGAIN_NUM;
+		return (int16_t)(adc0_calTemp0 * 256 + (diff + (diff < 0 ? -8 : 8) * ADC_TEMPGAIN_DEN) / (16 * ADC_TEMPGAIN_DEN));
+	}
+
+	mean = (sum + n / 2) / n;
+	return (int16_t)((mean * 1250 + 32768) >> 16);
+}
+
+/*
+ * Adds a sample to a channel, completing a value every decimation samples and
+ * a window every window values. The statistics of a window are published in
+ * one go, with stats.values counted last, so readers can tell a copy taken
+ * across an update.
+ */
+static void addSample (ADC_Channel_TypeDef channel, uint16_t sample)
+{
+	ADC_ChannelState_TypeDef *ch = &adcState[channel];
+	int16_t value;
+
+	ch->sum += sample;
+	if (++ch->samples < ch->decimation)
+		return;
+
+	value = toValue(channel, ch->sum, ch->samples);
+	ch->sum = 0;
+	ch->samples = 0;
+	adcData[channel] = (uint16_t)value;
+
+	if (ch->values == 0 || value < ch->min)
+		ch->min = value;
+	if (ch->values == 0 || value > ch->max)
+		ch->max = value;
+	ch->windowSum += value;
+
+	if (++ch->values == ch->stats.window)
+	{
+		ch->stats.min = ch->min;
+		ch->stats.max = ch->max;
+		ch->stats.mean = (int16_t)(ch->windowSum / ch->values);
+		ch->stats.windows++;
+		ch->values = 0;
+		ch->windowSum = 0;
+	}
+	ch->stats.values++;
+}
+
+/*
+ * Counts a block of a burst. The other channel's last block completes within
+ * a conversion of this one's, so the trigger is stopped at the first of the
+ * two, before the next scan, and the hold is released at the second.
+ */
+static void burstBlockDone (void)
+{
+  if (burstLeft == 0)
+    return;
+
+  burstLeft--;
+  if (burstLeft == 1)
+    LETIMER_Enable(LETIMER0, false);
+  else if (burstLeft == 0)
+    BSP_SLEEP_releaseEM1();
+}
 
 void scanComplete (unsigned int channel, bool primary, void *user)
 {
-	adcData [CHANNEL0] = (uint16_t)((adcData [CHANNEL0] * 1.25*1000.0) / 65536.0); // adc*milli-ref/V-to-A/resolution
-	adcData [CHANNEL1] = (uint16_t)((adcData [CHANNEL1] * 1.25*1000.0) / 65536.0); // adc*milli-ref/V-to-A/resolution
-	adcData [CHANNEL2] = (uint16_t)((adcData [CHANNEL2] * 1.25*1000.0) / 65536.0); // adc*milli-ref/resolution/ratio
-	adcData [CHANNEL3] = (uint16_t)((adcData [CHANNEL3] * 1.25*1000.0) / 65536.0); // adc*milli-ref/resolution/ratio
+	const uint16_t *sample = scanBuff[primary ? 0 : 1];
+	uint8_t i, c;
+
+	// The DMA returns to this half once the other is full
+	DMA_RefreshPingPong(channel, primary, false, NULL, NULL, BSP_ADC_BLOCK * BSP_ADC_SCANCOUNT - 1, false);
+
+	for (i = 0; i < BSP_ADC_BLOCK; i++)
+	{
+		for (c = 0; c < BSP_ADC_SCANCOUNT; c++)
+			addSample((ADC_Channel_TypeDef)c, *sample++);
+	}
 
-	isScanComplete = 1;
+	burstBlockDone();
 }
 
 void singleComplete (unsigned int channel, bool primary, void *user)
 {
-	// see reference manual section 28.3.4.2, equation 28.2
-	float temp = adc0_calTemp0 - ( ( adc0_temp0Read1V25 - adcData [TEMPERATURE] )/4096.0*1.25*1000.0/-1.92 );
+	const uint16_t *sample = tempBuff[primary ? 0 : 1];
+	uint8_t i;
+
+	DMA_RefreshPingPong(channel, primary, false, NULL, NULL, BSP_ADC_BLOCK - 1, false);
 
-	adcData [TEMPERATURE] = (uint16_t)(temp*256.0); // assume temperature < +/-128
+	for (i = 0; i < BSP_ADC_BLOCK; i++)
+		addSample(TEMPERATURE, sample[i]);
 
-	isSingleComplete = 1;
+	burstBlockDone();
 }
 
 /** @endcond */
@@ -81,15 +204,30 @@ void singleComplete (unsigned int channel, bool primary, void *user)
  * @date   21/05/2012
  *
  * This function initialises the CubeComputer's internal ADC module which is
- * used to sample the predefined \link ADC_Channel_TypeDef channels \endlink.
+ * used to sample the predefined \link ADC_Channel_TypeDef channels \endlink,
+ * and sets the scan rate to BSP_ADC_RATE_HZ. Each channel averages
+ * BSP_ADC_DECIMATION samples into a value and keeps statistics over
+ * BSP_ADC_WINDOW values until configured otherwise. BSP_DMA_Init must have been
+ * called.
  *
  ******************************************************************************/
 void BSP_ADC_Init(void)
 {
-  // Enable clocks used by ADC Sensors
+  uint8_t i;
+
+  // Enable clocks used by ADC Sensors and their trigger
   CMU_ClockEnable(cmuClock_HFPER, true);
   CMU_ClockEnable(cmuClock_ADC0, true);
   CMU_ClockEnable(cmuClock_DMA, true);
+  CMU_ClockEnable(cmuClock_PRS, true);
+  CMU_ClockEnable(cmuClock_CORELE, true);
+  CMU_ClockEnable(cmuClock_LETIMER0, true);
+
+  for (i = 0; i < CHANNELCOUNT; i++)
+  {
+    adcState[i].decimation = BSP_ADC_DECIMATION;
+    adcState[i].stats.window = BSP_ADC_WINDOW;
+  }
 
   // Configure DMA for ADC Sensors
   DMA_CfgChannel_TypeDef scanChnlCfg;
@@ -120,23 +258,33 @@ void BSP_ADC_Init(void)
   singleChnlCfg.cb        = &(cb[DMA_CHANNEL_ADC_SNGL]);
   DMA_CfgChannel(DMA_CHANNEL_ADC_SNGL, &singleChnlCfg);
 
-  // Configure descriptors for DMA transfers
+  // Configure descriptors for DMA transfers, both halves of the ping-pong cycles
 
-  // Single
+  // Scan
   scanDescrCfg.dstInc  = dmaDataInc2;
   scanDescrCfg.srcInc  = dmaDataIncNone;
   scanDescrCfg.size    = dmaDataSize2;
   scanDescrCfg.arbRate = dmaArbitrate1;
   scanDescrCfg.hprot   = 0;
   DMA_CfgDescr(DMA_CHANNEL_ADC_SCAN, true, &scanDescrCfg);
+  DMA_CfgDescr(DMA_CHANNEL_ADC_SCAN, false, &scanDescrCfg);
 
-  // Scan
-  singleDescrCfg.dstInc  = dmaDataIncNone;
+  // Single
+  singleDescrCfg.dstInc  = dmaDataInc2;
   singleDescrCfg.srcInc  = dmaDataIncNone;
   singleDescrCfg.size    = dmaDataSize2;
   singleDescrCfg.arbRate = dmaArbitrate1;
   singleDescrCfg.hprot   = 0;
   DMA_CfgDescr(DMA_CHANNEL_ADC_SNGL, true, &singleDescrCfg);
+  DMA_CfgDescr(DMA_CHANNEL_ADC_SNGL, false, &singleDescrCfg);
+
+  DMA_ActivatePingPong(DMA_CHANNEL_ADC_SCAN, false,
+                       scanBuff[0], (void *)((uint32_t) &(ADC0->SCANDATA)), BSP_ADC_BLOCK * BSP_ADC_SCANCOUNT - 1,
+                       scanBuff[1], (void *)((uint32_t) &(ADC0->SCANDATA)), BSP_ADC_BLOCK * BSP_ADC_SCANCOUNT - 1);
+
+  DMA_ActivatePingPong(DMA_CHANNEL_ADC_SNGL, false,
+                       tempBuff[0], (void *)((uint32_t) &(ADC0->SINGLEDATA)), BSP_ADC_BLOCK - 1,
+                       tempBuff[1], (void *)((uint32_t) &(ADC0->SINGLEDATA)), BSP_ADC_BLOCK - 1);
 
   // Configure ADC Sensors
   ADC_Init_TypeDef       init       = ADC_INIT_DEFAULT;
@@ -150,9 +298,11 @@ void BSP_ADC_Init(void)
   init.tailgate   = true;
   ADC_Init(ADC0, &init);
 
-  // Init ADC scan settings
+  // Init ADC scan settings, started by the trigger
   scanInit.resolution = adcResOVS;
   scanInit.reference  = adcRef1V25;
+  scanInit.prsEnable  = true;
+  scanInit.prsSel     = (ADC_PRSSEL_TypeDef)(adcPRSSELCh0 + BSP_ADC_PRSCH);
 #if defined(CubeCompV2B)
   scanInit.input      = ADC_SCANCTRL_INPUTMASK_CH4 |
                         ADC_SCANCTRL_INPUTMASK_CH5 |
@@ -166,70 +316,182 @@ void BSP_ADC_Init(void)
 #endif
   ADC_InitScan(ADC0, &scanInit);
 
-  // Init ADC single settings (temp cannot be selected as scan input)
+  // Init ADC single settings (temp cannot be selected as scan input), started by the same trigger
   singleInit.reference  = adcRef1V25;
   singleInit.acqTime    = adcAcqTime32;
   singleInit.input      = adcSingleInpTemp;
+  singleInit.prsEnable  = true;
+  singleInit.prsSel     = (ADC_PRSSEL_TypeDef)(adcPRSSELCh0 + BSP_ADC_PRSCH);
   ADC_InitSingle(ADC0, &singleInit);
 
   // Calibration values
-  adc0_calTemp0      = (float)((DEVINFO->CAL & _DEVINFO_CAL_TEMP_MASK) >> _DEVINFO_CAL_TEMP_SHIFT);
-  adc0_temp0Read1V25 = (float)((DEVINFO->ADC0CAL2 & _DEVINFO_ADC0CAL2_TEMP1V25_MASK) >> _DEVINFO_ADC0CAL2_TEMP1V25_SHIFT);
+  adc0_calTemp0      = (DEVINFO->CAL & _DEVINFO_CAL_TEMP_MASK) >> _DEVINFO_CAL_TEMP_SHIFT;
+  adc0_temp0Read1V25 = (DEVINFO->ADC0CAL2 & _DEVINFO_ADC0CAL2_TEMP1V25_MASK) >> _DEVINFO_ADC0CAL2_TEMP1V25_SHIFT;
+
+  // LETIMER0 pulses output 0 on every underflow, which PRS passes to the ADC
+  LETIMER_Init_TypeDef letimerInit = LETIMER_INIT_DEFAULT;
+  letimerInit.enable  = false;
+  letimerInit.comp0Top = true;
+  letimerInit.ufoa0   = letimerUFOAPulse;
+  letimerInit.repMode = letimerRepeatFree;
+  LETIMER_Init(LETIMER0, &letimerInit);
+  LETIMER_RepeatSet(LETIMER0, 0, 1);	// Output actions only happen while REP0 is non-zero
+
+  PRS_SourceSignalSet(BSP_ADC_PRSCH, PRS_CH_CTRL_SOURCESEL_LETIMER0, PRS_CH_CTRL_SIGSEL_LETIMER0CH0, prsEdgeOff);
+
+  BSP_ADC_setRate(BSP_ADC_RATE_HZ);
+
+  // Nothing is sampled, and EM2 is not held off, until BSP_ADC_burst or BSP_ADC_start
 }
 
 /***************************************************************************//**
- * @author Pieter J. Botma
- * @date   21/05/2012
+ * @author Andre Heunis
+ * @date   16/10/2026
  *
- * This function updates the ADC data buffer by scanning the ADC channels
- * (current and voltage levels) and sampling the on-chip temperature sensor.
+ * This function starts a burst of BSP_ADC_BURST scans at the rate set,
+ * holding the core out of EM2 until the burst's last DMA block is processed,
+ * BSP_ADC_BURST / BSP_ADC_RATE_HZ seconds later. At the default configuration
+ * each burst completes one window of every channel. Nothing is done while a
+ * burst is in progress or sampling is continuous.
  *
- * @param [in] wait
- *   Determines if the function should wait, in sleep mode, until update
- *   completes or immediately return from subroutine.
+ ******************************************************************************/
+void BSP_ADC_burst (void)
+{
+  NVIC_DisableIRQ(DMA_IRQn);
+  if (!adcRunning && burstLeft == 0)
+  {
+    BSP_SLEEP_holdEM1();
+    burstLeft = 2 * (BSP_ADC_BURST / BSP_ADC_BLOCK);	// A block of scans and one of temperatures each
+    LETIMER_Enable(LETIMER0, true);
+  }
+  NVIC_EnableIRQ(DMA_IRQn);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function stops continuous sampling or a burst and releases the EM1
+ * hold, so the core may enter EM2 while no module needs the ADC channels. The
+ * values and statistics keep what was collected; a part filled DMA block is
+ * completed once sampling is started again.
  *
  ******************************************************************************/
-void BSP_ADC_update (uint8_t wait)
+void BSP_ADC_stop (void)
 {
-  DMA_ActivateBasic(DMA_CHANNEL_ADC_SCAN, true, false, adcData,
-                     (void *)((uint32_t) &(ADC0->SCANDATA)), 4-1);
+  NVIC_DisableIRQ(DMA_IRQn);
+  if (adcRunning || burstLeft > 0)
+  {
+    LETIMER_Enable(LETIMER0, false);
+    BSP_SLEEP_releaseEM1();
+    adcRunning = false;
+    burstLeft = 0;
+  }
+  NVIC_EnableIRQ(DMA_IRQn);
+}
 
-  DMA_ActivateBasic(DMA_CHANNEL_ADC_SNGL, true, false, &(adcData[TEMPERATURE]),
-                       (void *)((uint32_t) &(ADC0->SINGLEDATA)), 1-1);
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function samples continuously, at the rate set, until BSP_ADC_stop,
+ * holding the core out of EM2 all the while. A burst in progress carries on
+ * without end.
+ *
+ ******************************************************************************/
+void BSP_ADC_start (void)
+{
+  NVIC_DisableIRQ(DMA_IRQn);
+  if (!adcRunning)
+  {
+    // A burst's hold becomes the continuous one
+    if (burstLeft > 0)
+      burstLeft = 0;
+    else
+      BSP_SLEEP_holdEM1();
+    LETIMER_Enable(LETIMER0, true);
+    adcRunning = true;
+  }
+  NVIC_EnableIRQ(DMA_IRQn);
+}
 
-  isScanComplete   = 0;
-  isSingleComplete = 0;
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets the number of scans per second. The LETIMER0 clock is
+ * divided down, so the rate is rounded to the nearest that divides it.
+ *
+ * @param [in] rateHz
+ *   Scans per second, from 1 to BSP_ADC_MAXRATE_HZ.
+ *
+ ******************************************************************************/
+void BSP_ADC_setRate (uint16_t rateHz)
+{
+  uint32_t clockHz = CMU_ClockFreqGet(cmuClock_LETIMER0);
 
-  ADC_Start(ADC0, adcStartScanAndSingle);
+  if (rateHz == 0)
+    rateHz = 1;
+  else if (rateHz > BSP_ADC_MAXRATE_HZ)
+    rateHz = BSP_ADC_MAXRATE_HZ;
 
-  // wait for temp measurement to finnish
-  while (wait && !BSP_ADC_isUpdateComplete())
-  {
-	  EMU_EnterEM1();
-  }
+  LETIMER_CompareSet(LETIMER0, 0, (clockHz + rateHz / 2) / rateHz - 1);
 }
 
 /***************************************************************************//**
- * @author Pieter J. Botma
- * @date   21/05/2012
+ * @author Andre Heunis
+ * @date   16/10/2026
  *
- * This function return true if both the channels have been scanned and the
- * temperature has been sampled.
+ * This function sets how many samples of a channel are averaged into each of
+ * its values, which sets its value rate to the scan rate over \b decimation,
+ * and how many values make up a window of its statistics. The value and
+ * window being collected are restarted.
+ *
+ * @param [in] channel
+ *   The channel to configure.
+ * @param [in] decimation
+ *   Samples per value, from 1 to BSP_ADC_MAXDECIMATION.
+ * @param [in] window
+ *   Values per window, at least 1.
  *
- * @return
- * 	 True if both the channels have been scanned and the.
  ******************************************************************************/
-uint8_t BSP_ADC_isUpdateComplete (void)
+void BSP_ADC_configChannel (ADC_Channel_TypeDef channel, uint16_t decimation, uint16_t window)
 {
-  return (isScanComplete && isSingleComplete);
+  ADC_ChannelState_TypeDef *ch;
+
+  if (channel >= CHANNELCOUNT)
+    return;
+
+  if (decimation == 0)
+    decimation = 1;
+  else if (decimation > BSP_ADC_MAXDECIMATION)
+    decimation = BSP_ADC_MAXDECIMATION;
+
+  if (window == 0)
+    window = 1;
+
+  ch = &adcState[channel];
+
+  // The DMA callbacks update the state
+  NVIC_DisableIRQ(DMA_IRQn);
+  ch->decimation = decimation;
+  ch->samples = 0;
+  ch->sum = 0;
+  ch->values = 0;
+  ch->windowSum = 0;
+  ch->stats.window = window;
+  ch->stats.windows = 0;
+  ch->stats.values = 0;
+  NVIC_EnableIRQ(DMA_IRQn);
 }
 
 /***************************************************************************//**
  * @author Pieter J. Botma
  * @date   21/05/2012
  *
- * This function returns the value, as an unsigned integer, of a specified
- * ADC \b channel.
+ * This function returns the latest value, as an unsigned integer, of a
+ * specified ADC \b channel: mV for CHANNEL0 to CHANNEL3 and 1/256 degrees
+ * Celsius, two's complement, for TEMPERATURE. It never waits for a conversion.
  *
  * @param [in] channel
  *   The specified channel which value should be returned.
@@ -238,15 +500,56 @@ uint8_t BSP_ADC_isUpdateComplete (void)
  ******************************************************************************/
 uint16_t BSP_ADC_getData (ADC_Channel_TypeDef channel)
 {
-	switch (channel)
+	return (channel < CHANNELCOUNT) ? adcData [channel] : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the mean of the values of a specified ADC \b channel
+ * over its last complete window, in the units of BSP_ADC_getData.
+ *
+ * @param [in] channel
+ *   The specified channel which mean should be returned.
+ * @return
+ * 	 The mean, or 0 before the first window completes.
+ ******************************************************************************/
+int16_t BSP_ADC_getMean (ADC_Channel_TypeDef channel)
+{
+	return (channel < CHANNELCOUNT) ? adcState[channel].stats.mean : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the statistics of a specified ADC \b channel over its
+ * last complete window. It copies again if a DMA callback updated them
+ * meanwhile, so it never masks interrupts.
+ *
+ * @param [in] channel
+ *   The specified channel.
+ * @param [out] stats
+ *   Copy of the statistics.
+ ******************************************************************************/
+void BSP_ADC_getStats (ADC_Channel_TypeDef channel, BSP_ADC_Stats_TypeDef *stats)
+{
+	const volatile BSP_ADC_Stats_TypeDef *src;
+
+	if (channel >= CHANNELCOUNT)
+		return;
+
+	src = &adcState[channel].stats;
+	do
 	{
-	case (0): 	return adcData [0];
-	case (1): 	return adcData [1];
-	case (2): 	return adcData [2];
-	case (3): 	return adcData [3];
-	case (TEMPERATURE): return adcData [TEMPERATURE];
-	default: 			return 0;
-	}
+		stats->values  = src->values;
+		stats->min     = src->min;
+		stats->max     = src->max;
+		stats->mean    = src->mean;
+		stats->window  = src->window;
+		stats->windows = src->windows;
+	} while (stats->values != src->values);
 }
 
 /***************************************************************************//**
@@ -264,21 +567,5 @@ uint16_t* BSP_ADC_getDataBuff (void)
   return adcData;
 }
 
-/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
-
-void ADC0_IRQHandler(void)
-{
-  // Reset all pending interupts
-  ADC_IntClear(ADC0, ADC_IFC_SINGLE);
-
-  float tmp = adc0_calTemp0 + ( ( (ADC0->SINGLEDATA) - adc0_temp0Read1V25 )/4096*1.25*1000/-1.92 );
-
-  adcData [TEMPERATURE] = (uint16_t) (tmp*256.0);
-
-  isSingleComplete = 1;
-}
-
-/** @endcond */
-
 /** @} (end addtogroup ADC) */
 /** @} (end addtogroup BSP_Library) */
@@ -75,6 +75,9 @@ void BSP_DMA_Init (void)
 	dmaInit.hprot = 0;
 	dmaInit.controlBlock = dmaControlBlock;
 	DMA_Init(&dmaInit);
+
+	// Callbacks may wake tasks, so the interrupt must be masked by FreeRTOS critical sections
+	NVIC_SetPriority(DMA_IRQn, DMA_IRQ_PRIORITY);
 }
 
 /** @} (end addtogroup DMA) */
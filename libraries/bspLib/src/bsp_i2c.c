@@ -32,6 +32,8 @@
 #include "em_i2c.h"
 #include "em_cmu.h"
 #include "em_gpio.h"
+#include "task.h"
+#include "bsp_sleep.h"
 
 /***************************************************************************//**
  * @addtogroup BSP_Library
@@ -47,6 +49,108 @@
 
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
+#define BSP_I2C_POLL_RETRIES	0x0FFFFF	// I2C_Transfer calls for a polled transfer
+
+/// Master transfer state of an I2C channel.
+typedef struct
+{
+	I2C_TypeDef *i2c;
+	IRQn_Type irq;
+	I2C_TransferSeq_TypeDef * volatile active;	// Transfer in progress, NULL when idle
+	I2C_TransferSeq_TypeDef *session;			// Transfers of the session in progress
+	uint8_t count;								// Transfers in the session
+	volatile uint8_t index;						// Session transfer in progress
+	volatile uint8_t completed;					// Transfers of the last session that completed
+	xSemaphoreHandle done;						// Given when the session completes
+	volatile BSP_I2C_Status_TypeDef status;		// Status of the last session started
+	I2C_TransferSeq_TypeDef seq;				// Transfer of BSP_I2C_masterTX
+	xSemaphoreHandle txDone;					// Completion of BSP_I2C_masterTX
+	xSemaphoreHandle lock;						// Serialises BSP_I2C_masterTX callers
+	BSP_I2C_Stats_TypeDef stats;
+} I2C_Master_TypeDef;
+
+static I2C_Master_TypeDef masters[2];
+
+static I2C_Master_TypeDef* GetMaster (I2C_TypeDef *i2c)
+{
+	if(i2c == BSP_I2C_SYS)
+		return &masters[0];
+	else if (i2c == BSP_I2C_SUB)
+		return &masters[1];
+	return NULL;
+}
+
+static void InitMaster (I2C_TypeDef *i2c, IRQn_Type irq)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+
+	if(master->lock == NULL)
+	{
+		master->lock = xSemaphoreCreateMutex();
+		vSemaphoreCreateBinary(master->txDone);
+		xSemaphoreTake(master->txDone, 0);
+	}
+	master->i2c    = i2c;
+	master->irq    = irq;
+	master->active = NULL;
+	master->status = bspI2cOk;
+
+	// Transfers are run from the interrupt handler, enabled by I2C_TransferInit
+	NVIC_SetPriority(irq, BSP_I2C_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(irq);
+	NVIC_EnableIRQ(irq);
+}
+
+// Counts the result of the active transfer
+static void MasterCount (I2C_Master_TypeDef *master, BSP_I2C_Status_TypeDef status)
+{
+	I2C_TransferSeq_TypeDef *seq = master->active;
+
+	switch(status)
+	{
+	case bspI2cOk:
+		master->stats.completed++;
+		if(seq->flags & I2C_FLAG_READ)
+			master->stats.rxBytes += seq->buf[0].len;
+		else
+			master->stats.txBytes += seq->buf[0].len;
+		if(seq->flags & I2C_FLAG_WRITE_READ)
+			master->stats.rxBytes += seq->buf[1].len;
+		else if(seq->flags & I2C_FLAG_WRITE_WRITE)
+			master->stats.txBytes += seq->buf[1].len;
+		break;
+	case bspI2cNack:
+		master->stats.nacks++;
+		break;
+	case bspI2cBusError:
+		master->stats.busErrors++;
+		break;
+	case bspI2cArbLost:
+		master->stats.arbLost++;
+		break;
+	case bspI2cTimeout:
+		master->stats.timeouts++;
+		break;
+	default:
+		master->stats.faults++;
+		break;
+	}
+	if(status != bspI2cOk)
+		master->stats.lastError = status;
+}
+
+// Ends the session with the result of the active transfer
+static void MasterComplete (I2C_Master_TypeDef *master, BSP_I2C_Status_TypeDef status)
+{
+	MasterCount(master, status);
+
+	master->completed = master->index + ((status == bspI2cOk) ? 1 : 0);
+	master->status    = status;
+	master->active    = NULL;
+
+	BSP_SLEEP_releaseEM1();
+}
+
 void InitSys (bool master)
 {
 	// Setup clocks
@@ -88,6 +192,10 @@ void InitSys (bool master)
 		NVIC_ClearPendingIRQ(I2C0_IRQn);
 		NVIC_EnableIRQ(I2C0_IRQn);
 	}
+	else
+	{
+		InitMaster(I2C0, I2C0_IRQn);
+	}
 }
 
 
@@ -131,6 +239,10 @@ void InitSub (bool master)
 		NVIC_ClearPendingIRQ(I2C1_IRQn);
 		NVIC_EnableIRQ(I2C1_IRQn);
 	}
+	else
+	{
+		InitMaster(I2C1, I2C1_IRQn);
+	}
 }
 
 /** @endcond */
@@ -195,6 +307,10 @@ void BSP_I2C_setSlaveMode(I2C_TypeDef *i2c, bool enable)
  * module, \b address, by transmitting \b txBuffer and or receiving \b rxBuffer
  * over the specified I2C channel.
  *
+ * The calling task is blocked until the transfer completes, while the transfer
+ * is run from the I2C interrupt. Callers of the same channel are served in turn.
+ * Before the scheduler is started, the transfer is polled.
+ *
  * @param[in] i2c
  *   Pointer to the I2C module to be used.
  * @param[in] address
@@ -209,39 +325,309 @@ void BSP_I2C_setSlaveMode(I2C_TypeDef *i2c, bool enable)
  *   Pointer to buffer where data, received over the specified I2C channel, should be saved.
  * @param[in] rxBufferSize
  *   Number of bytes received over the specified I2C channel.
+ * @return
+ *   bspI2cOk, or the reason the transfer failed.
  ******************************************************************************/
-uint32_t BSP_I2C_masterTX (I2C_TypeDef *i2c, uint16_t address, BSP_I2C_ModeSelect_TydeDef flag,
+BSP_I2C_Status_TypeDef BSP_I2C_masterTX (I2C_TypeDef *i2c, uint16_t address, BSP_I2C_ModeSelect_TydeDef flag,
 					  uint8_t *txBuffer, uint16_t txBufferSize,
 					  uint8_t *rxBuffer, uint16_t rxBufferSize)
 {
-  //i2cDisableSlaveInterrupts();
-  //BSP_I2C_setSlaveMode(i2c,0);
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+	I2C_TransferReturn_TypeDef result;
+	BSP_I2C_Status_TypeDef status;
+	uint32_t timeout;
+	bool running;
+
+	if(master == NULL || master->lock == NULL)
+		return bspI2cUsageFault;
+
+	running = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+
+	if(xSemaphoreTake(master->lock, running ? (2 * BSP_I2C_TIMEOUT_MS) / portTICK_RATE_MS : 0) != pdTRUE)
+		return bspI2cBusy;
+
+	// Initializing I2C transfer
+	master->seq.addr        = address;
+	master->seq.flags       = flag;
+	master->seq.buf[0].data = txBuffer;
+	master->seq.buf[0].len  = txBufferSize;
+	master->seq.buf[1].data = rxBuffer;
+	master->seq.buf[1].len  = rxBufferSize;
+
+	if(running)
+	{
+		status = BSP_I2C_masterStart(i2c, &master->seq, 1, master->txDone);
+
+		if(status == bspI2cInProgress)
+		{
+			if(xSemaphoreTake(master->txDone, BSP_I2C_TIMEOUT_MS / portTICK_RATE_MS) != pdTRUE)
+			{
+				BSP_I2C_masterAbort(i2c);
+				xSemaphoreTake(master->txDone, 0);	// in case it completed while aborting
+			}
+			status = master->status;
+		}
+	}
+	else
+	{
+		// Initialisation happens before the scheduler is started, with interrupts masked
+		NVIC_DisableIRQ(master->irq);
+
+		status = BSP_I2C_masterStart(i2c, &master->seq, 1, NULL);
+		if(status == bspI2cInProgress)
+		{
+			timeout = BSP_I2C_POLL_RETRIES;
+			do
+			{
+				result = I2C_Transfer(i2c);
+			}
+			while (result == i2cTransferInProgress && --timeout != 0);
+
+			if(result == i2cTransferInProgress)
+				BSP_I2C_masterAbort(i2c);
+			else
+				MasterComplete(master, (BSP_I2C_Status_TypeDef)result);
+			status = master->status;
+		}
+
+		NVIC_ClearPendingIRQ(master->irq);
+		NVIC_EnableIRQ(master->irq);
+	}
+
+	xSemaphoreGive(master->lock);
+
+	return status;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function starts a session of master transfers and returns without
+ * waiting for it. The transfers are run one after the other from the I2C
+ * interrupt, which starts each transfer as soon as the previous one completes,
+ * so the bus is not left idle while a task is woken in between. \b done is
+ * given when the last transfer completes or one fails, after which
+ * BSP_I2C_masterStatus returns the result and BSP_I2C_masterCompleted the
+ * number of transfers that completed. Transfers after a failed one are not run.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module to be used.
+ * @param[in] seq
+ *   Transfers to run. They must remain valid until the session completes.
+ * @param[in] count
+ *   Number of transfers in \b seq.
+ * @param[in] done
+ *   Semaphore given on completion, or NULL to poll BSP_I2C_masterStatus.
+ * @return
+ *   bspI2cInProgress if the session was started, bspI2cBusy if another
+ *   session is in progress, or the reason the first transfer was refused.
+ ******************************************************************************/
+BSP_I2C_Status_TypeDef BSP_I2C_masterStart (I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq, uint8_t count,
+											xSemaphoreHandle done)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+	I2C_TransferReturn_TypeDef result;
+
+	if(master == NULL || master->lock == NULL || count == 0)
+		return bspI2cUsageFault;
+
+	// The interrupt may not run before the transfer is set up
+	taskENTER_CRITICAL();
+
+	if(master->active != NULL)
+	{
+		taskEXIT_CRITICAL();
+		return bspI2cBusy;
+	}
+
+	// The I2C master needs the HF clocks until the session ends
+	BSP_SLEEP_holdEM1();
+
+	master->active  = seq;
+	master->session = seq;
+	master->count   = count;
+	master->index   = 0;
+	master->done    = done;
+	master->status = bspI2cInProgress;
+	master->stats.transfers++;
+
+	result = I2C_TransferInit(i2c, seq);
+	if(result != i2cTransferInProgress)
+		MasterComplete(master, (BSP_I2C_Status_TypeDef)result);	// refused, no interrupt follows
+
+	taskEXIT_CRITICAL();
+
+	return (BSP_I2C_Status_TypeDef)result;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the status of the last master session started on the
+ * specified I2C channel.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module.
+ * @return
+ *   bspI2cInProgress until the session completes, then bspI2cOk if every
+ *   transfer completed, or the reason the failed transfer ended.
+ ******************************************************************************/
+BSP_I2C_Status_TypeDef BSP_I2C_masterStatus (I2C_TypeDef *i2c)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+
+	return (master != NULL) ? master->status : bspI2cUsageFault;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the number of transfers of the last master session
+ * on the specified I2C channel that completed. When the session failed, the
+ * transfer at this index is the one that failed.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module.
+ * @return
+ *   Transfers completed, valid once the session has completed.
+ ******************************************************************************/
+uint8_t BSP_I2C_masterCompleted (I2C_TypeDef *i2c)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+
+	return (master != NULL) ? master->completed : 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function aborts the master transfer in progress on the specified I2C
+ * channel, e.g. when a slave stops responding. The transfer is counted as a
+ * timeout, the rest of its session is not run and the session's completion
+ * semaphore is not given.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module.
+ * @return
+ *   bspI2cTimeout if a transfer was aborted, otherwise the result of the last
+ *   transfer, which completed before it could be aborted.
+ ******************************************************************************/
+BSP_I2C_Status_TypeDef BSP_I2C_masterAbort (I2C_TypeDef *i2c)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+	BSP_I2C_Status_TypeDef status;
+
+	if(master == NULL)
+		return bspI2cUsageFault;
+
+	taskENTER_CRITICAL();
+
+	if(master->active != NULL)
+	{
+		i2c->IEN = 0;
+		i2c->CMD = I2C_CMD_ABORT;
+		i2c->IFC = _I2C_IFC_MASK;
+		NVIC_ClearPendingIRQ(master->irq);
+
+		MasterComplete(master, bspI2cTimeout);
+	}
+	status = master->status;
+
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function advances the master transfer in progress on the specified I2C
+ * channel, starts the next transfer of the session when it completes, and
+ * gives the completion semaphore at the end of the session. It is called
+ * from the channel's interrupt handler, which shares the interrupt with the
+ * slave mode handler on the main channel.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module that interrupted.
+ * @return
+ *   true if a master transfer was in progress and the interrupt is handled.
+ ******************************************************************************/
+bool BSP_I2C_masterIRQHandler (I2C_TypeDef *i2c)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
+	I2C_TransferReturn_TypeDef result;
+	portBASE_TYPE woken = pdFALSE;
+	xSemaphoreHandle done;
 
-  I2C_TransferReturn_TypeDef result;
-  I2C_TransferSeq_TypeDef i2cTransfer;
+	if(master == NULL || master->active == NULL)
+		return false;
 
-  // Initializing I2C transfer
-  i2cTransfer.addr        = address;
-  i2cTransfer.flags       = flag;
-  i2cTransfer.buf[0].data = txBuffer;
-  i2cTransfer.buf[0].len  = txBufferSize;
-  i2cTransfer.buf[1].data = rxBuffer;
-  i2cTransfer.buf[1].len  = rxBufferSize;
+	master->stats.interrupts++;
 
-  I2C_TransferInit(i2c, &i2cTransfer);
+	result = I2C_Transfer(i2c);
+	while(result == i2cTransferDone && master->index + 1 < master->count)
+	{
+		MasterCount(master, bspI2cOk);
 
-  uint32_t timeout = 0x0FFFFF;
+		master->index++;
+		master->active = &master->session[master->index];
+		master->stats.transfers++;
+		result = I2C_TransferInit(i2c, master->active);
+	}
+	if(result != i2cTransferInProgress)
+	{
+		done = master->done;
+		MasterComplete(master, (BSP_I2C_Status_TypeDef)result);
+
+		if(done != NULL)
+		{
+			xSemaphoreGiveFromISR(done, &woken);
+			portEND_SWITCHING_ISR(woken);
+		}
+	}
 
-  /* Sending data */
-  do
-  {
-	  timeout--;
+	return true;
+}
 
-	  result = I2C_Transfer(i2c);
-  }
-  while (result == i2cTransferInProgress && timeout != 0);
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the master transfer counters of the specified I2C
+ * channel.
+ *
+ * @param[in] i2c
+ *   Pointer to the I2C module.
+ * @param[out] stats
+ *   Copy of the counters.
+ ******************************************************************************/
+void BSP_I2C_getStats (I2C_TypeDef *i2c, BSP_I2C_Stats_TypeDef *stats)
+{
+	I2C_Master_TypeDef *master = GetMaster(i2c);
 
-  return timeout;
+	if(master == NULL)
+		return;
+
+	taskENTER_CRITICAL();
+	*stats = master->stats;
+	taskEXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Interrupt handler of the subsystem I2C channel, which is only used as a
+ * master. The main channel's handler is in comms.c.
+ ******************************************************************************/
+void I2C1_IRQHandler (void)
+{
+	BSP_I2C_masterIRQHandler(BSP_I2C_SUB);
 }
 
 /** @} (end addtogroup I2C) */
@@ -44,103 +44,164 @@
  * @{
  ******************************************************************************/
 
-//uint32_t msec; ///< Milliseconds counter
-//uint32_t sec; ///< Seconds counter
+static volatile uint32_t overflows;		///< Overflows of the counter since BSP_RTC_Init, the top of the time
 
 /***************************************************************************//**
  * @author Pieter J. Botma
  * @date   14/05/2012
  *
- * This function initialises the CubeComputer's real time clock to create an
- * interrupt roughly every millisecond, or 32 ticks of 32.768KHz crystal.
+ * This function initialises the CubeComputer's real time clock, which counts
+ * the 32.768KHz crystal. The counter runs free over its 24 bits, and the
+ * overflow interrupt extends it for the timebase. The RTOS tick interrupts
+ * from a compare channel of its own.
  *
  ******************************************************************************/
 void BSP_RTC_Init ()
 {
-	//sec = 0;
-	//msec = 0;
+	overflows = 0;
 
 	// RTC clock settings
 	CMU_ClockEnable(cmuClock_RTC, true);
 
-	// RTC counter settings
-	uint32_t ticksPerMs = CMU_ClockFreqGet(cmuClock_RTC) / 1000; // number of ticks for increment interval
-	RTC_CompareSet(0, ticksPerMs);
+	// RTC settings
+	RTC_Init_TypeDef init = RTC_INIT_DEFAULT;
+	init.enable   = false;
+	init.comp0Top = false;
+	RTC_Init(&init);
 
 	// RTC interrupt settings
-	RTC_IntEnable(RTC_IEN_COMP0);
+	RTC_IntEnable(RTC_IEN_OF);
 	NVIC_EnableIRQ(RTC_IRQn);
 
-	// RTC settings
-	RTC_Init_TypeDef init = RTC_INIT_DEFAULT;
-	RTC_Init(&init);
+	RTC_Enable(true);
 }
 
 /***************************************************************************//**
- * @author Pieter J. Botma
- * @date   14/05/2012
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function sets a compare value of the free running counter. A value the
+ * counter has already reached, or reaches before the write takes effect, would
+ * only match after the counter wraps, 512 s later, so its interrupt flag is
+ * set instead.
+ *
+ * @param [in] comp
+ * 	Compare channel, 0 or BSP_RTC_TICKCOMP.
+ * @param [in] count
+ * 	Counter value to interrupt at.
+ * @return
+ * 	Returns true if the flag was set because the value is already due.
+ ******************************************************************************/
+bool BSP_RTC_compareArm (unsigned int comp, uint32_t count)
+{
+	uint32_t ahead;
+
+	RTC_CompareSet(comp, count);
+
+	ahead = (count - RTC_CounterGet()) & BSP_RTC_MASK;
+	if(ahead < BSP_RTC_SYNCCOUNTS || ahead > BSP_RTC_MASK / 2)
+	{
+		RTC_IntSet((comp == 0) ? RTC_IFS_COMP0 : RTC_IFS_COMP1);
+		return true;
+	}
+
+	return false;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
  *
- * This function increments the milliseconds counter of the RTC. If 1024 ticks
- * have been reached (1024*32 = 32768 = LFXO), the seconds counter is
- * incremented and the milliseconds counter is reset.
+ * This function counts an overflow of the counter, and is called from
+ * RTC_IRQHandler when the overflow flag is raised. The flag is cleared with
+ * interrupts masked, so a reader never sees it cleared but not yet counted.
  *
  ******************************************************************************/
-/*void BSP_RTC_tick ()
+void BSP_RTC_overflowIRQ (void)
 {
-	msec++;
+	__disable_irq();
+	overflows++;
+	RTC_IntClear(RTC_IFC_OF);
+	__enable_irq();
+}
 
-	if (msec >= 1024)
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the counts of the crystal since BSP_RTC_Init. It may
+ * be called from any task or interrupt handler, also while the overflow
+ * interrupt is pending: an overflow raised but not yet counted is added if
+ * the counter has since wrapped, which it has when it is in its lower half.
+ *
+ * @return
+ * 	Returns the counter, extended to 56 bits by its overflows.
+ ******************************************************************************/
+uint64_t BSP_RTC_getCounts (void)
+{
+	uint32_t wraps, count;
+	bool pending;
+
+	do
 	{
-		msec = 0;
-		sec++;
-	}
-}*/
+		wraps = overflows;
+		count = RTC_CounterGet();
+		pending = (RTC_IntGet() & RTC_IF_OF) && count < BSP_RTC_MASK / 2;
+	} while(overflows != wraps);
+
+	return (((uint64_t)wraps + (pending ? 1 : 0)) << 24) | count;
+}
 
 /***************************************************************************//**
- * @author Pieter J. Botma
- * @date   14/05/2012
+ * @author Andre Heunis
+ * @date   16/10/2026
  *
- * This functions sets the seconds counter equal to the specified value,
- * \b time, and resets the milliseconds counter.
+ * This function returns the time since BSP_RTC_Init in microseconds, rounded
+ * down from the counts. It is monotonic, has a resolution of 30.5 us, and
+ * does not wrap for the life of the mission.
  *
- * @param [in] time
- * 	The new value of the seconds counter.
+ * @return
+ * 	Returns the microseconds since the RTC was initialised.
  ******************************************************************************/
-/*void BSP_RTC_setTime (uint32_t time)
+uint64_t BSP_RTC_getTimeUs (void)
 {
-	sec = time;
-	msec = 0;
-}*/
+	uint64_t counts = BSP_RTC_getCounts();
+
+	// 1000000/32768 = 15625/512, exact
+	return (counts / BSP_RTC_FREQ) * 1000000 + ((counts % BSP_RTC_FREQ) * 15625) / 512;
+}
 
 /***************************************************************************//**
  * @author Pieter J. Botma
  * @date   14/05/2012
  *
- * This function return the value of the seconds counter of the RTC.
+ * This function return the seconds since the RTC was initialised.
  *
  * @return
  * 	Returns the value of the seconds counter.
  *
  ******************************************************************************/
-/*uint32_t BSP_RTC_getTimeSec()
+uint32_t BSP_RTC_getTimeSec()
 {
-	return sec;
-}*/
+	return (uint32_t)(BSP_RTC_getCounts() / BSP_RTC_FREQ);
+}
 
 /***************************************************************************//**
  * @author Pieter J. Botma
  * @date   14/05/2012
  *
- * This function return the value of the milliseconds counter of the RTC.
+ * This function return the milliseconds of the current second, 0 to 999. Read
+ * with BSP_RTC_getTimeSec it may belong to another second; use
+ * BSP_RTC_getTimeUs for a time stamp.
  *
  * @return
  * 	Returns the value of the milliseconds counter.
  *
  ******************************************************************************/
-/*uint32_t BSP_RTC_getTimeMSec()
+uint32_t BSP_RTC_getTimeMSec()
 {
-	return msec;
-}*/
+	return (uint32_t)(((BSP_RTC_getCounts() % BSP_RTC_FREQ) * 1000) / BSP_RTC_FREQ);
+}
 
 /** @} (end addtogroup RTC) */
 /** @} (end addtogroup BSP_Library) */
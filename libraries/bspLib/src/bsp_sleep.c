@@ -0,0 +1,317 @@
+/***************************************************************************//**
+ * @file	bsp_sleep.c
+ * @brief	BSP sleep source file.
+ *
+ * This file contains the RTOS tick and the tickless idle of the port, which
+ * replace the SysTick versions in port.c, and the implementations of the
+ * functions defined in \em bsp_sleep.h.
+ *
+ * The RTC counter runs free at 32768 Hz and compare channel BSP_RTC_TICKCOMP
+ * interrupts for each tick. 32768 counts do not divide into ticks, so the
+ * ticks lie on a grid that restarts every second: tick n of a second is
+ * n * 32768 / configTICK_RATE_HZ counts after its start, and sleeping or
+ * interrupting late never shifts it.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "bsp_sleep.h"
+#include "bsp_rtc.h"
+#include "bsp_trace.h"
+#include "em_emu.h"
+#include "task.h"
+
+/***************************************************************************//**
+ * @addtogroup BSP_Library
+ * @brief Board Support Package (<b>BSP</b>) Driver Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup SLEEP
+ * @brief API for the RTOS tick and the energy modes the idle task sleeps in.
+ * @{
+ ******************************************************************************/
+
+/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+
+void vPortSetupTimerInterrupt( void );
+void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime );
+
+static uint32_t tickSecond;					// RTC count at the start of the second of the last tick
+static uint32_t tickPhase;					// Tick of that second last counted by the kernel
+static volatile uint32_t holds;				// EM1 holds taken and not released
+static BSP_SLEEP_Stats_TypeDef sleepStats;
+
+/*
+ * RTC count of the tick n ticks after the last one counted.
+ */
+static uint32_t tickCount(uint32_t n)
+{
+	uint32_t tick = tickPhase + n;
+
+	return (tickSecond + (tick / configTICK_RATE_HZ) * BSP_RTC_FREQ
+			+ ((tick % configTICK_RATE_HZ) * BSP_RTC_FREQ) / configTICK_RATE_HZ) & BSP_RTC_MASK;
+}
+
+/*
+ * Ticks of the grid at or before RTC count now that the kernel has not
+ * counted. Tick k of the second is at or before position p if
+ * k < (p + 1) * rate / 32768.
+ */
+static uint32_t ticksPassed(uint32_t now)
+{
+	uint32_t position = (now - tickSecond) & BSP_RTC_MASK;
+	uint32_t reached = ((position + 1) * configTICK_RATE_HZ + BSP_RTC_FREQ - 1) / BSP_RTC_FREQ;
+
+	// A tick taken a few counts early has not been reached yet
+	return (reached > tickPhase + 1) ? reached - (tickPhase + 1) : 0;
+}
+
+/*
+ * Moves the last tick counted n ticks on.
+ */
+static void tickAdvance(uint32_t n)
+{
+	tickPhase += n;
+	tickSecond = (tickSecond + (tickPhase / configTICK_RATE_HZ) * BSP_RTC_FREQ) & BSP_RTC_MASK;
+	tickPhase %= configTICK_RATE_HZ;
+}
+
+/** @endcond */
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function starts the tick interrupt on the RTC, which BSP_RTC_Init has
+ * started, instead of the SysTick. It is called by the port as the scheduler
+ * starts. The RTC interrupt becomes the lowest priority, the kernel's.
+ ******************************************************************************/
+void vPortSetupTimerInterrupt( void )
+{
+	tickSecond = RTC_CounterGet();
+	tickPhase = 0;
+
+	BSP_RTC_compareArm(BSP_RTC_TICKCOMP, tickCount(1));
+	RTC_IntEnable(RTC_IEN_COMP1);
+
+	NVIC_SetPriority(RTC_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+	NVIC_EnableIRQ(RTC_IRQn);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function stops the tick and sleeps until the tick the kernel next
+ * needs, or an interrupt, and then counts the ticks that passed. It is called
+ * by the idle task, with the scheduler suspended, when no task is ready for
+ * at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks.
+ *
+ * The core sleeps in EM2 unless a driver holds it in EM1. The ticks that
+ * passed, but the last, are stepped over; the tick interrupt
+ * counts the last, so the task it unblocks is switched to as from any tick.
+ *
+ * @param[in] xExpectedIdleTime
+ *   Ticks until the kernel next needs to run.
+ ******************************************************************************/
+void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime )
+{
+	uint32_t start, now, slept, ticks;
+	bool deep;
+
+	if(xExpectedIdleTime > BSP_SLEEP_MAXTICKS)
+		xExpectedIdleTime = BSP_SLEEP_MAXTICKS;
+
+	// Interrupts still wake the core, but are taken only once the ticks are counted
+	__disable_irq();
+
+	if(eTaskConfirmSleepModeStatus() == eAbortSleep)
+	{
+		sleepStats.aborted++;
+		__enable_irq();
+		return;
+	}
+
+	RTC_CompareSet(BSP_RTC_TICKCOMP, tickCount(xExpectedIdleTime));
+
+	deep = (holds == 0);
+	start = RTC_CounterGet();
+
+	if(deep)
+		EMU_EnterEM2(true);
+	else
+		EMU_EnterEM1();
+
+	now = RTC_CounterGet();
+	slept = (now - start) & BSP_RTC_MASK;
+
+	sleepStats.sleeps++;
+	if(deep)
+	{
+		sleepStats.em2Sleeps++;
+		sleepStats.em2Time += slept;
+	}
+	else
+		sleepStats.em1Time += slept;
+
+	ticks = ticksPassed(now);
+	if(ticks > xExpectedIdleTime)
+		ticks = xExpectedIdleTime;
+
+	if(ticks > 1)
+	{
+		tickAdvance(ticks - 1);
+		vTaskStepTick(ticks - 1);
+		sleepStats.suppressed += ticks - 1;
+	}
+
+	// Pends the tick interrupt for the last tick, if it has passed
+	BSP_RTC_compareArm(BSP_RTC_TICKCOMP, tickCount(1));
+
+	__enable_irq();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function counts the tick, and is called from RTC_IRQHandler with the
+ * flags raised. A tick is only counted once the grid
+ * has reached it, so a flag raised by an earlier compare value is ignored.
+ * When the next tick is also due the flag is set again, and the ticks missed
+ * are counted one interrupt at a time. How late the handler ran after the
+ * tick is recorded to the trace.
+ *
+ * @param[in] flags
+ *   RTC interrupt flags raised and enabled.
+ ******************************************************************************/
+void BSP_SLEEP_rtcIRQ (uint32_t flags)
+{
+	unsigned long mask;
+	uint32_t late;
+	portBASE_TYPE woken = pdFALSE;
+
+	if(flags & RTC_IF_COMP1)
+	{
+		RTC_IntClear(RTC_IFC_COMP1);
+
+		if(ticksPassed((RTC_CounterGet() + BSP_RTC_SYNCCOUNTS) & BSP_RTC_MASK) > 0)
+		{
+			// Taken a few counts early, the tick is on time
+			late = (RTC_CounterGet() - tickCount(1)) & BSP_RTC_MASK;
+			BSP_TRACE_isr(RTC_IRQn, (late < BSP_RTC_MASK / 2) ? late : 0);
+
+			tickAdvance(1);
+			sleepStats.ticks++;
+
+			mask = portSET_INTERRUPT_MASK_FROM_ISR();
+			woken = xTaskIncrementTick();
+			portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+		}
+
+		BSP_RTC_compareArm(BSP_RTC_TICKCOMP, tickCount(1));
+
+		portEND_SWITCHING_ISR(woken);
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the time since the RTC was started, in counts of
+ * 1/32768 s. It wraps after 36 hours, so it times intervals. It is the run
+ * time stats clock of the kernel.
+ *
+ * @return
+ *   RTC time in counts: the low 32 bits of BSP_RTC_getCounts.
+ ******************************************************************************/
+uint32_t BSP_SLEEP_getTime (void)
+{
+	return (uint32_t)BSP_RTC_getCounts();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns how long ago, on the grid, the tick the kernel last
+ * counted was due, so a task can time itself from a tick to within a count.
+ * It must be called with the tick masked, e.g. in a critical section together
+ * with xTaskGetTickCount, or the kernel may count another tick in between.
+ *
+ * @return
+ *   RTC counts since the grid time of the tick xTaskGetTickCount returns.
+ ******************************************************************************/
+uint32_t BSP_SLEEP_sinceTick (void)
+{
+	return (RTC_CounterGet() - tickCount(0)) & BSP_RTC_MASK;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function keeps the core out of EM2 until the hold is released, for a
+ * peripheral that stops without the high frequency clocks, e.g. a DMA
+ * transfer or the ADC. It may be called from an interrupt handler. Holds
+ * count, so each call must be matched by BSP_SLEEP_releaseEM1.
+ ******************************************************************************/
+void BSP_SLEEP_holdEM1 (void)
+{
+	__sync_fetch_and_add(&holds, 1);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function releases a hold taken by BSP_SLEEP_holdEM1. It may be called
+ * from an interrupt handler.
+ ******************************************************************************/
+void BSP_SLEEP_releaseEM1 (void)
+{
+	__sync_fetch_and_sub(&holds, 1);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the sleep counters.
+ *
+ * @param[out] stats
+ *   Copy of the counters.
+ ******************************************************************************/
+void BSP_SLEEP_getStats (BSP_SLEEP_Stats_TypeDef *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = sleepStats;
+	stats->holds = (uint16_t)holds;
+	taskEXIT_CRITICAL();
+}
+
+/** @} (end addtogroup SLEEP) */
+/** @} (end addtogroup BSP_Library) */
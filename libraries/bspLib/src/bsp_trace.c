@@ -0,0 +1,303 @@
+/***************************************************************************//**
+ * @file	bsp_trace.c
+ * @brief	BSP kernel trace source file.
+ *
+ * This file contains the implementations of the functions defined in \em
+ * bsp_trace.h.
+ *
+ * The kernel calls the hooks from its critical sections, the scheduler and
+ * the FromISR functions, and the tick interrupt calls BSP_TRACE_isr. Each
+ * event masks the interrupts the kernel masks while it is written, so an
+ * interrupt handler using a queue cannot tear it. Recording an event takes a
+ * read of the RTC and an 8 byte store.
+ *
+ * Queues are numbered from 1 in the order they are created, semaphores and
+ * mutexes included, and the number is kept in the queue's ucQueueNumber.
+ * Tasks are identified by their task number, which uxTaskGetSystemState
+ * returns with their name.
+ *
+ * The ring is in internal RAM unless BSP_TRACE_RINGADDR gives the address of
+ * BSP_TRACE_EVENTS events elsewhere, e.g. in an external SRAM module, which
+ * must then be powered before BSP_TRACE_Init.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2021 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include "bsp_trace.h"
+#include "FreeRTOS.h"
+
+/***************************************************************************//**
+ * @addtogroup BSP_Library
+ * @brief Board Support Package (<b>BSP</b>) Driver Library for CubeComputer.
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup TRACE
+ * @brief API for the kernel trace recorder.
+ * @{
+ ******************************************************************************/
+
+/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+
+#if (BSP_TRACE_EVENTS & (BSP_TRACE_EVENTS - 1)) != 0
+#error "BSP_TRACE_EVENTS must be a power of two"
+#endif
+
+#ifdef BSP_TRACE_RINGADDR
+#define ring	((BSP_TRACE_Event_TypeDef *)(BSP_TRACE_RINGADDR))
+#else
+static BSP_TRACE_Event_TypeDef ring[BSP_TRACE_EVENTS];
+#endif
+
+static bool recording;						// Off until BSP_TRACE_Init, so an external ring is powered first
+static uint32_t written;					// Events recorded since the ring was cleared
+static uint8_t queueCount;					// Queues numbered
+static BSP_TRACE_Queue_TypeDef queueTable[BSP_TRACE_MAXQUEUES];
+
+/*
+ * Writes an event to the ring, over the oldest once it is full.
+ */
+static void record(uint8_t type, uint8_t id, uint32_t value)
+{
+	BSP_TRACE_Event_TypeDef *event;
+	unsigned long mask;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	if(recording)
+	{
+		event = &ring[written & (BSP_TRACE_EVENTS - 1)];
+		event->time = portGET_RUN_TIME_COUNTER_VALUE();
+		event->type = type;
+		event->id = id;
+		event->value = (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+		written++;
+	}
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+/** @endcond */
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function clears the ring and starts recording. It is called once the
+ * RTC, and the memory holding the ring, are running.
+ ******************************************************************************/
+void BSP_TRACE_Init (void)
+{
+	BSP_TRACE_enable(true);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function starts or stops recording. Starting clears the ring. The ring
+ * is read with recording stopped, so no event is written while it is copied.
+ *
+ * @param[in] enable
+ *   True to clear the ring and start recording, false to stop.
+ ******************************************************************************/
+void BSP_TRACE_enable (bool enable)
+{
+	unsigned long mask;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	if(enable)
+		written = 0;
+	recording = enable;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @return
+ *   Events recorded since the ring was cleared. The ring holds the last
+ *   BSP_TRACE_EVENTS of them.
+ ******************************************************************************/
+uint32_t BSP_TRACE_written (void)
+{
+	return written;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies events out of the ring. It must be called with
+ * recording stopped.
+ *
+ * @param[in] first
+ *   Number of the first event to copy, counted from the clearing of the ring.
+ * @param[out] events
+ *   The events, oldest first.
+ * @param[in] max
+ *   Most events to copy.
+ * @return
+ *   Events copied. Events overwritten or not yet recorded are not copied.
+ ******************************************************************************/
+uint16_t BSP_TRACE_read (uint32_t first, BSP_TRACE_Event_TypeDef *events, uint16_t max)
+{
+	uint16_t n;
+
+	if(written > BSP_TRACE_EVENTS && first < written - BSP_TRACE_EVENTS)
+		return 0;
+
+	for(n = 0; n < max && first + n < written; n++)
+		events[n] = ring[(first + n) & (BSP_TRACE_EVENTS - 1)];
+
+	return n;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * @return
+ *   Queues numbered so far, the number of the last created.
+ ******************************************************************************/
+uint8_t BSP_TRACE_queues (void)
+{
+	return queueCount;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function returns the length and type of a queue.
+ *
+ * @param[in] number
+ *   Queue number, from 1.
+ * @param[out] queue
+ *   Its length and type, zero past BSP_TRACE_MAXQUEUES.
+ ******************************************************************************/
+void BSP_TRACE_getQueue (uint8_t number, BSP_TRACE_Queue_TypeDef *queue)
+{
+	if(number == 0 || number > queueCount || number > BSP_TRACE_MAXQUEUES)
+	{
+		queue->length = 0;
+		queue->type = 0;
+		return;
+	}
+
+	*queue = queueTable[number - 1];
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function records the task the scheduler has switched in. It is called
+ * by traceTASK_SWITCHED_IN.
+ *
+ * @param[in] task
+ *   Task number of the task switched in.
+ ******************************************************************************/
+void BSP_TRACE_switchedIn (unsigned long task)
+{
+	record(BSP_TRACE_SWITCH, (uint8_t)task, 0);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function numbers a new queue, semaphore or mutex. It is called by
+ * traceQUEUE_CREATE and traceCREATE_MUTEX.
+ *
+ * @param[in] length
+ *   Items the queue holds.
+ * @param[in] type
+ *   Its type, queueQUEUE_TYPE_BASE to queueQUEUE_TYPE_RECURSIVE_MUTEX.
+ * @return
+ *   Its number, or 0 once 255 queues have been numbered.
+ ******************************************************************************/
+uint8_t BSP_TRACE_queueCreated (unsigned long length, uint8_t type)
+{
+	unsigned long mask;
+	uint8_t number = 0;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	if(queueCount < 0xFF)
+	{
+		number = ++queueCount;
+		if(number <= BSP_TRACE_MAXQUEUES)
+		{
+			queueTable[number - 1].length = (length > 0xFFFF) ? 0xFFFF : (uint16_t)length;
+			queueTable[number - 1].type = type;
+		}
+	}
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+	return number;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function records a queue operation. It is called by the queue trace
+ * hooks.
+ *
+ * @param[in] type
+ *   BSP_TRACE_SEND, BSP_TRACE_RECEIVE or BSP_TRACE_SENDFAIL, with
+ *   BSP_TRACE_FROMISR from an interrupt handler.
+ * @param[in] queue
+ *   Queue number.
+ * @param[in] waiting
+ *   Items in the queue once the operation is done.
+ ******************************************************************************/
+void BSP_TRACE_queueEvent (uint8_t type, uint8_t queue, unsigned long waiting)
+{
+	record(type, queue, waiting);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function records how late an interrupt handler ran after the event
+ * that raised it, for handlers that know when that was, such as a compare
+ * match on the RTC.
+ *
+ * @param[in] irq
+ *   IRQ number of the interrupt.
+ * @param[in] late
+ *   RTC counts from the event to the handler.
+ ******************************************************************************/
+void BSP_TRACE_isr (uint8_t irq, uint32_t late)
+{
+	record(BSP_TRACE_ISR, irq, late);
+}
+
+/** @} (end addtogroup TRACE) */
+/** @} (end addtogroup BSP_Library) */
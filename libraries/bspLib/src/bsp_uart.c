@@ -28,8 +28,10 @@
  *
  ******************************************************************************/
 
+#include <string.h>
 #include "bsp_uart.h"
 #include "bsp_dma.h"
+#include "bsp_sleep.h"
 #include "em_cmu.h"
 #include "em_gpio.h"
 #include "comms.h"
@@ -48,37 +50,99 @@
 
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
-volatile uint8_t debugTxInProgress; // debug uart transmission flag. Has to be declared volatile so it can be changed in an interrupt
+/// Transmit queue of a UART channel: a ring of buffers the DMA sends in order.
+typedef struct
+{
+	USART_TypeDef *usart;
+	unsigned int dmaChannel;
+	uint8_t buff[BSP_UART_TXSLOTS][BSP_UART_TXSLOTLEN];
+	uint16_t len[BSP_UART_TXSLOTS];
+	uint8_t head;								// Next buffer to fill
+	uint8_t tail;								// Buffer being sent
+	volatile uint8_t queued;					// Buffers filled and not yet sent
+	xSemaphoreHandle freeSlots;					// Counts the buffers free to fill
+	xSemaphoreHandle empty;						// Given when the last buffer queued is sent
+	xSemaphoreHandle lock;						// Keeps the buffers of a message together
+	BSP_UART_TxStats_TypeDef stats;
+} BSP_UART_TxQueue_TypeDef;
+
+static BSP_UART_TxQueue_TypeDef debugTx;
+static BSP_UART_TxQueue_TypeDef miscTx;
+
+/*
+ * Starts the DMA on the oldest buffer queued.
+ */
+static void txStart(BSP_UART_TxQueue_TypeDef *q)
+{
+	DMA_ActivateBasic(q->dmaChannel,									// activate channel selected
+						true,											// use primary descriptor
+						false,											// no DMA burst
+						(void *) &(q->usart->TXDATA),					// destination address
+						(void *)(q->buff[q->tail]),						// source address
+						q->len[q->tail] - 1);							// buffer length -1
+}
 
 /***************************************************************************//**
  * @fn void debugTxComplete(unsigned int channel, bool primary, void *user)
  *
- * Callback function for Debug DMA TX channel. ( \em forward declaration )
+ * Callback function for the UART DMA TX channels. Frees the buffer just sent
+ * and starts the next one queued, if any. ( \em forward declaration )
  ******************************************************************************/
 void debugTxComplete(unsigned int channel, bool primary, void *user)
 {
-	// Clear transmission in progress flag
-	debugTxInProgress = 0;
+	BSP_UART_TxQueue_TypeDef *q = (BSP_UART_TxQueue_TypeDef *)user;
+	portBASE_TYPE woken = pdFALSE;
+
+	q->stats.bytes += q->len[q->tail];
+	q->stats.transfers++;
+
+	q->tail = (q->tail + 1) % BSP_UART_TXSLOTS;
+	q->queued--;
+
+	if(q->queued > 0)
+		txStart(q);
+	else
+	{
+		BSP_SLEEP_releaseEM1();
+		xSemaphoreGiveFromISR(q->empty, &woken);
+	}
+
+	xSemaphoreGiveFromISR(q->freeSlots, &woken);
+	portEND_SWITCHING_ISR(woken);
 }
 
-void InitDebug (void)
+/*
+ * Sets up the transmit queue and DMA channel of a UART.
+ */
+static void InitTx (BSP_UART_TxQueue_TypeDef *q, USART_TypeDef *usart, unsigned int dmaChannel, unsigned int dmaReq)
 {
-	CMU_ClockEnable(BSP_UART_DEBUG_CLOCK, true);
-	CMU_ClockEnable(cmuClock_GPIO, true);
+	q->usart = usart;
+	q->dmaChannel = dmaChannel;
+	q->head = 0;
+	q->tail = 0;
+	q->queued = 0;
+	memset(&q->stats, 0, sizeof(q->stats));
+
+	if(q->freeSlots == NULL)
+	{
+		q->freeSlots = xSemaphoreCreateCounting(BSP_UART_TXSLOTS, BSP_UART_TXSLOTS);
+		vSemaphoreCreateBinary(q->empty);
+		q->lock = xSemaphoreCreateMutex();
+	}
 
 	// Setting DMA call-back function
 
-	cb[DMA_CHANNEL_DEBUG_TX].cbFunc  = debugTxComplete;
-	cb[DMA_CHANNEL_DEBUG_TX].userPtr = NULL;
+	cb[dmaChannel].cbFunc  = debugTxComplete;
+	cb[dmaChannel].userPtr = q;
 
 	// DMA config
 
 	DMA_CfgChannel_TypeDef chnlTxCfg;
 	chnlTxCfg.highPri   = false;						// Normal priority
 	chnlTxCfg.enableInt = true;							// Interrupt enabled for callback functions
-	chnlTxCfg.select    = BSP_UART_DEBUG_DMAREQ;		// Set USART0 TX empty available as source of DMA signals
-	chnlTxCfg.cb        = &(cb[DMA_CHANNEL_DEBUG_TX]);  // Callback funtion // NULL
-	DMA_CfgChannel(DMA_CHANNEL_DEBUG_TX, &chnlTxCfg);
+	chnlTxCfg.select    = dmaReq;						// Set UART TX empty available as source of DMA signals
+	chnlTxCfg.cb        = &(cb[dmaChannel]);			// Callback funtion
+	DMA_CfgChannel(dmaChannel, &chnlTxCfg);
 
 	DMA_CfgDescr_TypeDef   descrTxCfg;
 	descrTxCfg.dstInc  = dmaDataIncNone;
@@ -86,7 +150,131 @@ void InitDebug (void)
 	descrTxCfg.size    = dmaDataSize1;
 	descrTxCfg.arbRate = dmaArbitrate1;
 	descrTxCfg.hprot   = 0;
-	DMA_CfgDescr(DMA_CHANNEL_DEBUG_TX, true, &descrTxCfg);
+	DMA_CfgDescr(dmaChannel, true, &descrTxCfg);
+}
+
+static BSP_UART_TxQueue_TypeDef *txQueueOf (USART_TypeDef *usart)
+{
+	return (usart == BSP_UART_MISC) ? &miscTx : &debugTx;
+}
+
+/*
+ * The debug UART receive ring. The DMA writes it as a ping-pong cycle, the
+ * primary descriptor filling the first half and the alternate the second, and
+ * interrupts once per half. Positions count bytes since the ring was started,
+ * so the ring index is the position modulo BSP_UART_RXRING.
+ */
+static uint8_t debugRxRing[BSP_UART_RXRING];
+static volatile uint32_t debugRxHalves;			// Halves filled, counted by the DMA interrupt
+static uint32_t debugRxTail;					// Position of the next byte to read
+static xSemaphoreHandle debugRxSem;				// Given when a half is filled
+static volatile bool debugRxQuiet;				// The receiver's EM1 hold is released for a quiet wait
+static BSP_UART_RxStats_TypeDef debugRxStats;
+
+/***************************************************************************//**
+ * @fn void debugRxComplete(unsigned int channel, bool primary, void *user)
+ *
+ * Callback function for Debug DMA RX channel. Re-arms the half just filled,
+ * which the DMA returns to once the other half is full, and wakes the reader.
+ ******************************************************************************/
+void debugRxComplete(unsigned int channel, bool primary, void *user)
+{
+	portBASE_TYPE woken = pdFALSE;
+
+	DMA_RefreshPingPong(channel, primary, false, NULL, NULL, BSP_UART_RXHALF - 1, false);
+
+	debugRxHalves++;
+	debugRxStats.interrupts++;
+
+	xSemaphoreGiveFromISR(debugRxSem, &woken);
+	portEND_SWITCHING_ISR(woken);
+}
+
+/*
+ * Position the DMA writes next. The descriptor of the half being filled holds
+ * the bytes it still expects; once it completes, and until the interrupt has
+ * counted it, its cycle is invalid. Read again if the interrupt counts a half
+ * in between.
+ */
+static uint32_t debugRxHead(void)
+{
+	DMA_DESCRIPTOR_TypeDef *descr;
+	uint32_t halves, remaining;
+
+	do
+	{
+		halves = debugRxHalves;
+		descr = (halves & 1) ? DMA_ALTDESCRIPTOR(DMA_CHANNEL_DEBUG_RX) : &dmaControlBlock[DMA_CHANNEL_DEBUG_RX];
+
+		if(((descr->CTRL & _DMA_CTRL_CYCLE_CTRL_MASK) >> _DMA_CTRL_CYCLE_CTRL_SHIFT) == _DMA_CTRL_CYCLE_CTRL_INVALID)
+			remaining = 0;
+		else
+			remaining = ((descr->CTRL & _DMA_CTRL_N_MINUS_1_MASK) >> _DMA_CTRL_N_MINUS_1_SHIFT) + 1;
+	} while(halves != debugRxHalves);
+
+	return halves * BSP_UART_RXHALF + BSP_UART_RXHALF - remaining;
+}
+
+/*
+ * Ends a quiet wait: stops the RX pin interrupt and holds the core in EM1 for
+ * the receiver again. Called with interrupts masked, or from an interrupt.
+ */
+static void debugRxEndQuiet(void)
+{
+	if(debugRxQuiet)
+	{
+		debugRxQuiet = false;
+		GPIO_IntDisable(1 << BSP_UART_DEBUG_RXPIN);
+		BSP_SLEEP_holdEM1();
+	}
+}
+
+void InitDebugRx (void)
+{
+	vSemaphoreCreateBinary(debugRxSem);
+	xSemaphoreTake(debugRxSem, 0);
+
+	debugRxHalves = 0;
+	debugRxTail = 0;
+	debugRxQuiet = false;
+
+	// The receiver's DMA stops in EM2, except while the reader waits quietly
+	BSP_SLEEP_holdEM1();
+	NVIC_SetPriority(BSP_UART_RXPIN_IRQn, BSP_UART_RXPIN_IRQ_PRIORITY);
+	NVIC_EnableIRQ(BSP_UART_RXPIN_IRQn);
+
+	cb[DMA_CHANNEL_DEBUG_RX].cbFunc  = debugRxComplete;
+	cb[DMA_CHANNEL_DEBUG_RX].userPtr = NULL;
+
+	DMA_CfgChannel_TypeDef chnlRxCfg;
+	chnlRxCfg.highPri   = true;							// A byte must be taken before the next one arrives
+	chnlRxCfg.enableInt = true;
+	chnlRxCfg.select    = BSP_UART_DEBUG_RXDMAREQ;		// RX data available as source of DMA signals
+	chnlRxCfg.cb        = &(cb[DMA_CHANNEL_DEBUG_RX]);
+	DMA_CfgChannel(DMA_CHANNEL_DEBUG_RX, &chnlRxCfg);
+
+	// Each byte is an arbitration, so the descriptors count the bytes as they arrive
+	DMA_CfgDescr_TypeDef   descrRxCfg;
+	descrRxCfg.dstInc  = dmaDataInc1;
+	descrRxCfg.srcInc  = dmaDataIncNone;
+	descrRxCfg.size    = dmaDataSize1;
+	descrRxCfg.arbRate = dmaArbitrate1;
+	descrRxCfg.hprot   = 0;
+	DMA_CfgDescr(DMA_CHANNEL_DEBUG_RX, true, &descrRxCfg);
+	DMA_CfgDescr(DMA_CHANNEL_DEBUG_RX, false, &descrRxCfg);
+
+	DMA_ActivatePingPong(DMA_CHANNEL_DEBUG_RX,
+						false,
+						(void *)(debugRxRing), (void *) &(BSP_UART_DEBUG->RXDATA), BSP_UART_RXHALF - 1,
+						(void *)(debugRxRing + BSP_UART_RXHALF), (void *) &(BSP_UART_DEBUG->RXDATA), BSP_UART_RXHALF - 1);
+}
+
+void InitDebug (void)
+{
+	CMU_ClockEnable(BSP_UART_DEBUG_CLOCK, true);
+	CMU_ClockEnable(cmuClock_GPIO, true);
+
+	InitTx(&debugTx, BSP_UART_DEBUG, DMA_CHANNEL_DEBUG_TX, BSP_UART_DEBUG_DMAREQ);
 
 	// UART config
 
@@ -102,21 +290,17 @@ void InitDebug (void)
 
 #if defined(CubeCompV2B)
 	GPIO_PinModeSet(gpioPortE, 7, gpioModePushPull, 1); // TX is on E7
-	GPIO_PinModeSet(gpioPortE, 6, gpioModeInputPull, 1);// RX is on E6
+	GPIO_PinModeSet(BSP_UART_DEBUG_RXPORT, BSP_UART_DEBUG_RXPIN, gpioModeInputPull, 1);// RX is on E6
 
 #else
 	GPIO_PinModeSet(gpioPortB,  9, gpioModePushPull, 1); // TX is on B9
-	GPIO_PinModeSet(gpioPortB, 10, gpioModeInputPull, 1);// RX is on B10
+	GPIO_PinModeSet(BSP_UART_DEBUG_RXPORT, BSP_UART_DEBUG_RXPIN, gpioModeInputPull, 1);// RX is on B10
 #endif
 
 #ifndef HIL_sim
-	// Setup interrupts
-	BSP_UART_DEBUG->IEN = USART_IEN_RXDATAV;
-	NVIC_EnableIRQ(BSP_UART_DEBUG_RX_IRQn);
+	// Received bytes go to the ring by DMA, instead of an interrupt per byte
+	InitDebugRx();
 #endif
-
-	// Initialise transfer flag
-	debugTxInProgress = 0;
 }
 
 void InitMisc (void)
@@ -124,27 +308,8 @@ void InitMisc (void)
 	CMU_ClockEnable(BSP_UART_MISC_CLOCK, true);
 	CMU_ClockEnable(cmuClock_GPIO, true);
 
-	// Setting DMA call-back function
-
-	cb[DMA_CHANNEL_DEBUG_TX].cbFunc  = debugTxComplete;
-	cb[DMA_CHANNEL_DEBUG_TX].userPtr = NULL;
-
-	// DMA config
-
-	DMA_CfgChannel_TypeDef chnlTxCfg;
-	chnlTxCfg.highPri   = false;
-	chnlTxCfg.enableInt = true;
-	chnlTxCfg.select    = BSP_UART_MISC_DMAREQ;
-	chnlTxCfg.cb        = &(cb[DMA_CHANNEL_DEBUG_TX]); ;
-	DMA_CfgChannel(DMA_CHANNEL_DEBUG_TX, &chnlTxCfg);
-
-	DMA_CfgDescr_TypeDef   descrTxCfg;
-	descrTxCfg.dstInc  = dmaDataIncNone;
-	descrTxCfg.srcInc  = dmaDataInc1;
-	descrTxCfg.size    = dmaDataSize1;
-	descrTxCfg.arbRate = dmaArbitrate1;
-	descrTxCfg.hprot   = 0;
-	DMA_CfgDescr(DMA_CHANNEL_DEBUG_TX, true, &descrTxCfg);
+	// The miscellaneous UART has its own DMA channel, so both can transmit at once
+	InitTx(&miscTx, BSP_UART_MISC, DMA_CHANNEL_MISC_TX, BSP_UART_MISC_DMAREQ);
 
 	// UART config
 
@@ -171,9 +336,6 @@ void InitMisc (void)
 	// Setup interrupts
 	BSP_UART_MISC->IEN = USART_IEN_RXDATAV;
 	NVIC_EnableIRQ(BSP_UART_MISC_RX_IRQn);
-
-	// Initialise transfer flag
-	debugTxInProgress = 0;
 }
 
 /** @endcond */
@@ -209,7 +371,8 @@ void BSP_UART_Init (USART_TypeDef *usart)
  ******************************************************************************/
 void BSP_UART_txByte(USART_TypeDef *usart, uint8_t data)
 {
-	USART_Tx(usart, data);
+	// Queued behind any buffers the DMA is sending, so the byte is not sent out of order
+	BSP_UART_txQueue(usart, &data, 1, portMAX_DELAY);
 }
 
 /***************************************************************************//**
@@ -217,44 +380,165 @@ void BSP_UART_txByte(USART_TypeDef *usart, uint8_t data)
  * @date   10/05/2012
  *
  * This function transmits the data buffer, \b buff of size \b len, over the
- * specified UART channel using DMA.
+ * specified UART channel using DMA. The data is copied into the channel's
+ * transmit buffers, so the caller may reuse \b buff as soon as it returns.
  * @param[in] usart
  *   Pointer to UART to be used.
  * @param[in] buff
  *	 Pointer to data buffer to be transmitted.
  * @param[in] len
  * 	 Length of data buffer to be transmitted.
+ * @param[in] wait
+ * 	 Block until the data has been sent.
  ******************************************************************************/
-void BSP_UART_txBuffer (USART_TypeDef *usart, uint8_t *buff, uint8_t len, bool wait)
+void BSP_UART_txBuffer (USART_TypeDef *usart, uint8_t *buff, uint16_t len, bool wait)
 {
-	// Implement transmission using DMA to free up MCU
-	DMA_ActivateBasic(DMA_CHANNEL_DEBUG_TX,										// activate channel selected
-						true,													// use primary descriptor
-						false,													// no DMA burst
-						(void *) &(usart->TXDATA),								// destination address
-						(void *)(buff),											// source address
-						len - 1);												// buffer length -1
-
-	// Set transmission flag as busy
-	debugTxInProgress = 1;
-
-	// Wait for previous transfer to complete
+	BSP_UART_txQueue(usart, buff, len, portMAX_DELAY);
+
 	if (wait)
-		while(debugTxInProgress);
+		BSP_UART_txFlush(usart, portMAX_DELAY);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the data buffer, \b buff of size \b len, into the
+ * transmit buffers of the specified UART channel and returns. The DMA sends
+ * the buffers in the order they were queued, starting the next from its
+ * completion interrupt. A message is queued whole before any other caller's.
+ * If all the buffers are in use, the caller blocks until one is sent, at most
+ * until the timeout; the rest of the message is then dropped and counted.
+ * @param[in] usart
+ *   Pointer to UART to be used.
+ * @param[in] buff
+ *	 Pointer to data buffer to be transmitted.
+ * @param[in] len
+ * 	 Length of data buffer to be transmitted.
+ * @param[in] timeout
+ *   Longest wait for each free buffer, in ticks.
+ * @return
+ *   Returns the number of bytes queued.
+ ******************************************************************************/
+uint16_t BSP_UART_txQueue (USART_TypeDef *usart, const uint8_t *buff, uint16_t len, portTickType timeout)
+{
+	BSP_UART_TxQueue_TypeDef *q = txQueueOf(usart);
+	portTickType start;
+	uint16_t done = 0, chunk;
+
+	if(len == 0)
+		return 0;
+
+	if(xSemaphoreTake(q->lock, timeout) != pdTRUE)
+	{
+		q->stats.dropped += len;
+		return 0;
+	}
+
+	while(done < len)
+	{
+		// Wait for the DMA to free a buffer
+		if(xSemaphoreTake(q->freeSlots, 0) != pdTRUE)
+		{
+			q->stats.waits++;
+			start = xTaskGetTickCount();
+			if(xSemaphoreTake(q->freeSlots, timeout) != pdTRUE)
+				break;
+			q->stats.waitTicks += xTaskGetTickCount() - start;
+		}
+
+		chunk = len - done;
+		if(chunk > BSP_UART_TXSLOTLEN)
+			chunk = BSP_UART_TXSLOTLEN;
+
+		memcpy(q->buff[q->head], buff + done, chunk);
+		q->len[q->head] = chunk;
+		q->head = (q->head + 1) % BSP_UART_TXSLOTS;
+		done += chunk;
+
+		// Start the DMA if it has sent everything queued before
+		taskENTER_CRITICAL();
+		if(q->queued++ == 0)
+		{
+			// The DMA stops in EM2, so the core stays in EM1 until the queue is sent
+			BSP_SLEEP_holdEM1();
+			xSemaphoreTake(q->empty, 0);
+			txStart(q);
+		}
+		if(q->queued > q->stats.maxQueued)
+			q->stats.maxQueued = q->queued;
+		taskEXIT_CRITICAL();
+	}
+
+	q->stats.messages++;
+	q->stats.dropped += len - done;
+	xSemaphoreGive(q->lock);
+
+	return done;
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function waits until the DMA has sent all the data queued on the
+ * specified UART channel.
+ * @param[in] usart
+ *   Pointer to UART to be used.
+ * @param[in] timeout
+ *   Longest wait, in ticks.
+ * @return
+ *   Returns true if the channel's transmit queue is empty.
+ ******************************************************************************/
+bool BSP_UART_txFlush (USART_TypeDef *usart, portTickType timeout)
+{
+	BSP_UART_TxQueue_TypeDef *q = txQueueOf(usart);
+
+	// The semaphore may have been left given by an earlier message; look again
+	while(q->queued > 0)
+	{
+		if(xSemaphoreTake(q->empty, timeout) != pdTRUE)
+			break;
+	}
+
+	// Pass the wake up on to any other task waiting; queueing takes it back
+	if(q->queued == 0)
+	{
+		xSemaphoreGive(q->empty);
+		return true;
+	}
+
+	return false;
+}
 
 /***************************************************************************//**
  * @author Pieter J. Botma
  * @date   01/08/2013
  *
- * This function returns the UART DMA transmission status flag.
+ * This function returns the debug UART DMA transmission status.
  * @return
- *   Returns the UART DMA transmission status flag.
+ *   Returns true while data queued on the debug UART is being sent.
  ******************************************************************************/
 bool BSP_UART_txInProgress (void)
 {
-	return debugTxInProgress;
+	return debugTx.queued > 0;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the transmit counters of the specified UART channel.
+ * @param[in] usart
+ *   Pointer to UART to be used.
+ * @param[out] stats
+ *   Copy of the counters.
+ ******************************************************************************/
+void BSP_UART_getTxStats (USART_TypeDef *usart, BSP_UART_TxStats_TypeDef *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = txQueueOf(usart)->stats;
+	taskEXIT_CRITICAL();
 }
 
 /***************************************************************************//**
@@ -311,6 +595,160 @@ void BSP_UART_rxBuffer(USART_TypeDef *usart, uint8_t *buff, uint8_t len)
 	USART_IntEnable(usart,USART_IF_RXDATAV);
 }
 
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function waits until a half of the debug UART receive ring is filled,
+ * or the timeout passes. Fewer bytes than a half raise no interrupt, so the
+ * timeout is also how often the caller looks for them.
+ * @param[in] timeout
+ *   Longest wait, in ticks.
+ * @return
+ *   Returns true if there is data to read.
+ ******************************************************************************/
+bool BSP_UART_rxWait (portTickType timeout)
+{
+	xSemaphoreTake(debugRxSem, timeout);
+
+	return debugRxHead() != debugRxTail;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function waits until the idle debug UART line becomes active, or the
+ * timeout passes, with the receiver's EM1 hold released so the core may sleep
+ * in EM2. The first falling edge on the RX pin wakes the reader and holds the
+ * core in EM1 again. The byte that edge starts is lost if the clocks restart
+ * too late for it, so the ground leads a frame with a delimiter, which the
+ * framing ignores.
+ * @param[in] timeout
+ *   Longest wait, in ticks.
+ * @return
+ *   Returns true if the line, or BSP_UART_rxWakeFromISR, ended the wait.
+ ******************************************************************************/
+bool BSP_UART_rxWaitQuiet (portTickType timeout)
+{
+	bool woken;
+
+	taskENTER_CRITICAL();
+	debugRxQuiet = true;
+	debugRxStats.quietWaits++;
+	GPIO_IntClear(1 << BSP_UART_DEBUG_RXPIN);
+	GPIO_IntConfig(BSP_UART_DEBUG_RXPORT, BSP_UART_DEBUG_RXPIN, false, true, true);
+	BSP_SLEEP_releaseEM1();
+	taskEXIT_CRITICAL();
+
+	woken = (xSemaphoreTake(debugRxSem, timeout) == pdTRUE);
+
+	taskENTER_CRITICAL();
+	debugRxEndQuiet();
+	taskEXIT_CRITICAL();
+
+	return woken;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function ends the debug UART reader's wait early, e.g. for a
+ * telecommand received on another link, and may only be called from an
+ * interrupt handler.
+ * @param[in,out] woken
+ *   Set to pdTRUE if the reader should be switched to at the end of the
+ *   interrupt.
+ ******************************************************************************/
+void BSP_UART_rxWakeFromISR (portBASE_TYPE *woken)
+{
+	debugRxEndQuiet();
+	xSemaphoreGiveFromISR(debugRxSem, woken);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function wakes the debug UART reader from a quiet wait when the line
+ * becomes active. It is called from GPIO_EVEN_IRQHandler when the RX pin
+ * interrupt flag is set.
+ ******************************************************************************/
+void BSP_UART_rxPinIRQ (void)
+{
+	portBASE_TYPE woken = pdFALSE;
+
+	GPIO_IntClear(1 << BSP_UART_DEBUG_RXPIN);
+
+	if(debugRxQuiet)
+		debugRxStats.pinWakes++;
+
+	BSP_UART_rxWakeFromISR(&woken);
+	portEND_SWITCHING_ISR(woken);
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the debug UART data received so far, in the order it
+ * was received, without waiting. If the DMA has lapped the reader, the bytes
+ * overwritten are counted as overruns and skipped.
+ * @param[out] buff
+ *   Pointer to data buffer where received data should be placed.
+ * @param[in] len
+ *   Size of the buffer.
+ * @return
+ *   Returns the number of bytes copied.
+ ******************************************************************************/
+uint16_t BSP_UART_rxRead (uint8_t *buff, uint16_t len)
+{
+	uint32_t head, count, index, chunk;
+
+	head = debugRxHead();
+	count = head - debugRxTail;
+
+	if(count > BSP_UART_RXRING)
+	{
+		debugRxStats.overruns += count - BSP_UART_RXRING;
+		debugRxTail = head - BSP_UART_RXRING;
+		count = BSP_UART_RXRING;
+	}
+
+	if(count > len)
+		count = len;
+
+	// At most two copies, either side of the end of the ring
+	index = debugRxTail % BSP_UART_RXRING;
+	chunk = BSP_UART_RXRING - index;
+	if(chunk > count)
+		chunk = count;
+
+	memcpy(buff, debugRxRing + index, chunk);
+	memcpy(buff + chunk, debugRxRing, count - chunk);
+
+	debugRxTail += count;
+	debugRxStats.bytes += count;
+
+	return count;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * This function copies the debug UART receive counters.
+ * @param[out] stats
+ *   Copy of the counters.
+ ******************************************************************************/
+void BSP_UART_getRxStats (BSP_UART_RxStats_TypeDef *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = debugRxStats;
+	taskEXIT_CRITICAL();
+}
+
 /** @} (end addtogroup UART) */
 /** @} (end addtogroup BSP_Library) */
 
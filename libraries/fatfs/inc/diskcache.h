@@ -0,0 +1,92 @@
+/***************************************************************************//**
+ * @file	diskcache.h
+ * @brief	Sector cache between FatFs and the disk driver.
+ *
+ * A set associative cache of whole sectors, used by disk_read and disk_write.
+ * Sectors in pinned ranges (the FAT and the directory sectors of the log
+ * files) are kept in preference to file data and are written back; all other
+ * sectors are written through.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#ifndef __DISKCACHE_H
+#define __DISKCACHE_H
+
+#include <stdint.h>
+#include "integer.h"
+#include "diskio.h"
+
+/***************************************************************************//**
+ * @addtogroup MicroSd
+ * @{
+ ******************************************************************************/
+
+#ifndef DISKCACHE_LINES
+#define DISKCACHE_LINES		16		///< Cached sectors with the default memory. 0 disables the cache.
+#endif
+#ifndef DISKCACHE_WAYS
+#define DISKCACHE_WAYS		4		///< Sectors per set. Pinned sectors may use all but one way of a set.
+#endif
+#ifndef DISKCACHE_RUN
+#define DISKCACHE_RUN		8		///< Most adjacent dirty sectors combined into one multiple block write.
+#endif
+#define DISKCACHE_PINS		8		///< Pinned sector ranges.
+#define DISKCACHE_SECTOR	512		///< Sector size.
+
+// Define DISKCACHE_MEM as the address of DISKCACHE_MEMSIZE( DISKCACHE_LINES ) bytes,
+// e.g. BSP_EBI_SRAM1_BASE, to keep the default cache in external SRAM instead of
+// a static array. The EBI must then be initialised before the disk.
+
+/// Memory needed for a cache of the given number of lines: the sectors, the write staging buffer and the line tags.
+#define DISKCACHE_MEMSIZE( lines )	( ( ( lines ) + DISKCACHE_RUN ) * DISKCACHE_SECTOR + ( lines ) * 12 )
+
+typedef DRESULT ( *DISKCACHE_ReadFunc )( BYTE *buff, DWORD sector, BYTE count );			///< Reads sectors from the disk.
+typedef DRESULT ( *DISKCACHE_WriteFunc )( const BYTE *buff, DWORD sector, BYTE count );	///< Writes sectors to the disk.
+
+/// Cache counters, reported in telemetry. Sector counts.
+typedef struct{
+	uint32_t reads;					///< Sectors read by FatFs.
+	uint32_t readHits;				///< Of which found in the cache.
+	uint32_t writes;				///< Sectors written by FatFs.
+	uint32_t writeHits;				///< Of which already in the cache.
+	uint32_t diskReads;				///< Sectors read from the disk.
+	uint32_t diskWrites;			///< Sectors written to the disk.
+	uint32_t diskWriteCmds;			///< Disk writes, each a single or a multiple block write.
+	uint32_t evictions;				///< Dirty sectors written back to make room.
+	uint16_t pinned;				///< Lines holding pinned sectors.
+	uint16_t dirty;					///< Lines not yet written to the disk.
+}DISKCACHE_Stats_TypeDef;
+
+void    DISKCACHE_Init( uint8_t *mem, uint16_t lines, DISKCACHE_ReadFunc read, DISKCACHE_WriteFunc write );	///< Set up an empty cache.
+DRESULT DISKCACHE_read( BYTE *buff, DWORD sector, BYTE count );			///< Read sectors through the cache.
+DRESULT DISKCACHE_write( const BYTE *buff, DWORD sector, BYTE count );	///< Write sectors through the cache.
+DRESULT DISKCACHE_flush( void );										///< Write every dirty sector to the disk.
+void    DISKCACHE_invalidate( void );									///< Drop every sector, dirty or not.
+uint8_t DISKCACHE_pin( DWORD sector, DWORD count );						///< Keep a range of sectors in preference to others and write it back.
+void    DISKCACHE_unpinAll( void );										///< Remove every pinned range.
+void    DISKCACHE_getStats( DISKCACHE_Stats_TypeDef *out );				///< Copy the counters.
+
+/** @} (end group MicroSd) */
+
+#endif // __DISKCACHE_H
@@ -40,10 +40,21 @@
 #define MICROSD_HI_SPI_FREQ     12000000
 #define MICROSD_LO_SPI_FREQ     100000
 
+/* Data blocks of at least MICROSD_DMA_MINLEN bytes are transferred by DMA, */
+/* with the calling task blocked until the transfer completes. A busy card */
+/* is polled by DMA in chunks of MICROSD_DMA_POLLLEN bytes. Set            */
+/* MICROSD_USE_DMA to 0 to transfer and poll by CPU instead.               */
+#define MICROSD_USE_DMA         1
+#define MICROSD_DMA_MINLEN      512
+#define MICROSD_DMA_POLLLEN     128
+#define MICROSD_DMA_TIMEOUT_MS  100
+
 #if defined(CubeCompV2B)
 #define MICROSD_USART           USART1
 #define MICROSD_LOC             USART_ROUTE_LOCATION_LOC1
 #define MICROSD_CMUCLOCK        cmuClock_USART1
+#define MICROSD_DMAREQ_RX       DMAREQ_USART1_RXDATAV
+#define MICROSD_DMAREQ_TX       DMAREQ_USART1_TXBL
 #define MICROSD_GPIOPORT        gpioPortD
 #define MICROSD_MOSIPIN         0
 #define MICROSD_MISOPIN         1
@@ -54,6 +65,8 @@
 #define MICROSD_USART           USART2
 #define MICROSD_LOC             USART_ROUTE_LOCATION_LOC1
 #define MICROSD_CMUCLOCK        cmuClock_USART2
+#define MICROSD_DMAREQ_RX       DMAREQ_USART2_RXDATAV
+#define MICROSD_DMAREQ_TX       DMAREQ_USART2_TXBL
 #define MICROSD_GPIOPORT        gpioPortB
 #define MICROSD_MOSIPIN         3
 #define MICROSD_MISOPIN         4
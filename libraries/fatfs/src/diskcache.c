@@ -0,0 +1,572 @@
+/***************************************************************************//**
+ * @file	diskcache.c
+ * @brief	Sector cache between FatFs and the disk driver.
+ *
+ * Single sector reads, which is all FatFs issues for the FAT, the directories
+ * and the log writers, are served from the cache. Only writes to pinned
+ * sectors are held back: dirty sectors are written back when their line is
+ * needed or on a flush, together with their dirty neighbours as one multiple
+ * block write. Every other write, file data and so the log rings and the log
+ * control block, goes straight to the disk and only updates the cached copy,
+ * so those sectors reach the card in the order they are written.
+ *
+ * Sectors in a pinned range may take all but one way of a set, so file data
+ * streaming through the cache cannot push the FAT and directory sectors out,
+ * and a burst of FAT updates cannot starve file data of lines either.
+ * @author	Andre Heunis
+ * @date	16/10/2026
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 ESL , http://http://www.esl.sun.ac.za/</b>
+ *******************************************************************************
+ *
+ * This source code is the property of the ESL. The source and compiled code may
+ * only be used on the CubeComputer.
+ *
+ * This copyright notice may not be removed from the source code nor changed.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: ESL has no obligation to
+ * support this Software. ESL is providing the Software "AS IS", with no express
+ * or implied warranties of any kind, including, but not limited to, any implied
+ * warranties of merchantability or fitness for any particular purpose or
+ * warranties against infringement of any proprietary rights of a third party.
+ *
+ * ESL will not be liable for any consequential, incidental, or special damages,
+ * or any other relief, or for any claim by any third party, arising from your
+ * use of this Software.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "diskcache.h"
+
+#define LINE_VALID		0x01
+#define LINE_DIRTY		0x02
+#define LINE_PINNED		0x04
+
+/// Tag of a cached sector. Kept at the end of the cache memory.
+typedef struct{
+	DWORD		sector;
+	uint32_t	used;		///< Access stamp, for least recently used replacement.
+	uint8_t		flags;
+}DISKCACHE_Line_TypeDef;
+
+/// A pinned sector range.
+typedef struct{
+	DWORD		first;
+	DWORD		count;
+}DISKCACHE_Pin_TypeDef;
+
+#ifndef DISKCACHE_MEM
+static uint32_t defaultMem[( DISKCACHE_MEMSIZE( DISKCACHE_LINES ) + 3 ) / 4];
+#define DISKCACHE_MEM	defaultMem
+#endif
+
+static uint8_t					*data;			///< Sector of each line.
+static uint8_t					*staging;		///< Write back buffer of DISKCACHE_RUN sectors.
+static DISKCACHE_Line_TypeDef	*tags;			///< Tag of each line.
+static uint16_t					lineCount;
+static uint16_t					ways;
+static uint16_t					sets;
+static uint32_t					stamp;
+static DISKCACHE_ReadFunc		diskRead;
+static DISKCACHE_WriteFunc		diskWrite;
+static DISKCACHE_Pin_TypeDef	pins[DISKCACHE_PINS];
+static uint8_t					pinCount;
+static DISKCACHE_Stats_TypeDef	stats;
+
+// FUNCTIONS *******************************************************************
+
+static uint8_t *DISKCACHE_data( DISKCACHE_Line_TypeDef *line )
+{
+	return data + ( uint32_t )( line - tags ) * DISKCACHE_SECTOR;
+}
+
+static DISKCACHE_Line_TypeDef *DISKCACHE_find( DWORD sector )
+{
+	DISKCACHE_Line_TypeDef *line = &tags[( sector % sets ) * ways];
+	uint16_t i;
+
+	for( i = 0; i < ways; i++, line++ )
+	{
+		if( ( line->flags & LINE_VALID ) && line->sector == sector )
+		{
+			return line;
+		}
+	}
+	return NULL;
+}
+
+static uint8_t DISKCACHE_isPinned( DWORD sector )
+{
+	uint8_t i;
+
+	// A single way set has no room to keep pinned sectors apart
+	if( ways < 2 )
+	{
+		return 0;
+	}
+	for( i = 0; i < pinCount; i++ )
+	{
+		if( sector - pins[i].first < pins[i].count )
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static uint8_t DISKCACHE_isDirty( DWORD sector )
+{
+	DISKCACHE_Line_TypeDef *line = DISKCACHE_find( sector );
+
+	return line != NULL && ( line->flags & LINE_DIRTY );
+}
+
+/*
+ * Writes the given dirty line back, with the dirty sectors next to it, as a
+ * single disk write of at most DISKCACHE_RUN sectors.
+ */
+static DRESULT DISKCACHE_writeBack( DISKCACHE_Line_TypeDef *line )
+{
+	DISKCACHE_Line_TypeDef *other;
+	DWORD first = line->sector;
+	BYTE count, i;
+	DRESULT res;
+
+	while( first > 0 && line->sector - first < DISKCACHE_RUN - 1 && DISKCACHE_isDirty( first - 1 ) )
+	{
+		first--;
+	}
+	count = line->sector - first + 1;
+	while( count < DISKCACHE_RUN && DISKCACHE_isDirty( first + count ) )
+	{
+		count++;
+	}
+
+	if( count == 1 )
+	{
+		res = diskWrite( DISKCACHE_data( line ), first, 1 );
+	}
+	else
+	{
+		for( i = 0; i < count; i++ )
+		{
+			memcpy( staging + i * DISKCACHE_SECTOR, DISKCACHE_data( DISKCACHE_find( first + i ) ), DISKCACHE_SECTOR );
+		}
+		res = diskWrite( staging, first, count );
+	}
+	if( res != RES_OK )
+	{
+		return res;
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		other = DISKCACHE_find( first + i );
+		other->flags &= ~LINE_DIRTY;
+	}
+	stats.diskWrites += count;
+	stats.diskWriteCmds++;
+
+	return RES_OK;
+}
+
+/*
+ * Picks a line for the given sector in its set, writing back the least
+ * recently used candidate if it is dirty. Pinned sectors replace unpinned
+ * lines until only one is left in the set, and each other after that.
+ */
+static DISKCACHE_Line_TypeDef *DISKCACHE_allocate( DWORD sector )
+{
+	DISKCACHE_Line_TypeDef *set = &tags[( sector % sets ) * ways];
+	DISKCACHE_Line_TypeDef *victim = NULL;
+	uint8_t pinned = DISKCACHE_isPinned( sector );
+	uint8_t victimPinned;
+	uint16_t i, pinnedCount = 0;
+
+	for( i = 0; i < ways; i++ )
+	{
+		if( ( set[i].flags & LINE_VALID ) && ( set[i].flags & LINE_PINNED ) )
+		{
+			pinnedCount++;
+		}
+	}
+
+	victimPinned = pinned && pinnedCount >= ways - 1;
+	for( i = 0; i < ways; i++ )
+	{
+		if( !( set[i].flags & LINE_VALID ) )
+		{
+			if( !pinned || pinnedCount < ways - 1 )
+			{
+				victim = &set[i];
+				break;
+			}
+			continue;
+		}
+		if( ( ( set[i].flags & LINE_PINNED ) != 0 ) != victimPinned )
+		{
+			continue;
+		}
+		if( victim == NULL || ( int32_t )( set[i].used - victim->used ) < 0 )
+		{
+			victim = &set[i];
+		}
+	}
+
+	// Ranges pinned after their sectors were cached can fill a whole set
+	if( victim == NULL )
+	{
+		victim = &set[0];
+		for( i = 1; i < ways; i++ )
+		{
+			if( ( int32_t )( set[i].used - victim->used ) < 0 )
+			{
+				victim = &set[i];
+			}
+		}
+	}
+
+	if( victim->flags & LINE_DIRTY )
+	{
+		if( DISKCACHE_writeBack( victim ) != RES_OK )
+		{
+			return NULL;
+		}
+		stats.evictions++;
+	}
+
+	victim->sector = sector;
+	victim->flags = LINE_VALID | ( pinned ? LINE_PINNED : 0 );
+	victim->used = ++stamp;
+
+	return victim;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Sets up an empty cache with no pinned ranges and clears the counters.
+ *
+ * @param[in] mem
+ *   DISKCACHE_MEMSIZE( lines ) bytes, word aligned, or NULL for the default
+ *   memory of DISKCACHE_LINES lines.
+ * @param[in] lines
+ *   Number of cached sectors. 0 passes every transfer to the disk.
+ * @param[in] read
+ *   Disk read function.
+ * @param[in] write
+ *   Disk write function.
+ ******************************************************************************/
+void DISKCACHE_Init( uint8_t *mem, uint16_t lines, DISKCACHE_ReadFunc read, DISKCACHE_WriteFunc write )
+{
+	if( mem == NULL )
+	{
+		mem = ( uint8_t * )DISKCACHE_MEM;
+		if( lines > DISKCACHE_LINES )
+		{
+			lines = DISKCACHE_LINES;
+		}
+	}
+
+	ways = ( lines < DISKCACHE_WAYS ) ? lines : DISKCACHE_WAYS;
+	sets = ( ways > 0 ) ? lines / ways : 0;
+	lineCount = sets * ways;
+
+	data = mem;
+	staging = mem + lines * DISKCACHE_SECTOR;
+	tags = ( DISKCACHE_Line_TypeDef * )( staging + DISKCACHE_RUN * DISKCACHE_SECTOR );
+
+	diskRead = read;
+	diskWrite = write;
+	pinCount = 0;
+	stamp = 0;
+	memset( &stats, 0, sizeof( stats ) );
+
+	DISKCACHE_invalidate();
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Reads sectors. A single sector is served from the cache and filled on a
+ * miss; a multiple sector read goes to the disk and is patched with the
+ * cached sectors not yet written back.
+ *
+ * @param[out] buff
+ *   Destination of count sectors.
+ * @param[in] sector
+ *   First sector.
+ * @param[in] count
+ *   Number of sectors.
+ * @return
+ *   The disk result.
+ ******************************************************************************/
+DRESULT DISKCACHE_read( BYTE *buff, DWORD sector, BYTE count )
+{
+	DISKCACHE_Line_TypeDef *line;
+	DRESULT res;
+	BYTE i;
+
+	stats.reads += count;
+
+	if( lineCount == 0 || count > 1 )
+	{
+		res = diskRead( buff, sector, count );
+		if( res != RES_OK )
+		{
+			return res;
+		}
+		stats.diskReads += count;
+
+		for( i = 0; lineCount > 0 && i < count; i++ )
+		{
+			line = DISKCACHE_find( sector + i );
+			if( line != NULL && ( line->flags & LINE_DIRTY ) )
+			{
+				memcpy( buff + i * DISKCACHE_SECTOR, DISKCACHE_data( line ), DISKCACHE_SECTOR );
+			}
+		}
+		return RES_OK;
+	}
+
+	line = DISKCACHE_find( sector );
+	if( line != NULL )
+	{
+		stats.readHits++;
+		line->used = ++stamp;
+	}
+	else
+	{
+		line = DISKCACHE_allocate( sector );
+		if( line == NULL )
+		{
+			return RES_ERROR;
+		}
+		res = diskRead( DISKCACHE_data( line ), sector, 1 );
+		if( res != RES_OK )
+		{
+			line->flags = 0;
+			return res;
+		}
+		stats.diskReads++;
+	}
+
+	memcpy( buff, DISKCACHE_data( line ), DISKCACHE_SECTOR );
+	return RES_OK;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Writes sectors. A single pinned sector is kept dirty in the cache; any
+ * other write goes to the disk and refreshes the cached copies.
+ *
+ * @param[in] buff
+ *   Source of count sectors.
+ * @param[in] sector
+ *   First sector.
+ * @param[in] count
+ *   Number of sectors.
+ * @return
+ *   The disk result.
+ ******************************************************************************/
+DRESULT DISKCACHE_write( const BYTE *buff, DWORD sector, BYTE count )
+{
+	DISKCACHE_Line_TypeDef *line;
+	DRESULT res;
+	BYTE i;
+
+	stats.writes += count;
+
+	if( lineCount == 0 || count > 1 || !DISKCACHE_isPinned( sector ) )
+	{
+		res = diskWrite( buff, sector, count );
+		if( res != RES_OK )
+		{
+			return res;
+		}
+		stats.diskWrites += count;
+		stats.diskWriteCmds++;
+
+		for( i = 0; lineCount > 0 && i < count; i++ )
+		{
+			line = DISKCACHE_find( sector + i );
+			if( line != NULL )
+			{
+				memcpy( DISKCACHE_data( line ), buff + i * DISKCACHE_SECTOR, DISKCACHE_SECTOR );
+				line->flags &= ~LINE_DIRTY;
+			}
+		}
+		return RES_OK;
+	}
+
+	line = DISKCACHE_find( sector );
+	if( line != NULL )
+	{
+		stats.writeHits++;
+		line->used = ++stamp;
+	}
+	else
+	{
+		line = DISKCACHE_allocate( sector );
+		if( line == NULL )
+		{
+			return RES_ERROR;
+		}
+	}
+
+	memcpy( DISKCACHE_data( line ), buff, DISKCACHE_SECTOR );
+	line->flags |= LINE_DIRTY;
+	return RES_OK;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Writes every dirty sector to the disk in ascending order, adjacent sectors
+ * together.
+ *
+ * @return
+ *   The result of the first failed disk write, or RES_OK.
+ ******************************************************************************/
+DRESULT DISKCACHE_flush( void )
+{
+	DISKCACHE_Line_TypeDef *first;
+	DRESULT res;
+	uint16_t i;
+
+	for( ;; )
+	{
+		first = NULL;
+		for( i = 0; i < lineCount; i++ )
+		{
+			if( ( tags[i].flags & LINE_DIRTY ) && ( first == NULL || tags[i].sector < first->sector ) )
+			{
+				first = &tags[i];
+			}
+		}
+		if( first == NULL )
+		{
+			return RES_OK;
+		}
+
+		res = DISKCACHE_writeBack( first );
+		if( res != RES_OK )
+		{
+			return res;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Drops every cached sector. Dirty sectors are lost, so flush first unless
+ * the disk has been replaced.
+ ******************************************************************************/
+void DISKCACHE_invalidate( void )
+{
+	uint16_t i;
+
+	for( i = 0; i < lineCount; i++ )
+	{
+		tags[i].flags = 0;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Adds a pinned sector range, unless it is pinned already. Sectors of the
+ * range already in the cache are pinned at once, and later writes to the
+ * range are held in the cache until written back.
+ *
+ * @param[in] sector
+ *   First sector of the range.
+ * @param[in] count
+ *   Number of sectors.
+ * @return
+ *   1 if the range was added, 0 if the pin table is full.
+ ******************************************************************************/
+uint8_t DISKCACHE_pin( DWORD sector, DWORD count )
+{
+	uint16_t i;
+
+	for( i = 0; i < pinCount; i++ )
+	{
+		if( pins[i].first == sector && pins[i].count == count )
+		{
+			return 1;
+		}
+	}
+	if( pinCount >= DISKCACHE_PINS )
+	{
+		return 0;
+	}
+	pins[pinCount].first = sector;
+	pins[pinCount].count = count;
+	pinCount++;
+
+	for( i = 0; i < lineCount; i++ )
+	{
+		if( ( tags[i].flags & LINE_VALID ) && DISKCACHE_isPinned( tags[i].sector ) )
+		{
+			tags[i].flags |= LINE_PINNED;
+		}
+	}
+	return 1;
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Removes every pinned range. The sectors stay cached as ordinary lines.
+ ******************************************************************************/
+void DISKCACHE_unpinAll( void )
+{
+	uint16_t i;
+
+	pinCount = 0;
+	for( i = 0; i < lineCount; i++ )
+	{
+		tags[i].flags &= ~LINE_PINNED;
+	}
+}
+
+/***************************************************************************//**
+ * @author Andre Heunis
+ * @date   16/10/2026
+ *
+ * Copies the counters, with the current number of pinned and dirty lines.
+ *
+ * @param[out] out
+ *   Destination of the counters.
+ ******************************************************************************/
+void DISKCACHE_getStats( DISKCACHE_Stats_TypeDef *out )
+{
+	uint16_t i;
+
+	stats.pinned = 0;
+	stats.dirty = 0;
+	for( i = 0; i < lineCount; i++ )
+	{
+		if( ( tags[i].flags & LINE_VALID ) && ( tags[i].flags & LINE_PINNED ) )
+		{
+			stats.pinned++;
+		}
+		if( tags[i].flags & LINE_DIRTY )
+		{
+			stats.dirty++;
+		}
+	}
+	*out = stats;
+}
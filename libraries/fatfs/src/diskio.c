@@ -12,10 +12,15 @@
 /-------------------------------------------------------------------------*/
 
 #include "diskio.h"
+#include "diskcache.h"
 #include "microsd.h"
 
 static DSTATUS stat = STA_NOINIT;  /* Disk status */
 static UINT CardType;
+static BYTE CacheReady;            /* Sector cache set up */
+
+static DRESULT MSD_read (BYTE *buff, DWORD sector, BYTE count);
+static DRESULT MSD_write (const BYTE *buff, DWORD sector, BYTE count);
 
 /*--------------------------------------------------------------------------
 
@@ -69,6 +74,10 @@ DSTATUS disk_initialize (
   if (ty) {                                     /* Initialization succeded */
     stat &= ~STA_NOINIT;                        /* Clear STA_NOINIT */
     MICROSD_SpiClkFast();                       /* Speed up SPI clock. */
+    if (!CacheReady) {                          /* Keep cached sectors over a re-initialization */
+      DISKCACHE_Init(0, DISKCACHE_LINES, MSD_read, MSD_write);
+      CacheReady = 1;
+    }
   } else {                                      /* Initialization failed */
     MICROSD_PowerOff();
     stat |= STA_NOINIT;                         /* Set STA_NOINIT */
@@ -93,16 +102,12 @@ DSTATUS disk_status (
 /* Read Sector(s)                                                        */
 /*-----------------------------------------------------------------------*/
 
-DRESULT disk_read (
-  BYTE drv,       /* Physical drive nmuber (0) */
+static DRESULT MSD_read (
   BYTE *buff,     /* Pointer to the data buffer to store read data */
   DWORD sector,   /* Start sector number (LBA) */
   BYTE count      /* Sector count (1..255) */
 )
 {
-  if (drv || !count) return RES_PARERR;
-  if (stat & STA_NOINIT) return RES_NOTRDY;
-
   if (!(CardType & CT_BLOCK)) sector *= 512;  /* Convert to byte address if needed */
 
   if (count == 1) {                           /* Single block read */
@@ -124,22 +129,29 @@ DRESULT disk_read (
   return count ? RES_ERROR : RES_OK;
 }
 
+DRESULT disk_read (
+  BYTE drv,       /* Physical drive nmuber (0) */
+  BYTE *buff,     /* Pointer to the data buffer to store read data */
+  DWORD sector,   /* Start sector number (LBA) */
+  BYTE count      /* Sector count (1..255) */
+)
+{
+  if (drv || !count) return RES_PARERR;
+  if (stat & STA_NOINIT) return RES_NOTRDY;
+
+  return DISKCACHE_read(buff, sector, count);
+}
+
 /*-----------------------------------------------------------------------*/
 /* Write Sector(s)                                                       */
 /*-----------------------------------------------------------------------*/
 
-#if _READONLY == 0
-DRESULT disk_write (
-  BYTE drv,           /* Physical drive nmuber (0) */
+static DRESULT MSD_write (
   const BYTE *buff,   /* Pointer to the data to be written */
   DWORD sector,       /* Start sector number (LBA) */
   BYTE count          /* Sector count (1..255) */
 )
 {
-  if (drv || !count) return RES_PARERR;
-  if (stat & STA_NOINIT) return RES_NOTRDY;
-  if (stat & STA_PROTECT) return RES_WRPRT;
-
   if (!(CardType & CT_BLOCK)) sector *= 512;  /* Convert to byte address if needed */
 
   if (count == 1) {                           /* Single block write */
@@ -162,6 +174,21 @@ DRESULT disk_write (
 
   return count ? RES_ERROR : RES_OK;
 }
+
+#if _READONLY == 0
+DRESULT disk_write (
+  BYTE drv,           /* Physical drive nmuber (0) */
+  const BYTE *buff,   /* Pointer to the data to be written */
+  DWORD sector,       /* Start sector number (LBA) */
+  BYTE count          /* Sector count (1..255) */
+)
+{
+  if (drv || !count) return RES_PARERR;
+  if (stat & STA_NOINIT) return RES_NOTRDY;
+  if (stat & STA_PROTECT) return RES_WRPRT;
+
+  return DISKCACHE_write(buff, sector, count);
+}
 #endif /* _READONLY */
 
 /*-----------------------------------------------------------------------*/
@@ -185,13 +212,15 @@ DRESULT disk_ioctl (
   res = RES_ERROR;
   switch (ctrl) {
     case CTRL_SYNC :                /* Flush dirty buffer if present */
-      if (MICROSD_Select()) {
+      if (DISKCACHE_flush() == RES_OK && MICROSD_Select()) {
         MICROSD_Deselect();
         res = RES_OK;
       }
       break;
 
     case CTRL_INVALIDATE :          /* Used when unmounting */
+      DISKCACHE_flush();            /* Write back what can be, the card may be gone */
+      DISKCACHE_invalidate();
       stat = STA_NOINIT;            /* Set disk status */
       res = RES_OK;
       break;
@@ -265,7 +294,7 @@ DRESULT disk_ioctl (
     case MMC_GET_SDSTAT :           /* Receive SD statsu as a data block (64 bytes) */
       if (MICROSD_SendCmd(ACMD13, 0) == 0) {    /* SD_STATUS */
         MICROSD_XferSpi(0xff);
-        if (MICROSD_BlockTx(buff, 64))
+        if (MICROSD_BlockRx(buff, 64))
           res = RES_OK;
       }
       break;
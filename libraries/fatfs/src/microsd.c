@@ -38,6 +38,14 @@
 #include "microsd.h"
 #include "em_cmu.h"
 #include "em_usart.h"
+#if MICROSD_USE_DMA
+#include <string.h>
+#include "em_dma.h"
+#include "bsp_dma.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
 
 /**************************************************************************//**
  * @addtogroup MicroSd
@@ -64,6 +72,218 @@ static uint8_t WaitReady(void)
 
   return res;
 }
+
+#if MICROSD_USE_DMA
+static xSemaphoreHandle dmaDone;        /* Given when a block transfer completes */
+static volatile bool    dmaBusy;        /* Set while a block transfer is in progress */
+static uint8_t          dmaDescr;       /* Increments of the current descriptors */
+static const uint8_t    dmaFill = 0xFF; /* Clocked out while receiving */
+static uint8_t          dmaDrain;       /* Last byte received while polling or transmitting */
+static uint8_t          dmaPoll[MICROSD_DMA_POLLLEN]; /* Bytes received while waiting for a data token */
+
+#define DMA_DESCR_RXINC   0x01          /* Received bytes are stored */
+#define DMA_DESCR_TXINC   0x02          /* Transmitted bytes are read from a buffer */
+#define DMA_DESCR_VALID   0x04          /* Descriptors have been configured */
+
+/**************************************************************************//**
+ * @brief DMA callback, called when the RX channel has received the last byte
+ *        of a block transfer.
+ *****************************************************************************/
+static void DmaComplete(unsigned int channel, bool primary, void *user)
+{
+  portBASE_TYPE woken = pdFALSE;
+
+  dmaBusy = false;
+  xSemaphoreGiveFromISR(dmaDone, &woken);
+  portEND_SWITCHING_ISR(woken);
+}
+
+/**************************************************************************//**
+ * @brief Configure the DMA channels used for block transfers.
+ *        The RX channel has high priority so the receiver never overruns.
+ *****************************************************************************/
+static void DmaInit(void)
+{
+  DMA_CfgChannel_TypeDef chnlCfg;
+
+  if (dmaDone == NULL)
+  {
+    vSemaphoreCreateBinary(dmaDone);
+    xSemaphoreTake(dmaDone, 0);
+  }
+  dmaDescr = 0;
+
+  cb[DMA_CHANNEL_MICROSD_RX].cbFunc  = DmaComplete;
+  cb[DMA_CHANNEL_MICROSD_RX].userPtr = NULL;
+
+  chnlCfg.highPri   = true;
+  chnlCfg.enableInt = true;
+  chnlCfg.select    = MICROSD_DMAREQ_RX;
+  chnlCfg.cb        = &(cb[DMA_CHANNEL_MICROSD_RX]);
+  DMA_CfgChannel(DMA_CHANNEL_MICROSD_RX, &chnlCfg);
+
+  chnlCfg.highPri   = false;
+  chnlCfg.enableInt = false;
+  chnlCfg.select    = MICROSD_DMAREQ_TX;
+  chnlCfg.cb        = NULL;
+  DMA_CfgChannel(DMA_CHANNEL_MICROSD_TX, &chnlCfg);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Transfer a block by DMA. The calling task is blocked until the last byte
+ *  has been received. Before the scheduler runs, the transfer is polled.
+ *  The descriptors are only rewritten when the direction changes, so the
+ *  sectors of a multiple block transfer just re-arm the channels.
+ * @param[out] rx
+ *  Buffer for the received bytes, or NULL to discard them.
+ * @param[in] tx
+ *  Bytes to transmit, or NULL to transmit 0xFF.
+ * @param len
+ *  Byte count (1..1024).
+ * @return
+ *  1:OK, 0:Timeout.
+ *****************************************************************************/
+static int DmaXfer(uint8_t *rx, const uint8_t *tx, uint32_t len)
+{
+  DMA_CfgDescr_TypeDef descrCfg;
+  uint32_t retryCount;
+  uint8_t descr;
+  int done;
+
+  descr = DMA_DESCR_VALID | (rx ? DMA_DESCR_RXINC : 0) | (tx ? DMA_DESCR_TXINC : 0);
+  if (descr != dmaDescr)
+  {
+    descrCfg.size    = dmaDataSize1;
+    descrCfg.arbRate = dmaArbitrate1;
+    descrCfg.hprot   = 0;
+
+    descrCfg.srcInc  = dmaDataIncNone;
+    descrCfg.dstInc  = rx ? dmaDataInc1 : dmaDataIncNone;
+    DMA_CfgDescr(DMA_CHANNEL_MICROSD_RX, true, &descrCfg);
+
+    descrCfg.srcInc  = tx ? dmaDataInc1 : dmaDataIncNone;
+    descrCfg.dstInc  = dmaDataIncNone;
+    DMA_CfgDescr(DMA_CHANNEL_MICROSD_TX, true, &descrCfg);
+
+    dmaDescr = descr;
+  }
+
+  if ( timeOut >= len )
+    timeOut -= len;
+  else
+    timeOut = 0;
+
+  /* Clear send and receive buffer, then start the receiver before the
+   * transmitter so that no byte is missed. */
+  MICROSD_USART->CMD = USART_CMD_CLEARRX | USART_CMD_CLEARTX;
+  dmaBusy = true;
+
+  DMA_ActivateBasic(DMA_CHANNEL_MICROSD_RX, true, false,
+                    rx ? (void *) rx : (void *) &dmaDrain,
+                    (void *) &(MICROSD_USART->RXDATA), len - 1);
+  DMA_ActivateBasic(DMA_CHANNEL_MICROSD_TX, true, false,
+                    (void *) &(MICROSD_USART->TXDATA),
+                    tx ? (void *) tx : (void *) &dmaFill, len - 1);
+
+  if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+  {
+    done = (xSemaphoreTake(dmaDone, MICROSD_DMA_TIMEOUT_MS / portTICK_RATE_MS) == pdTRUE);
+  }
+  else
+  {
+    /* Mounting happens before the scheduler is started */
+    retryCount = MICROSD_DMA_TIMEOUT_MS * xfersPrMsec;
+    while (dmaBusy && --retryCount);
+    done = !dmaBusy;
+    xSemaphoreTake(dmaDone, 0);
+  }
+
+  if (!done)
+  {
+    /* Abort the transfer */
+    DMA->CHENC = (1 << DMA_CHANNEL_MICROSD_TX) | (1 << DMA_CHANNEL_MICROSD_RX);
+    dmaBusy = false;
+  }
+
+  return done;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Wait for the card to finish programming a written block. While the
+ *  scheduler runs, a busy card is polled MICROSD_DMA_POLLLEN bytes at a
+ *  time by DMA so that the task sleeps instead of spinning on the busy
+ *  signal.
+ * @return 0xff: micro SD card ready, other value: micro SD card not ready.
+ *****************************************************************************/
+static uint8_t DmaWaitReady(void)
+{
+  uint32_t retryCount;
+
+  /* Most of the time the card is already ready */
+  if (MICROSD_XferSpi(0xff) == 0xFF)
+    return 0xFF;
+
+  if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    return WaitReady();
+
+  /* Wait for ready in timeout of 500ms */
+  retryCount = (500 * xfersPrMsec) / MICROSD_DMA_POLLLEN + 1;
+  do
+  {
+    if (!DmaXfer(NULL, NULL, MICROSD_DMA_POLLLEN))
+      return 0;
+  } while ((dmaDrain != 0xFF) && --retryCount);
+
+  /* The last byte polled tells whether the card has released the bus */
+  return dmaDrain;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Receive a data block by DMA. The card is polled for the data token
+ *  MICROSD_DMA_POLLLEN bytes at a time; data bytes that follow the token in
+ *  the same chunk are kept and the rest of the block is received by DMA.
+ * @param[out] buff
+ *  Data buffer to store received data.
+ * @param btr
+ *  Byte count (at least MICROSD_DMA_POLLLEN).
+ * @return
+ *  1:OK, 0:Failed.
+ *****************************************************************************/
+static int DmaBlockRx(uint8_t *buff, uint32_t btr)
+{
+  uint32_t retryCount, n;
+
+  /* Wait for data packet in timeout of 100ms */
+  retryCount = (100 * xfersPrMsec) / MICROSD_DMA_POLLLEN + 1;
+  do
+  {
+    if (!DmaXfer(dmaPoll, NULL, MICROSD_DMA_POLLLEN))
+      return 0;
+    for (n = 0; (n < MICROSD_DMA_POLLLEN) && (dmaPoll[n] == 0xFF); n++);
+  } while ((n == MICROSD_DMA_POLLLEN) && --retryCount);
+
+  if ((n == MICROSD_DMA_POLLLEN) || (dmaPoll[n] != 0xFE))
+    /* Invalid data token */
+    return 0;
+
+  /* Data already received with the token */
+  n++;
+  memcpy(buff, &dmaPoll[n], MICROSD_DMA_POLLLEN - n);
+  n = MICROSD_DMA_POLLLEN - n;
+
+  if ((n < btr) && !DmaXfer(buff + n, NULL, btr - n))
+    return 0;
+
+  /* Next two bytes is the CRC which we discard. */
+  MICROSD_XferSpi(0xff);
+  MICROSD_XferSpi(0xff);
+
+  return 1;
+}
+#endif  /* MICROSD_USE_DMA */
 /** @endcond */
 
 /**************************************************************************//**
@@ -94,6 +314,10 @@ void MICROSD_Init(void)
   GPIO_PinModeSet(MICROSD_GPIOPORT, MICROSD_MISOPIN, gpioModeInputPull, 1); /* MISO */
   GPIO_PinModeSet(MICROSD_GPIOPORT, MICROSD_CSPIN,   gpioModePushPull, 1);  /* CS */
   GPIO_PinModeSet(MICROSD_GPIOPORT, MICROSD_CLKPIN,  gpioModePushPull, 0);  /* CLK */
+
+#if MICROSD_USE_DMA
+  DmaInit();
+#endif
 }
 
 /**************************************************************************//**
@@ -146,7 +370,11 @@ void MICROSD_Deselect(void)
 int MICROSD_Select(void)
 {
   GPIO->P[ MICROSD_GPIOPORT ].DOUTCLR = 1 << MICROSD_CSPIN; /* CS pin low. */
+#if MICROSD_USE_DMA
+  if (DmaWaitReady() != 0xFF)
+#else
   if (WaitReady() != 0xFF)
+#endif
   {
     MICROSD_Deselect();
     return 0;
@@ -192,6 +420,11 @@ int MICROSD_BlockRx(uint8_t *buff, uint32_t btr)
   uint32_t retryCount, framectrl, ctrl;
   uint16_t *buff_16 = (uint16_t *) buff;
 
+#if MICROSD_USE_DMA
+  if ((btr >= MICROSD_DMA_MINLEN) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    return DmaBlockRx(buff, btr);
+#endif
+
   /* Wait for data packet in timeout of 100ms */
   retryCount = 100 * xfersPrMsec;
   do
@@ -255,14 +488,26 @@ int MICROSD_BlockRx(uint8_t *buff, uint32_t btr)
 int MICROSD_BlockTx(const uint8_t *buff, uint8_t token)
 {
   uint8_t resp;
+#if MICROSD_USE_DMA
+  /* In a multiple block write this waits for the previous block to be
+   * programmed, so the next block goes out as soon as the card is ready. */
+  if (DmaWaitReady() != 0xFF)
+    return 0;
+#else
   uint32_t bc = 512;
 
   if (WaitReady() != 0xFF)
     return 0;
+#endif
 
   MICROSD_XferSpi(token);         /* Xmit a token */
   if (token != 0xFD)
   {                               /* Not StopTran token */
+#if MICROSD_USE_DMA
+    /* Xmit the 512 byte data block to the MMC */
+    if (!DmaXfer(NULL, buff, 512))
+      return 0;
+#else
     do
     {
       /* Xmit the 512 byte data block to the MMC */
@@ -272,6 +517,7 @@ int MICROSD_BlockTx(const uint8_t *buff, uint8_t token)
       MICROSD_XferSpi(*buff++);
       bc -= 4;
     } while (bc);
+#endif
 
     MICROSD_XferSpi(0xFF);        /* CRC (Dummy) */
     MICROSD_XferSpi(0xFF);
@@ -1,17 +1,16 @@
 /*------------------------------------------------------------------------*/
-/* Sample code of OS dependent controls for FatFs R0.08b                  */
+/* OS dependent controls for FatFs R0.08b, on FreeRTOS                    */
 /* (C)ChaN, 2011                                                          */
 /*------------------------------------------------------------------------*/
 
 #include <stdlib.h>		/* ANSI memory controls */
-#include <malloc.h>		/* ANSI memory controls */
 
-#include "../ff.h"
+#include "ff.h"
 
 
 #if _FS_REENTRANT
 /*------------------------------------------------------------------------*/
-/* Create a Synchronization Object
+/* Create a Synchronization Object                                        */
 /*------------------------------------------------------------------------*/
 /* This function is called in f_mount function to create a new
 /  synchronization object, such as semaphore and mutex. When a zero is
@@ -25,17 +24,8 @@ int ff_cre_syncobj (	/* TRUE:Function succeeded, FALSE:Could not create due to a
 {
 	int ret;
 
-	*sobj = CreateMutex(NULL, FALSE, NULL);	/* Win32 */
-	ret = (*sobj != INVALID_HANDLE_VALUE);
-
-//	*sobj = SyncObjects[vol];	/* uITRON (give a static sync object) */
-//	ret = 1;					/* The initial value of the semaphore must be 1. */
-
-//	*sobj = OSMutexCreate(0, &err);			/* uC/OS-II */
-//	ret = (err == OS_NO_ERR);
-
-//	*sobj = xSemaphoreCreateMutex();		/* FreeRTOS */
-//	ret = (*sobj != NULL);
+	*sobj = xSemaphoreCreateMutex();		/* FreeRTOS, with priority inheritance */
+	ret = (*sobj != NULL);
 
 	return ret;
 }
@@ -54,18 +44,9 @@ int ff_del_syncobj (	/* TRUE:Function succeeded, FALSE:Could not delete due to a
 	_SYNC_t sobj		/* Sync object tied to the logical drive to be deleted */
 )
 {
-	BOOL ret;
-
-	ret = CloseHandle(sobj);	/* Win32 */
-
-//	ret = 1;					/* uITRON (nothing to do) */
-
-//	OSMutexDel(sobj, OS_DEL_ALWAYS, &err);	/* uC/OS-II */
-//	ret = (err == OS_NO_ERR);
-
-//	ret = 1;					/* FreeRTOS (nothing to do) */
+	vSemaphoreDelete(sobj);		/* FreeRTOS */
 
-	return ret;
+	return 1;
 }
 
 
@@ -83,14 +64,7 @@ int ff_req_grant (	/* TRUE:Got a grant to access the volume, FALSE:Could not get
 {
 	int ret;
 
-	ret = (WaitForSingleObject(sobj, _FS_TIMEOUT) == WAIT_OBJECT_0);	/* Win32 */
-
-//	ret = (wai_sem(sobj) == E_OK);	/* uITRON */
-
-//	OSMutexPend(sobj, _FS_TIMEOUT, &err));			/* uC/OS-II */
-//	ret = (err == OS_NO_ERR);
-
-//	ret = (xSemaphoreTake(sobj, _FS_TIMEOUT) == pdTRUE);	/* FreeRTOS */
+	ret = (xSemaphoreTake(sobj, _FS_TIMEOUT) == pdTRUE);	/* FreeRTOS */
 
 	return ret;
 }
@@ -107,13 +81,7 @@ void ff_rel_grant (
 	_SYNC_t sobj	/* Sync object to be signaled */
 )
 {
-	ReleaseMutex(sobj);		/* Win32 */
-
-//	sig_sem(sobj);			/* uITRON */
-
-//	OSMutexPost(sobj);		/* uC/OS-II */
-
-//	xSemaphoreGive(sobj);	/* FreeRTOS */
+	xSemaphoreGive(sobj);	/* FreeRTOS */
 
 }
 